@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <bit>
+#include <boost/asio/io_context.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <nostr/content_encoding.hpp>
+#include <optional>
+#include <signal/signal_bridge.hpp>
+#include <string>
+#include <tuple>
+#include <transport/ble_framing.hpp>
+#include <utility>
+#include <vector>
+
+#include "test_doubles/test_double_ble_stream.hpp"
+
+namespace radix_relay::signal::test {
+
+namespace {
+  constexpr std::uint64_t event_timestamp = 1234567890;
+  constexpr std::size_t file_size = 1024 * 1024;
+  constexpr std::size_t ble_mtu = 244;
+
+  auto frame_to_json(const std::vector<std::byte> &bytes) -> nlohmann::json
+  {
+    std::string text(bytes.size(), '\0');
+    std::ranges::transform(bytes, text.begin(), [](std::byte byte) { return std::bit_cast<char>(byte); });
+    return nlohmann::json::parse(text);
+  }
+
+  /// Hands a chunk frame to the recipient the way a relay would: author pubkey plus decoded content.
+  auto relay_chunk(const std::vector<std::byte> &frame, const bridge &recipient) -> transfer_progress
+  {
+    const auto event = frame_to_json(frame)[1];
+    const auto content = nostr::protocol::decode_content(event["content"].get<std::string>(),
+      nostr::protocol::content_encoding_from_tags(event["tags"].get<std::vector<std::vector<std::string>>>()));
+    return recipient.process_transfer_chunk(event["pubkey"].get<std::string>(), content.value());
+  }
+}// namespace
+
+TEST_CASE("Chunked File Transfer Benchmarks", "[benchmark][file_transfer]")
+{
+  const auto work_dir = std::filesystem::temp_directory_path() / "bench_file_transfer";
+  std::filesystem::remove_all(work_dir);
+  std::filesystem::create_directories(work_dir / "alice");
+  std::filesystem::create_directories(work_dir / "bob");
+
+  const auto source_path = work_dir / "payload.bin";
+  {
+    std::vector<char> payload(file_size);
+    for (std::size_t i = 0; i < payload.size(); ++i) { payload[i] = static_cast<char>((i * 31) % 251); }
+    std::ofstream(source_path, std::ios::binary).write(payload.data(), static_cast<std::streamsize>(payload.size()));
+  }
+
+  auto alice_bridge = std::make_shared<bridge>((work_dir / "alice" / "identity.db").string());
+  auto bob_bridge = std::make_shared<bridge>((work_dir / "bob" / "identity.db").string());
+
+  const auto alice_bundle_info = alice_bridge->generate_prekey_bundle_announcement("bench-0.1.0");
+  const auto alice_bundle = nlohmann::json::parse(alice_bundle_info.announcement_json)["content"].get<std::string>();
+  const auto bob_bundle_info = bob_bridge->generate_prekey_bundle_announcement("bench-0.1.0");
+  const auto bob_bundle = nlohmann::json::parse(bob_bundle_info.announcement_json)["content"].get<std::string>();
+
+  const auto bob_rdx = alice_bridge->add_contact_and_establish_session_from_base64(bob_bundle, "bob");
+  std::ignore = bob_bridge->add_contact_and_establish_session_from_base64(alice_bundle, "alice");
+
+  SECTION("Relay stand-in")
+  {
+    BENCHMARK_ADVANCED("Send and reassemble 1 MiB file (32 KiB chunks)")(Catch::Benchmark::Chronometer meter)
+    {
+      std::vector<std::string> saved_paths;
+      meter.measure([&]() -> bool {
+        const auto transfer = alice_bridge->start_file_transfer(bob_rdx, source_path.string());
+        bool complete = false;
+        for (const auto chunk_index : transfer.pending_chunks) {
+          const auto frame = alice_bridge->create_transfer_chunk_frame(
+            transfer.transfer_id, chunk_index, event_timestamp, "bench-0.1.0");
+          const auto progress = relay_chunk(frame.bytes, *bob_bridge);
+          std::ignore = alice_bridge->mark_transfer_chunk_delivered(transfer.transfer_id, chunk_index);
+          if (progress.complete) {
+            complete = true;
+            saved_paths.push_back(progress.path);
+          }
+        }
+        return complete;
+      });
+      for (const auto &path : saved_paths) { std::filesystem::remove(path); }
+    };
+
+    const auto transfer = alice_bridge->start_file_transfer(bob_rdx, source_path.string());
+    const auto chunk_index = transfer.pending_chunks.front();
+
+    BENCHMARK("Encrypt and frame one 32 KiB chunk")
+    {
+      return alice_bridge->create_transfer_chunk_frame(
+        transfer.transfer_id, chunk_index, event_timestamp, "bench-0.1.0");
+    };
+
+    BENCHMARK_ADVANCED("Decrypt and write one 32 KiB chunk")(Catch::Benchmark::Chronometer meter)
+    {
+      std::vector<signed_event_frame> frames;
+      frames.reserve(static_cast<std::size_t>(meter.runs()));
+      for (std::size_t i = 0; std::cmp_less(i, meter.runs()); ++i) {
+        frames.push_back(
+          alice_bridge->create_transfer_chunk_frame(transfer.transfer_id, chunk_index, event_timestamp, "bench-0.1.0"));
+      }
+
+      meter.measure([&](std::size_t idx) -> transfer_progress { return relay_chunk(frames[idx].bytes, *bob_bridge); });
+    };
+  }
+
+  SECTION("BLE test double")
+  {
+    const auto transfer = alice_bridge->start_file_transfer(bob_rdx, source_path.string());
+    const auto frame = alice_bridge->create_transfer_chunk_frame(
+      transfer.transfer_id, transfer.pending_chunks.front(), event_timestamp, "bench-0.1.0");
+
+    auto io_context = std::make_shared<boost::asio::io_context>();
+    radix_relay::test::test_double_ble_stream stream(io_context);
+
+    BENCHMARK("Carry one chunk frame over BLE (244 byte MTU)")
+    {
+      stream.reset();
+      stream.set_mtu(ble_mtu);
+      for (const auto &fragment : transport::fragment_ble_message(frame.bytes, stream.get_mtu())) {
+        stream.async_write(fragment, [](const boost::system::error_code &, std::size_t) {});
+      }
+      io_context->restart();
+      io_context->run();
+
+      transport::ble_reassembler reassembler;
+      std::optional<std::vector<std::byte>> message;
+      for (const auto &write : stream.get_writes()) { message = reassembler.push(write.data); }
+      return message;
+    };
+  }
+
+  alice_bridge.reset();
+  bob_bridge.reset();
+  std::filesystem::remove_all(work_dir);
+}
+
+}// namespace radix_relay::signal::test
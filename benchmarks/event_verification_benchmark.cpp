@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <bit>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <nostr/event_verification.hpp>
+#include <signal/signal_bridge.hpp>
+#include <string>
+#include <vector>
+
+namespace radix_relay::nostr::test {
+
+namespace {
+  constexpr std::size_t burst_size = 256;
+  constexpr std::uint64_t event_timestamp = 1234567890;
+
+  auto signed_events(const signal::bridge &bridge) -> std::vector<std::string>
+  {
+    std::vector<std::string> events;
+    events.reserve(burst_size);
+    for (std::size_t index = 0; index < burst_size; ++index) {
+      const auto frame = bridge.sign_event_frame(
+        40001, { { "p", std::string(64, 'b') } }, "message " + std::to_string(index), event_timestamp);
+      std::string frame_json;
+      frame_json.resize(frame.bytes.size());
+      std::ranges::transform(frame.bytes, frame_json.begin(), [](std::byte byte) { return std::bit_cast<char>(byte); });
+      events.push_back(nlohmann::json::parse(frame_json).at(1).dump());
+    }
+    return events;
+  }
+}// namespace
+
+TEST_CASE("Event Verification Benchmarks", "[benchmark][verify]")
+{
+  const auto db_path = (std::filesystem::temp_directory_path() / "bench_event_verification.db").string();
+  std::filesystem::remove(db_path);
+  auto bridge = std::make_shared<signal::bridge>(db_path);
+  const auto events = signed_events(*bridge);
+
+  // Divide by 256 for the cost of one event; a single-event batch never leaves the calling core.
+  BENCHMARK("Verify 256 events one at a time on one core")
+  {
+    std::size_t valid = 0;
+    for (const auto &event : events) { valid += static_cast<std::size_t>(bridge->verify_events({ event }).front()); }
+    return valid;
+  };
+
+  BENCHMARK("Verify a 256-event burst on every core") { return bridge->verify_events(events); };
+
+  verified_event_cache cache;
+  std::vector<nlohmann::json> parsed;
+  parsed.reserve(events.size());
+  for (const auto &event : events) {
+    parsed.push_back(nlohmann::json::parse(event));
+    cache.insert(parsed.back());
+  }
+
+  BENCHMARK("Look up 256 redelivered events in the verified-event cache")
+  {
+    return std::ranges::count_if(parsed, [&cache](const nlohmann::json &event) { return cache.contains(event); });
+  };
+
+  bridge.reset();
+  std::filesystem::remove(db_path);
+}
+
+}// namespace radix_relay::nostr::test
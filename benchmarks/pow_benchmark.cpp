@@ -0,0 +1,58 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <nostr/pow.hpp>
+#include <nostr/sha256.hpp>
+#include <string>
+#include <vector>
+
+namespace radix_relay::nostr::test {
+
+namespace {
+  constexpr std::uint64_t event_timestamp = 1234567890;
+  constexpr std::uint64_t hashes_per_run = 100'000;
+  constexpr std::uint32_t nip13_example_difficulty = 16;
+
+  auto bench_template() -> pow::event_template
+  {
+    const std::string pubkey(64, 'a');
+    const std::string content(256, 'Q');
+    return pow::make_event_template(pubkey,
+      event_timestamp,
+      40001,
+      { { "p", std::string(64, 'b') }, { "radix_version", "0.4.0", "base64" } },
+      content,
+      pow::max_difficulty);
+  }
+}// namespace
+
+TEST_CASE("Proof of Work Benchmarks", "[benchmark][pow]")
+{
+  const auto event = bench_template();
+
+  // Target 255 is never met, so every run makes exactly hashes_per_run attempts on one core.
+  BENCHMARK("100k nonce attempts on one core (scalar SHA-256)")
+  {
+    return pow::mine(event,
+      pow::max_difficulty,
+      { .threads = 1, .max_hashes_per_thread = hashes_per_run, .backend = sha256_backend::scalar },
+      {});
+  };
+
+  if (detected_sha256_backend() == sha256_backend::sha_ni) {
+    BENCHMARK("100k nonce attempts on one core (SHA-NI)")
+    {
+      return pow::mine(event,
+        pow::max_difficulty,
+        { .threads = 1, .max_hashes_per_thread = hashes_per_run, .backend = sha256_backend::sha_ni },
+        {});
+    };
+  }
+
+  BENCHMARK("Mine difficulty 16 on every core")
+  {
+    return pow::mine(event, nip13_example_difficulty, {}, {});
+  };
+}
+
+}// namespace radix_relay::nostr::test
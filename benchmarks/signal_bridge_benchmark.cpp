@@ -1,12 +1,34 @@
+#include <algorithm>
+#include <bit>
 #include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <chrono>
+#include <cstdint>
 #include <filesystem>
 #include <nlohmann/json.hpp>
+#include <nostr/content_encoding.hpp>
 #include <signal/signal_bridge.hpp>
+#include <string_view>
 
 namespace radix_relay::signal::test {
 
+namespace {
+  auto to_hex(const std::vector<uint8_t> &bytes) -> std::string
+  {
+    constexpr std::string_view hex_digits = "0123456789abcdef";
+    constexpr unsigned nibble_bits = 4;
+    constexpr unsigned nibble_mask = 0x0F;
+
+    std::string hex;
+    hex.reserve(bytes.size() * 2);
+    for (const auto byte : bytes) {
+      hex += hex_digits[static_cast<unsigned>(byte) >> nibble_bits];
+      hex += hex_digits[static_cast<unsigned>(byte) & nibble_mask];
+    }
+    return hex;
+  }
+}// namespace
+
 TEST_CASE("Signal Bridge Performance Benchmarks", "[benchmark][signal]")
 {
   SECTION("Key generation operations")
@@ -20,6 +42,8 @@ TEST_CASE("Signal Bridge Performance Benchmarks", "[benchmark][signal]")
       return bridge->generate_prekey_bundle_announcement("bench-0.1.0");
     };
 
+    BENCHMARK("Perform key maintenance") { return bridge->perform_key_maintenance(); };
+
     bridge.reset();
     std::filesystem::remove(db_path);
   }
@@ -80,6 +104,41 @@ TEST_CASE("Signal Bridge Performance Benchmarks", "[benchmark][signal]")
 
     BENCHMARK("Encrypt message") { return alice_bridge->encrypt_message(bob_rdx, message_bytes); };
 
+    constexpr std::uint32_t event_timestamp = 1234567890;
+
+    BENCHMARK("Plaintext to wire bytes (typed frame)")
+    {
+      auto ciphertext = alice_bridge->encrypt_message(bob_rdx, message_bytes);
+      return alice_bridge->create_encrypted_message_frame(bob_rdx, ciphertext, event_timestamp, "bench-0.1.0");
+    };
+
+    BENCHMARK("Plaintext to wire bytes (JSON round trip)")
+    {
+      auto ciphertext = alice_bridge->encrypt_message(bob_rdx, message_bytes);
+      auto signed_json =
+        alice_bridge->create_and_sign_encrypted_message(bob_rdx, to_hex(ciphertext), event_timestamp, "bench-0.1.0");
+      return nlohmann::json::array({ "EVENT", nlohmann::json::parse(signed_json) }).dump();
+    };
+
+    const auto ciphertext = alice_bridge->encrypt_message(bob_rdx, message_bytes);
+    const auto wire_frame =
+      alice_bridge->create_encrypted_message_frame(bob_rdx, ciphertext, event_timestamp, "bench-0.1.0");
+    std::string frame_text(wire_frame.bytes.size(), '\0');
+    std::ranges::transform(
+      wire_frame.bytes, frame_text.begin(), [](std::byte byte) { return std::bit_cast<char>(byte); });
+    const auto base64_content = nlohmann::json::parse(frame_text)[1]["content"].template get<std::string>();
+    const auto hex_content = to_hex(ciphertext);
+
+    BENCHMARK("Decode message content (base64)")
+    {
+      return nostr::protocol::decode_content(base64_content, nostr::protocol::content_encoding::base64);
+    };
+
+    BENCHMARK("Decode message content (hex)")
+    {
+      return nostr::protocol::decode_content(hex_content, nostr::protocol::content_encoding::hex);
+    };
+
     alice_bridge.reset();
     bob_bridge.reset();
     std::filesystem::remove(alice_db);
@@ -0,0 +1,186 @@
+#include <array>
+#include <atomic>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/asio/write.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+#include <string>
+#include <thread>
+#include <transport/tls_client_context.hpp>
+
+namespace radix_relay::transport::test {
+
+namespace {
+  constexpr long certificate_lifetime_seconds = 3600;
+  constexpr std::string_view host = "localhost";
+
+  struct pkey_deleter
+  {
+    auto operator()(EVP_PKEY *key) const -> void { EVP_PKEY_free(key); }
+  };
+
+  struct x509_deleter
+  {
+    auto operator()(X509 *cert) const -> void { X509_free(cert); }
+  };
+
+  struct pkey_ctx_deleter
+  {
+    auto operator()(EVP_PKEY_CTX *ctx) const -> void { EVP_PKEY_CTX_free(ctx); }
+  };
+
+  using pkey_ptr = std::unique_ptr<EVP_PKEY, pkey_deleter>;
+  using x509_ptr = std::unique_ptr<X509, x509_deleter>;
+
+  auto make_key() -> pkey_ptr
+  {
+    const std::unique_ptr<EVP_PKEY_CTX, pkey_ctx_deleter> ctx(EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr));
+    EVP_PKEY *key = nullptr;
+    if (ctx == nullptr or EVP_PKEY_keygen_init(ctx.get()) <= 0
+        or EVP_PKEY_CTX_set_ec_paramgen_curve_nid(ctx.get(), NID_X9_62_prime256v1) <= 0
+        or EVP_PKEY_keygen(ctx.get(), &key) <= 0) {
+      return nullptr;
+    }
+    return pkey_ptr(key);
+  }
+
+  auto make_self_signed(EVP_PKEY *key) -> x509_ptr
+  {
+    x509_ptr cert(X509_new());
+    X509_set_version(cert.get(), 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(cert.get()), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert.get()), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert.get()), certificate_lifetime_seconds);
+    X509_set_pubkey(cert.get(), key);
+
+    const std::string common_name(host);
+    auto *name = X509_get_subject_name(cert.get());
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto *bytes = reinterpret_cast<const unsigned char *>(common_name.c_str());
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, bytes, -1, -1, 0);
+    X509_set_issuer_name(cert.get(), name);
+    X509_sign(cert.get(), key, EVP_sha256());
+    return cert;
+  }
+
+  /**
+   * @brief Local TLS 1.3 server standing in for a relay.
+   *
+   * Accepts one connection at a time, completes the handshake, which also issues session
+   * tickets, then writes one byte and waits for the client to shut the connection down.
+   */
+  class tls_server
+  {
+  public:
+    tls_server(X509 *cert, EVP_PKEY *key)
+      : context_(boost::asio::ssl::context::tls_server),
+        acceptor_(io_context_, { boost::asio::ip::make_address("127.0.0.1"), 0 })
+    {
+      SSL_CTX_use_certificate(context_.native_handle(), cert);
+      SSL_CTX_use_PrivateKey(context_.native_handle(), key);
+      constexpr std::array<unsigned char, 5> session_id_context{ 'r', 'e', 'l', 'a', 'y' };
+      SSL_CTX_set_session_id_context(context_.native_handle(), session_id_context.data(), session_id_context.size());
+      thread_ = std::thread([this]() -> void { serve(); });
+    }
+
+    tls_server(const tls_server &) = delete;
+    auto operator=(const tls_server &) -> tls_server & = delete;
+    tls_server(tls_server &&) = delete;
+    auto operator=(tls_server &&) -> tls_server & = delete;
+
+    ~tls_server()
+    {
+      stopping_ = true;
+      boost::system::error_code error;
+      boost::asio::ip::tcp::socket wake(io_context_);
+      wake.connect(acceptor_.local_endpoint(), error);
+      thread_.join();
+    }
+
+    [[nodiscard]] auto endpoint() const -> boost::asio::ip::tcp::endpoint { return acceptor_.local_endpoint(); }
+
+  private:
+    auto serve() -> void
+    {
+      while (not stopping_) {
+        boost::system::error_code error;
+        boost::asio::ip::tcp::socket socket(io_context_);
+        acceptor_.accept(socket, error);
+        if (error or stopping_) { continue; }
+        socket.set_option(boost::asio::ip::tcp::no_delay(true), error);
+
+        boost::asio::ssl::stream<boost::asio::ip::tcp::socket> stream(std::move(socket), context_);
+        stream.handshake(boost::asio::ssl::stream_base::server, error);
+        if (error) { continue; }
+        std::array<char, 1> byte{ 'x' };
+        boost::asio::write(stream, boost::asio::buffer(byte), error);
+        boost::asio::read(stream, boost::asio::buffer(byte), error);
+        stream.shutdown(error);
+      }
+    }
+
+    boost::asio::io_context io_context_;
+    boost::asio::ssl::context context_;
+    boost::asio::ip::tcp::acceptor acceptor_;
+    std::atomic<bool> stopping_{ false };
+    std::thread thread_;
+  };
+
+  /// Connects, handshakes and reads the server's byte, which also takes in its session tickets. The
+  /// shutdown matters: OpenSSL stops resuming a session whose connection ended without close_notify.
+  auto connect(boost::asio::ssl::context &context, tls_client_context *sessions, const tls_server &server) -> bool
+  {
+    boost::asio::io_context io_context;
+    boost::asio::ssl::stream<boost::asio::ip::tcp::socket> stream(io_context, context);
+    stream.lowest_layer().connect(server.endpoint());
+    // Without it delayed ACKs, not the handshake, dominate the round trips
+    stream.lowest_layer().set_option(boost::asio::ip::tcp::no_delay(true));
+    if (sessions != nullptr) { sessions->prepare(stream.native_handle(), std::string(host)); }
+    stream.handshake(boost::asio::ssl::stream_base::client);
+
+    std::array<char, 1> byte{};
+    boost::asio::read(stream, boost::asio::buffer(byte));
+    const auto reused = SSL_session_reused(stream.native_handle()) == 1;
+
+    boost::system::error_code error;
+    stream.shutdown(error);
+    return reused;
+  }
+
+  auto trust(boost::asio::ssl::context &context, X509 *cert) -> void
+  {
+    X509_STORE_add_cert(SSL_CTX_get_cert_store(context.native_handle()), cert);
+    context.set_verify_mode(boost::asio::ssl::verify_peer);
+  }
+}// namespace
+
+TEST_CASE("TLS Handshake Benchmarks", "[benchmark][tls]")
+{
+  const auto key = make_key();
+  REQUIRE(key != nullptr);
+  const auto cert = make_self_signed(key.get());
+  const tls_server server(cert.get(), key.get());
+
+  boost::asio::ssl::context cold(boost::asio::ssl::context::tls_client);
+  trust(cold, cert.get());
+
+  tls_client_context resuming(false);
+  trust(resuming.context(), cert.get());
+
+  REQUIRE_FALSE(connect(resuming.context(), &resuming, server));
+  REQUIRE(resuming.cached_sessions() == 1);
+  REQUIRE(connect(resuming.context(), &resuming, server));
+
+  BENCHMARK("Full TLS 1.3 handshake") { return connect(cold, nullptr, server); };
+
+  BENCHMARK("Resumed TLS 1.3 handshake") { return connect(resuming.context(), &resuming, server); };
+}
+
+}// namespace radix_relay::transport::test
@@ -39,12 +39,80 @@ struct noop_bridge
     return { .plaintext = bytes, .should_republish_bundle = false };
   }
 
+  static auto record_peer_compression(const std::string & /*rdx*/, bool /*supported*/) -> void {}
+
+  static auto record_peer_base64_content(const std::string & /*rdx*/, bool /*supported*/) -> void {}
+
   static auto add_contact_and_establish_session_from_base64(const std::string & /*bundle*/,
     const std::string & /*alias*/) -> std::string
   {
     return "RDX:new_contact";
   }
 
+  static auto create_group(const std::string & /*name*/, const std::vector<std::string> & /*members*/)
+    -> std::string
+  {
+    return "fuzz_group_id";
+  }
+
+  static auto create_sender_key_distribution_frames(const std::string & /*group*/,
+    std::uint64_t /*timestamp*/,
+    const std::string & /*version*/) -> std::vector<radix_relay::signal::fan_out_frame>
+  {
+    return {};
+  }
+
+  static auto mark_sender_key_delivered(const std::string & /*group*/, const std::string & /*member_rdx*/) -> void {}
+
+  static auto create_group_message_frame(const std::string & /*group*/,
+    const std::vector<uint8_t> & /*plaintext*/,
+    std::uint64_t /*timestamp*/,
+    const std::string & /*version*/) -> radix_relay::signal::signed_event_frame
+  {
+    return {};
+  }
+
+  static auto process_sender_key_distribution(const std::string & /*rdx*/, const std::vector<uint8_t> & /*bytes*/)
+    -> radix_relay::signal::group_membership
+  {
+    return { .group_id = "fuzz_group_id", .name = "fuzz", .sender_rdx = "RDX:test", .should_republish_bundle = false };
+  }
+
+  static auto decrypt_group_message(const std::string & /*rdx*/,
+    const std::string &group_id,
+    const std::vector<uint8_t> &bytes) -> radix_relay::signal::group_decryption_result
+  {
+    return { .group_id = group_id, .name = "fuzz", .sender_rdx = "RDX:test", .plaintext = bytes };
+  }
+
+  static auto start_file_transfer(const std::string & /*peer*/, const std::string & /*path*/)
+    -> radix_relay::signal::outgoing_transfer
+  {
+    return {};
+  }
+
+  static auto pending_file_transfers() -> std::vector<radix_relay::signal::outgoing_transfer> { return {}; }
+
+  static auto create_transfer_chunk_frame(const std::string & /*transfer_id*/,
+    std::uint32_t /*chunk_index*/,
+    std::uint64_t /*timestamp*/,
+    const std::string & /*version*/) -> radix_relay::signal::signed_event_frame
+  {
+    return {};
+  }
+
+  static auto mark_transfer_chunk_delivered(const std::string & /*transfer_id*/, std::uint32_t /*chunk_index*/)
+    -> bool
+  {
+    return true;
+  }
+
+  static auto process_transfer_chunk(const std::string & /*rdx*/, const std::vector<uint8_t> & /*bytes*/)
+    -> radix_relay::signal::transfer_progress
+  {
+    return {};
+  }
+
   static auto generate_prekey_bundle_announcement(const std::string & /*version*/) -> radix_relay::signal::bundle_info
   {
     return { .announcement_json = "{}", .pre_key_id = 1, .signed_pre_key_id = 1, .kyber_pre_key_id = 1 };
@@ -52,8 +120,23 @@ struct noop_bridge
 
   static auto generate_empty_bundle_announcement(const std::string & /*version*/) -> std::string { return "{}"; }
 
+  static auto generate_empty_bundle_frame(const std::string & /*version*/) -> radix_relay::signal::signed_event_frame
+  {
+    return {};
+  }
+
   static auto extract_rdx_from_bundle_base64(const std::string & /*bundle*/) -> std::string { return "RDX:extracted"; }
 
+  static auto save_discovered_bundle(const radix_relay::signal::cached_bundle & /*bundle*/,
+    const std::string & /*bundle_base64*/) -> void
+  {}
+
+  static auto cached_discovered_bundles() -> std::vector<radix_relay::signal::cached_bundle> { return {}; }
+
+  static auto load_discovered_bundle(const std::string & /*nostr_pubkey*/) -> std::string { return {}; }
+
+  static auto forget_discovered_bundle(const std::string & /*nostr_pubkey*/) -> void {}
+
   static auto assign_contact_alias(const std::string & /*rdx*/, const std::string & /*alias*/) -> void {}
 
   static auto create_and_sign_encrypted_message(const std::string & /*rdx*/,
@@ -66,13 +149,42 @@ struct noop_bridge
 
   static auto sign_nostr_event(const std::string & /*event*/) -> std::string { return "{}"; }
 
-  static auto create_subscription_for_self(const std::string &sub_id, std::uint64_t /*since*/ = 0) -> std::string
+  static auto create_encrypted_message_frame(const std::string & /*rdx*/,
+    const std::vector<uint8_t> & /*ciphertext*/,
+    std::uint64_t /*timestamp*/,
+    const std::string & /*version*/) -> radix_relay::signal::signed_event_frame
+  {
+    return {};
+  }
+
+  static auto create_encrypted_message_frames(const std::vector<std::string> & /*peers*/,
+    const std::vector<uint8_t> & /*plaintext*/,
+    std::uint64_t /*timestamp*/,
+    const std::string & /*version*/) -> std::vector<radix_relay::signal::fan_out_frame>
   {
-    return R"(["REQ",")" + sub_id + R"(",{}])";
+    return {};
+  }
+
+  static auto sign_event_frame(std::uint32_t /*kind*/,
+    const std::vector<std::vector<std::string>> & /*tags*/,
+    const std::string & /*content*/,
+    std::uint64_t /*created_at*/) -> radix_relay::signal::signed_event_frame
+  {
+    return {};
+  }
+
+  static auto message_subscription(std::uint64_t since = 0) -> radix_relay::signal::message_subscription
+  {
+    return { .our_pubkey = {}, .group_ids = {}, .since = since };
   }
 
   static auto update_last_message_timestamp(std::uint64_t /*timestamp*/) -> void {}
 
+  static auto verify_events(const std::vector<std::string> &event_jsons) -> std::vector<bool>
+  {
+    return std::vector<bool>(event_jsons.size(), true);
+  }
+
   static auto perform_key_maintenance() -> radix_relay::signal::key_maintenance_result
   {
     return { .signed_pre_key_rotated = false, .kyber_pre_key_rotated = false, .pre_keys_replenished = false };
@@ -124,6 +236,7 @@ struct noop_command_handler
   auto operator()(const radix_relay::core::events::mode & /*cmd*/) const -> void {}
   auto operator()(const radix_relay::core::events::send & /*cmd*/) const -> void {}
   auto operator()(const radix_relay::core::events::broadcast & /*cmd*/) const -> void {}
+  auto operator()(const radix_relay::core::events::create_group & /*cmd*/) const -> void {}
   auto operator()(const radix_relay::core::events::connect & /*cmd*/) const -> void {}
   auto operator()(const radix_relay::core::events::disconnect & /*cmd*/) const -> void {}
   auto operator()(const radix_relay::core::events::trust & /*cmd*/) const -> void {}
@@ -59,8 +59,8 @@ inline auto print_app_banner(const app_state &state) -> void
 inline auto print_available_commands() -> void
 {
   fmt::print(
-    "Available commands: send, broadcast, peers, status, sessions, mode, scan, connect, trust, verify, version, help, "
-    "quit\n\n");
+    "Available commands: send, sendmany, sendfile, broadcast, group, peers, status, sessions, mode, scan, connect, "
+    "trust, verify, version, help, quit\n\n");
 }
 
 /**
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <CLI/CLI.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <map>
 #include <platform/env_utils.hpp>
 #include <spdlog/spdlog.h>
 #include <string>
@@ -17,6 +20,16 @@ struct cli_args
   std::string ui_mode = "gui";///< UI mode (tui/gui)
   bool verbose = false;///< Enable verbose logging
   bool show_version = false;///< Display version and exit
+  bool compress_payloads = false;///< Compress message payloads for peers that support it
+  std::uint32_t pow_difficulty = 0;///< NIP-13 proof-of-work bits for outgoing events (0: none)
+  std::map<std::string, std::uint32_t> relay_pow_difficulty;///< Per-relay proof-of-work bits, by relay URL
+  bool discover_all_bundles = false;///< Subscribe to every bundle announcement on the relay, not just contacts'
+  std::map<std::string, std::size_t> relay_max_subscriptions;///< Per-relay cap on open subscriptions, by relay URL
+  std::uint32_t backfill_page_size = 200;///< Stored messages fetched per page after connecting (0: all at once)
+  bool no_relay_deflate = false;///< Do not offer permessage-deflate to relays, saving CPU
+  int relay_deflate_window_bits = 15;///< permessage-deflate LZ77 window bits (9-15)
+  int relay_deflate_memory_level = 4;///< permessage-deflate zlib memory level (1-9)
+  bool relay_deflate_no_context_takeover = false;///< Compress each relay message on its own
 
   bool send_parsed = false;///< True if send subcommand was used
   std::string send_recipient;///< Recipient for send subcommand
@@ -68,6 +81,23 @@ inline auto setup_cli_app(CLI::App &app, cli_args &args) -> void
   app.add_option("-u,--ui", args.ui_mode, "UI mode: tui, gui")->check(CLI::IsMember({ "tui", "gui" }));
   app.add_flag("-v,--verbose", args.verbose, "Enable verbose logging");
   app.add_flag("--version", args.show_version, "Show version information");
+  app.add_flag("--compress", args.compress_payloads, "Compress message payloads for peers that also opt in");
+  app.add_option("--pow", args.pow_difficulty, "Proof-of-work bits mined into outgoing events (0-255)")
+    ->check(CLI::Range(0, 255));
+  app.add_option("--relay-pow", args.relay_pow_difficulty, "Proof-of-work bits for one relay: <url> <bits>");
+  app.add_flag("--discover-all", args.discover_all_bundles, "Discover every identity on the relay, not just contacts");
+  app.add_option(
+    "--relay-max-subs", args.relay_max_subscriptions, "Subscriptions one relay allows at once: <url> <count>");
+  app.add_option(
+    "--backfill-page", args.backfill_page_size, "Stored messages fetched per page after connecting (0: all at once)");
+  app.add_flag("--no-relay-deflate", args.no_relay_deflate, "Do not compress relay traffic (saves CPU on slow nodes)");
+  app.add_option("--relay-deflate-window", args.relay_deflate_window_bits, "Relay compression window bits (9-15)")
+    ->check(CLI::Range(9, 15));
+  app.add_option("--relay-deflate-mem-level", args.relay_deflate_memory_level, "Relay compression memory level (1-9)")
+    ->check(CLI::Range(1, 9));
+  app.add_flag("--relay-deflate-no-context-takeover",
+    args.relay_deflate_no_context_takeover,
+    "Compress each relay message on its own, using less memory");
 
   auto *send_cmd = app.add_subcommand("send", "Send a message");
   send_cmd->add_option("recipient", args.send_recipient, "Node ID or contact name")->required();
@@ -99,6 +129,21 @@ inline auto setup_cli_app(CLI::App &app, cli_args &args) -> void
     return false;
   }
 
+  constexpr std::uint32_t max_pow_difficulty = 255;
+  for (const auto &[relay, difficulty] : args.relay_pow_difficulty) {
+    if (difficulty > max_pow_difficulty) {
+      spdlog::error("Invalid proof-of-work difficulty for {}: {}", relay, difficulty);
+      return false;
+    }
+  }
+
+  for (const auto &[relay, max_subscriptions] : args.relay_max_subscriptions) {
+    if (max_subscriptions == 0) {
+      spdlog::error("Invalid subscription limit for {}: {}", relay, max_subscriptions);
+      return false;
+    }
+  }
+
   if (args.send_parsed) {
     if (args.send_recipient.empty()) {
       spdlog::error("Send command requires recipient");
@@ -22,12 +22,19 @@ concept signal_bridge = requires(T bridge,
   const std::string &version,
   const std::string &content,
   const std::vector<uint8_t> &bytes,
+  const std::vector<std::string> &members,
+  const std::vector<std::vector<std::string>> &tags,
   const std::string &subscription_id,
+  const std::string &path,
+  const radix_relay::signal::cached_bundle &cached,
   uint32_t timestamp,
+  std::uint32_t kind,
   std::uint64_t since_timestamp,
   std::uint32_t pre_key_id,
   std::uint32_t signed_pre_key_id,
-  std::uint32_t kyber_pre_key_id) {
+  std::uint32_t kyber_pre_key_id,
+  std::uint32_t chunk_index,
+  bool supported) {
   // Identity and session management
   { bridge.get_node_fingerprint() } -> std::convertible_to<std::string>;
   { bridge.list_contacts() } -> std::convertible_to<std::vector<radix_relay::core::contact_info>>;
@@ -35,15 +42,47 @@ concept signal_bridge = requires(T bridge,
   // Message encryption/decryption
   { bridge.encrypt_message(rdx, bytes) } -> std::convertible_to<std::vector<uint8_t>>;
   { bridge.decrypt_message(rdx, bytes) } -> std::convertible_to<radix_relay::signal::decryption_result>;
+  { bridge.record_peer_compression(rdx, supported) } -> std::same_as<void>;
+  { bridge.record_peer_base64_content(rdx, supported) } -> std::same_as<void>;
 
   // Session establishment
   { bridge.add_contact_and_establish_session_from_base64(bundle, alias) } -> std::convertible_to<std::string>;
 
+  // Sender key groups
+  { bridge.create_group(alias, members) } -> std::convertible_to<std::string>;
+  {
+    bridge.create_sender_key_distribution_frames(alias, since_timestamp, version)
+  } -> std::convertible_to<std::vector<radix_relay::signal::fan_out_frame>>;
+  { bridge.mark_sender_key_delivered(alias, rdx) } -> std::same_as<void>;
+  {
+    bridge.create_group_message_frame(alias, bytes, since_timestamp, version)
+  } -> std::convertible_to<radix_relay::signal::signed_event_frame>;
+  { bridge.process_sender_key_distribution(rdx, bytes) } -> std::convertible_to<radix_relay::signal::group_membership>;
+  {
+    bridge.decrypt_group_message(rdx, alias, bytes)
+  } -> std::convertible_to<radix_relay::signal::group_decryption_result>;
+
+  // Chunked file transfer
+  { bridge.start_file_transfer(rdx, path) } -> std::convertible_to<radix_relay::signal::outgoing_transfer>;
+  { bridge.pending_file_transfers() } -> std::convertible_to<std::vector<radix_relay::signal::outgoing_transfer>>;
+  {
+    bridge.create_transfer_chunk_frame(subscription_id, chunk_index, since_timestamp, version)
+  } -> std::convertible_to<radix_relay::signal::signed_event_frame>;
+  { bridge.mark_transfer_chunk_delivered(subscription_id, chunk_index) } -> std::convertible_to<bool>;
+  { bridge.process_transfer_chunk(rdx, bytes) } -> std::convertible_to<radix_relay::signal::transfer_progress>;
+
   // Bundle generation
   { bridge.generate_prekey_bundle_announcement(version) } -> std::convertible_to<radix_relay::signal::bundle_info>;
   { bridge.generate_empty_bundle_announcement(version) } -> std::convertible_to<std::string>;
+  { bridge.generate_empty_bundle_frame(version) } -> std::convertible_to<radix_relay::signal::signed_event_frame>;
   { bridge.extract_rdx_from_bundle_base64(bundle) } -> std::convertible_to<std::string>;
 
+  // Discovered bundle cache
+  { bridge.save_discovered_bundle(cached, bundle) } -> std::same_as<void>;
+  { bridge.cached_discovered_bundles() } -> std::convertible_to<std::vector<radix_relay::signal::cached_bundle>>;
+  { bridge.load_discovered_bundle(rdx) } -> std::convertible_to<std::string>;
+  { bridge.forget_discovered_bundle(rdx) } -> std::same_as<void>;
+
   // Contact management
   { bridge.assign_contact_alias(rdx, alias) } -> std::same_as<void>;
   { bridge.lookup_contact(alias) } -> std::convertible_to<radix_relay::core::contact_info>;
@@ -51,10 +90,20 @@ concept signal_bridge = requires(T bridge,
   // Nostr signing
   { bridge.create_and_sign_encrypted_message(rdx, content, timestamp, version) } -> std::convertible_to<std::string>;
   { bridge.sign_nostr_event(content) } -> std::convertible_to<std::string>;
+  {
+    bridge.create_encrypted_message_frame(rdx, bytes, since_timestamp, version)
+  } -> std::convertible_to<radix_relay::signal::signed_event_frame>;
+  {
+    bridge.create_encrypted_message_frames(members, bytes, since_timestamp, version)
+  } -> std::convertible_to<std::vector<radix_relay::signal::fan_out_frame>>;
+  {
+    bridge.sign_event_frame(kind, tags, content, since_timestamp)
+  } -> std::convertible_to<radix_relay::signal::signed_event_frame>;
 
   // Nostr subscription
-  { bridge.create_subscription_for_self(subscription_id, since_timestamp) } -> std::convertible_to<std::string>;
+  { bridge.message_subscription(since_timestamp) } -> std::convertible_to<radix_relay::signal::message_subscription>;
   { bridge.update_last_message_timestamp(since_timestamp) } -> std::same_as<void>;
+  { bridge.verify_events(members) } -> std::convertible_to<std::vector<bool>>;
 
   // Key maintenance
   { bridge.perform_key_maintenance() } -> std::convertible_to<radix_relay::signal::key_maintenance_result>;
@@ -4,8 +4,11 @@
 #include <boost/system/error_code.hpp>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <span>
+#include <string>
+#include <string_view>
 
 namespace radix_relay::concepts {
 
@@ -32,4 +35,47 @@ concept transport_stream = requires(T &stream,
   { stream.async_close(handler) } -> std::same_as<void>;
 };
 
+/**
+ * @brief Concept for transport streams that can also fetch a document from their endpoint.
+ *
+ * Used for metadata served next to the stream itself, such as the NIP-11 information document
+ * a Nostr relay returns over plain HTTPS when asked with its own Accept header. The fetch uses
+ * its own short-lived connection and never touches the stream's connection state.
+ */
+template<typename T>
+concept document_fetching_stream = transport_stream<T>
+                                   and requires(T &stream,
+                                     typename T::connection_params_t params,
+                                     std::string_view accept,
+                                     std::function<void(const boost::system::error_code &, std::string)> handler) {
+                                     { stream.async_fetch_document(params, accept, handler) } -> std::same_as<void>;
+                                   };
+
+/**
+ * @brief Concept for transport streams that can measure round trips to their peer.
+ *
+ * `async_ping` completes once the peer has answered the ping, so the time between the call
+ * and the handler is one round trip over the open connection.
+ */
+template<typename T>
+concept pinging_stream = transport_stream<T> and requires(T &stream,
+  std::function<void(const boost::system::error_code &)> handler) {
+  { stream.async_ping(handler) } -> std::same_as<void>;
+};
+
+/**
+ * @brief Concept for transport streams that count the bytes they move.
+ *
+ * `traffic()` returns running totals for the current connection: message bytes as the
+ * caller wrote and read them, and wire bytes as they crossed the link after compression,
+ * framing and encryption.
+ */
+template<typename T>
+concept traffic_counting_stream = transport_stream<T> and requires(T &stream) {
+  { stream.traffic().message_bytes_sent } -> std::convertible_to<std::uint64_t>;
+  { stream.traffic().message_bytes_received } -> std::convertible_to<std::uint64_t>;
+  { stream.traffic().wire_bytes_sent } -> std::convertible_to<std::uint64_t>;
+  { stream.traffic().wire_bytes_received } -> std::convertible_to<std::uint64_t>;
+};
+
 }// namespace radix_relay::concepts
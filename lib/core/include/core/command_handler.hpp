@@ -53,10 +53,11 @@ auto make_command_handler(std::shared_ptr<Bridge> bridge,
     [ctx](const events::help &) {
       ctx->emit(
         "Interactive Commands:\n"
-        "  /broadcast <message>          Send to all local peers\n"
+        "  /broadcast <group> <message>  Send one message to every group member\n"
         "  /chat <contact>               Enter chat mode with contact\n"
-        "  /connect <relay>              Add Nostr relay\n"
+        "  /connect <relay>...           Connect to the healthiest of the relays\n"
         "  /disconnect                   Disconnect from Nostr relay\n"
+        "  /group <name> <contact>...    Create a group with contacts\n"
         "  /identities                   List discovered identities\n"
         "  /leave                        Exit chat mode\n"
         "  /mode <internet|mesh|hybrid>  Switch transport mode\n"
@@ -64,6 +65,8 @@ auto make_command_handler(std::shared_ptr<Bridge> bridge,
         "  /publish                      Publish identity to network\n"
         "  /scan                         Force peer discovery\n"
         "  /send <peer> <message>        Send encrypted message to peer\n"
+        "  /sendfile <peer> <path>       Send a file to peer in encrypted chunks\n"
+        "  /sendmany <p1,p2,...> <msg>   Send one message to several peers\n"
         "  /sessions                     Show encrypted sessions\n"
         "  /status                       Show network status\n"
         "  /trust <peer> [alias]         Establish session with peer\n"
@@ -139,11 +142,39 @@ auto make_command_handler(std::shared_ptr<Bridge> bridge,
       }
     },
 
+    [ctx](const events::send_many &command) {
+      if (not command.peers.empty() and not command.message.empty()) {
+        ctx->session_queue->push(command);
+        ctx->emit("Sending '{}' to {} recipient(s)...\n", command.message, command.peers.size());
+      } else {
+        ctx->emit("Usage: sendmany <peer>,<peer>... <message>\n");
+      }
+    },
+
+    [ctx](const events::send_file &command) {
+      if (not command.peer.empty() and not command.path.empty()) {
+        ctx->session_queue->push(command);
+        ctx->emit("Sending file '{}' to '{}'...\n", command.path, command.peer);
+      } else {
+        ctx->emit("Usage: sendfile <peer> <path>\n");
+      }
+    },
+
     [ctx](const events::broadcast &command) {
-      if (not command.message.empty()) {
-        ctx->emit("Broadcasting '{}' to all local peers (not implemented)\n", command.message);
+      if (not command.group.empty() and not command.message.empty()) {
+        ctx->session_queue->push(command);
+        ctx->emit("Broadcasting '{}' to group '{}'...\n", command.message, command.group);
+      } else {
+        ctx->emit("Usage: broadcast <group> <message>\n");
+      }
+    },
+
+    [ctx](const events::create_group &command) {
+      if (not command.name.empty() and not command.members.empty()) {
+        ctx->session_queue->push(command);
+        ctx->emit("Creating group '{}' with {} member(s)...\n", command.name, command.members.size());
       } else {
-        ctx->emit("Usage: broadcast <message>\n");
+        ctx->emit("Usage: group <name> <contact>...\n");
       }
     },
 
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <algorithm>
 #include <concepts/signal_bridge.hpp>
 #include <core/events.hpp>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <optional>
+#include <ranges>
+#include <sstream>
 #include <string>
 #include <string_view>
 #include <variant>
@@ -33,7 +37,10 @@ template<concepts::signal_bridge Bridge> struct command_parser
     events::version,
     events::mode,
     events::send,
+    events::send_many,
+    events::send_file,
     events::broadcast,
+    events::create_group,
     events::connect,
     events::disconnect,
     events::publish_identity,
@@ -184,8 +191,36 @@ private:
       prefix_match<events::verify>("/verify ", [](const std::string &args) { return events::verify{ .peer = args }; }));
 
     // Less frequent commands
-    handlers_.push_back(prefix_match<events::broadcast>(
-      "/broadcast ", [](const std::string &args) { return events::broadcast{ .message = args }; }));
+    handlers_.push_back(prefix_match<events::send_many>("/sendmany ", [](const std::string &args) {
+      const auto first_space = args.find(' ');
+      if (first_space == std::string::npos) { return events::send_many{ .peers = {}, .message = "" }; }
+      events::send_many command{ .peers = {}, .message = args.substr(first_space + 1) };
+      for (const auto peer : std::views::split(std::string_view(args).substr(0, first_space), ',')) {
+        if (not peer.empty()) { command.peers.emplace_back(peer.begin(), peer.end()); }
+      }
+      return command;
+    }));
+    handlers_.push_back(prefix_match<events::send_file>("/sendfile ", [](const std::string &args) {
+      const auto first_space = args.find(' ');
+      if (first_space != std::string::npos) {
+        return events::send_file{ .peer = args.substr(0, first_space), .path = args.substr(first_space + 1) };
+      }
+      return events::send_file{ .peer = "", .path = "" };
+    }));
+    handlers_.push_back(prefix_match<events::broadcast>("/broadcast ", [](const std::string &args) {
+      const auto first_space = args.find(' ');
+      if (first_space != std::string::npos and not args.empty()) {
+        return events::broadcast{ .group = args.substr(0, first_space), .message = args.substr(first_space + 1) };
+      }
+      return events::broadcast{ .group = "", .message = "" };
+    }));
+    handlers_.push_back(prefix_match<events::create_group>("/group ", [](const std::string &args) {
+      std::istringstream words(args);
+      events::create_group command;
+      words >> command.name;
+      std::ranges::copy(std::ranges::istream_view<std::string>(words), std::back_inserter(command.members));
+      return command;
+    }));
     handlers_.push_back(
       prefix_match<events::mode>("/mode ", [](const std::string &args) { return events::mode{ .new_mode = args }; }));
     handlers_.push_back(exact_match<events::scan>("/scan"));
@@ -3,6 +3,7 @@
 #include <async/async_queue.hpp>
 #include <core/events.hpp>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
@@ -23,6 +24,8 @@ struct connection_status
 {
   std::optional<transport_state> internet;
   std::optional<transport_state> bluetooth;
+  std::map<std::string, events::connection_monitor::relay_stats> relays;
+  std::map<std::string, events::transport::traffic_measured> traffic;///< Bytes exchanged per relay this run
 };
 
 class connection_monitor
@@ -48,6 +51,8 @@ public:
   auto handle(const events::transport::connect_failed &event) -> void;
   auto handle(const events::transport::disconnected &event) -> void;
   auto handle(const events::transport::send_failed &event) -> void;
+  auto handle(const events::transport::traffic_measured &event) -> void;
+  auto handle(const events::connection_monitor::relay_stats &event) -> void;
   auto handle(const events::connection_monitor::query_status &event) -> void;
 
   [[nodiscard]] auto get_status() const -> connection_status;
@@ -55,6 +60,8 @@ public:
 private:
   std::shared_ptr<async::async_queue<events::display_filter_input_t>> display_out_queue_;
   std::unordered_map<events::transport_type, transport_state> states_;
+  std::map<std::string, events::connection_monitor::relay_stats> relays_;
+  std::map<std::string, events::transport::traffic_measured> traffic_;
 };
 
 }// namespace radix_relay::core
@@ -58,12 +58,34 @@ struct send
   std::string message;///< Message content to send
 };
 
-/// Broadcast message to all peers
+/// Send the same encrypted message to several peers at once
+struct send_many
+{
+  std::vector<std::string> peers;///< RDX fingerprints or aliases of recipients
+  std::string message;///< Message content to send
+};
+
+/// Send a file to a specific peer in encrypted chunks
+struct send_file
+{
+  std::string peer;///< RDX fingerprint or alias of recipient
+  std::string path;///< Local path of the file to send
+};
+
+/// Broadcast message to every member of a group
 struct broadcast
 {
+  std::string group;///< Group name or ID
   std::string message;///< Message content to broadcast
 };
 
+/// Create a sender key group with existing contacts
+struct create_group
+{
+  std::string name;///< Human-readable group name
+  std::vector<std::string> members;///< RDX fingerprints or aliases of the other members
+};
+
 /// Connect to a relay
 struct connect
 {
@@ -165,6 +187,7 @@ struct bundle_announcement_received
   std::string pubkey;///< Nostr public key
   std::string bundle_content;///< Bundle data
   std::string event_id;///< Nostr event ID
+  std::uint64_t created_at{ 0 };///< Announcement timestamp
 };
 
 /// Notification of removed bundle announcement
@@ -201,6 +224,35 @@ struct message_sent
   bool accepted;///< Whether relay accepted the message
 };
 
+/// Aggregated relay acceptance of a multi-recipient send
+struct send_many_report
+{
+  std::vector<std::string> accepted;///< Recipients whose event the relay accepted
+  std::vector<std::string> failed;///< Recipients that were skipped or rejected
+};
+
+/// Progress of a chunked file transfer in either direction
+struct file_transfer_progress
+{
+  std::string transfer_id;///< Transfer identifier
+  std::string peer;///< RDX fingerprint of the other party
+  std::string name;///< File name
+  std::uint32_t chunks_done;///< Chunks accepted by the relay (outgoing) or received (incoming)
+  std::uint32_t chunk_count;///< Number of chunks in the transfer
+  bool outgoing;///< Whether this node is the sender
+  bool complete;///< Whether every chunk is through; incoming files are verified and saved
+  std::string path;///< Saved file for completed incoming transfers
+  std::string error;///< Why an outgoing transfer paused, empty otherwise
+};
+
+/// Progress of fetching stored messages page by page after connecting
+struct backfill_progress
+{
+  std::uint32_t pages;///< Pages the relay has answered so far
+  std::uint64_t messages;///< Distinct stored messages received so far
+  bool complete;///< Whether the fetch reached the last stored message
+};
+
 /// Notification of published bundle status
 struct bundle_published
 {
@@ -214,6 +266,33 @@ struct subscription_established
   std::string subscription_id;///< Subscription identifier
 };
 
+/// Notification of a group created locally
+struct group_created
+{
+  std::string group_id;///< Sender key distribution ID of the group
+  std::string name;///< Human-readable group name
+};
+
+/// Notification of joining a group after receiving a member's sender key
+struct group_joined
+{
+  std::string group_id;///< Sender key distribution ID of the group
+  std::string name;///< Human-readable group name
+  std::string sender_rdx;///< RDX fingerprint of the member whose sender key arrived
+  bool should_republish_bundle;///< Whether to republish prekey bundle
+};
+
+/// Notification of received group message
+struct group_message_received
+{
+  std::string group_id;///< Sender key distribution ID of the group
+  std::string group_name;///< Human-readable group name
+  std::string sender_rdx;///< RDX fingerprint of sender
+  std::string sender_alias;///< Alias of sender (if known)
+  std::string content;///< Decrypted message content
+  std::uint64_t timestamp;///< Message timestamp
+};
+
 /// Transport type discriminator
 enum class transport_type { internet, bluetooth };
 
@@ -226,11 +305,24 @@ namespace transport {
     std::string url;///< Transport endpoint URL
   };
 
+  /// Limits a relay advertises in its NIP-11 information document; unset fields are not advertised
+  struct relay_limits
+  {
+    std::optional<std::size_t> max_message_length;///< Largest WebSocket message the relay accepts, in bytes
+    std::optional<std::size_t> max_subscriptions;///< Subscriptions one connection may hold open
+    std::optional<std::uint32_t> max_limit;///< Largest filter `limit` the relay honours
+    std::optional<std::uint32_t> min_pow_difficulty;///< NIP-13 leading zero bits required on published events
+
+    auto operator==(const relay_limits &) const -> bool = default;
+  };
+
   /// Notification of successful connection
   struct connected
   {
     std::string url;///< Connected transport endpoint URL
     transport_type type;///< Type of transport
+    relay_limits limits{};///< Limits of the relay, empty if it publishes none
+    std::optional<std::uint64_t> connect_ms;///< Time to resolve, connect and upgrade, in milliseconds
   };
 
   /// Notification of failed connection attempt
@@ -248,6 +340,15 @@ namespace transport {
     std::vector<std::byte> bytes;///< Raw data to send
   };
 
+  /// Command to send several frames as one queued unit
+  ///
+  /// Frames are written back to back in order and reported with a single sent or send_failed.
+  struct send_batch
+  {
+    std::string message_id;///< Unique identifier for the whole batch
+    std::vector<std::vector<std::byte>> frames;///< Raw frames to send
+  };
+
   /// Notification of successful send
   struct sent
   {
@@ -274,6 +375,23 @@ namespace transport {
   {
   };
 
+  /// Round trip of a WebSocket ping answered by the relay
+  struct ping_measured
+  {
+    std::string url;///< Relay URL the ping went to
+    std::uint64_t rtt_ms;///< Time from ping to pong, in milliseconds
+  };
+
+  /// Bytes exchanged with the relay since the previous report
+  struct traffic_measured
+  {
+    std::string url;///< Relay URL the bytes went to and came from
+    std::uint64_t message_bytes_sent{ 0 };///< Message payload sent, before compression
+    std::uint64_t message_bytes_received{ 0 };///< Message payload received, after decompression
+    std::uint64_t wire_bytes_sent{ 0 };///< Bytes sent on the link, after compression, framing and TLS
+    std::uint64_t wire_bytes_received{ 0 };///< Bytes received on the link
+  };
+
   /// Notification of disconnection
   struct disconnected
   {
@@ -282,15 +400,17 @@ namespace transport {
 
   /// Concept for transport command types
   template<typename T>
-  concept Command = std::same_as<T, connect> or std::same_as<T, send> or std::same_as<T, disconnect>;
+  concept Command = std::same_as<T, connect> or std::same_as<T, send> or std::same_as<T, send_batch>
+                    or std::same_as<T, disconnect>;
 
   /// Concept for transport event types
   template<typename T>
   concept Event = std::same_as<T, connected> or std::same_as<T, connect_failed> or std::same_as<T, sent>
-                  or std::same_as<T, send_failed> or std::same_as<T, bytes_received> or std::same_as<T, disconnected>;
+                  or std::same_as<T, send_failed> or std::same_as<T, bytes_received> or std::same_as<T, disconnected>
+                  or std::same_as<T, ping_measured> or std::same_as<T, traffic_measured>;
 
   /// Variant type for transport input events
-  using in_t = std::variant<connect, send, disconnect>;
+  using in_t = std::variant<connect, send, send_batch, disconnect>;
 
 }// namespace transport
 
@@ -300,11 +420,28 @@ namespace connection_monitor {
   {
   };
 
+  /// Latency and health of one relay, as measured by the session orchestrator
+  struct relay_stats
+  {
+    std::string url;///< Relay URL
+    std::optional<std::uint32_t> score;///< Health score from 0 to 100, unset until a request completed or failed
+    std::optional<std::uint64_t> ok_p50_ms;///< Median time from sending an EVENT to its OK
+    std::optional<std::uint64_t> ok_p99_ms;///< 99th percentile time from sending an EVENT to its OK
+    std::optional<std::uint64_t> eose_p50_ms;///< Median time from sending a REQ to its EOSE
+    std::optional<std::uint64_t> ping_ms;///< Latest WebSocket ping round trip
+    std::optional<std::uint64_t> connect_p50_ms;///< Median time to open a connection to the relay
+    std::optional<std::uint64_t> connect_p99_ms;///< 99th percentile time to open a connection to the relay
+    std::uint64_t request_timeout_ms{ 0 };///< Timeout currently applied to OK waits on this relay
+    std::uint64_t timeouts{ 0 };///< Requests the relay never answered
+  };
+
   /// Variant type for connection monitor input events
   using in_t = std::variant<transport::connected,
     transport::connect_failed,
     transport::disconnected,
     transport::send_failed,
+    transport::traffic_measured,
+    relay_stats,
     query_status>;
 
 }// namespace connection_monitor
@@ -314,11 +451,13 @@ template<typename T>
 concept Command =
   std::same_as<T, help> or std::same_as<T, peers> or std::same_as<T, status> or std::same_as<T, sessions>
   or std::same_as<T, identities> or std::same_as<T, scan> or std::same_as<T, version> or std::same_as<T, mode>
-  or std::same_as<T, send> or std::same_as<T, broadcast> or std::same_as<T, connect> or std::same_as<T, disconnect>
+  or std::same_as<T, send> or std::same_as<T, send_many> or std::same_as<T, send_file> or std::same_as<T, broadcast>
+  or std::same_as<T, create_group> or std::same_as<T, connect> or std::same_as<T, disconnect>
   or std::same_as<T, publish_identity> or std::same_as<T, unpublish_identity> or std::same_as<T, trust>
-  or std::same_as<T, verify> or std::same_as<T, subscribe> or std::same_as<T, subscribe_identities>
-  or std::same_as<T, subscribe_messages> or std::same_as<T, establish_session> or std::same_as<T, chat>
-  or std::same_as<T, leave> or std::same_as<T, unknown_command>;
+  or std::same_as<T, verify>
+  or std::same_as<T, subscribe> or std::same_as<T, subscribe_identities> or std::same_as<T, subscribe_messages>
+  or std::same_as<T, establish_session> or std::same_as<T, chat> or std::same_as<T, leave>
+  or std::same_as<T, unknown_command>;
 
 /// Concept for presentation layer event types
 template<typename T>
@@ -326,7 +465,9 @@ concept PresentationEvent =
   std::same_as<T, message_received> or std::same_as<T, session_established>
   or std::same_as<T, bundle_announcement_received> or std::same_as<T, bundle_announcement_removed>
   or std::same_as<T, message_sent> or std::same_as<T, bundle_published> or std::same_as<T, subscription_established>
-  or std::same_as<T, identities_listed>;
+  or std::same_as<T, identities_listed> or std::same_as<T, group_created> or std::same_as<T, group_joined>
+  or std::same_as<T, group_message_received> or std::same_as<T, send_many_report>
+  or std::same_as<T, file_transfer_progress> or std::same_as<T, backfill_progress>;
 
 /// Variant type for presentation events
 using presentation_event_variant_t = std::variant<message_received,
@@ -336,7 +477,13 @@ using presentation_event_variant_t = std::variant<message_received,
   message_sent,
   bundle_published,
   subscription_established,
-  identities_listed>;
+  identities_listed,
+  group_created,
+  group_joined,
+  group_message_received,
+  send_many_report,
+  file_transfer_progress,
+  backfill_progress>;
 
 /// Concept for all event types
 template<typename T>
@@ -347,6 +494,10 @@ namespace session_orchestrator {
 
   /// Variant of commands from main to session orchestrator
   using command_from_main_variant_t = std::variant<send,
+    send_many,
+    send_file,
+    broadcast,
+    create_group,
     publish_identity,
     unpublish_identity,
     trust,
@@ -357,6 +508,10 @@ namespace session_orchestrator {
 
   /// Variant of all input events to session orchestrator
   using in_t = std::variant<send,
+    send_many,
+    send_file,
+    broadcast,
+    create_group,
     publish_identity,
     unpublish_identity,
     trust,
@@ -371,6 +526,8 @@ namespace session_orchestrator {
     transport::sent,
     transport::send_failed,
     transport::disconnected,
+    transport::ping_measured,
+    transport::traffic_measured,
     bundle_announcement_received,
     bundle_announcement_removed>;
 
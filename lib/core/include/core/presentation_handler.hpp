@@ -3,6 +3,7 @@
 #include <async/async_queue.hpp>
 #include <core/events.hpp>
 #include <fmt/core.h>
+#include <fmt/ranges.h>
 #include <memory>
 #include <platform/time_utils.hpp>
 #include <spdlog/spdlog.h>
@@ -167,6 +168,171 @@ struct presentation_handler
     }
   }
 
+  /**
+   * @brief Handles a send_many report with the outcome for every recipient.
+   *
+   * @param evt Send many report event
+   */
+  auto handle(const events::send_many_report &evt) const -> void
+  {
+    const auto total = evt.accepted.size() + evt.failed.size();
+    if (evt.failed.empty()) {
+      emit(events::display_message::source::outgoing_message,
+        std::nullopt,
+        platform::current_timestamp_ms(),
+        "Message sent to {}/{} recipients\n",
+        evt.accepted.size(),
+        total);
+    } else {
+      emit(events::display_message::source::outgoing_message,
+        std::nullopt,
+        platform::current_timestamp_ms(),
+        "Message sent to {}/{} recipients (failed: {})\n",
+        evt.accepted.size(),
+        total,
+        fmt::join(evt.failed, ", "));
+    }
+  }
+
+  /**
+   * @brief Handles progress of the stored message fetch.
+   *
+   * A fetch that found nothing missed is only logged.
+   *
+   * @param evt Backfill progress event
+   */
+  auto handle(const events::backfill_progress &evt) const -> void
+  {
+    if (evt.complete and evt.messages == 0) {
+      spdlog::debug("Message history up to date after {} pages", evt.pages);
+    } else if (evt.complete) {
+      emit(events::display_message::source::system,
+        std::nullopt,
+        platform::current_timestamp_ms(),
+        "Fetched {} stored messages in {} pages\n",
+        evt.messages,
+        evt.pages);
+    } else {
+      emit(events::display_message::source::system,
+        std::nullopt,
+        platform::current_timestamp_ms(),
+        "Fetching stored messages: {} so far ({} pages)\n",
+        evt.messages,
+        evt.pages);
+    }
+  }
+
+  /**
+   * @brief Handles progress of a chunked file transfer in either direction.
+   *
+   * @param evt File transfer progress event
+   */
+  auto handle(const events::file_transfer_progress &evt) const -> void
+  {
+    const auto timestamp = platform::current_timestamp_ms();
+    if (not evt.outgoing) {
+      if (evt.complete) {
+        emit(events::display_message::source::incoming_message,
+          evt.peer,
+          timestamp,
+          "File '{}' from {} saved to {}\n",
+          evt.name,
+          evt.peer,
+          evt.path);
+      } else {
+        emit(events::display_message::source::incoming_message,
+          evt.peer,
+          timestamp,
+          "Receiving file '{}' from {} ({} chunks)\n",
+          evt.name,
+          evt.peer,
+          evt.chunk_count);
+      }
+    } else if (not evt.error.empty() and evt.chunk_count == 0) {
+      emit(events::display_message::source::outgoing_message,
+        std::nullopt,
+        timestamp,
+        "Cannot send file '{}' to {}: {}\n",
+        evt.name,
+        evt.peer,
+        evt.error);
+    } else if (not evt.error.empty()) {
+      emit(events::display_message::source::outgoing_message,
+        evt.peer,
+        timestamp,
+        "File '{}' to {} paused at {}/{} chunks, resuming on reconnect: {}\n",
+        evt.name,
+        evt.peer,
+        evt.chunks_done,
+        evt.chunk_count,
+        evt.error);
+    } else if (evt.complete) {
+      emit(events::display_message::source::outgoing_message,
+        evt.peer,
+        timestamp,
+        "File '{}' sent to {} ({} chunks)\n",
+        evt.name,
+        evt.peer,
+        evt.chunk_count);
+    } else {
+      emit(events::display_message::source::outgoing_message,
+        evt.peer,
+        timestamp,
+        "Sending file '{}' to {} ({}/{} chunks delivered)\n",
+        evt.name,
+        evt.peer,
+        evt.chunks_done,
+        evt.chunk_count);
+    }
+  }
+
+  /**
+   * @brief Handles a group created event.
+   *
+   * @param evt Group created event
+   */
+  auto handle(const events::group_created &evt) const -> void
+  {
+    emit(events::display_message::source::command_feedback,
+      std::nullopt,
+      platform::current_timestamp_ms(),
+      "Group '{}' created ({})\n",
+      evt.name,
+      evt.group_id);
+  }
+
+  /**
+   * @brief Handles a group joined event.
+   *
+   * @param evt Group joined event
+   */
+  auto handle(const events::group_joined &evt) const -> void
+  {
+    emit(events::display_message::source::session_event,
+      evt.sender_rdx,
+      platform::current_timestamp_ms(),
+      "Received sender key for group '{}' from {}\n",
+      evt.name,
+      evt.sender_rdx);
+  }
+
+  /**
+   * @brief Handles a received group message event.
+   *
+   * @param evt Group message received event
+   */
+  auto handle(const events::group_message_received &evt) const -> void
+  {
+    const auto &sender_display = evt.sender_alias.empty() ? evt.sender_rdx : evt.sender_alias;
+    emit(events::display_message::source::incoming_message,
+      evt.sender_rdx,
+      evt.timestamp,
+      "[{}] Message from {}: {}\n",
+      evt.group_name,
+      sender_display,
+      evt.content);
+  }
+
 private:
   std::shared_ptr<async::async_queue<events::display_filter_input_t>> display_out_queue_;
 
@@ -5,6 +5,41 @@
 
 namespace radix_relay::core {
 
+namespace {
+
+  auto format_latency(const std::optional<std::uint64_t> &latency) -> std::string
+  {
+    return latency ? fmt::format("{} ms", *latency) : std::string("-");
+  }
+
+  auto format_relay(const events::connection_monitor::relay_stats &relay) -> std::string
+  {
+    return fmt::format(
+      "    {}: score {}, OK p50 {} p99 {}, EOSE p50 {}, ping {}, connect p50 {} p99 {}, timeout {} ms, {} timeouts\n",
+      relay.url,
+      relay.score ? std::to_string(*relay.score) : std::string("-"),
+      format_latency(relay.ok_p50_ms),
+      format_latency(relay.ok_p99_ms),
+      format_latency(relay.eose_p50_ms),
+      format_latency(relay.ping_ms),
+      format_latency(relay.connect_p50_ms),
+      format_latency(relay.connect_p99_ms),
+      relay.request_timeout_ms,
+      relay.timeouts);
+  }
+
+  auto format_traffic(const events::transport::traffic_measured &traffic) -> std::string
+  {
+    return fmt::format("    {}: sent {} B ({} B on the wire), received {} B ({} B on the wire)\n",
+      traffic.url,
+      traffic.message_bytes_sent,
+      traffic.wire_bytes_sent,
+      traffic.message_bytes_received,
+      traffic.wire_bytes_received);
+  }
+
+}// namespace
+
 auto connection_monitor::handle(const events::transport::connected &event) -> void
 {
   auto timestamp = static_cast<std::uint64_t>(
@@ -46,6 +81,21 @@ auto connection_monitor::handle(const events::transport::send_failed &event) ->
   }
 }
 
+auto connection_monitor::handle(const events::transport::traffic_measured &event) -> void
+{
+  auto &total = traffic_[event.url];
+  total.url = event.url;
+  total.message_bytes_sent += event.message_bytes_sent;
+  total.message_bytes_received += event.message_bytes_received;
+  total.wire_bytes_sent += event.wire_bytes_sent;
+  total.wire_bytes_received += event.wire_bytes_received;
+}
+
+auto connection_monitor::handle(const events::connection_monitor::relay_stats &event) -> void
+{
+  relays_[event.url] = event;
+}
+
 auto connection_monitor::handle(const events::connection_monitor::query_status & /*event*/) -> void
 {
   auto status = get_status();
@@ -68,8 +118,20 @@ auto connection_monitor::handle(const events::connection_monitor::query_status &
     }
   }
 
-  auto message = fmt::format(
-    "Network Status:\n  Internet: {}\n  BLE Mesh: {}\n  Active Sessions: 0\n", internet_status, bluetooth_status);
+  std::string relays;
+  if (not status.relays.empty()) {
+    relays = "  Relays:\n";
+    for (const auto &[url, relay] : status.relays) { relays += format_relay(relay); }
+  }
+  if (not status.traffic.empty()) {
+    relays += "  Traffic:\n";
+    for (const auto &[url, traffic] : status.traffic) { relays += format_traffic(traffic); }
+  }
+
+  auto message = fmt::format("Network Status:\n  Internet: {}\n{}  BLE Mesh: {}\n  Active Sessions: 0\n",
+    internet_status,
+    relays,
+    bluetooth_status);
   display_out_queue_->push(events::display_message{ .message = message,
     .contact_rdx = std::nullopt,
     .timestamp = platform::current_timestamp_ms(),
@@ -88,6 +150,9 @@ auto connection_monitor::get_status() const -> connection_status
     status.bluetooth = states_.at(events::transport_type::bluetooth);
   }
 
+  status.relays = relays_;
+  status.traffic = traffic_;
+
   return status;
 }
 
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <nostr/sha256.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace radix_relay::nostr {
+
+/**
+ * @brief Information about a discovered prekey bundle.
+ */
+struct discovered_bundle
+{
+  std::string rdx_fingerprint;///< RDX fingerprint from bundle (empty until first needed)
+  std::string nostr_pubkey;///< Nostr public key
+  std::string bundle_base64;///< Base64-encoded bundle data (empty once evicted from memory)
+  std::string event_id;///< Nostr event ID
+  std::uint64_t created_at{ 0 };///< Announcement timestamp
+  sha256_digest bundle_hash{};///< SHA-256 of the bundle data, set by the registry
+};
+
+/**
+ * @brief Discovered prekey bundles indexed by Nostr pubkey and RDX fingerprint.
+ *
+ * Holds one bundle per pubkey; a newer announcement replaces an older one. Bundle bodies are
+ * several kilobytes each, so their total size is capped: once over the cap, the bodies used
+ * least recently are dropped while the identity itself stays listed. The most recently stored
+ * or used body is always kept. An evicted body comes back with the next announcement.
+ *
+ * RDX fingerprints are filled in lazily with set_rdx_fingerprint(). A re-announcement of
+ * identical bundle data keeps the fingerprint already worked out for it.
+ */
+class bundle_registry
+{
+public:
+  /// Bundle body bytes kept when no cap is given
+  static constexpr std::size_t default_max_body_bytes = std::size_t{ 16 } * 1024 * 1024;
+
+  /**
+   * @brief Constructs an empty registry.
+   *
+   * @param max_body_bytes Cap on the total size of resident bundle bodies
+   */
+  explicit bundle_registry(std::size_t max_body_bytes = default_max_body_bytes) : max_body_bytes_(max_body_bytes) {}
+
+  /**
+   * @brief Stores a bundle unless a newer one is already known for its pubkey.
+   *
+   * If the bundle has no RDX fingerprint and its data matches the stored bundle, the stored
+   * fingerprint is kept.
+   *
+   * @param bundle Bundle from an announcement
+   * @return true if stored, false if older than the stored bundle
+   */
+  auto upsert(discovered_bundle bundle) -> bool;
+
+  /**
+   * @brief Records the RDX fingerprint worked out for a bundle.
+   *
+   * @param nostr_pubkey Nostr public key of the bundle
+   * @param rdx_fingerprint RDX fingerprint extracted from the bundle data
+   */
+  auto set_rdx_fingerprint(const std::string &nostr_pubkey, std::string rdx_fingerprint) -> void;
+
+  /**
+   * @brief Forgets the bundle of a pubkey.
+   *
+   * @param nostr_pubkey Nostr public key
+   * @return true if a bundle was removed
+   */
+  auto erase(const std::string &nostr_pubkey) -> bool;
+
+  /**
+   * @brief Looks up a bundle by pubkey.
+   *
+   * @param nostr_pubkey Nostr public key
+   * @return The bundle, or nullptr if unknown
+   */
+  [[nodiscard]] auto find_by_pubkey(const std::string &nostr_pubkey) const -> const discovered_bundle *;
+
+  /**
+   * @brief Looks up a bundle by RDX fingerprint and marks its body as recently used.
+   *
+   * @param rdx_fingerprint RDX fingerprint
+   * @return The bundle, or nullptr if unknown
+   */
+  auto use_by_rdx(const std::string &rdx_fingerprint) -> const discovered_bundle *;
+
+  /**
+   * @brief Returns every known bundle, in no particular order.
+   *
+   * @return Bundles, with evicted bodies left empty
+   */
+  [[nodiscard]] auto bundles() const -> const std::vector<discovered_bundle> & { return bundles_; }
+
+  /**
+   * @brief Returns the number of known bundles.
+   *
+   * @return Bundle count
+   */
+  [[nodiscard]] auto size() const -> std::size_t { return bundles_.size(); }
+
+  /**
+   * @brief Returns the total size of the bundle bodies held in memory.
+   *
+   * @return Bytes of base64 bundle data
+   */
+  [[nodiscard]] auto body_bytes() const -> std::size_t { return body_bytes_; }
+
+private:
+  auto touch_body(const std::string &nostr_pubkey) -> void;
+  auto drop_body(const std::string &nostr_pubkey) -> void;
+  auto evict_bodies() -> void;
+
+  std::size_t max_body_bytes_;
+  std::size_t body_bytes_{ 0 };
+  std::vector<discovered_bundle> bundles_;
+  std::unordered_map<std::string, std::size_t> pubkey_index_;
+  std::unordered_map<std::string, std::size_t> rdx_index_;
+  std::list<std::string> body_lru_;
+  std::unordered_map<std::string, std::list<std::string>::iterator> body_lru_position_;
+};
+
+}// namespace radix_relay::nostr
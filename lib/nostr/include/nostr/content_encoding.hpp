@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace radix_relay::nostr::protocol {
+
+/// Third element of the radix_version tag marking base64 encrypted message content
+inline constexpr auto base64_content_encoding = "base64";
+
+/// Tag listing the content encodings the sender of a hex encrypted message accepts
+inline constexpr auto content_encoding_tag = "radix_content_encoding";
+
+/// Tag listing the plaintext codecs the sender of an encrypted message accepts
+inline constexpr auto compression_tag = "radix_compression";
+
+/// Codec name in the radix_compression tag for zstd-compressed plaintext
+inline constexpr auto zstd_compression = "zstd";
+
+/// Tag carrying a group's sender key distribution ID on group messages
+inline constexpr auto group_tag = "g";
+
+/**
+ * @brief Encoding of the ciphertext carried in an encrypted message's content.
+ */
+enum class content_encoding : std::uint8_t {
+  hex,///< Lowercase hex, used by peers that predate the encoding marker
+  base64,///< Base64, declared as ["radix_version", <version>, "base64"]
+};
+
+/**
+ * @brief Determines the content encoding declared by an event's tags.
+ *
+ * @param tags Event tags array
+ * @return base64 if the radix_version tag carries the base64 marker, hex otherwise
+ */
+[[nodiscard]] auto content_encoding_from_tags(const std::vector<std::vector<std::string>> &tags) -> content_encoding;
+
+/**
+ * @brief Checks whether an event's sender accepts base64 message content.
+ *
+ * @param tags Event tags array
+ * @return true if the content is base64 or a radix_content_encoding tag lists base64
+ */
+[[nodiscard]] auto accepts_base64_content(const std::vector<std::vector<std::string>> &tags) -> bool;
+
+/**
+ * @brief Checks whether an event's sender accepts zstd-compressed plaintext.
+ *
+ * @param tags Event tags array
+ * @return true if a radix_compression tag lists zstd
+ */
+[[nodiscard]] auto accepts_zstd_compression(const std::vector<std::vector<std::string>> &tags) -> bool;
+
+/**
+ * @brief Extracts the group a group message was sent to.
+ *
+ * @param tags Event tags array
+ * @return Distribution ID from the first g tag, or std::nullopt if there is none
+ */
+[[nodiscard]] auto group_id_from_tags(const std::vector<std::vector<std::string>> &tags) -> std::optional<std::string>;
+
+/**
+ * @brief Decodes encrypted message content into ciphertext bytes.
+ *
+ * Base64 decoding accepts both the standard and URL-safe alphabets, with or without padding.
+ *
+ * @param content Event content
+ * @param encoding Encoding declared by the event
+ * @return Decoded bytes, or std::nullopt if the content is malformed
+ */
+[[nodiscard]] auto decode_content(std::string_view content, content_encoding encoding)
+  -> std::optional<std::vector<std::uint8_t>>;
+
+}// namespace radix_relay::nostr::protocol
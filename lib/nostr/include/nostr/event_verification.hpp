@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <unordered_map>
+
+namespace radix_relay::nostr {
+
+/**
+ * @brief Computes the NIP-01 ID of an event from its signed fields.
+ *
+ * @param event Event object with pubkey, created_at, kind, tags and content
+ * @return 64 lowercase hex characters
+ * @throws nlohmann::json::exception if a field is missing or has the wrong type
+ */
+[[nodiscard]] auto compute_event_id(const nlohmann::json &event) -> std::string;
+
+/**
+ * @brief Bounded memory of events whose ID and signature already passed verification.
+ *
+ * Relays deliver the same event again across subscriptions and reconnects. An event whose ID and
+ * signature match a remembered pair, and whose fields still hash to that ID, needs no second
+ * Schnorr verification. Once full, the oldest entries are forgotten first.
+ */
+class verified_event_cache
+{
+public:
+  /// Entries kept when no capacity is given
+  static constexpr std::size_t default_capacity = 4096;
+
+  /**
+   * @brief Constructs an empty cache.
+   *
+   * @param capacity Maximum number of remembered events; 0 remembers nothing
+   */
+  explicit verified_event_cache(std::size_t capacity = default_capacity) : capacity_(capacity) {}
+
+  /**
+   * @brief Checks whether an event is known to be authentic.
+   *
+   * @param event Event object as delivered by a relay
+   * @return true if the ID and signature were verified before and the fields hash to the ID
+   */
+  [[nodiscard]] auto contains(const nlohmann::json &event) const -> bool;
+
+  /**
+   * @brief Remembers an event whose ID and signature were just verified.
+   *
+   * @param event Verified event object
+   */
+  auto insert(const nlohmann::json &event) -> void;
+
+  /**
+   * @brief Returns the number of remembered events.
+   *
+   * @return Entry count, at most the capacity
+   */
+  [[nodiscard]] auto size() const -> std::size_t { return signatures_.size(); }
+
+private:
+  std::size_t capacity_;
+  std::unordered_map<std::string, std::string> signatures_;
+  std::deque<std::string> insertion_order_;
+};
+
+}// namespace radix_relay::nostr
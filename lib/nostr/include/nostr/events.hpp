@@ -25,6 +25,24 @@ namespace incoming {
     explicit encrypted_message(const protocol::event_data &event) : protocol::event_data(event) {}
   };
 
+  /// Received sender key group message (kind 40005)
+  struct group_message : protocol::event_data
+  {
+    explicit group_message(const protocol::event_data &event) : protocol::event_data(event) {}
+  };
+
+  /// Received pairwise-encrypted sender key for a group (kind 40006)
+  struct sender_key_distribution : protocol::event_data
+  {
+    explicit sender_key_distribution(const protocol::event_data &event) : protocol::event_data(event) {}
+  };
+
+  /// Received pairwise-encrypted chunk of a file transfer (kind 40007)
+  struct file_chunk : protocol::event_data
+  {
+    explicit file_chunk(const protocol::event_data &event) : protocol::event_data(event) {}
+  };
+
   /// Received session establishment request
   struct session_request : protocol::event_data
   {
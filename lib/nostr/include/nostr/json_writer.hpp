@@ -0,0 +1,185 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <nostr/protocol.hpp>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace radix_relay::nostr::protocol {
+
+/**
+ * @brief Streaming JSON writer for NIP-01 messages.
+ *
+ * Appends compact JSON directly to a caller-owned byte buffer without building an intermediate
+ * document. Separators between array elements and object members are inserted automatically.
+ * Strings are scanned eight bytes at a time, and runs that need no escaping are copied as a block.
+ */
+class json_writer
+{
+public:
+  /// Maximum nesting depth of arrays and objects
+  static constexpr std::size_t max_depth = 8;
+
+  /**
+   * @brief Constructs a writer that appends to a buffer.
+   *
+   * @param out Buffer to append to; existing contents are kept
+   */
+  explicit json_writer(std::vector<std::byte> &out) : out_(&out) {}
+
+  /**
+   * @brief Opens an array.
+   *
+   * @return This writer
+   * @throws std::length_error if nesting exceeds max_depth
+   */
+  auto begin_array() -> json_writer &;
+
+  /**
+   * @brief Closes the innermost array.
+   *
+   * @return This writer
+   */
+  auto end_array() -> json_writer &;
+
+  /**
+   * @brief Opens an object.
+   *
+   * @return This writer
+   * @throws std::length_error if nesting exceeds max_depth
+   */
+  auto begin_object() -> json_writer &;
+
+  /**
+   * @brief Closes the innermost object.
+   *
+   * @return This writer
+   */
+  auto end_object() -> json_writer &;
+
+  /**
+   * @brief Writes an object member name; the next value written belongs to it.
+   *
+   * @param name Member name
+   * @return This writer
+   */
+  auto key(std::string_view name) -> json_writer &;
+
+  /**
+   * @brief Writes an escaped string value.
+   *
+   * @param text String contents
+   * @return This writer
+   */
+  auto value(std::string_view text) -> json_writer &;
+
+  /**
+   * @brief Writes an unsigned integer value.
+   *
+   * @param number Value to write
+   * @return This writer
+   */
+  auto value(std::uint64_t number) -> json_writer &;
+
+  /**
+   * @brief Writes an already-serialized JSON value verbatim.
+   *
+   * @param json Valid JSON text
+   * @return This writer
+   */
+  auto raw(std::string_view json) -> json_writer &;
+
+  /**
+   * @brief Returns the length of the leading run of a string that needs no escaping.
+   *
+   * @param text String to scan
+   * @return Number of leading bytes that can be copied as-is
+   */
+  [[nodiscard]] static auto unescaped_prefix_length(std::string_view text) -> std::size_t;
+
+private:
+  auto begin_value() -> void;
+  auto open(char bracket) -> void;
+  auto close(char bracket) -> void;
+  auto put(char character) -> void;
+  auto put(std::string_view text) -> void;
+  auto put_string(std::string_view text) -> void;
+
+  std::vector<std::byte> *out_;
+  std::array<bool, max_depth> has_members_{};
+  std::size_t depth_{ 0 };
+  bool after_key_{ false };
+};
+
+/// Capacity above which the scratch buffer is released instead of kept for the next frame
+constexpr std::size_t max_retained_scratch_capacity = 1024 * 1024;
+
+/**
+ * @brief Returns the calling thread's frame buffer, emptied.
+ *
+ * The buffer keeps its capacity from frame to frame, so building a frame in it and copying
+ * the result out costs one exact-size allocation instead of growing a fresh vector. It must
+ * not be held across a call that may build another frame on the same thread.
+ *
+ * @return Empty buffer owned by the calling thread
+ */
+[[nodiscard]] auto scratch_buffer() -> std::vector<std::byte> &;
+
+/**
+ * @brief Writes an event as a JSON object.
+ *
+ * @param writer Writer to append to
+ * @param evt Event to write
+ */
+auto write_event_object(json_writer &writer, const event_data &evt) -> void;
+
+/**
+ * @brief Writes a client ["EVENT", {...}] frame.
+ *
+ * @param out Buffer to append to
+ * @param evt Event to publish
+ */
+auto write_event_frame(std::vector<std::byte> &out, const event_data &evt) -> void;
+
+/**
+ * @brief Writes a ["REQ", subscription_id, filters...] frame.
+ *
+ * @param out Buffer to append to
+ * @param subscription_id Subscription identifier
+ * @param filters Filters to include, in order
+ */
+auto write_req_frame(std::vector<std::byte> &out, std::string_view subscription_id, std::span<const filter> filters)
+  -> void;
+
+/**
+ * @brief Writes a ["REQ", subscription_id, filter] frame with a single filter.
+ *
+ * @param out Buffer to append to
+ * @param subscription_id Subscription identifier
+ * @param req_filter Filter to include
+ */
+auto write_req_frame(std::vector<std::byte> &out, std::string_view subscription_id, const filter &req_filter)
+  -> void;
+
+/**
+ * @brief Writes a ["CLOSE", subscription_id] frame.
+ *
+ * @param out Buffer to append to
+ * @param subscription_id Subscription to close
+ */
+auto write_close_frame(std::vector<std::byte> &out, std::string_view subscription_id) -> void;
+
+/**
+ * @brief Writes the NIP-01 canonical serialization hashed to form an event ID.
+ *
+ * Produces [0,pubkey,created_at,kind,tags,content] with no whitespace.
+ *
+ * @param out Buffer to append to
+ * @param evt Event whose ID preimage to write
+ */
+auto write_event_id_preimage(std::vector<std::byte> &out, const event_data &evt) -> void;
+
+}// namespace radix_relay::nostr::protocol
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <nostr/protocol.hpp>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace radix_relay::nostr {
+
+/**
+ * @brief Walks stored messages backwards in pages bounded by `until` and `limit`.
+ *
+ * Each filter is paged on its own, newest page first: a page asks for at most `page_size`
+ * events up to the cursor, and the next page moves the cursor to the oldest timestamp seen.
+ * The cursor timestamp is inclusive, so events sitting exactly on it are delivered again by the
+ * next page and are recognised as duplicates. A filter is exhausted once a page comes back short
+ * or the cursor passes the filter's `since`.
+ *
+ * The backfill only decides what to request next; the caller sends the REQ and feeds the page's
+ * events back in.
+ */
+class message_backfill
+{
+public:
+  /**
+   * @brief Starts a backfill over the given filters.
+   *
+   * @param filters Message filters; their `since` bounds how far back the walk goes
+   * @param until Newest timestamp to fetch, usually the `since` of the live subscription
+   * @param page_size Events requested per page (at least 1)
+   */
+  message_backfill(std::vector<protocol::filter> filters, std::uint64_t until, std::uint32_t page_size);
+
+  /**
+   * @brief Returns the filter for the page to request next.
+   *
+   * @return Current filter with the page's `until` and `limit` applied
+   */
+  [[nodiscard]] auto page_filter() const -> protocol::filter;
+
+  /**
+   * @brief Records an event delivered on the current page.
+   *
+   * @param event_id Nostr event ID
+   * @param created_at Event timestamp
+   * @return false if the previous page, or an unfinished attempt at this one, already delivered the event
+   */
+  auto record_event(const std::string &event_id, std::uint64_t created_at) -> bool;
+
+  /**
+   * @brief Ends the current page and moves the cursor.
+   *
+   * @return true if another page has to be requested, false once every filter is exhausted
+   */
+  auto finish_page() -> bool;
+
+  /**
+   * @brief Starts the current page over, as when the relay did not finish sending it.
+   *
+   * The cursor stays where it is. Events the unfinished attempt delivered count as duplicates
+   * when the retry delivers them again.
+   */
+  auto retry_page() -> void;
+
+  /**
+   * @brief Adds filters to walk, as when the message subscription changes during a backfill.
+   *
+   * Filters already in the backfill are ignored; the page in flight is not affected.
+   *
+   * @param filters Message filters of the new subscription
+   */
+  auto add_filters(const std::vector<protocol::filter> &filters) -> void;
+
+  /**
+   * @brief Returns the oldest timestamp the backfill reaches.
+   *
+   * @return Smallest `since` of the filters, 0 if any filter is unbounded
+   */
+  [[nodiscard]] auto since() const -> std::uint64_t;
+
+  /**
+   * @brief Returns the number of pages finished so far.
+   *
+   * @return Page count
+   */
+  [[nodiscard]] auto pages() const -> std::uint32_t { return pages_; }
+
+  /**
+   * @brief Returns the number of distinct events received so far.
+   *
+   * @return Message count
+   */
+  [[nodiscard]] auto messages() const -> std::uint64_t { return messages_; }
+
+  /**
+   * @brief Checks whether every filter has been exhausted.
+   *
+   * @return true when no page is left to request
+   */
+  [[nodiscard]] auto complete() const -> bool { return current_ >= filters_.size(); }
+
+private:
+  auto next_filter() -> void;
+
+  std::vector<protocol::filter> filters_;
+  std::size_t current_{ 0 };
+  std::uint64_t start_;
+  std::uint64_t until_;
+  std::uint32_t page_size_;
+  std::size_t page_events_{ 0 };
+  std::uint64_t page_oldest_{ 0 };
+  std::set<std::string> page_oldest_ids_;
+  std::set<std::string> page_ids_;
+  std::set<std::string> boundary_ids_;
+  std::uint32_t pages_{ 0 };
+  std::uint64_t messages_{ 0 };
+};
+
+}// namespace radix_relay::nostr
@@ -11,12 +11,17 @@
 #include <iterator>
 #include <memory>
 #include <nlohmann/json.hpp>
+#include <nostr/content_encoding.hpp>
 #include <nostr/events.hpp>
+#include <nostr/pow.hpp>
 #include <nostr/protocol.hpp>
 #include <nostr/semver_utils.hpp>
 #include <optional>
 #include <spdlog/spdlog.h>
+#include <stdexcept>
+#include <stop_token>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace radix_relay::nostr {
@@ -33,6 +38,16 @@ struct publish_bundle_result
   std::uint32_t kyber_pre_key_id;///< Kyber prekey ID used
 };
 
+/**
+ * @brief Frames produced for a group broadcast.
+ */
+struct group_broadcast_result
+{
+  std::vector<signal::fan_out_frame> distribution_frames;///< Sender key distributions for members still missing it
+  std::string event_id;///< Nostr event ID of the group message
+  std::vector<std::byte> bytes;///< Serialized group message event
+};
+
 /**
  * @brief Handles processing of incoming and outgoing Nostr messages.
  *
@@ -54,31 +69,36 @@ public:
   /**
    * @brief Handles an incoming encrypted message event.
    *
+   * The content is base64 when the radix_version tag carries the base64 marker and hex otherwise, so
+   * messages from peers that predate the marker still decode. Whether the sender advertised zstd support
+   * is passed on to the bridge, which only compresses payloads for peers that did, and so is whether it
+   * showed it accepts base64 content, which the bridge only sends to such peers. Both are only taken from
+   * the newest message seen from the sender, and only passed on when they change.
+   *
    * @param event Encrypted message from Nostr relay
-   * @return message_received event if decryption successful, std::nullopt on failure
+   * @return message_received event if decryption successful, std::nullopt on malformed content
    */
   [[nodiscard]] auto handle(const nostr::events::incoming::encrypted_message &event)
     -> std::optional<core::events::message_received>
   {
-    std::vector<uint8_t> encrypted_bytes;
-    constexpr int hex_base = 16;
-    for (size_t i = 0; i < event.content.length(); i += 2) {
-      auto byte_string = event.content.substr(i, 2);
-      auto byte_value = static_cast<uint8_t>(std::stoul(byte_string, nullptr, hex_base));
-      encrypted_bytes.push_back(byte_value);
+    auto encrypted_bytes = protocol::decode_content(event.content, protocol::content_encoding_from_tags(event.tags));
+    if (not encrypted_bytes.has_value()) {
+      spdlog::warn("[nostr_handler] Malformed encrypted message content: event_id={}", event.id);
+      return std::nullopt;
     }
 
     // Pass Nostr pubkey as peer_hint - decrypt_message will:
     // - For PreKeySignalMessage: extract identity key and create contact automatically
     // - For SignalMessage: look up existing contact by this pubkey
-    auto result = bridge_->decrypt_message(event.pubkey, encrypted_bytes);
+    auto result = bridge_->decrypt_message(event.pubkey, *encrypted_bytes);
 
     const std::string decrypted_content(result.plaintext.begin(), result.plaintext.end());
 
-    bridge_->update_last_message_timestamp(event.created_at);
+    latest_message_timestamp_ = std::max(latest_message_timestamp_, event.created_at);
 
     // After successful decryption, get the sender's contact info (now guaranteed to exist)
     auto sender_contact = bridge_->lookup_contact(event.pubkey);
+    record_peer_capabilities(sender_contact.rdx_fingerprint, event);
 
     return core::events::message_received{ .sender_rdx = sender_contact.rdx_fingerprint,
       .sender_alias = sender_contact.user_alias,
@@ -87,6 +107,134 @@ public:
       .should_republish_bundle = result.should_republish_bundle };
   }
 
+  /**
+   * @brief Handles an incoming sender key distribution from a group member.
+   *
+   * @param event Pairwise-encrypted distribution from Nostr relay
+   * @return group_joined event if processing successful, std::nullopt on malformed content
+   */
+  [[nodiscard]] auto handle(const nostr::events::incoming::sender_key_distribution &event)
+    -> std::optional<core::events::group_joined>
+  {
+    auto encrypted_bytes = protocol::decode_content(event.content, protocol::content_encoding_from_tags(event.tags));
+    if (not encrypted_bytes.has_value()) {
+      spdlog::warn("[nostr_handler] Malformed sender key distribution content: event_id={}", event.id);
+      return std::nullopt;
+    }
+
+    auto membership = bridge_->process_sender_key_distribution(event.pubkey, *encrypted_bytes);
+
+    latest_message_timestamp_ = std::max(latest_message_timestamp_, event.created_at);
+
+    return core::events::group_joined{ .group_id = std::move(membership.group_id),
+      .name = std::move(membership.name),
+      .sender_rdx = std::move(membership.sender_rdx),
+      .should_republish_bundle = membership.should_republish_bundle };
+  }
+
+  /**
+   * @brief Handles an incoming group message.
+   *
+   * @param event Sender key encrypted message from Nostr relay
+   * @return group_message_received event if decryption successful, std::nullopt on malformed content
+   */
+  [[nodiscard]] auto handle(const nostr::events::incoming::group_message &event)
+    -> std::optional<core::events::group_message_received>
+  {
+    auto group_id = protocol::group_id_from_tags(event.tags);
+    auto encrypted_bytes = protocol::decode_content(event.content, protocol::content_encoding_from_tags(event.tags));
+    if (not group_id.has_value() or not encrypted_bytes.has_value()) {
+      spdlog::warn("[nostr_handler] Malformed group message: event_id={}", event.id);
+      return std::nullopt;
+    }
+
+    auto result = bridge_->decrypt_group_message(event.pubkey, *group_id, *encrypted_bytes);
+
+    latest_message_timestamp_ = std::max(latest_message_timestamp_, event.created_at);
+
+    auto sender_contact = bridge_->lookup_contact(result.sender_rdx);
+
+    return core::events::group_message_received{ .group_id = std::move(result.group_id),
+      .group_name = std::move(result.name),
+      .sender_rdx = sender_contact.rdx_fingerprint,
+      .sender_alias = sender_contact.user_alias,
+      .content = std::string(result.plaintext.begin(), result.plaintext.end()),
+      .timestamp = event.created_at };
+  }
+
+  /**
+   * @brief Handles an incoming chunk of a file transfer.
+   *
+   * The bridge writes the chunk straight into the transfer's partial file, so memory use does not
+   * grow with the file size. Repeated chunks are ignored by the bridge.
+   *
+   * @param event Pairwise-encrypted chunk from Nostr relay
+   * @return file_transfer_progress event if the chunk was stored, std::nullopt on malformed content
+   */
+  [[nodiscard]] auto handle(const nostr::events::incoming::file_chunk &event)
+    -> std::optional<core::events::file_transfer_progress>
+  {
+    auto encrypted_bytes = protocol::decode_content(event.content, protocol::content_encoding_from_tags(event.tags));
+    if (not encrypted_bytes.has_value()) {
+      spdlog::warn("[nostr_handler] Malformed file chunk content: event_id={}", event.id);
+      return std::nullopt;
+    }
+
+    auto progress = bridge_->process_transfer_chunk(event.pubkey, *encrypted_bytes);
+
+    latest_message_timestamp_ = std::max(latest_message_timestamp_, event.created_at);
+
+    return core::events::file_transfer_progress{ .transfer_id = std::move(progress.transfer_id),
+      .peer = std::move(progress.sender_rdx),
+      .name = std::move(progress.name),
+      .chunks_done = progress.received_chunks,
+      .chunk_count = progress.chunk_count,
+      .outgoing = false,
+      .complete = progress.complete,
+      .path = std::move(progress.path),
+      .error = "" };
+  }
+
+  /**
+   * @brief Checks whether a newer message timestamp is waiting to be persisted.
+   *
+   * @return true if the in-memory maximum is ahead of the last persisted value
+   */
+  [[nodiscard]] auto has_pending_message_timestamp() const -> bool
+  {
+    return persistable_message_timestamp() > persisted_message_timestamp_;
+  }
+
+  /**
+   * @brief Caps the message timestamp that may be persisted.
+   *
+   * While older messages are still being fetched, persisting a newer timestamp would make the
+   * next start skip the ones not fetched yet.
+   *
+   * @param ceiling Highest timestamp to persist, std::nullopt to lift the cap
+   */
+  auto set_message_timestamp_ceiling(std::optional<std::uint64_t> ceiling) -> void
+  {
+    message_timestamp_ceiling_ = ceiling;
+  }
+
+  /**
+   * @brief Persists the newest observed message timestamp through the bridge.
+   *
+   * Incoming messages only advance an in-memory maximum; this is the single point where
+   * it is written to storage, so a backlog of N messages costs one write instead of N.
+   *
+   * @return true if the bridge was updated, false if nothing was pending
+   */
+  auto flush_last_message_timestamp() -> bool
+  {
+    if (not has_pending_message_timestamp()) { return false; }
+    const auto timestamp = persistable_message_timestamp();
+    bridge_->update_last_message_timestamp(timestamp);
+    persisted_message_timestamp_ = timestamp;
+    return true;
+  }
+
   /**
    * @brief Handles an incoming bundle announcement event.
    *
@@ -109,7 +257,7 @@ public:
     }
 
     return core::events::bundle_announcement_received{
-      .pubkey = event.pubkey, .bundle_content = event.content, .event_id = event.id
+      .pubkey = event.pubkey, .bundle_content = event.content, .event_id = event.id, .created_at = event.created_at
     };
   }
 
@@ -124,43 +272,148 @@ public:
     std::vector<uint8_t> plaintext_bytes(cmd.message.begin(), cmd.message.end());
     auto encrypted_bytes = bridge_->encrypt_message(cmd.peer, plaintext_bytes);
 
-    std::string hex_content;
-    for (const auto &byte : encrypted_bytes) { hex_content += fmt::format("{:02x}", byte); }
+    auto frame = bridge_->create_encrypted_message_frame(cmd.peer,
+      encrypted_bytes,
+      static_cast<std::uint64_t>(std::time(nullptr)),
+      std::string{ cmake::project_version });
 
-    auto signed_event_json = bridge_->create_and_sign_encrypted_message(
-      cmd.peer, hex_content, static_cast<std::uint32_t>(std::time(nullptr)), std::string{ cmake::project_version });
+    return { std::move(frame.event_id), std::move(frame.bytes) };
+  }
+
+  /**
+   * @brief Handles a send_many command by encrypting one message for every recipient in a single bridge call.
+   *
+   * @param cmd Send many command containing recipients and message
+   * @return One frame or skip reason per recipient, in order
+   */
+  [[nodiscard]] auto handle(const core::events::send_many &cmd) -> std::vector<signal::fan_out_frame>
+  {
+    std::vector<uint8_t> plaintext_bytes(cmd.message.begin(), cmd.message.end());
+    return bridge_->create_encrypted_message_frames(cmd.peers,
+      plaintext_bytes,
+      static_cast<std::uint64_t>(std::time(nullptr)),
+      std::string{ cmake::project_version });
+  }
 
-    auto event_json = nlohmann::json::parse(signed_event_json);
-    const std::string event_id = event_json["id"].template get<std::string>();
+  /**
+   * @brief Handles a send_file command by registering the file for a chunked transfer.
+   *
+   * @param cmd Send file command containing peer and path
+   * @return The new transfer with every chunk pending
+   */
+  [[nodiscard]] auto handle(const core::events::send_file &cmd) -> signal::outgoing_transfer
+  {
+    return bridge_->start_file_transfer(cmd.peer, cmd.path);
+  }
 
-    nostr::protocol::event_data event_data;
-    event_data.id = event_id;
-    event_data.pubkey = event_json["pubkey"].template get<std::string>();
-    event_data.created_at = event_json["created_at"].template get<std::uint64_t>();
-    event_data.kind = event_json["kind"].template get<nostr::protocol::kind>();
-    event_data.content = event_json["content"].template get<std::string>();
-    event_data.sig = event_json["sig"].template get<std::string>();
+  /**
+   * @brief Reads, encrypts, and serializes one chunk of an outgoing transfer.
+   *
+   * @param transfer_id Outgoing transfer
+   * @param chunk_index Chunk to send
+   * @return Pair of event ID and serialized event bytes
+   */
+  [[nodiscard]] auto create_transfer_chunk(const std::string &transfer_id, std::uint32_t chunk_index)
+    -> std::pair<std::string, std::vector<std::byte>>
+  {
+    auto frame = bridge_->create_transfer_chunk_frame(transfer_id,
+      chunk_index,
+      static_cast<std::uint64_t>(std::time(nullptr)),
+      std::string{ cmake::project_version });
+    return { std::move(frame.event_id), std::move(frame.bytes) };
+  }
 
-    for (const auto &tag : event_json["tags"]) {
-      std::vector<std::string> tag_vec;
-      std::ranges::transform(
-        tag, std::back_inserter(tag_vec), [](const auto &item) { return item.template get<std::string>(); });
-      event_data.tags.push_back(tag_vec);
+  /**
+   * @brief Re-signs an outgoing event with a NIP-13 nonce tag that meets a difficulty target.
+   *
+   * The event's pubkey, timestamp, kind, tags and content are kept; only the nonce tag is added.
+   * Mining blocks the calling thread, so callers run this off the event loop.
+   *
+   * @param frame Event ID and serialized ["EVENT", {...}] frame from the bridge
+   * @param difficulty Required leading zero bits of the event ID
+   * @param options Mining threads, attempt limit, and SHA-256 implementation
+   * @param stop Abandons mining
+   * @return The re-signed frame, or the original frame if no nonce was found
+   * @throws std::runtime_error If the bridge signed an event whose ID is not the mined one
+   */
+  [[nodiscard]] auto add_proof_of_work(std::pair<std::string, std::vector<std::byte>> frame,
+    std::uint32_t difficulty,
+    const pow::mining_options &options,
+    std::stop_token stop) const -> std::pair<std::string, std::vector<std::byte>>
+  {
+    std::string json_str;
+    json_str.resize(frame.second.size());
+    std::ranges::transform(frame.second, json_str.begin(), [](std::byte byte) { return std::bit_cast<char>(byte); });
+    const auto event = nlohmann::json::parse(json_str).at(1);
+
+    const auto created_at = event.at("created_at").get<std::uint64_t>();
+    const auto kind = event.at("kind").get<std::uint32_t>();
+    auto tags = event.at("tags").get<std::vector<std::vector<std::string>>>();
+    const auto content = event.at("content").get<std::string>();
+
+    auto mined = pow::mine(pow::make_event_template(event.at("pubkey").get<std::string>(),
+                             created_at,
+                             kind,
+                             tags,
+                             content,
+                             difficulty),
+      difficulty,
+      options,
+      std::move(stop));
+    if (not mined) { return frame; }
+
+    tags.push_back({ pow::nonce_tag, mined->nonce, std::to_string(difficulty) });
+    auto signed_frame = bridge_->sign_event_frame(kind, tags, content, created_at);
+    if (signed_frame.event_id != mined->event_id) {
+      throw std::runtime_error(
+        fmt::format("signed event ID {} differs from mined ID {}", signed_frame.event_id, mined->event_id));
     }
+    spdlog::debug(
+      "[nostr_handler] Mined difficulty {} for kind {} in {} hashes", mined->difficulty, kind, mined->hashes);
+    return { std::move(signed_frame.event_id), std::move(signed_frame.bytes) };
+  }
 
-    auto protocol_event = nostr::protocol::event::from_event_data(event_data);
-    auto json_str = protocol_event.serialize();
+  /**
+   * @brief Handles a broadcast command by encrypting a message once for a whole group.
+   *
+   * Members whose sender key distribution no relay has accepted yet get a pairwise-encrypted
+   * distribution first; once every member holds it, a broadcast is a single event regardless of group size.
+   *
+   * @param cmd Broadcast command containing group and message
+   * @return Distribution frames to send first, then the group message event
+   */
+  [[nodiscard]] auto handle(const core::events::broadcast &cmd) -> group_broadcast_result
+  {
+    const auto timestamp = static_cast<std::uint64_t>(std::time(nullptr));
+    const std::string version_str{ cmake::project_version };
 
-    std::vector<std::byte> bytes;
-    bytes.resize(json_str.size());
-    std::ranges::transform(json_str, bytes.begin(), [](char character) { return std::bit_cast<std::byte>(character); });
+    group_broadcast_result result;
+    result.distribution_frames = bridge_->create_sender_key_distribution_frames(cmd.group, timestamp, version_str);
 
-    return { event_id, bytes };
+    std::vector<uint8_t> plaintext_bytes(cmd.message.begin(), cmd.message.end());
+    auto frame = bridge_->create_group_message_frame(cmd.group, plaintext_bytes, timestamp, version_str);
+    result.event_id = std::move(frame.event_id);
+    result.bytes = std::move(frame.bytes);
+    return result;
+  }
+
+  /**
+   * @brief Handles a create group command.
+   *
+   * @param cmd Create group command with name and members
+   * @return group_created event with the new group's distribution ID
+   */
+  [[nodiscard]] auto handle(const core::events::create_group &cmd) -> core::events::group_created
+  {
+    return core::events::group_created{ .group_id = bridge_->create_group(cmd.name, cmd.members), .name = cmd.name };
   }
 
   /**
    * @brief Handles a publish identity command by generating and serializing a bundle.
    *
+   * The bridge signs and frames the announcement, returning the same cached frame until its key material
+   * changes, so the bytes go to the transport as-is.
+   *
    * @param command Publish identity command
    * @return Result containing event ID, bytes, and prekey IDs
    */
@@ -168,34 +421,9 @@ public:
   {
     const std::string version_str{ radix_relay::cmake::project_version };
     auto bundle_info = bridge_->generate_prekey_bundle_announcement(version_str);
-    auto event_json = nlohmann::json::parse(bundle_info.announcement_json);
-
-    const std::string event_id = event_json["id"].template get<std::string>();
-
-    nostr::protocol::event_data event_data;
-    event_data.id = event_id;
-    event_data.pubkey = event_json["pubkey"].template get<std::string>();
-    event_data.created_at = event_json["created_at"].template get<std::uint64_t>();
-    event_data.kind = event_json["kind"].template get<nostr::protocol::kind>();
-    event_data.content = event_json["content"].template get<std::string>();
-    event_data.sig = event_json["sig"].template get<std::string>();
-
-    for (const auto &tag : event_json["tags"]) {
-      std::vector<std::string> tag_vec;
-      std::ranges::transform(
-        tag, std::back_inserter(tag_vec), [](const auto &item) { return item.template get<std::string>(); });
-      event_data.tags.push_back(tag_vec);
-    }
-
-    auto protocol_event = nostr::protocol::event::from_event_data(event_data);
-    auto json_str = protocol_event.serialize();
-
-    std::vector<std::byte> bytes;
-    bytes.resize(json_str.size());
-    std::ranges::transform(json_str, bytes.begin(), [](char character) { return std::bit_cast<std::byte>(character); });
 
-    return publish_bundle_result{ .event_id = event_id,
-      .bytes = std::move(bytes),
+    return publish_bundle_result{ .event_id = std::move(bundle_info.event_id),
+      .bytes = std::move(bundle_info.frame),
       .pre_key_id = bundle_info.pre_key_id,
       .signed_pre_key_id = bundle_info.signed_pre_key_id,
       .kyber_pre_key_id = bundle_info.kyber_pre_key_id };
@@ -211,34 +439,8 @@ public:
     -> std::pair<std::string, std::vector<std::byte>>
   {
     const std::string version_str{ radix_relay::cmake::project_version };
-    auto bundle_json = bridge_->generate_empty_bundle_announcement(version_str);
-    auto event_json = nlohmann::json::parse(bundle_json);
-
-    const std::string event_id = event_json["id"].template get<std::string>();
-
-    nostr::protocol::event_data event_data;
-    event_data.id = event_id;
-    event_data.pubkey = event_json["pubkey"].template get<std::string>();
-    event_data.created_at = event_json["created_at"].template get<std::uint64_t>();
-    event_data.kind = event_json["kind"].template get<nostr::protocol::kind>();
-    event_data.content = event_json["content"].template get<std::string>();
-    event_data.sig = event_json["sig"].template get<std::string>();
-
-    for (const auto &tag : event_json["tags"]) {
-      std::vector<std::string> tag_vec;
-      std::ranges::transform(
-        tag, std::back_inserter(tag_vec), [](const auto &item) { return item.template get<std::string>(); });
-      event_data.tags.push_back(tag_vec);
-    }
-
-    auto protocol_event = nostr::protocol::event::from_event_data(event_data);
-    auto json_str = protocol_event.serialize();
-
-    std::vector<std::byte> bytes;
-    bytes.resize(json_str.size());
-    std::ranges::transform(json_str, bytes.begin(), [](char character) { return std::bit_cast<std::byte>(character); });
-
-    return { event_id, bytes };
+    auto frame = bridge_->generate_empty_bundle_frame(version_str);
+    return { std::move(frame.event_id), std::move(frame.bytes) };
   }
 
   /**
@@ -345,7 +547,51 @@ public:
   static auto handle(const nostr::events::incoming::node_status & /*event*/) -> void {}
 
 private:
+  /// Capabilities shown by the newest message seen from a contact
+  struct peer_capabilities
+  {
+    std::uint64_t created_at{ 0 };
+    bool accepts_zstd{ false };
+    bool accepts_base64{ false };
+  };
+
+  /**
+   * @brief Passes the capabilities a message shows on to the bridge, if it is the sender's newest.
+   *
+   * The backfill and relay replays deliver older messages after newer ones, and those would reset the
+   * flags to what the peer supported back then. Unchanged flags are not passed on again.
+   *
+   * @param rdx RDX fingerprint of the sender
+   * @param event Decrypted message
+   */
+  auto record_peer_capabilities(const std::string &rdx, const protocol::event_data &event) -> void
+  {
+    const peer_capabilities shown{ .created_at = event.created_at,
+      .accepts_zstd = protocol::accepts_zstd_compression(event.tags),
+      .accepts_base64 = protocol::accepts_base64_content(event.tags) };
+
+    auto [known, first] = peer_capabilities_.try_emplace(rdx, shown);
+    if (not first and shown.created_at < known->second.created_at) { return; }
+    if (first or shown.accepts_zstd != known->second.accepts_zstd) {
+      bridge_->record_peer_compression(rdx, shown.accepts_zstd);
+    }
+    if (first or shown.accepts_base64 != known->second.accepts_base64) {
+      bridge_->record_peer_base64_content(rdx, shown.accepts_base64);
+    }
+    known->second = shown;
+  }
+
+  [[nodiscard]] auto persistable_message_timestamp() const -> std::uint64_t
+  {
+    return message_timestamp_ceiling_ ? std::min(latest_message_timestamp_, *message_timestamp_ceiling_)
+                                      : latest_message_timestamp_;
+  }
+
   std::shared_ptr<Bridge> bridge_;
+  std::uint64_t latest_message_timestamp_{ 0 };
+  std::uint64_t persisted_message_timestamp_{ 0 };
+  std::optional<std::uint64_t> message_timestamp_ceiling_;
+  std::unordered_map<std::string, peer_capabilities> peer_capabilities_;
 };
 
 }// namespace radix_relay::nostr
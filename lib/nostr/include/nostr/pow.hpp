@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <nostr/sha256.hpp>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+namespace radix_relay::nostr::pow {
+
+/// NIP-13 tag name: ["nonce", <nonce>, <target difficulty>]
+inline constexpr auto nonce_tag = "nonce";
+
+/// Highest difficulty a nonce tag can declare
+inline constexpr std::uint32_t max_difficulty = 255;
+
+/**
+ * @brief NIP-01 event serialization split around the nonce value.
+ *
+ * The nonce tag is appended after the event's own tags, so the serialization is
+ * prefix + nonce + suffix. The event ID is the SHA-256 of that string.
+ */
+struct event_template
+{
+  std::string prefix;///< [0,"<pubkey>",<created_at>,<kind>,[<tags>...,["nonce","
+  std::string suffix;///< ","<difficulty>"]],"<content>"]
+};
+
+/**
+ * @brief Options for a mining run.
+ */
+struct mining_options
+{
+  std::uint32_t threads{ 0 };///< Worker threads; 0 uses every hardware thread
+  std::uint64_t max_hashes_per_thread{ 0 };///< Give up after this many attempts per thread; 0 never gives up
+  sha256_backend backend{ detected_sha256_backend() };///< Compression implementation
+};
+
+/**
+ * @brief A nonce that meets the target difficulty.
+ */
+struct mining_result
+{
+  std::string nonce;///< Value for the nonce tag
+  std::string event_id;///< Hex ID of the event carrying the nonce
+  std::uint32_t difficulty;///< Leading zero bits of the ID, at least the target
+  std::uint64_t hashes;///< Attempts made across all threads
+};
+
+/**
+ * @brief Counts the leading zero bits of a digest, which NIP-13 calls its difficulty.
+ *
+ * @param digest Event ID bytes
+ * @return Number of leading zero bits, 0 to 256
+ */
+[[nodiscard]] auto leading_zero_bits(const sha256_digest &digest) -> std::uint32_t;
+
+/**
+ * @brief Builds the serialization template of an event that will carry a nonce tag.
+ *
+ * @param pubkey Author public key (hex)
+ * @param created_at Unix timestamp
+ * @param kind Event kind
+ * @param tags Event tags, without a nonce tag
+ * @param content Event content
+ * @param target Difficulty declared in the nonce tag
+ * @return Template to mine
+ * @throws std::invalid_argument if target is above max_difficulty
+ */
+[[nodiscard]] auto make_event_template(const std::string &pubkey,
+  std::uint64_t created_at,
+  std::uint32_t kind,
+  const std::vector<std::vector<std::string>> &tags,
+  const std::string &content,
+  std::uint32_t target) -> event_template;
+
+/**
+ * @brief Searches for a nonce whose event ID has at least target leading zero bits.
+ *
+ * Threads search disjoint nonce ranges. The part of the serialization before the nonce is
+ * hashed once, so each attempt only compresses the blocks from the nonce onwards. Blocks
+ * the calling thread until a nonce is found, every thread runs out of attempts, or stop is
+ * requested.
+ *
+ * @param event Template to mine
+ * @param target Required leading zero bits
+ * @param options Thread count, attempt limit, and SHA-256 implementation
+ * @param stop Cancels the search
+ * @return The first nonce found, or std::nullopt if the search ended without one
+ */
+[[nodiscard]] auto mine(const event_template &event,
+  std::uint32_t target,
+  const mining_options &options,
+  std::stop_token stop) -> std::optional<mining_result>;
+
+}// namespace radix_relay::nostr::pow
@@ -1,11 +1,13 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <nlohmann/json.hpp>
 #include <optional>
 #include <span>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace radix_relay::nostr::protocol {
@@ -33,6 +35,9 @@ enum class kind : std::uint16_t {
   identity_announcement = 40002,///< Radix: Node identity announcement
   session_request = 40003,///< Radix: Session establishment request
   node_status = 40004,///< Radix: Node status update
+  group_message = 40005,///< Radix: Sender key group message, one event per broadcast
+  sender_key_distribution = 40006,///< Radix: Pairwise-encrypted sender key for a group
+  file_chunk = 40007,///< Radix: Pairwise-encrypted chunk of a file transfer
 };
 
 /**
@@ -128,7 +133,7 @@ struct event_data
   /**
    * @brief Checks if event is a Radix-specific message type.
    *
-   * @return true if kind is 40001-40004, false otherwise
+   * @return true if kind is 40001-40007 or a bundle announcement, false otherwise
    */
   [[nodiscard]] auto is_radix_message() const -> bool;
 
@@ -178,6 +183,51 @@ struct eose
   static auto deserialize(const std::string &json) -> std::optional<eose>;
 };
 
+/**
+ * @brief Nostr CLOSED message (NIP-01).
+ *
+ * Sent by a relay when it ends or refuses a subscription.
+ */
+struct closed
+{
+  std::string subscription_id;///< Subscription the relay closed
+  std::string message;///< Reason, starting with a machine-readable prefix such as "rate-limited:"
+
+  /**
+   * @brief Deserializes CLOSED message from JSON.
+   *
+   * @param json JSON string in format ["CLOSED", subscription_id, message]
+   * @return Parsed closed or std::nullopt on failure
+   */
+  static auto deserialize(const std::string &json) -> std::optional<closed>;
+};
+
+/**
+ * @brief NIP-01 subscription filter.
+ *
+ * Empty lists and unset bounds are omitted when the filter is written.
+ */
+struct filter
+{
+  std::vector<std::string> ids{};///< Event IDs to match
+  std::vector<std::string> authors{};///< Author pubkeys to match
+  std::vector<enum kind> kinds{};///< Event kinds to match
+  std::vector<std::pair<char, std::vector<std::string>>> tags{};///< Single-letter tag filters, written as "#<letter>"
+  std::optional<std::uint64_t> since{};///< Lower bound on created_at
+  std::optional<std::uint64_t> until{};///< Upper bound on created_at
+  std::optional<std::uint32_t> limit{};///< Maximum number of stored events to return
+
+  /**
+   * @brief Reads a filter from its NIP-01 JSON object.
+   *
+   * @param json Filter object
+   * @return Parsed filter, or std::nullopt if the object is malformed or uses fields this type cannot hold
+   */
+  static auto from_json(const nlohmann::json &json) -> std::optional<filter>;
+
+  auto operator==(const filter &) const -> bool = default;
+};
+
 /**
  * @brief Nostr REQ subscription request.
  *
@@ -255,4 +305,20 @@ inline auto validate_subscription_id(const std::string &subscription_id) -> void
   }
 }
 
+/// Length of a hex-encoded Nostr public key
+constexpr std::size_t pubkey_hex_length = 64;
+
+/**
+ * @brief Checks whether a string is a hex-encoded Nostr public key.
+ *
+ * @param value String to check
+ * @return true if value is 64 lowercase hex characters
+ */
+inline auto is_pubkey_hex(const std::string &value) -> bool
+{
+  return value.length() == pubkey_hex_length and std::ranges::all_of(value, [](char character) {
+    return (character >= '0' and character <= '9') or (character >= 'a' and character <= 'f');
+  });
+}
+
 }// namespace radix_relay::nostr::protocol
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <core/events.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace radix_relay::nostr {
+
+/**
+ * @brief Latencies measured per relay.
+ */
+enum class relay_latency : std::uint8_t {
+  ok,///< From sending an EVENT to the relay's OK
+  eose,///< From sending a REQ to the relay's EOSE
+  ping,///< WebSocket ping round trip
+  connect,///< From starting to connect to the open WebSocket
+};
+
+/**
+ * @brief Tracks how fast and how reliably each relay answers.
+ *
+ * Keeps the most recent latencies per relay and kind, plus whether each OK or EOSE wait was
+ * answered. A wait that times out is recorded with the time it waited, so a relay that slows
+ * down pushes its own timeout up instead of timing out forever at a stale p99.
+ *
+ * The timeout for a relay is its p99 latency times a multiplier, clamped between a floor and
+ * the configured request timeout. Until enough samples exist the configured timeout applies.
+ *
+ * The score is the share of answered waits scaled down by the median OK latency:
+ * `100 * answered * 1s / (1s + p50)`. A relay answering everything within 100 ms scores about
+ * 90; one answering half its waits after a second scores 25.
+ */
+class relay_health
+{
+public:
+  static constexpr std::size_t default_window = 64;///< Samples kept per relay and latency kind
+  static constexpr std::size_t min_samples = 5;///< Samples needed before the timeout adapts
+  static constexpr std::uint32_t healthy_score = 50;///< Lowest score ranked ahead of unmeasured relays
+
+  /**
+   * @brief Constructs an empty health tracker.
+   *
+   * @param max_timeout Timeout used until a relay has enough samples, and the ceiling after
+   * @param min_timeout Floor of the adapted timeout
+   * @param timeout_multiplier Adapted timeout as a multiple of p99 latency (0: never adapt)
+   * @param window Samples kept per relay and latency kind
+   */
+  relay_health(std::chrono::milliseconds max_timeout,
+    std::chrono::milliseconds min_timeout,
+    std::uint32_t timeout_multiplier,
+    std::size_t window = default_window);
+
+  /**
+   * @brief Records a latency the relay answered within.
+   *
+   * Only OK and EOSE latencies count as answered waits for the score.
+   *
+   * @param url Relay URL
+   * @param kind What was measured
+   * @param elapsed Measured latency
+   */
+  auto record(const std::string &url, relay_latency kind, std::chrono::milliseconds elapsed) -> void;
+
+  /**
+   * @brief Records a wait the relay never answered.
+   *
+   * @param url Relay URL
+   * @param kind What was waited for
+   * @param elapsed How long the wait lasted
+   */
+  auto record_timeout(const std::string &url, relay_latency kind, std::chrono::milliseconds elapsed) -> void;
+
+  /**
+   * @brief Records a failed attempt to connect to the relay.
+   *
+   * @param url Relay URL
+   */
+  auto record_connect_failure(const std::string &url) -> void;
+
+  /**
+   * @brief Returns a latency percentile for the relay.
+   *
+   * @param url Relay URL
+   * @param kind Latency kind
+   * @param percent Percentile from 1 to 100 (nearest rank)
+   * @return Latency, or nullopt without samples
+   */
+  [[nodiscard]] auto percentile(const std::string &url, relay_latency kind, std::uint32_t percent) const
+    -> std::optional<std::chrono::milliseconds>;
+
+  /**
+   * @brief Returns how long to wait for the relay's answer.
+   *
+   * @param url Relay URL
+   * @param kind Answer waited for (OK or EOSE)
+   * @return Timeout adapted to the relay's p99 latency
+   */
+  [[nodiscard]] auto timeout(const std::string &url, relay_latency kind) const -> std::chrono::milliseconds;
+
+  /**
+   * @brief Returns the relay's health score.
+   *
+   * @param url Relay URL
+   * @return Score from 0 to 100, or nullopt if no wait on the relay has finished yet
+   */
+  [[nodiscard]] auto score(const std::string &url) const -> std::optional<std::uint32_t>;
+
+  /**
+   * @brief Orders relays by preference.
+   *
+   * Healthy relays come first, fastest median OK latency first; then relays without a score,
+   * in the given order; then unhealthy relays, best score first.
+   *
+   * @param urls Candidate relay URLs
+   * @return The same URLs, most preferred first
+   */
+  [[nodiscard]] auto rank(std::vector<std::string> urls) const -> std::vector<std::string>;
+
+  /**
+   * @brief Summarizes the relay for the connection monitor.
+   *
+   * @param url Relay URL
+   * @return Latency percentiles, score and current timeout of the relay
+   */
+  [[nodiscard]] auto stats(const std::string &url) const -> core::events::connection_monitor::relay_stats;
+
+private:
+  static constexpr std::size_t latency_kinds = 4;
+
+  struct relay_samples
+  {
+    std::array<std::deque<std::chrono::milliseconds>, latency_kinds> latencies;
+    std::deque<bool> answered;
+    std::uint64_t timeouts{ 0 };
+  };
+
+  auto push_latency(relay_samples &samples, relay_latency kind, std::chrono::milliseconds elapsed) const -> void;
+  auto push_outcome(relay_samples &samples, bool answered) const -> void;
+
+  std::chrono::milliseconds max_timeout_;
+  std::chrono::milliseconds min_timeout_;
+  std::uint32_t timeout_multiplier_;
+  std::size_t window_;
+  std::unordered_map<std::string, relay_samples> relays_;
+};
+
+}// namespace radix_relay::nostr
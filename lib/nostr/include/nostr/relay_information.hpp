@@ -0,0 +1,24 @@
+#pragma once
+
+#include <core/events.hpp>
+#include <optional>
+#include <string_view>
+
+namespace radix_relay::nostr {
+
+/// Media type relays answer NIP-11 requests with
+inline constexpr std::string_view relay_information_media_type = "application/nostr+json";
+
+/**
+ * @brief Reads the limits out of a NIP-11 relay information document.
+ *
+ * Only the `limitation` fields the node acts on are read. A field that is missing, not a
+ * number, or out of range is left unset rather than failing the whole document.
+ *
+ * @param document Body of the relay's information document
+ * @return Advertised limits, or std::nullopt if the body is not a JSON object
+ */
+[[nodiscard]] auto parse_relay_limits(std::string_view document)
+  -> std::optional<core::events::transport::relay_limits>;
+
+}// namespace radix_relay::nostr
@@ -1,40 +1,136 @@
 #pragma once
 
+#include <algorithm>
 #include <async/async_queue.hpp>
 #include <bit>
+#include <boost/asio/async_result.hpp>
 #include <boost/asio/bind_executor.hpp>
 #include <boost/asio/co_spawn.hpp>
 #include <boost/asio/detached.hpp>
 #include <boost/asio/experimental/channel_error.hpp>
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/asio/strand.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/use_awaitable.hpp>
 #include <chrono>
 #include <concepts/request_tracker.hpp>
 #include <concepts/signal_bridge.hpp>
 #include <core/events.hpp>
 #include <core/uuid_generator.hpp>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fmt/format.h>
+#include <iterator>
+#include <map>
 #include <memory>
 #include <nlohmann/json.hpp>
+#include <nostr/bundle_registry.hpp>
+#include <nostr/event_verification.hpp>
 #include <nostr/events.hpp>
+#include <nostr/json_writer.hpp>
+#include <nostr/message_backfill.hpp>
 #include <nostr/message_handler.hpp>
+#include <nostr/pow.hpp>
 #include <nostr/protocol.hpp>
+#include <nostr/relay_health.hpp>
+#include <nostr/sha256.hpp>
+#include <nostr/subscription_manager.hpp>
+#include <optional>
+#include <random>
+#include <set>
+#include <signal_types/signal_types.hpp>
+#include <span>
 #include <spdlog/spdlog.h>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
 #include <variant>
 #include <vector>
 
 namespace radix_relay::nostr {
 
 /**
- * @brief Information about a discovered prekey bundle.
+ * @brief Settings of the session orchestrator.
+ *
+ * Covers relay request timing, background coalescing, file transfer pacing, proof of work,
+ * event verification, bundle discovery, and subscription and backfill limits.
+ */
+struct session_orchestrator_config
+{
+  std::chrono::milliseconds request_timeout{ std::chrono::seconds(15) };///< Timeout for relay OK/EOSE responses
+  std::chrono::milliseconds min_request_timeout{ std::chrono::seconds(1) };///< Floor of the adapted timeout
+  std::uint32_t request_timeout_multiplier{ 3 };///< Adapted timeout as a multiple of relay p99 latency (0: fixed)
+  std::chrono::milliseconds timestamp_flush_interval{ std::chrono::seconds(2) };///< Debounce for timestamp writes
+  std::chrono::milliseconds republish_window{ std::chrono::seconds(5) };///< Window for coalescing bundle republishes
+  std::chrono::milliseconds key_maintenance_period{ std::chrono::hours(1) };///< Maintenance interval (0: connect only)
+  std::chrono::milliseconds key_maintenance_jitter{ std::chrono::minutes(5) };///< Max random delay per periodic run
+  std::size_t file_transfer_window{ 8 };///< File chunks awaiting a relay OK at once, per transfer
+  std::chrono::milliseconds file_chunk_retry_delay{ std::chrono::seconds(1) };///< First resend delay, doubled per try
+  std::chrono::milliseconds max_file_chunk_retry_delay{ std::chrono::minutes(1) };///< Cap on the resend delay
+  std::uint32_t file_chunk_max_attempts{ 5 };///< Unanswered sends of one chunk before its transfer pauses
+  std::uint32_t pow_difficulty{ 0 };///< NIP-13 leading zero bits mined into outgoing messages (0: none)
+  std::map<std::string, std::uint32_t> relay_pow_difficulty;///< Per-relay overrides of pow_difficulty
+  std::uint32_t pow_threads{ 0 };///< Mining threads (0: every hardware thread)
+  bool verify_event_signatures{ true };///< Drop relay-delivered events whose ID or signature does not check out
+  std::size_t verified_event_cache_size{ verified_event_cache::default_capacity };///< Event IDs remembered as verified
+  std::size_t discovered_bundle_memory{ bundle_registry::default_max_body_bytes };///< Cap on cached bundle bodies
+  bool discover_all_bundles{ false };///< Also subscribe to every bundle announcement on the relay
+  std::uint32_t bundle_discovery_limit{ 500 };///< Most stored announcements replayed for global discovery
+  std::chrono::seconds bundle_discovery_window{ std::chrono::days(30) };///< Oldest announcement replayed for it
+  std::size_t max_subscriptions{ subscription_manager::default_max_subscriptions };///< Open REQs the relay allows
+  std::map<std::string, std::size_t> relay_max_subscriptions;///< Per-relay overrides of max_subscriptions
+  std::uint32_t backfill_page_size{ 200 };///< Stored messages fetched per page after connecting (0: unpaged)
+  std::chrono::milliseconds backfill_retry_delay{ std::chrono::seconds(1) };///< First page retry delay, doubled per try
+  std::uint32_t backfill_page_attempts{ 3 };///< Requests of one page without EOSE before the backfill stops
+};
+
+/**
+ * @brief Relay-delivered event waiting for signature verification.
+ */
+struct pending_event
+{
+  std::string message;///< Raw relay message, for logging
+  nlohmann::json event;///< Event object from the EVENT message
+  bool verified{ false };///< Already known to be authentic from the verified-event cache
+};
+
+/**
+ * @brief Sending state of one chunked file transfer.
+ */
+struct file_transfer_state
+{
+  std::string peer_rdx;///< RDX fingerprint of the recipient
+  std::string name;///< File name sent to the recipient
+  std::uint32_t chunk_count{ 0 };///< Number of chunks in the transfer
+  std::uint32_t delivered{ 0 };///< Chunks the relay has accepted
+  std::deque<std::uint32_t> queued;///< Chunks waiting for a free window slot
+  std::set<std::uint32_t> in_flight;///< Chunks sent and awaiting a relay OK
+  std::set<std::uint32_t> retrying;///< Unanswered chunks waiting out their resend delay
+  std::map<std::uint32_t, std::uint32_t> unanswered;///< Sends without a relay answer, per chunk
+};
+
+/**
+ * @brief Bundle announcement mined for proof of work, kept for republishing.
  */
-struct discovered_bundle
+struct mined_bundle
 {
-  std::string rdx_fingerprint;///< RDX fingerprint from bundle
-  std::string nostr_pubkey;///< Nostr public key
-  std::string bundle_base64;///< Base64-encoded bundle data
-  std::string event_id;///< Nostr event ID
+  std::string unmined_event_id;///< Event ID of the announcement as the bridge signed it
+  std::uint32_t difficulty{ 0 };///< Leading zero bits it was mined to
+  std::pair<std::string, std::vector<std::byte>> frame;///< Mined event ID and serialized event
+};
+
+/**
+ * @brief Counters describing how bundle republish triggers were coalesced.
+ */
+struct republish_stats
+{
+  std::uint64_t triggers{ 0 };///< Number of republish requests received
+  std::uint64_t publishes{ 0 };///< Number of bundles actually generated and published
 };
 
 /**
@@ -60,7 +156,7 @@ struct session_orchestrator : public std::enable_shared_from_this<session_orches
    * @param transport_out_queue Queue for outgoing transport commands
    * @param presentation_out_queue Queue for outgoing presentation events
    * @param connection_monitor_out_queue Queue for outgoing transport status events
-   * @param timeout Default timeout for relay requests
+   * @param config Timing, file transfer, proof-of-work, verification, discovery and subscription settings
    */
   session_orchestrator(const std::shared_ptr<Bridge> &bridge,
     const std::shared_ptr<Tracker> &tracker,
@@ -69,12 +165,44 @@ struct session_orchestrator : public std::enable_shared_from_this<session_orches
     const std::shared_ptr<async::async_queue<core::events::transport::in_t>> &transport_out_queue,
     const std::shared_ptr<async::async_queue<core::events::presentation_event_variant_t>> &presentation_out_queue,
     const std::shared_ptr<async::async_queue<core::events::connection_monitor::in_t>> &connection_monitor_out_queue,
-    std::chrono::milliseconds timeout = std::chrono::seconds(15))
-    : bridge_(bridge), handler_(bridge_), tracker_(tracker), request_timeout_(timeout), io_context_(io_context),
-      in_queue_(in_queue), transport_out_queue_(transport_out_queue), presentation_out_queue_(presentation_out_queue),
-      connection_monitor_out_queue_(connection_monitor_out_queue)
+    session_orchestrator_config config = {})
+    : bridge_(bridge), handler_(bridge_), tracker_(tracker),
+      health_(config.request_timeout, config.min_request_timeout, config.request_timeout_multiplier),
+      timestamp_flush_interval_(config.timestamp_flush_interval), republish_window_(config.republish_window),
+      key_maintenance_period_(config.key_maintenance_period), key_maintenance_jitter_(config.key_maintenance_jitter),
+      file_transfer_window_(config.file_transfer_window), file_chunk_retry_delay_(config.file_chunk_retry_delay),
+      max_file_chunk_retry_delay_(config.max_file_chunk_retry_delay),
+      file_chunk_max_attempts_(config.file_chunk_max_attempts), pow_difficulty_(config.pow_difficulty),
+      relay_pow_difficulty_(std::move(config.relay_pow_difficulty)), pow_threads_(config.pow_threads),
+      verify_event_signatures_(config.verify_event_signatures), verified_events_(config.verified_event_cache_size),
+      io_context_(io_context), timestamp_flush_timer_(*io_context), republish_timer_(*io_context),
+      maintenance_timer_(*io_context), in_queue_(in_queue), transport_out_queue_(transport_out_queue),
+      presentation_out_queue_(presentation_out_queue), connection_monitor_out_queue_(connection_monitor_out_queue),
+      discovered_bundles_(config.discovered_bundle_memory), discover_all_bundles_(config.discover_all_bundles),
+      bundle_discovery_limit_(config.bundle_discovery_limit), bundle_discovery_window_(config.bundle_discovery_window),
+      max_subscriptions_(config.max_subscriptions),
+      relay_max_subscriptions_(std::move(config.relay_max_subscriptions)), subscriptions_(config.max_subscriptions),
+      backfill_page_size_(config.backfill_page_size), backfill_page_timeout_(config.request_timeout),
+      backfill_retry_delay_(config.backfill_retry_delay),
+      backfill_page_attempts_(config.backfill_page_attempts), backfill_retry_timer_(*io_context)
   {}
 
+  session_orchestrator(const session_orchestrator &) = delete;
+  auto operator=(const session_orchestrator &) -> session_orchestrator & = delete;
+  session_orchestrator(session_orchestrator &&) = delete;
+  auto operator=(session_orchestrator &&) -> session_orchestrator & = delete;
+
+  /**
+   * @brief Abandons any mining and waits for in-flight key maintenance and verification before tearing down.
+   */
+  ~session_orchestrator()
+  {
+    pow_stop_.request_stop();
+    pow_pool_.join();
+    maintenance_pool_.join();
+    verification_pool_.join();
+  }
+
   /**
    * @brief Processes a single event from the queue.
    *
@@ -101,6 +229,12 @@ struct session_orchestrator : public std::enable_shared_from_this<session_orches
     try {
       while (true) { co_await run_once(cancel_slot); }
     } catch (const boost::system::system_error &e) {
+      timestamp_flush_timer_.cancel();
+      republish_timer_.cancel();
+      maintenance_timer_.cancel();
+      backfill_retry_timer_.cancel();
+      pow_stop_.request_stop();
+      flush_last_message_timestamp();
       if (e.code() == boost::asio::error::operation_aborted
           or e.code() == boost::asio::experimental::error::channel_cancelled
           or e.code() == boost::asio::experimental::error::channel_closed) {
@@ -113,294 +247,2058 @@ struct session_orchestrator : public std::enable_shared_from_this<session_orches
     }
   }
 
-private:
   /**
-   * @brief Returns the list of discovered prekey bundles.
+   * @brief Returns bundle republish counters.
+   *
+   * @return Number of republish triggers versus bundles actually published
+   */
+  [[nodiscard]] auto get_republish_stats() const -> republish_stats { return republish_stats_; }
+
+private:
+  /**
+   * @brief Returns the list of discovered prekey bundles.
+   *
+   * @return Reference to discovered bundles vector
+   */
+  [[nodiscard]] auto get_discovered_bundles() const -> const std::vector<discovered_bundle> &
+  {
+    return discovered_bundles_.bundles();
+  }
+
+  std::shared_ptr<Bridge> bridge_;
+  nostr::message_handler<Bridge> handler_;
+  std::shared_ptr<Tracker> tracker_;
+  relay_health health_;
+  std::set<std::string> refused_locally_;
+  std::deque<std::string> relay_candidates_;
+  std::chrono::milliseconds timestamp_flush_interval_;
+  std::chrono::milliseconds republish_window_;
+  std::chrono::milliseconds key_maintenance_period_;
+  std::chrono::milliseconds key_maintenance_jitter_;
+  std::size_t file_transfer_window_;
+  std::chrono::milliseconds file_chunk_retry_delay_;
+  std::chrono::milliseconds max_file_chunk_retry_delay_;
+  std::uint32_t file_chunk_max_attempts_;
+  std::uint32_t pow_difficulty_;
+  std::map<std::string, std::uint32_t> relay_pow_difficulty_;
+  std::uint32_t pow_threads_;
+  bool verify_event_signatures_;
+  verified_event_cache verified_events_;
+  boost::asio::thread_pool verification_pool_{ 1 };
+  std::deque<pending_event> pending_events_;
+  bool verification_in_progress_{ false };
+  std::shared_ptr<boost::asio::io_context> io_context_;
+  boost::asio::steady_timer timestamp_flush_timer_;
+  bool timestamp_flush_scheduled_{ false };
+  boost::asio::steady_timer republish_timer_;
+  bool republish_scheduled_{ false };
+  std::uint64_t pending_republish_triggers_{ 0 };
+  republish_stats republish_stats_;
+  boost::asio::steady_timer maintenance_timer_;
+  boost::asio::thread_pool maintenance_pool_{ 1 };
+  bool maintenance_in_progress_{ false };
+  boost::asio::thread_pool pow_pool_{ 1 };
+  std::stop_source pow_stop_;
+  std::optional<mined_bundle> mined_bundle_;
+  std::string relay_url_;
+  core::events::transport::relay_limits relay_limits_;
+  std::minstd_rand jitter_rng_{ std::random_device{}() };
+  std::shared_ptr<async::async_queue<core::events::session_orchestrator::in_t>> in_queue_;
+  std::shared_ptr<async::async_queue<core::events::transport::in_t>> transport_out_queue_;
+  std::shared_ptr<async::async_queue<core::events::presentation_event_variant_t>> presentation_out_queue_;
+  std::shared_ptr<async::async_queue<core::events::connection_monitor::in_t>> connection_monitor_out_queue_;
+  bundle_registry discovered_bundles_;
+  bool bundle_cache_loaded_{ false };
+  bool discover_all_bundles_;
+  std::uint32_t bundle_discovery_limit_;
+  std::chrono::seconds bundle_discovery_window_;
+  std::size_t max_subscriptions_;
+  std::map<std::string, std::size_t> relay_max_subscriptions_;
+  subscription_manager subscriptions_;
+  std::uint32_t backfill_page_size_;
+  std::chrono::milliseconds backfill_page_timeout_;
+  std::chrono::milliseconds backfill_retry_delay_;
+  std::uint32_t backfill_page_attempts_;
+  std::optional<message_backfill> backfill_;
+  bool backfill_draining_{ false };
+  std::uint32_t backfill_page_failures_{ 0 };
+  boost::asio::steady_timer backfill_retry_timer_;
+  std::set<std::string> bundle_fetches_;
+  std::map<std::string, std::vector<std::string>> bundle_fetch_batches_;
+  std::map<std::string, std::string> pending_trusts_;
+  std::set<std::string> subscribed_group_ids_;
+  std::string our_pubkey_;
+  std::map<std::string, file_transfer_state> file_transfers_;
+  bool file_transfers_paused_{ false };
+
+  /**
+   * @brief Emits an event to the transport queue.
+   *
+   * @param evt Event to forward to transport layer
+   */
+  auto emit_transport_event(core::events::transport::in_t evt) -> void
+  {
+    if (const auto *send = std::get_if<core::events::transport::send>(&evt);
+        send != nullptr and exceeds_message_length(send->bytes)) {
+      reject_oversized_event(send->bytes);
+      return;
+    }
+    if (auto *batch = std::get_if<core::events::transport::send_batch>(&evt); batch != nullptr) {
+      std::erase_if(batch->frames, [this](const std::vector<std::byte> &frame) {
+        if (not exceeds_message_length(frame)) { return false; }
+        reject_oversized_event(frame);
+        return true;
+      });
+      if (batch->frames.empty()) { return; }
+    }
+    transport_out_queue_->push(std::move(evt));
+  }
+
+  /**
+   * @brief Checks a frame against the connected relay's advertised message length.
+   *
+   * @param frame Serialized Nostr message
+   * @return true if the relay would refuse the frame unread
+   */
+  [[nodiscard]] auto exceeds_message_length(std::span<const std::byte> frame) const -> bool
+  {
+    return relay_limits_.max_message_length and frame.size() > *relay_limits_.max_message_length;
+  }
+
+  /**
+   * @brief Fails an EVENT the relay would refuse for its size instead of sending it.
+   *
+   * The publisher is already waiting for the relay's OK, so the refusal is delivered as an OK
+   * once the current handler returns rather than after the request timeout.
+   *
+   * @param frame Serialized EVENT message
+   */
+  auto reject_oversized_event(std::span<const std::byte> frame) -> void
+  {
+    const auto reason =
+      fmt::format("invalid: {} bytes exceeds max_message_length {}", frame.size(), *relay_limits_.max_message_length);
+
+    std::string json_str(frame.size(), '\0');
+    std::ranges::transform(frame, json_str.begin(), [](std::byte byte) { return std::bit_cast<char>(byte); });
+    std::string event_id;
+    try {
+      const auto parsed = nlohmann::json::parse(json_str);
+      if (parsed.is_array() and parsed.size() >= 2 and parsed[1].is_object() and parsed[1].contains("id")) {
+        event_id = parsed[1]["id"].get<std::string>();
+      }
+    } catch (const std::exception &e) {
+      spdlog::debug("[session_orchestrator] Unreadable oversized frame: {}", e.what());
+    }
+
+    spdlog::warn("[session_orchestrator] Not sending event {} to {}: {}", event_id, relay_url_, reason);
+    if (event_id.empty()) { return; }
+    refused_locally_.insert(event_id);
+    boost::asio::post(*io_context_, [self = this->shared_from_this(), event_id, reason]() {
+      self->tracker_->resolve(
+        event_id, nostr::protocol::ok{ .event_id = event_id, .accepted = false, .message = reason });
+    });
+  }
+
+  /**
+   * @brief Emits an event to the presentation queue.
+   *
+   * @param evt Event to forward to presentation layer
+   */
+  auto emit_presentation_event(core::events::presentation_event_variant_t evt) -> void
+  {
+    presentation_out_queue_->push(std::move(evt));
+  }
+
+  /**
+   * @brief Emits a transport status event for connection monitoring.
+   *
+   * @param evt Event to forward to connection monitor
+   */
+  auto emit_connection_monitor_event(core::events::connection_monitor::in_t evt) -> void
+  {
+    connection_monitor_out_queue_->push(std::move(evt));
+  }
+
+  /**
+   * @brief Sends the relay's current latency and health figures to the connection monitor.
+   *
+   * @param url Relay URL
+   */
+  auto publish_relay_stats(const std::string &url) -> void
+  {
+    if (url.empty()) { return; }
+    emit_connection_monitor_event(health_.stats(url));
+  }
+
+  /**
+   * @brief Persists the last message timestamp if it advanced since the previous write.
+   *
+   * Storage failures are logged and the value stays pending for the next flush.
+   */
+  auto flush_last_message_timestamp() -> void
+  {
+    try {
+      if (handler_.flush_last_message_timestamp()) {
+        spdlog::debug("[session_orchestrator] Persisted last message timestamp");
+      }
+    } catch (const std::exception &e) {
+      spdlog::warn("[session_orchestrator] Failed to persist last message timestamp: {}", e.what());
+    }
+  }
+
+  /**
+   * @brief Arms the debounce timer that persists the last message timestamp.
+   *
+   * Subsequent messages arriving while the timer is pending are coalesced into the same write.
+   */
+  auto schedule_timestamp_flush() -> void
+  {
+    if (timestamp_flush_scheduled_ or not handler_.has_pending_message_timestamp()) { return; }
+
+    timestamp_flush_scheduled_ = true;
+    timestamp_flush_timer_.expires_after(timestamp_flush_interval_);
+    timestamp_flush_timer_.async_wait([weak_self = this->weak_from_this()](const boost::system::error_code &error) {
+      auto self = weak_self.lock();
+      if (not self) { return; }
+      self->timestamp_flush_scheduled_ = false;
+      if (not error) { self->flush_last_message_timestamp(); }
+    });
+  }
+
+  /**
+   * @brief Requests a bundle republish, coalescing requests within the republish window.
+   *
+   * The first request arms a timer; every further request until it fires is folded into the
+   * same bundle generation and publish.
+   */
+  auto request_bundle_republish() -> void
+  {
+    ++republish_stats_.triggers;
+    ++pending_republish_triggers_;
+    if (republish_scheduled_) { return; }
+
+    republish_scheduled_ = true;
+    republish_timer_.expires_after(republish_window_);
+    republish_timer_.async_wait([weak_self = this->weak_from_this()](const boost::system::error_code &error) {
+      auto self = weak_self.lock();
+      if (not self) { return; }
+      self->republish_scheduled_ = false;
+      if (error) { return; }
+
+      ++self->republish_stats_.publishes;
+      spdlog::info("[session_orchestrator] Republishing bundle ({} trigger(s) coalesced, {} publishes / {} triggers)",
+        self->pending_republish_triggers_,
+        self->republish_stats_.publishes,
+        self->republish_stats_.triggers);
+      self->pending_republish_triggers_ = 0;
+      self->handle(core::events::publish_identity{});
+    });
+  }
+
+  /**
+   * @brief Schedules the next key maintenance run.
+   *
+   * @param delay Delay before the run
+   */
+  auto schedule_key_maintenance(std::chrono::milliseconds delay) -> void
+  {
+    maintenance_timer_.expires_after(delay);
+    maintenance_timer_.async_wait([weak_self = this->weak_from_this()](const boost::system::error_code &error) {
+      if (error) { return; }
+      if (auto self = weak_self.lock()) { self->start_key_maintenance(); }
+    });
+  }
+
+  /**
+   * @brief Runs key maintenance on the maintenance thread and reports back on the io_context.
+   *
+   * Rotation checks, expired-key cleanup and rotation itself never block event processing.
+   */
+  auto start_key_maintenance() -> void
+  {
+    if (maintenance_in_progress_) { return; }
+    maintenance_in_progress_ = true;
+
+    boost::asio::post(maintenance_pool_,
+      [bridge = bridge_,
+        io_context = io_context_,
+        weak_self = this->weak_from_this(),
+        work = boost::asio::make_work_guard(*io_context_)]() mutable -> void {
+        std::optional<signal::key_maintenance_result> result;
+        try {
+          result = bridge->perform_key_maintenance();
+        } catch (const std::exception &e) {
+          spdlog::warn("[session_orchestrator] Key maintenance failed: {}", e.what());
+        }
+
+        boost::asio::post(*io_context, [weak_self, result, work = std::move(work)]() -> void {
+          if (auto self = weak_self.lock()) { self->finish_key_maintenance(result); }
+        });
+      });
+  }
+
+  /**
+   * @brief Handles the outcome of a key maintenance run.
+   *
+   * @param result Maintenance result, or std::nullopt if maintenance failed
+   */
+  auto finish_key_maintenance(const std::optional<signal::key_maintenance_result> &result) -> void
+  {
+    maintenance_in_progress_ = false;
+
+    if (result and (result->signed_pre_key_rotated or result->kyber_pre_key_rotated)) {
+      spdlog::info("[session_orchestrator] Keys rotated, scheduling bundle republish");
+      request_bundle_republish();
+    }
+
+    if (key_maintenance_period_.count() > 0) {
+      auto delay = key_maintenance_period_;
+      if (key_maintenance_jitter_.count() > 0) {
+        std::uniform_int_distribution<std::chrono::milliseconds::rep> jitter(0, key_maintenance_jitter_.count());
+        delay += std::chrono::milliseconds(jitter(jitter_rng_));
+      }
+      schedule_key_maintenance(delay);
+    }
+  }
+
+  /**
+   * @brief Dispatches a relay-delivered event to the message handler by kind.
+   *
+   * @param event_data Event object from an EVENT message
+   */
+  auto dispatch_event(nlohmann::json event_data) -> void
+  {
+    auto kind_value = event_data["kind"].get<std::uint32_t>();
+
+    switch (static_cast<nostr::protocol::kind>(kind_value)) {
+    case nostr::protocol::kind::encrypted_message: {
+      nostr::events::incoming::encrypted_message evt_inner{ nostr::protocol::event_data{ .id = event_data["id"],
+        .pubkey = event_data["pubkey"],
+        .created_at = event_data["created_at"],
+        .kind = event_data["kind"],
+        .tags = event_data["tags"],
+        .content = event_data["content"],
+        .sig = event_data["sig"] } };
+
+      std::optional<core::events::message_received> result;
+      try {
+        result = handler_.handle(evt_inner);
+      } catch (const std::exception &) {
+        fetch_unknown_sender_bundle(evt_inner.pubkey);
+        throw;
+      }
+      if (result) {
+        emit_presentation_event(*result);
+        schedule_timestamp_flush();
+        if (result->should_republish_bundle) { request_bundle_republish(); }
+      }
+      break;
+    }
+    case nostr::protocol::kind::sender_key_distribution: {
+      nostr::events::incoming::sender_key_distribution evt_inner{ nostr::protocol::event_data{
+        .id = event_data["id"],
+        .pubkey = event_data["pubkey"],
+        .created_at = event_data["created_at"],
+        .kind = event_data["kind"],
+        .tags = event_data["tags"],
+        .content = event_data["content"],
+        .sig = event_data["sig"] } };
+
+      if (auto result = handler_.handle(evt_inner)) {
+        subscribe_to_group(result->group_id);
+        schedule_timestamp_flush();
+        if (result->should_republish_bundle) { request_bundle_republish(); }
+        emit_presentation_event(*result);
+      }
+      break;
+    }
+    case nostr::protocol::kind::group_message: {
+      // The g filter matches our own broadcasts too, and our sender key cannot decrypt them again
+      if (event_data["pubkey"] == our_pubkey_) { break; }
+      nostr::events::incoming::group_message evt_inner{ nostr::protocol::event_data{ .id = event_data["id"],
+        .pubkey = event_data["pubkey"],
+        .created_at = event_data["created_at"],
+        .kind = event_data["kind"],
+        .tags = event_data["tags"],
+        .content = event_data["content"],
+        .sig = event_data["sig"] } };
+
+      if (auto result = handler_.handle(evt_inner)) {
+        emit_presentation_event(*result);
+        schedule_timestamp_flush();
+      }
+      break;
+    }
+    case nostr::protocol::kind::file_chunk: {
+      nostr::events::incoming::file_chunk evt_inner{ nostr::protocol::event_data{ .id = event_data["id"],
+        .pubkey = event_data["pubkey"],
+        .created_at = event_data["created_at"],
+        .kind = event_data["kind"],
+        .tags = event_data["tags"],
+        .content = event_data["content"],
+        .sig = event_data["sig"] } };
+
+      if (auto result = handler_.handle(evt_inner)) {
+        schedule_timestamp_flush();
+        if (result->chunks_done == 1 or result->complete) { emit_presentation_event(*result); }
+      }
+      break;
+    }
+    case nostr::protocol::kind::bundle_announcement: {
+      nostr::events::incoming::bundle_announcement evt_inner{ nostr::protocol::event_data{ .id = event_data["id"],
+        .pubkey = event_data["pubkey"],
+        .created_at = event_data["created_at"],
+        .kind = event_data["kind"],
+        .tags = event_data["tags"],
+        .content = event_data["content"],
+        .sig = event_data["sig"] } };
+
+      if (auto result = handler_.handle(evt_inner)) {
+        std::visit(
+          [this](auto &&inner_evt) {
+            handle(inner_evt);
+            emit_presentation_event(inner_evt);
+          },
+          *result);
+      }
+      break;
+    }
+    case nostr::protocol::kind::identity_announcement: {
+      nostr::events::incoming::identity_announcement evt_inner{ nostr::protocol::event_data{
+        .id = event_data["id"],
+        .pubkey = event_data["pubkey"],
+        .created_at = event_data["created_at"],
+        .kind = event_data["kind"],
+        .tags = event_data["tags"],
+        .content = event_data["content"],
+        .sig = event_data["sig"] } };
+
+      handler_.handle(evt_inner);
+      break;
+    }
+    case nostr::protocol::kind::session_request: {
+      nostr::events::incoming::session_request evt_inner{ nostr::protocol::event_data{ .id = event_data["id"],
+        .pubkey = event_data["pubkey"],
+        .created_at = event_data["created_at"],
+        .kind = event_data["kind"],
+        .tags = event_data["tags"],
+        .content = event_data["content"],
+        .sig = event_data["sig"] } };
+
+      handler_.handle(evt_inner);
+      break;
+    }
+    case nostr::protocol::kind::node_status: {
+      nostr::events::incoming::node_status evt_inner{ nostr::protocol::event_data{ .id = event_data["id"],
+        .pubkey = event_data["pubkey"],
+        .created_at = event_data["created_at"],
+        .kind = event_data["kind"],
+        .tags = event_data["tags"],
+        .content = event_data["content"],
+        .sig = event_data["sig"] } };
+
+      handler_.handle(evt_inner);
+      break;
+    }
+    default: {
+      nostr::events::incoming::unknown_message evt_inner{ nostr::protocol::event_data{ .id = event_data["id"],
+        .pubkey = event_data["pubkey"],
+        .created_at = event_data["created_at"],
+        .kind = event_data["kind"],
+        .tags = event_data["tags"],
+        .content = event_data["content"],
+        .sig = event_data["sig"] } };
+
+      handler_.handle(evt_inner);
+      break;
+    }
+    }
+  }
+
+  /**
+   * @brief Logs a failure to process a relay message.
+   *
+   * Replayed messages are expected after reconnecting and only logged at debug level; anything else
+   * is reported and surfaced as an unknown protocol message.
+   *
+   * @param json_str Raw relay message
+   * @param e Exception raised while processing it
+   */
+  auto report_event_error(const std::string &json_str, const std::exception &e) -> void
+  {
+    std::string error_msg(e.what());
+    if (error_msg.find("old counter") != std::string::npos
+        or error_msg.find("message with old") != std::string::npos) {
+      try {
+        auto parsed = nlohmann::json::parse(json_str);
+        if (parsed.is_array() and parsed.size() >= 3 and parsed[2].contains("pubkey")
+            and parsed[2].contains("id")) {
+          spdlog::debug("[session_orchestrator] Ignored duplicate message from {} (event: {})",
+            parsed[2]["pubkey"].get<std::string>().substr(0, 16),
+            parsed[2]["id"].get<std::string>().substr(0, 16));
+        } else {
+          spdlog::debug("[session_orchestrator] Ignored duplicate message: {}", error_msg);
+        }
+      } catch (...) {
+        spdlog::debug("[session_orchestrator] Ignored duplicate message: {}", error_msg);
+      }
+    } else {
+      spdlog::warn("[session_orchestrator] Failed to parse message: {} - Raw: {}", error_msg, json_str);
+      nostr::events::incoming::unknown_protocol evt_inner{ json_str };
+      handler_.handle(evt_inner);
+    }
+  }
+
+  /**
+   * @brief Verifies or dispatches an incoming event.
+   *
+   * Events already in the verified-event cache skip verification. Others queue up while a batch is being
+   * verified, so the next batch holds everything that arrived in the meantime. Cached events also queue
+   * behind pending ones to keep delivery in relay order.
+   *
+   * @param json_str Raw relay message
+   * @param event_data Event object from the EVENT message
+   */
+  auto receive_event(const std::string &json_str, nlohmann::json event_data) -> void
+  {
+    if (not verify_event_signatures_) {
+      dispatch_event(std::move(event_data));
+      return;
+    }
+
+    const auto cached = verified_events_.contains(event_data);
+    if (cached and pending_events_.empty()) {
+      dispatch_event(std::move(event_data));
+      return;
+    }
+
+    pending_events_.push_back({ .message = json_str, .event = std::move(event_data), .verified = cached });
+    if (not verification_in_progress_) { start_event_verification(); }
+  }
+
+  /**
+   * @brief Verifies the pending events on the verification thread and reports back on the io_context.
+   */
+  auto start_event_verification() -> void
+  {
+    std::vector<std::string> batch;
+    for (const auto &pending : pending_events_) {
+      if (not pending.verified) { batch.push_back(pending.event.dump()); }
+    }
+    if (batch.empty()) {
+      finish_event_verification({}, pending_events_.size());
+      return;
+    }
+    verification_in_progress_ = true;
+
+    boost::asio::post(verification_pool_,
+      [bridge = bridge_,
+        io_context = io_context_,
+        weak_self = this->weak_from_this(),
+        work = boost::asio::make_work_guard(*io_context_),
+        batch = std::move(batch),
+        count = pending_events_.size()]() mutable -> void {
+        std::vector<bool> verified;
+        try {
+          verified = bridge->verify_events(batch);
+        } catch (const std::exception &e) {
+          spdlog::warn("[session_orchestrator] Event verification failed: {}", e.what());
+        }
+
+        boost::asio::post(
+          *io_context, [weak_self, verified = std::move(verified), count, work = std::move(work)]() -> void {
+            if (auto self = weak_self.lock()) { self->finish_event_verification(verified, count); }
+          });
+      });
+  }
+
+  /**
+   * @brief Dispatches the authentic events of a verified batch and drops the rest.
+   *
+   * @param verified One flag per event of the batch that was not already verified
+   * @param count Number of pending events the batch covered
+   */
+  auto finish_event_verification(const std::vector<bool> &verified, std::size_t count) -> void
+  {
+    verification_in_progress_ = false;
+
+    std::size_t result_index = 0;
+    for (std::size_t i = 0; i < count and not pending_events_.empty(); ++i) {
+      auto pending = std::move(pending_events_.front());
+      pending_events_.pop_front();
+
+      if (not pending.verified) {
+        pending.verified = result_index < verified.size() and verified[result_index];
+        ++result_index;
+        if (not pending.verified) {
+          spdlog::warn("[session_orchestrator] Dropped event with invalid ID or signature: {}", pending.message);
+          continue;
+        }
+        verified_events_.insert(pending.event);
+      }
+
+      try {
+        dispatch_event(std::move(pending.event));
+      } catch (const std::exception &e) {
+        report_event_error(pending.message, e);
+      }
+    }
+
+    if (not pending_events_.empty()) {
+      start_event_verification();
+    } else if (backfill_draining_) {
+      advance_backfill();
+    }
+  }
+
+  /**
+   * @brief Returns the proof-of-work difficulty required by the connected relay.
+   *
+   * The configured difficulty is raised to the relay's advertised `min_pow_difficulty`.
+   *
+   * @return Leading zero bits to mine, 0 if outgoing events need no proof of work
+   */
+  [[nodiscard]] auto pow_difficulty() const -> std::uint32_t
+  {
+    const auto override_iter = relay_pow_difficulty_.find(relay_url_);
+    const auto configured = override_iter != relay_pow_difficulty_.end() ? override_iter->second : pow_difficulty_;
+    return std::max(configured, relay_limits_.min_pow_difficulty.value_or(0));
+  }
+
+  /**
+   * @brief Mines a NIP-13 nonce into an outgoing event on the mining thread.
+   *
+   * The job is posted to the mining thread and its result posted back to the io_context, so the
+   * event loop keeps running while mining. The destructor stops and joins the mining thread before
+   * any member goes away, so the job can refer to the handler directly. Mining failures, including
+   * a signed ID that differs from the mined one, fall back to the unmined event, which a relay
+   * demanding proof of work will reject like any other.
+   *
+   * @param frame Event ID and serialized event from the message handler
+   * @return The frame to publish
+   */
+  auto with_proof_of_work(std::pair<std::string, std::vector<std::byte>> frame)
+    -> boost::asio::awaitable<std::pair<std::string, std::vector<std::byte>>>
+  {
+    const auto difficulty = pow_difficulty();
+    if (difficulty == 0) { co_return frame; }
+
+    using mined_frame = std::pair<std::string, std::vector<std::byte>>;
+    co_return co_await boost::asio::async_initiate<const boost::asio::use_awaitable_t<> &, void(mined_frame)>(
+      [this, difficulty](auto completion, mined_frame unmined) -> void {
+        boost::asio::post(pow_pool_,
+          [handler = &handler_,
+            io_context = io_context_,
+            work = boost::asio::make_work_guard(*io_context_),
+            completion = std::move(completion),
+            unmined = std::move(unmined),
+            difficulty,
+            threads = pow_threads_,
+            stop = pow_stop_.get_token()]() mutable -> void {
+            mined_frame result;
+            try {
+              result =
+                handler->add_proof_of_work(unmined, difficulty, pow::mining_options{ .threads = threads }, stop);
+            } catch (const std::exception &e) {
+              spdlog::warn(
+                "[session_orchestrator] Proof of work failed, sending event {} unmined: {}", unmined.first, e.what());
+              result = std::move(unmined);
+            }
+
+            boost::asio::post(*io_context,
+              [completion = std::move(completion), result = std::move(result), work = std::move(work)]() mutable
+                -> void { std::move(completion)(std::move(result)); });
+          });
+      },
+      boost::asio::use_awaitable,
+      std::move(frame));
+  }
+
+  /**
+   * @brief Mines a bundle announcement once and reuses the result while it stays the same.
+   *
+   * The bridge hands out the same signed announcement until its keys change, so the event ID of
+   * the unmined frame identifies it. Republishing that announcement at the same difficulty sends
+   * the frame mined before instead of searching again. A frame that could not be mined is not kept.
+   *
+   * @param frame Event ID and serialized announcement from the message handler
+   * @return The frame to publish
+   */
+  auto with_bundle_proof_of_work(std::pair<std::string, std::vector<std::byte>> frame)
+    -> boost::asio::awaitable<std::pair<std::string, std::vector<std::byte>>>
+  {
+    const auto difficulty = pow_difficulty();
+    if (mined_bundle_ and mined_bundle_->unmined_event_id == frame.first and mined_bundle_->difficulty == difficulty) {
+      co_return mined_bundle_->frame;
+    }
+
+    auto unmined_event_id = frame.first;
+    auto mined = co_await with_proof_of_work(std::move(frame));
+    if (difficulty > 0 and mined.first != unmined_event_id) {
+      mined_bundle_ =
+        mined_bundle{ .unmined_event_id = std::move(unmined_event_id), .difficulty = difficulty, .frame = mined };
+    }
+    co_return mined;
+  }
+
+  /**
+   * @brief Handles a send command by encrypting and publishing a message.
+   *
+   * @param cmd Send command with peer and message content
+   */
+  auto handle(const core::events::send &cmd) -> void
+  {
+    boost::asio::co_spawn(
+      *io_context_,
+      // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+      [self = this->shared_from_this(), cmd]() -> boost::asio::awaitable<void> {
+        auto [event_id, bytes] = co_await self->with_proof_of_work(self->handler_.handle(cmd));
+
+        core::events::transport::send transport_cmd{ .message_id = core::uuid_generator::generate(),
+          .bytes = std::move(bytes) };
+        self->emit_transport_event(transport_cmd);
+
+        try {
+          auto ok_response = co_await self->template await_relay<nostr::protocol::ok>(event_id, relay_latency::ok);
+          self->emit_presentation_event(core::events::message_sent{ cmd.peer, event_id, ok_response.accepted });
+        } catch (const std::exception &) {
+          self->emit_presentation_event(
+            core::events::message_sent{ .peer = cmd.peer, .event_id = "", .accepted = false });
+        }
+      },
+      boost::asio::detached);
+  }
+
+  /**
+   * @brief Handles a send_many command by publishing one encrypted event per recipient as a single batch.
+   *
+   * Encryption and signing happen in one bridge call and the frames reach the transport as one batch.
+   * Each event's OK is tracked separately and the outcomes are reported together once all are known.
+   *
+   * @param cmd Send many command with recipients and message content
+   */
+  auto handle(const core::events::send_many &cmd) -> void
+  {
+    boost::asio::co_spawn(
+      *io_context_,
+      // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+      [self = this->shared_from_this(), cmd]() -> boost::asio::awaitable<void> {
+        std::vector<signal::fan_out_frame> frames;
+        try {
+          frames = self->handler_.handle(cmd);
+        } catch (const std::exception &e) {
+          spdlog::error("[session_orchestrator] Cannot send to {} recipients: {}", cmd.peers.size(), e.what());
+          self->emit_presentation_event(core::events::send_many_report{ .accepted = {}, .failed = cmd.peers });
+          co_return;
+        }
+
+        auto report = std::make_shared<core::events::send_many_report>();
+        core::events::transport::send_batch batch{ .message_id = core::uuid_generator::generate(), .frames = {} };
+        std::vector<std::pair<std::string, std::string>> pending;
+        for (auto &frame : frames) {
+          if (not frame.error.empty()) {
+            spdlog::warn("[session_orchestrator] Skipping {}: {}", frame.recipient, frame.error);
+            report->failed.push_back(std::move(frame.recipient));
+            continue;
+          }
+          std::tie(frame.event_id, frame.bytes) =
+            co_await self->with_proof_of_work({ std::move(frame.event_id), std::move(frame.bytes) });
+          pending.emplace_back(std::move(frame.recipient), std::move(frame.event_id));
+          batch.frames.push_back(std::move(frame.bytes));
+        }
+
+        if (pending.empty()) {
+          self->emit_presentation_event(std::move(*report));
+          co_return;
+        }
+
+        // Waiters go first so a batch frame refused before it is sent still finds its waiter
+        auto remaining = std::make_shared<std::size_t>(pending.size());
+        for (auto &entry : pending) {
+          boost::asio::co_spawn(
+            *self->io_context_,
+            // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+            [self, report, remaining, recipient = std::move(entry.first), event_id = std::move(entry.second)]()
+              -> boost::asio::awaitable<void> {
+              bool accepted = false;
+              try {
+                auto ok_response =
+                  co_await self->template await_relay<nostr::protocol::ok>(event_id, relay_latency::ok);
+                accepted = ok_response.accepted;
+              } catch (const std::exception &) {
+                accepted = false;
+              }
+              (accepted ? report->accepted : report->failed).push_back(recipient);
+              if (--*remaining == 0) { self->emit_presentation_event(std::move(*report)); }
+            },
+            boost::asio::detached);
+        }
+        self->emit_transport_event(std::move(batch));
+      },
+      boost::asio::detached);
+  }
+
+  /**
+   * @brief Handles a send_file command by starting a chunked transfer.
+   *
+   * @param cmd Send file command with peer and path
+   */
+  auto handle(const core::events::send_file &cmd) -> void
+  {
+    try {
+      track_file_transfer(handler_.handle(cmd));
+    } catch (const std::exception &e) {
+      spdlog::error("[session_orchestrator] Cannot send {} to {}: {}", cmd.path, cmd.peer, e.what());
+      emit_presentation_event(core::events::file_transfer_progress{ .transfer_id = "",
+        .peer = cmd.peer,
+        .name = cmd.path,
+        .chunks_done = 0,
+        .chunk_count = 0,
+        .outgoing = true,
+        .complete = false,
+        .path = "",
+        .error = e.what() });
+    }
+  }
+
+  /**
+   * @brief Starts sending the pending chunks of a transfer unless it is already in progress.
+   *
+   * @param transfer Transfer with the chunks no relay has accepted yet
+   */
+  auto track_file_transfer(signal::outgoing_transfer transfer) -> void
+  {
+    if (file_transfers_.contains(transfer.transfer_id)) { return; }
+
+    const auto pending = static_cast<std::uint32_t>(transfer.pending_chunks.size());
+    auto &state = file_transfers_[transfer.transfer_id];
+    state.peer_rdx = std::move(transfer.peer_rdx);
+    state.name = std::move(transfer.name);
+    state.chunk_count = transfer.chunk_count;
+    state.delivered = transfer.chunk_count - pending;
+    state.queued.assign(transfer.pending_chunks.begin(), transfer.pending_chunks.end());
+
+    emit_file_transfer_progress(transfer.transfer_id, state, "");
+    pump_file_transfer(transfer.transfer_id);
+  }
+
+  /**
+   * @brief Sends queued chunks of a transfer until its window is full.
+   *
+   * Nothing is sent while the transport is down; queued chunks wait for the next connection.
+   *
+   * @param transfer_id Outgoing transfer
+   */
+  auto pump_file_transfer(const std::string &transfer_id) -> void
+  {
+    auto iter = file_transfers_.find(transfer_id);
+    if (iter == file_transfers_.end() or file_transfers_paused_) { return; }
+
+    std::vector<std::uint32_t> chunks;
+    auto &state = iter->second;
+    while (state.in_flight.size() + state.retrying.size() < file_transfer_window_ and not state.queued.empty()) {
+      chunks.push_back(state.queued.front());
+      state.in_flight.insert(state.queued.front());
+      state.queued.pop_front();
+    }
+    for (const auto chunk_index : chunks) { send_file_chunk(transfer_id, chunk_index); }
+  }
+
+  /**
+   * @brief Publishes one chunk and reports the relay's answer back to the transfer.
+   *
+   * @param transfer_id Outgoing transfer
+   * @param chunk_index Chunk to send
+   */
+  auto send_file_chunk(const std::string &transfer_id, std::uint32_t chunk_index) -> void
+  {
+    boost::asio::co_spawn(
+      *io_context_,
+      // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+      [self = this->shared_from_this(), transfer_id, chunk_index]() -> boost::asio::awaitable<void> {
+        std::pair<std::string, std::vector<std::byte>> frame;
+        try {
+          frame = self->handler_.create_transfer_chunk(transfer_id, chunk_index);
+        } catch (const std::exception &e) {
+          self->pause_file_transfer(transfer_id, e.what());
+          co_return;
+        }
+        frame = co_await self->with_proof_of_work(std::move(frame));
+
+        self->emit_transport_event(core::events::transport::send{ .message_id = core::uuid_generator::generate(),
+          .bytes = std::move(frame.second) });
+
+        std::optional<bool> accepted;
+        try {
+          auto ok_response = co_await self->template await_relay<nostr::protocol::ok>(frame.first, relay_latency::ok);
+          accepted = ok_response.accepted;
+        } catch (const std::exception &e) {
+          spdlog::debug("[session_orchestrator] No OK for chunk {} of {}: {}", chunk_index, transfer_id, e.what());
+        }
+        self->finish_file_chunk(transfer_id, chunk_index, accepted);
+      },
+      boost::asio::detached);
+  }
+
+  /**
+   * @brief Records the relay's answer for a chunk and refills the window.
+   *
+   * A chunk without an answer is sent again after a delay that doubles with each unanswered send,
+   * keeping its window slot meanwhile. A rejected chunk, or one left unanswered too often, pauses the
+   * transfer until the next connection.
+   *
+   * @param transfer_id Outgoing transfer
+   * @param chunk_index Chunk that was sent
+   * @param accepted Relay's answer, or std::nullopt if none arrived in time
+   */
+  auto finish_file_chunk(const std::string &transfer_id, std::uint32_t chunk_index, std::optional<bool> accepted)
+    -> void
+  {
+    auto iter = file_transfers_.find(transfer_id);
+    if (iter == file_transfers_.end() or iter->second.in_flight.erase(chunk_index) == 0) { return; }
+    auto &state = iter->second;
+
+    if (not accepted.has_value()) {
+      const auto attempts = ++state.unanswered[chunk_index];
+      if (attempts >= file_chunk_max_attempts_) {
+        pause_file_transfer(transfer_id, fmt::format("no answer for chunk {} after {} sends", chunk_index, attempts));
+        return;
+      }
+      state.retrying.insert(chunk_index);
+      schedule_file_chunk_retry(transfer_id, chunk_index, file_chunk_retry_delay(attempts));
+      return;
+    }
+    if (not *accepted) {
+      pause_file_transfer(transfer_id, fmt::format("relay rejected chunk {}", chunk_index));
+      return;
+    }
+
+    bool complete = false;
+    try {
+      complete = bridge_->mark_transfer_chunk_delivered(transfer_id, chunk_index);
+    } catch (const std::exception &e) {
+      pause_file_transfer(transfer_id, e.what());
+      return;
+    }
+
+    ++state.delivered;
+    if (complete) {
+      state.delivered = state.chunk_count;
+      emit_file_transfer_progress(transfer_id, state, "");
+      file_transfers_.erase(iter);
+      return;
+    }
+    pump_file_transfer(transfer_id);
+  }
+
+  /**
+   * @brief Returns how long to wait before resending a chunk.
+   *
+   * @param attempts Unanswered sends of the chunk so far
+   * @return Retry delay doubled per earlier unanswered send, capped at the configured maximum
+   */
+  [[nodiscard]] auto file_chunk_retry_delay(std::uint32_t attempts) const -> std::chrono::milliseconds
+  {
+    auto delay = file_chunk_retry_delay_;
+    for (std::uint32_t attempt = 1; attempt < attempts and delay < max_file_chunk_retry_delay_; ++attempt) {
+      delay *= 2;
+    }
+    return std::min(delay, max_file_chunk_retry_delay_);
+  }
+
+  /**
+   * @brief Puts an unanswered chunk back at the front of its queue once its delay has passed.
+   *
+   * Does nothing if the transfer was paused or finished meanwhile.
+   *
+   * @param transfer_id Outgoing transfer
+   * @param chunk_index Chunk to resend
+   * @param delay Time to wait first
+   */
+  auto schedule_file_chunk_retry(const std::string &transfer_id,
+    std::uint32_t chunk_index,
+    std::chrono::milliseconds delay) -> void
+  {
+    auto timer = std::make_shared<boost::asio::steady_timer>(*io_context_, delay);
+    timer->async_wait([self = this->shared_from_this(), timer, transfer_id, chunk_index](
+                        const boost::system::error_code &error) -> void {
+      if (error) { return; }
+      auto iter = self->file_transfers_.find(transfer_id);
+      if (iter == self->file_transfers_.end() or iter->second.retrying.erase(chunk_index) == 0) { return; }
+      iter->second.queued.push_front(chunk_index);
+      self->pump_file_transfer(transfer_id);
+    });
+  }
+
+  /**
+   * @brief Stops sending a transfer; its undelivered chunks resume on the next connection.
+   *
+   * @param transfer_id Outgoing transfer
+   * @param error Why the transfer stopped
+   */
+  auto pause_file_transfer(const std::string &transfer_id, const std::string &error) -> void
+  {
+    auto iter = file_transfers_.find(transfer_id);
+    if (iter == file_transfers_.end()) { return; }
+
+    spdlog::warn("[session_orchestrator] Pausing transfer {}: {}", transfer_id, error);
+    emit_file_transfer_progress(transfer_id, iter->second, error);
+    file_transfers_.erase(iter);
+  }
+
+  /**
+   * @brief Picks up unfinished outgoing transfers, including ones left over from a previous run.
+   */
+  auto resume_file_transfers() -> void
+  {
+    file_transfers_paused_ = false;
+    try {
+      for (auto &transfer : bridge_->pending_file_transfers()) { track_file_transfer(std::move(transfer)); }
+    } catch (const std::exception &e) {
+      spdlog::warn("[session_orchestrator] Cannot load pending file transfers: {}", e.what());
+    }
+
+    std::vector<std::string> transfer_ids;
+    transfer_ids.reserve(file_transfers_.size());
+    for (const auto &entry : file_transfers_) { transfer_ids.push_back(entry.first); }
+    for (const auto &transfer_id : transfer_ids) { pump_file_transfer(transfer_id); }
+  }
+
+  /**
+   * @brief Reports the sending progress of a transfer.
+   *
+   * @param transfer_id Outgoing transfer
+   * @param state Current state of the transfer
+   * @param error Why the transfer paused, empty otherwise
+   */
+  auto emit_file_transfer_progress(const std::string &transfer_id,
+    const file_transfer_state &state,
+    const std::string &error) -> void
+  {
+    emit_presentation_event(core::events::file_transfer_progress{ .transfer_id = transfer_id,
+      .peer = state.peer_rdx,
+      .name = state.name,
+      .chunks_done = state.delivered,
+      .chunk_count = state.chunk_count,
+      .outgoing = true,
+      .complete = state.delivered == state.chunk_count,
+      .path = "",
+      .error = error });
+  }
+
+  /**
+   * @brief Handles a broadcast command by publishing one sender key encrypted event to a group.
+   *
+   * Any sender key distributions still owed to members go out first, so they reach the relay ahead
+   * of the group message they unlock. A member only counts as holding the key once a relay accepts
+   * its distribution; until then every broadcast sends it again.
+   *
+   * @param cmd Broadcast command with group and message content
+   */
+  auto handle(const core::events::broadcast &cmd) -> void
+  {
+    boost::asio::co_spawn(
+      *io_context_,
+      // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+      [self = this->shared_from_this(), cmd]() -> boost::asio::awaitable<void> {
+        std::optional<group_broadcast_result> result;
+        try {
+          result = self->handler_.handle(cmd);
+        } catch (const std::exception &e) {
+          spdlog::error("[session_orchestrator] Cannot broadcast to group {}: {}", cmd.group, e.what());
+          self->emit_presentation_event(
+            core::events::message_sent{ .peer = cmd.group, .event_id = "", .accepted = false });
+          co_return;
+        }
+
+        std::tie(result->event_id, result->bytes) =
+          co_await self->with_proof_of_work({ std::move(result->event_id), std::move(result->bytes) });
+
+        for (auto &distribution : result->distribution_frames) {
+          std::tie(distribution.event_id, distribution.bytes) =
+            co_await self->with_proof_of_work({ std::move(distribution.event_id), std::move(distribution.bytes) });
+          self->track_sender_key_delivery(cmd.group, std::move(distribution.recipient), distribution.event_id);
+          self->emit_transport_event(core::events::transport::send{
+            .message_id = core::uuid_generator::generate(), .bytes = std::move(distribution.bytes) });
+        }
+        self->emit_transport_event(core::events::transport::send{
+          .message_id = core::uuid_generator::generate(), .bytes = std::move(result->bytes) });
+
+        try {
+          auto ok_response =
+            co_await self->template await_relay<nostr::protocol::ok>(result->event_id, relay_latency::ok);
+          self->emit_presentation_event(core::events::message_sent{
+            .peer = cmd.group, .event_id = result->event_id, .accepted = ok_response.accepted });
+        } catch (const std::exception &) {
+          self->emit_presentation_event(
+            core::events::message_sent{ .peer = cmd.group, .event_id = "", .accepted = false });
+        }
+      },
+      boost::asio::detached);
+  }
+
+  /**
+   * @brief Marks a member as holding this node's sender key once a relay accepts the distribution.
+   *
+   * @param group Group the distribution belongs to
+   * @param member_rdx RDX fingerprint of the member
+   * @param event_id Event ID of the distribution
+   */
+  auto track_sender_key_delivery(std::string group, std::string member_rdx, std::string event_id) -> void
+  {
+    boost::asio::co_spawn(
+      *io_context_,
+      // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+      [self = this->shared_from_this(),
+        group = std::move(group),
+        member_rdx = std::move(member_rdx),
+        event_id = std::move(event_id)]() -> boost::asio::awaitable<void> {
+        try {
+          auto ok_response = co_await self->template await_relay<nostr::protocol::ok>(event_id, relay_latency::ok);
+          if (ok_response.accepted) {
+            self->bridge_->mark_sender_key_delivered(group, member_rdx);
+            co_return;
+          }
+          spdlog::warn("[session_orchestrator] Relay refused sender key for {} in {}: {}",
+            member_rdx,
+            group,
+            ok_response.message);
+        } catch (const std::exception &e) {
+          spdlog::warn("[session_orchestrator] Sender key for {} in {} not confirmed: {}", member_rdx, group, e.what());
+        }
+      },
+      boost::asio::detached);
+  }
+
+  /**
+   * @brief Handles a create group command and subscribes to the new group's messages.
+   *
+   * @param cmd Create group command with name and members
+   */
+  auto handle(const core::events::create_group &cmd) -> void
+  {
+    try {
+      auto created = handler_.handle(cmd);
+      subscribe_to_group(created.group_id);
+      emit_presentation_event(std::move(created));
+    } catch (const std::exception &e) {
+      spdlog::error("[session_orchestrator] Cannot create group {}: {}", cmd.name, e.what());
+    }
+  }
+
+  /**
+   * @brief Re-sends the messages subscription if a group is not covered by it yet.
+   *
+   * @param group_id Sender key distribution ID of the group
+   */
+  auto subscribe_to_group(const std::string &group_id) -> void
+  {
+    if (not subscribed_group_ids_.insert(group_id).second) { return; }
+    if (subscriptions_.contains("messages")) { handle(core::events::subscribe_messages{}); }
+  }
+
+  /**
+   * @brief Handles a publish identity command by generating and publishing a bundle.
+   *
+   * @param cmd Publish identity command
+   */
+  auto handle(const core::events::publish_identity &cmd) -> void
+  {
+    boost::asio::co_spawn(
+      *io_context_,
+      // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+      [self = this->shared_from_this(), cmd]() -> boost::asio::awaitable<void> {
+        auto result = self->handler_.handle(cmd);
+        std::tie(result.event_id, result.bytes) =
+          co_await self->with_bundle_proof_of_work({ std::move(result.event_id), std::move(result.bytes) });
+
+        core::events::transport::send transport_cmd{ .message_id = core::uuid_generator::generate(),
+          .bytes = std::move(result.bytes) };
+        self->emit_transport_event(transport_cmd);
+
+        try {
+          auto ok_response =
+            co_await self->template await_relay<nostr::protocol::ok>(result.event_id, relay_latency::ok);
+          if (ok_response.accepted) {
+            self->bridge_->record_published_bundle(
+              result.pre_key_id, result.signed_pre_key_id, result.kyber_pre_key_id);
+          }
+          self->emit_presentation_event(
+            core::events::bundle_published{ .event_id = result.event_id, .accepted = ok_response.accepted });
+        } catch (const std::exception &e) {
+          spdlog::warn("[session_orchestrator] OK timeout for event: {} - {}", result.event_id, e.what());
+          self->emit_presentation_event(core::events::bundle_published{ .event_id = "", .accepted = false });
+        }
+      },
+      boost::asio::detached);
+  }
+
+  /**
+   * @brief Handles an unpublish identity command by publishing an empty bundle.
+   *
+   * @param cmd Unpublish identity command
+   */
+  auto handle(const core::events::unpublish_identity &cmd) -> void
+  {
+    boost::asio::co_spawn(
+      *io_context_,
+      // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+      [self = this->shared_from_this(), cmd]() -> boost::asio::awaitable<void> {
+        auto [event_id, bytes] = co_await self->with_proof_of_work(self->handler_.handle(cmd));
+
+        core::events::transport::send transport_cmd{ .message_id = core::uuid_generator::generate(),
+          .bytes = std::move(bytes) };
+        self->emit_transport_event(transport_cmd);
+
+        try {
+          auto ok_response = co_await self->template await_relay<nostr::protocol::ok>(event_id, relay_latency::ok);
+          self->emit_presentation_event(
+            core::events::bundle_published{ .event_id = event_id, .accepted = ok_response.accepted });
+        } catch (const std::exception &e) {
+          spdlog::warn("[session_orchestrator] OK timeout for event: {} - {}", event_id, e.what());
+          self->emit_presentation_event(core::events::bundle_published{ .event_id = "", .accepted = false });
+        }
+      },
+      boost::asio::detached);
+  }
+
+  /**
+   * @brief Handles a trust command by establishing session or updating alias.
+   *
+   * The peer may be an RDX fingerprint of a discovered bundle or a Nostr pubkey. Bundles discovered
+   * in earlier runs are read from the identity database, so trusting them needs no relay. A pubkey
+   * with no discovered bundle has its bundle fetched from the relay, and the trust completes when it
+   * arrives.
+   *
+   * @param cmd Trust command with peer identifier and optional alias
+   */
+  auto handle(const core::events::trust &cmd) -> void
+  {
+    bool contact_exists = false;
+    try {
+      std::ignore = bridge_->lookup_contact(cmd.peer);
+      contact_exists = true;
+    } catch (const std::exception &e) {
+      spdlog::debug("Contact {} not found, will check discovered bundles: {}", cmd.peer, e.what());
+    }
+
+    if (contact_exists) {
+      if (not cmd.alias.empty()) {
+        handler_.handle(cmd);
+        spdlog::info("Updated alias for existing contact: {}", cmd.peer);
+      }
+      return;
+    }
+
+    load_bundle_cache();
+    auto trust_cmd = cmd;
+    const auto *bundle = discovered_bundles_.use_by_rdx(cmd.peer);
+    if (bundle == nullptr) {
+      resolve_rdx_fingerprints();
+      bundle = discovered_bundles_.use_by_rdx(cmd.peer);
+    }
+    if (bundle == nullptr and nostr::protocol::is_pubkey_hex(cmd.peer)) {
+      bundle = discovered_bundles_.find_by_pubkey(cmd.peer);
+      if (bundle == nullptr) {
+        spdlog::info("Fetching the bundle of {} from the relay", cmd.peer);
+        pending_trusts_[cmd.peer] = cmd.alias;
+        fetch_bundles({ cmd.peer });
+        return;
+      }
+      trust_cmd.peer = bundle->rdx_fingerprint;
+    }
+
+    const auto bundle_data = bundle != nullptr ? bundle_body(*bundle) : std::string{};
+    if (bundle != nullptr and bundle_data.empty()) {
+      spdlog::error("Cannot establish session with {}: bundle data is neither in memory nor in the identity database",
+        cmd.peer);
+    } else if (bundle != nullptr) {
+      auto session_result = handler_.handle(core::events::establish_session{ .bundle_data = bundle_data });
+      if (session_result and not trust_cmd.alias.empty()) { handler_.handle(trust_cmd); }
+      if (session_result) {
+        emit_presentation_event(*session_result);
+        refresh_contact_bundles();
+      }
+    } else {
+      spdlog::error(
+        "Cannot establish session with {}: identity not found in discovered bundles and no existing contact", cmd.peer);
+    }
+  }
+
+  /**
+   * @brief Handles a subscribe command by sending subscription request to relay.
+   *
+   * The subscription replaces an earlier one with the same ID. The relay sees a generated
+   * subscription ID; the user's ID is reported back once stored events are in.
+   *
+   * @param cmd Subscribe command with JSON filter
+   */
+  auto handle(const core::events::subscribe &cmd) -> void
+  {
+    try {
+      const auto subscription_id = handler_.handle(cmd).first;
+      auto filters = req_filters(cmd.subscription_json);
+      if (not filters) {
+        spdlog::warn("[session_orchestrator] Ignoring subscription {} with unsupported filters", subscription_id);
+        return;
+      }
+      auto name = std::string(user_subscription_prefix) + subscription_id;
+      open_subscription(name, std::move(*filters), subscription_lifetime::persistent);
+    } catch (const std::exception &e) {
+      spdlog::warn("[session_orchestrator] Ignoring malformed subscription request: {}", e.what());
+    }
+  }
+
+  /// Prefix of the subscription names given to user-requested subscriptions
+  static constexpr std::string_view user_subscription_prefix = "subscribe:";
+
+  /**
+   * @brief Reads the filters of a serialized REQ frame.
+   *
+   * @param req_json JSON string in format ["REQ", subscription_id, filters...]
+   * @return Filters, or std::nullopt if the frame is malformed or a filter is unsupported
+   */
+  [[nodiscard]] static auto req_filters(const std::string &req_json)
+    -> std::optional<std::vector<nostr::protocol::filter>>
+  {
+    const auto parsed = nlohmann::json::parse(req_json, nullptr, false);
+    if (parsed.is_discarded() or not parsed.is_array() or parsed.size() < 3) { return std::nullopt; }
+
+    std::vector<nostr::protocol::filter> filters;
+    for (std::size_t index = 2; index < parsed.size(); ++index) {
+      auto req_filter = nostr::protocol::filter::from_json(parsed[index]);
+      if (not req_filter) { return std::nullopt; }
+      filters.push_back(std::move(*req_filter));
+    }
+    return filters;
+  }
+
+  /**
+   * @brief Returns the subscription limit of the connected relay.
+   *
+   * A per-relay override wins over the relay's advertised `max_subscriptions`, which wins over
+   * the configured default.
+   *
+   * @return Relay-side subscriptions kept open at once
+   */
+  [[nodiscard]] auto max_subscriptions() const -> std::size_t
+  {
+    const auto override_iter = relay_max_subscriptions_.find(relay_url_);
+    if (override_iter != relay_max_subscriptions_.end()) { return override_iter->second; }
+    return relay_limits_.max_subscriptions.value_or(max_subscriptions_);
+  }
+
+  /**
+   * @brief Caps a filter limit to the connected relay's advertised `max_limit`.
+   *
+   * @param limit Wanted number of stored events
+   * @return Number of stored events the relay will actually return
+   */
+  [[nodiscard]] auto relay_limit(std::uint32_t limit) const -> std::uint32_t
+  {
+    return std::min(limit, relay_limits_.max_limit.value_or(limit));
+  }
+
+  /**
+   * @brief Opens a named subscription on the relay, replacing any open under the same name.
+   *
+   * @param name Subscription name
+   * @param filters Filters to subscribe with
+   * @param lifetime Whether the subscription is closed once the relay has sent its stored events
+   */
+  auto open_subscription(const std::string &name,
+    std::vector<nostr::protocol::filter> filters,
+    subscription_lifetime lifetime) -> void
+  {
+    apply_subscription_update(subscriptions_.open(name, std::move(filters), lifetime));
+  }
+
+  /**
+   * @brief Sends the CLOSE and REQ frames of a subscription change.
+   *
+   * Waiters on closed subscriptions are released; each REQ gets a waiter for its EOSE.
+   *
+   * @param update Frames decided by the subscription manager
+   */
+  auto apply_subscription_update(subscription_update update) -> void
+  {
+    for (const auto &subscription_id : update.closes) {
+      auto &bytes = nostr::protocol::scratch_buffer();
+      nostr::protocol::write_close_frame(bytes, subscription_id);
+      emit_transport_event(core::events::transport::send{
+        .message_id = core::uuid_generator::generate(), .bytes = { bytes.begin(), bytes.end() } });
+      tracker_->resolve(subscription_id, nostr::protocol::eose{ subscription_id });
+    }
+
+    for (auto &request : update.requests) {
+      auto &bytes = nostr::protocol::scratch_buffer();
+      nostr::protocol::write_req_frame(
+        bytes, request.subscription_id, std::span<const nostr::protocol::filter>(request.filters));
+      if (exceeds_message_length(bytes)) {
+        reject_oversized_req(std::move(request.subscription_id), bytes.size());
+        continue;
+      }
+      emit_transport_event(core::events::transport::send{
+        .message_id = core::uuid_generator::generate(), .bytes = { bytes.begin(), bytes.end() } });
+      await_replay(std::move(request.subscription_id));
+    }
+  }
+
+  /**
+   * @brief Treats a REQ the relay would refuse for its size as closed by the relay.
+   *
+   * The subscription is dropped once the current update has been applied, releasing whatever
+   * waits on it, instead of waiting out the EOSE timeout.
+   *
+   * @param subscription_id Relay-side subscription ID of the unsent REQ
+   * @param size Size of the REQ frame in bytes
+   */
+  auto reject_oversized_req(std::string subscription_id, std::size_t size) -> void
+  {
+    auto reason =
+      fmt::format("invalid: {} bytes exceeds max_message_length {}", size, *relay_limits_.max_message_length);
+    boost::asio::post(*io_context_,
+      [self = this->shared_from_this(), subscription_id = std::move(subscription_id), reason = std::move(reason)]() {
+        self->handle_relay_closed(nostr::protocol::closed{ .subscription_id = subscription_id, .message = reason });
+      });
+  }
+
+  /**
+   * @brief Waits for the relay's answer to a request and records how long it took.
+   *
+   * Unless a timeout is given, it adapts to the latencies measured on the connected relay.
+   * Answers and timeouts are both recorded against the relay the request went to, except OKs
+   * refused before the event was ever sent.
+   *
+   * @tparam ResponseType Answer to wait for (ok or eose)
+   * @param request_id Event ID or subscription ID
+   * @param kind Latency the wait measures
+   * @param timeout Fixed timeout replacing the adapted one
+   * @return The relay's answer
+   * @throws std::runtime_error on timeout
+   */
+  template<typename ResponseType>
+  auto await_relay(std::string request_id,
+    relay_latency kind,
+    std::optional<std::chrono::milliseconds> timeout = std::nullopt) -> boost::asio::awaitable<ResponseType>
+  {
+    const auto url = relay_url_;
+    const auto started = std::chrono::steady_clock::now();
+    const auto elapsed = [started]() {
+      return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+    };
+
+    try {
+      auto response =
+        co_await tracker_->template async_track<ResponseType>(request_id, timeout.value_or(health_.timeout(url, kind)));
+      if (refused_locally_.erase(request_id) == 0 and not url.empty()) {
+        health_.record(url, kind, elapsed());
+        publish_relay_stats(url);
+      }
+      co_return response;
+    } catch (const std::runtime_error &) {
+      if (not url.empty()) {
+        health_.record_timeout(url, kind, elapsed());
+        publish_relay_stats(url);
+      }
+      throw;
+    }
+  }
+
+  /**
+   * @brief Waits for the relay to finish sending the stored events of a subscription.
+   *
+   * A backfill page holds up to a full page of stored events, far more than the replays the
+   * adapted timeout is learned from, so it gets the configured request timeout instead.
+   *
+   * @param subscription_id Relay-side subscription ID
+   */
+  auto await_replay(std::string subscription_id) -> void
+  {
+    std::optional<std::chrono::milliseconds> timeout;
+    if (subscription_id == subscriptions_.subscription_id(std::string(backfill_subscription))) {
+      timeout = backfill_page_timeout_;
+    }
+    boost::asio::co_spawn(
+      *io_context_,
+      // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+      [self = this->shared_from_this(),
+        subscription_id = std::move(subscription_id),
+        timeout]() -> boost::asio::awaitable<void> {
+        bool replayed = true;
+        try {
+          co_await self->template await_relay<nostr::protocol::eose>(subscription_id, relay_latency::eose, timeout);
+        } catch (const std::exception &e) {
+          spdlog::warn("[session_orchestrator] EOSE timeout for subscription: {} - {}", subscription_id, e.what());
+          replayed = false;
+        }
+        self->finish_replay(subscription_id, replayed);
+      },
+      boost::asio::detached);
+  }
+
+  /**
+   * @brief Closes one-shot subscriptions and reports persistent ones once their stored events are in.
+   *
+   * @param subscription_id Relay-side subscription ID
+   * @param replayed Whether the relay sent EOSE before the request timeout
+   */
+  auto finish_replay(const std::string &subscription_id, bool replayed) -> void
+  {
+    for (const auto &finished : subscriptions_.replay_finished(subscription_id)) {
+      if (finished.lifetime == subscription_lifetime::one_shot) {
+        apply_subscription_update(subscriptions_.close(finished.name));
+        finish_bundle_fetch(finished.name);
+        if (finished.name == backfill_subscription) { finish_backfill_page(replayed); }
+        continue;
+      }
+
+      std::string established;
+      if (replayed) {
+        established = finished.name.starts_with(user_subscription_prefix)
+                        ? finished.name.substr(user_subscription_prefix.size())
+                        : subscription_id;
+      }
+      emit_presentation_event(core::events::subscription_established{ established });
+    }
+  }
+
+  /**
+   * @brief Handles a relay closing or refusing one of our subscriptions.
+   *
+   * A refusal over the relay's subscription limit lowers the limit to the number of subscriptions
+   * still open and re-opens what was dropped, which merges it into another subscription. Other
+   * refusals are only logged; a bundle fetch can be retried afterwards.
+   *
+   * @param closed CLOSED message from the relay
+   */
+  auto handle_relay_closed(const nostr::protocol::closed &closed) -> void
+  {
+    auto dropped = subscriptions_.closed_by_relay(closed.subscription_id);
+    tracker_->resolve(closed.subscription_id, nostr::protocol::eose{ closed.subscription_id });
+    if (dropped.empty()) {
+      spdlog::debug("[session_orchestrator] Relay closed unknown subscription {}", closed.subscription_id);
+      return;
+    }
+    spdlog::warn("[session_orchestrator] Relay closed subscription {}: {}", closed.subscription_id, closed.message);
+
+    const bool over_limit =
+      closed.message.starts_with("rate-limited:") or closed.message.find("too many") != std::string::npos;
+    const bool limit_lowered = over_limit and subscriptions_.active_count() < subscriptions_.max_subscriptions();
+    if (limit_lowered) {
+      subscriptions_.set_max_subscriptions(subscriptions_.active_count());
+      spdlog::info("[session_orchestrator] Keeping at most {} subscriptions open on {}",
+        subscriptions_.max_subscriptions(),
+        relay_url_);
+    }
+
+    for (auto &subscription : dropped) {
+      if (limit_lowered) {
+        open_subscription(subscription.name, std::move(subscription.filters), subscription.lifetime);
+      } else if (subscription.lifetime == subscription_lifetime::one_shot) {
+        finish_bundle_fetch(subscription.name);
+        if (subscription.name == backfill_subscription) { finish_backfill_page(false); }
+      }
+    }
+    apply_subscription_update(subscriptions_.open_waiting());
+  }
+
+  /**
+   * @brief Handles a subscribe identities command by subscribing to every bundle announcement on the relay.
+   *
+   * Replay of stored announcements is bounded by the configured discovery window and limit; new
+   * announcements keep arriving for as long as the subscription is open.
+   *
+   * @param cmd Subscribe identities command
+   */
+  auto handle(const core::events::subscribe_identities & /*cmd*/) -> void
+  {
+    const auto now =
+      std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch());
+    auto filter = bundle_filter({});
+    const auto oldest = std::max(now - bundle_discovery_window_, std::chrono::seconds{ 0 });
+    filter.since = static_cast<std::uint64_t>(oldest.count());
+    filter.limit = relay_limit(bundle_discovery_limit_);
+    open_subscription("identities", { std::move(filter) }, subscription_lifetime::persistent);
+  }
+
+  /**
+   * @brief Returns a filter for the bundle announcements of the given authors.
+   *
+   * @param authors Nostr pubkeys to match, empty for every author
+   * @return Bundle announcement filter
+   */
+  [[nodiscard]] static auto bundle_filter(std::vector<std::string> authors) -> nostr::protocol::filter
+  {
+    return nostr::protocol::filter{ .authors = std::move(authors),
+      .kinds = { nostr::protocol::kind::bundle_announcement },
+      .tags = { { 'd', { "radix_prekey_bundle_v1" } } } };
+  }
+
+  /**
+   * @brief Subscribes to bundle updates from known contacts, replacing the previous subscription.
+   *
+   * When a bundle is already known for every contact, only announcements at least as new as the
+   * oldest of them are requested. Sends nothing while there are no contacts.
+   */
+  auto refresh_contact_bundles() -> void
+  {
+    load_bundle_cache();
+    std::vector<std::string> authors;
+    std::optional<std::uint64_t> oldest_known;
+    bool all_known = true;
+    for (const auto &contact : bridge_->list_contacts()) {
+      if (not nostr::protocol::is_pubkey_hex(contact.nostr_pubkey)) { continue; }
+      authors.push_back(contact.nostr_pubkey);
+      if (const auto *known = discovered_bundles_.find_by_pubkey(contact.nostr_pubkey); known == nullptr) {
+        all_known = false;
+      } else {
+        oldest_known = std::min(oldest_known.value_or(known->created_at), known->created_at);
+      }
+    }
+    if (authors.empty()) { return; }
+
+    auto filter = bundle_filter(std::move(authors));
+    if (all_known) { filter.since = oldest_known; }
+    open_subscription("contact_bundles", { std::move(filter) }, subscription_lifetime::persistent);
+  }
+
+  /**
+   * @brief Fetches the current bundles of specific pubkeys once.
+   *
+   * The subscription is closed as soon as the relay has sent its stored events, and waits for a
+   * free slot while the relay's subscription limit is reached. Pubkeys with a fetch already in
+   * flight are skipped.
+   *
+   * @param pubkeys Nostr pubkeys whose bundles to fetch
+   */
+  auto fetch_bundles(std::vector<std::string> pubkeys) -> void
+  {
+    std::erase_if(pubkeys, [this](const std::string &pubkey) { return not bundle_fetches_.insert(pubkey).second; });
+    if (pubkeys.empty()) { return; }
+
+    auto name = "bundle_fetch:" + core::uuid_generator::generate();
+    bundle_fetch_batches_.emplace(name, pubkeys);
+    open_subscription(name, { bundle_filter(std::move(pubkeys)) }, subscription_lifetime::one_shot);
+  }
+
+  /**
+   * @brief Forgets a finished bundle fetch so its pubkeys can be fetched again.
+   *
+   * @param name Subscription name of the fetch
+   */
+  auto finish_bundle_fetch(const std::string &name) -> void
+  {
+    const auto batch = bundle_fetch_batches_.find(name);
+    if (batch == bundle_fetch_batches_.end()) { return; }
+    for (const auto &pubkey : batch->second) { bundle_fetches_.erase(pubkey); }
+    bundle_fetch_batches_.erase(batch);
+  }
+
+  /**
+   * @brief Fetches the bundle of a sender whose message could not be processed.
+   *
+   * Does nothing if the sender is a contact or its bundle is already known.
+   *
+   * @param pubkey Nostr pubkey of the sender
+   */
+  auto fetch_unknown_sender_bundle(const std::string &pubkey) -> void
+  {
+    load_bundle_cache();
+    if (not nostr::protocol::is_pubkey_hex(pubkey) or discovered_bundles_.find_by_pubkey(pubkey) != nullptr) { return; }
+    try {
+      std::ignore = bridge_->lookup_contact(pubkey);
+      return;
+    } catch (const std::exception &) {
+      spdlog::debug("[session_orchestrator] Message from unknown sender {}, fetching its bundle", pubkey);
+    }
+    fetch_bundles({ pubkey });
+  }
+
+  /**
+   * @brief Handles a bundle announcement received event by storing discovered bundle.
+   *
+   * Announcements older than the bundle already stored for the pubkey, and redeliveries of the
+   * stored announcement, are ignored; an evicted body is read back from the identity database rather
+   * than taken from a redelivery. New bundle data is written there too, with the RDX fingerprint
+   * already worked out for it if the data is unchanged; a re-announcement of the data in memory is
+   * not written again. The RDX fingerprint is only extracted once the identity is listed or trusted.
+   *
+   * @param event Bundle announcement event with pubkey and bundle data
+   */
+  auto handle(const core::events::bundle_announcement_received &event) -> void
+  {
+    load_bundle_cache();
+    sha256_digest previous_hash{};
+    if (const auto *stored = discovered_bundles_.find_by_pubkey(event.pubkey); stored != nullptr) {
+      if (stored->created_at > event.created_at or stored->event_id == event.event_id) { return; }
+      previous_hash = stored->bundle_hash;
+    }
+
+    discovered_bundles_.upsert(discovered_bundle{ .rdx_fingerprint = {},
+      .nostr_pubkey = event.pubkey,
+      .bundle_base64 = event.bundle_content,
+      .event_id = event.event_id,
+      .created_at = event.created_at });
+    if (const auto *stored = discovered_bundles_.find_by_pubkey(event.pubkey);
+        stored != nullptr and stored->bundle_hash != previous_hash) {
+      save_bundle(signal::cached_bundle{ .nostr_pubkey = event.pubkey,
+                    .rdx_fingerprint = stored->rdx_fingerprint,
+                    .event_id = event.event_id,
+                    .created_at = event.created_at },
+        event.bundle_content);
+    }
+
+    if (auto pending = pending_trusts_.extract(event.pubkey)) {
+      handle(core::events::trust{ .peer = event.pubkey, .alias = std::move(pending.mapped()) });
+    }
+  }
+
+  /**
+   * @brief Extracts the RDX fingerprints of discovered bundles that do not have one yet.
+   *
+   * Bundle data evicted from memory is read back from the identity database, and each extracted
+   * fingerprint is saved there so later runs do not extract it again. Bundles that cannot be parsed
+   * are dropped.
+   */
+  auto resolve_rdx_fingerprints() -> void
+  {
+    std::vector<std::pair<signal::cached_bundle, std::string>> unresolved;
+    for (const auto &bundle : discovered_bundles_.bundles()) {
+      if (bundle.rdx_fingerprint.empty()) {
+        unresolved.emplace_back(signal::cached_bundle{ .nostr_pubkey = bundle.nostr_pubkey,
+                                  .rdx_fingerprint = {},
+                                  .event_id = bundle.event_id,
+                                  .created_at = bundle.created_at },
+          bundle.bundle_base64);
+      }
+    }
+
+    for (auto &[bundle, bundle_base64] : unresolved) {
+      try {
+        if (bundle_base64.empty()) { bundle_base64 = bridge_->load_discovered_bundle(bundle.nostr_pubkey); }
+        if (bundle_base64.empty()) { continue; }
+        bundle.rdx_fingerprint = bridge_->extract_rdx_from_bundle_base64(bundle_base64);
+        discovered_bundles_.set_rdx_fingerprint(bundle.nostr_pubkey, bundle.rdx_fingerprint);
+        save_bundle(bundle, bundle_base64);
+      } catch (const std::exception &e) {
+        spdlog::warn("[session_orchestrator] Dropping unreadable bundle from {}: {}", bundle.nostr_pubkey, e.what());
+        forget_bundle(bundle.nostr_pubkey);
+      }
+    }
+  }
+
+  /**
+   * @brief Fills the bundle registry from the identity database on first use.
+   *
+   * Only announcement metadata is read; bundle data stays on disk until a session is established
+   * or a fingerprint is extracted. Bundles already received from a relay are kept as they are.
+   */
+  auto load_bundle_cache() -> void
+  {
+    if (bundle_cache_loaded_) { return; }
+    bundle_cache_loaded_ = true;
+
+    try {
+      for (auto &cached : bridge_->cached_discovered_bundles()) {
+        if (discovered_bundles_.find_by_pubkey(cached.nostr_pubkey) != nullptr) { continue; }
+        discovered_bundles_.upsert(discovered_bundle{ .rdx_fingerprint = std::move(cached.rdx_fingerprint),
+          .nostr_pubkey = std::move(cached.nostr_pubkey),
+          .bundle_base64 = {},
+          .event_id = std::move(cached.event_id),
+          .created_at = cached.created_at });
+      }
+      spdlog::debug("[session_orchestrator] Loaded {} cached bundle(s)", discovered_bundles_.size());
+    } catch (const std::exception &e) {
+      spdlog::warn("[session_orchestrator] Could not load cached bundles: {}", e.what());
+    }
+  }
+
+  /**
+   * @brief Returns the data of a discovered bundle, reading it from the identity database if evicted.
    *
-   * @return Reference to discovered bundles vector
+   * @param bundle Discovered bundle
+   * @return Base64-encoded bundle, or an empty string if it is not available
    */
-  [[nodiscard]] auto get_discovered_bundles() const -> const std::vector<discovered_bundle> &
+  [[nodiscard]] auto bundle_body(const discovered_bundle &bundle) const -> std::string
   {
-    return discovered_bundles_;
+    if (not bundle.bundle_base64.empty()) { return bundle.bundle_base64; }
+    try {
+      return bridge_->load_discovered_bundle(bundle.nostr_pubkey);
+    } catch (const std::exception &e) {
+      spdlog::warn("[session_orchestrator] Could not read cached bundle of {}: {}", bundle.nostr_pubkey, e.what());
+      return {};
+    }
   }
 
-  std::shared_ptr<Bridge> bridge_;
-  nostr::message_handler<Bridge> handler_;
-  std::shared_ptr<Tracker> tracker_;
-  std::chrono::milliseconds request_timeout_;
-  std::shared_ptr<boost::asio::io_context> io_context_;
-  std::shared_ptr<async::async_queue<core::events::session_orchestrator::in_t>> in_queue_;
-  std::shared_ptr<async::async_queue<core::events::transport::in_t>> transport_out_queue_;
-  std::shared_ptr<async::async_queue<core::events::presentation_event_variant_t>> presentation_out_queue_;
-  std::shared_ptr<async::async_queue<core::events::connection_monitor::in_t>> connection_monitor_out_queue_;
-  std::vector<discovered_bundle> discovered_bundles_;
-
   /**
-   * @brief Emits an event to the transport queue.
+   * @brief Writes a discovered bundle to the identity database.
    *
-   * @param evt Event to forward to transport layer
+   * A failed write only costs the bundle after a restart, so it is logged and otherwise ignored.
+   *
+   * @param bundle Announcement metadata
+   * @param bundle_base64 Base64-encoded bundle
    */
-  auto emit_transport_event(core::events::transport::in_t evt) -> void { transport_out_queue_->push(std::move(evt)); }
+  auto save_bundle(const signal::cached_bundle &bundle, const std::string &bundle_base64) -> void
+  {
+    try {
+      bridge_->save_discovered_bundle(bundle, bundle_base64);
+    } catch (const std::exception &e) {
+      spdlog::warn("[session_orchestrator] Could not cache bundle of {}: {}", bundle.nostr_pubkey, e.what());
+    }
+  }
 
   /**
-   * @brief Emits an event to the presentation queue.
+   * @brief Forgets a discovered bundle in memory and in the identity database.
    *
-   * @param evt Event to forward to presentation layer
+   * @param nostr_pubkey Nostr pubkey of the bundle
    */
-  auto emit_presentation_event(core::events::presentation_event_variant_t evt) -> void
+  auto forget_bundle(const std::string &nostr_pubkey) -> void
   {
-    presentation_out_queue_->push(std::move(evt));
+    discovered_bundles_.erase(nostr_pubkey);
+    try {
+      bridge_->forget_discovered_bundle(nostr_pubkey);
+    } catch (const std::exception &e) {
+      spdlog::warn("[session_orchestrator] Could not remove cached bundle of {}: {}", nostr_pubkey, e.what());
+    }
   }
 
   /**
-   * @brief Emits a transport status event for connection monitoring.
+   * @brief Handles a bundle announcement removed event by deleting discovered bundle.
    *
-   * @param evt Event to forward to connection monitor
+   * @param event Bundle removal event with pubkey
    */
-  auto emit_connection_monitor_event(core::events::connection_monitor::in_t evt) -> void
+  auto handle(const core::events::bundle_announcement_removed &event) -> void
   {
-    connection_monitor_out_queue_->push(std::move(evt));
+    load_bundle_cache();
+    forget_bundle(event.pubkey);
   }
 
   /**
-   * @brief Handles a send command by encrypting and publishing a message.
+   * @brief Handles a list identities command by emitting discovered identities.
    *
-   * @param cmd Send command with peer and message content
+   * Includes identities discovered in earlier runs.
+   *
+   * @param cmd List identities command
    */
-  auto handle(const core::events::send &cmd) -> void
+  auto handle(const core::events::list_identities & /*cmd*/) -> void
   {
-    boost::asio::co_spawn(
-      *io_context_,
-      // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
-      [self = this->shared_from_this(), cmd]() -> boost::asio::awaitable<void> {
-        auto [event_id, bytes] = self->handler_.handle(cmd);
-
-        core::events::transport::send transport_cmd{ .message_id = core::uuid_generator::generate(),
-          .bytes = std::move(bytes) };
-        self->emit_transport_event(transport_cmd);
+    load_bundle_cache();
+    resolve_rdx_fingerprints();
 
-        try {
-          auto ok_response =
-            co_await self->tracker_->template async_track<nostr::protocol::ok>(event_id, self->request_timeout_);
-          self->emit_presentation_event(core::events::message_sent{ cmd.peer, event_id, ok_response.accepted });
-        } catch (const std::exception &) {
-          self->emit_presentation_event(
-            core::events::message_sent{ .peer = cmd.peer, .event_id = "", .accepted = false });
-        }
-      },
-      boost::asio::detached);
+    std::vector<core::events::discovered_identity> identities;
+    identities.reserve(discovered_bundles_.size());
+    for (const auto &bundle : discovered_bundles_.bundles()) {
+      if (bundle.rdx_fingerprint.empty()) { continue; }
+      identities.push_back(core::events::discovered_identity{
+        .rdx_fingerprint = bundle.rdx_fingerprint, .nostr_pubkey = bundle.nostr_pubkey, .event_id = bundle.event_id });
+    }
+    emit_presentation_event(core::events::identities_listed{ .identities = std::move(identities) });
   }
 
+  /// Subscription name of the page currently fetched by the message backfill
+  static constexpr std::string_view backfill_subscription = "message_backfill";
+
+  /// Recent messages the live subscription replays itself, covering senders whose clocks run behind
+  static constexpr std::chrono::seconds live_message_window{ std::chrono::minutes(5) };
+
   /**
-   * @brief Handles a publish identity command by generating and publishing a bundle.
+   * @brief Starts fetching stored messages up to the given timestamp, page by page.
    *
-   * @param cmd Publish identity command
+   * While the backfill runs, the persisted message timestamp is held at the oldest point it has to
+   * reach, so an interrupted backfill starts over from there on the next connect. A backfill that
+   * is already running picks up the new filters after the ones it is walking.
+   *
+   * @param filters Message filters, bounded below by the persisted message timestamp
+   * @param until Newest timestamp to fetch
    */
-  auto handle(const core::events::publish_identity &cmd) -> void
+  auto start_backfill(std::vector<nostr::protocol::filter> filters, std::uint64_t until) -> void
   {
-    boost::asio::co_spawn(
-      *io_context_,
-      // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
-      [self = this->shared_from_this(), cmd]() -> boost::asio::awaitable<void> {
-        auto result = self->handler_.handle(cmd);
-
-        core::events::transport::send transport_cmd{ .message_id = core::uuid_generator::generate(),
-          .bytes = std::move(result.bytes) };
-        self->emit_transport_event(transport_cmd);
+    std::erase_if(filters, [until](const nostr::protocol::filter &candidate) {
+      return candidate.since.value_or(0) > until;
+    });
+    if (filters.empty()) { return; }
 
-        try {
-          auto ok_response =
-            co_await self->tracker_->template async_track<nostr::protocol::ok>(result.event_id, self->request_timeout_);
-          if (ok_response.accepted) {
-            self->bridge_->record_published_bundle(
-              result.pre_key_id, result.signed_pre_key_id, result.kyber_pre_key_id);
-          }
-          self->emit_presentation_event(
-            core::events::bundle_published{ .event_id = result.event_id, .accepted = ok_response.accepted });
-        } catch (const std::exception &e) {
-          spdlog::warn("[session_orchestrator] OK timeout for event: {} - {}", result.event_id, e.what());
-          self->emit_presentation_event(core::events::bundle_published{ .event_id = "", .accepted = false });
-        }
-      },
-      boost::asio::detached);
+    if (backfill_) {
+      backfill_->add_filters(filters);
+    } else {
+      backfill_.emplace(std::move(filters), until, relay_limit(backfill_page_size_));
+      request_backfill_page();
+    }
+    handler_.set_message_timestamp_ceiling(backfill_->since());
   }
 
   /**
-   * @brief Handles an unpublish identity command by publishing an empty bundle.
-   *
-   * @param cmd Unpublish identity command
+   * @brief Opens the one-shot subscription for the next backfill page.
    */
-  auto handle(const core::events::unpublish_identity &cmd) -> void
+  auto request_backfill_page() -> void
   {
-    boost::asio::co_spawn(
-      *io_context_,
-      // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
-      [self = this->shared_from_this(), cmd]() -> boost::asio::awaitable<void> {
-        auto [event_id, bytes] = self->handler_.handle(cmd);
-
-        core::events::transport::send transport_cmd{ .message_id = core::uuid_generator::generate(),
-          .bytes = std::move(bytes) };
-        self->emit_transport_event(transport_cmd);
-
-        try {
-          auto ok_response =
-            co_await self->tracker_->template async_track<nostr::protocol::ok>(event_id, self->request_timeout_);
-          self->emit_presentation_event(
-            core::events::bundle_published{ .event_id = event_id, .accepted = ok_response.accepted });
-        } catch (const std::exception &e) {
-          spdlog::warn("[session_orchestrator] OK timeout for event: {} - {}", event_id, e.what());
-          self->emit_presentation_event(core::events::bundle_published{ .event_id = "", .accepted = false });
-        }
-      },
-      boost::asio::detached);
+    open_subscription(
+      std::string(backfill_subscription), { backfill_->page_filter() }, subscription_lifetime::one_shot);
   }
 
   /**
-   * @brief Handles a trust command by establishing session or updating alias.
+   * @brief Counts an event delivered on the backfill page.
    *
-   * @param cmd Trust command with peer identifier and optional alias
+   * @param subscription_id Relay-side subscription ID from the EVENT message
+   * @param event Event object from the EVENT message
+   * @return false if the event repeats one the previous page already delivered
    */
-  auto handle(const core::events::trust &cmd) -> void
+  auto record_backfill_event(const std::string &subscription_id, const nlohmann::json &event) -> bool
   {
-    bool contact_exists = false;
-    try {
-      std::ignore = bridge_->lookup_contact(cmd.peer);
-      contact_exists = true;
-    } catch (const std::exception &e) {
-      spdlog::debug("Contact {} not found, will check discovered bundles: {}", cmd.peer, e.what());
+    if (not backfill_ or not event.is_object()
+        or subscription_id != subscriptions_.subscription_id(std::string(backfill_subscription))) {
+      return true;
     }
+    return backfill_->record_event(event.value("id", std::string{}), event.value("created_at", std::uint64_t{ 0 }));
+  }
 
-    if (contact_exists) {
-      if (not cmd.alias.empty()) {
-        handler_.handle(cmd);
-        spdlog::info("Updated alias for existing contact: {}", cmd.peer);
+  /**
+   * @brief Handles the end of a backfill page.
+   *
+   * The next page is requested only once the events of this one have been verified and
+   * decrypted, so at most one page of history is in memory at a time. A page without EOSE is
+   * requested again after a delay that doubles with each try; after too many tries the backfill
+   * stops and resumes on the next connect.
+   *
+   * @param replayed Whether the relay sent EOSE before the request timeout
+   */
+  auto finish_backfill_page(bool replayed) -> void
+  {
+    if (not backfill_) { return; }
+    if (not replayed) {
+      if (++backfill_page_failures_ < backfill_page_attempts_) {
+        retry_backfill_page();
+        return;
       }
+      spdlog::warn("[session_orchestrator] Stopped fetching stored messages after {} pages, resuming on reconnect",
+        backfill_->pages());
+      stop_backfill();
       return;
     }
+    backfill_page_failures_ = 0;
 
-    auto bundle_iter = std::ranges::find_if(
-      discovered_bundles_, [&cmd](const discovered_bundle &bundle) { return bundle.rdx_fingerprint == cmd.peer; });
-
-    if (bundle_iter != discovered_bundles_.end()) {
-      auto session_result =
-        handler_.handle(core::events::establish_session{ .bundle_data = bundle_iter->bundle_base64 });
-      if (session_result and not cmd.alias.empty()) { handler_.handle(cmd); }
-      if (session_result) { emit_presentation_event(*session_result); }
-    } else {
-      spdlog::error(
-        "Cannot establish session with {}: identity not found in discovered bundles and no existing contact", cmd.peer);
+    if (verification_in_progress_ or not pending_events_.empty()) {
+      backfill_draining_ = true;
+      return;
     }
+    advance_backfill();
   }
 
   /**
-   * @brief Handles a subscribe command by sending subscription request to relay.
-   *
-   * @param cmd Subscribe command with JSON filter
+   * @brief Requests the current backfill page again once its retry delay has passed.
    */
-  auto handle(const core::events::subscribe &cmd) -> void
+  auto retry_backfill_page() -> void
   {
-    boost::asio::co_spawn(
-      *io_context_,
-      // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
-      [self = this->shared_from_this(), cmd]() -> boost::asio::awaitable<void> {
-        auto [subscription_id, bytes] = self->handler_.handle(cmd);
-
-        core::events::transport::send transport_cmd{ .message_id = core::uuid_generator::generate(),
-          .bytes = std::move(bytes) };
-        self->emit_transport_event(transport_cmd);
+    auto delay = backfill_retry_delay_;
+    for (std::uint32_t failure = 1; failure < backfill_page_failures_; ++failure) { delay *= 2; }
+    spdlog::debug("[session_orchestrator] No EOSE for backfill page, retrying in {}ms", delay.count());
 
-        try {
-          auto eose = co_await self->tracker_->template async_track<nostr::protocol::eose>(
-            subscription_id, self->request_timeout_);
-          self->emit_presentation_event(core::events::subscription_established{ eose.subscription_id });
-        } catch (const std::exception &e) {
-          spdlog::warn("[session_orchestrator] EOSE timeout for subscription: {} - {}", subscription_id, e.what());
-          self->emit_presentation_event(core::events::subscription_established{ "" });
-        }
-      },
-      boost::asio::detached);
+    backfill_retry_timer_.expires_after(delay);
+    backfill_retry_timer_.async_wait([weak_self = this->weak_from_this()](const boost::system::error_code &error) {
+      if (error) { return; }
+      auto self = weak_self.lock();
+      if (not self or not self->backfill_) { return; }
+      self->backfill_->retry_page();
+      self->request_backfill_page();
+    });
   }
 
   /**
-   * @brief Handles a subscribe identities command by subscribing to bundle announcements.
-   *
-   * @param cmd Subscribe identities command
+   * @brief Abandons the backfill, leaving the persisted message timestamp where it has to resume.
    */
-  auto handle(const core::events::subscribe_identities & /*cmd*/) -> void
+  auto stop_backfill() -> void
   {
-    const auto subscription_id = core::uuid_generator::generate();
-    nostr::protocol::validate_subscription_id(subscription_id);
-
-    const auto kind_value = std::to_string(
-      static_cast<std::underlying_type_t<nostr::protocol::kind>>(nostr::protocol::kind::bundle_announcement));
-    const std::string subscription_json =
-      R"(["REQ",")" + subscription_id + R"(",{"kinds":[)" + kind_value + R"(],"#d":["radix_prekey_bundle_v1"]}])";
-    handle(core::events::subscribe{ .subscription_json = subscription_json });
+    backfill_retry_timer_.cancel();
+    backfill_.reset();
+    backfill_draining_ = false;
+    backfill_page_failures_ = 0;
   }
 
   /**
-   * @brief Handles a bundle announcement received event by storing discovered bundle.
-   *
-   * @param event Bundle announcement event with pubkey and bundle data
+   * @brief Reports backfill progress and requests the next page, or completes the backfill.
    */
-  auto handle(const core::events::bundle_announcement_received &event) -> void
+  auto advance_backfill() -> void
   {
-    auto rdx_fingerprint = bridge_->extract_rdx_from_bundle_base64(event.bundle_content);
+    backfill_draining_ = false;
+    if (not backfill_) { return; }
 
-    auto existing = std::ranges::find_if(
-      discovered_bundles_, [&event](const auto &bundle) { return bundle.nostr_pubkey == event.pubkey; });
-
-    if (existing != discovered_bundles_.end()) {
-      existing->rdx_fingerprint = rdx_fingerprint;
-      existing->bundle_base64 = event.bundle_content;
-      existing->event_id = event.event_id;
-    } else {
-      discovered_bundles_.push_back(discovered_bundle{ .rdx_fingerprint = rdx_fingerprint,
-        .nostr_pubkey = event.pubkey,
-        .bundle_base64 = event.bundle_content,
-        .event_id = event.event_id });
+    const bool more = backfill_->finish_page();
+    emit_presentation_event(core::events::backfill_progress{
+      .pages = backfill_->pages(), .messages = backfill_->messages(), .complete = not more });
+    if (more) {
+      request_backfill_page();
+      return;
     }
-  }
 
-  /**
-   * @brief Handles a bundle announcement removed event by deleting discovered bundle.
-   *
-   * @param event Bundle removal event with pubkey
-   */
-  auto handle(const core::events::bundle_announcement_removed &event) -> void
-  {
-    std::erase_if(discovered_bundles_, [&event](const auto &bundle) { return bundle.nostr_pubkey == event.pubkey; });
+    spdlog::info("[session_orchestrator] Fetched {} stored messages in {} pages on {}",
+      backfill_->messages(),
+      backfill_->pages(),
+      relay_url_);
+    backfill_.reset();
+    handler_.set_message_timestamp_ceiling(std::nullopt);
+    schedule_timestamp_flush();
   }
 
   /**
-   * @brief Handles a list identities command by emitting discovered identities.
+   * @brief Handles a subscribe messages command by subscribing to incoming messages.
    *
-   * @param cmd List identities command
+   * The filter covers every known group, so joining a group re-subscribes. The previous
+   * subscription is closed first rather than left running alongside the new one.
+   *
+   * With paging enabled the live subscription only reaches back a few minutes, and older
+   * messages since the persisted timestamp are fetched by a backfill walking backwards with
+   * `until` and `limit`, so a long absence does not replay everything in one burst.
+   *
+   * @param cmd Subscribe messages command
    */
-  auto handle(const core::events::list_identities & /*cmd*/) -> void
+  auto handle(const core::events::subscribe_messages & /*cmd*/) -> void
   {
-    std::vector<core::events::discovered_identity> identities;
-    identities.reserve(discovered_bundles_.size());
-    std::ranges::transform(discovered_bundles_, std::back_inserter(identities), [](const auto &bundle) {
-      return core::events::discovered_identity{
-        .rdx_fingerprint = bundle.rdx_fingerprint, .nostr_pubkey = bundle.nostr_pubkey, .event_id = bundle.event_id
-      };
-    });
-    emit_presentation_event(core::events::identities_listed{ .identities = std::move(identities) });
+    flush_last_message_timestamp();
+    auto subscription = bridge_->message_subscription();
+    our_pubkey_ = subscription.our_pubkey;
+    auto filters = message_filters(std::move(subscription));
+    if (backfill_page_size_ == 0) {
+      open_subscription("messages", std::move(filters), subscription_lifetime::persistent);
+      return;
+    }
+
+    const auto now =
+      std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch());
+    const auto live_since =
+      static_cast<std::uint64_t>(std::max(now - live_message_window, std::chrono::seconds{ 0 }).count());
+
+    auto live = filters;
+    for (auto &live_filter : live) { live_filter.since = std::max(live_filter.since.value_or(0), live_since); }
+    open_subscription("messages", std::move(live), subscription_lifetime::persistent);
+    start_backfill(std::move(filters), live_since);
   }
 
   /**
-   * @brief Handles a subscribe messages command by subscribing to incoming messages.
+   * @brief Builds the filters of the message subscription.
    *
-   * @param cmd Subscribe messages command
+   * Pairwise events are matched by the `p` tag naming this node, group messages by the `g`
+   * tag of each group it belongs to.
+   *
+   * @param subscription Pubkey, groups and lower bound from the bridge
+   * @return One filter for pairwise events, plus one for group messages if in any group
    */
-  auto handle(const core::events::subscribe_messages & /*cmd*/) -> void
+  [[nodiscard]] static auto message_filters(signal::message_subscription subscription)
+    -> std::vector<nostr::protocol::filter>
   {
-    const auto subscription_id = core::uuid_generator::generate();
-    nostr::protocol::validate_subscription_id(subscription_id);
-
-    auto subscription_json = bridge_->create_subscription_for_self(subscription_id, 0);
-    handle(core::events::subscribe{ .subscription_json = subscription_json });
+    std::vector<nostr::protocol::filter> filters;
+    filters.push_back(nostr::protocol::filter{ .kinds = { nostr::protocol::kind::encrypted_message,
+                                                 nostr::protocol::kind::sender_key_distribution,
+                                                 nostr::protocol::kind::file_chunk },
+      .tags = { { 'p', { std::move(subscription.our_pubkey) } } } });
+    if (not subscription.group_ids.empty()) {
+      filters.push_back(nostr::protocol::filter{ .kinds = { nostr::protocol::kind::group_message },
+        .tags = { { 'g', std::move(subscription.group_ids) } } });
+    }
+    if (subscription.since > 0) {
+      for (auto &message_filter : filters) { message_filter.since = subscription.since; }
+    }
+    return filters;
   }
 
   /**
@@ -441,125 +2339,32 @@ private:
             tracker_->resolve(eose_msg->subscription_id, *eose_msg);
             nostr::events::incoming::eose evt_inner{ *eose_msg };
             handler_.handle(evt_inner);
+            flush_last_message_timestamp();
           } else {
             nostr::events::incoming::unknown_protocol evt_inner{ json_str };
             handler_.handle(evt_inner);
           }
-        } else if (msg_type == "EVENT" and parsed.size() >= 3) {
-          auto event_data = parsed[2];
-          auto kind_value = event_data["kind"].get<std::uint32_t>();
-
-          switch (static_cast<nostr::protocol::kind>(kind_value)) {
-          case nostr::protocol::kind::encrypted_message: {
-            nostr::events::incoming::encrypted_message evt_inner{ nostr::protocol::event_data{ .id = event_data["id"],
-              .pubkey = event_data["pubkey"],
-              .created_at = event_data["created_at"],
-              .kind = event_data["kind"],
-              .tags = event_data["tags"],
-              .content = event_data["content"],
-              .sig = event_data["sig"] } };
-
-            if (auto result = handler_.handle(evt_inner)) {
-              emit_presentation_event(*result);
-              if (result->should_republish_bundle) { handle(core::events::publish_identity{}); }
-            }
-            break;
-          }
-          case nostr::protocol::kind::bundle_announcement: {
-            nostr::events::incoming::bundle_announcement evt_inner{ nostr::protocol::event_data{ .id = event_data["id"],
-              .pubkey = event_data["pubkey"],
-              .created_at = event_data["created_at"],
-              .kind = event_data["kind"],
-              .tags = event_data["tags"],
-              .content = event_data["content"],
-              .sig = event_data["sig"] } };
-
-            if (auto result = handler_.handle(evt_inner)) {
-              std::visit(
-                [this](auto &&inner_evt) {
-                  handle(inner_evt);
-                  emit_presentation_event(inner_evt);
-                },
-                *result);
-            }
-            break;
-          }
-          case nostr::protocol::kind::identity_announcement: {
-            nostr::events::incoming::identity_announcement evt_inner{ nostr::protocol::event_data{
-              .id = event_data["id"],
-              .pubkey = event_data["pubkey"],
-              .created_at = event_data["created_at"],
-              .kind = event_data["kind"],
-              .tags = event_data["tags"],
-              .content = event_data["content"],
-              .sig = event_data["sig"] } };
-
-            handler_.handle(evt_inner);
-            break;
-          }
-          case nostr::protocol::kind::session_request: {
-            nostr::events::incoming::session_request evt_inner{ nostr::protocol::event_data{ .id = event_data["id"],
-              .pubkey = event_data["pubkey"],
-              .created_at = event_data["created_at"],
-              .kind = event_data["kind"],
-              .tags = event_data["tags"],
-              .content = event_data["content"],
-              .sig = event_data["sig"] } };
-
-            handler_.handle(evt_inner);
-            break;
-          }
-          case nostr::protocol::kind::node_status: {
-            nostr::events::incoming::node_status evt_inner{ nostr::protocol::event_data{ .id = event_data["id"],
-              .pubkey = event_data["pubkey"],
-              .created_at = event_data["created_at"],
-              .kind = event_data["kind"],
-              .tags = event_data["tags"],
-              .content = event_data["content"],
-              .sig = event_data["sig"] } };
-
-            handler_.handle(evt_inner);
-            break;
-          }
-          default: {
-            nostr::events::incoming::unknown_message evt_inner{ nostr::protocol::event_data{ .id = event_data["id"],
-              .pubkey = event_data["pubkey"],
-              .created_at = event_data["created_at"],
-              .kind = event_data["kind"],
-              .tags = event_data["tags"],
-              .content = event_data["content"],
-              .sig = event_data["sig"] } };
-
+        } else if (msg_type == "CLOSED") {
+          auto closed_msg = nostr::protocol::closed::deserialize(json_str);
+          if (closed_msg) {
+            handle_relay_closed(*closed_msg);
+          } else {
+            nostr::events::incoming::unknown_protocol evt_inner{ json_str };
             handler_.handle(evt_inner);
-            break;
           }
+        } else if (msg_type == "EVENT" and parsed.size() >= 3) {
+          if (parsed[1].is_string()) {
+            const auto subscription_id = parsed[1].get<std::string>();
+            subscriptions_.record_event(subscription_id);
+            if (not record_backfill_event(subscription_id, parsed[2])) { return; }
           }
+          receive_event(json_str, std::move(parsed[2]));
         } else {
           nostr::events::incoming::unknown_protocol evt_inner{ json_str };
           handler_.handle(evt_inner);
         }
       } catch (const std::exception &e) {
-        std::string error_msg(e.what());
-        if (error_msg.find("old counter") != std::string::npos
-            or error_msg.find("message with old") != std::string::npos) {
-          try {
-            auto parsed = nlohmann::json::parse(json_str);
-            if (parsed.is_array() and parsed.size() >= 3 and parsed[2].contains("pubkey")
-                and parsed[2].contains("id")) {
-              spdlog::debug("[session_orchestrator] Ignored duplicate message from {} (event: {})",
-                parsed[2]["pubkey"].get<std::string>().substr(0, 16),
-                parsed[2]["id"].get<std::string>().substr(0, 16));
-            } else {
-              spdlog::debug("[session_orchestrator] Ignored duplicate message: {}", error_msg);
-            }
-          } catch (...) {
-            spdlog::debug("[session_orchestrator] Ignored duplicate message: {}", error_msg);
-          }
-        } else {
-          spdlog::warn("[session_orchestrator] Failed to parse message: {} - Raw: {}", error_msg, json_str);
-          nostr::events::incoming::unknown_protocol evt_inner{ json_str };
-          handler_.handle(evt_inner);
-        }
+        report_event_error(json_str, e);
       }
     } catch (const std::bad_alloc &e) {
       spdlog::error("[session_orchestrator] Failed to process bytes_received event: {}", e.what());
@@ -569,38 +2374,73 @@ private:
   /**
    * @brief Handles a connect command by forwarding to transport layer.
    *
-   * @param evt Connect event with relay URL
+   * Several space-separated relays are candidates: the healthiest one measured so far is tried
+   * first and the others follow in order of preference while connecting fails.
+   *
+   * @param evt Connect event with one or more relay URLs
    */
   auto handle(const core::events::connect &evt) -> void
   {
-    spdlog::info("[session_orchestrator] Connecting to relay: {}", evt.relay);
-    emit_transport_event(core::events::transport::connect{ .url = evt.relay });
+    std::vector<std::string> candidates;
+    std::string_view relays = evt.relay;
+    while (not relays.empty()) {
+      const auto start = relays.find_first_not_of(' ');
+      if (start == std::string_view::npos) { break; }
+      relays.remove_prefix(start);
+      const auto end = std::min(relays.find(' '), relays.size());
+      candidates.emplace_back(relays.substr(0, end));
+      relays.remove_prefix(end);
+    }
+    if (candidates.empty()) { return; }
+
+    const auto ranked = health_.rank(std::move(candidates));
+    relay_candidates_.assign(std::next(ranked.begin()), ranked.end());
+    connect_to(ranked.front());
+  }
+
+  /**
+   * @brief Asks the transport to connect to one relay.
+   *
+   * @param url Relay URL
+   */
+  auto connect_to(const std::string &url) -> void
+  {
+    spdlog::info("[session_orchestrator] Connecting to relay: {}", url);
+    emit_transport_event(core::events::transport::connect{ .url = url });
   }
 
   /**
-   * @brief Handles transport connected event by performing key maintenance and subscribing.
+   * @brief Handles transport connected event by subscribing and scheduling key maintenance.
+   *
+   * Subscriptions go out first; maintenance runs in the background and only triggers a
+   * bundle republish if it actually rotated keys. The relay's advertised limits apply until
+   * it disconnects.
    *
    * @param evt Connected event from transport
    */
   auto handle(const core::events::transport::connected &evt) -> void
   {
     emit_connection_monitor_event(evt);
-
-    spdlog::info("[session_orchestrator] Transport connected, performing key maintenance");
-    auto maintenance_result = bridge_->perform_key_maintenance();
-
-    if (maintenance_result.signed_pre_key_rotated or maintenance_result.kyber_pre_key_rotated) {
-      spdlog::info("[session_orchestrator] Keys rotated, republishing bundle");
-      handle(core::events::publish_identity{});
+    relay_url_ = evt.url;
+    relay_limits_ = evt.limits;
+    relay_candidates_.clear();
+    if (evt.connect_ms) {
+      health_.record(evt.url, relay_latency::connect, std::chrono::milliseconds(*evt.connect_ms));
+      publish_relay_stats(evt.url);
     }
 
-    spdlog::info("[session_orchestrator] Subscribing to identities and messages");
-    handle(core::events::subscribe_identities{});
+    spdlog::info("[session_orchestrator] Transport connected, subscribing to contact bundles and messages");
+    subscriptions_.reset(max_subscriptions());
+    refresh_contact_bundles();
+    if (discover_all_bundles_) { handle(core::events::subscribe_identities{}); }
     handle(core::events::subscribe_messages{});
+    resume_file_transfers();
+
+    schedule_key_maintenance(std::chrono::milliseconds::zero());
   }
 
   /**
-   * @brief Handles transport connection failure event.
+   * @brief Handles transport connection failure event by trying the next candidate relay.
    *
    * @param evt Connect failed event with error message
    */
@@ -609,9 +2449,33 @@ private:
     emit_connection_monitor_event(evt);
 
     spdlog::error("[session_orchestrator] Transport connect failed: {}", evt.error_message);
-    std::ignore = bridge_;
+    health_.record_connect_failure(evt.url);
+    publish_relay_stats(evt.url);
+    if (not relay_candidates_.empty()) {
+      auto next = std::move(relay_candidates_.front());
+      relay_candidates_.pop_front();
+      connect_to(next);
+    }
+  }
+
+  /**
+   * @brief Records the round trip of a WebSocket ping to the relay.
+   *
+   * @param evt Ping round trip measured by the transport
+   */
+  auto handle(const core::events::transport::ping_measured &evt) -> void
+  {
+    health_.record(evt.url, relay_latency::ping, std::chrono::milliseconds(evt.rtt_ms));
+    publish_relay_stats(evt.url);
   }
 
+  /**
+   * @brief Passes the bytes exchanged with the relay on to the connection monitor.
+   *
+   * @param evt Traffic since the transport's previous report
+   */
+  auto handle(const core::events::transport::traffic_measured &evt) -> void { emit_connection_monitor_event(evt); }
+
   /**
    * @brief Handles transport sent confirmation event.
    *
@@ -646,7 +2510,14 @@ private:
     emit_connection_monitor_event(evt);
 
     spdlog::info("[session_orchestrator] Transport disconnected");
-    std::ignore = bridge_;
+    relay_limits_ = {};
+    subscriptions_.reset(max_subscriptions());
+    bundle_fetches_.clear();
+    bundle_fetch_batches_.clear();
+    stop_backfill();
+    file_transfers_paused_ = true;
+    maintenance_timer_.cancel();
+    flush_last_message_timestamp();
   }
 };
 
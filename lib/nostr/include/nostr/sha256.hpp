@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace radix_relay::nostr {
+
+/// SHA-256 digest bytes
+using sha256_digest = std::array<std::uint8_t, 32>;
+
+/// SHA-256 chaining state: eight 32-bit words
+using sha256_state = std::array<std::uint32_t, 8>;
+
+/// Size of one SHA-256 message block
+inline constexpr std::size_t sha256_block_size = 64;
+
+/// Chaining state before the first block
+inline constexpr sha256_state sha256_initial_state{
+  0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+/**
+ * @brief Block compression implementation.
+ */
+enum class sha256_backend : std::uint8_t {
+  scalar,///< Portable C++
+  sha_ni,///< x86 SHA extensions
+};
+
+/**
+ * @brief Picks the fastest compression implementation this CPU supports.
+ *
+ * @return sha_ni on x86 CPUs with SHA extensions, scalar otherwise
+ */
+[[nodiscard]] auto detected_sha256_backend() -> sha256_backend;
+
+/**
+ * @brief Runs the compression function over whole message blocks.
+ *
+ * Callers hashing many messages that share a prefix compress the prefix once and copy the
+ * resulting state, so only the blocks that differ are hashed per message.
+ *
+ * @param state Chaining state, updated in place
+ * @param blocks Message blocks; the size must be a multiple of sha256_block_size
+ * @param backend Implementation to use; must be supported by this CPU
+ */
+auto sha256_compress(sha256_state &state, std::span<const std::uint8_t> blocks, sha256_backend backend) -> void;
+
+/**
+ * @brief Serializes a final chaining state as digest bytes.
+ *
+ * @param state State after the last padded block
+ * @return Big-endian digest
+ */
+[[nodiscard]] auto sha256_digest_from_state(const sha256_state &state) -> sha256_digest;
+
+/**
+ * @brief Hashes a complete message.
+ *
+ * @param message Message bytes
+ * @param backend Implementation to use; must be supported by this CPU
+ * @return SHA-256 digest
+ */
+[[nodiscard]] auto sha256(std::span<const std::uint8_t> message, sha256_backend backend = detected_sha256_backend())
+  -> sha256_digest;
+
+/**
+ * @brief Formats a digest the way Nostr event IDs are written.
+ *
+ * @param digest Digest bytes
+ * @return 64 lowercase hex characters
+ */
+[[nodiscard]] auto sha256_hex(const sha256_digest &digest) -> std::string;
+
+}// namespace radix_relay::nostr
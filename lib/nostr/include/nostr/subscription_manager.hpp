@@ -0,0 +1,233 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <nostr/protocol.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace radix_relay::nostr {
+
+/**
+ * @brief How long a named subscription stays open on the relay.
+ */
+enum class subscription_lifetime : std::uint8_t {
+  persistent,///< Kept open for live events until replaced or closed
+  one_shot,///< Only wanted for the stored events replayed before EOSE
+};
+
+/**
+ * @brief A REQ frame to send for one relay-side subscription.
+ */
+struct subscription_request
+{
+  std::string subscription_id;///< Relay-side subscription ID
+  std::vector<protocol::filter> filters;///< Merged filters of every subscription it carries
+};
+
+/**
+ * @brief Frames that bring the relay in line with a change to the subscription set.
+ */
+struct subscription_update
+{
+  std::vector<std::string> closes;///< Relay-side subscription IDs to CLOSE, sent before the requests
+  std::vector<subscription_request> requests;///< REQ frames to send
+};
+
+/**
+ * @brief A named subscription that has finished replaying or was closed by the relay.
+ */
+struct subscription_outcome
+{
+  std::string name;///< Name the subscription was opened under
+  subscription_lifetime lifetime{ subscription_lifetime::persistent };///< Lifetime it was opened with
+  std::vector<protocol::filter> filters;///< Filters it was opened with
+  std::uint64_t events{ 0 };///< Events received on its relay-side subscription so far
+};
+
+/**
+ * @brief Tracks the subscriptions open on one relay.
+ *
+ * Callers open subscriptions under a name ("messages", "contact_bundles", ...) and the manager
+ * maps names onto relay-side subscription IDs. Opening a name again replaces its filters, so a
+ * superseded subscription is always closed. Each name gets its own relay-side subscription while
+ * the relay's limit allows; at the limit a persistent name joins the persistent subscription with
+ * the fewest filters, which is re-sent as one REQ, and a one-shot name waits for a free slot.
+ * Relay-side IDs are looked up in constant time as EVENT, EOSE, and CLOSED messages arrive.
+ *
+ * The manager only decides which frames to send; the caller writes them to the relay.
+ */
+class subscription_manager
+{
+public:
+  /// Relay-side subscriptions kept open when the relay does not say otherwise
+  static constexpr std::size_t default_max_subscriptions = 20;
+
+  /**
+   * @brief Constructs a manager with no subscriptions.
+   *
+   * @param max_subscriptions Relay-side subscriptions the relay accepts at once (at least 1)
+   */
+  explicit subscription_manager(std::size_t max_subscriptions = default_max_subscriptions);
+
+  /**
+   * @brief Opens a named subscription, replacing any open under the same name.
+   *
+   * @param name Caller-chosen name
+   * @param filters Filters to subscribe with
+   * @param lifetime Whether the subscription stays open after EOSE
+   * @return Frames to send
+   */
+  auto open(const std::string &name, std::vector<protocol::filter> filters, subscription_lifetime lifetime)
+    -> subscription_update;
+
+  /**
+   * @brief Closes a named subscription and opens waiting ones in the freed slot.
+   *
+   * @param name Name the subscription was opened under
+   * @return Frames to send, empty if the name is not open
+   */
+  auto close(const std::string &name) -> subscription_update;
+
+  /**
+   * @brief Opens waiting subscriptions while the relay has free slots.
+   *
+   * @return Frames to send
+   */
+  auto open_waiting() -> subscription_update;
+
+  /**
+   * @brief Records an EOSE for a relay-side subscription.
+   *
+   * One-shot subscriptions stay open until closed by the caller.
+   *
+   * @param subscription_id Relay-side subscription ID
+   * @return Named subscriptions that were still waiting for their stored events
+   */
+  auto replay_finished(const std::string &subscription_id) -> std::vector<subscription_outcome>;
+
+  /**
+   * @brief Forgets a relay-side subscription the relay has closed.
+   *
+   * @param subscription_id Relay-side subscription ID from the CLOSED message
+   * @return Named subscriptions that were carried by it
+   */
+  auto closed_by_relay(const std::string &subscription_id) -> std::vector<subscription_outcome>;
+
+  /**
+   * @brief Counts an event delivered on a relay-side subscription.
+   *
+   * @param subscription_id Relay-side subscription ID from the EVENT message
+   * @return true if the ID belongs to an open subscription
+   */
+  auto record_event(const std::string &subscription_id) -> bool;
+
+  /**
+   * @brief Drops every subscription, as after a disconnect.
+   *
+   * @param max_subscriptions Limit of the relay connected next
+   */
+  auto reset(std::size_t max_subscriptions) -> void;
+
+  /**
+   * @brief Changes the relay-side subscription limit.
+   *
+   * Open subscriptions are left alone; the new limit applies to later opens.
+   *
+   * @param max_subscriptions Relay-side subscriptions the relay accepts at once (at least 1)
+   */
+  auto set_max_subscriptions(std::size_t max_subscriptions) -> void;
+
+  /**
+   * @brief Checks whether a name is open or waiting for a slot.
+   *
+   * @param name Subscription name
+   * @return true if the name is known
+   */
+  [[nodiscard]] auto contains(const std::string &name) const -> bool { return entries_.contains(name); }
+
+  /**
+   * @brief Returns the relay-side subscription ID a name is carried by.
+   *
+   * @param name Subscription name
+   * @return Relay-side subscription ID, empty if the name is not open or still waiting for a slot
+   */
+  [[nodiscard]] auto subscription_id(const std::string &name) const -> std::string
+  {
+    const auto item = entries_.find(name);
+    return item != entries_.end() ? item->second.subscription_id : std::string{};
+  }
+
+  /**
+   * @brief Checks whether a relay-side subscription ID is open.
+   *
+   * @param subscription_id Relay-side subscription ID
+   * @return true if open
+   */
+  [[nodiscard]] auto is_active(const std::string &subscription_id) const -> bool
+  {
+    return relay_subscriptions_.contains(subscription_id);
+  }
+
+  /**
+   * @brief Returns the number of open relay-side subscriptions.
+   *
+   * @return Subscription count
+   */
+  [[nodiscard]] auto active_count() const -> std::size_t { return relay_subscriptions_.size(); }
+
+  /**
+   * @brief Returns the number of named subscriptions waiting for a slot.
+   *
+   * @return Waiting count
+   */
+  [[nodiscard]] auto waiting_count() const -> std::size_t { return waiting_.size(); }
+
+  /**
+   * @brief Returns the relay-side subscription limit.
+   *
+   * @return Maximum open subscriptions
+   */
+  [[nodiscard]] auto max_subscriptions() const -> std::size_t { return max_subscriptions_; }
+
+private:
+  struct entry
+  {
+    std::vector<protocol::filter> filters;
+    subscription_lifetime lifetime{ subscription_lifetime::persistent };
+    std::string subscription_id;
+    bool replaying{ true };
+  };
+
+  struct relay_subscription
+  {
+    std::vector<std::string> names;
+    subscription_lifetime lifetime{ subscription_lifetime::persistent };
+    std::uint64_t events{ 0 };
+  };
+
+  auto place(const std::string &name, subscription_update &update) -> void;
+  auto detach(const std::string &name, subscription_update &update) -> void;
+  auto reissue(std::string subscription_id, subscription_update &update) -> void;
+  auto retire(const std::string &subscription_id, subscription_update &update) -> void;
+
+  std::size_t max_subscriptions_;
+  std::unordered_map<std::string, entry> entries_;
+  std::unordered_map<std::string, relay_subscription> relay_subscriptions_;
+  std::deque<std::string> waiting_;
+};
+
+/**
+ * @brief Combines filters that differ only in their authors.
+ *
+ * Filters with the same kinds, tags, and time bounds, no event IDs, and no limit become one
+ * filter with the union of their authors. Duplicate filters are dropped. Order is kept.
+ *
+ * @param filters Filters to combine
+ * @return Equivalent, possibly shorter, list of filters
+ */
+auto merge_filters(std::vector<protocol::filter> filters) -> std::vector<protocol::filter>;
+
+}// namespace radix_relay::nostr
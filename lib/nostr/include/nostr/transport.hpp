@@ -4,13 +4,19 @@
 #include <concepts/transport_stream.hpp>
 #include <core/events.hpp>
 #include <core/uuid_generator.hpp>
+#include <nostr/relay_information.hpp>
 
 #include <boost/asio.hpp>
 #include <boost/asio/experimental/channel_error.hpp>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <memory>
+#include <optional>
 #include <span>
 #include <stdexcept>
 #include <string>
@@ -28,6 +34,16 @@ namespace radix_relay::nostr {
  *
  * Manages WebSocket connection to Nostr relays, handling connection lifecycle,
  * message sending/receiving, and forwarding parsed events to the session orchestrator.
+ *
+ * When the stream can fetch documents, each relay's NIP-11 information document is fetched
+ * once per URL before the first WebSocket upgrade. The advertised limits size the read buffer
+ * and are passed on to the orchestrator in the `connected` event.
+ *
+ * When the stream can ping, the relay is pinged right after connecting and then every ping
+ * interval, and each round trip is reported to the orchestrator for relay health tracking.
+ *
+ * When the stream counts its traffic, the bytes exchanged since the previous report are sent
+ * with every ping and when the connection ends.
  */
 template<concepts::transport_stream WebSocketStream> struct transport
 {
@@ -38,17 +54,21 @@ template<concepts::transport_stream WebSocketStream> struct transport
    * @param io_context Boost.Asio io_context for async operations
    * @param in_queue Queue for incoming transport commands
    * @param to_session_queue Queue for outgoing events to session orchestrator
+   * @param ping_interval Time between latency pings while connected (0: no pings)
    */
   transport(const std::shared_ptr<WebSocketStream> &websocket_stream,
     const std::shared_ptr<boost::asio::io_context> &io_context,
     const std::shared_ptr<async::async_queue<core::events::transport::in_t>> &in_queue,
-    const std::shared_ptr<async::async_queue<core::events::session_orchestrator::in_t>> &to_session_queue)
-    : ws_(websocket_stream), io_context_(io_context), in_queue_(in_queue), to_session_queue_(to_session_queue)
+    const std::shared_ptr<async::async_queue<core::events::session_orchestrator::in_t>> &to_session_queue,
+    std::chrono::milliseconds ping_interval = std::chrono::milliseconds::zero())
+    : ws_(websocket_stream), io_context_(io_context), in_queue_(in_queue), to_session_queue_(to_session_queue),
+      ping_interval_(ping_interval), ping_timer_(*io_context)
   {}
 
   ~transport()
   {
     in_queue_->close();
+    ping_timer_.cancel();
     if (connected_) {
       connected_ = false;
       ws_->async_close([](const boost::system::error_code & /*error*/, std::size_t /*bytes*/) {});
@@ -104,9 +124,23 @@ private:
   std::shared_ptr<boost::asio::io_context> io_context_;
   std::shared_ptr<async::async_queue<core::events::transport::in_t>> in_queue_;
   std::shared_ptr<async::async_queue<core::events::session_orchestrator::in_t>> to_session_queue_;
-  static constexpr size_t read_buffer_size = 8192;
-  std::array<std::byte, read_buffer_size> read_buffer_{};
+  static constexpr std::size_t default_read_buffer_size = 128 * 1024;
+  static constexpr std::size_t max_read_buffer_size = 16 * 1024 * 1024;
+  static constexpr std::size_t envelope_allowance = 1024;
+  std::vector<std::byte> read_buffer_ = std::vector<std::byte>(default_read_buffer_size);
+  std::unordered_map<std::string, core::events::transport::relay_limits> relay_limits_;
   std::unordered_map<std::string, std::vector<std::byte>> pending_sends_;
+  struct pending_write
+  {
+    std::string message_id;
+    std::vector<std::vector<std::byte>> frames;
+  };
+  std::deque<pending_write> write_queue_;
+  bool writing_{ false };
+  std::chrono::milliseconds ping_interval_;
+  boost::asio::steady_timer ping_timer_;
+  std::string url_;
+  core::events::transport::traffic_measured reported_traffic_;
 
   std::string host_;
   std::string port_;
@@ -187,7 +221,9 @@ private:
 
       start_read();
     } else {
+      if (connected_) { report_traffic(); }
       connected_ = false;
+      ping_timer_.cancel();
     }
   }
 
@@ -208,14 +244,88 @@ private:
       return;
     }
 
+    if constexpr (concepts::document_fetching_stream<WebSocketStream>) {
+      if (not relay_limits_.contains(evt.url)) {
+        fetch_relay_limits(evt.url);
+        return;
+      }
+    }
+    open_connection(evt.url);
+  }
+
+  /**
+   * @brief Fetches and caches a relay's NIP-11 limits, then opens the connection.
+   *
+   * A relay without a usable information document is cached with empty limits so the
+   * fetch is not repeated on reconnect.
+   *
+   * @param url Relay URL, already split into host, port and path
+   */
+  auto fetch_relay_limits(const std::string &url) -> void
+  {
+    ws_->async_fetch_document({ .host = host_, .port = port_, .path = path_ },
+      relay_information_media_type,
+      [this, url](const boost::system::error_code &error_code, std::string document) {
+        auto limits = error_code ? std::nullopt : parse_relay_limits(document);
+        if (limits) {
+          spdlog::debug("[transport] {} advertises max_message_length={} max_subscriptions={} max_limit={}",
+            url,
+            limits->max_message_length.value_or(0),
+            limits->max_subscriptions.value_or(0),
+            limits->max_limit.value_or(0));
+        } else {
+          spdlog::debug("[transport] No relay information for {}: {}",
+            url,
+            error_code ? error_code.message() : "not a JSON object");
+        }
+        relay_limits_[url] = limits.value_or(core::events::transport::relay_limits{});
+        open_connection(url);
+      });
+  }
+
+  /**
+   * @brief Sizes the read buffer for the largest message the relay accepts.
+   *
+   * Relays bound what clients send, not what they deliver, so the buffer leaves room for the
+   * EVENT envelope around an event of the advertised size.
+   *
+   * @param limits Limits of the relay being connected to
+   */
+  auto size_read_buffer(const core::events::transport::relay_limits &limits) -> void
+  {
+    const auto wanted = limits.max_message_length.value_or(0) + envelope_allowance;
+    read_buffer_.resize(std::clamp(wanted, default_read_buffer_size, max_read_buffer_size));
+  }
+
+  /**
+   * @brief Opens the WebSocket connection to the parsed URL.
+   *
+   * The time from here to the open WebSocket is reported in the `connected` event.
+   *
+   * @param url Relay URL reported in the resulting event
+   */
+  auto open_connection(const std::string &url) -> void
+  {
+    const auto started = std::chrono::steady_clock::now();
     ws_->async_connect({ .host = host_, .port = port_, .path = path_ },
-      [this, url = evt.url](const boost::system::error_code &error_code, std::size_t /*bytes*/) {
+      [this, url, started](const boost::system::error_code &error_code, std::size_t /*bytes*/) {
         if (not error_code) {
+          const auto elapsed =
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+          const auto cached = relay_limits_.find(url);
+          const auto limits =
+            cached != relay_limits_.end() ? cached->second : core::events::transport::relay_limits{};
+          size_read_buffer(limits);
           connected_ = true;
+          url_ = url;
+          reported_traffic_ = {};
           start_read();
           core::events::transport::connected connected_evt{ .url = url,
-            .type = core::events::transport_type::internet };
+            .type = core::events::transport_type::internet,
+            .limits = limits,
+            .connect_ms = static_cast<std::uint64_t>(elapsed.count()) };
           emit_event(std::move(connected_evt));
+          send_ping();
         } else {
           core::events::transport::connect_failed failed{
             .url = url, .error_message = error_code.message(), .type = core::events::transport_type::internet
@@ -226,48 +336,178 @@ private:
   }
 
   /**
-   * @brief Handles a send command by transmitting bytes over WebSocket.
+   * @brief Pings the relay and reports the round trip, then schedules the next ping.
+   *
+   * A failed ping stops the cycle; the read loop notices a dead connection on its own.
+   */
+  auto send_ping() -> void
+  {
+    if constexpr (concepts::pinging_stream<WebSocketStream>) {
+      if (ping_interval_ == std::chrono::milliseconds::zero()) { return; }
+
+      const auto started = std::chrono::steady_clock::now();
+      ws_->async_ping([this, started, url = url_](const boost::system::error_code &error) {
+        if (error) {
+          spdlog::debug("[transport] Ping to {} failed: {}", url, error.message());
+          return;
+        }
+        if (not connected_ or url != url_) { return; }
+
+        const auto rtt =
+          std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+        emit_event(
+          core::events::transport::ping_measured{ .url = url, .rtt_ms = static_cast<std::uint64_t>(rtt.count()) });
+        report_traffic();
+
+        ping_timer_.expires_after(ping_interval_);
+        ping_timer_.async_wait([this](const boost::system::error_code &timer_error) {
+          if (not timer_error and connected_) { send_ping(); }
+        });
+      });
+    }
+  }
+
+  /**
+   * @brief Reports the bytes exchanged with the relay since the previous report.
+   *
+   * Nothing is sent when no bytes moved.
+   */
+  auto report_traffic() -> void
+  {
+    if constexpr (concepts::traffic_counting_stream<WebSocketStream>) {
+      const auto total = ws_->traffic();
+      const auto since = [](std::uint64_t now, std::uint64_t before) { return now >= before ? now - before : now; };
+
+      core::events::transport::traffic_measured delta{ .url = url_,
+        .message_bytes_sent = since(total.message_bytes_sent, reported_traffic_.message_bytes_sent),
+        .message_bytes_received = since(total.message_bytes_received, reported_traffic_.message_bytes_received),
+        .wire_bytes_sent = since(total.wire_bytes_sent, reported_traffic_.wire_bytes_sent),
+        .wire_bytes_received = since(total.wire_bytes_received, reported_traffic_.wire_bytes_received) };
+      reported_traffic_ = { .url = url_,
+        .message_bytes_sent = total.message_bytes_sent,
+        .message_bytes_received = total.message_bytes_received,
+        .wire_bytes_sent = total.wire_bytes_sent,
+        .wire_bytes_received = total.wire_bytes_received };
+
+      if (delta.message_bytes_sent != 0 or delta.message_bytes_received != 0 or delta.wire_bytes_sent != 0
+          or delta.wire_bytes_received != 0) {
+        emit_event(std::move(delta));
+      }
+    }
+  }
+
+  /**
+   * @brief Handles a send command by queueing its bytes for the WebSocket.
    *
    * @param evt Send event with message ID and data bytes
    */
   auto handle(const core::events::transport::send &evt) noexcept -> void
   {
-    if (not connected_) {
-      core::events::transport::send_failed failed{
-        .message_id = evt.message_id, .error_message = "Not connected", .type = core::events::transport_type::internet
-      };
-      emit_event(std::move(failed));
-      return;
+    try {
+      enqueue_write(evt.message_id, { evt.bytes });
+    } catch (const std::bad_alloc &e) {
+      fail_write(evt.message_id, e.what());
     }
+  }
 
-    std::shared_ptr<std::vector<std::byte>> data;
+  /**
+   * @brief Handles a batch send by queueing its frames for the WebSocket.
+   *
+   * Each frame is still its own WebSocket message, as Nostr relays expect, but the batch is
+   * one queue item and one completion event for the orchestrator.
+   *
+   * @param evt Batch event with message ID and frames
+   */
+  auto handle(const core::events::transport::send_batch &evt) noexcept -> void
+  {
     try {
-      data = std::make_shared<std::vector<std::byte>>(evt.bytes);
+      enqueue_write(evt.message_id, evt.frames);
     } catch (const std::bad_alloc &e) {
-      core::events::transport::send_failed failed{
-        .message_id = evt.message_id, .error_message = e.what(), .type = core::events::transport_type::internet
-      };
-      emit_event(std::move(failed));
+      fail_write(evt.message_id, e.what());
+    }
+  }
+
+  /**
+   * @brief Queues frames to be written as one unit, after every write queued before them.
+   *
+   * The stream allows one write at a time, so sends and batches share this queue and only its
+   * front is ever being written.
+   *
+   * @param message_id Identifier reported when the frames are written or fail
+   * @param frames Frames to write in order
+   */
+  auto enqueue_write(std::string message_id, std::vector<std::vector<std::byte>> frames) -> void
+  {
+    if (not connected_) {
+      fail_write(message_id, "Not connected");
       return;
     }
 
-    auto message_id = evt.message_id;
+    write_queue_.push_back({ .message_id = std::move(message_id), .frames = std::move(frames) });
+    if (not writing_) { write_next(0); }
+  }
 
-    ws_->async_write(std::span<const std::byte>(*data),
-      [this, data, message_id](const boost::system::error_code &error, std::size_t bytes_transferred) {
-        if (error) {
-          spdlog::error("[transport] Write failed: {} (attempted {} bytes)", error.message(), data->size());
-          core::events::transport::send_failed failed{
-            .message_id = message_id, .error_message = error.message(), .type = core::events::transport_type::internet
-          };
-          emit_event(std::move(failed));
-        } else {
-          spdlog::trace("[transport] Wrote {} bytes", bytes_transferred);
-          core::events::transport::sent sent_evt{ .message_id = message_id,
-            .type = core::events::transport_type::internet };
-          emit_event(std::move(sent_evt));
-        }
-      });
+  /**
+   * @brief Writes one frame of the queued write at the front and chains the next on completion.
+   *
+   * Once the front write is done or has failed, it is reported and the next queued write starts.
+   *
+   * @param index Frame of the front write to write
+   */
+  auto write_next(std::size_t index) -> void
+  {
+    if (write_queue_.empty()) {
+      writing_ = false;
+      return;
+    }
+    writing_ = true;
+
+    auto &front = write_queue_.front();
+    if (not connected_) {
+      auto message_id = std::move(front.message_id);
+      write_queue_.pop_front();
+      fail_write(message_id, "Not connected");
+      write_next(0);
+      return;
+    }
+    if (index == front.frames.size()) {
+      core::events::transport::sent sent_evt{ .message_id = std::move(front.message_id),
+        .type = core::events::transport_type::internet };
+      write_queue_.pop_front();
+      emit_event(std::move(sent_evt));
+      write_next(0);
+      return;
+    }
+
+    // The front entry stays put until this write completes, so the span stays valid
+    const std::span<const std::byte> frame(front.frames[index]);
+    ws_->async_write(frame, [this, index](const boost::system::error_code &error, std::size_t bytes_transferred) {
+      auto &written = write_queue_.front();
+      if (error) {
+        spdlog::error("[transport] Write {}/{} failed: {}", index + 1, written.frames.size(), error.message());
+        auto message_id = std::move(written.message_id);
+        write_queue_.pop_front();
+        fail_write(message_id, error.message());
+        write_next(0);
+        return;
+      }
+      spdlog::trace("[transport] Wrote {} bytes ({}/{})", bytes_transferred, index + 1, written.frames.size());
+      write_next(index + 1);
+    });
+  }
+
+  /**
+   * @brief Reports a send or batch that could not be written.
+   *
+   * @param message_id Identifier of the send or batch
+   * @param error_message Reason for the failure
+   */
+  auto fail_write(const std::string &message_id, const std::string &error_message) -> void
+  {
+    core::events::transport::send_failed failed{
+      .message_id = message_id, .error_message = error_message, .type = core::events::transport_type::internet
+    };
+    emit_event(std::move(failed));
   }
 
   /**
@@ -277,9 +517,11 @@ private:
    */
   auto handle(const core::events::transport::disconnect & /*evt*/) noexcept -> void
   {
+    ping_timer_.cancel();
     if (connected_) {
       connected_ = false;
       ws_->async_close([this](const boost::system::error_code & /*error*/, std::size_t /*bytes*/) {
+        report_traffic();
         core::events::transport::disconnected evt{ .type = core::events::transport_type::internet };
         emit_event(evt);
       });
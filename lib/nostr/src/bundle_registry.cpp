@@ -0,0 +1,133 @@
+#include <nostr/bundle_registry.hpp>
+
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+namespace radix_relay::nostr {
+
+auto bundle_registry::upsert(discovered_bundle bundle) -> bool
+{
+  std::size_t index = bundles_.size();
+  if (not bundle.bundle_base64.empty()) {
+    const auto *bytes = std::bit_cast<const std::uint8_t *>(bundle.bundle_base64.data());
+    bundle.bundle_hash = sha256(std::span(bytes, bundle.bundle_base64.size()));
+  }
+
+  if (const auto existing = pubkey_index_.find(bundle.nostr_pubkey); existing != pubkey_index_.end()) {
+    index = existing->second;
+    auto &stored = bundles_[index];
+    if (bundle.created_at < stored.created_at) { return false; }
+    if (bundle.rdx_fingerprint.empty() and bundle.bundle_hash == stored.bundle_hash) {
+      bundle.rdx_fingerprint = stored.rdx_fingerprint;
+    }
+
+    drop_body(stored.nostr_pubkey);
+    if (const auto rdx_entry = rdx_index_.find(stored.rdx_fingerprint);
+        rdx_entry != rdx_index_.end() and rdx_entry->second == index) {
+      rdx_index_.erase(rdx_entry);
+    }
+    stored = std::move(bundle);
+  } else {
+    pubkey_index_.emplace(bundle.nostr_pubkey, index);
+    bundles_.push_back(std::move(bundle));
+  }
+
+  const auto &stored = bundles_[index];
+  if (not stored.rdx_fingerprint.empty()) { rdx_index_[stored.rdx_fingerprint] = index; }
+  if (not stored.bundle_base64.empty()) {
+    body_bytes_ += stored.bundle_base64.size();
+    body_lru_.push_front(stored.nostr_pubkey);
+    body_lru_position_[stored.nostr_pubkey] = body_lru_.begin();
+  }
+
+  evict_bodies();
+  return true;
+}
+
+auto bundle_registry::set_rdx_fingerprint(const std::string &nostr_pubkey, std::string rdx_fingerprint) -> void
+{
+  const auto existing = pubkey_index_.find(nostr_pubkey);
+  if (existing == pubkey_index_.end()) { return; }
+
+  const auto index = existing->second;
+  auto &stored = bundles_[index];
+  if (const auto rdx_entry = rdx_index_.find(stored.rdx_fingerprint);
+      rdx_entry != rdx_index_.end() and rdx_entry->second == index) {
+    rdx_index_.erase(rdx_entry);
+  }
+  stored.rdx_fingerprint = std::move(rdx_fingerprint);
+  if (not stored.rdx_fingerprint.empty()) { rdx_index_[stored.rdx_fingerprint] = index; }
+}
+
+auto bundle_registry::erase(const std::string &nostr_pubkey) -> bool
+{
+  const auto existing = pubkey_index_.find(nostr_pubkey);
+  if (existing == pubkey_index_.end()) { return false; }
+
+  const auto index = existing->second;
+  const auto last = bundles_.size() - 1;
+  drop_body(nostr_pubkey);
+  if (const auto rdx_entry = rdx_index_.find(bundles_[index].rdx_fingerprint);
+      rdx_entry != rdx_index_.end() and rdx_entry->second == index) {
+    rdx_index_.erase(rdx_entry);
+  }
+  pubkey_index_.erase(existing);
+
+  if (index != last) {
+    bundles_[index] = std::move(bundles_[last]);
+    pubkey_index_[bundles_[index].nostr_pubkey] = index;
+    if (const auto rdx_entry = rdx_index_.find(bundles_[index].rdx_fingerprint);
+        rdx_entry != rdx_index_.end() and rdx_entry->second == last) {
+      rdx_entry->second = index;
+    }
+  }
+  bundles_.pop_back();
+  return true;
+}
+
+auto bundle_registry::find_by_pubkey(const std::string &nostr_pubkey) const -> const discovered_bundle *
+{
+  const auto existing = pubkey_index_.find(nostr_pubkey);
+  return existing != pubkey_index_.end() ? &bundles_[existing->second] : nullptr;
+}
+
+auto bundle_registry::use_by_rdx(const std::string &rdx_fingerprint) -> const discovered_bundle *
+{
+  const auto existing = rdx_index_.find(rdx_fingerprint);
+  if (existing == rdx_index_.end()) { return nullptr; }
+
+  const auto &bundle = bundles_[existing->second];
+  touch_body(bundle.nostr_pubkey);
+  return &bundle;
+}
+
+auto bundle_registry::touch_body(const std::string &nostr_pubkey) -> void
+{
+  const auto position = body_lru_position_.find(nostr_pubkey);
+  if (position != body_lru_position_.end()) { body_lru_.splice(body_lru_.begin(), body_lru_, position->second); }
+}
+
+auto bundle_registry::drop_body(const std::string &nostr_pubkey) -> void
+{
+  const auto position = body_lru_position_.find(nostr_pubkey);
+  if (position == body_lru_position_.end()) { return; }
+
+  auto &body = bundles_[pubkey_index_.at(nostr_pubkey)].bundle_base64;
+  body_bytes_ -= body.size();
+  body.clear();
+  body.shrink_to_fit();
+  body_lru_.erase(position->second);
+  body_lru_position_.erase(position);
+}
+
+auto bundle_registry::evict_bodies() -> void
+{
+  while (body_bytes_ > max_body_bytes_ and body_lru_.size() > 1) {
+    const auto least_recent = body_lru_.back();
+    drop_body(least_recent);
+  }
+}
+
+}// namespace radix_relay::nostr
@@ -0,0 +1,175 @@
+#include <nostr/content_encoding.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+
+namespace radix_relay::nostr::protocol {
+
+namespace {
+  constexpr std::uint8_t invalid_symbol = 0xFF;
+  constexpr std::size_t table_size = std::numeric_limits<std::uint8_t>::max() + 1;
+  using decode_table = std::array<std::uint8_t, table_size>;
+
+  constexpr auto make_hex_table() -> decode_table
+  {
+    decode_table table{};
+    table.fill(invalid_symbol);
+    constexpr std::uint8_t decimal_digits = 10;
+    for (std::uint8_t digit = 0; digit < decimal_digits; ++digit) {
+      table.at(static_cast<std::size_t>('0' + digit)) = digit;
+    }
+    constexpr std::uint8_t letter_digits = 6;
+    for (std::uint8_t letter = 0; letter < letter_digits; ++letter) {
+      table.at(static_cast<std::size_t>('a' + letter)) = decimal_digits + letter;
+      table.at(static_cast<std::size_t>('A' + letter)) = decimal_digits + letter;
+    }
+    return table;
+  }
+
+  constexpr std::uint8_t base64_plus = 62;
+  constexpr std::uint8_t base64_slash = 63;
+
+  constexpr auto make_base64_table() -> decode_table
+  {
+    decode_table table{};
+    table.fill(invalid_symbol);
+    constexpr std::string_view alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    for (std::size_t index = 0; index < alphabet.size(); ++index) {
+      table.at(static_cast<unsigned char>(alphabet[index])) = static_cast<std::uint8_t>(index);
+    }
+    table.at(static_cast<unsigned char>('-')) = base64_plus;
+    table.at(static_cast<unsigned char>('_')) = base64_slash;
+    return table;
+  }
+
+  constexpr auto hex_table = make_hex_table();
+  constexpr auto base64_table = make_base64_table();
+
+  constexpr auto lookup(const decode_table &table, char symbol) -> std::uint8_t
+  {
+    return table[static_cast<unsigned char>(symbol)];// NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+  }
+
+  constexpr std::uint8_t invalid_bit = 0x80;
+  constexpr unsigned nibble_bits = 4;
+  constexpr unsigned sextet_bits = 6;
+  constexpr unsigned byte_bits = 8;
+  constexpr std::uint32_t byte_mask = 0xFF;
+  constexpr std::size_t base64_quad = 4;
+  constexpr std::size_t base64_triple = 3;
+
+  auto decode_hex(std::string_view text) -> std::optional<std::vector<std::uint8_t>>
+  {
+    if (text.size() % 2 != 0) { return std::nullopt; }
+
+    std::vector<std::uint8_t> bytes(text.size() / 2);
+    std::uint8_t invalid = 0;
+    for (std::size_t index = 0; index < bytes.size(); ++index) {
+      const auto high = lookup(hex_table, text[2 * index]);
+      const auto low = lookup(hex_table, text[(2 * index) + 1]);
+      invalid |= high | low;
+      bytes[index] = static_cast<std::uint8_t>((high << nibble_bits) | low);
+    }
+    if ((invalid & invalid_bit) != 0) { return std::nullopt; }
+    return bytes;
+  }
+
+  auto decode_base64(std::string_view text) -> std::optional<std::vector<std::uint8_t>>
+  {
+    constexpr std::size_t max_padding = 2;
+    if (text.size() % base64_quad == 0) {
+      for (std::size_t padding = 0; padding < max_padding and text.ends_with('='); ++padding) {
+        text.remove_suffix(1);
+      }
+    }
+
+    const auto full_quads = text.size() / base64_quad;
+    const auto remainder = text.size() % base64_quad;
+    if (remainder == 1) { return std::nullopt; }
+
+    std::vector<std::uint8_t> bytes((full_quads * base64_triple) + (remainder == 0 ? 0 : remainder - 1));
+
+    // Invalid symbols map to 0xFF, so OR-ing every lookup and checking once keeps the loop branch-free
+    std::uint8_t invalid = 0;
+    auto *out = bytes.data();
+    for (std::size_t quad = 0; quad < full_quads; ++quad) {
+      const auto *in = text.data() + (quad * base64_quad);
+      const auto first = lookup(base64_table, in[0]);
+      const auto second = lookup(base64_table, in[1]);
+      const auto third = lookup(base64_table, in[2]);
+      const auto fourth = lookup(base64_table, in[3]);
+      invalid |= first | second | third | fourth;
+
+      const auto triple = (std::uint32_t{ first } << (3 * sextet_bits)) | (std::uint32_t{ second } << (2 * sextet_bits))
+                          | (std::uint32_t{ third } << sextet_bits) | std::uint32_t{ fourth };
+      out[0] = static_cast<std::uint8_t>((triple >> (2 * byte_bits)) & byte_mask);
+      out[1] = static_cast<std::uint8_t>((triple >> byte_bits) & byte_mask);
+      out[2] = static_cast<std::uint8_t>(triple & byte_mask);
+      out += base64_triple;
+    }
+
+    if (remainder != 0) {
+      std::uint32_t tail = 0;
+      for (std::size_t index = 0; index < remainder; ++index) {
+        const auto symbol = lookup(base64_table, text[(full_quads * base64_quad) + index]);
+        invalid |= symbol;
+        tail |= std::uint32_t{ symbol } << ((3 - index) * sextet_bits);
+      }
+      for (std::size_t index = 0; index + 1 < remainder; ++index) {
+        out[index] = static_cast<std::uint8_t>((tail >> ((2 - index) * byte_bits)) & byte_mask);
+      }
+    }
+
+    if ((invalid & invalid_bit) != 0) { return std::nullopt; }
+    return bytes;
+  }
+}// namespace
+
+auto content_encoding_from_tags(const std::vector<std::vector<std::string>> &tags) -> content_encoding
+{
+  const auto marked = std::ranges::any_of(tags, [](const auto &tag) {
+    return tag.size() >= 3 and tag[0] == "radix_version" and tag[2] == base64_content_encoding;
+  });
+  return marked ? content_encoding::base64 : content_encoding::hex;
+}
+
+auto accepts_base64_content(const std::vector<std::vector<std::string>> &tags) -> bool
+{
+  if (content_encoding_from_tags(tags) == content_encoding::base64) { return true; }
+  return std::ranges::any_of(tags, [](const auto &tag) {
+    return not tag.empty() and tag[0] == content_encoding_tag
+           and std::ranges::find(std::next(tag.begin()), tag.end(), base64_content_encoding) != tag.end();
+  });
+}
+
+auto accepts_zstd_compression(const std::vector<std::vector<std::string>> &tags) -> bool
+{
+  return std::ranges::any_of(tags, [](const auto &tag) {
+    return not tag.empty() and tag[0] == compression_tag
+           and std::ranges::find(std::next(tag.begin()), tag.end(), zstd_compression) != tag.end();
+  });
+}
+
+auto group_id_from_tags(const std::vector<std::vector<std::string>> &tags) -> std::optional<std::string>
+{
+  const auto group =
+    std::ranges::find_if(tags, [](const auto &tag) { return tag.size() >= 2 and tag[0] == group_tag; });
+  if (group == tags.end()) { return std::nullopt; }
+  return (*group)[1];
+}
+
+auto decode_content(std::string_view content, content_encoding encoding) -> std::optional<std::vector<std::uint8_t>>
+{
+  switch (encoding) {
+  case content_encoding::base64:
+    return decode_base64(content);
+  case content_encoding::hex:
+    return decode_hex(content);
+  }
+  return std::nullopt;
+}
+
+}// namespace radix_relay::nostr::protocol
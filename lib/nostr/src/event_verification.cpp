@@ -0,0 +1,51 @@
+#include <nostr/event_verification.hpp>
+
+#include <bit>
+#include <cstdint>
+#include <nostr/sha256.hpp>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace radix_relay::nostr {
+
+auto compute_event_id(const nlohmann::json &event) -> std::string
+{
+  const auto fields = nlohmann::json::array({ 0,
+    event.at("pubkey").get<std::string>(),
+    event.at("created_at").get<std::uint64_t>(),
+    event.at("kind").get<std::uint32_t>(),
+    event.at("tags").get<std::vector<std::vector<std::string>>>(),
+    event.at("content").get<std::string>() });
+  const auto serialized = fields.dump();
+  const auto *bytes = std::bit_cast<const std::uint8_t *>(serialized.data());
+  return sha256_hex(sha256(std::span(bytes, serialized.size())));
+}
+
+auto verified_event_cache::contains(const nlohmann::json &event) const -> bool
+{
+  try {
+    const auto entry = signatures_.find(event.at("id").get<std::string>());
+    return entry != signatures_.end() and entry->second == event.at("sig").get<std::string>()
+           and compute_event_id(event) == entry->first;
+  } catch (const nlohmann::json::exception &) {
+    return false;
+  }
+}
+
+auto verified_event_cache::insert(const nlohmann::json &event) -> void
+{
+  if (capacity_ == 0) { return; }
+
+  auto event_id = event.at("id").get<std::string>();
+  if (signatures_.contains(event_id)) { return; }
+
+  if (signatures_.size() == capacity_) {
+    signatures_.erase(insertion_order_.front());
+    insertion_order_.pop_front();
+  }
+  signatures_.emplace(event_id, event.at("sig").get<std::string>());
+  insertion_order_.push_back(std::move(event_id));
+}
+
+}// namespace radix_relay::nostr
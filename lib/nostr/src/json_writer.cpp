@@ -0,0 +1,315 @@
+#include <nostr/json_writer.hpp>
+
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace radix_relay::nostr::protocol {
+
+namespace {
+  constexpr auto broadcast(std::uint8_t byte) -> std::uint64_t { return 0x0101010101010101ULL * byte; }
+
+  constexpr std::uint64_t high_bits = broadcast(0x80);
+  constexpr std::uint8_t first_printable = 0x20;
+
+  /// Non-zero if any byte of the word is a control character, a quote, or a backslash
+  constexpr auto escape_mask(std::uint64_t word) -> std::uint64_t
+  {
+    const auto control = (word - broadcast(first_printable)) & ~word;
+    const auto quote = word ^ broadcast('"');
+    const auto backslash = word ^ broadcast('\\');
+    const auto quote_hit = (quote - broadcast(1)) & ~quote;
+    const auto backslash_hit = (backslash - broadcast(1)) & ~backslash;
+    return (control | quote_hit | backslash_hit) & high_bits;
+  }
+
+  constexpr auto needs_escape(char character) -> bool
+  {
+    return static_cast<std::uint8_t>(character) < first_printable or character == '"' or character == '\\';
+  }
+
+  constexpr std::size_t unicode_escape_length = 6;
+
+  auto escape_sequence(char character, std::array<char, unicode_escape_length> &scratch) -> std::string_view
+  {
+    switch (character) {
+    case '"':
+      return R"(\")";
+    case '\\':
+      return R"(\\)";
+    case '\n':
+      return R"(\n)";
+    case '\r':
+      return R"(\r)";
+    case '\t':
+      return R"(\t)";
+    case '\b':
+      return R"(\b)";
+    case '\f':
+      return R"(\f)";
+    default:
+      break;
+    }
+
+    constexpr std::string_view hex_digits = "0123456789abcdef";
+    constexpr unsigned nibble_bits = 4;
+    constexpr unsigned nibble_mask = 0x0F;
+    const auto code = static_cast<std::uint8_t>(character);
+    scratch = { '\\', 'u', '0', '0', hex_digits[code >> nibble_bits], hex_digits[code & nibble_mask] };
+    return { scratch.data(), scratch.size() };
+  }
+
+  constexpr std::size_t frame_overhead = 128;
+  constexpr std::size_t per_tag_overhead = 8;
+  constexpr std::size_t quoted_item_overhead = 3;
+  constexpr std::size_t close_frame_overhead = 16;
+
+  auto estimated_size(const event_data &evt) -> std::size_t
+  {
+    auto size = frame_overhead + evt.id.size() + evt.pubkey.size() + evt.content.size() + evt.sig.size();
+    for (const auto &tag : evt.tags) {
+      size += per_tag_overhead;
+      for (const auto &item : tag) { size += item.size() + quoted_item_overhead; }
+    }
+    return size;
+  }
+
+  auto write_filter(json_writer &writer, const filter &req_filter) -> void
+  {
+    writer.begin_object();
+    if (not req_filter.ids.empty()) {
+      writer.key("ids").begin_array();
+      for (const auto &event_id : req_filter.ids) { writer.value(event_id); }
+      writer.end_array();
+    }
+    if (not req_filter.authors.empty()) {
+      writer.key("authors").begin_array();
+      for (const auto &author : req_filter.authors) { writer.value(author); }
+      writer.end_array();
+    }
+    if (not req_filter.kinds.empty()) {
+      writer.key("kinds").begin_array();
+      for (const auto event_kind : req_filter.kinds) { writer.value(static_cast<std::uint64_t>(event_kind)); }
+      writer.end_array();
+    }
+    for (const auto &[letter, values] : req_filter.tags) {
+      const std::array<char, 2> tag_key{ '#', letter };
+      writer.key({ tag_key.data(), tag_key.size() }).begin_array();
+      for (const auto &tag_value : values) { writer.value(tag_value); }
+      writer.end_array();
+    }
+    if (req_filter.since) { writer.key("since").value(*req_filter.since); }
+    if (req_filter.until) { writer.key("until").value(*req_filter.until); }
+    if (req_filter.limit) { writer.key("limit").value(static_cast<std::uint64_t>(*req_filter.limit)); }
+    writer.end_object();
+  }
+
+  auto write_tags(json_writer &writer, const std::vector<std::vector<std::string>> &tags) -> void
+  {
+    writer.begin_array();
+    for (const auto &tag : tags) {
+      writer.begin_array();
+      for (const auto &item : tag) { writer.value(item); }
+      writer.end_array();
+    }
+    writer.end_array();
+  }
+}// namespace
+
+auto json_writer::begin_array() -> json_writer &
+{
+  open('[');
+  return *this;
+}
+
+auto json_writer::end_array() -> json_writer &
+{
+  close(']');
+  return *this;
+}
+
+auto json_writer::begin_object() -> json_writer &
+{
+  open('{');
+  return *this;
+}
+
+auto json_writer::end_object() -> json_writer &
+{
+  close('}');
+  return *this;
+}
+
+auto json_writer::key(std::string_view name) -> json_writer &
+{
+  begin_value();
+  put_string(name);
+  put(':');
+  after_key_ = true;
+  return *this;
+}
+
+auto json_writer::value(std::string_view text) -> json_writer &
+{
+  begin_value();
+  put_string(text);
+  return *this;
+}
+
+auto json_writer::value(std::uint64_t number) -> json_writer &
+{
+  begin_value();
+  std::array<char, std::numeric_limits<std::uint64_t>::digits10 + 1> digits{};
+  const auto result = std::to_chars(digits.data(), digits.data() + digits.size(), number);
+  put({ digits.data(), static_cast<std::size_t>(result.ptr - digits.data()) });
+  return *this;
+}
+
+auto json_writer::raw(std::string_view json) -> json_writer &
+{
+  begin_value();
+  put(json);
+  return *this;
+}
+
+auto json_writer::unescaped_prefix_length(std::string_view text) -> std::size_t
+{
+  std::size_t offset = 0;
+  for (; offset + sizeof(std::uint64_t) <= text.size(); offset += sizeof(std::uint64_t)) {
+    std::uint64_t word{};
+    std::memcpy(&word, text.data() + offset, sizeof(word));
+    if (escape_mask(word) != 0) { break; }
+  }
+  while (offset < text.size() and not needs_escape(text[offset])) { ++offset; }
+  return offset;
+}
+
+auto json_writer::begin_value() -> void
+{
+  if (after_key_) {
+    after_key_ = false;
+    return;
+  }
+  if (depth_ > 0) {
+    if (has_members_.at(depth_ - 1)) { put(','); }
+    has_members_.at(depth_ - 1) = true;
+  }
+}
+
+auto json_writer::open(char bracket) -> void
+{
+  if (depth_ == max_depth) { throw std::length_error("JSON nesting exceeds maximum depth"); }
+  begin_value();
+  has_members_.at(depth_) = false;
+  ++depth_;
+  put(bracket);
+}
+
+auto json_writer::close(char bracket) -> void
+{
+  if (depth_ == 0) { throw std::logic_error("Unbalanced JSON close"); }
+  --depth_;
+  put(bracket);
+}
+
+auto json_writer::put(char character) -> void { out_->push_back(static_cast<std::byte>(character)); }
+
+auto json_writer::put(std::string_view text) -> void
+{
+  if (text.empty()) { return; }
+  const auto offset = out_->size();
+  out_->resize(offset + text.size());
+  std::memcpy(out_->data() + offset, text.data(), text.size());
+}
+
+auto json_writer::put_string(std::string_view text) -> void
+{
+  put('"');
+  std::array<char, unicode_escape_length> scratch{};
+  while (not text.empty()) {
+    const auto clean = unescaped_prefix_length(text);
+    put(text.substr(0, clean));
+    if (clean == text.size()) { break; }
+    put(escape_sequence(text[clean], scratch));
+    text.remove_prefix(clean + 1);
+  }
+  put('"');
+}
+
+auto scratch_buffer() -> std::vector<std::byte> &
+{
+  thread_local std::vector<std::byte> buffer;
+  if (buffer.capacity() > max_retained_scratch_capacity) { buffer = std::vector<std::byte>(); }
+  buffer.clear();
+  return buffer;
+}
+
+auto write_event_object(json_writer &writer, const event_data &evt) -> void
+{
+  writer.begin_object();
+  writer.key("id").value(evt.id);
+  writer.key("pubkey").value(evt.pubkey);
+  writer.key("created_at").value(evt.created_at);
+  writer.key("kind").value(static_cast<std::uint64_t>(evt.kind));
+  writer.key("tags");
+  write_tags(writer, evt.tags);
+  writer.key("content").value(evt.content);
+  writer.key("sig").value(evt.sig);
+  writer.end_object();
+}
+
+auto write_event_frame(std::vector<std::byte> &out, const event_data &evt) -> void
+{
+  out.reserve(out.size() + estimated_size(evt));
+  json_writer writer(out);
+  writer.begin_array().value("EVENT");
+  write_event_object(writer, evt);
+  writer.end_array();
+}
+
+auto write_req_frame(std::vector<std::byte> &out, std::string_view subscription_id, std::span<const filter> filters)
+  -> void
+{
+  auto size = frame_overhead + subscription_id.size();
+  for (const auto &req_filter : filters) {
+    size += frame_overhead;
+    for (const auto &author : req_filter.authors) { size += author.size() + quoted_item_overhead; }
+    for (const auto &event_id : req_filter.ids) { size += event_id.size() + quoted_item_overhead; }
+  }
+  out.reserve(out.size() + size);
+
+  json_writer writer(out);
+  writer.begin_array().value("REQ").value(subscription_id);
+  for (const auto &req_filter : filters) { write_filter(writer, req_filter); }
+  writer.end_array();
+}
+
+auto write_req_frame(std::vector<std::byte> &out, std::string_view subscription_id, const filter &req_filter)
+  -> void
+{
+  write_req_frame(out, subscription_id, std::span<const filter>{ &req_filter, 1 });
+}
+
+auto write_close_frame(std::vector<std::byte> &out, std::string_view subscription_id) -> void
+{
+  out.reserve(out.size() + subscription_id.size() + close_frame_overhead);
+  json_writer writer(out);
+  writer.begin_array().value("CLOSE").value(subscription_id).end_array();
+}
+
+auto write_event_id_preimage(std::vector<std::byte> &out, const event_data &evt) -> void
+{
+  out.reserve(out.size() + estimated_size(evt));
+  json_writer writer(out);
+  writer.begin_array();
+  writer.value(std::uint64_t{ 0 });
+  writer.value(evt.pubkey);
+  writer.value(evt.created_at);
+  writer.value(static_cast<std::uint64_t>(evt.kind));
+  write_tags(writer, evt.tags);
+  writer.value(evt.content);
+  writer.end_array();
+}
+
+}// namespace radix_relay::nostr::protocol
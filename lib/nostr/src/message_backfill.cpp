@@ -0,0 +1,91 @@
+#include <nostr/message_backfill.hpp>
+
+#include <algorithm>
+#include <ranges>
+#include <utility>
+
+namespace radix_relay::nostr {
+
+message_backfill::message_backfill(std::vector<protocol::filter> filters, std::uint64_t until, std::uint32_t page_size)
+  : filters_(std::move(filters)), start_(until), until_(until), page_size_(std::max<std::uint32_t>(page_size, 1))
+{}
+
+auto message_backfill::page_filter() const -> protocol::filter
+{
+  auto page = filters_.at(current_);
+  page.until = until_;
+  page.limit = page_size_;
+  return page;
+}
+
+auto message_backfill::record_event(const std::string &event_id, std::uint64_t created_at) -> bool
+{
+  // Duplicates still count against the page limit on the relay's side
+  ++page_events_;
+  if (created_at == until_ and boundary_ids_.contains(event_id)) { return false; }
+
+  if (page_oldest_ids_.empty() or created_at < page_oldest_) {
+    page_oldest_ = created_at;
+    page_oldest_ids_.clear();
+  }
+  if (created_at == page_oldest_) { page_oldest_ids_.insert(event_id); }
+  if (not page_ids_.insert(event_id).second) { return false; }
+  ++messages_;
+  return true;
+}
+
+auto message_backfill::finish_page() -> bool
+{
+  ++pages_;
+  const auto since = filters_.at(current_).since.value_or(0);
+
+  if (page_events_ < page_size_) {
+    next_filter();
+  } else if (page_oldest_ < until_) {
+    until_ = page_oldest_;
+    boundary_ids_ = std::move(page_oldest_ids_);
+  } else if (until_ > since) {
+    // More than a page of events share one second; the rest of that second cannot be paged
+    --until_;
+    boundary_ids_.clear();
+  } else {
+    next_filter();
+  }
+
+  page_events_ = 0;
+  page_oldest_ = 0;
+  page_oldest_ids_.clear();
+  page_ids_.clear();
+  return not complete();
+}
+
+auto message_backfill::retry_page() -> void
+{
+  page_events_ = 0;
+  page_oldest_ = 0;
+  page_oldest_ids_.clear();
+}
+
+auto message_backfill::add_filters(const std::vector<protocol::filter> &filters) -> void
+{
+  for (const auto &candidate : filters) {
+    if (std::ranges::find(filters_, candidate) == filters_.end()) { filters_.push_back(candidate); }
+  }
+}
+
+auto message_backfill::since() const -> std::uint64_t
+{
+  if (filters_.empty()) { return 0; }
+  return std::ranges::min(filters_ | std::views::transform([](const protocol::filter &candidate) {
+    return candidate.since.value_or(0);
+  }));
+}
+
+auto message_backfill::next_filter() -> void
+{
+  ++current_;
+  until_ = start_;
+  boundary_ids_.clear();
+}
+
+}// namespace radix_relay::nostr
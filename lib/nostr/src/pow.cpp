@@ -0,0 +1,198 @@
+#include <nostr/pow.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <thread>
+
+namespace radix_relay::nostr::pow {
+
+namespace {
+  // Nonces are "1" + worker number + counter, all fixed width so the blocks before the nonce
+  // never move. The leading 1 keeps the value free of leading zeros.
+  constexpr std::size_t nonce_digits = 20;
+  constexpr std::size_t worker_digits = 4;
+  constexpr std::uint32_t max_workers = 9999;
+  constexpr std::uint64_t attempts_between_stop_checks = 1024;
+  constexpr unsigned word_bits = 32;
+
+  auto state_leading_zero_bits(const sha256_state &state) -> std::uint32_t
+  {
+    std::uint32_t bits = 0;
+    for (const auto word : state) {
+      if (word != 0) { return bits + static_cast<std::uint32_t>(std::countl_zero(word)); }
+      bits += word_bits;
+    }
+    return bits;
+  }
+
+  auto write_decimal(std::span<std::uint8_t> digits, std::uint64_t value) -> void
+  {
+    constexpr std::uint64_t base = 10;
+    for (auto &digit : std::views::reverse(digits)) {
+      digit = static_cast<std::uint8_t>('0' + (value % base));
+      value /= base;
+    }
+  }
+
+  /// Increments a decimal counter in place; false once it wraps around.
+  auto increment_decimal(std::span<std::uint8_t> digits) -> bool
+  {
+    for (auto &digit : std::views::reverse(digits)) {
+      if (digit != '9') {
+        ++digit;
+        return true;
+      }
+      digit = '0';
+    }
+    return false;
+  }
+
+  /// SHA-256 work shared by every worker: the prefix compressed once and the padded remainder.
+  struct prepared_search
+  {
+    sha256_state midstate;
+    std::vector<std::uint8_t> tail;
+    std::size_t nonce_offset;
+  };
+
+  auto prepare_search(const event_template &event, sha256_backend backend) -> prepared_search
+  {
+    constexpr std::size_t length_bytes = 8;
+    constexpr std::uint8_t padding_marker = 0x80;
+    constexpr unsigned byte_bits = 8;
+
+    const auto *prefix_bytes = std::bit_cast<const std::uint8_t *>(event.prefix.data());
+    const auto *suffix_bytes = std::bit_cast<const std::uint8_t *>(event.suffix.data());
+    const auto whole_blocks = event.prefix.size() - (event.prefix.size() % sha256_block_size);
+
+    prepared_search search{ .midstate = sha256_initial_state, .tail = {}, .nonce_offset = 0 };
+    sha256_compress(search.midstate, std::span(prefix_bytes, whole_blocks), backend);
+
+    search.tail.assign(prefix_bytes + whole_blocks, prefix_bytes + event.prefix.size());
+    search.nonce_offset = search.tail.size();
+    search.tail.resize(search.tail.size() + nonce_digits, '0');
+    search.tail.insert(search.tail.end(), suffix_bytes, suffix_bytes + event.suffix.size());
+
+    const auto message_length = event.prefix.size() + nonce_digits + event.suffix.size();
+    search.tail.push_back(padding_marker);
+    while (search.tail.size() % sha256_block_size != sha256_block_size - length_bytes) { search.tail.push_back(0); }
+    const auto bit_length = static_cast<std::uint64_t>(message_length) * byte_bits;
+    for (std::size_t byte = 0; byte < length_bytes; ++byte) {
+      search.tail.push_back(static_cast<std::uint8_t>(bit_length >> (byte_bits * (length_bytes - 1 - byte))));
+    }
+    return search;
+  }
+
+  struct search_outcome
+  {
+    std::mutex mutex;
+    std::optional<mining_result> result;
+    std::atomic<std::uint64_t> hashes{ 0 };
+  };
+
+  auto run_worker(std::uint32_t worker,
+    const prepared_search &search,
+    std::uint32_t target,
+    const mining_options &options,
+    std::stop_source &stop_source,
+    search_outcome &outcome) -> void
+  {
+    auto tail = search.tail;
+    const auto nonce = std::span(tail).subspan(search.nonce_offset, nonce_digits);
+    nonce[0] = '1';
+    write_decimal(nonce.subspan(1, worker_digits), worker);
+    const auto counter = nonce.subspan(1 + worker_digits);
+
+    const auto stop = stop_source.get_token();
+    std::uint64_t attempts = 0;
+    bool exhausted = false;
+    while (not exhausted and not stop.stop_requested()) {
+      for (std::uint64_t batch = 0; batch < attempts_between_stop_checks; ++batch) {
+        auto state = search.midstate;
+        sha256_compress(state, tail, options.backend);
+        ++attempts;
+
+        if (const auto difficulty = state_leading_zero_bits(state); difficulty >= target) {
+          const std::scoped_lock lock(outcome.mutex);
+          if (not outcome.result) {
+            outcome.result = mining_result{ .nonce = std::string(nonce.begin(), nonce.end()),
+              .event_id = sha256_hex(sha256_digest_from_state(state)),
+              .difficulty = difficulty,
+              .hashes = 0 };
+          }
+          stop_source.request_stop();
+          exhausted = true;
+          break;
+        }
+        if (attempts == options.max_hashes_per_thread or not increment_decimal(counter)) {
+          exhausted = true;
+          break;
+        }
+      }
+    }
+    outcome.hashes += attempts;
+  }
+}// namespace
+
+auto leading_zero_bits(const sha256_digest &digest) -> std::uint32_t
+{
+  constexpr std::uint32_t byte_bits = 8;
+  std::uint32_t bits = 0;
+  for (const auto byte : digest) {
+    if (byte != 0) { return bits + static_cast<std::uint32_t>(std::countl_zero(byte)); }
+    bits += byte_bits;
+  }
+  return bits;
+}
+
+auto make_event_template(const std::string &pubkey,
+  std::uint64_t created_at,
+  std::uint32_t kind,
+  const std::vector<std::vector<std::string>> &tags,
+  const std::string &content,
+  std::uint32_t target) -> event_template
+{
+  if (target > max_difficulty) { throw std::invalid_argument("PoW difficulty above " + std::to_string(max_difficulty)); }
+
+  auto head = nlohmann::json::array({ 0, pubkey, created_at, kind }).dump();
+  head.pop_back();
+  auto tag_list = nlohmann::json(tags).dump();
+  tag_list.pop_back();
+
+  return event_template{ .prefix = head + "," + tag_list + (tags.empty() ? "" : ",") + R"([")" + nonce_tag + R"(",")",
+    .suffix = R"(",")" + std::to_string(target) + R"("]],)" + nlohmann::json(content).dump() + "]" };
+}
+
+auto mine(const event_template &event, std::uint32_t target, const mining_options &options, std::stop_token stop)
+  -> std::optional<mining_result>
+{
+  const auto search = prepare_search(event, options.backend);
+  const auto workers =
+    std::min(options.threads != 0 ? options.threads : std::max(1U, std::thread::hardware_concurrency()), max_workers);
+
+  std::stop_source stop_source;
+  const std::stop_callback forward_stop(stop, [&stop_source]() { stop_source.request_stop(); });
+  search_outcome outcome;
+  {
+    std::vector<std::jthread> threads;
+    threads.reserve(workers - 1);
+    for (std::uint32_t worker = 1; worker < workers; ++worker) {
+      threads.emplace_back([worker, &search, target, &options, &stop_source, &outcome]() {
+        run_worker(worker, search, target, options, stop_source, outcome);
+      });
+    }
+    run_worker(0, search, target, options, stop_source, outcome);
+  }
+
+  if (outcome.result) { outcome.result->hashes = outcome.hashes; }
+  return outcome.result;
+}
+
+}// namespace radix_relay::nostr::pow
@@ -1,9 +1,10 @@
 #include "internal_use_only/config.hpp"
+#include <nostr/json_writer.hpp>
 #include <nostr/protocol.hpp>
 
 #include <algorithm>
 #include <bit>
-#include <iterator>
+#include <limits>
 
 namespace radix_relay::nostr::protocol {
 
@@ -62,28 +63,10 @@ auto event_data::deserialize(const std::string &json) -> std::optional<event_dat
 
 auto event_data::serialize() const -> std::vector<std::byte>
 {
-  nlohmann::json json_obj;
-
-  json_obj["id"] = id;
-  json_obj["pubkey"] = pubkey;
-  json_obj["created_at"] = created_at;
-  json_obj["kind"] = kind;
-  json_obj["content"] = content;
-  json_obj["sig"] = sig;
-
-  json_obj["tags"] = nlohmann::json::array();
-  for (const auto &tag : tags) {
-    nlohmann::json tag_json = nlohmann::json::array();
-    std::ranges::copy(tag, std::back_inserter(tag_json));
-    json_obj["tags"].push_back(tag_json);
-  }
-
-  auto json_str = json_obj.dump();
-  std::vector<std::byte> bytes;
-  bytes.resize(json_str.size());
-  std::ranges::transform(
-    json_str, bytes.begin(), [](char character) -> std::byte { return std::bit_cast<std::byte>(character); });
-  return bytes;
+  auto &bytes = scratch_buffer();
+  json_writer writer(bytes);
+  write_event_object(writer, *this);
+  return { bytes.begin(), bytes.end() };
 }
 
 auto event_data::create_identity_announcement(const std::string &sender_pubkey,
@@ -149,6 +132,9 @@ auto event_data::is_radix_message() const -> bool
   case kind::identity_announcement:
   case kind::session_request:
   case kind::node_status:
+  case kind::group_message:
+  case kind::sender_key_distribution:
+  case kind::file_chunk:
   case kind::bundle_announcement:
     return true;
   case kind::profile_metadata:
@@ -177,6 +163,9 @@ auto event_data::get_kind() const -> std::optional<enum kind>
   case kind::identity_announcement:
   case kind::session_request:
   case kind::node_status:
+  case kind::group_message:
+  case kind::sender_key_distribution:
+  case kind::file_chunk:
   case kind::parameterized_replaceable_start:
     return kind;
   }
@@ -222,6 +211,69 @@ auto eose::deserialize(const std::string &json) -> std::optional<eose>
   }
 }
 
+auto closed::deserialize(const std::string &json) -> std::optional<closed>
+{
+  try {
+    auto json_obj = nlohmann::json::parse(json);
+
+    if (not json_obj.is_array() or json_obj.size() < 2) { return std::nullopt; }
+    if (not json_obj[0].is_string() or json_obj[0].get<std::string>() != "CLOSED") { return std::nullopt; }
+    if (not json_obj[1].is_string()) { return std::nullopt; }
+
+    closed result;
+    result.subscription_id = json_obj[1].get<std::string>();
+    if (json_obj.size() > 2 and json_obj[2].is_string()) { result.message = json_obj[2].get<std::string>(); }
+
+    return result;
+  } catch (const std::exception &) {
+    return std::nullopt;
+  }
+}
+
+auto filter::from_json(const nlohmann::json &json) -> std::optional<filter>
+{
+  if (not json.is_object()) { return std::nullopt; }
+
+  const auto read_strings = [](const nlohmann::json &values, std::vector<std::string> &out) -> bool {
+    if (not values.is_array()) { return false; }
+    for (const auto &value : values) {
+      if (not value.is_string()) { return false; }
+      out.push_back(value.get<std::string>());
+    }
+    return true;
+  };
+
+  filter result;
+  for (const auto &[key, value] : json.items()) {
+    if (key == "ids") {
+      if (not read_strings(value, result.ids)) { return std::nullopt; }
+    } else if (key == "authors") {
+      if (not read_strings(value, result.authors)) { return std::nullopt; }
+    } else if (key == "kinds") {
+      if (not value.is_array()) { return std::nullopt; }
+      for (const auto &event_kind : value) {
+        if (not event_kind.is_number_unsigned()) { return std::nullopt; }
+        if (event_kind.get<std::uint64_t>() > std::numeric_limits<std::uint16_t>::max()) { return std::nullopt; }
+        result.kinds.push_back(static_cast<enum kind>(event_kind.get<std::uint16_t>()));
+      }
+    } else if (key.size() == 2 and key[0] == '#') {
+      std::vector<std::string> tag_values;
+      if (not read_strings(value, tag_values)) { return std::nullopt; }
+      result.tags.emplace_back(key[1], std::move(tag_values));
+    } else if (key == "since" or key == "until") {
+      if (not value.is_number_unsigned()) { return std::nullopt; }
+      (key == "since" ? result.since : result.until) = value.get<std::uint64_t>();
+    } else if (key == "limit") {
+      if (not value.is_number_unsigned()) { return std::nullopt; }
+      if (value.get<std::uint64_t>() > std::numeric_limits<std::uint32_t>::max()) { return std::nullopt; }
+      result.limit = value.get<std::uint32_t>();
+    } else {
+      return std::nullopt;
+    }
+  }
+  return result;
+}
+
 auto req::serialize() const -> std::string
 {
   nlohmann::json json_array = nlohmann::json::array();
@@ -255,26 +307,18 @@ auto event::from_event_data(const event_data &evt) -> event { return event{ .sub
 
 auto event::serialize() const -> std::string
 {
-  nlohmann::json event_json;
-  event_json["id"] = data.id;
-  event_json["pubkey"] = data.pubkey;
-  event_json["created_at"] = data.created_at;
-  event_json["kind"] = data.kind;
-  event_json["content"] = data.content;
-  event_json["sig"] = data.sig;
-  event_json["tags"] = nlohmann::json::array();
-  for (const auto &tag : data.tags) {
-    nlohmann::json tag_json = nlohmann::json::array();
-    std::ranges::copy(tag, std::back_inserter(tag_json));
-    event_json["tags"].push_back(tag_json);
-  }
-
-  nlohmann::json message = nlohmann::json::array();
-  message.push_back("EVENT");
-  if (not subscription_id.empty()) { message.push_back(subscription_id); }
-  message.push_back(event_json);
+  auto &bytes = scratch_buffer();
+  json_writer writer(bytes);
+  writer.begin_array().value("EVENT");
+  if (not subscription_id.empty()) { writer.value(subscription_id); }
+  write_event_object(writer, data);
+  writer.end_array();
 
-  return message.dump();
+  std::string json_str;
+  json_str.resize(bytes.size());
+  std::ranges::transform(
+    bytes, json_str.begin(), [](std::byte byte_val) -> char { return std::bit_cast<char>(byte_val); });
+  return json_str;
 }
 
 auto event::deserialize(const std::string &json) -> std::optional<event>
@@ -0,0 +1,153 @@
+#include <nostr/relay_health.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace radix_relay::nostr {
+
+namespace {
+
+  constexpr std::uint32_t full_score = 100;
+  constexpr std::uint32_t median = 50;
+  constexpr std::uint32_t tail = 99;
+  constexpr std::chrono::milliseconds score_reference{ std::chrono::seconds(1) };
+
+  auto index(relay_latency kind) -> std::size_t { return static_cast<std::size_t>(kind); }
+
+  auto to_ms(std::optional<std::chrono::milliseconds> latency) -> std::optional<std::uint64_t>
+  {
+    if (not latency) { return std::nullopt; }
+    return static_cast<std::uint64_t>(latency->count());
+  }
+
+}// namespace
+
+relay_health::relay_health(std::chrono::milliseconds max_timeout,
+  std::chrono::milliseconds min_timeout,
+  std::uint32_t timeout_multiplier,
+  std::size_t window)
+  : max_timeout_(max_timeout), min_timeout_(std::min(min_timeout, max_timeout)),
+    timeout_multiplier_(timeout_multiplier), window_(std::max<std::size_t>(window, 1))
+{}
+
+auto relay_health::record(const std::string &url, relay_latency kind, std::chrono::milliseconds elapsed) -> void
+{
+  auto &samples = relays_[url];
+  push_latency(samples, kind, elapsed);
+  if (kind == relay_latency::ok or kind == relay_latency::eose) { push_outcome(samples, true); }
+}
+
+auto relay_health::record_timeout(const std::string &url, relay_latency kind, std::chrono::milliseconds elapsed)
+  -> void
+{
+  auto &samples = relays_[url];
+  push_latency(samples, kind, elapsed);
+  push_outcome(samples, false);
+  ++samples.timeouts;
+}
+
+auto relay_health::record_connect_failure(const std::string &url) -> void { push_outcome(relays_[url], false); }
+
+auto relay_health::percentile(const std::string &url, relay_latency kind, std::uint32_t percent) const
+  -> std::optional<std::chrono::milliseconds>
+{
+  const auto relay = relays_.find(url);
+  if (relay == relays_.end() or relay->second.latencies.at(index(kind)).empty()) { return std::nullopt; }
+
+  std::vector<std::chrono::milliseconds> sorted(
+    relay->second.latencies.at(index(kind)).begin(), relay->second.latencies.at(index(kind)).end());
+  std::ranges::sort(sorted);
+  const auto rank = (std::clamp<std::uint32_t>(percent, 1, full_score) * sorted.size() + full_score - 1) / full_score;
+  return sorted.at(rank - 1);
+}
+
+auto relay_health::timeout(const std::string &url, relay_latency kind) const -> std::chrono::milliseconds
+{
+  const auto relay = relays_.find(url);
+  if (timeout_multiplier_ == 0 or relay == relays_.end()
+      or relay->second.latencies.at(index(kind)).size() < min_samples) {
+    return max_timeout_;
+  }
+
+  const auto adapted = *percentile(url, kind, tail) * timeout_multiplier_;
+  return std::clamp(adapted, min_timeout_, max_timeout_);
+}
+
+auto relay_health::score(const std::string &url) const -> std::optional<std::uint32_t>
+{
+  const auto relay = relays_.find(url);
+  if (relay == relays_.end() or relay->second.answered.empty()) { return std::nullopt; }
+
+  const auto &answered = relay->second.answered;
+  const auto answered_share =
+    static_cast<double>(std::ranges::count(answered, true)) / static_cast<double>(answered.size());
+
+  auto latency = percentile(url, relay_latency::ok, median);
+  if (not latency) { latency = percentile(url, relay_latency::eose, median); }
+  const auto reference = static_cast<double>(score_reference.count());
+  const auto speed = latency ? reference / (reference + static_cast<double>(latency->count())) : 1.0;
+
+  return static_cast<std::uint32_t>(std::lround(full_score * answered_share * speed));
+}
+
+auto relay_health::rank(std::vector<std::string> urls) const -> std::vector<std::string>
+{
+  enum class tier : std::uint8_t { healthy, unmeasured, unhealthy };
+
+  const auto tier_of = [this](const std::string &url) {
+    const auto relay_score = score(url);
+    if (not relay_score) { return tier::unmeasured; }
+    return *relay_score >= healthy_score ? tier::healthy : tier::unhealthy;
+  };
+  const auto latency_of = [this](const std::string &url) {
+    return percentile(url, relay_latency::ok, median).value_or(std::chrono::milliseconds::max());
+  };
+
+  std::ranges::stable_sort(urls, [&](const std::string &lhs, const std::string &rhs) {
+    const auto lhs_tier = tier_of(lhs);
+    const auto rhs_tier = tier_of(rhs);
+    if (lhs_tier != rhs_tier) { return lhs_tier < rhs_tier; }
+    if (lhs_tier == tier::healthy) { return latency_of(lhs) < latency_of(rhs); }
+    if (lhs_tier == tier::unhealthy) { return score(lhs) > score(rhs); }
+    return false;
+  });
+  return urls;
+}
+
+auto relay_health::stats(const std::string &url) const -> core::events::connection_monitor::relay_stats
+{
+  const auto relay = relays_.find(url);
+  const auto latest_ping = [&]() -> std::optional<std::chrono::milliseconds> {
+    if (relay == relays_.end() or relay->second.latencies.at(index(relay_latency::ping)).empty()) {
+      return std::nullopt;
+    }
+    return relay->second.latencies.at(index(relay_latency::ping)).back();
+  };
+
+  return core::events::connection_monitor::relay_stats{ .url = url,
+    .score = score(url),
+    .ok_p50_ms = to_ms(percentile(url, relay_latency::ok, median)),
+    .ok_p99_ms = to_ms(percentile(url, relay_latency::ok, tail)),
+    .eose_p50_ms = to_ms(percentile(url, relay_latency::eose, median)),
+    .ping_ms = to_ms(latest_ping()),
+    .connect_p50_ms = to_ms(percentile(url, relay_latency::connect, median)),
+    .connect_p99_ms = to_ms(percentile(url, relay_latency::connect, tail)),
+    .request_timeout_ms = static_cast<std::uint64_t>(timeout(url, relay_latency::ok).count()),
+    .timeouts = relay == relays_.end() ? 0 : relay->second.timeouts };
+}
+
+auto relay_health::push_latency(relay_samples &samples, relay_latency kind, std::chrono::milliseconds elapsed) const
+  -> void
+{
+  auto &latencies = samples.latencies.at(index(kind));
+  latencies.push_back(std::max(elapsed, std::chrono::milliseconds::zero()));
+  if (latencies.size() > window_) { latencies.pop_front(); }
+}
+
+auto relay_health::push_outcome(relay_samples &samples, bool answered) const -> void
+{
+  samples.answered.push_back(answered);
+  if (samples.answered.size() > window_) { samples.answered.pop_front(); }
+}
+
+}// namespace radix_relay::nostr
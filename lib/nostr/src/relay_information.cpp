@@ -0,0 +1,51 @@
+#include <nostr/relay_information.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <nlohmann/json.hpp>
+
+namespace radix_relay::nostr {
+
+namespace {
+
+  template<typename T>
+  auto read_limit(const nlohmann::json &limitation, const char *key, std::uint64_t min, std::uint64_t max)
+    -> std::optional<T>
+  {
+    const auto value = limitation.find(key);
+    if (value == limitation.end() or not value->is_number_integer()) { return std::nullopt; }
+    if (value->is_number_unsigned()) {
+      const auto number = value->get<std::uint64_t>();
+      if (number < min or number > max) { return std::nullopt; }
+      return static_cast<T>(number);
+    }
+    const auto number = value->get<std::int64_t>();
+    if (number < 0 or static_cast<std::uint64_t>(number) < min or static_cast<std::uint64_t>(number) > max) {
+      return std::nullopt;
+    }
+    return static_cast<T>(number);
+  }
+
+}// namespace
+
+auto parse_relay_limits(std::string_view document) -> std::optional<core::events::transport::relay_limits>
+{
+  const auto json = nlohmann::json::parse(document, nullptr, false);
+  if (json.is_discarded() or not json.is_object()) { return std::nullopt; }
+
+  core::events::transport::relay_limits limits;
+  const auto limitation = json.find("limitation");
+  if (limitation == json.end() or not limitation->is_object()) { return limits; }
+
+  static constexpr std::uint64_t max_pow_difficulty = 255;
+  limits.max_message_length =
+    read_limit<std::size_t>(*limitation, "max_message_length", 1, std::numeric_limits<std::size_t>::max());
+  limits.max_subscriptions =
+    read_limit<std::size_t>(*limitation, "max_subscriptions", 1, std::numeric_limits<std::size_t>::max());
+  limits.max_limit =
+    read_limit<std::uint32_t>(*limitation, "max_limit", 1, std::numeric_limits<std::uint32_t>::max());
+  limits.min_pow_difficulty = read_limit<std::uint32_t>(*limitation, "min_pow_difficulty", 0, max_pow_difficulty);
+  return limits;
+}
+
+}// namespace radix_relay::nostr
@@ -0,0 +1,219 @@
+#include <nostr/sha256.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#if defined(__x86_64__) and (defined(__GNUC__) or defined(__clang__))
+#define RADIX_RELAY_SHA_NI 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace radix_relay::nostr {
+
+namespace {
+  constexpr std::array<std::uint32_t, 64> round_constants{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+  };
+
+  constexpr std::size_t schedule_words = 16;
+  constexpr std::size_t word_bytes = 4;
+  constexpr unsigned byte_bits = 8;
+
+  auto load_big_endian(const std::uint8_t *bytes) -> std::uint32_t
+  {
+    return (static_cast<std::uint32_t>(bytes[0]) << 24U) | (static_cast<std::uint32_t>(bytes[1]) << 16U)
+           | (static_cast<std::uint32_t>(bytes[2]) << 8U) | static_cast<std::uint32_t>(bytes[3]);
+  }
+
+  auto compress_scalar(sha256_state &state, std::span<const std::uint8_t> blocks) -> void
+  {
+    std::array<std::uint32_t, round_constants.size()> schedule{};
+    for (std::size_t offset = 0; offset < blocks.size(); offset += sha256_block_size) {
+      for (std::size_t i = 0; i < schedule_words; ++i) {
+        schedule[i] = load_big_endian(&blocks[offset + (i * word_bytes)]);
+      }
+      for (std::size_t i = schedule_words; i < schedule.size(); ++i) {
+        const auto s0 = std::rotr(schedule[i - 15], 7) ^ std::rotr(schedule[i - 15], 18) ^ (schedule[i - 15] >> 3U);
+        const auto s1 = std::rotr(schedule[i - 2], 17) ^ std::rotr(schedule[i - 2], 19) ^ (schedule[i - 2] >> 10U);
+        schedule[i] = schedule[i - 16] + s0 + schedule[i - 7] + s1;
+      }
+
+      auto [a, b, c, d, e, f, g, h] = state;
+      for (std::size_t i = 0; i < round_constants.size(); ++i) {
+        const auto sum1 = std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25);
+        const auto choose = (e & f) ^ (~e & g);
+        const auto temp1 = h + sum1 + choose + round_constants[i] + schedule[i];
+        const auto sum0 = std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22);
+        const auto majority = (a & b) ^ (a & c) ^ (b & c);
+        h = g;
+        g = f;
+        f = e;
+        e = d + temp1;
+        d = c;
+        c = b;
+        b = a;
+        a = temp1 + sum0 + majority;
+      }
+
+      state[0] += a;
+      state[1] += b;
+      state[2] += c;
+      state[3] += d;
+      state[4] += e;
+      state[5] += f;
+      state[6] += g;
+      state[7] += h;
+    }
+  }
+
+#ifdef RADIX_RELAY_SHA_NI
+  // Four rounds per step; each step also extends the message schedule by four words.
+  __attribute__((target("sha,sse4.1"))) auto compress_sha_ni(sha256_state &state,
+    std::span<const std::uint8_t> blocks) -> void
+  {
+    const auto byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+    auto abef = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&state[0]));
+    auto cdgh = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&state[4]));
+    abef = _mm_shuffle_epi32(abef, 0xB1);
+    cdgh = _mm_shuffle_epi32(cdgh, 0x1B);
+    const auto dcba = abef;
+    abef = _mm_alignr_epi8(dcba, cdgh, 8);
+    cdgh = _mm_blend_epi16(cdgh, dcba, 0xF0);
+
+    for (std::size_t offset = 0; offset < blocks.size(); offset += sha256_block_size) {
+      const auto abef_saved = abef;
+      const auto cdgh_saved = cdgh;
+
+      __m128i words[4];// NOLINT(cppcoreguidelines-avoid-c-arrays,hicpp-avoid-c-arrays,modernize-avoid-c-arrays)
+      for (std::size_t step = 0; step < round_constants.size() / 4; ++step) {
+        auto &word = words[step % 4];
+        if (step < 4) {
+          const auto *source = reinterpret_cast<const __m128i *>(&blocks[offset + (step * 16)]);
+          word = _mm_shuffle_epi8(_mm_loadu_si128(source), byte_swap);
+        } else {
+          const auto &previous = words[(step + 3) % 4];
+          word = _mm_sha256msg2_epu32(
+            _mm_add_epi32(_mm_sha256msg1_epu32(word, words[(step + 1) % 4]),
+              _mm_alignr_epi8(previous, words[(step + 2) % 4], 4)),
+            previous);
+        }
+
+        const auto constants = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&round_constants[step * 4]));
+        auto message = _mm_add_epi32(word, constants);
+        cdgh = _mm_sha256rnds2_epu32(cdgh, abef, message);
+        message = _mm_shuffle_epi32(message, 0x0E);
+        abef = _mm_sha256rnds2_epu32(abef, cdgh, message);
+      }
+
+      abef = _mm_add_epi32(abef, abef_saved);
+      cdgh = _mm_add_epi32(cdgh, cdgh_saved);
+    }
+
+    const auto feba = _mm_shuffle_epi32(abef, 0x1B);
+    cdgh = _mm_shuffle_epi32(cdgh, 0xB1);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(&state[0]), _mm_blend_epi16(feba, cdgh, 0xF0));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(&state[4]), _mm_alignr_epi8(cdgh, feba, 8));
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+  }
+
+  auto cpu_has_sha_ni() -> bool
+  {
+    constexpr unsigned sse41_bit = 1U << 19U;
+    constexpr unsigned sha_bit = 1U << 29U;
+    unsigned eax = 0;
+    unsigned ebx = 0;
+    unsigned ecx = 0;
+    unsigned edx = 0;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0 or (ecx & sse41_bit) == 0) { return false; }
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 0) { return false; }
+    return (ebx & sha_bit) != 0;
+  }
+#endif
+}// namespace
+
+auto detected_sha256_backend() -> sha256_backend
+{
+#ifdef RADIX_RELAY_SHA_NI
+  static const auto backend = cpu_has_sha_ni() ? sha256_backend::sha_ni : sha256_backend::scalar;
+  return backend;
+#else
+  return sha256_backend::scalar;
+#endif
+}
+
+auto sha256_compress(sha256_state &state, std::span<const std::uint8_t> blocks, sha256_backend backend) -> void
+{
+#ifdef RADIX_RELAY_SHA_NI
+  if (backend == sha256_backend::sha_ni) {
+    compress_sha_ni(state, blocks);
+    return;
+  }
+#else
+  std::ignore = backend;
+#endif
+  compress_scalar(state, blocks);
+}
+
+auto sha256_digest_from_state(const sha256_state &state) -> sha256_digest
+{
+  sha256_digest digest{};
+  for (std::size_t i = 0; i < state.size(); ++i) {
+    for (std::size_t byte = 0; byte < word_bytes; ++byte) {
+      digest[(i * word_bytes) + byte] =
+        static_cast<std::uint8_t>(state[i] >> (byte_bits * (word_bytes - 1 - byte)));
+    }
+  }
+  return digest;
+}
+
+auto sha256(std::span<const std::uint8_t> message, sha256_backend backend) -> sha256_digest
+{
+  constexpr std::size_t length_bytes = 8;
+  constexpr std::uint8_t padding_marker = 0x80;
+
+  const auto whole_blocks = message.size() - (message.size() % sha256_block_size);
+  auto state = sha256_initial_state;
+  sha256_compress(state, message.first(whole_blocks), backend);
+
+  std::vector<std::uint8_t> tail(message.begin() + static_cast<std::ptrdiff_t>(whole_blocks), message.end());
+  tail.push_back(padding_marker);
+  while (tail.size() % sha256_block_size != sha256_block_size - length_bytes) { tail.push_back(0); }
+  const auto bit_length = static_cast<std::uint64_t>(message.size()) * byte_bits;
+  for (std::size_t byte = 0; byte < length_bytes; ++byte) {
+    tail.push_back(static_cast<std::uint8_t>(bit_length >> (byte_bits * (length_bytes - 1 - byte))));
+  }
+  sha256_compress(state, tail, backend);
+
+  return sha256_digest_from_state(state);
+}
+
+auto sha256_hex(const sha256_digest &digest) -> std::string
+{
+  constexpr std::string_view hex_digits = "0123456789abcdef";
+  constexpr unsigned nibble_bits = 4;
+  constexpr unsigned nibble_mask = 0x0F;
+
+  std::string hex;
+  hex.reserve(digest.size() * 2);
+  for (const auto byte : digest) {
+    hex += hex_digits[static_cast<unsigned>(byte) >> nibble_bits];
+    hex += hex_digits[static_cast<unsigned>(byte) & nibble_mask];
+  }
+  return hex;
+}
+
+}// namespace radix_relay::nostr
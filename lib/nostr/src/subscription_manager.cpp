@@ -0,0 +1,228 @@
+#include <nostr/subscription_manager.hpp>
+
+#include <algorithm>
+#include <core/uuid_generator.hpp>
+#include <utility>
+
+namespace radix_relay::nostr {
+
+namespace {
+
+  auto mergeable(const protocol::filter &lhs, const protocol::filter &rhs) -> bool
+  {
+    return lhs.ids.empty() and rhs.ids.empty() and not lhs.limit and not rhs.limit and not lhs.authors.empty()
+           and not rhs.authors.empty() and lhs.kinds == rhs.kinds and lhs.tags == rhs.tags and lhs.since == rhs.since
+           and lhs.until == rhs.until;
+  }
+
+}// namespace
+
+auto merge_filters(std::vector<protocol::filter> filters) -> std::vector<protocol::filter>
+{
+  std::vector<protocol::filter> merged;
+  for (auto &candidate : filters) {
+    if (std::ranges::find(merged, candidate) != merged.end()) { continue; }
+
+    const auto target =
+      std::ranges::find_if(merged, [&candidate](const protocol::filter &kept) { return mergeable(kept, candidate); });
+    if (target == merged.end()) {
+      merged.push_back(std::move(candidate));
+      continue;
+    }
+    for (auto &author : candidate.authors) {
+      if (std::ranges::find(target->authors, author) == target->authors.end()) {
+        target->authors.push_back(std::move(author));
+      }
+    }
+  }
+  return merged;
+}
+
+subscription_manager::subscription_manager(std::size_t max_subscriptions)
+  : max_subscriptions_(std::max<std::size_t>(max_subscriptions, 1))
+{}
+
+auto subscription_manager::open(const std::string &name,
+  std::vector<protocol::filter> filters,
+  subscription_lifetime lifetime) -> subscription_update
+{
+  subscription_update update;
+  if (entries_.contains(name)) {
+    detach(name, update);
+    entries_.erase(name);
+  }
+
+  entries_.emplace(
+    name, entry{ .filters = std::move(filters), .lifetime = lifetime, .subscription_id = {}, .replaying = true });
+  place(name, update);
+  return update;
+}
+
+auto subscription_manager::close(const std::string &name) -> subscription_update
+{
+  if (not entries_.contains(name)) { return {}; }
+
+  subscription_update update;
+  detach(name, update);
+  entries_.erase(name);
+
+  auto opened = open_waiting();
+  update.requests.insert(update.requests.end(),
+    std::make_move_iterator(opened.requests.begin()),
+    std::make_move_iterator(opened.requests.end()));
+  return update;
+}
+
+auto subscription_manager::open_waiting() -> subscription_update
+{
+  subscription_update update;
+  while (not waiting_.empty() and relay_subscriptions_.size() < max_subscriptions_) {
+    const auto name = std::move(waiting_.front());
+    waiting_.pop_front();
+    place(name, update);
+  }
+  return update;
+}
+
+auto subscription_manager::replay_finished(const std::string &subscription_id) -> std::vector<subscription_outcome>
+{
+  const auto subscription = relay_subscriptions_.find(subscription_id);
+  if (subscription == relay_subscriptions_.end()) { return {}; }
+
+  std::vector<subscription_outcome> finished;
+  for (const auto &name : subscription->second.names) {
+    auto &item = entries_.at(name);
+    if (not item.replaying) { continue; }
+    item.replaying = false;
+    finished.push_back(
+      { .name = name, .lifetime = item.lifetime, .filters = item.filters, .events = subscription->second.events });
+  }
+  return finished;
+}
+
+auto subscription_manager::closed_by_relay(const std::string &subscription_id) -> std::vector<subscription_outcome>
+{
+  auto node = relay_subscriptions_.extract(subscription_id);
+  if (node.empty()) { return {}; }
+
+  std::vector<subscription_outcome> outcomes;
+  for (const auto &name : node.mapped().names) {
+    auto item = entries_.extract(name);
+    outcomes.push_back({ .name = name,
+      .lifetime = item.mapped().lifetime,
+      .filters = std::move(item.mapped().filters),
+      .events = node.mapped().events });
+  }
+  return outcomes;
+}
+
+auto subscription_manager::record_event(const std::string &subscription_id) -> bool
+{
+  const auto subscription = relay_subscriptions_.find(subscription_id);
+  if (subscription == relay_subscriptions_.end()) { return false; }
+
+  ++subscription->second.events;
+  return true;
+}
+
+auto subscription_manager::reset(std::size_t max_subscriptions) -> void
+{
+  entries_.clear();
+  relay_subscriptions_.clear();
+  waiting_.clear();
+  set_max_subscriptions(max_subscriptions);
+}
+
+auto subscription_manager::set_max_subscriptions(std::size_t max_subscriptions) -> void
+{
+  max_subscriptions_ = std::max<std::size_t>(max_subscriptions, 1);
+}
+
+auto subscription_manager::place(const std::string &name, subscription_update &update) -> void
+{
+  auto &item = entries_.at(name);
+  if (relay_subscriptions_.size() < max_subscriptions_) {
+    item.subscription_id = core::uuid_generator::generate();
+    relay_subscriptions_.emplace(
+      item.subscription_id, relay_subscription{ .names = { name }, .lifetime = item.lifetime });
+    update.requests.push_back({ .subscription_id = item.subscription_id, .filters = merge_filters(item.filters) });
+    return;
+  }
+
+  if (item.lifetime == subscription_lifetime::persistent) {
+    const auto filter_count = [this](const relay_subscription &subscription) {
+      std::size_t count = 0;
+      for (const auto &carried : subscription.names) { count += entries_.at(carried).filters.size(); }
+      return count;
+    };
+
+    auto host = relay_subscriptions_.end();
+    for (auto candidate = relay_subscriptions_.begin(); candidate != relay_subscriptions_.end(); ++candidate) {
+      if (candidate->second.lifetime != subscription_lifetime::persistent) { continue; }
+      if (host == relay_subscriptions_.end() or filter_count(candidate->second) < filter_count(host->second)) {
+        host = candidate;
+      }
+    }
+
+    if (host != relay_subscriptions_.end()) {
+      host->second.names.push_back(name);
+      item.subscription_id = host->first;
+      reissue(host->first, update);
+      return;
+    }
+  }
+
+  item.subscription_id.clear();
+  waiting_.push_back(name);
+}
+
+auto subscription_manager::detach(const std::string &name, subscription_update &update) -> void
+{
+  const auto &item = entries_.at(name);
+  if (item.subscription_id.empty()) {
+    std::erase(waiting_, name);
+    return;
+  }
+
+  const auto subscription_id = item.subscription_id;
+  auto &carried = relay_subscriptions_.at(subscription_id).names;
+  std::erase(carried, name);
+  if (carried.empty()) {
+    relay_subscriptions_.erase(subscription_id);
+    retire(subscription_id, update);
+  } else {
+    reissue(subscription_id, update);
+  }
+}
+
+auto subscription_manager::reissue(std::string subscription_id, subscription_update &update) -> void
+{
+  auto node = relay_subscriptions_.extract(subscription_id);
+  retire(subscription_id, update);
+
+  node.key() = core::uuid_generator::generate();
+  node.mapped().events = 0;
+
+  std::vector<protocol::filter> filters;
+  for (const auto &name : node.mapped().names) {
+    auto &item = entries_.at(name);
+    item.subscription_id = node.key();
+    filters.insert(filters.end(), item.filters.begin(), item.filters.end());
+  }
+
+  update.requests.push_back({ .subscription_id = node.key(), .filters = merge_filters(std::move(filters)) });
+  relay_subscriptions_.insert(std::move(node));
+}
+
+auto subscription_manager::retire(const std::string &subscription_id, subscription_update &update) -> void
+{
+  // A subscription requested earlier in the same update never reached the relay
+  const auto unsent = std::ranges::find(update.requests, subscription_id, &subscription_request::subscription_id);
+  if (unsent != update.requests.end()) {
+    update.requests.erase(unsent);
+  } else {
+    update.closes.push_back(subscription_id);
+  }
+}
+
+}// namespace radix_relay::nostr
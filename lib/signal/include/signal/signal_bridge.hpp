@@ -3,6 +3,8 @@
 #include <core/contact_info.hpp>
 #include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <mutex>
 #include <rust/cxx.h>
 #include <signal_bridge_cxx/lib.h>
 #include <signal_types/signal_types.hpp>
@@ -16,6 +18,7 @@ namespace radix_relay::signal {
  *
  * Provides Signal Protocol operations including encryption/decryption,
  * key management, session establishment, and Nostr integration.
+ * Calls are serialized internally, so one bridge may be shared between threads.
  */
 class bridge
 {
@@ -26,7 +29,8 @@ public:
    * @param bridge_db Path to Signal Protocol database
    */
   explicit bridge(const std::filesystem::path &bridge_db)
-    : bridge_(radix_relay::new_signal_bridge(bridge_db.string().c_str()))
+    : bridge_(radix_relay::new_signal_bridge(bridge_db.string().c_str())),
+      key_factory_(radix_relay::key_factory_handle(*bridge_))
   {}
 
   /**
@@ -34,7 +38,9 @@ public:
    *
    * @param signal_bridge Rust SignalBridge instance
    */
-  explicit bridge(rust::Box<SignalBridge> signal_bridge) : bridge_(std::move(signal_bridge)) {}
+  explicit bridge(rust::Box<SignalBridge> signal_bridge)
+    : bridge_(std::move(signal_bridge)), key_factory_(radix_relay::key_factory_handle(*bridge_))
+  {}
 
   bridge(const bridge &) = delete;
   auto operator=(const bridge &) -> bridge & = delete;
@@ -76,6 +82,36 @@ public:
   [[nodiscard]] auto decrypt_message(const std::string &rdx, const std::vector<uint8_t> &bytes) const
     -> decryption_result;
 
+  /**
+   * @brief Opts this node in or out of compressing outgoing message payloads.
+   *
+   * While enabled, outgoing messages advertise zstd support and plaintext to peers that advertised it
+   * too is compressed before encryption. Incoming compressed payloads are decoded either way.
+   *
+   * @param enabled Whether to advertise and use payload compression
+   */
+  auto set_payload_compression(bool enabled) const -> void;
+
+  /**
+   * @brief Records whether a peer's latest message advertised zstd support.
+   *
+   * The capability is stored with the contact, so it survives a restart.
+   *
+   * @param rdx Sender's RDX fingerprint
+   * @param supported Whether the message carried the capability
+   */
+  auto record_peer_compression(const std::string &rdx, bool supported) const -> void;
+
+  /**
+   * @brief Records whether a peer's latest message showed it accepts base64 content.
+   *
+   * The capability is stored with the contact; peers never recorded get hex content.
+   *
+   * @param rdx Sender's RDX fingerprint
+   * @param supported Whether the message was base64 or listed base64 as accepted
+   */
+  auto record_peer_base64_content(const std::string &rdx, bool supported) const -> void;
+
   /**
    * @brief Establishes a session from a prekey bundle.
    *
@@ -94,6 +130,38 @@ public:
    */
   [[nodiscard]] auto extract_rdx_from_bundle_base64(const std::string &bundle_base64) const -> std::string;
 
+  /**
+   * @brief Remembers a discovered bundle announcement across restarts.
+   *
+   * A cached announcement newer than this one is kept.
+   *
+   * @param bundle Announcement metadata
+   * @param bundle_base64 Base64-encoded prekey bundle
+   */
+  auto save_discovered_bundle(const cached_bundle &bundle, const std::string &bundle_base64) const -> void;
+
+  /**
+   * @brief Lists cached bundle announcements without their bundle data.
+   *
+   * @return Cached announcements, in no particular order
+   */
+  [[nodiscard]] auto cached_discovered_bundles() const -> std::vector<cached_bundle>;
+
+  /**
+   * @brief Reads the bundle data of a cached announcement.
+   *
+   * @param nostr_pubkey Nostr pubkey of the announcing node
+   * @return Base64-encoded prekey bundle, or an empty string if none is cached
+   */
+  [[nodiscard]] auto load_discovered_bundle(const std::string &nostr_pubkey) const -> std::string;
+
+  /**
+   * @brief Forgets the cached bundle announcement of a pubkey.
+   *
+   * @param nostr_pubkey Nostr pubkey of the announcing node
+   */
+  auto forget_discovered_bundle(const std::string &nostr_pubkey) const -> void;
+
   /**
    * @brief Generates a signed prekey bundle announcement.
    *
@@ -110,6 +178,14 @@ public:
    */
   [[nodiscard]] auto generate_empty_bundle_announcement(const std::string &version) const -> std::string;
 
+  /**
+   * @brief Generates an empty bundle announcement as a wire-ready EVENT frame.
+   *
+   * @param version Protocol version string
+   * @return Event ID and serialized ["EVENT", {...}] frame
+   */
+  [[nodiscard]] auto generate_empty_bundle_frame(const std::string &version) const -> signed_event_frame;
+
   /**
    * @brief Assigns an alias to a contact.
    *
@@ -132,6 +208,38 @@ public:
     uint32_t timestamp,
     const std::string &version) const -> std::string;
 
+  /**
+   * @brief Creates, signs, and frames a Nostr encrypted message event.
+   *
+   * @param rdx Recipient's RDX fingerprint or Nostr pubkey
+   * @param ciphertext Signal Protocol ciphertext, base64-encoded into the event content by the bridge
+   * @param timestamp Unix timestamp
+   * @param version Protocol version string
+   * @return Event ID and serialized ["EVENT", {...}] frame
+   */
+  [[nodiscard]] auto create_encrypted_message_frame(const std::string &rdx,
+    const std::vector<uint8_t> &ciphertext,
+    std::uint64_t timestamp,
+    const std::string &version) const -> signed_event_frame;
+
+  /**
+   * @brief Encrypts one message for many recipients and frames an event for each.
+   *
+   * All session updates and history rows are written in one storage transaction and every
+   * event is signed with a single key derivation. A recipient without a session does not fail
+   * the others; its entry carries an error instead of a frame.
+   *
+   * @param peers Recipient RDX fingerprints, aliases, or Nostr pubkeys
+   * @param plaintext Message bytes
+   * @param timestamp Unix timestamp
+   * @param version Protocol version string
+   * @return One entry per recipient, in order
+   */
+  [[nodiscard]] auto create_encrypted_message_frames(const std::vector<std::string> &peers,
+    const std::vector<uint8_t> &plaintext,
+    std::uint64_t timestamp,
+    const std::string &version) const -> std::vector<fan_out_frame>;
+
   /**
    * @brief Looks up a contact by RDX fingerprint or alias.
    *
@@ -150,14 +258,152 @@ public:
   [[nodiscard]] auto sign_nostr_event(const std::string &event_json) const -> std::string;
 
   /**
-   * @brief Creates a Nostr subscription filter for messages to this node.
+   * @brief Signs a Nostr event from typed fields.
+   *
+   * @param kind Nostr event kind
+   * @param tags Event tags
+   * @param content Event content
+   * @param created_at Unix timestamp
+   * @return Event ID and serialized ["EVENT", {...}] frame
+   */
+  [[nodiscard]] auto sign_event_frame(std::uint32_t kind,
+    const std::vector<std::vector<std::string>> &tags,
+    const std::string &content,
+    std::uint64_t created_at) const -> signed_event_frame;
+
+  /**
+   * @brief Creates a sender key group of existing contacts.
+   *
+   * Nothing is sent until the first create_sender_key_distribution_frames() call.
    *
-   * @param subscription_id Subscription identifier
-   * @param since_timestamp Optional timestamp to filter messages since
-   * @return REQ message JSON
+   * @param name Human-readable group name
+   * @param members RDX fingerprints, aliases, or Nostr pubkeys of the other members
+   * @return Distribution ID identifying the group
    */
-  [[nodiscard]] auto create_subscription_for_self(const std::string &subscription_id,
-    std::uint64_t since_timestamp = 0) const -> std::string;
+  [[nodiscard]] auto create_group(const std::string &name, const std::vector<std::string> &members) const
+    -> std::string;
+
+  /**
+   * @brief Builds sender key distributions for group members that don't hold this node's key yet.
+   *
+   * Each distribution is encrypted over the pairwise session with one member, once per group.
+   * Members without a session are skipped and retried on the next call, and so is every member
+   * until mark_sender_key_delivered() records that a relay accepted their distribution.
+   *
+   * @param group Group distribution ID or name
+   * @param timestamp Unix timestamp
+   * @param version Protocol version string
+   * @return One frame per distribution, with the member's RDX fingerprint as recipient
+   */
+  [[nodiscard]] auto create_sender_key_distribution_frames(const std::string &group,
+    std::uint64_t timestamp,
+    const std::string &version) const -> std::vector<fan_out_frame>;
+
+  /**
+   * @brief Records that a relay accepted a member's sender key distribution.
+   *
+   * @param group Group distribution ID or name
+   * @param member_rdx RDX fingerprint of the member
+   */
+  auto mark_sender_key_delivered(const std::string &group, const std::string &member_rdx) const -> void;
+
+  /**
+   * @brief Encrypts a message once for a whole group and frames it as a single event.
+   *
+   * @param group Group distribution ID or name
+   * @param plaintext Message bytes
+   * @param timestamp Unix timestamp
+   * @param version Protocol version string
+   * @return Event ID and serialized ["EVENT", {...}] frame
+   */
+  [[nodiscard]] auto create_group_message_frame(const std::string &group,
+    const std::vector<uint8_t> &plaintext,
+    std::uint64_t timestamp,
+    const std::string &version) const -> signed_event_frame;
+
+  /**
+   * @brief Processes a sender key distribution received from a group member.
+   *
+   * @param rdx Nostr pubkey of the event author (peer hint)
+   * @param bytes Pairwise Signal ciphertext of the distribution
+   * @return Group and sender the key belongs to
+   */
+  [[nodiscard]] auto process_sender_key_distribution(const std::string &rdx, const std::vector<uint8_t> &bytes) const
+    -> group_membership;
+
+  /**
+   * @brief Decrypts a group message with the sender's distributed sender key.
+   *
+   * @param rdx Nostr pubkey of the event author (peer hint)
+   * @param group_id Distribution ID from the event's g tag
+   * @param bytes Serialized sender key message
+   * @return Group, sender, and decrypted plaintext
+   */
+  [[nodiscard]] auto decrypt_group_message(const std::string &rdx,
+    const std::string &group_id,
+    const std::vector<uint8_t> &bytes) const -> group_decryption_result;
+
+  /**
+   * @brief Registers a file to be sent to a contact in chunks.
+   *
+   * The file is hashed now and read again one chunk at a time as frames are built, so it must
+   * stay in place until the transfer completes.
+   *
+   * @param peer RDX fingerprint, alias, or Nostr pubkey of the recipient
+   * @param path File to send
+   * @return The new transfer with every chunk pending
+   */
+  [[nodiscard]] auto start_file_transfer(const std::string &peer, const std::string &path) const
+    -> outgoing_transfer;
+
+  /**
+   * @brief Lists outgoing transfers that still have chunks no relay has accepted.
+   *
+   * @return Unfinished transfers, oldest first
+   */
+  [[nodiscard]] auto pending_file_transfers() const -> std::vector<outgoing_transfer>;
+
+  /**
+   * @brief Reads and encrypts one chunk of an outgoing transfer and frames it as an event.
+   *
+   * @param transfer_id Outgoing transfer
+   * @param chunk_index Chunk to send
+   * @param timestamp Unix timestamp
+   * @param version Protocol version string
+   * @return Event ID and serialized ["EVENT", {...}] frame
+   */
+  [[nodiscard]] auto create_transfer_chunk_frame(const std::string &transfer_id,
+    std::uint32_t chunk_index,
+    std::uint64_t timestamp,
+    const std::string &version) const -> signed_event_frame;
+
+  /**
+   * @brief Records that a relay accepted a chunk of an outgoing transfer.
+   *
+   * @param transfer_id Outgoing transfer
+   * @param chunk_index Accepted chunk
+   * @return True once every chunk has been accepted
+   */
+  [[nodiscard]] auto mark_transfer_chunk_delivered(const std::string &transfer_id, std::uint32_t chunk_index) const
+    -> bool;
+
+  /**
+   * @brief Decrypts a received file chunk and writes it into the transfer's partial file.
+   *
+   * @param rdx Nostr pubkey of the event author (peer hint)
+   * @param bytes Pairwise Signal ciphertext of the chunk
+   * @return Progress of the transfer the chunk belongs to
+   */
+  [[nodiscard]] auto process_transfer_chunk(const std::string &rdx, const std::vector<uint8_t> &bytes) const
+    -> transfer_progress;
+
+  /**
+   * @brief Returns what this node subscribes to in order to receive its messages.
+   *
+   * @param since_timestamp Timestamp to receive messages since, 0 for the stored one
+   * @return Pubkey, group IDs and lower bound of the message subscription
+   */
+  [[nodiscard]] auto message_subscription(std::uint64_t since_timestamp = 0) const -> signal::message_subscription;
 
   /**
    * @brief Updates the timestamp of the last received message.
@@ -166,9 +412,23 @@ public:
    */
   auto update_last_message_timestamp(std::uint64_t timestamp) const -> void;
 
+  /**
+   * @brief Checks the ID and BIP-340 signature of relay-delivered events.
+   *
+   * Touches no bridge state and takes no lock, so it can run on a worker thread alongside other
+   * bridge calls. Large batches are split across cores.
+   *
+   * @param event_jsons Event objects as JSON
+   * @return One flag per event, in order: true if the event is authentic
+   */
+  [[nodiscard]] auto verify_events(const std::vector<std::string> &event_jsons) const -> std::vector<bool>;
+
   /**
    * @brief Performs periodic key maintenance and rotation.
    *
+   * The bridge is locked while due keys are looked up and again while new keys are stored, but
+   * not while key pairs are claimed from the key factory, which may have to generate them.
+   *
    * @return Result indicating which keys were rotated
    */
   [[nodiscard]] auto perform_key_maintenance() const -> key_maintenance_result;
@@ -246,6 +506,8 @@ public:
 
 private:
   mutable rust::Box<SignalBridge> bridge_;
+  rust::Box<KeyFactoryHandle> key_factory_;///< Used by key maintenance without holding mutex_
+  std::unique_ptr<std::mutex> mutex_ = std::make_unique<std::mutex>();///< Serializes calls into the Rust bridge
 };
 
 
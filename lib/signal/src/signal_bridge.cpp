@@ -2,16 +2,47 @@
 
 #include <algorithm>
 #include <iterator>
+#include <mutex>
 
 namespace radix_relay::signal {
 
+namespace {
+  auto to_byte_vector(const rust::Vec<std::uint8_t> &bytes) -> std::vector<std::byte>
+  {
+    std::vector<std::byte> result(bytes.size());
+    std::transform(
+      bytes.begin(), bytes.end(), result.begin(), [](std::uint8_t value) { return static_cast<std::byte>(value); });
+    return result;
+  }
+
+  auto to_signed_event_frame(const radix_relay::SignedEventFrame &rust_frame) -> signed_event_frame
+  {
+    return {
+      .event_id = std::string(rust_frame.event_id),
+      .bytes = to_byte_vector(rust_frame.frame),
+    };
+  }
+
+  auto to_fan_out_frame(const radix_relay::FanOutFrame &rust_frame) -> fan_out_frame
+  {
+    return {
+      .recipient = std::string(rust_frame.recipient),
+      .event_id = std::string(rust_frame.event_id),
+      .bytes = to_byte_vector(rust_frame.bytes),
+      .error = std::string(rust_frame.error),
+    };
+  }
+}// namespace
+
 auto bridge::get_node_fingerprint() const -> std::string
 {
+  const std::scoped_lock lock(*mutex_);
   return std::string(radix_relay::generate_node_fingerprint(*bridge_));
 }
 
 auto bridge::list_contacts() const -> std::vector<core::contact_info>
 {
+  const std::scoped_lock lock(*mutex_);
   auto rust_contacts = radix_relay::list_contacts(*bridge_);
   std::vector<core::contact_info> result;
   result.reserve(rust_contacts.size());
@@ -30,6 +61,7 @@ auto bridge::list_contacts() const -> std::vector<core::contact_info>
 
 auto bridge::encrypt_message(const std::string &rdx, const std::vector<uint8_t> &bytes) const -> std::vector<uint8_t>
 {
+  const std::scoped_lock lock(*mutex_);
   auto encrypted =
     radix_relay::encrypt_message(*bridge_, rdx.c_str(), rust::Slice<const uint8_t>{ bytes.data(), bytes.size() });
   return { encrypted.begin(), encrypted.end() };
@@ -37,6 +69,7 @@ auto bridge::encrypt_message(const std::string &rdx, const std::vector<uint8_t>
 
 auto bridge::decrypt_message(const std::string &rdx, const std::vector<uint8_t> &bytes) const -> decryption_result
 {
+  const std::scoped_lock lock(*mutex_);
   auto result =
     radix_relay::decrypt_message(*bridge_, rdx.c_str(), rust::Slice<const uint8_t>{ bytes.data(), bytes.size() });
   return {
@@ -45,38 +78,106 @@ auto bridge::decrypt_message(const std::string &rdx, const std::vector<uint8_t>
   };
 }
 
+auto bridge::set_payload_compression(bool enabled) const -> void
+{
+  const std::scoped_lock lock(*mutex_);
+  radix_relay::set_payload_compression(*bridge_, enabled);
+}
+
+auto bridge::record_peer_compression(const std::string &rdx, bool supported) const -> void
+{
+  const std::scoped_lock lock(*mutex_);
+  radix_relay::record_peer_compression(*bridge_, rdx.c_str(), supported);
+}
+
+auto bridge::record_peer_base64_content(const std::string &rdx, bool supported) const -> void
+{
+  const std::scoped_lock lock(*mutex_);
+  radix_relay::record_peer_base64_content(*bridge_, rdx.c_str(), supported);
+}
+
 auto bridge::add_contact_and_establish_session_from_base64(const std::string &bundle, const std::string &alias) const
   -> std::string
 {
+  const std::scoped_lock lock(*mutex_);
   auto peer_rdx = radix_relay::add_contact_and_establish_session_from_base64(*bridge_, bundle.c_str(), alias.c_str());
   return std::string(peer_rdx);
 }
 
 auto bridge::extract_rdx_from_bundle_base64(const std::string &bundle_base64) const -> std::string
 {
+  const std::scoped_lock lock(*mutex_);
   auto rdx = radix_relay::extract_rdx_from_bundle_base64(*bridge_, bundle_base64.c_str());
   return std::string(rdx);
 }
 
+auto bridge::save_discovered_bundle(const cached_bundle &bundle, const std::string &bundle_base64) const -> void
+{
+  const std::scoped_lock lock(*mutex_);
+  const radix_relay::DiscoveredBundle rust_bundle{ .nostr_pubkey = rust::String(bundle.nostr_pubkey),
+    .rdx_fingerprint = rust::String(bundle.rdx_fingerprint),
+    .event_id = rust::String(bundle.event_id),
+    .created_at = bundle.created_at };
+  radix_relay::save_discovered_bundle(*bridge_, rust_bundle, bundle_base64.c_str());
+}
+
+auto bridge::cached_discovered_bundles() const -> std::vector<cached_bundle>
+{
+  const std::scoped_lock lock(*mutex_);
+  auto rust_bundles = radix_relay::cached_discovered_bundles(*bridge_);
+  std::vector<cached_bundle> result;
+  result.reserve(rust_bundles.size());
+  std::ranges::transform(rust_bundles, std::back_inserter(result), [](const radix_relay::DiscoveredBundle &bundle) {
+    return cached_bundle{ .nostr_pubkey = std::string(bundle.nostr_pubkey),
+      .rdx_fingerprint = std::string(bundle.rdx_fingerprint),
+      .event_id = std::string(bundle.event_id),
+      .created_at = bundle.created_at };
+  });
+  return result;
+}
+
+auto bridge::load_discovered_bundle(const std::string &nostr_pubkey) const -> std::string
+{
+  const std::scoped_lock lock(*mutex_);
+  return std::string(radix_relay::load_discovered_bundle(*bridge_, nostr_pubkey.c_str()));
+}
+
+auto bridge::forget_discovered_bundle(const std::string &nostr_pubkey) const -> void
+{
+  const std::scoped_lock lock(*mutex_);
+  radix_relay::forget_discovered_bundle(*bridge_, nostr_pubkey.c_str());
+}
+
 auto bridge::generate_prekey_bundle_announcement(const std::string &version) const -> bundle_info
 {
+  const std::scoped_lock lock(*mutex_);
   auto bundle_result = radix_relay::generate_prekey_bundle_announcement(*bridge_, version.c_str());
   return {
     .announcement_json = std::string(bundle_result.announcement_json),
     .pre_key_id = bundle_result.pre_key_id,
     .signed_pre_key_id = bundle_result.signed_pre_key_id,
     .kyber_pre_key_id = bundle_result.kyber_pre_key_id,
+    .event_id = std::string(bundle_result.event_id),
+    .frame = to_byte_vector(bundle_result.frame),
   };
 }
 
 auto bridge::generate_empty_bundle_announcement(const std::string &version) const -> std::string
 {
+  const std::scoped_lock lock(*mutex_);
   auto bundle_json = radix_relay::generate_empty_bundle_announcement(*bridge_, version.c_str());
   return std::string(bundle_json);
 }
 
+auto bridge::generate_empty_bundle_frame(const std::string &version) const -> signed_event_frame
+{
+  const std::scoped_lock lock(*mutex_);
+  return to_signed_event_frame(radix_relay::generate_empty_bundle_frame(*bridge_, version.c_str()));
+}
+
 auto bridge::assign_contact_alias(const std::string &rdx, const std::string &alias) const -> void
 {
+  const std::scoped_lock lock(*mutex_);
   radix_relay::assign_contact_alias(*bridge_, rdx.c_str(), alias.c_str());
 }
 
@@ -85,13 +186,49 @@ auto bridge::create_and_sign_encrypted_message(const std::string &rdx,
   uint32_t timestamp,
   const std::string &version) const -> std::string
 {
+  const std::scoped_lock lock(*mutex_);
   auto signed_event =
     radix_relay::create_and_sign_encrypted_message(*bridge_, rdx.c_str(), content.c_str(), timestamp, version.c_str());
   return std::string(signed_event);
 }
 
+auto bridge::create_encrypted_message_frame(const std::string &rdx,
+  const std::vector<uint8_t> &ciphertext,
+  std::uint64_t timestamp,
+  const std::string &version) const -> signed_event_frame
+{
+  const std::scoped_lock lock(*mutex_);
+  return to_signed_event_frame(radix_relay::create_encrypted_message_frame(*bridge_,
+    rdx.c_str(),
+    rust::Slice<const uint8_t>{ ciphertext.data(), ciphertext.size() },
+    timestamp,
+    version.c_str()));
+}
+
+auto bridge::create_encrypted_message_frames(const std::vector<std::string> &peers,
+  const std::vector<uint8_t> &plaintext,
+  std::uint64_t timestamp,
+  const std::string &version) const -> std::vector<fan_out_frame>
+{
+  rust::Vec<rust::String> rust_peers;
+  rust_peers.reserve(peers.size());
+  for (const auto &peer : peers) { rust_peers.emplace_back(peer); }
+
+  const std::scoped_lock lock(*mutex_);
+  auto rust_frames = radix_relay::create_encrypted_message_frames(*bridge_,
+    std::move(rust_peers),
+    rust::Slice<const uint8_t>{ plaintext.data(), plaintext.size() },
+    timestamp,
+    version.c_str());
+  std::vector<fan_out_frame> result;
+  result.reserve(rust_frames.size());
+  std::ranges::transform(rust_frames, std::back_inserter(result), to_fan_out_frame);
+  return result;
+}
+
 auto bridge::lookup_contact(const std::string &alias) const -> core::contact_info
 {
+  const std::scoped_lock lock(*mutex_);
   auto rust_contact = radix_relay::lookup_contact(*bridge_, alias.c_str());
   return {
     .rdx_fingerprint = std::string(rust_contact.rdx_fingerprint),
@@ -103,26 +240,209 @@ auto bridge::lookup_contact(const std::string &alias) const -> core::contact_inf
 
 auto bridge::sign_nostr_event(const std::string &event_json) const -> std::string
 {
+  const std::scoped_lock lock(*mutex_);
   auto signed_event = radix_relay::sign_nostr_event(*bridge_, event_json.c_str());
   return std::string(signed_event);
 }
 
-auto bridge::create_subscription_for_self(const std::string &subscription_id, std::uint64_t since_timestamp) const
-  -> std::string
+auto bridge::sign_event_frame(std::uint32_t kind,
+  const std::vector<std::vector<std::string>> &tags,
+  const std::string &content,
+  std::uint64_t created_at) const -> signed_event_frame
+{
+  rust::Vec<radix_relay::EventTag> rust_tags;
+  rust_tags.reserve(tags.size());
+  for (const auto &tag : tags) {
+    radix_relay::EventTag rust_tag;
+    rust_tag.values.reserve(tag.size());
+    for (const auto &value : tag) { rust_tag.values.emplace_back(value); }
+    rust_tags.push_back(std::move(rust_tag));
+  }
+
+  const std::scoped_lock lock(*mutex_);
+  return to_signed_event_frame(radix_relay::sign_event_frame(*bridge_,
+    created_at,
+    kind,
+    rust::Slice<const radix_relay::EventTag>{ rust_tags.data(), rust_tags.size() },
+    content.c_str()));
+}
+
+auto bridge::create_group(const std::string &name, const std::vector<std::string> &members) const -> std::string
+{
+  rust::Vec<rust::String> rust_members;
+  rust_members.reserve(members.size());
+  for (const auto &member : members) { rust_members.emplace_back(member); }
+
+  const std::scoped_lock lock(*mutex_);
+  return std::string(radix_relay::create_group(*bridge_, name.c_str(), std::move(rust_members)));
+}
+
+auto bridge::create_sender_key_distribution_frames(const std::string &group,
+  std::uint64_t timestamp,
+  const std::string &version) const -> std::vector<fan_out_frame>
+{
+  const std::scoped_lock lock(*mutex_);
+  auto rust_frames =
+    radix_relay::create_sender_key_distribution_frames(*bridge_, group.c_str(), timestamp, version.c_str());
+  std::vector<fan_out_frame> result;
+  result.reserve(rust_frames.size());
+  std::ranges::transform(rust_frames, std::back_inserter(result), to_fan_out_frame);
+  return result;
+}
+
+auto bridge::mark_sender_key_delivered(const std::string &group, const std::string &member_rdx) const -> void
+{
+  const std::scoped_lock lock(*mutex_);
+  radix_relay::mark_sender_key_delivered(*bridge_, group.c_str(), member_rdx.c_str());
+}
+
+auto bridge::create_group_message_frame(const std::string &group,
+  const std::vector<uint8_t> &plaintext,
+  std::uint64_t timestamp,
+  const std::string &version) const -> signed_event_frame
+{
+  const std::scoped_lock lock(*mutex_);
+  return to_signed_event_frame(radix_relay::create_group_message_frame(*bridge_,
+    group.c_str(),
+    rust::Slice<const uint8_t>{ plaintext.data(), plaintext.size() },
+    timestamp,
+    version.c_str()));
+}
+
+auto bridge::process_sender_key_distribution(const std::string &rdx, const std::vector<uint8_t> &bytes) const
+  -> group_membership
+{
+  const std::scoped_lock lock(*mutex_);
+  auto result = radix_relay::process_sender_key_distribution(
+    *bridge_, rdx.c_str(), rust::Slice<const uint8_t>{ bytes.data(), bytes.size() });
+  return {
+    .group_id = std::string(result.group_id),
+    .name = std::string(result.name),
+    .sender_rdx = std::string(result.sender_rdx),
+    .should_republish_bundle = result.should_republish_bundle,
+  };
+}
+
+auto bridge::decrypt_group_message(const std::string &rdx,
+  const std::string &group_id,
+  const std::vector<uint8_t> &bytes) const -> group_decryption_result
+{
+  const std::scoped_lock lock(*mutex_);
+  auto result = radix_relay::decrypt_group_message(
+    *bridge_, rdx.c_str(), group_id.c_str(), rust::Slice<const uint8_t>{ bytes.data(), bytes.size() });
+  return {
+    .group_id = std::string(result.group_id),
+    .name = std::string(result.name),
+    .sender_rdx = std::string(result.sender_rdx),
+    .plaintext = { result.plaintext.begin(), result.plaintext.end() },
+  };
+}
+
+namespace {
+  auto to_outgoing_transfer(const radix_relay::OutgoingTransfer &rust_transfer) -> outgoing_transfer
+  {
+    return {
+      .transfer_id = std::string(rust_transfer.transfer_id),
+      .peer_rdx = std::string(rust_transfer.peer_rdx),
+      .name = std::string(rust_transfer.name),
+      .chunk_count = rust_transfer.chunk_count,
+      .pending_chunks = { rust_transfer.pending_chunks.begin(), rust_transfer.pending_chunks.end() },
+    };
+  }
+}// namespace
+
+auto bridge::start_file_transfer(const std::string &peer, const std::string &path) const -> outgoing_transfer
 {
-  auto subscription_json =
-    radix_relay::create_subscription_for_self(*bridge_, subscription_id.c_str(), since_timestamp);
-  return std::string(subscription_json);
+  const std::scoped_lock lock(*mutex_);
+  return to_outgoing_transfer(radix_relay::start_file_transfer(*bridge_, peer.c_str(), path.c_str()));
+}
+
+auto bridge::pending_file_transfers() const -> std::vector<outgoing_transfer>
+{
+  const std::scoped_lock lock(*mutex_);
+  auto rust_transfers = radix_relay::pending_file_transfers(*bridge_);
+  std::vector<outgoing_transfer> result;
+  result.reserve(rust_transfers.size());
+  std::ranges::transform(rust_transfers, std::back_inserter(result), to_outgoing_transfer);
+  return result;
+}
+
+auto bridge::create_transfer_chunk_frame(const std::string &transfer_id,
+  std::uint32_t chunk_index,
+  std::uint64_t timestamp,
+  const std::string &version) const -> signed_event_frame
+{
+  const std::scoped_lock lock(*mutex_);
+  return to_signed_event_frame(
+    radix_relay::create_transfer_chunk_frame(*bridge_, transfer_id.c_str(), chunk_index, timestamp, version.c_str()));
+}
+
+auto bridge::mark_transfer_chunk_delivered(const std::string &transfer_id, std::uint32_t chunk_index) const -> bool
+{
+  const std::scoped_lock lock(*mutex_);
+  return radix_relay::mark_transfer_chunk_delivered(*bridge_, transfer_id.c_str(), chunk_index);
+}
+
+auto bridge::process_transfer_chunk(const std::string &rdx, const std::vector<uint8_t> &bytes) const
+  -> transfer_progress
+{
+  const std::scoped_lock lock(*mutex_);
+  auto result = radix_relay::process_transfer_chunk(
+    *bridge_, rdx.c_str(), rust::Slice<const uint8_t>{ bytes.data(), bytes.size() });
+  return {
+    .transfer_id = std::string(result.transfer_id),
+    .name = std::string(result.name),
+    .sender_rdx = std::string(result.sender_rdx),
+    .received_chunks = result.received_chunks,
+    .chunk_count = result.chunk_count,
+    .complete = result.complete,
+    .path = std::string(result.path),
+  };
+}
+
+auto bridge::message_subscription(std::uint64_t since_timestamp) const -> signal::message_subscription
+{
+  const std::scoped_lock lock(*mutex_);
+  auto subscription = radix_relay::message_subscription(*bridge_, since_timestamp);
+  std::vector<std::string> group_ids;
+  group_ids.reserve(subscription.group_ids.size());
+  std::ranges::transform(subscription.group_ids, std::back_inserter(group_ids), [](const rust::String &group_id) {
+    return std::string(group_id);
+  });
+  return { .our_pubkey = std::string(subscription.our_pubkey),
+    .group_ids = std::move(group_ids),
+    .since = subscription.since };
 }
 
 auto bridge::update_last_message_timestamp(std::uint64_t timestamp) const -> void
 {
+  const std::scoped_lock lock(*mutex_);
   radix_relay::update_last_message_timestamp(*bridge_, timestamp);
 }
 
+auto bridge::verify_events(const std::vector<std::string> &event_jsons) const -> std::vector<bool>
+{
+  rust::Vec<rust::String> rust_events;
+  rust_events.reserve(event_jsons.size());
+  for (const auto &event_json : event_jsons) { rust_events.emplace_back(event_json); }
+
+  auto verified = radix_relay::verify_events(std::move(rust_events));
+  return { verified.begin(), verified.end() };
+}
+
 auto bridge::perform_key_maintenance() const -> signal::key_maintenance_result
 {
-  const radix_relay::KeyMaintenanceResult rust_result = radix_relay::perform_key_maintenance(*bridge_);
+  radix_relay::KeyMaintenancePlan plan{};
+  {
+    const std::scoped_lock lock(*mutex_);
+    plan = radix_relay::plan_key_maintenance(*bridge_);
+  }
+
+  // Claiming may generate key pairs, so other calls can use the bridge in the meantime
+  const auto keys = radix_relay::claim_maintenance_keys(*key_factory_, plan);
+
+  const std::scoped_lock lock(*mutex_);
+  const radix_relay::KeyMaintenanceResult rust_result = radix_relay::apply_key_maintenance(*bridge_, plan, *keys);
   return {
     .signed_pre_key_rotated = rust_result.signed_pre_key_rotated,
     .kyber_pre_key_rotated = rust_result.kyber_pre_key_rotated,
@@ -134,11 +454,13 @@ auto bridge::record_published_bundle(std::uint32_t pre_key_id,
   std::uint32_t signed_pre_key_id,
   std::uint32_t kyber_pre_key_id) const -> void
 {
+  const std::scoped_lock lock(*mutex_);
   radix_relay::record_published_bundle(*bridge_, pre_key_id, signed_pre_key_id, kyber_pre_key_id);
 }
 
 auto bridge::get_conversations(bool include_archived) const -> std::vector<conversation>
 {
+  const std::scoped_lock lock(*mutex_);
   auto rust_conversations = radix_relay::get_conversations(*bridge_, include_archived);
   std::vector<conversation> result;
   result.reserve(rust_conversations.size());
@@ -160,6 +482,7 @@ auto bridge::get_conversation_messages(const std::string &rdx_fingerprint,
   std::uint32_t limit,
   std::uint32_t offset) const -> std::vector<stored_message>
 {
+  const std::scoped_lock lock(*mutex_);
   auto rust_messages = radix_relay::get_conversation_messages(*bridge_, rdx_fingerprint.c_str(), limit, offset);
   std::vector<stored_message> result;
   result.reserve(rust_messages.size());
@@ -183,27 +506,32 @@ auto bridge::get_conversation_messages(const std::string &rdx_fingerprint,
 
 auto bridge::mark_conversation_read(const std::string &rdx_fingerprint) const -> void
 {
+  const std::scoped_lock lock(*mutex_);
   radix_relay::mark_conversation_read(*bridge_, rdx_fingerprint.c_str());
 }
 
 auto bridge::mark_conversation_read_up_to(const std::string &rdx_fingerprint, std::uint64_t up_to_timestamp) const
   -> void
 {
+  const std::scoped_lock lock(*mutex_);
   radix_relay::mark_conversation_read_up_to(*bridge_, rdx_fingerprint.c_str(), up_to_timestamp);
 }
 
 auto bridge::delete_message(std::int64_t message_id) const -> void
 {
+  const std::scoped_lock lock(*mutex_);
   radix_relay::delete_message(*bridge_, message_id);
 }
 
 auto bridge::delete_conversation(const std::string &rdx_fingerprint) const -> void
 {
+  const std::scoped_lock lock(*mutex_);
   radix_relay::delete_conversation(*bridge_, rdx_fingerprint.c_str());
 }
 
 auto bridge::get_unread_count(const std::string &rdx_fingerprint) const -> std::uint32_t
 {
+  const std::scoped_lock lock(*mutex_);
   return radix_relay::get_unread_count(*bridge_, rdx_fingerprint.c_str());
 }
 
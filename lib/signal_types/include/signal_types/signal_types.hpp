@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <signal_bridge_cxx/lib.h>
 #include <string>
@@ -31,6 +32,28 @@ struct decryption_result
   bool should_republish_bundle;///< Whether sender exhausted our prekeys
 };
 
+/**
+ * @brief Group and sender of a processed sender key distribution.
+ */
+struct group_membership
+{
+  std::string group_id;///< Sender key distribution ID identifying the group
+  std::string name;///< Human-readable group name
+  std::string sender_rdx;///< RDX fingerprint of the member whose sender key was received
+  bool should_republish_bundle;///< Whether sender exhausted our prekeys
+};
+
+/**
+ * @brief Result of decrypting a received group message.
+ */
+struct group_decryption_result
+{
+  std::string group_id;///< Sender key distribution ID identifying the group
+  std::string name;///< Human-readable group name
+  std::string sender_rdx;///< RDX fingerprint of the sender
+  std::vector<uint8_t> plaintext;///< Decrypted message content
+};
+
 /**
  * @brief Information about a generated prekey bundle.
  */
@@ -40,6 +63,75 @@ struct bundle_info
   std::uint32_t pre_key_id;///< One-time prekey ID included in bundle
   std::uint32_t signed_pre_key_id;///< Signed prekey ID included in bundle
   std::uint32_t kyber_pre_key_id;///< Kyber PQ prekey ID included in bundle
+  std::string event_id;///< Nostr event ID of the signed announcement
+  std::vector<std::byte> frame;///< Wire-ready ["EVENT", {...}] frame for the announcement
+};
+
+/**
+ * @brief A signed Nostr event serialized as a client EVENT frame.
+ */
+struct signed_event_frame
+{
+  std::string event_id;///< Nostr event ID
+  std::vector<std::byte> bytes;///< Wire-ready ["EVENT", {...}] frame
+};
+
+/**
+ * @brief One recipient's share of a multi-recipient send.
+ */
+struct fan_out_frame
+{
+  std::string recipient;///< Recipient as given by the caller
+  std::string event_id;///< Nostr event ID, empty when the recipient was skipped
+  std::vector<std::byte> bytes;///< Wire-ready ["EVENT", {...}] frame, empty when the recipient was skipped
+  std::string error;///< Why the recipient was skipped, empty on success
+};
+
+/**
+ * @brief Sender-side state of a chunked file transfer.
+ */
+struct outgoing_transfer
+{
+  std::string transfer_id;///< Random transfer identifier
+  std::string peer_rdx;///< RDX fingerprint of the recipient
+  std::string name;///< File name sent to the recipient
+  std::uint32_t chunk_count;///< Number of chunks in the transfer
+  std::vector<std::uint32_t> pending_chunks;///< Chunks no relay has accepted yet, in order
+};
+
+/**
+ * @brief Receiver-side progress of a chunked file transfer.
+ */
+struct transfer_progress
+{
+  std::string transfer_id;///< Random transfer identifier
+  std::string name;///< File name
+  std::string sender_rdx;///< RDX fingerprint of the sender
+  std::uint32_t received_chunks;///< Chunks received so far
+  std::uint32_t chunk_count;///< Number of chunks in the transfer
+  bool complete;///< Whether the file is complete and verified
+  std::string path;///< Where the file is saved once complete
+};
+
+/**
+ * @brief A discovered bundle announcement kept in the identity database.
+ */
+struct cached_bundle
+{
+  std::string nostr_pubkey;///< Nostr public key of the announcing node
+  std::string rdx_fingerprint;///< RDX fingerprint of the bundle, empty if not yet extracted
+  std::string event_id;///< Nostr event ID of the announcement
+  std::uint64_t created_at;///< Announcement timestamp
+};
+
+/**
+ * @brief What a node subscribes to in order to receive its messages.
+ */
+struct message_subscription
+{
+  std::string our_pubkey;///< Nostr public key (hex) pairwise events are addressed to
+  std::vector<std::string> group_ids;///< Distribution IDs of the groups this node belongs to
+  std::uint64_t since;///< Timestamp to receive events since, 0 for no lower bound
 };
 
 /**
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace radix_relay::transport {
+
+/**
+ * @brief Splits messages into MTU-sized BLE writes and joins them back together.
+ *
+ * Every fragment starts with a one-byte header: ble_more_fragments when more of the same
+ * message follows, ble_last_fragment on the final fragment. A message that fits in one
+ * write costs a single extra byte.
+ */
+inline constexpr std::byte ble_last_fragment{ 0x00 };
+inline constexpr std::byte ble_more_fragments{ 0x01 };
+
+/// Largest message the reassembler accepts before discarding a partial message
+inline constexpr std::size_t ble_max_message_size = 256 * 1024;
+
+/**
+ * @brief Splits a message into fragments of at most mtu bytes, header included.
+ *
+ * @param message Message to split
+ * @param mtu Largest write the link accepts; must be at least 2
+ * @return Fragments in sending order
+ */
+[[nodiscard]] auto fragment_ble_message(std::span<const std::byte> message, std::size_t mtu)
+  -> std::vector<std::vector<std::byte>>;
+
+/**
+ * @brief Rebuilds messages from fragments received in order.
+ */
+class ble_reassembler
+{
+public:
+  /**
+   * @brief Adds one received fragment.
+   *
+   * Empty fragments and unknown headers discard the partial message. A message growing past
+   * ble_max_message_size is dropped along with the rest of its fragments.
+   *
+   * @param fragment Fragment as received from the link
+   * @return The complete message once its last fragment arrives
+   */
+  [[nodiscard]] auto push(std::span<const std::byte> fragment) -> std::optional<std::vector<std::byte>>;
+
+  /**
+   * @brief Discards any partial message, e.g. after the link drops.
+   */
+  auto reset() -> void;
+
+private:
+  std::vector<std::byte> partial_;
+  bool discarding_{ false };
+};
+
+}// namespace radix_relay::transport
@@ -1,12 +1,14 @@
 #pragma once
 
 #include <concepts/transport_stream.hpp>
+#include <transport/ble_framing.hpp>
 
 #include <boost/asio.hpp>
 #include <boost/system/error_code.hpp>
 #include <simpleble/SimpleBLE.h>
 
 #include <cstddef>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -56,12 +58,15 @@ private:
   std::string rx_characteristic_uuid_;
   std::string service_uuid_;
 
-  std::vector<std::byte> read_buffer_;
+  ble_reassembler reassembler_;
+  std::deque<std::vector<std::byte>> received_messages_;
+  boost::asio::mutable_buffer pending_read_buffer_;
   std::function<void(const boost::system::error_code &, std::size_t)> pending_read_handler_;
 
   static auto find_adapter() -> std::optional<SimpleBLE::Adapter>;
   auto find_peripheral(const std::string &address) -> std::optional<SimpleBLE::Peripheral>;
   auto setup_notification_callback() -> void;
+  auto deliver_pending_read() -> void;
 };
 
 static_assert(concepts::transport_stream<ble_stream>);
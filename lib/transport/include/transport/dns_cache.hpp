@@ -0,0 +1,89 @@
+#pragma once
+
+#include <boost/asio/ip/tcp.hpp>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace radix_relay::transport {
+
+/**
+ * @brief Resolved relay addresses shared by the connections of a process.
+ *
+ * getaddrinfo does not report record TTLs, so every entry lives for one fixed TTL. An entry
+ * whose addresses all failed to connect should be forgotten, which makes the next attempt
+ * resolve the host again instead of waiting out the TTL on addresses that moved.
+ */
+class dns_cache
+{
+public:
+  using clock = std::chrono::steady_clock;
+  using endpoints_t = std::vector<boost::asio::ip::tcp::endpoint>;
+
+  static constexpr std::chrono::seconds default_ttl{ 300 };///< Lifetime of a cached resolution
+
+  /**
+   * @brief Returns the process-wide cache.
+   *
+   * @return Shared cache
+   */
+  [[nodiscard]] static auto shared() -> const std::shared_ptr<dns_cache> &;
+
+  /**
+   * @brief Creates an empty cache.
+   *
+   * @param ttl Lifetime of each cached resolution
+   */
+  explicit dns_cache(std::chrono::seconds ttl = default_ttl);
+
+  /**
+   * @brief Returns the cached addresses of a host, if still fresh.
+   *
+   * @param host Host name
+   * @param port Port or service name
+   * @param now Current time
+   * @return Addresses in resolver order, or nullopt if absent or expired
+   */
+  [[nodiscard]] auto lookup(const std::string &host,
+    const std::string &port,
+    clock::time_point now = clock::now()) const -> std::optional<endpoints_t>;
+
+  /**
+   * @brief Caches the addresses a host resolved to.
+   *
+   * @param host Host name
+   * @param port Port or service name
+   * @param endpoints Resolved addresses in resolver order
+   * @param now Time of the resolution
+   */
+  auto store(const std::string &host,
+    const std::string &port,
+    endpoints_t endpoints,
+    clock::time_point now = clock::now()) -> void;
+
+  /**
+   * @brief Drops the cached addresses of a host.
+   *
+   * @param host Host name
+   * @param port Port or service name
+   */
+  auto forget(const std::string &host, const std::string &port) -> void;
+
+private:
+  struct entry
+  {
+    endpoints_t endpoints;
+    clock::time_point expires;
+  };
+
+  std::chrono::seconds ttl_;
+  mutable std::mutex mutex_;
+  std::map<std::pair<std::string, std::string>, entry> entries_;
+};
+
+}// namespace radix_relay::transport
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+namespace radix_relay::transport {
+
+/// Delay between starting connection attempts (RFC 8305 section 5 recommends 250 ms)
+constexpr std::chrono::milliseconds connection_attempt_delay{ 250 };
+
+/**
+ * @brief Orders addresses for connection attempts per RFC 8305 section 4.
+ *
+ * Alternates address families, starting with the family of the first address. The order
+ * within each family is kept, since the resolver already sorted it by RFC 6724 preference.
+ *
+ * @param endpoints Addresses in resolver order
+ * @return The same addresses, families interleaved
+ */
+[[nodiscard]] auto interleave_address_families(const std::vector<boost::asio::ip::tcp::endpoint> &endpoints)
+  -> std::vector<boost::asio::ip::tcp::endpoint>;
+
+/**
+ * @brief Completion handler of a connection race.
+ *
+ * Receives the error, the connected socket and the address it connected to. On error the
+ * socket is closed and the address is default constructed.
+ */
+using happy_eyeballs_handler = std::function<
+  void(const boost::system::error_code &, boost::asio::ip::tcp::socket, const boost::asio::ip::tcp::endpoint &)>;
+
+/**
+ * @brief Connects to the first address that answers, racing them per RFC 8305.
+ *
+ * Attempts start in interleaved family order, one every attempt delay, or straight away
+ * when the previous attempt fails. The first attempt to connect wins and the others are
+ * closed, so a dead IPv6 route costs one attempt delay rather than a full TCP timeout.
+ *
+ * @param executor Executor the sockets and timers run on
+ * @param endpoints Addresses in resolver order
+ * @param attempt_delay Time to wait for an attempt before starting the next
+ * @param timeout Time after which the whole race fails with timed_out
+ * @param handler Called once with the outcome
+ */
+auto async_happy_eyeballs_connect(const boost::asio::any_io_executor &executor,
+  const std::vector<boost::asio::ip::tcp::endpoint> &endpoints,
+  std::chrono::milliseconds attempt_delay,
+  std::chrono::milliseconds timeout,
+  happy_eyeballs_handler handler) -> void;
+
+}// namespace radix_relay::transport
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <boost/asio/ssl.hpp>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace radix_relay::transport {
+
+/**
+ * @brief TLS client configuration shared by the connections of a process.
+ *
+ * Wraps one `ssl::context` that negotiates TLS 1.2 or 1.3 and verifies peers against the
+ * system CA store, which is therefore loaded once rather than per connection. Sessions the
+ * server hands out (TLS 1.3 tickets or TLS 1.2 session IDs) are cached per host name, and the
+ * next connection to that host offers the newest one so it can resume with an abbreviated
+ * handshake instead of a full key exchange and certificate check.
+ */
+class tls_client_context
+{
+public:
+  /**
+   * @brief Returns the process-wide context, loading the system CA store on first use.
+   *
+   * @return Shared context
+   */
+  [[nodiscard]] static auto shared() -> const std::shared_ptr<tls_client_context> &;
+
+  /**
+   * @brief Creates a context with its own session cache.
+   *
+   * @param load_default_verify_paths Trust the system CA store; without it only certificate
+   *        authorities added to context() are trusted
+   */
+  explicit tls_client_context(bool load_default_verify_paths = true);
+
+  tls_client_context(const tls_client_context &) = delete;
+  auto operator=(const tls_client_context &) -> tls_client_context & = delete;
+  tls_client_context(tls_client_context &&) = delete;
+  auto operator=(tls_client_context &&) -> tls_client_context & = delete;
+  ~tls_client_context() = default;
+
+  /**
+   * @brief Returns the underlying context for constructing SSL streams.
+   *
+   * @return Boost.Asio SSL context
+   */
+  [[nodiscard]] auto context() -> boost::asio::ssl::context & { return context_; }
+
+  /**
+   * @brief Prepares a new SSL connection to a host before its handshake.
+   *
+   * Sets SNI, which is also the key the session is cached under, and offers the cached
+   * session for the host if there is one.
+   *
+   * @param ssl Native handle of a stream created from context()
+   * @param host Server host name
+   * @return false if SNI could not be set
+   */
+  auto prepare(SSL *ssl, const std::string &host) -> bool;
+
+  /**
+   * @brief Returns the number of hosts with a cached session.
+   *
+   * @return Cached session count
+   */
+  [[nodiscard]] auto cached_sessions() const -> std::size_t;
+
+private:
+  struct session_deleter
+  {
+    auto operator()(SSL_SESSION *session) const -> void { SSL_SESSION_free(session); }
+  };
+
+  static auto on_new_session(SSL *ssl, SSL_SESSION *session) -> int;
+
+  boost::asio::ssl::context context_;
+  mutable std::mutex sessions_mutex_;
+  std::unordered_map<std::string, std::unique_ptr<SSL_SESSION, session_deleter>> sessions_;
+};
+
+}// namespace radix_relay::transport
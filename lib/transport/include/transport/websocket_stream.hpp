@@ -1,5 +1,6 @@
 #pragma once
 
+#include <concepts/transport_stream.hpp>
 
 #include <boost/asio.hpp>
 #include <boost/asio/ssl.hpp>
@@ -7,10 +8,17 @@
 #include <boost/beast/ssl.hpp>
 #include <boost/beast/websocket.hpp>
 #include <boost/beast/websocket/ssl.hpp>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <span>
+#include <string>
 #include <string_view>
+#include <transport/dns_cache.hpp>
+#include <transport/happy_eyeballs.hpp>
+#include <transport/tls_client_context.hpp>
 
 namespace radix_relay::transport {
 
@@ -24,10 +32,46 @@ struct websocket_connection_params
   std::string_view path;///< WebSocket path (e.g., "/" or "/api/v1")
 };
 
+/**
+ * @brief permessage-deflate (RFC 7692) settings offered to the server.
+ *
+ * The same window and context takeover settings are asked for both directions. Compression
+ * only happens if the server accepts the offer.
+ */
+struct websocket_compression
+{
+  static constexpr int max_window_bits = 15;///< Largest LZ77 window zlib supports
+  static constexpr int default_memory_level = 4;///< Beast's default zlib memory level
+
+  bool enabled{ true };///< Offer permessage-deflate; off saves CPU on constrained nodes
+  int window_bits{ max_window_bits };///< LZ77 window as a power of two, 9 to 15
+  int memory_level{ default_memory_level };///< zlib memory level, 1 to 9; lower uses less memory
+  bool no_context_takeover{ false };///< Compress each message on its own, trading ratio for memory
+};
+
+/**
+ * @brief Bytes moved over the current connection since its WebSocket upgrade.
+ */
+struct websocket_traffic
+{
+  std::uint64_t message_bytes_sent{ 0 };///< Message payload written, before compression
+  std::uint64_t message_bytes_received{ 0 };///< Message payload read, after decompression
+  std::uint64_t wire_bytes_sent{ 0 };///< TLS records written, after compression and framing
+  std::uint64_t wire_bytes_received{ 0 };///< TLS records read
+};
+
 /**
  * @brief WebSocket stream with TLS support.
  *
  * Provides asynchronous operations for secure WebSocket connections using Boost.Beast.
+ * Every connection gets a fresh TLS stream from the shared client context, so reconnecting
+ * to a relay resumes the TLS session of the previous connection.
+ *
+ * Host names are resolved through the shared DNS cache, and the TCP connection goes to
+ * whichever resolved address answers first, IPv6 and IPv4 attempts raced per RFC 8305.
+ *
+ * Unless disabled, permessage-deflate is offered in the upgrade. Message bytes are counted
+ * before compression and TLS record bytes after it, so the two show what compression saves.
  */
 class websocket_stream
 {
@@ -36,29 +80,114 @@ public:
 
 private:
   static constexpr int connection_timeout_seconds = 30;
+  static constexpr int document_timeout_seconds = 10;
+  static constexpr std::uint64_t document_body_limit = 64 * 1024;
+
+  using websocket_t = boost::beast::websocket::stream<boost::beast::ssl_stream<boost::beast::tcp_stream>>;
+  using tcp_handler = std::function<void(const boost::system::error_code &, boost::asio::ip::tcp::socket)>;
 
-  boost::asio::ssl::context ssl_context_;
+  websocket_compression compression_;
+  std::shared_ptr<tls_client_context> tls_;
+  std::shared_ptr<dns_cache> dns_;
+  boost::asio::strand<boost::asio::io_context::executor_type> strand_;
   boost::asio::ip::tcp::resolver resolver_;
-  boost::beast::websocket::stream<boost::beast::ssl_stream<boost::beast::tcp_stream>> ws_;
+  std::unique_ptr<websocket_t> ws_;
   boost::beast::flat_buffer read_buffer_;
+  boost::beast::websocket::ping_data ping_payload_;
+  std::uint64_t pings_sent_{ 0 };
+  std::function<void(const boost::system::error_code &)> pong_handler_;
+  websocket_traffic messages_;
+  websocket_traffic wire_baseline_;
+  std::size_t pending_operations_{ 0 };
+  std::function<void()> drained_handler_;
+
+  /**
+   * @brief Opens a TCP connection to a host through the DNS cache and a connection race.
+   *
+   * @param host Host name
+   * @param port Port or service name
+   * @param timeout Time allowed for the whole race
+   * @param handler Completion handler called with error code and connected socket
+   */
+  auto async_open_tcp(const std::string &host,
+    const std::string &port,
+    std::chrono::milliseconds timeout,
+    tcp_handler handler) -> void;
+
+  /**
+   * @brief Races connections to resolved addresses, forgetting them if none answers.
+   *
+   * @param host Host name the addresses belong to
+   * @param port Port or service name
+   * @param endpoints Addresses in resolver order
+   * @param timeout Time allowed for the whole race
+   * @param handler Completion handler called with error code and connected socket
+   */
+  auto race_endpoints(const std::string &host,
+    const std::string &port,
+    const dns_cache::endpoints_t &endpoints,
+    std::chrono::milliseconds timeout,
+    tcp_handler handler) -> void;
+
+  /**
+   * @brief Replaces the WebSocket stream and connects the new one.
+   *
+   * @param host Host name
+   * @param port Port or service name
+   * @param path WebSocket path
+   * @param handler Completion handler called with error code and bytes transferred
+   */
+  auto open_websocket(const std::string &host,
+    const std::string &port,
+    const std::string &path,
+    std::function<void(const boost::system::error_code &, std::size_t)> handler) -> void;
+
+  /**
+   * @brief Counts a read, write, ping or close as finished, resuming a connect waiting on them.
+   */
+  auto finish_operation() -> void;
 
 public:
   /**
    * @brief Constructs a WebSocket stream.
    *
    * @param io_context Boost.Asio io_context for async operations
+   * @param compression permessage-deflate settings offered on every connection
+   * @param tls TLS client context holding the trust store and cached sessions
+   * @param dns Cache of resolved relay addresses
    */
-  explicit websocket_stream(const std::shared_ptr<boost::asio::io_context> &io_context);
+  explicit websocket_stream(const std::shared_ptr<boost::asio::io_context> &io_context,
+    websocket_compression compression = {},
+    std::shared_ptr<tls_client_context> tls = tls_client_context::shared(),
+    std::shared_ptr<dns_cache> dns = dns_cache::shared());
 
   /**
    * @brief Asynchronously connects to a WebSocket endpoint.
    *
+   * Reads, writes, pings and closes still pending on a previous connection are aborted first,
+   * and the new connection starts once their handlers have run. A connect already waiting for
+   * that fails with `already_started`.
+   *
    * @param params Connection parameters (host, port, path)
    * @param handler Completion handler called with error code and bytes transferred
    */
   auto async_connect(websocket_connection_params params,
     std::function<void(const boost::system::error_code &, std::size_t)> handler) -> void;
 
+  /**
+   * @brief Asynchronously fetches a document from the endpoint over HTTPS.
+   *
+   * Opens a separate TLS connection, sends `GET path` with the given Accept header and
+   * hands back the body of a 200 response. The WebSocket connection is not affected.
+   *
+   * @param params Endpoint to fetch from (host, port, path)
+   * @param accept Value of the Accept header (e.g. "application/nostr+json")
+   * @param handler Completion handler called with error code and response body
+   */
+  auto async_fetch_document(websocket_connection_params params,
+    std::string_view accept,
+    std::function<void(const boost::system::error_code &, std::string)> handler) -> void;
+
   /**
    * @brief Asynchronously writes data to the WebSocket.
    *
@@ -77,13 +206,33 @@ public:
   auto async_read(const boost::asio::mutable_buffer &buffer,
     std::function<void(const boost::system::error_code &, std::size_t)> handler) -> void;
 
+  /**
+   * @brief Sends a WebSocket ping and waits for the matching pong.
+   *
+   * The pong arrives through the read loop, so a read must be pending for the handler to run.
+   * A new ping replaces one still waiting for its pong, which then never completes.
+   *
+   * @param handler Completion handler called once the pong arrives or the ping fails
+   */
+  auto async_ping(std::function<void(const boost::system::error_code &)> handler) -> void;
+
   /**
    * @brief Asynchronously closes the WebSocket connection.
    *
    * @param handler Completion handler called with error code and bytes transferred
    */
   auto async_close(std::function<void(const boost::system::error_code &, std::size_t)> handler) -> void;
+
+  /**
+   * @brief Returns the bytes moved over the current connection.
+   *
+   * @return Counters since the WebSocket upgrade, zero before the first connection
+   */
+  [[nodiscard]] auto traffic() -> websocket_traffic;
 };
 
+static_assert(concepts::document_fetching_stream<websocket_stream>);
+static_assert(concepts::pinging_stream<websocket_stream>);
+static_assert(concepts::traffic_counting_stream<websocket_stream>);
 
 }// namespace radix_relay::transport
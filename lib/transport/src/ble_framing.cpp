@@ -0,0 +1,65 @@
+#include <transport/ble_framing.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace radix_relay::transport {
+
+namespace {
+  constexpr std::size_t header_size = 1;
+}// namespace
+
+auto fragment_ble_message(std::span<const std::byte> message, std::size_t mtu) -> std::vector<std::vector<std::byte>>
+{
+  if (mtu <= header_size) { throw std::invalid_argument("BLE MTU too small for fragmentation"); }
+
+  const auto payload_size = mtu - header_size;
+  std::vector<std::vector<std::byte>> fragments;
+  fragments.reserve(std::max<std::size_t>(1, (message.size() + payload_size - 1) / payload_size));
+
+  std::size_t offset = 0;
+  do {
+    const auto length = std::min(payload_size, message.size() - offset);
+    const bool last = offset + length == message.size();
+
+    std::vector<std::byte> fragment;
+    fragment.reserve(header_size + length);
+    fragment.push_back(last ? ble_last_fragment : ble_more_fragments);
+    const auto chunk = message.subspan(offset, length);
+    fragment.insert(fragment.end(), chunk.begin(), chunk.end());
+    fragments.push_back(std::move(fragment));
+
+    offset += length;
+  } while (offset < message.size());
+
+  return fragments;
+}
+
+auto ble_reassembler::push(std::span<const std::byte> fragment) -> std::optional<std::vector<std::byte>>
+{
+  if (fragment.empty() or (fragment.front() != ble_last_fragment and fragment.front() != ble_more_fragments)) {
+    reset();
+    return std::nullopt;
+  }
+
+  const bool last = fragment.front() == ble_last_fragment;
+  if (discarding_ or partial_.size() + fragment.size() - header_size > ble_max_message_size) {
+    partial_.clear();
+    discarding_ = not last;
+    return std::nullopt;
+  }
+
+  partial_.insert(partial_.end(), fragment.begin() + header_size, fragment.end());
+  if (not last) { return std::nullopt; }
+
+  return std::exchange(partial_, {});
+}
+
+auto ble_reassembler::reset() -> void
+{
+  partial_.clear();
+  discarding_ = false;
+}
+
+}// namespace radix_relay::transport
@@ -1,6 +1,7 @@
 #include <transport/ble_stream.hpp>
 
 #include <algorithm>
+#include <utility>
 
 namespace radix_relay::transport {
 
@@ -45,21 +46,34 @@ auto ble_stream::setup_notification_callback() -> void
   if (not peripheral_ or not peripheral_->is_connected()) { return; }
 
   peripheral_->notify(service_uuid_, rx_characteristic_uuid_, [this](const SimpleBLE::ByteArray &data) {
-    read_buffer_.clear();
-    read_buffer_.reserve(data.size());
+    std::vector<std::byte> fragment;
+    fragment.reserve(data.size());
     std::ranges::transform(
-      data, std::back_inserter(read_buffer_), [](auto byte) { return static_cast<std::byte>(byte); });
+      data, std::back_inserter(fragment), [](auto byte) { return static_cast<std::byte>(byte); });
 
-    if (pending_read_handler_) {
-      auto handler = std::move(pending_read_handler_);
-      pending_read_handler_ = nullptr;
+    boost::asio::post(strand_, [this, fragment = std::move(fragment)]() {
+      auto message = reassembler_.push(fragment);
+      if (not message) { return; }
 
-      boost::asio::post(
-        strand_, [handler = std::move(handler), size = data.size()]() { handler(boost::system::error_code{}, size); });
-    }
+      received_messages_.push_back(std::move(*message));
+      deliver_pending_read();
+    });
   });
 }
 
+auto ble_stream::deliver_pending_read() -> void
+{
+  if (not pending_read_handler_ or received_messages_.empty()) { return; }
+
+  auto handler = std::exchange(pending_read_handler_, nullptr);
+  const auto &message = received_messages_.front();
+  const auto bytes_to_copy = std::min(boost::asio::buffer_size(pending_read_buffer_), message.size());
+  std::copy_n(message.begin(), bytes_to_copy, static_cast<std::byte *>(pending_read_buffer_.data()));
+  received_messages_.pop_front();
+
+  handler(boost::system::error_code{}, bytes_to_copy);
+}
+
 auto ble_stream::async_connect(ble_connection_params params,
   std::function<void(const boost::system::error_code &, std::size_t)> handler) -> void
 {
@@ -120,20 +134,20 @@ auto ble_stream::async_write(std::span<const std::byte> data,
     return;
   }
 
-  if (data.size() > mtu_) {
-    boost::asio::post(
-      strand_, [handler]() { handler(boost::system::error_code{ boost::asio::error::message_size }, 0); });
-    return;
+  std::vector<SimpleBLE::ByteArray> ble_fragments;
+  for (const auto &fragment : fragment_ble_message(data, mtu_)) {
+    auto &ble_data = ble_fragments.emplace_back();
+    ble_data.reserve(fragment.size());
+    std::ranges::transform(fragment, std::back_inserter(ble_data), [](auto byte) {
+      return static_cast<char>(static_cast<unsigned char>(byte));
+    });
   }
 
-  SimpleBLE::ByteArray ble_data;
-  ble_data.reserve(data.size());
-  std::ranges::transform(
-    data, std::back_inserter(ble_data), [](auto byte) { return static_cast<char>(static_cast<unsigned char>(byte)); });
-
-  boost::asio::post(strand_, [this, ble_data = std::move(ble_data), handler, size = data.size()]() {
+  boost::asio::post(strand_, [this, ble_fragments = std::move(ble_fragments), handler, size = data.size()]() {
     try {
-      peripheral_->write_request(service_uuid_, tx_characteristic_uuid_, ble_data);
+      for (const auto &ble_data : ble_fragments) {
+        peripheral_->write_request(service_uuid_, tx_characteristic_uuid_, ble_data);
+      }
       handler(boost::system::error_code{}, size);
     } catch (const std::exception &) {
       handler(boost::system::error_code{ boost::asio::error::operation_aborted }, 0);
@@ -150,16 +164,11 @@ auto ble_stream::async_read(const boost::asio::mutable_buffer &buffer,
     return;
   }
 
-  if (not read_buffer_.empty()) {
-    const auto bytes_to_copy = std::min(boost::asio::buffer_size(buffer), read_buffer_.size());
-    std::copy_n(read_buffer_.begin(), bytes_to_copy, static_cast<std::byte *>(buffer.data()));
-    read_buffer_.clear();
-
-    boost::asio::post(strand_, [handler, bytes_to_copy]() { handler(boost::system::error_code{}, bytes_to_copy); });
-    return;
-  }
-
-  pending_read_handler_ = handler;
+  boost::asio::post(strand_, [this, buffer, handler]() {
+    pending_read_buffer_ = buffer;
+    pending_read_handler_ = handler;
+    deliver_pending_read();
+  });
 }
 
 auto ble_stream::async_close(std::function<void(const boost::system::error_code &, std::size_t)> handler) -> void
@@ -168,6 +177,8 @@ auto ble_stream::async_close(std::function<void(const boost::system::error_code
     try {
       if (peripheral_ and peripheral_->is_connected()) { peripheral_->disconnect(); }
       connected_ = false;
+      reassembler_.reset();
+      received_messages_.clear();
       peripheral_.reset();
       adapter_.reset();
       handler(boost::system::error_code{}, 0);
@@ -0,0 +1,36 @@
+#include <transport/dns_cache.hpp>
+
+namespace radix_relay::transport {
+
+auto dns_cache::shared() -> const std::shared_ptr<dns_cache> &
+{
+  static const auto cache = std::make_shared<dns_cache>();
+  return cache;
+}
+
+dns_cache::dns_cache(std::chrono::seconds ttl) : ttl_(ttl) {}
+
+auto dns_cache::lookup(const std::string &host, const std::string &port, clock::time_point now) const
+  -> std::optional<endpoints_t>
+{
+  const std::scoped_lock lock(mutex_);
+  const auto cached = entries_.find({ host, port });
+  if (cached == entries_.end() or now >= cached->second.expires) { return std::nullopt; }
+  return cached->second.endpoints;
+}
+
+auto dns_cache::store(const std::string &host, const std::string &port, endpoints_t endpoints, clock::time_point now)
+  -> void
+{
+  if (endpoints.empty()) { return; }
+  const std::scoped_lock lock(mutex_);
+  entries_.insert_or_assign({ host, port }, entry{ .endpoints = std::move(endpoints), .expires = now + ttl_ });
+}
+
+auto dns_cache::forget(const std::string &host, const std::string &port) -> void
+{
+  const std::scoped_lock lock(mutex_);
+  entries_.erase({ host, port });
+}
+
+}// namespace radix_relay::transport
@@ -0,0 +1,157 @@
+#include <transport/happy_eyeballs.hpp>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace radix_relay::transport {
+
+namespace {
+
+  /// State of one connection race, shared by its completion handlers
+  class connect_race : public std::enable_shared_from_this<connect_race>
+  {
+  public:
+    connect_race(const boost::asio::any_io_executor &executor,
+      std::vector<boost::asio::ip::tcp::endpoint> endpoints,
+      std::chrono::milliseconds attempt_delay,
+      happy_eyeballs_handler handler)
+      : executor_(executor), endpoints_(std::move(endpoints)), attempt_delay_(attempt_delay),
+        handler_(std::move(handler)), stagger_(executor), deadline_(executor)
+    {
+      // Sockets with a connect in flight must not move
+      attempts_.reserve(endpoints_.size());
+    }
+
+    auto start(std::chrono::milliseconds timeout) -> void
+    {
+      deadline_.expires_after(timeout);
+      deadline_.async_wait([self = shared_from_this()](const boost::system::error_code &error) -> void {
+        if (not error) { self->fail(boost::asio::error::timed_out); }
+      });
+      launch_next();
+    }
+
+  private:
+    auto launch_next() -> void
+    {
+      if (done_ or next_ == endpoints_.size()) { return; }
+
+      const auto index = next_++;
+      attempts_.emplace_back(executor_);
+      ++in_flight_;
+      attempts_.at(index).async_connect(
+        endpoints_.at(index), [self = shared_from_this(), index](const boost::system::error_code &error) -> void {
+          self->on_attempt(index, error);
+        });
+
+      if (next_ < endpoints_.size()) {
+        stagger_.expires_after(attempt_delay_);
+        stagger_.async_wait([self = shared_from_this()](const boost::system::error_code &error) -> void {
+          if (not error) { self->launch_next(); }
+        });
+      }
+    }
+
+    auto on_attempt(std::size_t index, const boost::system::error_code &error) -> void
+    {
+      --in_flight_;
+      if (done_) { return; }
+
+      if (not error) {
+        done_ = true;
+        stop_timers();
+        for (std::size_t other = 0; other < attempts_.size(); ++other) {
+          if (other != index) { close(attempts_.at(other)); }
+        }
+        handler_({}, std::move(attempts_.at(index)), endpoints_.at(index));
+        return;
+      }
+
+      last_error_ = error;
+      if (next_ < endpoints_.size()) {
+        // A refused or unreachable address frees its slot at once instead of after the delay
+        stagger_.cancel();
+        launch_next();
+      } else if (in_flight_ == 0) {
+        fail(last_error_);
+      }
+    }
+
+    auto fail(const boost::system::error_code &error) -> void
+    {
+      if (done_) { return; }
+      done_ = true;
+      stop_timers();
+      for (auto &attempt : attempts_) { close(attempt); }
+      handler_(error, boost::asio::ip::tcp::socket(executor_), {});
+    }
+
+    auto stop_timers() -> void
+    {
+      stagger_.cancel();
+      deadline_.cancel();
+    }
+
+    static auto close(boost::asio::ip::tcp::socket &socket) -> void
+    {
+      boost::system::error_code ignored;
+      socket.close(ignored);
+    }
+
+    boost::asio::any_io_executor executor_;
+    std::vector<boost::asio::ip::tcp::endpoint> endpoints_;
+    std::chrono::milliseconds attempt_delay_;
+    happy_eyeballs_handler handler_;
+    boost::asio::steady_timer stagger_;
+    boost::asio::steady_timer deadline_;
+    std::vector<boost::asio::ip::tcp::socket> attempts_;
+    std::size_t next_{ 0 };
+    std::size_t in_flight_{ 0 };
+    bool done_{ false };
+    boost::system::error_code last_error_{ boost::asio::error::host_not_found };
+  };
+
+}// namespace
+
+auto interleave_address_families(const std::vector<boost::asio::ip::tcp::endpoint> &endpoints)
+  -> std::vector<boost::asio::ip::tcp::endpoint>
+{
+  if (endpoints.empty()) { return {}; }
+
+  const auto first_family = endpoints.front().protocol();
+  std::vector<boost::asio::ip::tcp::endpoint> preferred;
+  std::vector<boost::asio::ip::tcp::endpoint> other;
+  for (const auto &endpoint : endpoints) {
+    (endpoint.protocol() == first_family ? preferred : other).push_back(endpoint);
+  }
+
+  std::vector<boost::asio::ip::tcp::endpoint> ordered;
+  ordered.reserve(endpoints.size());
+  for (std::size_t index = 0; index < preferred.size() or index < other.size(); ++index) {
+    if (index < preferred.size()) { ordered.push_back(preferred.at(index)); }
+    if (index < other.size()) { ordered.push_back(other.at(index)); }
+  }
+  return ordered;
+}
+
+auto async_happy_eyeballs_connect(const boost::asio::any_io_executor &executor,
+  const std::vector<boost::asio::ip::tcp::endpoint> &endpoints,
+  std::chrono::milliseconds attempt_delay,
+  std::chrono::milliseconds timeout,
+  happy_eyeballs_handler handler) -> void
+{
+  if (endpoints.empty()) {
+    boost::asio::post(executor, [executor, handler = std::move(handler)]() -> void {
+      handler(boost::asio::error::host_not_found, boost::asio::ip::tcp::socket(executor), {});
+    });
+    return;
+  }
+
+  std::make_shared<connect_race>(executor, interleave_address_families(endpoints), attempt_delay, std::move(handler))
+    ->start(timeout);
+}
+
+}// namespace radix_relay::transport
@@ -0,0 +1,71 @@
+#include <transport/tls_client_context.hpp>
+
+namespace radix_relay::transport {
+
+namespace {
+
+  /// SSL_CTX ex_data slot holding the owning tls_client_context; slot 0 belongs to Asio's verify callback
+  auto owner_slot() -> int
+  {
+    static const int slot = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return slot;
+  }
+
+}// namespace
+
+auto tls_client_context::shared() -> const std::shared_ptr<tls_client_context> &
+{
+  static const auto context = std::make_shared<tls_client_context>();
+  return context;
+}
+
+tls_client_context::tls_client_context(bool load_default_verify_paths)
+  : context_(boost::asio::ssl::context::tls_client)
+{
+  SSL_CTX_set_min_proto_version(context_.native_handle(), TLS1_2_VERSION);
+  if (load_default_verify_paths) { context_.set_default_verify_paths(); }
+  context_.set_verify_mode(boost::asio::ssl::verify_peer);
+
+  // Sessions are kept here, keyed by host, rather than in OpenSSL's cache keyed by session ID
+  SSL_CTX_set_session_cache_mode(context_.native_handle(), SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+  SSL_CTX_set_ex_data(context_.native_handle(), owner_slot(), this);
+  SSL_CTX_sess_set_new_cb(context_.native_handle(), &tls_client_context::on_new_session);
+}
+
+auto tls_client_context::prepare(SSL *ssl, const std::string &host) -> bool
+{
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+#endif
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast,hicpp-no-array-decay)
+  if (not SSL_set_tlsext_host_name(ssl, host.c_str())) { return false; }
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
+
+  const std::scoped_lock lock(sessions_mutex_);
+  const auto cached = sessions_.find(host);
+  if (cached != sessions_.end()) { SSL_set_session(ssl, cached->second.get()); }
+  return true;
+}
+
+auto tls_client_context::cached_sessions() const -> std::size_t
+{
+  const std::scoped_lock lock(sessions_mutex_);
+  return sessions_.size();
+}
+
+auto tls_client_context::on_new_session(SSL *ssl, SSL_SESSION *session) -> int
+{
+  auto *owner = static_cast<tls_client_context *>(SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), owner_slot()));
+  const auto *host = SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name);
+  if (owner == nullptr or host == nullptr or SSL_SESSION_is_resumable(session) == 0) { return 0; }
+
+  // Returning 1 hands our reference of the session to the cache
+  const std::scoped_lock lock(owner->sessions_mutex_);
+  owner->sessions_.insert_or_assign(std::string(host), std::unique_ptr<SSL_SESSION, session_deleter>(session));
+  return 1;
+}
+
+}// namespace radix_relay::transport
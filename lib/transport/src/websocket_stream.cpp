@@ -1,77 +1,263 @@
 #include <transport/websocket_stream.hpp>
 
+#include <boost/beast/http.hpp>
 #include <chrono>
+#include <memory>
+#include <string>
+#include <utility>
 
 namespace radix_relay::transport {
 
-websocket_stream::websocket_stream(const std::shared_ptr<boost::asio::io_context> &io_context)
-  : ssl_context_(boost::asio::ssl::context::tlsv12_client), resolver_(*io_context),
-    ws_(boost::asio::make_strand(*io_context), ssl_context_)
+namespace {
+
+  /// State of one document fetch, shared by its completion handlers
+  struct document_fetch
+  {
+    document_fetch(const boost::asio::any_io_executor &executor, std::shared_ptr<tls_client_context> tls_context)
+      : tls(std::move(tls_context)), stream(executor, tls->context())
+    {}
+
+    std::shared_ptr<tls_client_context> tls;
+    boost::beast::ssl_stream<boost::beast::tcp_stream> stream;
+    boost::beast::flat_buffer buffer;
+    boost::beast::http::request<boost::beast::http::empty_body> request;
+    boost::beast::http::response_parser<boost::beast::http::string_body> parser;
+    std::string host;
+    std::function<void(const boost::system::error_code &, std::string)> handler;
+  };
+
+}// namespace
+
+websocket_stream::websocket_stream(const std::shared_ptr<boost::asio::io_context> &io_context,
+  websocket_compression compression,
+  std::shared_ptr<tls_client_context> tls,
+  std::shared_ptr<dns_cache> dns)
+  : compression_(compression), tls_(std::move(tls)), dns_(std::move(dns)),
+    strand_(boost::asio::make_strand(*io_context)), resolver_(*io_context),
+    ws_(std::make_unique<websocket_t>(strand_, tls_->context()))
+{}
+
+auto websocket_stream::async_open_tcp(const std::string &host,
+  const std::string &port,
+  std::chrono::milliseconds timeout,
+  tcp_handler handler) -> void
 {
-  ssl_context_.set_default_verify_paths();
-  ssl_context_.set_verify_mode(boost::asio::ssl::verify_peer);
+  if (auto cached = dns_->lookup(host, port)) {
+    race_endpoints(host, port, *cached, timeout, std::move(handler));
+    return;
+  }
+
+  resolver_.async_resolve(host,
+    port,
+    [this, host, port, timeout, handler = std::move(handler)](const boost::system::error_code &error_code,
+      const boost::asio::ip::tcp::resolver::results_type &results) mutable -> void {
+      if (error_code) {
+        handler(error_code, boost::asio::ip::tcp::socket(strand_));
+        return;
+      }
+
+      dns_cache::endpoints_t endpoints;
+      for (const auto &result : results) { endpoints.push_back(result.endpoint()); }
+      dns_->store(host, port, endpoints);
+      race_endpoints(host, port, endpoints, timeout, std::move(handler));
+    });
+}
+
+auto websocket_stream::race_endpoints(const std::string &host,
+  const std::string &port,
+  const dns_cache::endpoints_t &endpoints,
+  std::chrono::milliseconds timeout,
+  tcp_handler handler) -> void
+{
+  async_happy_eyeballs_connect(strand_,
+    endpoints,
+    connection_attempt_delay,
+    timeout,
+    [this, host, port, handler = std::move(handler)](const boost::system::error_code &error_code,
+      boost::asio::ip::tcp::socket socket,
+      const boost::asio::ip::tcp::endpoint & /*endpoint*/) mutable -> void {
+      // No address answered; they may have moved, so resolve again next time
+      if (error_code) { dns_->forget(host, port); }
+      handler(error_code, std::move(socket));
+    });
 }
 
 auto websocket_stream::async_connect(websocket_connection_params params,
   std::function<void(const boost::system::error_code &, std::size_t)> handler) -> void
 {
-  namespace beast = boost::beast;
-
   auto host_str = std::string(params.host);
   auto port_str = std::string(params.port);
   auto path_str = std::string(params.path);
 
-  resolver_.async_resolve(host_str,
-    port_str,
-    [this, host_str, port_str, path_str, handler = std::move(handler)](const boost::system::error_code &error_code,
-      const boost::asio::ip::tcp::resolver::results_type &results) mutable -> void {
-      if (error_code) {
-        handler(error_code, 0);
+  if (drained_handler_) {
+    boost::asio::post(strand_, [handler = std::move(handler)]() -> void {
+      handler(boost::asio::error::already_started, 0);
+    });
+    return;
+  }
+
+  if (pending_operations_ == 0) {
+    open_websocket(host_str, port_str, path_str, std::move(handler));
+    return;
+  }
+
+  // Pending operations still hold the old stream; closing its socket aborts them
+  drained_handler_ = [this, host_str, port_str, path_str, handler = std::move(handler)]() mutable -> void {
+    open_websocket(host_str, port_str, path_str, std::move(handler));
+  };
+  boost::beast::get_lowest_layer(*ws_).close();
+}
+
+auto websocket_stream::finish_operation() -> void
+{
+  if (--pending_operations_ == 0 and drained_handler_) {
+    boost::asio::post(strand_, std::exchange(drained_handler_, nullptr));
+  }
+}
+
+auto websocket_stream::open_websocket(const std::string &host,
+  const std::string &port,
+  const std::string &path,
+  std::function<void(const boost::system::error_code &, std::size_t)> handler) -> void
+{
+  namespace beast = boost::beast;
+
+  // An SSL object cannot be handshaken twice; the new one offers the cached session instead
+  ws_ = std::make_unique<websocket_t>(strand_, tls_->context());
+  messages_ = {};
+  wire_baseline_ = {};
+
+  if (compression_.enabled) {
+    beast::websocket::permessage_deflate deflate;
+    deflate.client_enable = true;
+    deflate.client_max_window_bits = compression_.window_bits;
+    deflate.server_max_window_bits = compression_.window_bits;
+    deflate.client_no_context_takeover = compression_.no_context_takeover;
+    deflate.server_no_context_takeover = compression_.no_context_takeover;
+    deflate.memLevel = compression_.memory_level;
+    ws_->set_option(deflate);
+  }
+
+  async_open_tcp(host,
+    port,
+    std::chrono::seconds(connection_timeout_seconds),
+    [this, host_str = host, path_str = path, handler = std::move(handler)](
+      const boost::system::error_code &connect_error, boost::asio::ip::tcp::socket socket) mutable -> void {
+      if (connect_error) {
+        handler(connect_error, 0);
         return;
       }
 
-      beast::get_lowest_layer(ws_).expires_after(std::chrono::seconds(connection_timeout_seconds));
+      beast::get_lowest_layer(*ws_).socket() = std::move(socket);
+      beast::get_lowest_layer(*ws_).expires_after(std::chrono::seconds(connection_timeout_seconds));
+
+      if (not tls_->prepare(ws_->next_layer().native_handle(), host_str)) {
+        handler(boost::asio::error::operation_not_supported, 0);
+        return;
+      }
 
-      beast::get_lowest_layer(ws_).async_connect(results,
-        [this, host_str, path_str, handler = std::move(handler)](const boost::system::error_code &connect_error,
-          const boost::asio::ip::tcp::endpoint & /*endpoint*/) mutable -> void {
-          if (connect_error) {
-            handler(connect_error, 0);
+      ws_->next_layer().async_handshake(boost::asio::ssl::stream_base::client,
+        [this, host_str, path_str, handler = std::move(handler)](
+          const boost::system::error_code &ssl_error) mutable -> void {
+          if (ssl_error) {
+            handler(ssl_error, 0);
             return;
           }
 
-#ifdef __GNUC__
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wold-style-cast"
-#endif
-          // NOLINTNEXTLINE(cppcoreguidelines-pro-type-cstyle-cast,hicpp-no-array-decay)
-          if (not SSL_set_tlsext_host_name(ws_.next_layer().native_handle(), host_str.c_str())) {
-#ifdef __GNUC__
-#pragma GCC diagnostic pop
-#endif
-            handler(boost::asio::error::operation_not_supported, 0);
+          beast::get_lowest_layer(*ws_).expires_never();
+
+          ws_->set_option(beast::websocket::stream_base::timeout::suggested(beast::role_type::client));
+          ws_->set_option(beast::websocket::stream_base::decorator([](beast::websocket::request_type &req) -> void {
+            req.set(boost::beast::http::field::user_agent, std::string(BOOST_BEAST_VERSION_STRING) + " radix-relay");
+          }));
+
+          ws_->control_callback([this](beast::websocket::frame_type kind, beast::string_view payload) -> void {
+            if (kind == beast::websocket::frame_type::pong and pong_handler_
+                and payload == beast::string_view(ping_payload_.data(), ping_payload_.size())) {
+              std::exchange(pong_handler_, nullptr)(boost::system::error_code{});
+            }
+          });
+
+          ws_->async_handshake(host_str,
+            path_str,
+            [this, handler = std::move(handler)](const boost::system::error_code &ws_error) -> void {
+              // Traffic counts start after the upgrade, so both sides count the same messages
+              if (not ws_error) { wire_baseline_ = traffic(); }
+              handler(ws_error, 0);
+            });
+        });
+    });
+}
+
+auto websocket_stream::async_fetch_document(websocket_connection_params params,
+  std::string_view accept,
+  std::function<void(const boost::system::error_code &, std::string)> handler) -> void
+{
+  namespace beast = boost::beast;
+  namespace http = boost::beast::http;
+
+  static constexpr int http_version = 11;
+
+  auto fetch = std::make_shared<document_fetch>(strand_, tls_);
+  fetch->host = std::string(params.host);
+  fetch->handler = std::move(handler);
+  fetch->request = { http::verb::get, std::string(params.path), http_version };
+  fetch->request.set(http::field::host, fetch->host);
+  fetch->request.set(http::field::accept, std::string(accept));
+  fetch->request.set(http::field::user_agent, std::string(BOOST_BEAST_VERSION_STRING) + " radix-relay");
+  fetch->parser.body_limit(document_body_limit);
+
+  async_open_tcp(fetch->host,
+    std::string(params.port),
+    std::chrono::seconds(document_timeout_seconds),
+    [fetch](const boost::system::error_code &connect_error, boost::asio::ip::tcp::socket socket) -> void {
+      if (connect_error) {
+        fetch->handler(connect_error, {});
+        return;
+      }
+
+      beast::get_lowest_layer(fetch->stream).socket() = std::move(socket);
+      beast::get_lowest_layer(fetch->stream).expires_after(std::chrono::seconds(document_timeout_seconds));
+
+      if (not fetch->tls->prepare(fetch->stream.native_handle(), fetch->host)) {
+        fetch->handler(boost::asio::error::operation_not_supported, {});
+        return;
+      }
+
+      fetch->stream.async_handshake(
+        boost::asio::ssl::stream_base::client, [fetch](const boost::system::error_code &ssl_error) -> void {
+          if (ssl_error) {
+            fetch->handler(ssl_error, {});
             return;
           }
 
-          ws_.next_layer().async_handshake(boost::asio::ssl::stream_base::client,
-            [this, host_str, path_str, handler = std::move(handler)](
-              const boost::system::error_code &ssl_error) mutable -> void {
-              if (ssl_error) {
-                handler(ssl_error, 0);
+          http::async_write(fetch->stream,
+            fetch->request,
+            [fetch](const boost::system::error_code &write_error, std::size_t /*bytes*/) -> void {
+              if (write_error) {
+                fetch->handler(write_error, {});
                 return;
               }
 
-              beast::get_lowest_layer(ws_).expires_never();
+              http::async_read(fetch->stream,
+                fetch->buffer,
+                fetch->parser,
+                [fetch](const boost::system::error_code &read_error, std::size_t /*bytes*/) -> void {
+                  beast::get_lowest_layer(fetch->stream).expires_never();
+                  if (read_error) {
+                    fetch->handler(read_error, {});
+                    return;
+                  }
 
-              ws_.set_option(beast::websocket::stream_base::timeout::suggested(beast::role_type::client));
-              ws_.set_option(beast::websocket::stream_base::decorator([](beast::websocket::request_type &req) -> void {
-                req.set(
-                  boost::beast::http::field::user_agent, std::string(BOOST_BEAST_VERSION_STRING) + " radix-relay");
-              }));
+                  auto response = fetch->parser.release();
+                  if (response.result() != http::status::ok) {
+                    fetch->handler(make_error_code(boost::system::errc::protocol_error), {});
+                  } else {
+                    fetch->handler({}, std::move(response.body()));
+                  }
 
-              ws_.async_handshake(
-                host_str, path_str, [handler = std::move(handler)](const boost::system::error_code &ws_error) -> void {
-                  handler(ws_error, 0);
+                  // The body is already delivered; a failed TLS close changes nothing for the caller
+                  fetch->stream.async_shutdown([fetch](const boost::system::error_code & /*error*/) -> void {});
                 });
             });
         });
@@ -81,8 +267,12 @@ auto websocket_stream::async_connect(websocket_connection_params params,
 auto websocket_stream::async_write(const std::span<const std::byte> data,
   std::function<void(const boost::system::error_code &, std::size_t)> handler) -> void
 {
-  ws_.async_write(boost::asio::buffer(data.data(), data.size()),
-    [handler = std::move(handler)](const boost::system::error_code &error_code, std::size_t bytes_transferred) -> void {
+  ++pending_operations_;
+  ws_->async_write(boost::asio::buffer(data.data(), data.size()),
+    [this, handler = std::move(handler)](
+      const boost::system::error_code &error_code, std::size_t bytes_transferred) -> void {
+      finish_operation();
+      messages_.message_bytes_sent += bytes_transferred;
       handler(error_code, bytes_transferred);
     });
 }
@@ -91,11 +281,14 @@ auto websocket_stream::async_read(const boost::asio::mutable_buffer &buffer,
   std::function<void(const boost::system::error_code &, std::size_t)> handler) -> void
 {
   read_buffer_.clear();
-  ws_.async_read(read_buffer_,
+  ++pending_operations_;
+  ws_->async_read(read_buffer_,
     [this, buffer, handler = std::move(handler)](
       const boost::system::error_code &error_code, std::size_t /*bytes_transferred*/) -> void {
+      finish_operation();
       if (not error_code) {
         const auto data = read_buffer_.data();
+        messages_.message_bytes_received += data.size();
         const std::size_t size = std::min(boost::asio::buffer_size(buffer), data.size());
         boost::asio::buffer_copy(buffer, data, size);
         handler(error_code, size);
@@ -105,10 +298,38 @@ auto websocket_stream::async_read(const boost::asio::mutable_buffer &buffer,
     });
 }
 
+auto websocket_stream::async_ping(std::function<void(const boost::system::error_code &)> handler) -> void
+{
+  // Numbered payloads keep pongs to Beast's own keep-alive pings from completing ours
+  ping_payload_ = std::to_string(++pings_sent_);
+  pong_handler_ = std::move(handler);
+  ++pending_operations_;
+  ws_->async_ping(ping_payload_, [this](const boost::system::error_code &error_code) -> void {
+    finish_operation();
+    if (error_code and pong_handler_) { std::exchange(pong_handler_, nullptr)(error_code); }
+  });
+}
+
 auto websocket_stream::async_close(std::function<void(const boost::system::error_code &, std::size_t)> handler) -> void
 {
-  ws_.async_close(boost::beast::websocket::close_code::normal,
-    [handler = std::move(handler)](const boost::system::error_code &error_code) -> void { handler(error_code, 0); });
+  ++pending_operations_;
+  ws_->async_close(boost::beast::websocket::close_code::normal,
+    [this, handler = std::move(handler)](const boost::system::error_code &error_code) -> void {
+      finish_operation();
+      handler(error_code, 0);
+    });
+}
+
+auto websocket_stream::traffic() -> websocket_traffic
+{
+  // Asio hands OpenSSL one BIO for both directions; its counters are the TLS records exchanged
+  auto *bio = SSL_get_rbio(ws_->next_layer().native_handle());
+  if (bio == nullptr) { return messages_; }
+
+  auto counted = messages_;
+  counted.wire_bytes_sent = BIO_number_written(bio) - wire_baseline_.wire_bytes_sent;
+  counted.wire_bytes_received = BIO_number_read(bio) - wire_baseline_.wire_bytes_received;
+  return counted;
 }
 
 }// namespace radix_relay::transport
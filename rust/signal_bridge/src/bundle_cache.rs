@@ -0,0 +1,230 @@
+//! Persistent cache of discovered prekey bundles
+//!
+//! Bundle announcements seen on relays are remembered in the identity database so that
+//! `/trust` and `/identities` work right after a restart, before any relay has replayed its
+//! announcements. The listing leaves the bundle bodies out; a body is read only when a session
+//! is about to be established with it. Only the newest `MAX_CACHED_BUNDLES` announcements are
+//! kept, so global discovery cannot grow the table without bound.
+
+use crate::SignalBridgeError;
+use rusqlite::{Connection, OptionalExtension};
+use std::sync::{Arc, Mutex};
+
+/// Most bundle announcements kept; the oldest are dropped first
+pub const MAX_CACHED_BUNDLES: usize = 4096;
+
+/// A cached bundle announcement without its body
+#[derive(Clone, Debug, PartialEq)]
+pub struct CachedBundle {
+    /// Nostr public key of the announcing node
+    pub nostr_pubkey: String,
+    /// RDX fingerprint of the bundle, empty if not yet extracted
+    pub rdx_fingerprint: String,
+    /// Nostr event ID of the announcement
+    pub event_id: String,
+    /// Announcement timestamp
+    pub created_at: u64,
+}
+
+/// Stores the newest bundle announcement of each Nostr pubkey
+pub struct BundleCache {
+    storage: Arc<Mutex<Connection>>,
+}
+
+impl BundleCache {
+    /// Creates a bundle cache backed by the given database connection
+    pub fn new(storage_connection: Arc<Mutex<Connection>>) -> Self {
+        Self {
+            storage: storage_connection,
+        }
+    }
+
+    pub fn create_tables(conn: &Connection) -> Result<(), Box<dyn std::error::Error>> {
+        conn.execute(
+            "CREATE TABLE IF NOT EXISTS discovered_bundles (
+                nostr_pubkey TEXT PRIMARY KEY,
+                rdx_fingerprint TEXT NOT NULL,
+                event_id TEXT NOT NULL,
+                created_at INTEGER NOT NULL,
+                bundle_base64 TEXT NOT NULL
+            )",
+            [],
+        )?;
+
+        Ok(())
+    }
+
+    /// Stores a bundle unless a newer announcement is already cached for its pubkey
+    ///
+    /// An empty RDX fingerprint keeps the one already cached for identical bundle data. Once more
+    /// than `MAX_CACHED_BUNDLES` announcements are cached, the oldest ones are dropped.
+    ///
+    /// # Arguments
+    /// * `bundle` - Announcement metadata
+    /// * `bundle_base64` - Base64-encoded bundle data
+    pub fn save(
+        &mut self,
+        bundle: &CachedBundle,
+        bundle_base64: &str,
+    ) -> Result<(), SignalBridgeError> {
+        let conn = self.storage.lock().unwrap();
+        conn.execute(
+            "INSERT INTO discovered_bundles
+             (nostr_pubkey, rdx_fingerprint, event_id, created_at, bundle_base64)
+             VALUES (?1, ?2, ?3, ?4, ?5)
+             ON CONFLICT(nostr_pubkey) DO UPDATE SET
+               rdx_fingerprint = CASE
+                 WHEN excluded.rdx_fingerprint = ''
+                      AND excluded.bundle_base64 = discovered_bundles.bundle_base64
+                 THEN discovered_bundles.rdx_fingerprint
+                 ELSE excluded.rdx_fingerprint
+               END,
+               event_id = excluded.event_id,
+               created_at = excluded.created_at,
+               bundle_base64 = excluded.bundle_base64
+             WHERE excluded.created_at >= discovered_bundles.created_at",
+            rusqlite::params![
+                bundle.nostr_pubkey,
+                bundle.rdx_fingerprint,
+                bundle.event_id,
+                bundle.created_at,
+                bundle_base64
+            ],
+        )?;
+        conn.execute(
+            "DELETE FROM discovered_bundles WHERE nostr_pubkey NOT IN (
+               SELECT nostr_pubkey FROM discovered_bundles
+               ORDER BY created_at DESC, nostr_pubkey LIMIT ?1
+             )",
+            [MAX_CACHED_BUNDLES as i64],
+        )?;
+        Ok(())
+    }
+
+    /// Lists every cached bundle without reading the bundle bodies
+    pub fn list(&self) -> Result<Vec<CachedBundle>, SignalBridgeError> {
+        let conn = self.storage.lock().unwrap();
+        let mut stmt = conn.prepare(
+            "SELECT nostr_pubkey, rdx_fingerprint, event_id, created_at FROM discovered_bundles",
+        )?;
+        let bundles = stmt
+            .query_map([], |row| {
+                Ok(CachedBundle {
+                    nostr_pubkey: row.get(0)?,
+                    rdx_fingerprint: row.get(1)?,
+                    event_id: row.get(2)?,
+                    created_at: row.get(3)?,
+                })
+            })?
+            .collect::<Result<Vec<_>, _>>()?;
+        Ok(bundles)
+    }
+
+    /// Reads the body of a cached bundle
+    ///
+    /// # Returns
+    /// Base64-encoded bundle data, or an empty string if nothing is cached for the pubkey
+    pub fn load_body(&self, nostr_pubkey: &str) -> Result<String, SignalBridgeError> {
+        let conn = self.storage.lock().unwrap();
+        let body = conn
+            .query_row(
+                "SELECT bundle_base64 FROM discovered_bundles WHERE nostr_pubkey = ?1",
+                [nostr_pubkey],
+                |row| row.get(0),
+            )
+            .optional()?;
+        Ok(body.unwrap_or_default())
+    }
+
+    /// Forgets the cached bundle of a pubkey
+    pub fn remove(&mut self, nostr_pubkey: &str) -> Result<(), SignalBridgeError> {
+        let conn = self.storage.lock().unwrap();
+        conn.execute(
+            "DELETE FROM discovered_bundles WHERE nostr_pubkey = ?1",
+            [nostr_pubkey],
+        )?;
+        Ok(())
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn cache() -> BundleCache {
+        let conn = Connection::open_in_memory().unwrap();
+        BundleCache::create_tables(&conn).unwrap();
+        BundleCache::new(Arc::new(Mutex::new(conn)))
+    }
+
+    fn bundle(event_id: &str, created_at: u64) -> CachedBundle {
+        CachedBundle {
+            nostr_pubkey: "ab".repeat(32),
+            rdx_fingerprint: String::new(),
+            event_id: event_id.to_string(),
+            created_at,
+        }
+    }
+
+    #[test]
+    fn test_saved_bundle_is_listed_without_body() {
+        let mut bundles = cache();
+        bundles.save(&bundle("e1", 100), "Ym9keQ==").unwrap();
+
+        assert_eq!(bundles.list().unwrap(), vec![bundle("e1", 100)]);
+        assert_eq!(bundles.load_body(&"ab".repeat(32)).unwrap(), "Ym9keQ==");
+        assert_eq!(bundles.load_body(&"cd".repeat(32)).unwrap(), "");
+    }
+
+    #[test]
+    fn test_older_announcement_does_not_replace_newer() {
+        let mut bundles = cache();
+        bundles.save(&bundle("e2", 200), "bmV3").unwrap();
+        bundles.save(&bundle("e1", 100), "b2xk").unwrap();
+        assert_eq!(bundles.list().unwrap(), vec![bundle("e2", 200)]);
+
+        let mut resolved = bundle("e2", 200);
+        resolved.rdx_fingerprint = "RDX:bob".to_string();
+        bundles.save(&resolved, "bmV3").unwrap();
+        assert_eq!(bundles.list().unwrap(), vec![resolved]);
+        assert_eq!(bundles.load_body(&"ab".repeat(32)).unwrap(), "bmV3");
+    }
+
+    #[test]
+    fn test_unchanged_bundle_keeps_its_fingerprint() {
+        let mut bundles = cache();
+        let mut resolved = bundle("e1", 100);
+        resolved.rdx_fingerprint = "RDX:bob".to_string();
+        bundles.save(&resolved, "Ym9i").unwrap();
+
+        bundles.save(&bundle("e2", 200), "Ym9i").unwrap();
+        assert_eq!(bundles.list().unwrap()[0].rdx_fingerprint, "RDX:bob");
+
+        bundles.save(&bundle("e3", 300), "Ym9iMg==").unwrap();
+        assert_eq!(bundles.list().unwrap(), vec![bundle("e3", 300)]);
+    }
+
+    #[test]
+    fn test_oldest_bundles_are_pruned_beyond_the_cap() {
+        let mut bundles = cache();
+        for index in 0..=MAX_CACHED_BUNDLES as u64 {
+            let mut announced = bundle(&format!("e{index}"), 1000 + index);
+            announced.nostr_pubkey = format!("{index:064x}");
+            bundles.save(&announced, "Ym9keQ==").unwrap();
+        }
+
+        let listed = bundles.list().unwrap();
+        assert_eq!(listed.len(), MAX_CACHED_BUNDLES);
+        assert!(listed.iter().all(|cached| cached.event_id != "e0"));
+    }
+
+    #[test]
+    fn test_removed_bundle_is_forgotten() {
+        let mut bundles = cache();
+        bundles.save(&bundle("e1", 100), "Ym9keQ==").unwrap();
+        bundles.remove(&"ab".repeat(32)).unwrap();
+
+        assert!(bundles.list().unwrap().is_empty());
+        assert_eq!(bundles.load_body(&"ab".repeat(32)).unwrap(), "");
+    }
+}
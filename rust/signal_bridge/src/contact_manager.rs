@@ -260,6 +260,94 @@ impl ContactManager {
         Ok(result)
     }
 
+    /// Records whether a contact accepts base64 encrypted message content
+    ///
+    /// # Arguments
+    /// * `rdx_fingerprint` - RDX fingerprint of the contact
+    /// * `accepts` - Whether the contact's latest message showed base64 support
+    pub fn set_accepts_base64_content(
+        &mut self,
+        rdx_fingerprint: &str,
+        accepts: bool,
+    ) -> Result<(), SignalBridgeError> {
+        self.set_capability("accepts_base64_content", rdx_fingerprint, accepts)
+    }
+
+    /// Checks whether a contact accepts base64 encrypted message content
+    ///
+    /// Unknown contacts and contacts that never showed support get hex, which every version
+    /// decodes.
+    ///
+    /// # Arguments
+    /// * `identifier` - RDX fingerprint, Nostr pubkey, or alias
+    pub fn accepts_base64_content(&self, identifier: &str) -> Result<bool, SignalBridgeError> {
+        self.capability("accepts_base64_content", identifier)
+    }
+
+    /// Records whether a contact's latest message advertised zstd payload compression
+    ///
+    /// # Arguments
+    /// * `rdx_fingerprint` - RDX fingerprint of the contact
+    /// * `accepts` - Whether the message carried the zstd capability
+    pub fn set_accepts_zstd(
+        &mut self,
+        rdx_fingerprint: &str,
+        accepts: bool,
+    ) -> Result<(), SignalBridgeError> {
+        self.set_capability("accepts_zstd", rdx_fingerprint, accepts)
+    }
+
+    /// Checks whether a contact accepts zstd-compressed plaintext
+    ///
+    /// # Arguments
+    /// * `identifier` - RDX fingerprint, Nostr pubkey, or alias
+    pub fn accepts_zstd(&self, identifier: &str) -> Result<bool, SignalBridgeError> {
+        self.capability("accepts_zstd", identifier)
+    }
+
+    /// Stores a capability flag, writing only when it differs from the stored value
+    ///
+    /// Every decrypted message reports its sender's capabilities, and they rarely change.
+    fn set_capability(
+        &mut self,
+        column: &'static str,
+        rdx_fingerprint: &str,
+        accepts: bool,
+    ) -> Result<(), SignalBridgeError> {
+        let conn_lock = self.storage.lock().unwrap();
+        conn_lock
+            .execute(
+                &format!(
+                    "UPDATE contacts SET {0} = ?1 WHERE rdx_fingerprint = ?2 AND {0} IS NOT ?1",
+                    column
+                ),
+                rusqlite::params![accepts, rdx_fingerprint],
+            )
+            .map_err(|e| SignalBridgeError::Storage(e.to_string()))?;
+        Ok(())
+    }
+
+    fn capability(
+        &self,
+        column: &'static str,
+        identifier: &str,
+    ) -> Result<bool, SignalBridgeError> {
+        let conn_lock = self.storage.lock().unwrap();
+        let accepts: Option<bool> = conn_lock
+            .query_row(
+                &format!(
+                    "SELECT {} FROM contacts
+                     WHERE rdx_fingerprint = ?1 OR user_alias = ?1 OR nostr_pubkey = ?1",
+                    column
+                ),
+                rusqlite::params![identifier],
+                |row| row.get(0),
+            )
+            .optional()
+            .map_err(|e| SignalBridgeError::Storage(e.to_string()))?;
+        Ok(accepts.unwrap_or(false))
+    }
+
     /// Generates an RDX fingerprint from a Signal identity key
     ///
     /// # Arguments
@@ -281,6 +369,41 @@ mod tests {
     use super::*;
     use crate::keys::generate_identity_key_pair;
 
+    #[test]
+    fn test_unchanged_capability_is_not_written() {
+        let storage_conn = Arc::new(Mutex::new(rusqlite::Connection::open_in_memory().unwrap()));
+        {
+            let conn = storage_conn.lock().unwrap();
+            conn.execute(
+                "CREATE TABLE contacts (
+                    rdx_fingerprint TEXT PRIMARY KEY,
+                    nostr_pubkey TEXT,
+                    user_alias TEXT,
+                    accepts_zstd BOOLEAN NOT NULL DEFAULT 0
+                )",
+                [],
+            )
+            .unwrap();
+            conn.execute(
+                "INSERT INTO contacts (rdx_fingerprint) VALUES ('RDX:bob')",
+                [],
+            )
+            .unwrap();
+        }
+        let mut manager = ContactManager::new(storage_conn.clone());
+        let writes = || storage_conn.lock().unwrap().total_changes();
+
+        let before = writes();
+        manager.set_accepts_zstd("RDX:bob", false).unwrap();
+        assert_eq!(writes(), before);
+
+        manager.set_accepts_zstd("RDX:bob", true).unwrap();
+        assert_eq!(writes(), before + 1);
+        manager.set_accepts_zstd("RDX:bob", true).unwrap();
+        assert_eq!(writes(), before + 1);
+        assert!(manager.accepts_zstd("RDX:bob").unwrap());
+    }
+
     #[tokio::test]
     async fn test_add_contact_from_identity_key() {
         use crate::memory_storage::MemoryStorage;
@@ -0,0 +1,124 @@
+//! Verification of relay-delivered Nostr events
+//!
+//! A relay can hand us events it made up. Before an incoming event is decrypted or its bundle
+//! extracted, its ID has to match the hash of its fields and its BIP-340 signature has to be
+//! valid for its pubkey. Events arrive in bursts, so they are checked a batch at a time and a
+//! large batch is split across cores.
+
+use nostr::{Event, JsonUtil};
+use std::thread;
+
+/// Smallest share of a batch worth handing to another thread
+const MIN_EVENTS_PER_THREAD: usize = 16;
+
+/// Checks the ID and signature of a batch of events
+///
+/// # Arguments
+/// * `events` - Event objects as JSON
+///
+/// # Returns
+/// One flag per event, in order: true if the event parses, its ID matches its fields, and its
+/// signature is valid
+pub fn verify_events(events: &[String]) -> Vec<bool> {
+    let threads = thread::available_parallelism()
+        .map_or(1, |cores| cores.get())
+        .min(events.len().div_ceil(MIN_EVENTS_PER_THREAD))
+        .max(1);
+    if threads == 1 {
+        return events.iter().map(|event| verify_event(event)).collect();
+    }
+
+    let chunk_size = events.len().div_ceil(threads);
+    thread::scope(|scope| {
+        let workers: Vec<_> = events
+            .chunks(chunk_size)
+            .map(|chunk| {
+                let worker = scope.spawn(move || {
+                    chunk
+                        .iter()
+                        .map(|event| verify_event(event))
+                        .collect::<Vec<_>>()
+                });
+                (chunk.len(), worker)
+            })
+            .collect();
+        workers
+            .into_iter()
+            .flat_map(|(len, worker)| worker.join().unwrap_or_else(|_| vec![false; len]))
+            .collect()
+    })
+}
+
+fn verify_event(json: &str) -> bool {
+    Event::from_json(json).is_ok_and(|event| event.verify().is_ok())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use nostr::{EventBuilder, Keys, Kind};
+
+    fn signed_event_json(keys: &Keys, content: &str) -> String {
+        EventBuilder::new(Kind::Custom(40001), content, [])
+            .to_event(keys)
+            .unwrap()
+            .as_json()
+    }
+
+    fn with_field(json: &str, field: &str, value: serde_json::Value) -> String {
+        let mut event: serde_json::Value = serde_json::from_str(json).unwrap();
+        event[field] = value;
+        event.to_string()
+    }
+
+    #[test]
+    fn test_signed_events_verify() {
+        let keys = Keys::generate();
+        let events = vec![
+            signed_event_json(&keys, "one"),
+            signed_event_json(&keys, "two"),
+        ];
+        assert_eq!(verify_events(&events), vec![true, true]);
+    }
+
+    #[test]
+    fn test_forged_events_are_rejected() {
+        let keys = Keys::generate();
+        let other_keys = Keys::generate();
+        let genuine = signed_event_json(&keys, "hello");
+        let events = vec![
+            with_field(&genuine, "content", "goodbye".into()),
+            with_field(&genuine, "pubkey", other_keys.public_key().to_hex().into()),
+            with_field(
+                &genuine,
+                "sig",
+                serde_json::from_str::<serde_json::Value>(&signed_event_json(&other_keys, "hello"))
+                    .unwrap()["sig"]
+                    .clone(),
+            ),
+            "not an event".to_string(),
+            genuine,
+        ];
+        assert_eq!(
+            verify_events(&events),
+            vec![false, false, false, false, true]
+        );
+    }
+
+    #[test]
+    fn test_large_batches_keep_their_order() {
+        let keys = Keys::generate();
+        let events: Vec<String> = (0..100)
+            .map(|i| {
+                let event = signed_event_json(&keys, &i.to_string());
+                if i % 7 == 0 {
+                    with_field(&event, "content", "tampered".into())
+                } else {
+                    event
+                }
+            })
+            .collect();
+        let expected: Vec<bool> = (0..100).map(|i| i % 7 != 0).collect();
+        assert_eq!(verify_events(&events), expected);
+    }
+}
@@ -0,0 +1,811 @@
+//! Chunked file transfer for Radix Relay
+//!
+//! Files too large for one event travel as a series of chunks, each encrypted over the
+//! pairwise Signal session and sent as its own event. Every chunk carries the transfer's
+//! manifest, so a receiver can start reassembly from whichever chunk arrives first, and
+//! relays may deliver chunks in any order.
+//!
+//! Both ends keep their progress in SQLite. The sender remembers which chunks a relay has
+//! accepted and resumes with the rest after a disconnect; the receiver writes each chunk
+//! straight to a `.part` file at its offset and remembers which ones it holds, so repeated
+//! chunks are ignored and memory use stays at one chunk regardless of file size.
+
+use crate::SignalBridgeError;
+use rusqlite::{Connection, OptionalExtension};
+use serde::{Deserialize, Serialize};
+use sha2::{Digest, Sha256};
+use std::fs::{File, OpenOptions};
+use std::io::{Read, Seek, SeekFrom, Write};
+use std::path::{Path, PathBuf};
+use std::sync::{Arc, Mutex};
+use std::time::{SystemTime, UNIX_EPOCH};
+use uuid::Uuid;
+
+/// Plaintext bytes per chunk
+///
+/// Sized so a chunk event stays well under common relay event limits after Signal framing
+/// and base64 encoding.
+pub const CHUNK_SIZE: u32 = 32 * 1024;
+
+/// Largest file that can be sent or accepted
+pub const MAX_TRANSFER_SIZE: u64 = 64 * 1024 * 1024;
+
+/// Describes a whole transfer; repeated in every chunk
+#[derive(Serialize, Deserialize, Clone, Debug, PartialEq)]
+pub struct TransferManifest {
+    /// Random transfer identifier
+    pub transfer_id: String,
+    /// File name without any directory components
+    pub name: String,
+    /// File size in bytes
+    pub total_size: u64,
+    /// Bytes per chunk; only the last chunk may be shorter
+    pub chunk_size: u32,
+    /// Number of chunks
+    pub chunk_count: u32,
+    /// SHA-256 of the whole file
+    pub file_hash: [u8; 32],
+}
+
+/// One encrypted unit of a transfer
+#[derive(Serialize, Deserialize, Debug, PartialEq)]
+pub struct TransferChunk {
+    /// Transfer this chunk belongs to
+    pub manifest: TransferManifest,
+    /// Zero-based chunk index
+    pub index: u32,
+    /// SHA-256 of `data`
+    pub chunk_hash: [u8; 32],
+    /// Chunk bytes
+    pub data: Vec<u8>,
+}
+
+/// Sender-side state of a transfer that still has chunks to deliver
+#[derive(Clone, Debug)]
+pub struct OutgoingTransfer {
+    /// Transfer identifier
+    pub transfer_id: String,
+    /// RDX fingerprint of the recipient
+    pub peer_rdx: String,
+    /// File name sent to the recipient
+    pub name: String,
+    /// Number of chunks
+    pub chunk_count: u32,
+    /// Chunks no relay has accepted yet, in order
+    pub pending_chunks: Vec<u32>,
+}
+
+/// Receiver-side progress after processing a chunk
+#[derive(Clone, Debug)]
+pub struct TransferProgress {
+    /// Transfer identifier
+    pub transfer_id: String,
+    /// File name
+    pub name: String,
+    /// RDX fingerprint of the sender
+    pub sender_rdx: String,
+    /// Chunks received so far
+    pub received_chunks: u32,
+    /// Number of chunks
+    pub chunk_count: u32,
+    /// Whether the file is complete and verified
+    pub complete: bool,
+    /// Final path of the file, chosen when the transfer completes
+    pub path: String,
+}
+
+/// Persists chunked transfer state and moves chunk bytes to and from disk
+pub struct FileTransferManager {
+    storage: Arc<Mutex<Connection>>,
+    download_dir: PathBuf,
+}
+
+impl FileTransferManager {
+    /// Creates a transfer manager that saves received files under `download_dir`
+    pub fn new(storage_connection: Arc<Mutex<Connection>>, download_dir: PathBuf) -> Self {
+        Self {
+            storage: storage_connection,
+            download_dir,
+        }
+    }
+
+    pub fn create_tables(conn: &Connection) -> Result<(), Box<dyn std::error::Error>> {
+        conn.execute(
+            "CREATE TABLE IF NOT EXISTS outgoing_transfers (
+                transfer_id TEXT PRIMARY KEY,
+                peer_rdx TEXT NOT NULL,
+                path TEXT NOT NULL,
+                name TEXT NOT NULL,
+                total_size INTEGER NOT NULL,
+                chunk_size INTEGER NOT NULL,
+                chunk_count INTEGER NOT NULL,
+                file_hash BLOB NOT NULL,
+                delivered BLOB NOT NULL,
+                created_at INTEGER NOT NULL
+            )",
+            [],
+        )?;
+
+        conn.execute(
+            "CREATE TABLE IF NOT EXISTS incoming_transfers (
+                transfer_id TEXT PRIMARY KEY,
+                sender_rdx TEXT NOT NULL,
+                name TEXT NOT NULL,
+                path TEXT NOT NULL,
+                total_size INTEGER NOT NULL,
+                chunk_size INTEGER NOT NULL,
+                chunk_count INTEGER NOT NULL,
+                file_hash BLOB NOT NULL,
+                received BLOB NOT NULL,
+                completed BOOLEAN DEFAULT 0,
+                created_at INTEGER NOT NULL
+            )",
+            [],
+        )?;
+
+        Ok(())
+    }
+
+    /// Registers a file for sending and hashes it without loading it into memory
+    ///
+    /// # Arguments
+    /// * `peer_rdx` - RDX fingerprint of the recipient
+    /// * `path` - File to send
+    pub fn start_outgoing(
+        &mut self,
+        peer_rdx: &str,
+        path: &str,
+    ) -> Result<OutgoingTransfer, SignalBridgeError> {
+        let name = sanitized_name(path)?;
+        let mut file = File::open(path)?;
+        let total_size = file.metadata()?.len();
+        if total_size == 0 || total_size > MAX_TRANSFER_SIZE {
+            return Err(SignalBridgeError::InvalidInput(format!(
+                "File size must be between 1 and {} bytes",
+                MAX_TRANSFER_SIZE
+            )));
+        }
+
+        let mut hasher = Sha256::new();
+        let mut buffer = vec![0u8; CHUNK_SIZE as usize];
+        loop {
+            let read = file.read(&mut buffer)?;
+            if read == 0 {
+                break;
+            }
+            hasher.update(&buffer[..read]);
+        }
+
+        let chunk_count = chunk_count_for(total_size, CHUNK_SIZE)?;
+        let transfer_id = Uuid::new_v4().to_string();
+        let now = SystemTime::now().duration_since(UNIX_EPOCH)?.as_secs();
+        let conn = self.storage.lock().unwrap();
+        conn.execute(
+            "INSERT INTO outgoing_transfers
+             (transfer_id, peer_rdx, path, name, total_size, chunk_size, chunk_count, file_hash,
+              delivered, created_at)
+             VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10)",
+            rusqlite::params![
+                transfer_id,
+                peer_rdx,
+                path,
+                name,
+                total_size,
+                CHUNK_SIZE,
+                chunk_count,
+                hasher.finalize().to_vec(),
+                bitmap_new(chunk_count),
+                now
+            ],
+        )?;
+
+        Ok(OutgoingTransfer {
+            transfer_id,
+            peer_rdx: peer_rdx.to_string(),
+            name,
+            chunk_count,
+            pending_chunks: (0..chunk_count).collect(),
+        })
+    }
+
+    /// Returns every outgoing transfer with chunks still awaiting relay acceptance
+    pub fn pending_outgoing(&self) -> Result<Vec<OutgoingTransfer>, SignalBridgeError> {
+        let conn = self.storage.lock().unwrap();
+        let mut stmt = conn.prepare(
+            "SELECT transfer_id, peer_rdx, name, chunk_count, delivered FROM outgoing_transfers
+             ORDER BY created_at, transfer_id",
+        )?;
+        let transfers = stmt
+            .query_map([], |row| {
+                let chunk_count: u32 = row.get(3)?;
+                let delivered: Vec<u8> = row.get(4)?;
+                Ok(OutgoingTransfer {
+                    transfer_id: row.get(0)?,
+                    peer_rdx: row.get(1)?,
+                    name: row.get(2)?,
+                    chunk_count,
+                    pending_chunks: (0..chunk_count)
+                        .filter(|index| !bitmap_get(&delivered, *index))
+                        .collect(),
+                })
+            })?
+            .collect::<Result<Vec<_>, _>>()?;
+        Ok(transfers)
+    }
+
+    /// Reads one chunk of an outgoing transfer from disk
+    ///
+    /// # Arguments
+    /// * `transfer_id` - Outgoing transfer
+    /// * `index` - Chunk to read
+    ///
+    /// # Returns
+    /// RDX fingerprint of the recipient and the chunk
+    pub fn read_chunk(
+        &self,
+        transfer_id: &str,
+        index: u32,
+    ) -> Result<(String, TransferChunk), SignalBridgeError> {
+        let (peer_rdx, path, manifest) = {
+            let conn = self.storage.lock().unwrap();
+            conn.query_row(
+                "SELECT peer_rdx, path, name, total_size, chunk_size, chunk_count, file_hash
+                 FROM outgoing_transfers WHERE transfer_id = ?1",
+                rusqlite::params![transfer_id],
+                |row| {
+                    Ok((
+                        row.get::<_, String>(0)?,
+                        row.get::<_, String>(1)?,
+                        TransferManifest {
+                            transfer_id: transfer_id.to_string(),
+                            name: row.get(2)?,
+                            total_size: row.get(3)?,
+                            chunk_size: row.get(4)?,
+                            chunk_count: row.get(5)?,
+                            file_hash: hash_from_blob(row.get(6)?),
+                        },
+                    ))
+                },
+            )
+            .optional()?
+            .ok_or_else(|| {
+                SignalBridgeError::InvalidInput(format!("Transfer not found: {}", transfer_id))
+            })?
+        };
+
+        let length = chunk_length(&manifest, index)?;
+        let mut data = vec![0u8; length];
+        let mut file = File::open(&path)?;
+        file.seek(SeekFrom::Start(
+            u64::from(index) * u64::from(manifest.chunk_size),
+        ))?;
+        file.read_exact(&mut data)?;
+
+        Ok((
+            peer_rdx,
+            TransferChunk {
+                manifest,
+                index,
+                chunk_hash: Sha256::digest(&data).into(),
+                data,
+            },
+        ))
+    }
+
+    /// Records that a relay accepted a chunk
+    ///
+    /// # Returns
+    /// True once every chunk has been accepted; the transfer is then forgotten
+    pub fn mark_delivered(
+        &mut self,
+        transfer_id: &str,
+        index: u32,
+    ) -> Result<bool, SignalBridgeError> {
+        let conn = self.storage.lock().unwrap();
+        let row: Option<(u32, Vec<u8>)> = conn
+            .query_row(
+                "SELECT chunk_count, delivered FROM outgoing_transfers WHERE transfer_id = ?1",
+                rusqlite::params![transfer_id],
+                |row| Ok((row.get(0)?, row.get(1)?)),
+            )
+            .optional()?;
+        let Some((chunk_count, mut delivered)) = row else {
+            return Ok(true);
+        };
+        if index >= chunk_count {
+            return Err(SignalBridgeError::InvalidInput(format!(
+                "Chunk {} out of range",
+                index
+            )));
+        }
+
+        bitmap_set(&mut delivered, index);
+        if bitmap_count(&delivered, chunk_count) == chunk_count {
+            conn.execute(
+                "DELETE FROM outgoing_transfers WHERE transfer_id = ?1",
+                rusqlite::params![transfer_id],
+            )?;
+            return Ok(true);
+        }
+        conn.execute(
+            "UPDATE outgoing_transfers SET delivered = ?1 WHERE transfer_id = ?2",
+            rusqlite::params![delivered, transfer_id],
+        )?;
+        Ok(false)
+    }
+
+    /// Writes a received chunk into its transfer's partial file
+    ///
+    /// The first chunk of a transfer creates the partial file at full size. Once every chunk is
+    /// present the whole file is hashed against the manifest and moved to its final name; a
+    /// mismatch discards the partial file. The final name is picked only then, so transfers of
+    /// files with the same name never end up at the same path.
+    ///
+    /// # Arguments
+    /// * `sender_rdx` - RDX fingerprint of the sender
+    /// * `chunk` - Decrypted chunk
+    pub fn receive_chunk(
+        &mut self,
+        sender_rdx: &str,
+        chunk: &TransferChunk,
+    ) -> Result<TransferProgress, SignalBridgeError> {
+        let manifest = &chunk.manifest;
+        validate_manifest(manifest)?;
+        if chunk.data.len() != chunk_length(manifest, chunk.index)? {
+            return Err(SignalBridgeError::InvalidInput(format!(
+                "Chunk {} has the wrong length",
+                chunk.index
+            )));
+        }
+        if <[u8; 32]>::from(Sha256::digest(&chunk.data)) != chunk.chunk_hash {
+            return Err(SignalBridgeError::InvalidInput(format!(
+                "Chunk {} failed its hash check",
+                chunk.index
+            )));
+        }
+
+        let conn = self.storage.lock().unwrap();
+        let existing: Option<(String, String, Vec<u8>, bool, StoredManifest)> = conn
+            .query_row(
+                "SELECT sender_rdx, path, received, completed, total_size, chunk_size, chunk_count,
+                        file_hash
+                 FROM incoming_transfers WHERE transfer_id = ?1",
+                rusqlite::params![manifest.transfer_id],
+                |row| {
+                    Ok((
+                        row.get(0)?,
+                        row.get(1)?,
+                        row.get(2)?,
+                        row.get(3)?,
+                        (row.get(4)?, row.get(5)?, row.get(6)?, row.get(7)?),
+                    ))
+                },
+            )
+            .optional()?;
+
+        let (mut path, mut received) = match existing {
+            Some((owner, _, _, _, _)) if owner != sender_rdx => {
+                return Err(SignalBridgeError::InvalidInput(
+                    "Transfer belongs to another sender".to_string(),
+                ))
+            }
+            Some((_, _, _, _, stored)) if stored != stored_manifest(manifest) => {
+                return Err(SignalBridgeError::InvalidInput(format!(
+                    "Chunk {} does not match the manifest of transfer {}",
+                    chunk.index, manifest.transfer_id
+                )))
+            }
+            Some((_, path, received, true, _)) => {
+                return Ok(self.progress(manifest, sender_rdx, &received, true, path))
+            }
+            Some((_, path, received, false, _)) => (path, received),
+            None => {
+                std::fs::create_dir_all(&self.download_dir)?;
+                let path = self.download_dir.join(&manifest.name);
+                let part = File::create(self.part_path(&manifest.transfer_id))?;
+                part.set_len(manifest.total_size)?;
+                let received = bitmap_new(manifest.chunk_count);
+                let now = SystemTime::now().duration_since(UNIX_EPOCH)?.as_secs();
+                conn.execute(
+                    "INSERT INTO incoming_transfers
+                     (transfer_id, sender_rdx, name, path, total_size, chunk_size, chunk_count,
+                      file_hash, received, created_at)
+                     VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10)",
+                    rusqlite::params![
+                        manifest.transfer_id,
+                        sender_rdx,
+                        manifest.name,
+                        path.to_string_lossy(),
+                        manifest.total_size,
+                        manifest.chunk_size,
+                        manifest.chunk_count,
+                        manifest.file_hash.to_vec(),
+                        received,
+                        now
+                    ],
+                )?;
+                (path.to_string_lossy().into_owned(), received)
+            }
+        };
+
+        if bitmap_get(&received, chunk.index) {
+            return Ok(self.progress(manifest, sender_rdx, &received, false, path));
+        }
+
+        let part_path = self.part_path(&manifest.transfer_id);
+        let mut part = OpenOptions::new().write(true).open(&part_path)?;
+        part.seek(SeekFrom::Start(
+            u64::from(chunk.index) * u64::from(manifest.chunk_size),
+        ))?;
+        part.write_all(&chunk.data)?;
+        bitmap_set(&mut received, chunk.index);
+
+        let complete = bitmap_count(&received, manifest.chunk_count) == manifest.chunk_count;
+        if complete {
+            part.sync_all()?;
+            drop(part);
+            if hash_file(&part_path)? != manifest.file_hash {
+                let _ = std::fs::remove_file(&part_path);
+                conn.execute(
+                    "DELETE FROM incoming_transfers WHERE transfer_id = ?1",
+                    rusqlite::params![manifest.transfer_id],
+                )?;
+                return Err(SignalBridgeError::InvalidInput(format!(
+                    "Transfer {} failed its file hash check",
+                    manifest.transfer_id
+                )));
+            }
+            let final_path = reserve_unique_path(&self.download_dir, &manifest.name)?;
+            std::fs::rename(&part_path, &final_path)?;
+            path = final_path.to_string_lossy().into_owned();
+        }
+
+        conn.execute(
+            "UPDATE incoming_transfers SET received = ?1, completed = ?2, path = ?3
+             WHERE transfer_id = ?4",
+            rusqlite::params![received, complete, path, manifest.transfer_id],
+        )?;
+        Ok(self.progress(manifest, sender_rdx, &received, complete, path))
+    }
+
+    fn part_path(&self, transfer_id: &str) -> PathBuf {
+        self.download_dir.join(format!("{}.part", transfer_id))
+    }
+
+    fn progress(
+        &self,
+        manifest: &TransferManifest,
+        sender_rdx: &str,
+        received: &[u8],
+        complete: bool,
+        path: String,
+    ) -> TransferProgress {
+        TransferProgress {
+            transfer_id: manifest.transfer_id.clone(),
+            name: manifest.name.clone(),
+            sender_rdx: sender_rdx.to_string(),
+            received_chunks: bitmap_count(received, manifest.chunk_count),
+            chunk_count: manifest.chunk_count,
+            complete,
+            path,
+        }
+    }
+}
+
+fn sanitized_name(path: &str) -> Result<String, SignalBridgeError> {
+    Path::new(path)
+        .file_name()
+        .and_then(|name| name.to_str())
+        .filter(|name| !name.is_empty() && !name.starts_with('.'))
+        .map(str::to_string)
+        .ok_or_else(|| SignalBridgeError::InvalidInput(format!("Not a file name: {}", path)))
+}
+
+/// Size, chunk size, chunk count, and file hash of a transfer as stored for its first chunk
+type StoredManifest = (u64, u32, u32, Vec<u8>);
+
+fn stored_manifest(manifest: &TransferManifest) -> StoredManifest {
+    (
+        manifest.total_size,
+        manifest.chunk_size,
+        manifest.chunk_count,
+        manifest.file_hash.to_vec(),
+    )
+}
+
+fn validate_manifest(manifest: &TransferManifest) -> Result<(), SignalBridgeError> {
+    if Uuid::parse_str(&manifest.transfer_id).is_err() {
+        return Err(SignalBridgeError::InvalidInput(
+            "Malformed transfer ID".to_string(),
+        ));
+    }
+    if sanitized_name(&manifest.name)? != manifest.name {
+        return Err(SignalBridgeError::InvalidInput(
+            "Transfer name must not contain a path".to_string(),
+        ));
+    }
+    if manifest.total_size == 0
+        || manifest.total_size > MAX_TRANSFER_SIZE
+        || manifest.chunk_size == 0
+        || manifest.chunk_size > CHUNK_SIZE
+        || manifest.chunk_count != chunk_count_for(manifest.total_size, manifest.chunk_size)?
+    {
+        return Err(SignalBridgeError::InvalidInput(
+            "Inconsistent transfer manifest".to_string(),
+        ));
+    }
+    Ok(())
+}
+
+fn chunk_count_for(total_size: u64, chunk_size: u32) -> Result<u32, SignalBridgeError> {
+    Ok(u32::try_from(total_size.div_ceil(u64::from(chunk_size)))?)
+}
+
+fn chunk_length(manifest: &TransferManifest, index: u32) -> Result<usize, SignalBridgeError> {
+    if index >= manifest.chunk_count {
+        return Err(SignalBridgeError::InvalidInput(format!(
+            "Chunk {} out of range",
+            index
+        )));
+    }
+    let offset = u64::from(index) * u64::from(manifest.chunk_size);
+    let length = (manifest.total_size - offset).min(u64::from(manifest.chunk_size));
+    Ok(usize::try_from(length)?)
+}
+
+/// Creates an empty file at the first free variant of `name`, so no other transfer can take it
+fn reserve_unique_path(dir: &Path, name: &str) -> std::io::Result<PathBuf> {
+    let mut attempt = 0u32;
+    loop {
+        let candidate = match attempt {
+            0 => dir.join(name),
+            n => dir.join(format!("{} ({})", name, n)),
+        };
+        match OpenOptions::new()
+            .write(true)
+            .create_new(true)
+            .open(&candidate)
+        {
+            Ok(_) => return Ok(candidate),
+            Err(e) if e.kind() == std::io::ErrorKind::AlreadyExists => attempt += 1,
+            Err(e) => return Err(e),
+        }
+    }
+}
+
+fn hash_file(path: &Path) -> Result<[u8; 32], SignalBridgeError> {
+    let mut file = File::open(path)?;
+    let mut hasher = Sha256::new();
+    let mut buffer = vec![0u8; CHUNK_SIZE as usize];
+    loop {
+        let read = file.read(&mut buffer)?;
+        if read == 0 {
+            break;
+        }
+        hasher.update(&buffer[..read]);
+    }
+    Ok(hasher.finalize().into())
+}
+
+fn hash_from_blob(blob: Vec<u8>) -> [u8; 32] {
+    let mut hash = [0u8; 32];
+    let length = blob.len().min(hash.len());
+    hash[..length].copy_from_slice(&blob[..length]);
+    hash
+}
+
+fn bitmap_new(bits: u32) -> Vec<u8> {
+    vec![0u8; bits.div_ceil(8) as usize]
+}
+
+fn bitmap_get(bitmap: &[u8], bit: u32) -> bool {
+    bitmap
+        .get((bit / 8) as usize)
+        .is_some_and(|byte| byte & (1 << (bit % 8)) != 0)
+}
+
+fn bitmap_set(bitmap: &mut [u8], bit: u32) {
+    if let Some(byte) = bitmap.get_mut((bit / 8) as usize) {
+        *byte |= 1 << (bit % 8);
+    }
+}
+
+fn bitmap_count(bitmap: &[u8], bits: u32) -> u32 {
+    (0..bits).filter(|bit| bitmap_get(bitmap, *bit)).count() as u32
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn manager(dir: &Path) -> FileTransferManager {
+        let conn = Connection::open_in_memory().unwrap();
+        FileTransferManager::create_tables(&conn).unwrap();
+        FileTransferManager::new(Arc::new(Mutex::new(conn)), dir.join("downloads"))
+    }
+
+    fn scratch_dir(name: &str) -> PathBuf {
+        let dir = std::env::temp_dir().join(format!("radix_transfer_{}_{}", name, Uuid::new_v4()));
+        std::fs::create_dir_all(&dir).unwrap();
+        dir
+    }
+
+    fn sample_file(dir: &Path, size: usize) -> (PathBuf, Vec<u8>) {
+        let contents: Vec<u8> = (0..size).map(|i| (i * 31 % 251) as u8).collect();
+        let path = dir.join("map.bin");
+        std::fs::write(&path, &contents).unwrap();
+        (path, contents)
+    }
+
+    #[test]
+    fn test_out_of_order_chunks_reassemble_to_the_original_file() {
+        let dir = scratch_dir("reassemble");
+        let (path, contents) = sample_file(&dir, CHUNK_SIZE as usize * 2 + 100);
+        let mut sender = manager(&dir.join("alice"));
+        let mut receiver = manager(&dir.join("bob"));
+
+        let transfer = sender
+            .start_outgoing("RDX:bob", path.to_str().unwrap())
+            .unwrap();
+        assert_eq!(transfer.chunk_count, 3);
+        assert_eq!(transfer.pending_chunks, vec![0, 1, 2]);
+
+        let mut last = None;
+        for index in [2, 0, 0, 1] {
+            let (peer, chunk) = sender.read_chunk(&transfer.transfer_id, index).unwrap();
+            assert_eq!(peer, "RDX:bob");
+            last = Some(receiver.receive_chunk("RDX:alice", &chunk).unwrap());
+        }
+
+        let progress = last.unwrap();
+        assert!(progress.complete);
+        assert_eq!(progress.received_chunks, 3);
+        assert_eq!(progress.name, "map.bin");
+        assert_eq!(std::fs::read(&progress.path).unwrap(), contents);
+        let _ = std::fs::remove_dir_all(&dir);
+    }
+
+    #[test]
+    fn test_sender_resumes_with_undelivered_chunks() {
+        let dir = scratch_dir("resume");
+        let (path, _) = sample_file(&dir, CHUNK_SIZE as usize * 3);
+        let mut sender = manager(&dir);
+
+        let transfer = sender
+            .start_outgoing("RDX:bob", path.to_str().unwrap())
+            .unwrap();
+        assert!(!sender.mark_delivered(&transfer.transfer_id, 1).unwrap());
+
+        let pending = sender.pending_outgoing().unwrap();
+        assert_eq!(pending.len(), 1);
+        assert_eq!(pending[0].pending_chunks, vec![0, 2]);
+
+        assert!(!sender.mark_delivered(&transfer.transfer_id, 0).unwrap());
+        assert!(sender.mark_delivered(&transfer.transfer_id, 2).unwrap());
+        assert!(sender.pending_outgoing().unwrap().is_empty());
+        let _ = std::fs::remove_dir_all(&dir);
+    }
+
+    #[test]
+    fn test_tampered_and_malformed_chunks_are_rejected() {
+        let dir = scratch_dir("reject");
+        let (path, _) = sample_file(&dir, 1000);
+        let mut sender = manager(&dir.join("alice"));
+        let mut receiver = manager(&dir.join("bob"));
+        let transfer = sender
+            .start_outgoing("RDX:bob", path.to_str().unwrap())
+            .unwrap();
+        let (_, chunk) = sender.read_chunk(&transfer.transfer_id, 0).unwrap();
+
+        let mut tampered = TransferChunk {
+            manifest: chunk.manifest.clone(),
+            index: 0,
+            chunk_hash: chunk.chunk_hash,
+            data: chunk.data.clone(),
+        };
+        tampered.data[0] ^= 0xff;
+        assert!(receiver.receive_chunk("RDX:alice", &tampered).is_err());
+
+        let mut traversal = TransferChunk {
+            manifest: chunk.manifest.clone(),
+            index: 0,
+            chunk_hash: chunk.chunk_hash,
+            data: chunk.data.clone(),
+        };
+        traversal.manifest.name = "../escape".to_string();
+        assert!(receiver.receive_chunk("RDX:alice", &traversal).is_err());
+
+        let mut wrong_file = TransferChunk {
+            manifest: chunk.manifest.clone(),
+            index: 0,
+            chunk_hash: chunk.chunk_hash,
+            data: chunk.data.clone(),
+        };
+        wrong_file.manifest.file_hash = [0u8; 32];
+        assert!(receiver.receive_chunk("RDX:alice", &wrong_file).is_err());
+
+        assert!(
+            receiver
+                .receive_chunk("RDX:alice", &chunk)
+                .unwrap()
+                .complete
+        );
+        assert!(receiver.receive_chunk("RDX:mallory", &chunk).is_err());
+        let _ = std::fs::remove_dir_all(&dir);
+    }
+
+    #[test]
+    fn test_chunks_must_match_the_manifest_of_the_first_chunk() {
+        let dir = scratch_dir("manifest");
+        let (path, _) = sample_file(&dir, CHUNK_SIZE as usize * 2 + 100);
+        let mut sender = manager(&dir.join("alice"));
+        let mut receiver = manager(&dir.join("bob"));
+        let transfer = sender
+            .start_outgoing("RDX:bob", path.to_str().unwrap())
+            .unwrap();
+        let (_, first) = sender.read_chunk(&transfer.transfer_id, 0).unwrap();
+        receiver.receive_chunk("RDX:alice", &first).unwrap();
+
+        let (_, mut other_file) = sender.read_chunk(&transfer.transfer_id, 1).unwrap();
+        other_file.manifest.file_hash = [0u8; 32];
+        assert!(receiver.receive_chunk("RDX:alice", &other_file).is_err());
+
+        let (_, mut other_size) = sender.read_chunk(&transfer.transfer_id, 1).unwrap();
+        other_size.manifest.total_size += 1;
+        assert!(receiver.receive_chunk("RDX:alice", &other_size).is_err());
+
+        let (_, second) = sender.read_chunk(&transfer.transfer_id, 1).unwrap();
+        let progress = receiver.receive_chunk("RDX:alice", &second).unwrap();
+        assert_eq!(progress.received_chunks, 2);
+        let _ = std::fs::remove_dir_all(&dir);
+    }
+
+    #[test]
+    fn test_interleaved_transfers_of_the_same_name_keep_both_files() {
+        let dir = scratch_dir("same_name");
+        std::fs::create_dir_all(dir.join("one")).unwrap();
+        std::fs::create_dir_all(dir.join("two")).unwrap();
+        let (first_path, first_contents) = sample_file(&dir.join("one"), CHUNK_SIZE as usize + 1);
+        let (second_path, second_contents) = sample_file(&dir.join("two"), CHUNK_SIZE as usize + 2);
+        let mut sender = manager(&dir.join("alice"));
+        let mut receiver = manager(&dir.join("bob"));
+        let first = sender
+            .start_outgoing("RDX:bob", first_path.to_str().unwrap())
+            .unwrap();
+        let second = sender
+            .start_outgoing("RDX:bob", second_path.to_str().unwrap())
+            .unwrap();
+
+        let mut done = Vec::new();
+        for (transfer, index) in [(&first, 0), (&second, 0), (&first, 1), (&second, 1)] {
+            let (_, chunk) = sender.read_chunk(&transfer.transfer_id, index).unwrap();
+            let progress = receiver.receive_chunk("RDX:alice", &chunk).unwrap();
+            if progress.complete {
+                done.push(progress);
+            }
+        }
+
+        assert_eq!(done.len(), 2);
+        assert_eq!(done[0].name, done[1].name);
+        assert_ne!(done[0].path, done[1].path);
+        assert_eq!(std::fs::read(&done[0].path).unwrap(), first_contents);
+        assert_eq!(std::fs::read(&done[1].path).unwrap(), second_contents);
+        let _ = std::fs::remove_dir_all(&dir);
+    }
+
+    #[test]
+    fn test_empty_and_missing_files_cannot_be_sent() {
+        let dir = scratch_dir("invalid");
+        let mut sender = manager(&dir);
+        let empty = dir.join("empty.txt");
+        std::fs::write(&empty, b"").unwrap();
+
+        assert!(sender
+            .start_outgoing("RDX:bob", empty.to_str().unwrap())
+            .is_err());
+        assert!(sender
+            .start_outgoing("RDX:bob", dir.join("missing").to_str().unwrap())
+            .is_err());
+        let _ = std::fs::remove_dir_all(&dir);
+    }
+}
@@ -0,0 +1,372 @@
+//! Group channel management for Radix Relay
+//!
+//! Groups are built on Signal sender keys: every member hands each other member a
+//! `SenderKeyDistributionMessage` once, over the existing pairwise session, and from then on a
+//! broadcast is a single `group_encrypt` whose ciphertext every member can decrypt. This module
+//! keeps the group roster and remembers which members already hold this node's sender key; the
+//! sender key material itself lives in the `sender_keys` table owned by
+//! [`crate::sqlite_storage::SqliteSenderKeyStore`].
+
+use crate::SignalBridgeError;
+use rusqlite::{Connection, OptionalExtension};
+use serde::{Deserialize, Serialize};
+use std::sync::{Arc, Mutex};
+use std::time::{SystemTime, UNIX_EPOCH};
+use uuid::Uuid;
+
+/// A group channel and its other members
+#[derive(Clone, Debug)]
+pub struct GroupInfo {
+    /// Sender key distribution ID, shared by all members and used as the group identifier
+    pub distribution_id: Uuid,
+    /// Human-readable group name
+    pub name: String,
+    /// RDX fingerprints of the other members
+    pub members: Vec<String>,
+}
+
+/// Payload carried inside a pairwise-encrypted sender key distribution
+#[derive(Serialize, Deserialize, Debug, PartialEq)]
+pub struct GroupInvitation {
+    /// Sender key distribution ID of the group
+    pub distribution_id: String,
+    /// Human-readable group name
+    pub name: String,
+    /// RDX fingerprints of every member, including the sender
+    pub members: Vec<String>,
+    /// Serialized `SenderKeyDistributionMessage`, base64-encoded
+    pub sender_key: String,
+}
+
+/// Manages the group roster separately from Signal Protocol key storage
+pub struct GroupManager {
+    storage: Arc<Mutex<Connection>>,
+}
+
+impl GroupManager {
+    /// Creates a new group manager with the given database connection
+    pub fn new(storage_connection: Arc<Mutex<Connection>>) -> Self {
+        Self {
+            storage: storage_connection,
+        }
+    }
+
+    pub fn create_tables(conn: &Connection) -> Result<(), Box<dyn std::error::Error>> {
+        conn.execute(
+            "CREATE TABLE IF NOT EXISTS groups (
+                distribution_id TEXT PRIMARY KEY,
+                name TEXT NOT NULL,
+                created_at INTEGER NOT NULL
+            )",
+            [],
+        )?;
+
+        conn.execute(
+            "CREATE INDEX IF NOT EXISTS idx_groups_name ON groups(name)",
+            [],
+        )?;
+
+        conn.execute(
+            "CREATE TABLE IF NOT EXISTS group_members (
+                distribution_id TEXT NOT NULL,
+                rdx_fingerprint TEXT NOT NULL,
+                sender_key_sent BOOLEAN DEFAULT 0,
+                PRIMARY KEY (distribution_id, rdx_fingerprint),
+                FOREIGN KEY (distribution_id) REFERENCES groups(distribution_id) ON DELETE CASCADE
+            )",
+            [],
+        )?;
+
+        Ok(())
+    }
+
+    /// Creates a new group with a fresh distribution ID
+    ///
+    /// # Arguments
+    /// * `name` - Human-readable group name
+    /// * `members` - RDX fingerprints of the other members
+    ///
+    /// # Returns
+    /// Distribution ID of the new group
+    pub fn create_group(
+        &mut self,
+        name: &str,
+        members: &[String],
+    ) -> Result<Uuid, SignalBridgeError> {
+        let distribution_id = Uuid::new_v4();
+        self.join_group(distribution_id, name, members)?;
+        Ok(distribution_id)
+    }
+
+    /// Records a new group and its members
+    ///
+    /// An existing group keeps its name and roster: the distribution ID is public, so an
+    /// invitation naming a known group must not be able to add members to it. Repeated
+    /// distributions for the same group are harmless.
+    ///
+    /// # Arguments
+    /// * `distribution_id` - Distribution ID of the group
+    /// * `name` - Human-readable group name
+    /// * `members` - RDX fingerprints of the other members
+    pub fn join_group(
+        &mut self,
+        distribution_id: Uuid,
+        name: &str,
+        members: &[String],
+    ) -> Result<(), SignalBridgeError> {
+        let now = SystemTime::now().duration_since(UNIX_EPOCH)?.as_secs();
+        let mut conn_lock = self.storage.lock().unwrap();
+        let tx = conn_lock.transaction()?;
+
+        let created = tx.execute(
+            "INSERT OR IGNORE INTO groups (distribution_id, name, created_at) VALUES (?1, ?2, ?3)",
+            rusqlite::params![distribution_id.to_string(), name, now],
+        )? > 0;
+        if !created {
+            return Ok(());
+        }
+        for member in members {
+            tx.execute(
+                "INSERT OR IGNORE INTO group_members (distribution_id, rdx_fingerprint)
+                 VALUES (?1, ?2)",
+                rusqlite::params![distribution_id.to_string(), member],
+            )?;
+        }
+
+        tx.commit()?;
+        Ok(())
+    }
+
+    /// Looks up a group by distribution ID or name
+    ///
+    /// # Arguments
+    /// * `identifier` - Distribution ID or group name
+    pub fn lookup_group(&self, identifier: &str) -> Result<GroupInfo, SignalBridgeError> {
+        let conn_lock = self.storage.lock().unwrap();
+
+        let by_id: Option<(String, String)> = conn_lock
+            .query_row(
+                "SELECT distribution_id, name FROM groups WHERE distribution_id = ?1",
+                rusqlite::params![identifier],
+                |row| Ok((row.get(0)?, row.get(1)?)),
+            )
+            .optional()?;
+
+        let (distribution_id, name) = match by_id {
+            Some(group) => group,
+            None => {
+                let mut stmt = conn_lock
+                    .prepare("SELECT distribution_id, name FROM groups WHERE name = ?1")?;
+                let matches = stmt
+                    .query_map(rusqlite::params![identifier], |row| {
+                        Ok((row.get::<_, String>(0)?, row.get::<_, String>(1)?))
+                    })?
+                    .collect::<Result<Vec<_>, _>>()?;
+                match matches.len() {
+                    0 => {
+                        return Err(SignalBridgeError::InvalidInput(format!(
+                            "Group not found: {}",
+                            identifier
+                        )))
+                    }
+                    1 => matches.into_iter().next().unwrap(),
+                    _ => {
+                        return Err(SignalBridgeError::InvalidInput(format!(
+                            "Group name '{}' is ambiguous, use its distribution ID",
+                            identifier
+                        )))
+                    }
+                }
+            }
+        };
+
+        let mut stmt = conn_lock.prepare(
+            "SELECT rdx_fingerprint FROM group_members WHERE distribution_id = ?1
+             ORDER BY rdx_fingerprint",
+        )?;
+        let members = stmt
+            .query_map(rusqlite::params![distribution_id], |row| row.get(0))?
+            .collect::<Result<Vec<String>, _>>()?;
+
+        Ok(GroupInfo {
+            distribution_id: Uuid::parse_str(&distribution_id)
+                .map_err(|e| SignalBridgeError::Storage(e.to_string()))?,
+            name,
+            members,
+        })
+    }
+
+    /// Returns the other members of a group, or `None` if the group is unknown
+    ///
+    /// # Arguments
+    /// * `distribution_id` - Distribution ID of the group
+    pub fn group_members(
+        &self,
+        distribution_id: Uuid,
+    ) -> Result<Option<Vec<String>>, SignalBridgeError> {
+        let conn_lock = self.storage.lock().unwrap();
+        let known: Option<i64> = conn_lock
+            .query_row(
+                "SELECT 1 FROM groups WHERE distribution_id = ?1",
+                rusqlite::params![distribution_id.to_string()],
+                |row| row.get(0),
+            )
+            .optional()?;
+        if known.is_none() {
+            return Ok(None);
+        }
+
+        let mut stmt = conn_lock.prepare(
+            "SELECT rdx_fingerprint FROM group_members WHERE distribution_id = ?1
+             ORDER BY rdx_fingerprint",
+        )?;
+        let members = stmt
+            .query_map(rusqlite::params![distribution_id.to_string()], |row| {
+                row.get(0)
+            })?
+            .collect::<Result<Vec<String>, _>>()?;
+        Ok(Some(members))
+    }
+
+    /// Returns the members that have not yet been sent this node's sender key
+    ///
+    /// # Arguments
+    /// * `distribution_id` - Distribution ID of the group
+    pub fn members_awaiting_sender_key(
+        &self,
+        distribution_id: Uuid,
+    ) -> Result<Vec<String>, SignalBridgeError> {
+        let conn_lock = self.storage.lock().unwrap();
+        let mut stmt = conn_lock.prepare(
+            "SELECT rdx_fingerprint FROM group_members
+             WHERE distribution_id = ?1 AND sender_key_sent = 0
+             ORDER BY rdx_fingerprint",
+        )?;
+        let members = stmt
+            .query_map(rusqlite::params![distribution_id.to_string()], |row| {
+                row.get(0)
+            })?
+            .collect::<Result<Vec<String>, _>>()?;
+        Ok(members)
+    }
+
+    /// Marks that a member now holds this node's sender key for a group
+    ///
+    /// # Arguments
+    /// * `distribution_id` - Distribution ID of the group
+    /// * `rdx_fingerprint` - Member that was sent the distribution message
+    pub fn mark_sender_key_sent(
+        &mut self,
+        distribution_id: Uuid,
+        rdx_fingerprint: &str,
+    ) -> Result<(), SignalBridgeError> {
+        let conn_lock = self.storage.lock().unwrap();
+        conn_lock.execute(
+            "UPDATE group_members SET sender_key_sent = 1
+             WHERE distribution_id = ?1 AND rdx_fingerprint = ?2",
+            rusqlite::params![distribution_id.to_string(), rdx_fingerprint],
+        )?;
+        Ok(())
+    }
+
+    /// Returns the distribution IDs of every known group
+    pub fn list_group_ids(&self) -> Result<Vec<String>, SignalBridgeError> {
+        let conn_lock = self.storage.lock().unwrap();
+        let mut stmt =
+            conn_lock.prepare("SELECT distribution_id FROM groups ORDER BY distribution_id")?;
+        let ids = stmt
+            .query_map([], |row| row.get(0))?
+            .collect::<Result<Vec<String>, _>>()?;
+        Ok(ids)
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn manager() -> GroupManager {
+        let conn = Connection::open_in_memory().unwrap();
+        GroupManager::create_tables(&conn).unwrap();
+        GroupManager::new(Arc::new(Mutex::new(conn)))
+    }
+
+    #[test]
+    fn test_create_and_lookup_group_by_id_and_name() {
+        let mut groups = manager();
+        let members = vec!["RDX:bob".to_string(), "RDX:carol".to_string()];
+
+        let id = groups.create_group("ops", &members).unwrap();
+
+        let by_id = groups.lookup_group(&id.to_string()).unwrap();
+        let by_name = groups.lookup_group("ops").unwrap();
+        assert_eq!(by_id.distribution_id, id);
+        assert_eq!(by_name.distribution_id, id);
+        assert_eq!(by_name.members, members);
+        assert!(groups.lookup_group("missing").is_err());
+    }
+
+    #[test]
+    fn test_ambiguous_group_name_is_rejected() {
+        let mut groups = manager();
+        groups
+            .create_group("ops", &["RDX:bob".to_string()])
+            .unwrap();
+        groups
+            .create_group("ops", &["RDX:carol".to_string()])
+            .unwrap();
+
+        assert!(groups.lookup_group("ops").is_err());
+    }
+
+    #[test]
+    fn test_sender_key_distribution_is_tracked_per_member() {
+        let mut groups = manager();
+        let id = groups
+            .create_group("ops", &["RDX:bob".to_string(), "RDX:carol".to_string()])
+            .unwrap();
+
+        groups.mark_sender_key_sent(id, "RDX:bob").unwrap();
+        assert_eq!(
+            groups.members_awaiting_sender_key(id).unwrap(),
+            vec!["RDX:carol".to_string()]
+        );
+
+        groups
+            .join_group(
+                id,
+                "renamed",
+                &["RDX:bob".to_string(), "RDX:carol".to_string()],
+            )
+            .unwrap();
+        let group = groups.lookup_group(&id.to_string()).unwrap();
+        assert_eq!(group.name, "ops");
+        assert_eq!(group.members.len(), 2);
+        assert_eq!(
+            groups.members_awaiting_sender_key(id).unwrap(),
+            vec!["RDX:carol".to_string()]
+        );
+    }
+
+    #[test]
+    fn test_joining_a_known_group_does_not_widen_its_roster() {
+        let mut groups = manager();
+        let id = groups
+            .create_group("ops", &["RDX:bob".to_string()])
+            .unwrap();
+
+        groups
+            .join_group(
+                id,
+                "ops",
+                &["RDX:bob".to_string(), "RDX:mallory".to_string()],
+            )
+            .unwrap();
+
+        assert_eq!(
+            groups.group_members(id).unwrap(),
+            Some(vec!["RDX:bob".to_string()])
+        );
+        assert_eq!(groups.group_members(Uuid::new_v4()).unwrap(), None);
+    }
+}
@@ -0,0 +1,406 @@
+//! Background key factory for Signal Protocol pre-keys
+//!
+//! Key pair generation (Kyber1024 in particular) is the most expensive work the bridge does.
+//! The factory keeps a reserve of ready-made one-time pre-key pairs plus the next signed
+//! pre-key and Kyber pre-key pairs, and refills that reserve on a worker thread. Rotation and
+//! replenishment then only assign IDs, sign, and store keys that already exist.
+//!
+//! The worker starts on first use, so bridges that never run key maintenance never spawn it.
+
+use libsignal_protocol::{kem, KeyPair};
+use std::collections::VecDeque;
+use std::sync::{Arc, Condvar, Mutex, MutexGuard, OnceLock};
+use std::thread::JoinHandle;
+
+/// Default number of one-time pre-key pairs kept in reserve
+pub const DEFAULT_PRE_KEY_RESERVE: usize = crate::key_rotation::REPLENISH_COUNT as usize;
+
+/// Number of one-time pre-key pairs generated per worker iteration
+const PRE_KEY_BATCH_SIZE: usize = 10;
+
+/// Supplier of the key pairs that rotation and replenishment sign and store
+pub trait KeySource {
+    /// Returns exactly `count` one-time pre-key pairs
+    fn take_pre_keys(&self, count: usize) -> Vec<KeyPair>;
+
+    /// Returns the key pair for the next signed pre-key
+    fn take_signed_pre_key(&self) -> KeyPair;
+
+    /// Returns the key pair for the next Kyber pre-key
+    fn take_kyber_pre_key(&self) -> kem::KeyPair;
+}
+
+/// Key source that generates every key pair on the calling thread
+#[derive(Debug, Clone, Copy, Default)]
+pub struct InlineKeySource;
+
+impl KeySource for InlineKeySource {
+    fn take_pre_keys(&self, count: usize) -> Vec<KeyPair> {
+        let mut rng = rand::rng();
+        (0..count).map(|_| KeyPair::generate(&mut rng)).collect()
+    }
+
+    fn take_signed_pre_key(&self) -> KeyPair {
+        KeyPair::generate(&mut rand::rng())
+    }
+
+    fn take_kyber_pre_key(&self) -> kem::KeyPair {
+        kem::KeyPair::generate(kem::KeyType::Kyber1024, &mut rand::rng())
+    }
+}
+
+/// Key pairs claimed ahead of a maintenance run
+///
+/// Claiming may generate keys when the reserve runs dry, so it happens before the bridge is
+/// locked; the run itself then only signs and stores. Anything not claimed up front is
+/// generated inline.
+#[derive(Default)]
+pub struct PreparedKeys {
+    pre_keys: Mutex<Vec<KeyPair>>,
+    signed_pre_key: Mutex<Option<KeyPair>>,
+    kyber_pre_key: Mutex<Option<kem::KeyPair>>,
+}
+
+impl KeySource for PreparedKeys {
+    fn take_pre_keys(&self, count: usize) -> Vec<KeyPair> {
+        let mut key_pairs = std::mem::take(
+            &mut *self
+                .pre_keys
+                .lock()
+                .unwrap_or_else(|poisoned| poisoned.into_inner()),
+        );
+        key_pairs.truncate(count);
+        let shortfall = count - key_pairs.len();
+        key_pairs.extend(InlineKeySource.take_pre_keys(shortfall));
+        key_pairs
+    }
+
+    fn take_signed_pre_key(&self) -> KeyPair {
+        self.signed_pre_key
+            .lock()
+            .unwrap_or_else(|poisoned| poisoned.into_inner())
+            .take()
+            .unwrap_or_else(|| InlineKeySource.take_signed_pre_key())
+    }
+
+    fn take_kyber_pre_key(&self) -> kem::KeyPair {
+        self.kyber_pre_key
+            .lock()
+            .unwrap_or_else(|poisoned| poisoned.into_inner())
+            .take()
+            .unwrap_or_else(|| InlineKeySource.take_kyber_pre_key())
+    }
+}
+
+/// Snapshot of what the factory currently holds
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub struct KeyReserveStatus {
+    /// Ready one-time pre-key pairs
+    pub pre_keys: usize,
+    /// Whether the next signed pre-key pair is ready
+    pub signed_pre_key_ready: bool,
+    /// Whether the next Kyber pre-key pair is ready
+    pub kyber_pre_key_ready: bool,
+}
+
+struct Reserve {
+    pre_keys: VecDeque<KeyPair>,
+    signed_pre_key: Option<KeyPair>,
+    kyber_pre_key: Option<kem::KeyPair>,
+    pre_key_target: usize,
+    shutdown: bool,
+}
+
+impl Reserve {
+    fn is_full(&self) -> bool {
+        self.kyber_pre_key.is_some()
+            && self.signed_pre_key.is_some()
+            && self.pre_keys.len() >= self.pre_key_target
+    }
+}
+
+struct Shared {
+    reserve: Mutex<Reserve>,
+    wake: Condvar,
+}
+
+impl Shared {
+    fn lock(&self) -> MutexGuard<'_, Reserve> {
+        self.reserve
+            .lock()
+            .unwrap_or_else(|poisoned| poisoned.into_inner())
+    }
+}
+
+/// Pre-generates key pairs off the caller's thread
+pub struct KeyFactory {
+    shared: Arc<Shared>,
+    worker: OnceLock<Option<JoinHandle<()>>>,
+}
+
+impl KeyFactory {
+    /// Creates a factory with an empty reserve
+    ///
+    /// The refill worker is not started until the factory is first used.
+    ///
+    /// # Arguments
+    /// * `pre_key_reserve` - Number of one-time pre-key pairs to keep ready
+    pub fn new(pre_key_reserve: usize) -> Self {
+        let shared = Arc::new(Shared {
+            reserve: Mutex::new(Reserve {
+                pre_keys: VecDeque::with_capacity(pre_key_reserve),
+                signed_pre_key: None,
+                kyber_pre_key: None,
+                pre_key_target: pre_key_reserve,
+                shutdown: false,
+            }),
+            wake: Condvar::new(),
+        });
+
+        Self {
+            shared,
+            worker: OnceLock::new(),
+        }
+    }
+
+    /// Starts the refill worker if it is not running yet
+    pub fn start(&self) {
+        self.worker.get_or_init(|| {
+            let worker_shared = Arc::clone(&self.shared);
+            std::thread::Builder::new()
+                .name("signal-key-factory".to_string())
+                .spawn(move || Self::refill_loop(&worker_shared))
+                .ok()
+        });
+    }
+
+    /// Claims the key pairs a maintenance run will need and starts the worker
+    ///
+    /// # Arguments
+    /// * `signed_pre_key` - Whether a signed pre-key will be rotated
+    /// * `kyber_pre_key` - Whether a Kyber pre-key will be rotated
+    /// * `pre_key_count` - Number of one-time pre-keys that will be stored
+    pub fn prepare(
+        &self,
+        signed_pre_key: bool,
+        kyber_pre_key: bool,
+        pre_key_count: usize,
+    ) -> PreparedKeys {
+        self.start();
+        PreparedKeys {
+            pre_keys: Mutex::new(self.take_pre_keys(pre_key_count)),
+            signed_pre_key: Mutex::new(signed_pre_key.then(|| self.take_signed_pre_key())),
+            kyber_pre_key: Mutex::new(kyber_pre_key.then(|| self.take_kyber_pre_key())),
+        }
+    }
+
+    /// Reports what the reserve currently holds
+    pub fn status(&self) -> KeyReserveStatus {
+        let reserve = self.shared.lock();
+        KeyReserveStatus {
+            pre_keys: reserve.pre_keys.len(),
+            signed_pre_key_ready: reserve.signed_pre_key.is_some(),
+            kyber_pre_key_ready: reserve.kyber_pre_key.is_some(),
+        }
+    }
+
+    /// Blocks until the reserve is full or the timeout elapses
+    ///
+    /// # Returns
+    /// true if the reserve is full
+    pub fn wait_until_full(&self, timeout: std::time::Duration) -> bool {
+        self.start();
+        let reserve = self.shared.lock();
+        let (reserve, _) = self
+            .shared
+            .wake
+            .wait_timeout_while(reserve, timeout, |reserve| !reserve.is_full())
+            .unwrap_or_else(|poisoned| poisoned.into_inner());
+        reserve.is_full()
+    }
+
+    fn refill_loop(shared: &Shared) {
+        let mut rng = rand::rng();
+        loop {
+            let (need_kyber, need_signed, pre_key_shortfall) = {
+                let mut reserve = shared.lock();
+                while !reserve.shutdown && reserve.is_full() {
+                    reserve = shared
+                        .wake
+                        .wait(reserve)
+                        .unwrap_or_else(|poisoned| poisoned.into_inner());
+                }
+                if reserve.shutdown {
+                    return;
+                }
+                (
+                    reserve.kyber_pre_key.is_none(),
+                    reserve.signed_pre_key.is_none(),
+                    reserve
+                        .pre_key_target
+                        .saturating_sub(reserve.pre_keys.len()),
+                )
+            };
+
+            // Generate outside the lock so claims never wait on key generation
+            if need_kyber {
+                let key_pair = kem::KeyPair::generate(kem::KeyType::Kyber1024, &mut rng);
+                shared.lock().kyber_pre_key.get_or_insert(key_pair);
+            } else if need_signed {
+                let key_pair = KeyPair::generate(&mut rng);
+                shared.lock().signed_pre_key.get_or_insert(key_pair);
+            } else {
+                let batch: Vec<KeyPair> = (0..pre_key_shortfall.min(PRE_KEY_BATCH_SIZE))
+                    .map(|_| KeyPair::generate(&mut rng))
+                    .collect();
+                shared.lock().pre_keys.extend(batch);
+            }
+            shared.wake.notify_all();
+        }
+    }
+}
+
+impl KeySource for KeyFactory {
+    /// Takes one-time pre-key pairs from the reserve
+    ///
+    /// Any shortfall is generated inline so callers always receive `count` pairs.
+    fn take_pre_keys(&self, count: usize) -> Vec<KeyPair> {
+        self.start();
+        let mut key_pairs = {
+            let mut reserve = self.shared.lock();
+            let available = count.min(reserve.pre_keys.len());
+            reserve.pre_keys.drain(..available).collect::<Vec<_>>()
+        };
+        self.shared.wake.notify_all();
+
+        let mut rng = rand::rng();
+        while key_pairs.len() < count {
+            key_pairs.push(KeyPair::generate(&mut rng));
+        }
+        key_pairs
+    }
+
+    /// Takes the next signed pre-key pair, generating inline if none is ready
+    fn take_signed_pre_key(&self) -> KeyPair {
+        self.start();
+        let ready = self.shared.lock().signed_pre_key.take();
+        self.shared.wake.notify_all();
+        ready.unwrap_or_else(|| InlineKeySource.take_signed_pre_key())
+    }
+
+    /// Takes the next Kyber pre-key pair, generating inline if none is ready
+    fn take_kyber_pre_key(&self) -> kem::KeyPair {
+        self.start();
+        let ready = self.shared.lock().kyber_pre_key.take();
+        self.shared.wake.notify_all();
+        ready.unwrap_or_else(|| InlineKeySource.take_kyber_pre_key())
+    }
+}
+
+impl Default for KeyFactory {
+    fn default() -> Self {
+        Self::new(DEFAULT_PRE_KEY_RESERVE)
+    }
+}
+
+impl Drop for KeyFactory {
+    fn drop(&mut self) {
+        self.shared.lock().shutdown = true;
+        self.shared.wake.notify_all();
+        if let Some(Some(worker)) = self.worker.take() {
+            let _ = worker.join();
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::time::Duration;
+
+    #[test]
+    fn test_factory_fills_reserve_in_background() {
+        let factory = KeyFactory::new(25);
+
+        assert!(factory.wait_until_full(Duration::from_secs(30)));
+
+        let status = factory.status();
+        assert_eq!(status.pre_keys, 25);
+        assert!(status.signed_pre_key_ready);
+        assert!(status.kyber_pre_key_ready);
+    }
+
+    #[test]
+    fn test_take_pre_keys_returns_requested_count_and_refills() {
+        let factory = KeyFactory::new(10);
+        assert!(factory.wait_until_full(Duration::from_secs(30)));
+
+        let key_pairs = factory.take_pre_keys(15);
+        assert_eq!(key_pairs.len(), 15);
+
+        let distinct: std::collections::HashSet<Vec<u8>> = key_pairs
+            .iter()
+            .map(|pair| pair.public_key.serialize().to_vec())
+            .collect();
+        assert_eq!(distinct.len(), 15);
+
+        assert!(factory.wait_until_full(Duration::from_secs(30)));
+        assert_eq!(factory.status().pre_keys, 10);
+    }
+
+    #[test]
+    fn test_take_rotation_keys_consumes_and_refills() {
+        let factory = KeyFactory::new(0);
+        assert!(factory.wait_until_full(Duration::from_secs(30)));
+
+        let first_kyber = factory.take_kyber_pre_key();
+        let first_signed = factory.take_signed_pre_key();
+        assert!(factory.wait_until_full(Duration::from_secs(30)));
+
+        let second_kyber = factory.take_kyber_pre_key();
+        let second_signed = factory.take_signed_pre_key();
+        assert_ne!(
+            first_kyber.public_key.serialize(),
+            second_kyber.public_key.serialize()
+        );
+        assert_ne!(
+            first_signed.public_key.serialize(),
+            second_signed.public_key.serialize()
+        );
+    }
+
+    #[test]
+    fn test_worker_starts_on_first_use() {
+        let factory = KeyFactory::new(5);
+        assert!(factory.worker.get().is_none());
+        assert_eq!(factory.status().pre_keys, 0);
+
+        assert_eq!(factory.take_pre_keys(3).len(), 3);
+        assert!(factory.worker.get().is_some());
+        assert!(factory.wait_until_full(Duration::from_secs(30)));
+    }
+
+    #[test]
+    fn test_prepared_keys_fall_back_to_inline_generation() {
+        let factory = KeyFactory::new(10);
+        assert!(factory.wait_until_full(Duration::from_secs(30)));
+
+        let prepared = factory.prepare(false, true, 4);
+        assert_eq!(prepared.pre_keys.lock().unwrap().len(), 4);
+        assert!(prepared.signed_pre_key.lock().unwrap().is_none());
+        assert!(prepared.kyber_pre_key.lock().unwrap().is_some());
+
+        assert_eq!(prepared.take_pre_keys(6).len(), 6);
+        assert_eq!(prepared.take_pre_keys(2).len(), 2);
+        let _ = prepared.take_signed_pre_key();
+        let _ = prepared.take_kyber_pre_key();
+        assert!(prepared.kyber_pre_key.lock().unwrap().is_none());
+    }
+
+    #[test]
+    fn test_drop_stops_worker() {
+        let factory = KeyFactory::new(DEFAULT_PRE_KEY_RESERVE);
+        factory.start();
+        drop(factory);
+    }
+}
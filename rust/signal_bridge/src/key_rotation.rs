@@ -3,7 +3,7 @@
 //! Implements periodic rotation of signed pre-keys and Kyber pre-keys,
 //! plus consumption-based pre-key management following Signal Protocol security model.
 
-use crate::keys::{generate_pre_keys, generate_signed_pre_key};
+use crate::key_factory::KeySource;
 use crate::storage_trait::{
     ExtendedKyberPreKeyStore, ExtendedPreKeyStore, ExtendedSignedPreKeyStore,
     SignalStorageContainer,
@@ -19,26 +19,39 @@ pub const ROTATION_INTERVAL_SECS: u64 = 7 * 24 * 60 * 60;
 /// Grace period before deleting old keys (7 days in seconds)
 pub const GRACE_PERIOD_SECS: u64 = 7 * 24 * 60 * 60;
 
-/// Rotates the signed pre-key by generating and storing a new one
+/// Rotates the signed pre-key by signing and storing a new one
 ///
 /// # Arguments
 /// * `storage` - Signal Protocol storage container
 /// * `identity_key_pair` - Identity key pair to sign the new pre-key
+/// * `keys` - Source of the new key pair
 pub async fn rotate_signed_pre_key<S: SignalStorageContainer>(
     storage: &mut S,
     identity_key_pair: &IdentityKeyPair,
+    keys: &impl KeySource,
 ) -> Result<(), Box<dyn std::error::Error>> {
-    let current_max_id = storage
+    let next_id = storage
         .signed_pre_key_store()
         .get_max_signed_pre_key_id()
         .await?
-        .unwrap_or(0);
+        .unwrap_or(0)
+        + 1;
 
-    let new_signed_pre_key = generate_signed_pre_key(identity_key_pair, current_max_id + 1).await?;
+    let key_pair = keys.take_signed_pre_key();
+    let mut rng = rand::rng();
+    let signature = identity_key_pair
+        .private_key()
+        .calculate_signature(&key_pair.public_key.serialize(), &mut rng)?;
+    let timestamp = Timestamp::from_epoch_millis(
+        std::time::SystemTime::now()
+            .duration_since(std::time::UNIX_EPOCH)?
+            .as_millis() as u64,
+    );
+    let record = SignedPreKeyRecord::new(next_id.into(), timestamp, &key_pair, &signature);
 
     storage
         .signed_pre_key_store()
-        .save_signed_pre_key(new_signed_pre_key.id()?, &new_signed_pre_key)
+        .save_signed_pre_key(next_id.into(), &record)
         .await?;
 
     Ok(())
@@ -117,26 +130,30 @@ pub async fn cleanup_expired_signed_pre_keys<S: SignalStorageContainer>(
 /// # Arguments
 /// * `storage` - Signal Protocol storage container
 /// * `pre_key_id` - ID of the pre-key to consume
+/// * `keys` - Source of replacement key pairs
 pub async fn consume_pre_key<S: SignalStorageContainer>(
     storage: &mut S,
     pre_key_id: PreKeyId,
+    keys: &impl KeySource,
 ) -> Result<(), Box<dyn std::error::Error>> {
     storage.pre_key_store().delete_pre_key(pre_key_id).await?;
 
     let current_count = storage.pre_key_store().pre_key_count().await;
     if current_count < MIN_PRE_KEY_COUNT {
-        replenish_pre_keys(storage).await?;
+        replenish_pre_keys(storage, keys).await?;
     }
 
     Ok(())
 }
 
-/// Generates and stores new batch of pre-keys
+/// Stores a new batch of pre-keys
 ///
 /// # Arguments
 /// * `storage` - Signal Protocol storage container
+/// * `keys` - Source of the new key pairs
 pub async fn replenish_pre_keys<S: SignalStorageContainer>(
     storage: &mut S,
+    keys: &impl KeySource,
 ) -> Result<(), Box<dyn std::error::Error>> {
     let next_id = storage
         .pre_key_store()
@@ -145,43 +162,46 @@ pub async fn replenish_pre_keys<S: SignalStorageContainer>(
         .map(|id| id + 1)
         .unwrap_or(1);
 
-    let new_pre_keys = generate_pre_keys(next_id, REPLENISH_COUNT).await?;
+    let key_pairs = keys.take_pre_keys(REPLENISH_COUNT as usize);
 
-    for (key_id, key_pair) in &new_pre_keys {
-        let record = PreKeyRecord::new((*key_id).into(), key_pair);
+    for (key_id, key_pair) in (next_id..).zip(key_pairs.iter()) {
+        let record = PreKeyRecord::new(key_id.into(), key_pair);
         storage
             .pre_key_store()
-            .save_pre_key((*key_id).into(), &record)
+            .save_pre_key(key_id.into(), &record)
             .await?;
     }
 
     Ok(())
 }
 
-/// Rotates the Kyber post-quantum pre-key by generating and storing a new one
+/// Rotates the Kyber post-quantum pre-key by signing and storing a new one
 ///
 /// # Arguments
 /// * `storage` - Signal Protocol storage container
 /// * `identity_key_pair` - Identity key pair to sign the new Kyber pre-key
+/// * `keys` - Source of the new key pair
 pub async fn rotate_kyber_pre_key<S: SignalStorageContainer>(
     storage: &mut S,
     identity_key_pair: &IdentityKeyPair,
+    keys: &impl KeySource,
 ) -> Result<(), Box<dyn std::error::Error>> {
-    let current_max_id = storage
+    let next_id = storage
         .kyber_pre_key_store()
         .get_max_kyber_pre_key_id()
         .await?
-        .unwrap_or(0);
+        .unwrap_or(0)
+        + 1;
 
+    let kyber_keypair = keys.take_kyber_pre_key();
     let mut rng = rand::rng();
-    let kyber_keypair = kem::KeyPair::generate(kem::KeyType::Kyber1024, &mut rng);
     let kyber_signature = identity_key_pair
         .private_key()
         .calculate_signature(&kyber_keypair.public_key.serialize(), &mut rng)?;
 
     let now = std::time::SystemTime::now();
     let kyber_record = KyberPreKeyRecord::new(
-        KyberPreKeyId::from(current_max_id + 1),
+        KyberPreKeyId::from(next_id),
         Timestamp::from_epoch_millis(now.duration_since(std::time::UNIX_EPOCH)?.as_millis() as u64),
         &kyber_keypair,
         &kyber_signature,
@@ -189,7 +209,7 @@ pub async fn rotate_kyber_pre_key<S: SignalStorageContainer>(
 
     storage
         .kyber_pre_key_store()
-        .save_kyber_pre_key(KyberPreKeyId::from(current_max_id + 1), &kyber_record)
+        .save_kyber_pre_key(KyberPreKeyId::from(next_id), &kyber_record)
         .await?;
 
     Ok(())
@@ -266,6 +286,7 @@ pub async fn cleanup_expired_kyber_pre_keys<S: SignalStorageContainer>(
 #[cfg(test)]
 mod tests {
     use super::*;
+    use crate::key_factory::{InlineKeySource, KeyFactory};
     use crate::keys::{generate_identity_key_pair, generate_signed_pre_key};
     use crate::sqlite_storage::SqliteStorage;
     use crate::storage_trait::{
@@ -296,7 +317,7 @@ mod tests {
             1
         );
 
-        rotate_signed_pre_key(&mut storage, &identity_key_pair).await?;
+        rotate_signed_pre_key(&mut storage, &identity_key_pair, &InlineKeySource).await?;
 
         assert_eq!(
             storage.signed_pre_key_store().signed_pre_key_count().await,
@@ -449,7 +470,7 @@ mod tests {
 
         assert_eq!(storage.pre_key_store().pre_key_count().await, 51);
 
-        consume_pre_key(&mut storage, PreKeyId::from(1)).await?;
+        consume_pre_key(&mut storage, PreKeyId::from(1), &InlineKeySource).await?;
 
         assert_eq!(storage.pre_key_store().pre_key_count().await, 50);
 
@@ -463,7 +484,7 @@ mod tests {
 
         assert_eq!(storage.pre_key_store().pre_key_count().await, 0);
 
-        replenish_pre_keys(&mut storage).await?;
+        replenish_pre_keys(&mut storage, &InlineKeySource).await?;
 
         assert_eq!(
             storage.pre_key_store().pre_key_count().await,
@@ -491,7 +512,7 @@ mod tests {
 
         assert_eq!(storage.pre_key_store().pre_key_count().await, 49);
 
-        consume_pre_key(&mut storage, PreKeyId::from(1)).await?;
+        consume_pre_key(&mut storage, PreKeyId::from(1), &InlineKeySource).await?;
 
         assert!(storage.pre_key_store().pre_key_count().await >= MIN_PRE_KEY_COUNT);
 
@@ -531,7 +552,7 @@ mod tests {
 
         assert_eq!(storage.kyber_pre_key_store().kyber_pre_key_count().await, 1);
 
-        rotate_kyber_pre_key(&mut storage, &identity_key_pair).await?;
+        rotate_kyber_pre_key(&mut storage, &identity_key_pair, &InlineKeySource).await?;
 
         assert_eq!(storage.kyber_pre_key_store().kyber_pre_key_count().await, 2);
 
@@ -686,4 +707,74 @@ mod tests {
 
         Ok(())
     }
+
+    #[tokio::test]
+    async fn test_rotation_from_factory_uses_next_ids() -> Result<(), Box<dyn std::error::Error>> {
+        let mut storage = SqliteStorage::new(":memory:").await?;
+        storage.initialize()?;
+
+        let identity_key_pair = generate_identity_key_pair().await?;
+        storage
+            .identity_store()
+            .set_local_identity_key_pair(&identity_key_pair)
+            .await?;
+
+        let factory = KeyFactory::new(REPLENISH_COUNT as usize);
+
+        rotate_signed_pre_key(&mut storage, &identity_key_pair, &factory).await?;
+        rotate_signed_pre_key(&mut storage, &identity_key_pair, &factory).await?;
+        rotate_kyber_pre_key(&mut storage, &identity_key_pair, &factory).await?;
+
+        assert_eq!(
+            storage
+                .signed_pre_key_store()
+                .get_max_signed_pre_key_id()
+                .await?,
+            Some(2)
+        );
+        assert_eq!(
+            storage
+                .kyber_pre_key_store()
+                .get_max_kyber_pre_key_id()
+                .await?,
+            Some(1)
+        );
+
+        let signed = storage
+            .signed_pre_key_store()
+            .get_signed_pre_key(SignedPreKeyId::from(2u32))
+            .await?;
+        assert!(identity_key_pair
+            .identity_key()
+            .public_key()
+            .verify_signature(&signed.public_key()?.serialize(), &signed.signature()?));
+
+        assert!(!signed_pre_key_needs_rotation(&mut storage).await?);
+        assert!(!kyber_pre_key_needs_rotation(&mut storage).await?);
+
+        Ok(())
+    }
+
+    #[tokio::test]
+    async fn test_replenish_from_factory_continues_id_sequence(
+    ) -> Result<(), Box<dyn std::error::Error>> {
+        let mut storage = SqliteStorage::new(":memory:").await?;
+        storage.initialize()?;
+
+        let factory = KeyFactory::new(REPLENISH_COUNT as usize);
+
+        replenish_pre_keys(&mut storage, &InlineKeySource).await?;
+        replenish_pre_keys(&mut storage, &factory).await?;
+
+        assert_eq!(
+            storage.pre_key_store().pre_key_count().await,
+            2 * REPLENISH_COUNT as usize
+        );
+        assert_eq!(
+            storage.pre_key_store().get_max_pre_key_id().await?,
+            Some(2 * REPLENISH_COUNT)
+        );
+
+        Ok(())
+    }
 }
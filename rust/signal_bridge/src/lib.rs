@@ -3,14 +3,20 @@
 //! This crate provides a bridge between Radix Relay's C++ transport layer
 //! and the official Signal Protocol Rust implementation for end-to-end encryption.
 
+pub mod bundle_cache;
 mod contact_manager;
 mod db_encryption;
 mod encryption_trait;
+pub mod event_verification;
+pub mod file_transfer;
+pub mod group_manager;
+pub mod key_factory;
 pub mod key_rotation;
 mod keys;
 pub mod memory_storage;
 pub mod message_history;
 mod nostr_identity;
+pub mod payload_compression;
 mod session_trait;
 pub mod sqlite_storage;
 pub mod storage_trait;
@@ -27,7 +33,13 @@ mod sqlcipher_tests;
 #[cfg(test)]
 mod message_history_tests;
 
+pub use bundle_cache::{BundleCache, CachedBundle};
 pub use contact_manager::{ContactInfo, ContactManager};
+pub use file_transfer::{FileTransferManager, OutgoingTransfer, TransferProgress};
+pub use group_manager::{GroupInfo, GroupInvitation, GroupManager};
+pub use key_factory::{
+    InlineKeySource, KeyFactory, KeyReserveStatus, KeySource, PreparedKeys, DEFAULT_PRE_KEY_RESERVE,
+};
 pub use key_rotation::{
     cleanup_expired_kyber_pre_keys, cleanup_expired_signed_pre_keys, consume_pre_key,
     kyber_pre_key_needs_rotation, replenish_pre_keys, rotate_kyber_pre_key, rotate_signed_pre_key,
@@ -38,6 +50,17 @@ pub use message_history::{
     Conversation, DeliveryStatus, MessageDirection, MessageHistory, MessageType, StoredMessage,
 };
 
+/// Keys a maintenance run found due, decided before any key pairs are claimed
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct KeyMaintenancePlan {
+    /// True if the signed pre-key is older than the rotation interval
+    pub rotate_signed_pre_key: bool,
+    /// True if the Kyber pre-key is older than the rotation interval
+    pub rotate_kyber_pre_key: bool,
+    /// True if fewer one-time pre-keys than the minimum remain
+    pub replenish_pre_keys: bool,
+}
+
 /// Result of key maintenance operations indicating which keys were rotated/replenished
 #[derive(Debug, Clone, Default)]
 pub struct KeyMaintenanceResult {
@@ -62,8 +85,37 @@ use libsignal_protocol::{
 };
 use nostr::{EventBuilder, Keys, Kind, Tag};
 use serde::{Deserialize, Serialize};
+use std::sync::Arc;
 use std::time::{SystemTime, UNIX_EPOCH};
 
+/// Third element of the radix_version tag marking base64 encrypted message content
+///
+/// Receivers treat content as hex when the marker is absent, which is what older peers send.
+pub const BASE64_CONTENT_ENCODING: &str = "base64";
+
+/// Tag on hex encrypted messages listing the content encodings the sender accepts
+///
+/// Peers that predate base64 only decode hex, so a peer gets base64 only once it has sent
+/// base64 content or this tag. Messages that are already base64 leave the tag out.
+pub const CONTENT_ENCODING_TAG: &str = "radix_content_encoding";
+
+/// Tag on encrypted messages listing the plaintext codecs the sender accepts
+///
+/// Only sent by nodes that opted in to payload compression; see [`payload_compression`].
+pub const COMPRESSION_TAG: &str = "radix_compression";
+
+/// Nostr kind of a sender key group message, one event per broadcast
+pub const GROUP_MESSAGE_KIND: u32 = 40005;
+
+/// Nostr kind of a pairwise-encrypted sender key distribution for a group
+pub const SENDER_KEY_DISTRIBUTION_KIND: u32 = 40006;
+
+/// Tag carrying a group's distribution ID on group messages
+pub const GROUP_TAG: &str = "g";
+
+/// Nostr kind of one pairwise-encrypted chunk of a file transfer
+pub const FILE_CHUNK_KIND: u32 = 40007;
+
 #[derive(Serialize, Deserialize, Clone)]
 struct SerializablePreKeyBundle {
     pub registration_id: u32,
@@ -87,12 +139,83 @@ pub struct DecryptionResult {
     pub should_republish_bundle: bool,
 }
 
+/// Group and sender of a processed sender key distribution
+pub struct GroupMembership {
+    /// Distribution ID of the group
+    pub group_id: String,
+    /// Human-readable group name
+    pub name: String,
+    /// RDX fingerprint of the member whose sender key was received
+    pub sender_rdx: String,
+    /// Whether the sender needs this node to republish its bundle
+    pub should_republish_bundle: bool,
+}
+
+/// Result of decrypting an incoming group message
+pub struct GroupDecryptionResult {
+    /// Distribution ID of the group
+    pub group_id: String,
+    /// Human-readable group name
+    pub name: String,
+    /// RDX fingerprint of the sender
+    pub sender_rdx: String,
+    /// Decrypted plaintext bytes
+    pub plaintext: Vec<u8>,
+}
+
+/// One recipient's share of a fan-out send
+pub struct FanOutFrame {
+    /// Recipient as given by the caller
+    pub recipient: String,
+    /// Event ID (hex), empty when encryption failed
+    pub event_id: String,
+    /// Serialized `["EVENT", {...}]` frame, empty when encryption failed
+    pub bytes: Vec<u8>,
+    /// Why this recipient was skipped, empty on success
+    pub error: String,
+}
+
+/// What a node subscribes to in order to receive its messages
+pub struct MessageSubscription {
+    /// Nostr public key (hex) that pairwise events are addressed to
+    pub our_pubkey: String,
+    /// Distribution IDs of the groups this node belongs to
+    pub group_ids: Vec<String>,
+    /// Timestamp to receive events since, 0 for no lower bound
+    pub since: u64,
+}
+
+/// Signed bundle announcement kept until the key material it advertises changes
+struct CachedBundleAnnouncement {
+    /// (pre-key, signed pre-key, Kyber pre-key) IDs embedded in the bundle
+    key_ids: (u32, u32, u32),
+    /// Version string the announcement was tagged with
+    project_version: String,
+    /// Announcement and IDs returned to callers
+    info: ffi::BundleInfo,
+}
+
 /// Main bridge between C++ and Rust Signal Protocol implementation
 pub struct SignalBridge {
     /// SQLite-backed Signal Protocol storage
     pub(crate) storage: SqliteStorage,
     /// Contact/peer management
     contact_manager: ContactManager,
+    /// Group rosters and sender key distribution state
+    group_manager: GroupManager,
+    /// Chunked file transfer progress in both directions
+    file_transfers: FileTransferManager,
+    /// Bundle announcements discovered on relays, kept across restarts
+    bundle_cache: BundleCache,
+    /// Background generator of pre-key pairs used by key maintenance, shared so maintenance
+    /// can claim keys without holding the bridge
+    key_factory: Arc<KeyFactory>,
+    /// Last signed bundle announcement, reused while its keys are still current
+    cached_bundle_announcement: Option<CachedBundleAnnouncement>,
+    /// `created_at` of the last bundle announcement signed, full or empty
+    last_announcement_timestamp: u64,
+    /// Whether this node opted in to compressing outgoing message plaintext
+    payload_compression: bool,
 }
 
 impl SignalBridge {
@@ -176,6 +299,18 @@ impl SignalBridge {
     }
 
     pub async fn new(db_path: &str) -> Result<Self, SignalBridgeError> {
+        Self::new_with_key_reserve(db_path, DEFAULT_PRE_KEY_RESERVE).await
+    }
+
+    /// Opens the bridge with a custom one-time pre-key reserve size for the key factory
+    ///
+    /// # Arguments
+    /// * `db_path` - Path to the SQLite database
+    /// * `pre_key_reserve` - Number of pre-generated one-time pre-key pairs to keep ready
+    pub async fn new_with_key_reserve(
+        db_path: &str,
+        pre_key_reserve: usize,
+    ) -> Result<Self, SignalBridgeError> {
         if let Some(parent) = std::path::Path::new(db_path).parent() {
             std::fs::create_dir_all(parent)?;
         }
@@ -199,10 +334,24 @@ impl SignalBridge {
                  storage.kyber_pre_key_store().kyber_pre_key_count().await);
 
         let contact_manager = ContactManager::new(storage.connection());
+        let group_manager = GroupManager::new(storage.connection());
+        let download_dir = std::path::Path::new(db_path)
+            .parent()
+            .unwrap_or_else(|| std::path::Path::new("."))
+            .join("downloads");
+        let file_transfers = FileTransferManager::new(storage.connection(), download_dir);
+        let bundle_cache = BundleCache::new(storage.connection());
 
         Ok(Self {
             storage,
             contact_manager,
+            group_manager,
+            file_transfers,
+            bundle_cache,
+            key_factory: Arc::new(KeyFactory::new(pre_key_reserve)),
+            cached_bundle_announcement: None,
+            last_announcement_timestamp: 0,
+            payload_compression: false,
         })
     }
 
@@ -211,6 +360,33 @@ impl SignalBridge {
         peer: &str,
         plaintext: &[u8],
     ) -> Result<Vec<u8>, SignalBridgeError> {
+        let (session_address, ciphertext) = self.encrypt_for_peer(peer, plaintext).await?;
+
+        let timestamp = std::time::SystemTime::now()
+            .duration_since(std::time::UNIX_EPOCH)
+            .map_err(|e| SignalBridgeError::Protocol(e.to_string()))?
+            .as_millis() as u64;
+
+        if let Err(e) = self.storage.message_history().store_outgoing_message(
+            &session_address,
+            timestamp,
+            plaintext,
+        ) {
+            eprintln!("Warning: Failed to store outgoing message: {}", e);
+        }
+
+        Ok(ciphertext)
+    }
+
+    /// Encrypts a plaintext for a peer's pairwise session without recording history
+    ///
+    /// # Returns
+    /// RDX fingerprint the session is keyed by, and the serialized ciphertext
+    async fn encrypt_for_peer(
+        &mut self,
+        peer: &str,
+        plaintext: &[u8],
+    ) -> Result<(String, Vec<u8>), SignalBridgeError> {
         if peer.is_empty() {
             return Err(SignalBridgeError::InvalidInput(
                 "Specify a peer name".to_string(),
@@ -239,29 +415,64 @@ impl SignalBridge {
             )));
         }
 
-        let ciphertext = self.storage.encrypt_message(&address, plaintext).await?;
+        let payload = if self.compresses_for(&session_address)? {
+            payload_compression::encode_frame(plaintext)?
+        } else {
+            plaintext.to_vec()
+        };
+        let ciphertext = self.storage.encrypt_message(&address, &payload).await?;
+
+        Ok((session_address, ciphertext.serialize().to_vec()))
+    }
+
+    pub async fn decrypt_message(
+        &mut self,
+        peer_hint: &str,
+        ciphertext_bytes: &[u8],
+    ) -> Result<DecryptionResult, SignalBridgeError> {
+        let (address, pre_key_consumed, payload) =
+            self.decrypt_pairwise(peer_hint, ciphertext_bytes).await?;
+        // The ratchet has already moved past this message, so an error here would lose it for
+        // good. A frame that fails to decode is delivered as received instead.
+        let plaintext = payload_compression::decode_frame(&payload).unwrap_or_else(|e| {
+            eprintln!("Warning: Failed to decode message payload: {}", e);
+            payload
+        });
 
         let timestamp = std::time::SystemTime::now()
             .duration_since(std::time::UNIX_EPOCH)
             .map_err(|e| SignalBridgeError::Protocol(e.to_string()))?
             .as_millis() as u64;
 
-        if let Err(e) = self.storage.message_history().store_outgoing_message(
-            &session_address,
+        let session_established = pre_key_consumed;
+
+        if let Err(e) = self.storage.message_history().store_incoming_message(
+            address.name(),
             timestamp,
-            plaintext,
+            &plaintext,
+            pre_key_consumed,
+            session_established,
         ) {
-            eprintln!("Warning: Failed to store outgoing message: {}", e);
+            eprintln!("Warning: Failed to store incoming message: {}", e);
         }
 
-        Ok(ciphertext.serialize().to_vec())
+        Ok(DecryptionResult {
+            plaintext,
+            should_republish_bundle: pre_key_consumed,
+        })
     }
 
-    pub async fn decrypt_message(
+    /// Decrypts a pairwise Signal message without touching message history
+    ///
+    /// A PreKeySignalMessage from an unknown sender adds them as a contact.
+    ///
+    /// # Returns
+    /// Sender address, whether a one-time pre-key was consumed, and the decrypted bytes
+    async fn decrypt_pairwise(
         &mut self,
         peer_hint: &str,
         ciphertext_bytes: &[u8],
-    ) -> Result<DecryptionResult, SignalBridgeError> {
+    ) -> Result<(ProtocolAddress, bool, Vec<u8>), SignalBridgeError> {
         use crate::contact_manager::ContactManager;
         use libsignal_protocol::{PreKeySignalMessage, SignalMessage};
 
@@ -324,29 +535,90 @@ impl SignalBridge {
             DeviceId::new(1).map_err(|e| SignalBridgeError::Protocol(e.to_string()))?,
         );
 
-        let plaintext = self.storage.decrypt_message(&address, &ciphertext).await?;
+        let payload = self.storage.decrypt_message(&address, &ciphertext).await?;
+        Ok((address, pre_key_consumed, payload))
+    }
 
-        let timestamp = std::time::SystemTime::now()
-            .duration_since(std::time::UNIX_EPOCH)
-            .map_err(|e| SignalBridgeError::Protocol(e.to_string()))?
-            .as_millis() as u64;
+    /// Opts this node in or out of payload compression
+    ///
+    /// While enabled, outgoing encrypted messages advertise zstd support and plaintext sent to
+    /// peers that advertised it too is compressed before encryption. Incoming frames are
+    /// decoded either way.
+    pub fn set_payload_compression(&mut self, enabled: bool) {
+        self.payload_compression = enabled;
+    }
 
-        let session_established = pre_key_consumed;
+    /// Records whether a peer's latest message advertised zstd support
+    ///
+    /// Stored with the contact, so compression survives a restart.
+    ///
+    /// # Arguments
+    /// * `rdx_fingerprint` - RDX fingerprint of the sender
+    /// * `supported` - Whether the message carried the zstd capability
+    pub fn record_peer_compression(
+        &mut self,
+        rdx_fingerprint: &str,
+        supported: bool,
+    ) -> Result<(), SignalBridgeError> {
+        self.contact_manager
+            .set_accepts_zstd(rdx_fingerprint, supported)
+    }
 
-        if let Err(e) = self.storage.message_history().store_incoming_message(
-            address.name(),
-            timestamp,
-            &plaintext,
-            pre_key_consumed,
-            session_established,
-        ) {
-            eprintln!("Warning: Failed to store incoming message: {}", e);
+    /// Records whether a peer's latest message showed it accepts base64 content
+    ///
+    /// Stored with the contact, so the encoding survives a restart.
+    ///
+    /// # Arguments
+    /// * `rdx_fingerprint` - RDX fingerprint of the sender
+    /// * `supported` - Whether the message was base64 or listed base64 in its tags
+    pub fn record_peer_base64_content(
+        &mut self,
+        rdx_fingerprint: &str,
+        supported: bool,
+    ) -> Result<(), SignalBridgeError> {
+        self.contact_manager
+            .set_accepts_base64_content(rdx_fingerprint, supported)
+    }
+
+    /// Builds the tags and content of an encrypted message event
+    ///
+    /// Content is base64 for peers that showed they accept it and hex otherwise, since hex is
+    /// the only encoding peers that predate the marker decode.
+    fn encrypted_message_parts(
+        &self,
+        peer: &str,
+        recipient_pubkey: String,
+        ciphertext: &[u8],
+        project_version: &str,
+    ) -> Result<(Vec<Vec<String>>, String), SignalBridgeError> {
+        let base64 = self.contact_manager.accepts_base64_content(peer)?;
+
+        let mut version_tag = vec!["radix_version".to_string(), project_version.to_string()];
+        if base64 {
+            version_tag.push(BASE64_CONTENT_ENCODING.to_string());
+        }
+        let mut tags = vec![vec!["p".to_string(), recipient_pubkey], version_tag];
+        if self.payload_compression {
+            tags.push(vec![
+                COMPRESSION_TAG.to_string(),
+                payload_compression::ZSTD_CAPABILITY.to_string(),
+            ]);
         }
 
-        Ok(DecryptionResult {
-            plaintext,
-            should_republish_bundle: pre_key_consumed,
-        })
+        let content = if base64 {
+            base64::engine::general_purpose::STANDARD.encode(ciphertext)
+        } else {
+            tags.push(vec![
+                CONTENT_ENCODING_TAG.to_string(),
+                BASE64_CONTENT_ENCODING.to_string(),
+            ]);
+            hex::encode(ciphertext)
+        };
+        Ok((tags, content))
+    }
+
+    fn compresses_for(&self, rdx_fingerprint: &str) -> Result<bool, SignalBridgeError> {
+        Ok(self.payload_compression && self.contact_manager.accepts_zstd(rdx_fingerprint)?)
     }
 
     pub async fn establish_session(
@@ -409,25 +681,11 @@ impl SignalBridge {
         Ok(())
     }
 
-    pub async fn generate_pre_key_bundle(
-        &mut self,
-    ) -> Result<(Vec<u8>, u32, u32, u32), SignalBridgeError> {
+    /// Returns the (pre-key, signed pre-key, Kyber pre-key) IDs a bundle built now would contain
+    async fn current_bundle_key_ids(&mut self) -> Result<(u32, u32, u32), SignalBridgeError> {
         use crate::storage_trait::{
             ExtendedKyberPreKeyStore, ExtendedPreKeyStore, ExtendedSignedPreKeyStore,
         };
-        use libsignal_protocol::*;
-
-        let identity_key = *self
-            .storage
-            .identity_store()
-            .get_identity_key_pair()
-            .await?
-            .identity_key();
-        let registration_id = self
-            .storage
-            .identity_store()
-            .get_local_registration_id()
-            .await?;
 
         // Use latest available keys (highest IDs) for bundle generation
         // This ensures bundles reflect the most recent key rotation
@@ -454,6 +712,29 @@ impl SignalBridge {
                 SignalBridgeError::Protocol("No kyber pre-keys available".to_string())
             })?;
 
+        Ok((pre_key_id, signed_pre_key_id, kyber_pre_key_id))
+    }
+
+    pub async fn generate_pre_key_bundle(
+        &mut self,
+    ) -> Result<(Vec<u8>, u32, u32, u32), SignalBridgeError> {
+        use libsignal_protocol::*;
+
+        let identity_key = *self
+            .storage
+            .identity_store()
+            .get_identity_key_pair()
+            .await?
+            .identity_key();
+        let registration_id = self
+            .storage
+            .identity_store()
+            .get_local_registration_id()
+            .await?;
+
+        let (pre_key_id, signed_pre_key_id, kyber_pre_key_id) =
+            self.current_bundle_key_ids().await?;
+
         let pre_key_record = self
             .storage
             .pre_key_store()
@@ -576,6 +857,7 @@ impl SignalBridge {
         println!("WARNING: Resetting identity - all existing sessions will be invalidated");
 
         self.clear_all_sessions().await?;
+        self.invalidate_bundle_announcement();
 
         self.storage.pre_key_store().clear_all_pre_keys().await?;
         self.storage
@@ -633,13 +915,11 @@ impl SignalBridge {
         Ok(peer_nostr_public_key.to_bytes().to_vec())
     }
 
-    pub async fn create_subscription_for_self(
+    pub async fn message_subscription(
         &mut self,
-        subscription_id: &str,
         since_timestamp: u64,
-    ) -> Result<String, SignalBridgeError> {
+    ) -> Result<MessageSubscription, SignalBridgeError> {
         let keys = self.derive_nostr_keypair().await?;
-        let our_pubkey = keys.public_key().to_hex();
 
         let since = if since_timestamp > 0 {
             since_timestamp
@@ -649,21 +929,11 @@ impl SignalBridge {
             })?
         };
 
-        let mut filter = serde_json::json!({
-            "kinds": [40001],
-            "#p": [our_pubkey]
-        });
-
-        if since > 0 {
-            filter
-                .as_object_mut()
-                .unwrap()
-                .insert("since".to_string(), serde_json::json!(since));
-        }
-
-        let subscription = serde_json::json!(["REQ", subscription_id, filter]);
-
-        Ok(subscription.to_string())
+        Ok(MessageSubscription {
+            our_pubkey: keys.public_key().to_hex(),
+            group_ids: self.group_manager.list_group_ids()?,
+            since,
+        })
     }
 
     pub async fn update_last_message_timestamp(
@@ -680,10 +950,23 @@ impl SignalBridge {
             })
     }
 
+    /// Returns a signed prekey bundle announcement
+    ///
+    /// The signed announcement is cached and returned unchanged while the highest pre-key,
+    /// signed pre-key, and Kyber pre-key IDs and the version tag stay the same. Rotation,
+    /// replenishment, consumption of the advertised pre-key, or an identity reset produce a
+    /// freshly built and signed announcement.
     pub async fn generate_prekey_bundle_announcement(
         &mut self,
         project_version: &str,
     ) -> Result<ffi::BundleInfo, SignalBridgeError> {
+        let key_ids = self.current_bundle_key_ids().await?;
+        if let Some(cached) = &self.cached_bundle_announcement {
+            if cached.key_ids == key_ids && cached.project_version == project_version {
+                return Ok(cached.info.clone());
+            }
+        }
+
         let (bundle_bytes, pre_key_id, signed_pre_key_id, kyber_pre_key_id) =
             self.generate_pre_key_bundle().await?;
 
@@ -692,80 +975,123 @@ impl SignalBridge {
             .await?;
 
         let bundle_base64 = base64::engine::general_purpose::STANDARD.encode(&bundle_bytes);
-        let timestamp = SystemTime::now()
-            .duration_since(UNIX_EPOCH)
-            .map_err(|e| SignalBridgeError::Protocol(e.to_string()))?
-            .as_secs();
+        let timestamp = self.next_announcement_timestamp()?;
 
         let tags = vec![
             vec!["d".to_string(), "radix_prekey_bundle_v1".to_string()],
-            vec!["rdx".to_string(), rdx_fingerprint.clone()],
+            vec!["rdx".to_string(), rdx_fingerprint],
             vec!["radix_version".to_string(), project_version.to_string()],
             vec!["bundle_timestamp".to_string(), timestamp.to_string()],
         ];
 
-        let (pubkey, event_id, signature) = self
-            .sign_nostr_event(timestamp, 30078, tags.clone(), &bundle_base64)
+        let event = self
+            .sign_event(timestamp, 30078, tags, &bundle_base64)
             .await?;
 
-        let event = serde_json::json!({
-            "id": event_id,
-            "pubkey": pubkey,
-            "created_at": timestamp,
-            "kind": 30078,
-            "tags": [
-                ["d", "radix_prekey_bundle_v1"],
-                ["rdx", rdx_fingerprint],
-                ["radix_version", project_version],
-                ["bundle_timestamp", timestamp.to_string()],
-            ],
-            "content": bundle_base64,
-            "sig": signature,
-        });
-
         let announcement_json = serde_json::to_string(&event)
             .map_err(|e| SignalBridgeError::Serialization(e.to_string()))?;
 
-        Ok(ffi::BundleInfo {
+        let info = ffi::BundleInfo {
             announcement_json,
+            event_id: event.id.to_hex(),
+            frame: Self::event_frame(&event)?,
             pre_key_id,
             signed_pre_key_id,
             kyber_pre_key_id,
-        })
+        };
+        self.cached_bundle_announcement = Some(CachedBundleAnnouncement {
+            key_ids: (pre_key_id, signed_pre_key_id, kyber_pre_key_id),
+            project_version: project_version.to_string(),
+            info: info.clone(),
+        });
+
+        Ok(info)
+    }
+
+    /// Drops the cached bundle announcement so the next request re-signs
+    pub fn invalidate_bundle_announcement(&mut self) {
+        self.cached_bundle_announcement = None;
+    }
+
+    /// Returns the `created_at` for a new bundle announcement
+    ///
+    /// Relays keep only the newest announcement (NIP-33), so each one is dated at least a
+    /// second after the previous, even when both are signed within the same second.
+    fn next_announcement_timestamp(&mut self) -> Result<u64, SignalBridgeError> {
+        let now = SystemTime::now()
+            .duration_since(UNIX_EPOCH)
+            .map_err(|e| SignalBridgeError::Protocol(e.to_string()))?
+            .as_secs();
+        self.last_announcement_timestamp = now.max(self.last_announcement_timestamp + 1);
+        Ok(self.last_announcement_timestamp)
+    }
+
+    /// Records the key IDs of a published bundle
+    ///
+    /// The cached announcement is dropped when it advertises different keys than the ones
+    /// recorded, so what gets re-sent always matches the published-bundle state.
+    ///
+    /// # Arguments
+    /// * `pre_key_id` - One-time prekey ID
+    /// * `signed_pre_key_id` - Signed prekey ID
+    /// * `kyber_pre_key_id` - Kyber prekey ID
+    pub fn record_published_bundle(
+        &mut self,
+        pre_key_id: u32,
+        signed_pre_key_id: u32,
+        kyber_pre_key_id: u32,
+    ) -> Result<(), SignalBridgeError> {
+        self.storage
+            .record_published_bundle(pre_key_id, signed_pre_key_id, kyber_pre_key_id)?;
+
+        let recorded = (pre_key_id, signed_pre_key_id, kyber_pre_key_id);
+        if self
+            .cached_bundle_announcement
+            .as_ref()
+            .is_some_and(|cached| cached.key_ids != recorded)
+        {
+            self.invalidate_bundle_announcement();
+        }
+        Ok(())
     }
 
     pub async fn generate_empty_bundle_announcement(
         &mut self,
         project_version: &str,
     ) -> Result<String, SignalBridgeError> {
-        let timestamp = SystemTime::now()
-            .duration_since(UNIX_EPOCH)
-            .map_err(|e| SignalBridgeError::Protocol(e.to_string()))?
-            .as_secs();
+        let event = self.sign_empty_bundle_announcement(project_version).await?;
+        serde_json::to_string(&event).map_err(|e| SignalBridgeError::Serialization(e.to_string()))
+    }
+
+    /// Generates an empty bundle announcement as a wire-ready `["EVENT", {...}]` frame
+    ///
+    /// # Returns
+    /// Event ID (hex) and the serialized frame bytes
+    pub async fn generate_empty_bundle_frame(
+        &mut self,
+        project_version: &str,
+    ) -> Result<(String, Vec<u8>), SignalBridgeError> {
+        let event = self.sign_empty_bundle_announcement(project_version).await?;
+        Ok((event.id.to_hex(), Self::event_frame(&event)?))
+    }
+
+    /// Signs an empty bundle announcement, replacing the published bundle on relays
+    ///
+    /// The cached announcement is dropped: it is older than the empty one, so relays would
+    /// keep the empty one if it were sent again.
+    async fn sign_empty_bundle_announcement(
+        &mut self,
+        project_version: &str,
+    ) -> Result<nostr::Event, SignalBridgeError> {
+        self.invalidate_bundle_announcement();
+        let timestamp = self.next_announcement_timestamp()?;
 
         let tags = vec![
             vec!["d".to_string(), "radix_prekey_bundle_v1".to_string()],
             vec!["radix_version".to_string(), project_version.to_string()],
         ];
 
-        let (pubkey, event_id, signature) = self
-            .sign_nostr_event(timestamp, 30078, tags.clone(), "")
-            .await?;
-
-        let event = serde_json::json!({
-            "id": event_id,
-            "pubkey": pubkey,
-            "created_at": timestamp,
-            "kind": 30078,
-            "tags": [
-                ["d", "radix_prekey_bundle_v1"],
-                ["radix_version", project_version],
-            ],
-            "content": "",
-            "sig": signature,
-        });
-
-        serde_json::to_string(&event).map_err(|e| SignalBridgeError::Serialization(e.to_string()))
+        self.sign_event(timestamp, 30078, tags, "").await
     }
 
     pub async fn add_contact_and_establish_session(
@@ -813,44 +1139,669 @@ impl SignalBridge {
         tags: Vec<Vec<String>>,
         content: &str,
     ) -> Result<(String, String, String), SignalBridgeError> {
-        let keys = self.derive_nostr_keypair().await?;
-
-        let nostr_tags: Vec<Tag> = tags
-            .into_iter()
-            .map(|tag_vec| {
-                if tag_vec.is_empty() {
-                    Tag::parse(&[""]).unwrap_or_else(|_| Tag::parse(&["unknown"]).unwrap())
-                } else {
-                    Tag::parse(&tag_vec).unwrap_or_else(|_| Tag::parse(&["unknown"]).unwrap())
-                }
-            })
-            .collect();
-
-        let event = EventBuilder::new(Kind::Custom(kind as u16), content, nostr_tags)
-            .custom_created_at(nostr::Timestamp::from(created_at))
-            .to_event(&keys)
-            .map_err(|e| SignalBridgeError::Protocol(format!("Failed to create event: {}", e)))?;
+        let event = self.sign_event(created_at, kind, tags, content).await?;
 
         Ok((
-            keys.public_key().to_hex(),
+            event.pubkey.to_hex(),
             event.id.to_hex(),
             event.sig.to_string(),
         ))
     }
 
-    pub async fn generate_node_fingerprint(&mut self) -> Result<String, SignalBridgeError> {
-        let identity_key_pair = self
-            .storage
-            .identity_store()
-            .get_identity_key_pair()
-            .await?;
-
-        Ok(ContactManager::generate_identity_fingerprint_from_key(
-            identity_key_pair.identity_key(),
-        ))
+    /// Signs an event and returns it as a wire-ready NIP-01 `["EVENT", {...}]` frame
+    ///
+    /// # Arguments
+    /// * `created_at` - Unix timestamp for the event
+    /// * `kind` - Nostr event kind
+    /// * `tags` - Event tags
+    /// * `content` - Event content
+    ///
+    /// # Returns
+    /// Event ID (hex) and the serialized frame bytes
+    pub async fn sign_event_frame(
+        &mut self,
+        created_at: u64,
+        kind: u32,
+        tags: Vec<Vec<String>>,
+        content: &str,
+    ) -> Result<(String, Vec<u8>), SignalBridgeError> {
+        let event = self.sign_event(created_at, kind, tags, content).await?;
+        Ok((event.id.to_hex(), Self::event_frame(&event)?))
     }
 
-    pub async fn add_contact_from_bundle(
+    /// Builds, signs, and frames an encrypted message event for a peer
+    ///
+    /// # Arguments
+    /// * `peer` - Recipient RDX fingerprint, alias, or Nostr pubkey
+    /// * `ciphertext` - Signal Protocol ciphertext, base64 or hex encoded into the event content
+    /// * `timestamp` - Unix timestamp for the event
+    /// * `project_version` - Protocol version string
+    ///
+    /// # Returns
+    /// Event ID (hex) and the serialized `["EVENT", {...}]` frame bytes
+    pub async fn create_encrypted_message_frame(
+        &mut self,
+        peer: &str,
+        ciphertext: &[u8],
+        timestamp: u64,
+        project_version: &str,
+    ) -> Result<(String, Vec<u8>), SignalBridgeError> {
+        let recipient_pubkey = hex::encode(self.derive_peer_nostr_key(peer).await?);
+        let (tags, content) =
+            self.encrypted_message_parts(peer, recipient_pubkey, ciphertext, project_version)?;
+        self.sign_event_frame(timestamp, 40001, tags, &content)
+            .await
+    }
+
+    /// Encrypts one plaintext for many peers and signs a message event for each
+    ///
+    /// All ratchet updates and history rows are written in a single storage transaction, and
+    /// the Nostr keypair is derived once for the whole batch. A peer that cannot be encrypted
+    /// for (unknown, or without a session) gets an error entry instead of a frame; it does not
+    /// fail the others.
+    ///
+    /// # Arguments
+    /// * `peers` - Recipient RDX fingerprints, aliases, or Nostr pubkeys
+    /// * `plaintext` - Message bytes
+    /// * `timestamp` - Unix timestamp for the events
+    /// * `project_version` - Protocol version string
+    ///
+    /// # Returns
+    /// One entry per peer, in order
+    pub async fn create_encrypted_message_frames(
+        &mut self,
+        peers: &[String],
+        plaintext: &[u8],
+        timestamp: u64,
+        project_version: &str,
+    ) -> Result<Vec<FanOutFrame>, SignalBridgeError> {
+        let keys = self.derive_nostr_keypair().await?;
+        let history_timestamp = SystemTime::now().duration_since(UNIX_EPOCH)?.as_millis() as u64;
+
+        self.storage.begin_batch()?;
+        let mut frames = Vec::with_capacity(peers.len());
+        for peer in peers {
+            let frame = match self
+                .fan_out_frame(&keys, peer, plaintext, timestamp, project_version)
+                .await
+            {
+                Ok((session_address, event_id, bytes)) => {
+                    if let Err(e) = self.storage.message_history().store_outgoing_message(
+                        &session_address,
+                        history_timestamp,
+                        plaintext,
+                    ) {
+                        eprintln!("Warning: Failed to store outgoing message: {}", e);
+                    }
+                    FanOutFrame {
+                        recipient: peer.clone(),
+                        event_id,
+                        bytes,
+                        error: String::new(),
+                    }
+                }
+                Err(e) => FanOutFrame {
+                    recipient: peer.clone(),
+                    event_id: String::new(),
+                    bytes: Vec::new(),
+                    error: e.to_string(),
+                },
+            };
+            frames.push(frame);
+        }
+
+        if let Err(e) = self.storage.commit_batch() {
+            self.storage.rollback_batch()?;
+            return Err(e);
+        }
+        Ok(frames)
+    }
+
+    async fn fan_out_frame(
+        &mut self,
+        keys: &Keys,
+        peer: &str,
+        plaintext: &[u8],
+        timestamp: u64,
+        project_version: &str,
+    ) -> Result<(String, String, Vec<u8>), SignalBridgeError> {
+        let (session_address, ciphertext) = self.encrypt_for_peer(peer, plaintext).await?;
+        let recipient_pubkey = hex::encode(self.derive_peer_nostr_key(&session_address).await?);
+        let (tags, content) = self.encrypted_message_parts(
+            &session_address,
+            recipient_pubkey,
+            &ciphertext,
+            project_version,
+        )?;
+        let event = Self::sign_event_with(keys, timestamp, 40001, tags, &content)?;
+
+        Ok((
+            session_address,
+            event.id.to_hex(),
+            Self::event_frame(&event)?,
+        ))
+    }
+
+    /// Creates a group of existing contacts
+    ///
+    /// Nothing is sent yet; the members receive this node's sender key with the first
+    /// [`Self::create_sender_key_distribution_frames`] call.
+    ///
+    /// # Arguments
+    /// * `name` - Human-readable group name
+    /// * `members` - RDX fingerprints, aliases, or Nostr pubkeys of the other members
+    ///
+    /// # Returns
+    /// Distribution ID of the new group
+    pub async fn create_group(
+        &mut self,
+        name: &str,
+        members: &[String],
+    ) -> Result<String, SignalBridgeError> {
+        if name.is_empty() {
+            return Err(SignalBridgeError::InvalidInput(
+                "Specify a group name".to_string(),
+            ));
+        }
+        if members.is_empty() {
+            return Err(SignalBridgeError::InvalidInput(
+                "Specify at least one group member".to_string(),
+            ));
+        }
+
+        let mut member_rdx = Vec::with_capacity(members.len());
+        for member in members {
+            let contact = self
+                .contact_manager
+                .lookup_contact(member, self.storage.session_store())
+                .await?;
+            if !member_rdx.contains(&contact.rdx_fingerprint) {
+                member_rdx.push(contact.rdx_fingerprint);
+            }
+        }
+
+        let distribution_id = self.group_manager.create_group(name, &member_rdx)?;
+        Ok(distribution_id.to_string())
+    }
+
+    /// Builds sender key distribution events for group members that don't have this node's key
+    ///
+    /// Each distribution is encrypted over the pairwise session with that member and tagged
+    /// with their Nostr pubkey, so it costs one encryption per member once per group rather
+    /// than once per message. Members without a session are skipped and retried on the next
+    /// call. A member keeps getting the key until [`Self::mark_sender_key_delivered`] records
+    /// that a relay accepted it.
+    ///
+    /// # Arguments
+    /// * `group` - Group distribution ID or name
+    /// * `timestamp` - Unix timestamp for the events
+    /// * `project_version` - Protocol version string
+    ///
+    /// # Returns
+    /// One frame per distribution, with the member's RDX fingerprint as recipient
+    pub async fn create_sender_key_distribution_frames(
+        &mut self,
+        group: &str,
+        timestamp: u64,
+        project_version: &str,
+    ) -> Result<Vec<FanOutFrame>, SignalBridgeError> {
+        use libsignal_protocol::create_sender_key_distribution_message;
+
+        let group = self.group_manager.lookup_group(group)?;
+        let pending = self
+            .group_manager
+            .members_awaiting_sender_key(group.distribution_id)?;
+        if pending.is_empty() {
+            return Ok(Vec::new());
+        }
+
+        let our_rdx = self.generate_node_fingerprint().await?;
+        let our_address = ProtocolAddress::new(
+            our_rdx.clone(),
+            DeviceId::new(1).map_err(|e| SignalBridgeError::Protocol(e.to_string()))?,
+        );
+        let mut rng = rand::rng();
+        let distribution = create_sender_key_distribution_message(
+            &our_address,
+            group.distribution_id,
+            self.storage.sender_key_store(),
+            &mut rng,
+        )
+        .await?;
+
+        let mut members = group.members.clone();
+        members.push(our_rdx);
+        let invitation = serde_json::to_vec(&GroupInvitation {
+            distribution_id: group.distribution_id.to_string(),
+            name: group.name.clone(),
+            members,
+            sender_key: base64::engine::general_purpose::STANDARD.encode(distribution.serialized()),
+        })
+        .map_err(|e| SignalBridgeError::Serialization(e.to_string()))?;
+
+        let mut frames = Vec::with_capacity(pending.len());
+        for member in pending {
+            let address = ProtocolAddress::new(
+                member.clone(),
+                DeviceId::new(1).map_err(|e| SignalBridgeError::Protocol(e.to_string()))?,
+            );
+            if self
+                .storage
+                .session_store()
+                .load_session(&address)
+                .await?
+                .is_none()
+            {
+                eprintln!(
+                    "Warning: No session with group member {}, sender key not sent",
+                    member
+                );
+                continue;
+            }
+
+            let ciphertext = self.storage.encrypt_message(&address, &invitation).await?;
+            let recipient_pubkey = hex::encode(self.derive_peer_nostr_key(&member).await?);
+            let tags = vec![
+                vec!["p".to_string(), recipient_pubkey],
+                vec![
+                    "radix_version".to_string(),
+                    project_version.to_string(),
+                    BASE64_CONTENT_ENCODING.to_string(),
+                ],
+            ];
+            let content = base64::engine::general_purpose::STANDARD.encode(ciphertext.serialize());
+            let (event_id, bytes) = self
+                .sign_event_frame(timestamp, SENDER_KEY_DISTRIBUTION_KIND, tags, &content)
+                .await?;
+            frames.push(FanOutFrame {
+                recipient: member,
+                event_id,
+                bytes,
+                error: String::new(),
+            });
+        }
+
+        Ok(frames)
+    }
+
+    /// Records that a relay accepted a member's sender key distribution
+    ///
+    /// # Arguments
+    /// * `group` - Group distribution ID or name
+    /// * `member_rdx` - RDX fingerprint of the member the distribution was for
+    pub fn mark_sender_key_delivered(
+        &mut self,
+        group: &str,
+        member_rdx: &str,
+    ) -> Result<(), SignalBridgeError> {
+        let group = self.group_manager.lookup_group(group)?;
+        self.group_manager
+            .mark_sender_key_sent(group.distribution_id, member_rdx)
+    }
+
+    /// Encrypts a message once for a whole group and frames it as a single event
+    ///
+    /// The event carries the group's distribution ID in a `g` tag instead of a recipient
+    /// pubkey, so every member's subscription matches the same event.
+    ///
+    /// # Arguments
+    /// * `group` - Group distribution ID or name
+    /// * `plaintext` - Message bytes
+    /// * `timestamp` - Unix timestamp for the event
+    /// * `project_version` - Protocol version string
+    ///
+    /// # Returns
+    /// Event ID (hex) and the serialized `["EVENT", {...}]` frame bytes
+    pub async fn create_group_message_frame(
+        &mut self,
+        group: &str,
+        plaintext: &[u8],
+        timestamp: u64,
+        project_version: &str,
+    ) -> Result<(String, Vec<u8>), SignalBridgeError> {
+        use libsignal_protocol::group_encrypt;
+
+        let group = self.group_manager.lookup_group(group)?;
+        let our_address = ProtocolAddress::new(
+            self.generate_node_fingerprint().await?,
+            DeviceId::new(1).map_err(|e| SignalBridgeError::Protocol(e.to_string()))?,
+        );
+
+        let mut rng = rand::rng();
+        let ciphertext = group_encrypt(
+            self.storage.sender_key_store(),
+            &our_address,
+            group.distribution_id,
+            plaintext,
+            &mut rng,
+        )
+        .await?;
+
+        let tags = vec![
+            vec![GROUP_TAG.to_string(), group.distribution_id.to_string()],
+            vec![
+                "radix_version".to_string(),
+                project_version.to_string(),
+                BASE64_CONTENT_ENCODING.to_string(),
+            ],
+        ];
+        let content = base64::engine::general_purpose::STANDARD.encode(ciphertext.serialized());
+        self.sign_event_frame(timestamp, GROUP_MESSAGE_KIND, tags, &content)
+            .await
+    }
+
+    /// Processes a sender key distribution received from a group member
+    ///
+    /// Records the group and its roster, so this node can decrypt the sender's group messages
+    /// and later hand its own sender key to the other members. For a group this node already
+    /// knows, only current members may distribute a key, and the roster stays as it is.
+    ///
+    /// # Arguments
+    /// * `peer_hint` - Nostr pubkey of the event author
+    /// * `ciphertext_bytes` - Pairwise Signal ciphertext of the distribution
+    pub async fn process_sender_key_distribution(
+        &mut self,
+        peer_hint: &str,
+        ciphertext_bytes: &[u8],
+    ) -> Result<GroupMembership, SignalBridgeError> {
+        use libsignal_protocol::{
+            process_sender_key_distribution_message, SenderKeyDistributionMessage,
+        };
+
+        let (address, pre_key_consumed, payload) =
+            self.decrypt_pairwise(peer_hint, ciphertext_bytes).await?;
+        let invitation: GroupInvitation = serde_json::from_slice(&payload)
+            .map_err(|e| SignalBridgeError::Serialization(e.to_string()))?;
+        let distribution_id = uuid::Uuid::parse_str(&invitation.distribution_id)
+            .map_err(|e| SignalBridgeError::InvalidInput(e.to_string()))?;
+
+        let sender_key = base64::engine::general_purpose::STANDARD
+            .decode(&invitation.sender_key)
+            .map_err(|e| SignalBridgeError::Serialization(e.to_string()))?;
+        let distribution = SenderKeyDistributionMessage::try_from(sender_key.as_slice())?;
+        if distribution.distribution_id()? != distribution_id {
+            return Err(SignalBridgeError::InvalidInput(
+                "Sender key does not belong to the announced group".to_string(),
+            ));
+        }
+
+        let sender_rdx = address.name().to_string();
+        if let Some(members) = self.group_manager.group_members(distribution_id)? {
+            if !members.contains(&sender_rdx) {
+                return Err(SignalBridgeError::InvalidInput(format!(
+                    "{} is not a member of group {}",
+                    sender_rdx, distribution_id
+                )));
+            }
+        }
+
+        process_sender_key_distribution_message(
+            &address,
+            &distribution,
+            self.storage.sender_key_store(),
+        )
+        .await?;
+
+        let our_rdx = self.generate_node_fingerprint().await?;
+        let mut members: Vec<String> = invitation
+            .members
+            .into_iter()
+            .filter(|member| *member != our_rdx)
+            .collect();
+        if !members.contains(&sender_rdx) {
+            members.push(sender_rdx.clone());
+        }
+        self.group_manager
+            .join_group(distribution_id, &invitation.name, &members)?;
+
+        let group = self
+            .group_manager
+            .lookup_group(&invitation.distribution_id)?;
+        Ok(GroupMembership {
+            group_id: invitation.distribution_id,
+            name: group.name,
+            sender_rdx,
+            should_republish_bundle: pre_key_consumed,
+        })
+    }
+
+    /// Decrypts a group message with the sender's previously distributed sender key
+    ///
+    /// Group messages are not written to the per-contact message history.
+    ///
+    /// # Arguments
+    /// * `peer_hint` - Nostr pubkey of the event author
+    /// * `group_id` - Distribution ID from the event's `g` tag
+    /// * `ciphertext_bytes` - Serialized SenderKeyMessage
+    pub async fn decrypt_group_message(
+        &mut self,
+        peer_hint: &str,
+        group_id: &str,
+        ciphertext_bytes: &[u8],
+    ) -> Result<GroupDecryptionResult, SignalBridgeError> {
+        use libsignal_protocol::{group_decrypt, SenderKeyMessage};
+
+        let group = self.group_manager.lookup_group(group_id)?;
+        let message = SenderKeyMessage::try_from(ciphertext_bytes)?;
+        if message.distribution_id() != group.distribution_id {
+            return Err(SignalBridgeError::InvalidInput(
+                "Group message does not belong to the tagged group".to_string(),
+            ));
+        }
+
+        // The #g filter also matches our own group messages. Our sending chain has already
+        // moved past them, so group_decrypt rejects the echo as a duplicate.
+        let our_pubkey = self.derive_nostr_keypair().await?.public_key().to_hex();
+        let sender_rdx = if peer_hint == our_pubkey {
+            self.generate_node_fingerprint().await?
+        } else {
+            self.contact_manager
+                .lookup_contact(peer_hint, self.storage.session_store())
+                .await?
+                .rdx_fingerprint
+        };
+        let address = ProtocolAddress::new(
+            sender_rdx.clone(),
+            DeviceId::new(1).map_err(|e| SignalBridgeError::Protocol(e.to_string()))?,
+        );
+
+        let plaintext =
+            group_decrypt(ciphertext_bytes, self.storage.sender_key_store(), &address).await?;
+
+        Ok(GroupDecryptionResult {
+            group_id: group.distribution_id.to_string(),
+            name: group.name,
+            sender_rdx,
+            plaintext,
+        })
+    }
+
+    /// Registers a file to be sent to a peer in chunks
+    ///
+    /// The file is hashed here but read again chunk by chunk as events are built, so it must
+    /// stay in place until the transfer completes.
+    ///
+    /// # Arguments
+    /// * `peer` - RDX fingerprint, alias, or Nostr pubkey of the recipient
+    /// * `path` - File to send
+    pub async fn start_file_transfer(
+        &mut self,
+        peer: &str,
+        path: &str,
+    ) -> Result<OutgoingTransfer, SignalBridgeError> {
+        let contact = self
+            .contact_manager
+            .lookup_contact(peer, self.storage.session_store())
+            .await?;
+        if !contact.has_active_session {
+            return Err(SignalBridgeError::SessionNotFound(format!(
+                "Establish a session with {} before sending files",
+                peer
+            )));
+        }
+        self.file_transfers
+            .start_outgoing(&contact.rdx_fingerprint, path)
+    }
+
+    /// Returns outgoing transfers that still have chunks to deliver, for resuming after restart
+    pub fn pending_file_transfers(&self) -> Result<Vec<OutgoingTransfer>, SignalBridgeError> {
+        self.file_transfers.pending_outgoing()
+    }
+
+    /// Reads, encrypts, and frames one chunk of an outgoing transfer
+    ///
+    /// # Arguments
+    /// * `transfer_id` - Outgoing transfer
+    /// * `chunk_index` - Chunk to send
+    /// * `timestamp` - Unix timestamp for the event
+    /// * `project_version` - Protocol version string
+    ///
+    /// # Returns
+    /// Event ID (hex) and the serialized `["EVENT", {...}]` frame bytes
+    pub async fn create_transfer_chunk_frame(
+        &mut self,
+        transfer_id: &str,
+        chunk_index: u32,
+        timestamp: u64,
+        project_version: &str,
+    ) -> Result<(String, Vec<u8>), SignalBridgeError> {
+        let (peer_rdx, chunk) = self.file_transfers.read_chunk(transfer_id, chunk_index)?;
+        let (session_address, ciphertext) = self
+            .encrypt_for_peer(&peer_rdx, &bincode::serialize(&chunk)?)
+            .await?;
+        let recipient_pubkey = hex::encode(self.derive_peer_nostr_key(&session_address).await?);
+
+        let tags = vec![
+            vec!["p".to_string(), recipient_pubkey],
+            vec![
+                "radix_version".to_string(),
+                project_version.to_string(),
+                BASE64_CONTENT_ENCODING.to_string(),
+            ],
+        ];
+        let content = base64::engine::general_purpose::STANDARD.encode(&ciphertext);
+        self.sign_event_frame(timestamp, FILE_CHUNK_KIND, tags, &content)
+            .await
+    }
+
+    /// Records that a relay accepted a chunk of an outgoing transfer
+    ///
+    /// # Returns
+    /// True once every chunk has been accepted
+    pub fn mark_transfer_chunk_delivered(
+        &mut self,
+        transfer_id: &str,
+        chunk_index: u32,
+    ) -> Result<bool, SignalBridgeError> {
+        self.file_transfers.mark_delivered(transfer_id, chunk_index)
+    }
+
+    /// Decrypts a received file chunk and writes it into the transfer's partial file
+    ///
+    /// # Arguments
+    /// * `peer_hint` - Nostr pubkey of the event author
+    /// * `ciphertext_bytes` - Pairwise Signal ciphertext of the chunk
+    pub async fn process_transfer_chunk(
+        &mut self,
+        peer_hint: &str,
+        ciphertext_bytes: &[u8],
+    ) -> Result<TransferProgress, SignalBridgeError> {
+        let (address, _, payload) = self.decrypt_pairwise(peer_hint, ciphertext_bytes).await?;
+        let chunk: file_transfer::TransferChunk =
+            bincode::deserialize(&payload_compression::decode_frame(&payload)?)?;
+        self.file_transfers.receive_chunk(address.name(), &chunk)
+    }
+
+    /// Remembers a discovered bundle announcement across restarts
+    ///
+    /// Keeps the cached announcement if it is newer than this one.
+    ///
+    /// # Arguments
+    /// * `bundle` - Announcement metadata
+    /// * `bundle_base64` - Base64-encoded bundle data
+    pub fn save_discovered_bundle(
+        &mut self,
+        bundle: &CachedBundle,
+        bundle_base64: &str,
+    ) -> Result<(), SignalBridgeError> {
+        self.bundle_cache.save(bundle, bundle_base64)
+    }
+
+    /// Lists cached bundle announcements without their bundle data
+    pub fn cached_discovered_bundles(&self) -> Result<Vec<CachedBundle>, SignalBridgeError> {
+        self.bundle_cache.list()
+    }
+
+    /// Reads the bundle data of a cached announcement
+    ///
+    /// # Returns
+    /// Base64-encoded bundle, or an empty string if none is cached for the pubkey
+    pub fn load_discovered_bundle(&self, nostr_pubkey: &str) -> Result<String, SignalBridgeError> {
+        self.bundle_cache.load_body(nostr_pubkey)
+    }
+
+    /// Forgets the cached bundle announcement of a pubkey
+    pub fn forget_discovered_bundle(
+        &mut self,
+        nostr_pubkey: &str,
+    ) -> Result<(), SignalBridgeError> {
+        self.bundle_cache.remove(nostr_pubkey)
+    }
+
+    /// Serializes a signed event as a NIP-01 client `["EVENT", {...}]` frame
+    fn event_frame(event: &nostr::Event) -> Result<Vec<u8>, SignalBridgeError> {
+        serde_json::to_vec(&("EVENT", event))
+            .map_err(|e| SignalBridgeError::Serialization(e.to_string()))
+    }
+
+    async fn sign_event(
+        &mut self,
+        created_at: u64,
+        kind: u32,
+        tags: Vec<Vec<String>>,
+        content: &str,
+    ) -> Result<nostr::Event, SignalBridgeError> {
+        let keys = self.derive_nostr_keypair().await?;
+        Self::sign_event_with(&keys, created_at, kind, tags, content)
+    }
+
+    fn sign_event_with(
+        keys: &Keys,
+        created_at: u64,
+        kind: u32,
+        tags: Vec<Vec<String>>,
+        content: &str,
+    ) -> Result<nostr::Event, SignalBridgeError> {
+        let nostr_tags: Vec<Tag> = tags
+            .into_iter()
+            .map(|tag_vec| {
+                if tag_vec.is_empty() {
+                    Tag::parse(&[""]).unwrap_or_else(|_| Tag::parse(&["unknown"]).unwrap())
+                } else {
+                    Tag::parse(&tag_vec).unwrap_or_else(|_| Tag::parse(&["unknown"]).unwrap())
+                }
+            })
+            .collect();
+
+        EventBuilder::new(Kind::Custom(kind as u16), content, nostr_tags)
+            .custom_created_at(nostr::Timestamp::from(created_at))
+            .to_event(keys)
+            .map_err(|e| SignalBridgeError::Protocol(format!("Failed to create event: {}", e)))
+    }
+
+    pub async fn generate_node_fingerprint(&mut self) -> Result<String, SignalBridgeError> {
+        let identity_key_pair = self
+            .storage
+            .identity_store()
+            .get_identity_key_pair()
+            .await?;
+
+        Ok(ContactManager::generate_identity_fingerprint_from_key(
+            identity_key_pair.identity_key(),
+        ))
+    }
+
+    pub async fn add_contact_from_bundle(
         &mut self,
         bundle_bytes: &[u8],
         user_alias: Option<&str>,
@@ -894,33 +1845,89 @@ impl SignalBridge {
     /// - Clean up expired signed pre-keys past the grace period
     /// - Replenish one-time pre-keys if the count drops below the threshold
     ///
+    /// Runs `plan_key_maintenance`, claims the planned keys from the key factory and then
+    /// runs `apply_key_maintenance`. Callers sharing the bridge between threads can run the
+    /// steps separately and release the bridge while keys are claimed.
+    ///
     /// Returns a `KeyMaintenanceResult` indicating which keys were rotated/replenished.
     pub async fn perform_key_maintenance(
         &mut self,
     ) -> Result<KeyMaintenanceResult, SignalBridgeError> {
+        let plan = self.plan_key_maintenance().await?;
+        let keys = Self::claim_maintenance_keys(&self.key_factory, &plan);
+        self.apply_key_maintenance(&plan, &keys).await
+    }
+
+    /// Checks which keys are due for rotation or replenishment without changing anything
+    pub async fn plan_key_maintenance(&mut self) -> Result<KeyMaintenancePlan, SignalBridgeError> {
         use crate::key_rotation::{
-            cleanup_expired_kyber_pre_keys, cleanup_expired_signed_pre_keys,
-            kyber_pre_key_needs_rotation, replenish_pre_keys, rotate_kyber_pre_key,
-            rotate_signed_pre_key, signed_pre_key_needs_rotation, MIN_PRE_KEY_COUNT,
+            kyber_pre_key_needs_rotation, signed_pre_key_needs_rotation, MIN_PRE_KEY_COUNT,
         };
 
-        let mut result = KeyMaintenanceResult::default();
+        Ok(KeyMaintenancePlan {
+            rotate_signed_pre_key: signed_pre_key_needs_rotation(&mut self.storage).await?,
+            rotate_kyber_pre_key: kyber_pre_key_needs_rotation(&mut self.storage).await?,
+            replenish_pre_keys: self.storage.pre_key_store().pre_key_count().await
+                < MIN_PRE_KEY_COUNT,
+        })
+    }
 
-        let identity_key_pair = self
-            .storage
-            .identity_store()
-            .get_identity_key_pair()
-            .await?;
+    /// Returns the key factory, which may be used without holding the bridge
+    pub fn key_factory(&self) -> Arc<KeyFactory> {
+        Arc::clone(&self.key_factory)
+    }
 
-        // Check and rotate signed pre-key if needed
-        if signed_pre_key_needs_rotation(&mut self.storage).await? {
-            rotate_signed_pre_key(&mut self.storage, &identity_key_pair).await?;
-            result.signed_pre_key_rotated = true;
+    /// Claims the key pairs a plan needs, generating any the reserve lacks
+    ///
+    /// # Arguments
+    /// * `factory` - Key factory of the bridge the plan was made for
+    /// * `plan` - Result of `plan_key_maintenance`
+    pub fn claim_maintenance_keys(factory: &KeyFactory, plan: &KeyMaintenancePlan) -> PreparedKeys {
+        use crate::key_rotation::REPLENISH_COUNT;
+
+        let pre_key_count = if plan.replenish_pre_keys {
+            REPLENISH_COUNT as usize
+        } else {
+            0
+        };
+        factory.prepare(
+            plan.rotate_signed_pre_key,
+            plan.rotate_kyber_pre_key,
+            pre_key_count,
+        )
+    }
+
+    /// Rotates and replenishes the keys a plan found due, then cleans up expired keys
+    ///
+    /// # Arguments
+    /// * `plan` - Result of `plan_key_maintenance`
+    /// * `keys` - Source of the new key pairs
+    pub async fn apply_key_maintenance(
+        &mut self,
+        plan: &KeyMaintenancePlan,
+        keys: &impl KeySource,
+    ) -> Result<KeyMaintenanceResult, SignalBridgeError> {
+        use crate::key_rotation::{
+            cleanup_expired_kyber_pre_keys, cleanup_expired_signed_pre_keys, replenish_pre_keys,
+            rotate_kyber_pre_key, rotate_signed_pre_key,
+        };
+
+        let mut result = KeyMaintenanceResult::default();
+
+        let identity_key_pair = self
+            .storage
+            .identity_store()
+            .get_identity_key_pair()
+            .await?;
+
+        if plan.rotate_signed_pre_key {
+            rotate_signed_pre_key(&mut self.storage, &identity_key_pair, keys).await?;
+            result.signed_pre_key_rotated = true;
         }
 
-        // Check and rotate Kyber pre-key if needed (independently)
-        if kyber_pre_key_needs_rotation(&mut self.storage).await? {
-            rotate_kyber_pre_key(&mut self.storage, &identity_key_pair).await?;
+        // Kyber pre-keys rotate independently of the signed pre-key
+        if plan.rotate_kyber_pre_key {
+            rotate_kyber_pre_key(&mut self.storage, &identity_key_pair, keys).await?;
             result.kyber_pre_key_rotated = true;
         }
 
@@ -928,13 +1935,18 @@ impl SignalBridge {
         cleanup_expired_signed_pre_keys(&mut self.storage).await?;
         cleanup_expired_kyber_pre_keys(&mut self.storage).await?;
 
-        // Replenish one-time pre-keys if count is low
-        let pre_key_count = self.storage.pre_key_store().pre_key_count().await;
-        if pre_key_count < MIN_PRE_KEY_COUNT {
-            replenish_pre_keys(&mut self.storage).await?;
+        if plan.replenish_pre_keys {
+            replenish_pre_keys(&mut self.storage, keys).await?;
             result.pre_keys_replenished = true;
         }
 
+        if result.signed_pre_key_rotated
+            || result.kyber_pre_key_rotated
+            || result.pre_keys_replenished
+        {
+            self.invalidate_bundle_announcement();
+        }
+
         Ok(result)
     }
 }
@@ -1054,6 +2066,13 @@ mod ffi {
         pub has_active_session: bool,
     }
 
+    #[derive(Clone, Copy, Debug, Default)]
+    pub struct KeyMaintenancePlan {
+        pub rotate_signed_pre_key: bool,
+        pub rotate_kyber_pre_key: bool,
+        pub replenish_pre_keys: bool,
+    }
+
     #[derive(Clone, Debug, Default)]
     pub struct KeyMaintenanceResult {
         pub signed_pre_key_rotated: bool,
@@ -1067,14 +2086,86 @@ mod ffi {
         pub should_republish_bundle: bool,
     }
 
+    #[derive(Clone, Debug)]
+    pub struct GroupMembership {
+        pub group_id: String,
+        pub name: String,
+        pub sender_rdx: String,
+        pub should_republish_bundle: bool,
+    }
+
+    #[derive(Clone, Debug)]
+    pub struct GroupDecryptionResult {
+        pub group_id: String,
+        pub name: String,
+        pub sender_rdx: String,
+        pub plaintext: Vec<u8>,
+    }
+
+    #[derive(Clone, Debug)]
+    pub struct FanOutFrame {
+        pub recipient: String,
+        pub event_id: String,
+        pub bytes: Vec<u8>,
+        pub error: String,
+    }
+
+    #[derive(Clone, Debug)]
+    pub struct OutgoingTransfer {
+        pub transfer_id: String,
+        pub peer_rdx: String,
+        pub name: String,
+        pub chunk_count: u32,
+        pub pending_chunks: Vec<u32>,
+    }
+
+    #[derive(Clone, Debug)]
+    pub struct DiscoveredBundle {
+        pub nostr_pubkey: String,
+        pub rdx_fingerprint: String,
+        pub event_id: String,
+        pub created_at: u64,
+    }
+
+    #[derive(Clone, Debug)]
+    pub struct MessageSubscription {
+        pub our_pubkey: String,
+        pub group_ids: Vec<String>,
+        pub since: u64,
+    }
+
+    #[derive(Clone, Debug)]
+    pub struct TransferProgress {
+        pub transfer_id: String,
+        pub name: String,
+        pub sender_rdx: String,
+        pub received_chunks: u32,
+        pub chunk_count: u32,
+        pub complete: bool,
+        pub path: String,
+    }
+
     #[derive(Clone, Debug)]
     pub struct BundleInfo {
         pub announcement_json: String,
+        pub event_id: String,
+        pub frame: Vec<u8>,
         pub pre_key_id: u32,
         pub signed_pre_key_id: u32,
         pub kyber_pre_key_id: u32,
     }
 
+    #[derive(Clone, Debug)]
+    pub struct EventTag {
+        pub values: Vec<String>,
+    }
+
+    #[derive(Clone, Debug)]
+    pub struct SignedEventFrame {
+        pub event_id: String,
+        pub frame: Vec<u8>,
+    }
+
     #[derive(Clone, Debug)]
     pub struct PreKeyBundleWithMetadata {
         pub bundle_bytes: Vec<u8>,
@@ -1107,6 +2198,8 @@ mod ffi {
 
     extern "Rust" {
         type SignalBridge;
+        type KeyFactoryHandle;
+        type MaintenanceKeys;
 
         fn new_signal_bridge(db_path: &str) -> Result<Box<SignalBridge>>;
 
@@ -1122,6 +2215,20 @@ mod ffi {
             ciphertext: &[u8],
         ) -> Result<DecryptionResult>;
 
+        fn set_payload_compression(bridge: &mut SignalBridge, enabled: bool);
+
+        fn record_peer_compression(
+            bridge: &mut SignalBridge,
+            rdx_fingerprint: &str,
+            supported: bool,
+        ) -> Result<()>;
+
+        fn record_peer_base64_content(
+            bridge: &mut SignalBridge,
+            rdx_fingerprint: &str,
+            supported: bool,
+        ) -> Result<()>;
+
         fn establish_session(bridge: &mut SignalBridge, peer: &str, bundle: &[u8]) -> Result<()>;
 
         fn generate_pre_key_bundle(bridge: &mut SignalBridge) -> Result<PreKeyBundleWithMetadata>;
@@ -1144,14 +2251,119 @@ mod ffi {
             project_version: &str,
         ) -> Result<String>;
 
-        fn create_subscription_for_self(
+        fn sign_event_frame(
             bridge: &mut SignalBridge,
-            subscription_id: &str,
-            since_timestamp: u64,
+            created_at: u64,
+            kind: u32,
+            tags: &[EventTag],
+            content: &str,
+        ) -> Result<SignedEventFrame>;
+
+        fn create_encrypted_message_frame(
+            bridge: &mut SignalBridge,
+            session_id: &str,
+            ciphertext: &[u8],
+            timestamp: u64,
+            project_version: &str,
+        ) -> Result<SignedEventFrame>;
+
+        fn create_encrypted_message_frames(
+            bridge: &mut SignalBridge,
+            peers: Vec<String>,
+            plaintext: &[u8],
+            timestamp: u64,
+            project_version: &str,
+        ) -> Result<Vec<FanOutFrame>>;
+
+        fn create_group(
+            bridge: &mut SignalBridge,
+            name: &str,
+            members: Vec<String>,
         ) -> Result<String>;
 
+        fn create_sender_key_distribution_frames(
+            bridge: &mut SignalBridge,
+            group: &str,
+            timestamp: u64,
+            project_version: &str,
+        ) -> Result<Vec<FanOutFrame>>;
+
+        fn mark_sender_key_delivered(
+            bridge: &mut SignalBridge,
+            group: &str,
+            member_rdx: &str,
+        ) -> Result<()>;
+
+        fn create_group_message_frame(
+            bridge: &mut SignalBridge,
+            group: &str,
+            plaintext: &[u8],
+            timestamp: u64,
+            project_version: &str,
+        ) -> Result<SignedEventFrame>;
+
+        fn process_sender_key_distribution(
+            bridge: &mut SignalBridge,
+            peer_hint: &str,
+            ciphertext: &[u8],
+        ) -> Result<GroupMembership>;
+
+        fn decrypt_group_message(
+            bridge: &mut SignalBridge,
+            peer_hint: &str,
+            group_id: &str,
+            ciphertext: &[u8],
+        ) -> Result<GroupDecryptionResult>;
+
+        fn start_file_transfer(
+            bridge: &mut SignalBridge,
+            peer: &str,
+            path: &str,
+        ) -> Result<OutgoingTransfer>;
+
+        fn pending_file_transfers(bridge: &mut SignalBridge) -> Result<Vec<OutgoingTransfer>>;
+
+        fn create_transfer_chunk_frame(
+            bridge: &mut SignalBridge,
+            transfer_id: &str,
+            chunk_index: u32,
+            timestamp: u64,
+            project_version: &str,
+        ) -> Result<SignedEventFrame>;
+
+        fn mark_transfer_chunk_delivered(
+            bridge: &mut SignalBridge,
+            transfer_id: &str,
+            chunk_index: u32,
+        ) -> Result<bool>;
+
+        fn process_transfer_chunk(
+            bridge: &mut SignalBridge,
+            peer_hint: &str,
+            ciphertext: &[u8],
+        ) -> Result<TransferProgress>;
+
+        fn save_discovered_bundle(
+            bridge: &mut SignalBridge,
+            bundle: &DiscoveredBundle,
+            bundle_base64: &str,
+        ) -> Result<()>;
+
+        fn cached_discovered_bundles(bridge: &mut SignalBridge) -> Result<Vec<DiscoveredBundle>>;
+
+        fn load_discovered_bundle(bridge: &mut SignalBridge, nostr_pubkey: &str) -> Result<String>;
+
+        fn forget_discovered_bundle(bridge: &mut SignalBridge, nostr_pubkey: &str) -> Result<()>;
+
+        fn message_subscription(
+            bridge: &mut SignalBridge,
+            since_timestamp: u64,
+        ) -> Result<MessageSubscription>;
+
         fn update_last_message_timestamp(bridge: &mut SignalBridge, timestamp: u64) -> Result<()>;
 
+        fn verify_events(events: Vec<String>) -> Vec<bool>;
+
         fn lookup_contact(bridge: &mut SignalBridge, identifier: &str) -> Result<ContactInfo>;
 
         fn assign_contact_alias(
@@ -1172,6 +2384,11 @@ mod ffi {
             project_version: &str,
         ) -> Result<String>;
 
+        fn generate_empty_bundle_frame(
+            bridge: &mut SignalBridge,
+            project_version: &str,
+        ) -> Result<SignedEventFrame>;
+
         fn add_contact_and_establish_session(
             bridge: &mut SignalBridge,
             bundle_bytes: &[u8],
@@ -1194,7 +2411,20 @@ mod ffi {
             bundle_base64: &str,
         ) -> Result<String>;
 
-        fn perform_key_maintenance(bridge: &mut SignalBridge) -> Result<KeyMaintenanceResult>;
+        fn key_factory_handle(bridge: &SignalBridge) -> Box<KeyFactoryHandle>;
+
+        fn plan_key_maintenance(bridge: &mut SignalBridge) -> Result<KeyMaintenancePlan>;
+
+        fn claim_maintenance_keys(
+            factory: &KeyFactoryHandle,
+            plan: &KeyMaintenancePlan,
+        ) -> Box<MaintenanceKeys>;
+
+        fn apply_key_maintenance(
+            bridge: &mut SignalBridge,
+            plan: &KeyMaintenancePlan,
+            keys: &MaintenanceKeys,
+        ) -> Result<KeyMaintenanceResult>;
 
         fn record_published_bundle(
             bridge: &mut SignalBridge,
@@ -1283,6 +2513,47 @@ pub fn decrypt_message(
     })
 }
 
+/// Opts the node in or out of payload compression for outgoing messages
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+/// * `enabled` - Whether to advertise and use zstd plaintext compression
+pub fn set_payload_compression(bridge: &mut SignalBridge, enabled: bool) {
+    bridge.set_payload_compression(enabled);
+}
+
+/// Records whether a peer advertised support for compressed plaintext
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+/// * `rdx_fingerprint` - Sender's RDX fingerprint
+/// * `supported` - Whether the sender's latest message carried the zstd capability
+pub fn record_peer_compression(
+    bridge: &mut SignalBridge,
+    rdx_fingerprint: &str,
+    supported: bool,
+) -> Result<(), Box<dyn std::error::Error>> {
+    bridge
+        .record_peer_compression(rdx_fingerprint, supported)
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })
+}
+
+/// Records whether a peer showed it accepts base64 encrypted message content
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+/// * `rdx_fingerprint` - Sender's RDX fingerprint
+/// * `supported` - Whether the sender's latest message was base64 or listed base64
+pub fn record_peer_base64_content(
+    bridge: &mut SignalBridge,
+    rdx_fingerprint: &str,
+    supported: bool,
+) -> Result<(), Box<dyn std::error::Error>> {
+    bridge
+        .record_peer_base64_content(rdx_fingerprint, supported)
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })
+}
+
 /// Establishes a Signal Protocol session from a prekey bundle
 ///
 /// # Arguments
@@ -1360,20 +2631,83 @@ pub fn reset_identity(bridge: &mut SignalBridge) -> Result<(), Box<dyn std::erro
         .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })
 }
 
-/// Performs periodic key rotation and cleanup
+/// Key factory of a bridge, usable while another thread holds the bridge
+pub struct KeyFactoryHandle(Arc<KeyFactory>);
+
+/// Key pairs claimed for one maintenance run
+pub struct MaintenanceKeys(PreparedKeys);
+
+fn to_plan(plan: &ffi::KeyMaintenancePlan) -> KeyMaintenancePlan {
+    KeyMaintenancePlan {
+        rotate_signed_pre_key: plan.rotate_signed_pre_key,
+        rotate_kyber_pre_key: plan.rotate_kyber_pre_key,
+        replenish_pre_keys: plan.replenish_pre_keys,
+    }
+}
+
+/// Returns a handle to the bridge's key factory
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+pub fn key_factory_handle(bridge: &SignalBridge) -> Box<KeyFactoryHandle> {
+    Box::new(KeyFactoryHandle(bridge.key_factory()))
+}
+
+/// Checks which keys are due for rotation or replenishment
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+///
+/// # Returns
+/// Keys the next apply_key_maintenance call should rotate or replenish
+pub fn plan_key_maintenance(
+    bridge: &mut SignalBridge,
+) -> Result<ffi::KeyMaintenancePlan, Box<dyn std::error::Error>> {
+    let rt = tokio::runtime::Runtime::new()
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })?;
+    let plan = rt
+        .block_on(bridge.plan_key_maintenance())
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })?;
+    Ok(ffi::KeyMaintenancePlan {
+        rotate_signed_pre_key: plan.rotate_signed_pre_key,
+        rotate_kyber_pre_key: plan.rotate_kyber_pre_key,
+        replenish_pre_keys: plan.replenish_pre_keys,
+    })
+}
+
+/// Claims the key pairs a maintenance plan needs, generating any the reserve lacks
+///
+/// # Arguments
+/// * `factory` - Key factory of the planned bridge
+/// * `plan` - Result of plan_key_maintenance
+pub fn claim_maintenance_keys(
+    factory: &KeyFactoryHandle,
+    plan: &ffi::KeyMaintenancePlan,
+) -> Box<MaintenanceKeys> {
+    Box::new(MaintenanceKeys(SignalBridge::claim_maintenance_keys(
+        &factory.0,
+        &to_plan(plan),
+    )))
+}
+
+/// Performs the key rotation, replenishment and cleanup a plan found due
 ///
 /// # Arguments
 /// * `bridge` - Signal bridge instance
+/// * `plan` - Result of plan_key_maintenance
+/// * `keys` - Key pairs claimed for the plan
 ///
 /// # Returns
 /// KeyMaintenanceResult indicating which keys were rotated
-pub fn perform_key_maintenance(
+pub fn apply_key_maintenance(
     bridge: &mut SignalBridge,
+    plan: &ffi::KeyMaintenancePlan,
+    keys: &MaintenanceKeys,
 ) -> Result<ffi::KeyMaintenanceResult, Box<dyn std::error::Error>> {
     let rt = tokio::runtime::Runtime::new()
         .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })?;
     let result = rt
-        .block_on(bridge.perform_key_maintenance())
+        .block_on(bridge.apply_key_maintenance(&to_plan(plan), &keys.0))
         .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })?;
     Ok(ffi::KeyMaintenanceResult {
         signed_pre_key_rotated: result.signed_pre_key_rotated,
@@ -1395,9 +2729,7 @@ pub fn record_published_bundle(
     signed_pre_key_id: u32,
     kyber_pre_key_id: u32,
 ) -> Result<(), Box<dyn std::error::Error>> {
-    bridge
-        .storage
-        .record_published_bundle(pre_key_id, signed_pre_key_id, kyber_pre_key_id)?;
+    bridge.record_published_bundle(pre_key_id, signed_pre_key_id, kyber_pre_key_id)?;
     Ok(())
 }
 
@@ -1669,271 +3001,748 @@ pub fn create_and_sign_encrypted_message(
     sign_nostr_event(bridge, &event_json_str)
 }
 
-/// Creates a Nostr subscription filter for messages to this node
+/// Signs an event from typed fields and returns the wire-ready frame
 ///
 /// # Arguments
 /// * `bridge` - Signal bridge instance
-/// * `subscription_id` - Subscription identifier
-/// * `since_timestamp` - Optional timestamp to filter messages since
+/// * `created_at` - Unix timestamp
+/// * `kind` - Nostr event kind
+/// * `tags` - Event tags
+/// * `content` - Event content
 ///
 /// # Returns
-/// REQ message JSON
-pub fn create_subscription_for_self(
+/// Event ID and `["EVENT", {...}]` frame bytes
+pub fn sign_event_frame(
     bridge: &mut SignalBridge,
-    subscription_id: &str,
-    since_timestamp: u64,
-) -> Result<String, Box<dyn std::error::Error>> {
-    let rt = tokio::runtime::Runtime::new()
+    created_at: u64,
+    kind: u32,
+    tags: &[ffi::EventTag],
+    content: &str,
+) -> Result<ffi::SignedEventFrame, Box<dyn std::error::Error>> {
+    let rt = tokio::runtime::Runtime::new()?;
+    let tags = tags.iter().map(|tag| tag.values.clone()).collect();
+    let (event_id, frame) = rt
+        .block_on(bridge.sign_event_frame(created_at, kind, tags, content))
         .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })?;
-    rt.block_on(bridge.create_subscription_for_self(subscription_id, since_timestamp))
-        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })
+    Ok(ffi::SignedEventFrame { event_id, frame })
 }
 
-/// Updates the timestamp of the last received message
+/// Creates, signs, and frames a Nostr encrypted message event
 ///
 /// # Arguments
 /// * `bridge` - Signal bridge instance
+/// * `session_id` - Recipient's session identifier
+/// * `ciphertext` - Raw Signal Protocol ciphertext
 /// * `timestamp` - Unix timestamp
-pub fn update_last_message_timestamp(
+/// * `project_version` - Protocol version string
+///
+/// # Returns
+/// Event ID and `["EVENT", {...}]` frame bytes
+pub fn create_encrypted_message_frame(
     bridge: &mut SignalBridge,
+    session_id: &str,
+    ciphertext: &[u8],
     timestamp: u64,
-) -> Result<(), Box<dyn std::error::Error>> {
-    let rt = tokio::runtime::Runtime::new()
+    project_version: &str,
+) -> Result<ffi::SignedEventFrame, Box<dyn std::error::Error>> {
+    let rt = tokio::runtime::Runtime::new()?;
+    let (event_id, frame) = rt
+        .block_on(bridge.create_encrypted_message_frame(
+            session_id,
+            ciphertext,
+            timestamp,
+            project_version,
+        ))
         .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })?;
-    rt.block_on(bridge.update_last_message_timestamp(timestamp))
-        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })
+    Ok(ffi::SignedEventFrame { event_id, frame })
 }
 
-/// Looks up a contact by RDX fingerprint or alias
+/// Encrypts one message for many peers and frames an event for each
 ///
 /// # Arguments
 /// * `bridge` - Signal bridge instance
-/// * `identifier` - Contact identifier (RDX fingerprint or user alias)
+/// * `peers` - Recipient RDX fingerprints, aliases, or Nostr pubkeys
+/// * `plaintext` - Message bytes
+/// * `timestamp` - Unix timestamp
+/// * `project_version` - Protocol version string
 ///
 /// # Returns
-/// Contact information
-pub fn lookup_contact(
+/// One entry per peer, carrying either a frame or the reason it was skipped
+pub fn create_encrypted_message_frames(
     bridge: &mut SignalBridge,
-    identifier: &str,
-) -> Result<ffi::ContactInfo, Box<dyn std::error::Error>> {
+    peers: Vec<String>,
+    plaintext: &[u8],
+    timestamp: u64,
+    project_version: &str,
+) -> Result<Vec<ffi::FanOutFrame>, Box<dyn std::error::Error>> {
     let rt = tokio::runtime::Runtime::new()?;
-    let contact = rt.block_on(bridge.lookup_contact(identifier))?;
-    Ok(ffi::ContactInfo {
-        rdx_fingerprint: contact.rdx_fingerprint,
-        nostr_pubkey: contact.nostr_pubkey,
-        user_alias: contact.user_alias.unwrap_or_default(),
-        has_active_session: contact.has_active_session,
-    })
+    let frames = rt
+        .block_on(bridge.create_encrypted_message_frames(
+            &peers,
+            plaintext,
+            timestamp,
+            project_version,
+        ))
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })?;
+    Ok(frames
+        .into_iter()
+        .map(|frame| ffi::FanOutFrame {
+            recipient: frame.recipient,
+            event_id: frame.event_id,
+            bytes: frame.bytes,
+            error: frame.error,
+        })
+        .collect())
 }
 
-/// Assigns an alias to a contact
+/// Creates a sender key group of existing contacts
 ///
 /// # Arguments
 /// * `bridge` - Signal bridge instance
-/// * `identifier` - Contact's RDX fingerprint
-/// * `new_alias` - User-friendly alias
-pub fn assign_contact_alias(
+/// * `name` - Human-readable group name
+/// * `members` - RDX fingerprints, aliases, or Nostr pubkeys of the other members
+///
+/// # Returns
+/// Distribution ID of the new group
+pub fn create_group(
     bridge: &mut SignalBridge,
-    identifier: &str,
-    new_alias: &str,
-) -> Result<(), Box<dyn std::error::Error>> {
+    name: &str,
+    members: Vec<String>,
+) -> Result<String, Box<dyn std::error::Error>> {
     let rt = tokio::runtime::Runtime::new()?;
-    rt.block_on(bridge.assign_contact_alias(identifier, new_alias))
+    rt.block_on(bridge.create_group(name, &members))
         .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })
 }
 
-/// Lists all known contacts
+/// Builds sender key distribution events for group members that don't have this node's key
 ///
 /// # Arguments
 /// * `bridge` - Signal bridge instance
+/// * `group` - Group distribution ID or name
+/// * `timestamp` - Unix timestamp
+/// * `project_version` - Protocol version string
 ///
 /// # Returns
-/// Vector of contact information structs
-pub fn list_contacts(
+/// One signed `["EVENT", {...}]` frame per member that was sent the key
+pub fn create_sender_key_distribution_frames(
     bridge: &mut SignalBridge,
-) -> Result<Vec<ffi::ContactInfo>, Box<dyn std::error::Error>> {
+    group: &str,
+    timestamp: u64,
+    project_version: &str,
+) -> Result<Vec<ffi::FanOutFrame>, Box<dyn std::error::Error>> {
     let rt = tokio::runtime::Runtime::new()?;
-    let contacts = rt.block_on(bridge.list_contacts())?;
-    Ok(contacts
+    let frames = rt
+        .block_on(bridge.create_sender_key_distribution_frames(group, timestamp, project_version))
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })?;
+    Ok(frames
         .into_iter()
-        .map(|c| ffi::ContactInfo {
-            rdx_fingerprint: c.rdx_fingerprint,
-            nostr_pubkey: c.nostr_pubkey,
-            user_alias: c.user_alias.unwrap_or_default(),
-            has_active_session: c.has_active_session,
+        .map(|frame| ffi::FanOutFrame {
+            recipient: frame.recipient,
+            event_id: frame.event_id,
+            bytes: frame.bytes,
+            error: frame.error,
         })
         .collect())
 }
 
-/// Generates a signed prekey bundle announcement
+/// Records that a relay accepted a member's sender key distribution
 ///
 /// # Arguments
 /// * `bridge` - Signal bridge instance
-/// * `project_version` - Protocol version string
+/// * `group` - Group distribution ID or name
+/// * `member_rdx` - RDX fingerprint of the member
+pub fn mark_sender_key_delivered(
+    bridge: &mut SignalBridge,
+    group: &str,
+    member_rdx: &str,
+) -> Result<(), Box<dyn std::error::Error>> {
+    bridge
+        .mark_sender_key_delivered(group, member_rdx)
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })
+}
+
+/// Encrypts a message once for a group and frames it as a single event
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+/// * `group` - Group distribution ID or name
+/// * `plaintext` - Message bytes
+/// * `timestamp` - Unix timestamp
+/// * `project_version` - Protocol version string
 ///
 /// # Returns
-/// Bundle information with announcement JSON and prekey IDs
-pub fn generate_prekey_bundle_announcement(
+/// Event ID and `["EVENT", {...}]` frame bytes
+pub fn create_group_message_frame(
     bridge: &mut SignalBridge,
+    group: &str,
+    plaintext: &[u8],
+    timestamp: u64,
     project_version: &str,
-) -> Result<ffi::BundleInfo, Box<dyn std::error::Error>> {
+) -> Result<ffi::SignedEventFrame, Box<dyn std::error::Error>> {
     let rt = tokio::runtime::Runtime::new()?;
-    rt.block_on(bridge.generate_prekey_bundle_announcement(project_version))
-        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })
+    let (event_id, frame) = rt
+        .block_on(bridge.create_group_message_frame(group, plaintext, timestamp, project_version))
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })?;
+    Ok(ffi::SignedEventFrame { event_id, frame })
 }
 
-/// Generates an empty bundle announcement for unpublishing
+/// Processes a sender key distribution received from a group member
 ///
 /// # Arguments
 /// * `bridge` - Signal bridge instance
-/// * `project_version` - Protocol version string
+/// * `peer_hint` - Nostr pubkey of the event author
+/// * `ciphertext` - Pairwise Signal ciphertext of the distribution
 ///
 /// # Returns
-/// Signed empty bundle announcement JSON
-pub fn generate_empty_bundle_announcement(
+/// Group and sender the key belongs to
+pub fn process_sender_key_distribution(
     bridge: &mut SignalBridge,
-    project_version: &str,
-) -> Result<String, Box<dyn std::error::Error>> {
+    peer_hint: &str,
+    ciphertext: &[u8],
+) -> Result<ffi::GroupMembership, Box<dyn std::error::Error>> {
     let rt = tokio::runtime::Runtime::new()?;
-    rt.block_on(bridge.generate_empty_bundle_announcement(project_version))
-        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })
+    let membership = rt
+        .block_on(bridge.process_sender_key_distribution(peer_hint, ciphertext))
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })?;
+    Ok(ffi::GroupMembership {
+        group_id: membership.group_id,
+        name: membership.name,
+        sender_rdx: membership.sender_rdx,
+        should_republish_bundle: membership.should_republish_bundle,
+    })
 }
 
-/// Adds a contact from a bundle and establishes a session
+/// Decrypts a group message with the sender's distributed sender key
 ///
 /// # Arguments
 /// * `bridge` - Signal bridge instance
-/// * `bundle_bytes` - Serialized prekey bundle
-/// * `user_alias` - Optional user-assigned alias
+/// * `peer_hint` - Nostr pubkey of the event author
+/// * `group_id` - Distribution ID from the event's `g` tag
+/// * `ciphertext` - Serialized SenderKeyMessage
 ///
 /// # Returns
-/// RDX fingerprint of the added contact
-pub fn add_contact_and_establish_session(
+/// Group, sender, and decrypted plaintext
+pub fn decrypt_group_message(
     bridge: &mut SignalBridge,
-    bundle_bytes: &[u8],
-    user_alias: &str,
-) -> Result<String, Box<dyn std::error::Error>> {
+    peer_hint: &str,
+    group_id: &str,
+    ciphertext: &[u8],
+) -> Result<ffi::GroupDecryptionResult, Box<dyn std::error::Error>> {
     let rt = tokio::runtime::Runtime::new()?;
-    let alias = if user_alias.is_empty() {
-        None
-    } else {
-        Some(user_alias)
-    };
-    rt.block_on(bridge.add_contact_and_establish_session(bundle_bytes, alias))
-        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })
+    let result = rt
+        .block_on(bridge.decrypt_group_message(peer_hint, group_id, ciphertext))
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })?;
+    Ok(ffi::GroupDecryptionResult {
+        group_id: result.group_id,
+        name: result.name,
+        sender_rdx: result.sender_rdx,
+        plaintext: result.plaintext,
+    })
 }
 
-/// Adds a contact from a base64-encoded bundle and establishes a session
+fn to_ffi_outgoing_transfer(transfer: OutgoingTransfer) -> ffi::OutgoingTransfer {
+    ffi::OutgoingTransfer {
+        transfer_id: transfer.transfer_id,
+        peer_rdx: transfer.peer_rdx,
+        name: transfer.name,
+        chunk_count: transfer.chunk_count,
+        pending_chunks: transfer.pending_chunks,
+    }
+}
+
+/// Registers a file to be sent to a peer in chunks
 ///
 /// # Arguments
 /// * `bridge` - Signal bridge instance
-/// * `bundle_base64` - Base64-encoded prekey bundle
-/// * `user_alias` - Optional user-assigned alias
+/// * `peer` - RDX fingerprint, alias, or Nostr pubkey of the recipient
+/// * `path` - File to send
 ///
 /// # Returns
-/// RDX fingerprint of the added contact
-pub fn add_contact_and_establish_session_from_base64(
+/// The new transfer with every chunk pending
+pub fn start_file_transfer(
     bridge: &mut SignalBridge,
-    bundle_base64: &str,
-    user_alias: &str,
-) -> Result<String, Box<dyn std::error::Error>> {
-    use base64::Engine;
-    let bundle_bytes = base64::engine::general_purpose::STANDARD
-        .decode(bundle_base64)
-        .map_err(|e| -> Box<dyn std::error::Error> {
-            Box::new(SignalBridgeError::Protocol(format!(
-                "Base64 decode error: {}",
-                e
-            )))
-        })?;
+    peer: &str,
+    path: &str,
+) -> Result<ffi::OutgoingTransfer, Box<dyn std::error::Error>> {
+    let rt = tokio::runtime::Runtime::new()?;
+    let transfer = rt
+        .block_on(bridge.start_file_transfer(peer, path))
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })?;
+    Ok(to_ffi_outgoing_transfer(transfer))
+}
 
-    add_contact_and_establish_session(bridge, &bundle_bytes, user_alias)
+/// Lists outgoing transfers with chunks a relay has not yet accepted
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+///
+/// # Returns
+/// Unfinished transfers, oldest first
+pub fn pending_file_transfers(
+    bridge: &mut SignalBridge,
+) -> Result<Vec<ffi::OutgoingTransfer>, Box<dyn std::error::Error>> {
+    let transfers = bridge
+        .pending_file_transfers()
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })?;
+    Ok(transfers
+        .into_iter()
+        .map(to_ffi_outgoing_transfer)
+        .collect())
 }
 
-/// Extracts RDX fingerprint from a prekey bundle without adding contact
+/// Encrypts one chunk of an outgoing transfer and frames it as an event
 ///
 /// # Arguments
-/// * `_bridge` - Signal bridge instance (unused)
-/// * `bundle_bytes` - Serialized prekey bundle
+/// * `bridge` - Signal bridge instance
+/// * `transfer_id` - Outgoing transfer
+/// * `chunk_index` - Chunk to send
+/// * `timestamp` - Unix timestamp
+/// * `project_version` - Protocol version string
 ///
 /// # Returns
-/// RDX fingerprint
-pub fn extract_rdx_from_bundle(
-    _bridge: &mut SignalBridge,
-    bundle_bytes: &[u8],
-) -> Result<String, Box<dyn std::error::Error>> {
-    use libsignal_protocol::IdentityKey;
+/// Event ID and `["EVENT", {...}]` frame bytes
+pub fn create_transfer_chunk_frame(
+    bridge: &mut SignalBridge,
+    transfer_id: &str,
+    chunk_index: u32,
+    timestamp: u64,
+    project_version: &str,
+) -> Result<ffi::SignedEventFrame, Box<dyn std::error::Error>> {
+    let rt = tokio::runtime::Runtime::new()?;
+    let (event_id, frame) = rt
+        .block_on(bridge.create_transfer_chunk_frame(
+            transfer_id,
+            chunk_index,
+            timestamp,
+            project_version,
+        ))
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })?;
+    Ok(ffi::SignedEventFrame { event_id, frame })
+}
 
-    let bundle: SerializablePreKeyBundle =
-        bincode::deserialize(bundle_bytes).map_err(|e| -> Box<dyn std::error::Error> {
-            Box::new(SignalBridgeError::InvalidInput(format!(
-                "Failed to deserialize bundle: {}",
-                e
-            )))
-        })?;
+/// Records that a relay accepted a chunk of an outgoing transfer
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+/// * `transfer_id` - Outgoing transfer
+/// * `chunk_index` - Accepted chunk
+///
+/// # Returns
+/// True once every chunk has been accepted
+pub fn mark_transfer_chunk_delivered(
+    bridge: &mut SignalBridge,
+    transfer_id: &str,
+    chunk_index: u32,
+) -> Result<bool, Box<dyn std::error::Error>> {
+    bridge
+        .mark_transfer_chunk_delivered(transfer_id, chunk_index)
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })
+}
 
-    let identity_key =
-        IdentityKey::decode(&bundle.identity_key).map_err(|e| -> Box<dyn std::error::Error> {
-            Box::new(SignalBridgeError::Protocol(e.to_string()))
-        })?;
+/// Remembers a discovered bundle announcement across restarts
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+/// * `bundle` - Announcement metadata
+/// * `bundle_base64` - Base64-encoded bundle data
+pub fn save_discovered_bundle(
+    bridge: &mut SignalBridge,
+    bundle: &ffi::DiscoveredBundle,
+    bundle_base64: &str,
+) -> Result<(), Box<dyn std::error::Error>> {
+    let cached = CachedBundle {
+        nostr_pubkey: bundle.nostr_pubkey.clone(),
+        rdx_fingerprint: bundle.rdx_fingerprint.clone(),
+        event_id: bundle.event_id.clone(),
+        created_at: bundle.created_at,
+    };
+    bridge
+        .save_discovered_bundle(&cached, bundle_base64)
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })
+}
 
-    Ok(ContactManager::generate_identity_fingerprint_from_key(
-        &identity_key,
-    ))
+/// Lists cached bundle announcements without their bundle data
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+pub fn cached_discovered_bundles(
+    bridge: &mut SignalBridge,
+) -> Result<Vec<ffi::DiscoveredBundle>, Box<dyn std::error::Error>> {
+    let bundles = bridge
+        .cached_discovered_bundles()
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })?;
+    Ok(bundles
+        .into_iter()
+        .map(|bundle| ffi::DiscoveredBundle {
+            nostr_pubkey: bundle.nostr_pubkey,
+            rdx_fingerprint: bundle.rdx_fingerprint,
+            event_id: bundle.event_id,
+            created_at: bundle.created_at,
+        })
+        .collect())
 }
 
-/// Extracts RDX fingerprint from a base64-encoded prekey bundle
+/// Reads the bundle data of a cached announcement
 ///
 /// # Arguments
 /// * `bridge` - Signal bridge instance
-/// * `bundle_base64` - Base64-encoded prekey bundle
+/// * `nostr_pubkey` - Nostr pubkey of the announcing node
 ///
 /// # Returns
-/// RDX fingerprint
-pub fn extract_rdx_from_bundle_base64(
+/// Base64-encoded bundle, or an empty string if none is cached
+pub fn load_discovered_bundle(
     bridge: &mut SignalBridge,
-    bundle_base64: &str,
+    nostr_pubkey: &str,
 ) -> Result<String, Box<dyn std::error::Error>> {
-    use base64::Engine;
-    let bundle_bytes = base64::engine::general_purpose::STANDARD
-        .decode(bundle_base64)
-        .map_err(|e| -> Box<dyn std::error::Error> {
-            Box::new(SignalBridgeError::Protocol(format!(
-                "Base64 decode error: {}",
-                e
-            )))
-        })?;
+    bridge
+        .load_discovered_bundle(nostr_pubkey)
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })
+}
 
-    extract_rdx_from_bundle(bridge, &bundle_bytes)
+/// Forgets the cached bundle announcement of a pubkey
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+/// * `nostr_pubkey` - Nostr pubkey of the announcing node
+pub fn forget_discovered_bundle(
+    bridge: &mut SignalBridge,
+    nostr_pubkey: &str,
+) -> Result<(), Box<dyn std::error::Error>> {
+    bridge
+        .forget_discovered_bundle(nostr_pubkey)
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })
 }
 
-#[cfg(test)]
-mod tests {
-    use super::*;
-    use std::time::{SystemTime, UNIX_EPOCH};
+/// Decrypts a received file chunk and stores it
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+/// * `peer_hint` - Nostr pubkey of the event author
+/// * `ciphertext` - Pairwise Signal ciphertext of the chunk
+///
+/// # Returns
+/// Progress of the transfer the chunk belongs to
+pub fn process_transfer_chunk(
+    bridge: &mut SignalBridge,
+    peer_hint: &str,
+    ciphertext: &[u8],
+) -> Result<ffi::TransferProgress, Box<dyn std::error::Error>> {
+    let rt = tokio::runtime::Runtime::new()?;
+    let progress = rt
+        .block_on(bridge.process_transfer_chunk(peer_hint, ciphertext))
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })?;
+    Ok(ffi::TransferProgress {
+        transfer_id: progress.transfer_id,
+        name: progress.name,
+        sender_rdx: progress.sender_rdx,
+        received_chunks: progress.received_chunks,
+        chunk_count: progress.chunk_count,
+        complete: progress.complete,
+        path: progress.path,
+    })
+}
 
-    #[test]
-    fn test_libsignal_basic_types() {
-        let device_id = DeviceId::new(1).expect("Valid device ID");
-        let protocol_address = ProtocolAddress::new("test_device".to_string(), device_id);
-        assert_eq!(protocol_address.name(), "test_device");
-        assert_eq!(protocol_address.device_id(), device_id);
-    }
+/// Returns what this node subscribes to in order to receive its messages
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+/// * `since_timestamp` - Timestamp to receive messages since, 0 for the stored one
+///
+/// # Returns
+/// Pubkey, group IDs and lower bound of the message subscription
+pub fn message_subscription(
+    bridge: &mut SignalBridge,
+    since_timestamp: u64,
+) -> Result<ffi::MessageSubscription, Box<dyn std::error::Error>> {
+    let rt = tokio::runtime::Runtime::new()
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })?;
+    let subscription = rt
+        .block_on(bridge.message_subscription(since_timestamp))
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })?;
+    Ok(ffi::MessageSubscription {
+        our_pubkey: subscription.our_pubkey,
+        group_ids: subscription.group_ids,
+        since: subscription.since,
+    })
+}
 
-    #[tokio::test]
-    async fn test_nostr_key_derivation_deterministic() {
-        let temp_dir = std::env::temp_dir();
-        let db_path = temp_dir.join("test_nostr_derivation.db");
-        let mut bridge = SignalBridge::new(db_path.to_str().unwrap()).await.unwrap();
+/// Updates the timestamp of the last received message
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+/// * `timestamp` - Unix timestamp
+pub fn update_last_message_timestamp(
+    bridge: &mut SignalBridge,
+    timestamp: u64,
+) -> Result<(), Box<dyn std::error::Error>> {
+    let rt = tokio::runtime::Runtime::new()
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })?;
+    rt.block_on(bridge.update_last_message_timestamp(timestamp))
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })
+}
 
-        let nostr_keypair1 = bridge.derive_nostr_keypair().await.unwrap();
-        let nostr_keypair2 = bridge.derive_nostr_keypair().await.unwrap();
+/// Checks the ID and BIP-340 signature of relay-delivered events
+///
+/// Needs no bridge state, so callers can verify without holding the bridge.
+///
+/// # Arguments
+/// * `events` - Event objects as JSON
+///
+/// # Returns
+/// One flag per event, in order: true if the event is authentic
+pub fn verify_events(events: Vec<String>) -> Vec<bool> {
+    event_verification::verify_events(&events)
+}
 
-        assert_eq!(nostr_keypair1.secret_key(), nostr_keypair2.secret_key());
-        assert_eq!(nostr_keypair1.public_key(), nostr_keypair2.public_key());
+/// Looks up a contact by RDX fingerprint or alias
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+/// * `identifier` - Contact identifier (RDX fingerprint or user alias)
+///
+/// # Returns
+/// Contact information
+pub fn lookup_contact(
+    bridge: &mut SignalBridge,
+    identifier: &str,
+) -> Result<ffi::ContactInfo, Box<dyn std::error::Error>> {
+    let rt = tokio::runtime::Runtime::new()?;
+    let contact = rt.block_on(bridge.lookup_contact(identifier))?;
+    Ok(ffi::ContactInfo {
+        rdx_fingerprint: contact.rdx_fingerprint,
+        nostr_pubkey: contact.nostr_pubkey,
+        user_alias: contact.user_alias.unwrap_or_default(),
+        has_active_session: contact.has_active_session,
+    })
+}
 
-        let _ = std::fs::remove_file(&db_path);
-    }
+/// Assigns an alias to a contact
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+/// * `identifier` - Contact's RDX fingerprint
+/// * `new_alias` - User-friendly alias
+pub fn assign_contact_alias(
+    bridge: &mut SignalBridge,
+    identifier: &str,
+    new_alias: &str,
+) -> Result<(), Box<dyn std::error::Error>> {
+    let rt = tokio::runtime::Runtime::new()?;
+    rt.block_on(bridge.assign_contact_alias(identifier, new_alias))
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })
+}
+
+/// Lists all known contacts
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+///
+/// # Returns
+/// Vector of contact information structs
+pub fn list_contacts(
+    bridge: &mut SignalBridge,
+) -> Result<Vec<ffi::ContactInfo>, Box<dyn std::error::Error>> {
+    let rt = tokio::runtime::Runtime::new()?;
+    let contacts = rt.block_on(bridge.list_contacts())?;
+    Ok(contacts
+        .into_iter()
+        .map(|c| ffi::ContactInfo {
+            rdx_fingerprint: c.rdx_fingerprint,
+            nostr_pubkey: c.nostr_pubkey,
+            user_alias: c.user_alias.unwrap_or_default(),
+            has_active_session: c.has_active_session,
+        })
+        .collect())
+}
+
+/// Generates a signed prekey bundle announcement
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+/// * `project_version` - Protocol version string
+///
+/// # Returns
+/// Bundle information with announcement JSON and prekey IDs
+pub fn generate_prekey_bundle_announcement(
+    bridge: &mut SignalBridge,
+    project_version: &str,
+) -> Result<ffi::BundleInfo, Box<dyn std::error::Error>> {
+    let rt = tokio::runtime::Runtime::new()?;
+    rt.block_on(bridge.generate_prekey_bundle_announcement(project_version))
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })
+}
+
+/// Generates an empty bundle announcement for unpublishing
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+/// * `project_version` - Protocol version string
+///
+/// # Returns
+/// Signed empty bundle announcement JSON
+pub fn generate_empty_bundle_announcement(
+    bridge: &mut SignalBridge,
+    project_version: &str,
+) -> Result<String, Box<dyn std::error::Error>> {
+    let rt = tokio::runtime::Runtime::new()?;
+    rt.block_on(bridge.generate_empty_bundle_announcement(project_version))
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })
+}
+
+/// Generates an empty bundle announcement frame for unpublishing
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+/// * `project_version` - Protocol version string
+///
+/// # Returns
+/// Event ID and `["EVENT", {...}]` frame bytes
+pub fn generate_empty_bundle_frame(
+    bridge: &mut SignalBridge,
+    project_version: &str,
+) -> Result<ffi::SignedEventFrame, Box<dyn std::error::Error>> {
+    let rt = tokio::runtime::Runtime::new()?;
+    let (event_id, frame) = rt
+        .block_on(bridge.generate_empty_bundle_frame(project_version))
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })?;
+    Ok(ffi::SignedEventFrame { event_id, frame })
+}
+
+/// Adds a contact from a bundle and establishes a session
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+/// * `bundle_bytes` - Serialized prekey bundle
+/// * `user_alias` - Optional user-assigned alias
+///
+/// # Returns
+/// RDX fingerprint of the added contact
+pub fn add_contact_and_establish_session(
+    bridge: &mut SignalBridge,
+    bundle_bytes: &[u8],
+    user_alias: &str,
+) -> Result<String, Box<dyn std::error::Error>> {
+    let rt = tokio::runtime::Runtime::new()?;
+    let alias = if user_alias.is_empty() {
+        None
+    } else {
+        Some(user_alias)
+    };
+    rt.block_on(bridge.add_contact_and_establish_session(bundle_bytes, alias))
+        .map_err(|e| -> Box<dyn std::error::Error> { Box::new(e) })
+}
+
+/// Adds a contact from a base64-encoded bundle and establishes a session
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+/// * `bundle_base64` - Base64-encoded prekey bundle
+/// * `user_alias` - Optional user-assigned alias
+///
+/// # Returns
+/// RDX fingerprint of the added contact
+pub fn add_contact_and_establish_session_from_base64(
+    bridge: &mut SignalBridge,
+    bundle_base64: &str,
+    user_alias: &str,
+) -> Result<String, Box<dyn std::error::Error>> {
+    use base64::Engine;
+    let bundle_bytes = base64::engine::general_purpose::STANDARD
+        .decode(bundle_base64)
+        .map_err(|e| -> Box<dyn std::error::Error> {
+            Box::new(SignalBridgeError::Protocol(format!(
+                "Base64 decode error: {}",
+                e
+            )))
+        })?;
+
+    add_contact_and_establish_session(bridge, &bundle_bytes, user_alias)
+}
+
+/// Extracts RDX fingerprint from a prekey bundle without adding contact
+///
+/// # Arguments
+/// * `_bridge` - Signal bridge instance (unused)
+/// * `bundle_bytes` - Serialized prekey bundle
+///
+/// # Returns
+/// RDX fingerprint
+pub fn extract_rdx_from_bundle(
+    _bridge: &mut SignalBridge,
+    bundle_bytes: &[u8],
+) -> Result<String, Box<dyn std::error::Error>> {
+    use libsignal_protocol::IdentityKey;
+
+    let bundle: SerializablePreKeyBundle =
+        bincode::deserialize(bundle_bytes).map_err(|e| -> Box<dyn std::error::Error> {
+            Box::new(SignalBridgeError::InvalidInput(format!(
+                "Failed to deserialize bundle: {}",
+                e
+            )))
+        })?;
+
+    let identity_key =
+        IdentityKey::decode(&bundle.identity_key).map_err(|e| -> Box<dyn std::error::Error> {
+            Box::new(SignalBridgeError::Protocol(e.to_string()))
+        })?;
+
+    Ok(ContactManager::generate_identity_fingerprint_from_key(
+        &identity_key,
+    ))
+}
+
+/// Extracts RDX fingerprint from a base64-encoded prekey bundle
+///
+/// # Arguments
+/// * `bridge` - Signal bridge instance
+/// * `bundle_base64` - Base64-encoded prekey bundle
+///
+/// # Returns
+/// RDX fingerprint
+pub fn extract_rdx_from_bundle_base64(
+    bridge: &mut SignalBridge,
+    bundle_base64: &str,
+) -> Result<String, Box<dyn std::error::Error>> {
+    use base64::Engine;
+    let bundle_bytes = base64::engine::general_purpose::STANDARD
+        .decode(bundle_base64)
+        .map_err(|e| -> Box<dyn std::error::Error> {
+            Box::new(SignalBridgeError::Protocol(format!(
+                "Base64 decode error: {}",
+                e
+            )))
+        })?;
+
+    extract_rdx_from_bundle(bridge, &bundle_bytes)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::time::{SystemTime, UNIX_EPOCH};
+
+    #[test]
+    fn test_libsignal_basic_types() {
+        let device_id = DeviceId::new(1).expect("Valid device ID");
+        let protocol_address = ProtocolAddress::new("test_device".to_string(), device_id);
+        assert_eq!(protocol_address.name(), "test_device");
+        assert_eq!(protocol_address.device_id(), device_id);
+    }
+
+    #[tokio::test]
+    async fn test_nostr_key_derivation_deterministic() {
+        let temp_dir = std::env::temp_dir();
+        let db_path = temp_dir.join("test_nostr_derivation.db");
+        let mut bridge = SignalBridge::new(db_path.to_str().unwrap()).await.unwrap();
+
+        let nostr_keypair1 = bridge.derive_nostr_keypair().await.unwrap();
+        let nostr_keypair2 = bridge.derive_nostr_keypair().await.unwrap();
+
+        assert_eq!(nostr_keypair1.secret_key(), nostr_keypair2.secret_key());
+        assert_eq!(nostr_keypair1.public_key(), nostr_keypair2.public_key());
+
+        let _ = std::fs::remove_file(&db_path);
+    }
 
     #[tokio::test]
     async fn test_peer_nostr_key_derivation() {
@@ -2475,127 +4284,724 @@ mod tests {
             .await
             .expect("Failed to create bridge");
 
-        let result = bridge
-            .encrypt_message("unknown_peer", b"test message")
-            .await;
-        assert!(result.is_err());
-        if let Err(SignalBridgeError::SessionNotFound(msg)) = result {
-            assert_eq!(
-                msg,
-                "Establish a session with unknown_peer before sending messages"
-            );
-        } else {
-            panic!("Expected SessionNotFound error for unknown peer");
+        let result = bridge
+            .encrypt_message("unknown_peer", b"test message")
+            .await;
+        assert!(result.is_err());
+        if let Err(SignalBridgeError::SessionNotFound(msg)) = result {
+            assert_eq!(
+                msg,
+                "Establish a session with unknown_peer before sending messages"
+            );
+        } else {
+            panic!("Expected SessionNotFound error for unknown peer");
+        }
+    }
+
+    #[tokio::test]
+    async fn test_decrypt_message_malformed_ciphertext() {
+        use std::env;
+
+        let temp_dir = env::temp_dir();
+        let process_id = std::process::id();
+        let timestamp = std::time::SystemTime::now()
+            .duration_since(std::time::UNIX_EPOCH)
+            .unwrap()
+            .as_millis();
+
+        let db_path = temp_dir.join(format!(
+            "test_malformed_ciphertext_{}_{}.db",
+            process_id, timestamp
+        ));
+        let db_path_str = db_path.to_str().unwrap();
+        let mut bridge = SignalBridge::new(db_path_str)
+            .await
+            .expect("Failed to create bridge");
+
+        let malformed_data = vec![0x01, 0x02, 0x03, 0x04];
+        let result = bridge.decrypt_message("alice", &malformed_data).await;
+        assert!(result.is_err());
+        if let Err(SignalBridgeError::Serialization(msg)) = result {
+            assert_eq!(msg, "Provide a valid Signal Protocol message");
+        } else {
+            panic!("Expected Serialization error for malformed ciphertext");
+        }
+    }
+
+    #[tokio::test]
+    async fn test_establish_session_malformed_bundle() {
+        use std::env;
+
+        let temp_dir = env::temp_dir();
+        let process_id = std::process::id();
+        let timestamp = std::time::SystemTime::now()
+            .duration_since(std::time::UNIX_EPOCH)
+            .unwrap()
+            .as_millis();
+
+        let db_path = temp_dir.join(format!(
+            "test_malformed_bundle_{}_{}.db",
+            process_id, timestamp
+        ));
+        let db_path_str = db_path.to_str().unwrap();
+        let mut bridge = SignalBridge::new(db_path_str)
+            .await
+            .expect("Failed to create bridge");
+
+        let malformed_bundle = vec![0xFF, 0xFE, 0xFD, 0xFC];
+        let result = bridge.establish_session("alice", &malformed_bundle).await;
+        assert!(result.is_err());
+        if let Err(SignalBridgeError::Serialization(msg)) = result {
+            assert_eq!(msg, "io error: unexpected end of file");
+        } else {
+            panic!("Expected Serialization error for malformed bundle");
+        }
+    }
+
+    #[tokio::test]
+    async fn test_sign_nostr_event() -> Result<(), Box<dyn std::error::Error>> {
+        use std::env;
+
+        let temp_dir = env::temp_dir();
+        let process_id = std::process::id();
+        let timestamp = std::time::SystemTime::now()
+            .duration_since(std::time::UNIX_EPOCH)
+            .unwrap()
+            .as_millis();
+
+        let db_path = temp_dir.join(format!("test_sign_nostr_{}_{}.db", process_id, timestamp));
+        let db_path_str = db_path.to_str().unwrap();
+        let mut bridge = SignalBridge::new(db_path_str).await?;
+
+        let _event_json = r#"{
+            "id": "",
+            "pubkey": "",
+            "created_at": 1234567890,
+            "kind": 40001,
+            "tags": [
+                ["p", "recipient_pubkey"]
+            ],
+            "content": "encrypted_content_here",
+            "sig": ""
+        }"#;
+
+        let result = bridge
+            .sign_nostr_event(
+                1234567890,
+                40001,
+                vec![vec!["p".to_string(), "recipient_pubkey".to_string()]],
+                "encrypted_content_here",
+            )
+            .await;
+        assert!(result.is_ok());
+
+        let (pubkey, event_id, signature) = result.unwrap();
+        assert!(!pubkey.is_empty());
+        assert!(!event_id.is_empty());
+        assert!(!signature.is_empty());
+        assert_eq!(event_id.len(), 64); // SHA256 hex should be 64 chars
+        assert_eq!(pubkey.len(), 64); // Nostr pubkey hex should be 64 chars
+
+        let keys = bridge.derive_nostr_keypair().await?;
+        assert_eq!(pubkey, keys.public_key().to_hex());
+
+        Ok(())
+    }
+
+    #[tokio::test]
+    async fn test_sign_event_frame_is_wire_ready() -> Result<(), Box<dyn std::error::Error>> {
+        let temp_dir = std::env::temp_dir();
+        let timestamp = SystemTime::now()
+            .duration_since(UNIX_EPOCH)
+            .unwrap()
+            .as_millis();
+        let db_path = temp_dir.join(format!("test_sign_event_frame_{}.db", timestamp));
+        let mut bridge = SignalBridge::new(db_path.to_str().unwrap()).await?;
+
+        let (event_id, frame) = bridge
+            .sign_event_frame(
+                1234567890,
+                40001,
+                vec![vec!["p".to_string(), "recipient_pubkey".to_string()]],
+                "encrypted \"content\"\n",
+            )
+            .await?;
+
+        let parsed: serde_json::Value = serde_json::from_slice(&frame)?;
+        let message = parsed.as_array().expect("frame should be a JSON array");
+        assert_eq!(message.len(), 2);
+        assert_eq!(message[0], "EVENT");
+
+        let event = &message[1];
+        assert_eq!(event["id"], event_id);
+        assert_eq!(event["kind"], 40001);
+        assert_eq!(event["created_at"], 1234567890);
+        assert_eq!(event["content"], "encrypted \"content\"\n");
+        assert_eq!(event["tags"][0][0], "p");
+
+        let keys = bridge.derive_nostr_keypair().await?;
+        assert_eq!(event["pubkey"], keys.public_key().to_hex());
+
+        let signed: nostr::Event = serde_json::from_value(event.clone())?;
+        assert!(signed.verify().is_ok());
+
+        let _ = std::fs::remove_file(&db_path);
+        Ok(())
+    }
+
+    #[tokio::test]
+    async fn test_encrypted_message_frame_falls_back_to_hex_for_old_peers(
+    ) -> Result<(), Box<dyn std::error::Error>> {
+        let temp_dir = std::env::temp_dir();
+        let timestamp = SystemTime::now()
+            .duration_since(UNIX_EPOCH)
+            .unwrap()
+            .as_millis();
+
+        let alice_db_path = temp_dir.join(format!("test_hex_frame_alice_{}.db", timestamp));
+        let mut alice_bridge = SignalBridge::new(alice_db_path.to_str().unwrap()).await?;
+
+        let bob_db_path = temp_dir.join(format!("test_hex_frame_bob_{}.db", timestamp));
+        let mut bob_bridge = SignalBridge::new(bob_db_path.to_str().unwrap()).await?;
+
+        let (alice_bundle_bytes, _, _, _) = alice_bridge.generate_pre_key_bundle().await?;
+        let alice_rdx = bob_bridge
+            .add_contact_and_establish_session(&alice_bundle_bytes, Some("Alice"))
+            .await?;
+
+        let ciphertext = bob_bridge.encrypt_message(&alice_rdx, b"legacy").await?;
+        let (_, frame) = bob_bridge
+            .create_encrypted_message_frame("Alice", &ciphertext, 1234567890, "test-0.1.0")
+            .await?;
+
+        let parsed: serde_json::Value = serde_json::from_slice(&frame)?;
+        let event = &parsed[1];
+        assert_eq!(
+            event["tags"][1],
+            serde_json::json!(["radix_version", "test-0.1.0"])
+        );
+        assert_eq!(
+            event["tags"][2],
+            serde_json::json!([CONTENT_ENCODING_TAG, BASE64_CONTENT_ENCODING])
+        );
+        assert_eq!(
+            event["content"]
+                .as_str()
+                .expect("content should be a string"),
+            hex::encode(&ciphertext)
+        );
+
+        bob_bridge.record_peer_base64_content(&alice_rdx, true)?;
+        bob_bridge.record_peer_base64_content(&alice_rdx, false)?;
+        let frames = bob_bridge
+            .create_encrypted_message_frames(
+                &[alice_rdx.clone()],
+                b"still legacy",
+                1234567890,
+                "test-0.1.0",
+            )
+            .await?;
+        let parsed: serde_json::Value = serde_json::from_slice(&frames[0].bytes)?;
+        assert_eq!(
+            parsed[1]["tags"][1],
+            serde_json::json!(["radix_version", "test-0.1.0"])
+        );
+        assert!(hex::decode(parsed[1]["content"].as_str().unwrap()).is_ok());
+
+        let _ = std::fs::remove_file(&alice_db_path);
+        let _ = std::fs::remove_file(&bob_db_path);
+        Ok(())
+    }
+
+    #[tokio::test]
+    async fn test_encrypted_message_frame_uses_base64_content(
+    ) -> Result<(), Box<dyn std::error::Error>> {
+        let temp_dir = std::env::temp_dir();
+        let timestamp = SystemTime::now()
+            .duration_since(UNIX_EPOCH)
+            .unwrap()
+            .as_millis();
+
+        let alice_db_path = temp_dir.join(format!("test_base64_frame_alice_{}.db", timestamp));
+        let mut alice_bridge = SignalBridge::new(alice_db_path.to_str().unwrap()).await?;
+
+        let bob_db_path = temp_dir.join(format!("test_base64_frame_bob_{}.db", timestamp));
+        let mut bob_bridge = SignalBridge::new(bob_db_path.to_str().unwrap()).await?;
+
+        let (alice_bundle_bytes, _, _, _) = alice_bridge.generate_pre_key_bundle().await?;
+        let alice_rdx = bob_bridge
+            .add_contact_and_establish_session(&alice_bundle_bytes, Some("Alice"))
+            .await?;
+
+        bob_bridge.record_peer_base64_content(&alice_rdx, true)?;
+        let ciphertext = bob_bridge.encrypt_message(&alice_rdx, b"compact").await?;
+        let (_, frame) = bob_bridge
+            .create_encrypted_message_frame(&alice_rdx, &ciphertext, 1234567890, "test-0.1.0")
+            .await?;
+
+        let parsed: serde_json::Value = serde_json::from_slice(&frame)?;
+        let event = &parsed[1];
+        assert_eq!(
+            event["tags"][1],
+            serde_json::json!(["radix_version", "test-0.1.0", BASE64_CONTENT_ENCODING])
+        );
+
+        let content = event["content"]
+            .as_str()
+            .expect("content should be a string");
+        assert!(content.len() < ciphertext.len() * 2);
+        assert_eq!(
+            base64::engine::general_purpose::STANDARD.decode(content)?,
+            ciphertext
+        );
+
+        let _ = std::fs::remove_file(&alice_db_path);
+        let _ = std::fs::remove_file(&bob_db_path);
+        Ok(())
+    }
+
+    #[tokio::test]
+    async fn test_payload_compression_negotiated_per_peer() -> Result<(), Box<dyn std::error::Error>>
+    {
+        let temp_dir = std::env::temp_dir();
+        let timestamp = SystemTime::now()
+            .duration_since(UNIX_EPOCH)
+            .unwrap()
+            .as_millis();
+
+        let alice_db_path = temp_dir.join(format!("test_compression_alice_{}.db", timestamp));
+        let mut alice_bridge = SignalBridge::new(alice_db_path.to_str().unwrap()).await?;
+
+        let bob_db_path = temp_dir.join(format!("test_compression_bob_{}.db", timestamp));
+        let mut bob_bridge = SignalBridge::new(bob_db_path.to_str().unwrap()).await?;
+
+        let (alice_bundle_bytes, _, _, _) = alice_bridge.generate_pre_key_bundle().await?;
+        let alice_rdx = bob_bridge
+            .add_contact_and_establish_session(&alice_bundle_bytes, Some("Alice"))
+            .await?;
+
+        let message = b"Hi Alice, how are you? I'll be there in a few minutes. Let me know if you need anything else.";
+
+        bob_bridge.set_payload_compression(true);
+        let first = bob_bridge.encrypt_message(&alice_rdx, message).await?;
+        let (_, frame) = bob_bridge
+            .create_encrypted_message_frame(&alice_rdx, &first, 1234567890, "test-0.1.0")
+            .await?;
+        let parsed: serde_json::Value = serde_json::from_slice(&frame)?;
+        assert_eq!(
+            parsed[1]["tags"][2],
+            serde_json::json!([COMPRESSION_TAG, payload_compression::ZSTD_CAPABILITY])
+        );
+
+        let decrypted = alice_bridge.decrypt_message("", &first).await?;
+        assert_eq!(decrypted.plaintext, message);
+        let bob_rdx = bob_bridge.generate_node_fingerprint().await?;
+
+        alice_bridge.set_payload_compression(true);
+        let uncompressed = alice_bridge.encrypt_message(&bob_rdx, message).await?;
+        assert_eq!(
+            bob_bridge
+                .decrypt_message(&alice_rdx, &uncompressed)
+                .await?
+                .plaintext,
+            message
+        );
+
+        alice_bridge.record_peer_compression(&bob_rdx, true)?;
+        let compressed = alice_bridge.encrypt_message(&bob_rdx, message).await?;
+        assert!(compressed.len() < uncompressed.len());
+        assert_eq!(
+            bob_bridge
+                .decrypt_message(&alice_rdx, &compressed)
+                .await?
+                .plaintext,
+            message
+        );
+
+        let history = alice_bridge
+            .storage
+            .message_history()
+            .get_conversation_messages(&bob_rdx, 10, 0)?;
+        assert!(history
+            .iter()
+            .all(|stored| stored.content.as_bytes() == message));
+
+        drop(alice_bridge);
+        let mut alice_reopened = SignalBridge::new(alice_db_path.to_str().unwrap()).await?;
+        alice_reopened.set_payload_compression(true);
+        let after_restart = alice_reopened.encrypt_message(&bob_rdx, message).await?;
+        assert!(after_restart.len() < uncompressed.len());
+
+        let _ = std::fs::remove_file(&alice_db_path);
+        let _ = std::fs::remove_file(&bob_db_path);
+        Ok(())
+    }
+
+    #[tokio::test]
+    async fn test_undecodable_payload_frame_is_delivered_as_received(
+    ) -> Result<(), Box<dyn std::error::Error>> {
+        let temp_dir = std::env::temp_dir();
+        let timestamp = SystemTime::now()
+            .duration_since(UNIX_EPOCH)
+            .unwrap()
+            .as_millis();
+
+        let alice_db_path = temp_dir.join(format!("test_bad_frame_alice_{}.db", timestamp));
+        let mut alice_bridge = SignalBridge::new(alice_db_path.to_str().unwrap()).await?;
+
+        let bob_db_path = temp_dir.join(format!("test_bad_frame_bob_{}.db", timestamp));
+        let mut bob_bridge = SignalBridge::new(bob_db_path.to_str().unwrap()).await?;
+
+        let (alice_bundle_bytes, _, _, _) = alice_bridge.generate_pre_key_bundle().await?;
+        let alice_rdx = bob_bridge
+            .add_contact_and_establish_session(&alice_bundle_bytes, Some("Alice"))
+            .await?;
+        let address = ProtocolAddress::new(alice_rdx.clone(), DeviceId::new(1).unwrap());
+
+        let unknown_codec = [payload_compression::FRAME_MARKER, 0x7f, b'h', b'i'];
+        let ciphertext = bob_bridge
+            .storage
+            .encrypt_message(&address, &unknown_codec)
+            .await?;
+        let decrypted = alice_bridge
+            .decrypt_message("", &ciphertext.serialize())
+            .await?;
+        assert_eq!(decrypted.plaintext, unknown_codec);
+
+        let next = bob_bridge
+            .encrypt_message(&alice_rdx, b"still here")
+            .await?;
+        assert_eq!(
+            alice_bridge.decrypt_message("", &next).await?.plaintext,
+            b"still here"
+        );
+
+        let _ = std::fs::remove_file(&alice_db_path);
+        let _ = std::fs::remove_file(&bob_db_path);
+        Ok(())
+    }
+
+    #[tokio::test]
+    async fn test_group_message_reaches_all_members_with_one_event(
+    ) -> Result<(), Box<dyn std::error::Error>> {
+        let temp_dir = std::env::temp_dir();
+        let timestamp = SystemTime::now()
+            .duration_since(UNIX_EPOCH)
+            .unwrap()
+            .as_millis();
+
+        let alice_db_path = temp_dir.join(format!("test_group_alice_{}.db", timestamp));
+        let mut alice_bridge = SignalBridge::new(alice_db_path.to_str().unwrap()).await?;
+        let bob_db_path = temp_dir.join(format!("test_group_bob_{}.db", timestamp));
+        let mut bob_bridge = SignalBridge::new(bob_db_path.to_str().unwrap()).await?;
+        let carol_db_path = temp_dir.join(format!("test_group_carol_{}.db", timestamp));
+        let mut carol_bridge = SignalBridge::new(carol_db_path.to_str().unwrap()).await?;
+
+        let (bob_bundle, _, _, _) = bob_bridge.generate_pre_key_bundle().await?;
+        alice_bridge
+            .add_contact_and_establish_session(&bob_bundle, Some("bob"))
+            .await?;
+        let (carol_bundle, _, _, _) = carol_bridge.generate_pre_key_bundle().await?;
+        alice_bridge
+            .add_contact_and_establish_session(&carol_bundle, Some("carol"))
+            .await?;
+
+        let group_id = alice_bridge
+            .create_group("ops", &["bob".to_string(), "carol".to_string()])
+            .await?;
+
+        let distributions = alice_bridge
+            .create_sender_key_distribution_frames("ops", 1234567890, "test-0.1.0")
+            .await?;
+        assert_eq!(distributions.len(), 2);
+
+        let resent = alice_bridge
+            .create_sender_key_distribution_frames("ops", 1234567890, "test-0.1.0")
+            .await?;
+        assert_eq!(resent.len(), 2);
+        alice_bridge.mark_sender_key_delivered("ops", &distributions[0].recipient)?;
+        let remaining = alice_bridge
+            .create_sender_key_distribution_frames("ops", 1234567890, "test-0.1.0")
+            .await?;
+        assert_eq!(remaining.len(), 1);
+        assert_eq!(remaining[0].recipient, distributions[1].recipient);
+        alice_bridge.mark_sender_key_delivered(&group_id, &distributions[1].recipient)?;
+        assert!(alice_bridge
+            .create_sender_key_distribution_frames("ops", 1234567890, "test-0.1.0")
+            .await?
+            .is_empty());
+
+        let alice_pubkey = alice_bridge
+            .derive_nostr_keypair()
+            .await?
+            .public_key()
+            .to_hex();
+        let bob_pubkey = bob_bridge
+            .derive_nostr_keypair()
+            .await?
+            .public_key()
+            .to_hex();
+        for distribution in &distributions {
+            let parsed: serde_json::Value = serde_json::from_slice(&distribution.bytes)?;
+            assert_eq!(parsed[1]["kind"], SENDER_KEY_DISTRIBUTION_KIND);
+            let content = base64::engine::general_purpose::STANDARD
+                .decode(parsed[1]["content"].as_str().unwrap())?;
+            let recipient = if parsed[1]["tags"][0][1] == bob_pubkey.as_str() {
+                &mut bob_bridge
+            } else {
+                &mut carol_bridge
+            };
+            let membership = recipient
+                .process_sender_key_distribution(&alice_pubkey, &content)
+                .await?;
+            assert_eq!(membership.group_id, group_id);
+            assert_eq!(membership.name, "ops");
+        }
+
+        let (_, frame) = alice_bridge
+            .create_group_message_frame("ops", b"Status update", 1234567891, "test-0.1.0")
+            .await?;
+        let parsed: serde_json::Value = serde_json::from_slice(&frame)?;
+        assert_eq!(parsed[1]["kind"], GROUP_MESSAGE_KIND);
+        assert_eq!(
+            parsed[1]["tags"][0],
+            serde_json::json!([GROUP_TAG, group_id])
+        );
+        let content = base64::engine::general_purpose::STANDARD
+            .decode(parsed[1]["content"].as_str().unwrap())?;
+
+        for member in [&mut bob_bridge, &mut carol_bridge] {
+            let result = member
+                .decrypt_group_message(&alice_pubkey, &group_id, &content)
+                .await?;
+            assert_eq!(result.plaintext, b"Status update");
+            assert_eq!(result.name, "ops");
+
+            let subscription = member.message_subscription(0).await?;
+            assert_eq!(subscription.group_ids, vec![group_id.clone()]);
         }
+
+        let _ = std::fs::remove_file(&alice_db_path);
+        let _ = std::fs::remove_file(&bob_db_path);
+        let _ = std::fs::remove_file(&carol_db_path);
+        Ok(())
     }
 
     #[tokio::test]
-    async fn test_decrypt_message_malformed_ciphertext() {
-        use std::env;
-
-        let temp_dir = env::temp_dir();
-        let process_id = std::process::id();
-        let timestamp = std::time::SystemTime::now()
-            .duration_since(std::time::UNIX_EPOCH)
+    async fn test_non_member_cannot_distribute_a_key_for_a_known_group(
+    ) -> Result<(), Box<dyn std::error::Error>> {
+        let temp_dir = std::env::temp_dir();
+        let timestamp = SystemTime::now()
+            .duration_since(UNIX_EPOCH)
             .unwrap()
             .as_millis();
 
-        let db_path = temp_dir.join(format!(
-            "test_malformed_ciphertext_{}_{}.db",
-            process_id, timestamp
-        ));
-        let db_path_str = db_path.to_str().unwrap();
-        let mut bridge = SignalBridge::new(db_path_str)
+        let alice_db_path = temp_dir.join(format!("test_group_gate_alice_{}.db", timestamp));
+        let mut alice_bridge = SignalBridge::new(alice_db_path.to_str().unwrap()).await?;
+        let bob_db_path = temp_dir.join(format!("test_group_gate_bob_{}.db", timestamp));
+        let mut bob_bridge = SignalBridge::new(bob_db_path.to_str().unwrap()).await?;
+        let mallory_db_path = temp_dir.join(format!("test_group_gate_mallory_{}.db", timestamp));
+        let mut mallory_bridge = SignalBridge::new(mallory_db_path.to_str().unwrap()).await?;
+
+        let (bob_bundle, _, _, _) = bob_bridge.generate_pre_key_bundle().await?;
+        let bob_rdx = alice_bridge
+            .add_contact_and_establish_session(&bob_bundle, Some("bob"))
+            .await?;
+        let group_id = alice_bridge
+            .create_group("ops", &["bob".to_string()])
+            .await?;
+        let alice_pubkey = alice_bridge
+            .derive_nostr_keypair()
+            .await?
+            .public_key()
+            .to_hex();
+        let invitation = alice_bridge
+            .create_sender_key_distribution_frames("ops", 1234567890, "test-0.1.0")
+            .await?;
+        let parsed: serde_json::Value = serde_json::from_slice(&invitation[0].bytes)?;
+        let content = base64::engine::general_purpose::STANDARD
+            .decode(parsed[1]["content"].as_str().unwrap())?;
+        bob_bridge
+            .process_sender_key_distribution(&alice_pubkey, &content)
+            .await?;
+
+        // Group messages carry the distribution ID, so anyone can invite themselves to the group
+        let (bob_bundle, _, _, _) = bob_bridge.generate_pre_key_bundle().await?;
+        mallory_bridge
+            .add_contact_and_establish_session(&bob_bundle, Some("bob"))
+            .await?;
+        mallory_bridge.group_manager.join_group(
+            uuid::Uuid::parse_str(&group_id)?,
+            "ops",
+            &[bob_rdx.clone()],
+        )?;
+        let forged = mallory_bridge
+            .create_sender_key_distribution_frames(&group_id, 1234567891, "test-0.1.0")
+            .await?;
+        let parsed: serde_json::Value = serde_json::from_slice(&forged[0].bytes)?;
+        let content = base64::engine::general_purpose::STANDARD
+            .decode(parsed[1]["content"].as_str().unwrap())?;
+        let mallory_pubkey = mallory_bridge
+            .derive_nostr_keypair()
+            .await?
+            .public_key()
+            .to_hex();
+
+        assert!(bob_bridge
+            .process_sender_key_distribution(&mallory_pubkey, &content)
             .await
-            .expect("Failed to create bridge");
+            .is_err());
+        let alice_rdx = alice_bridge.generate_node_fingerprint().await?;
+        assert_eq!(
+            bob_bridge.group_manager.lookup_group(&group_id)?.members,
+            vec![alice_rdx]
+        );
 
-        let malformed_data = vec![0x01, 0x02, 0x03, 0x04];
-        let result = bridge.decrypt_message("alice", &malformed_data).await;
-        assert!(result.is_err());
-        if let Err(SignalBridgeError::Serialization(msg)) = result {
-            assert_eq!(msg, "Provide a valid Signal Protocol message");
-        } else {
-            panic!("Expected Serialization error for malformed ciphertext");
-        }
+        let _ = std::fs::remove_file(&alice_db_path);
+        let _ = std::fs::remove_file(&bob_db_path);
+        let _ = std::fs::remove_file(&mallory_db_path);
+        Ok(())
     }
 
     #[tokio::test]
-    async fn test_establish_session_malformed_bundle() {
-        use std::env;
-
-        let temp_dir = env::temp_dir();
-        let process_id = std::process::id();
-        let timestamp = std::time::SystemTime::now()
-            .duration_since(std::time::UNIX_EPOCH)
+    async fn test_fan_out_encrypts_for_each_peer_and_skips_unknown(
+    ) -> Result<(), Box<dyn std::error::Error>> {
+        let temp_dir = std::env::temp_dir();
+        let timestamp = SystemTime::now()
+            .duration_since(UNIX_EPOCH)
             .unwrap()
             .as_millis();
 
-        let db_path = temp_dir.join(format!(
-            "test_malformed_bundle_{}_{}.db",
-            process_id, timestamp
-        ));
-        let db_path_str = db_path.to_str().unwrap();
-        let mut bridge = SignalBridge::new(db_path_str)
-            .await
-            .expect("Failed to create bridge");
+        let alice_db_path = temp_dir.join(format!("test_fan_out_alice_{}.db", timestamp));
+        let mut alice_bridge = SignalBridge::new(alice_db_path.to_str().unwrap()).await?;
+        let bob_db_path = temp_dir.join(format!("test_fan_out_bob_{}.db", timestamp));
+        let mut bob_bridge = SignalBridge::new(bob_db_path.to_str().unwrap()).await?;
+        let carol_db_path = temp_dir.join(format!("test_fan_out_carol_{}.db", timestamp));
+        let mut carol_bridge = SignalBridge::new(carol_db_path.to_str().unwrap()).await?;
 
-        let malformed_bundle = vec![0xFF, 0xFE, 0xFD, 0xFC];
-        let result = bridge.establish_session("alice", &malformed_bundle).await;
-        assert!(result.is_err());
-        if let Err(SignalBridgeError::Serialization(msg)) = result {
-            assert_eq!(msg, "io error: unexpected end of file");
-        } else {
-            panic!("Expected Serialization error for malformed bundle");
+        let (bob_bundle, _, _, _) = bob_bridge.generate_pre_key_bundle().await?;
+        alice_bridge
+            .add_contact_and_establish_session(&bob_bundle, Some("bob"))
+            .await?;
+        let (carol_bundle, _, _, _) = carol_bridge.generate_pre_key_bundle().await?;
+        let carol_rdx = alice_bridge
+            .add_contact_and_establish_session(&carol_bundle, Some("carol"))
+            .await?;
+        alice_bridge.record_peer_base64_content(&carol_rdx, true)?;
+
+        let peers = vec![
+            "bob".to_string(),
+            "mallory".to_string(),
+            "carol".to_string(),
+        ];
+        let frames = alice_bridge
+            .create_encrypted_message_frames(&peers, b"Meet at noon", 1234567890, "test-0.1.0")
+            .await?;
+
+        assert_eq!(frames.len(), 3);
+        assert!(frames[0].bytes.len() > frames[2].bytes.len());
+        assert!(frames[1].bytes.is_empty());
+        assert!(!frames[1].error.is_empty());
+
+        let alice_pubkey = alice_bridge
+            .derive_nostr_keypair()
+            .await?
+            .public_key()
+            .to_hex();
+        for (frame, member) in [
+            (&frames[0], &mut bob_bridge),
+            (&frames[2], &mut carol_bridge),
+        ] {
+            assert!(frame.error.is_empty());
+            let parsed: serde_json::Value = serde_json::from_slice(&frame.bytes)?;
+            assert_eq!(parsed[1]["id"], frame.event_id.as_str());
+            assert_eq!(parsed[1]["pubkey"], alice_pubkey.as_str());
+            let content = parsed[1]["content"].as_str().unwrap();
+            let ciphertext = if parsed[1]["tags"][1][2] == BASE64_CONTENT_ENCODING {
+                base64::engine::general_purpose::STANDARD.decode(content)?
+            } else {
+                hex::decode(content)?
+            };
+            let result = member.decrypt_message(&alice_pubkey, &ciphertext).await?;
+            assert_eq!(result.plaintext, b"Meet at noon");
         }
+
+        let _ = std::fs::remove_file(&alice_db_path);
+        let _ = std::fs::remove_file(&bob_db_path);
+        let _ = std::fs::remove_file(&carol_db_path);
+        Ok(())
     }
 
     #[tokio::test]
-    async fn test_sign_nostr_event() -> Result<(), Box<dyn std::error::Error>> {
-        use std::env;
-
-        let temp_dir = env::temp_dir();
-        let process_id = std::process::id();
-        let timestamp = std::time::SystemTime::now()
-            .duration_since(std::time::UNIX_EPOCH)
+    async fn test_file_transfer_chunks_reassemble_at_recipient(
+    ) -> Result<(), Box<dyn std::error::Error>> {
+        let timestamp = SystemTime::now()
+            .duration_since(UNIX_EPOCH)
             .unwrap()
             .as_millis();
+        let test_dir = std::env::temp_dir().join(format!("test_file_transfer_{}", timestamp));
+        std::fs::create_dir_all(test_dir.join("alice"))?;
+        std::fs::create_dir_all(test_dir.join("bob"))?;
 
-        let db_path = temp_dir.join(format!("test_sign_nostr_{}_{}.db", process_id, timestamp));
-        let db_path_str = db_path.to_str().unwrap();
-        let mut bridge = SignalBridge::new(db_path_str).await?;
+        let alice_db_path = test_dir.join("alice").join("radix.db");
+        let mut alice_bridge = SignalBridge::new(alice_db_path.to_str().unwrap()).await?;
+        let bob_db_path = test_dir.join("bob").join("radix.db");
+        let mut bob_bridge = SignalBridge::new(bob_db_path.to_str().unwrap()).await?;
 
-        let _event_json = r#"{
-            "id": "",
-            "pubkey": "",
-            "created_at": 1234567890,
-            "kind": 40001,
-            "tags": [
-                ["p", "recipient_pubkey"]
-            ],
-            "content": "encrypted_content_here",
-            "sig": ""
-        }"#;
+        let (bob_bundle, _, _, _) = bob_bridge.generate_pre_key_bundle().await?;
+        alice_bridge
+            .add_contact_and_establish_session(&bob_bundle, Some("bob"))
+            .await?;
 
-        let result = bridge
-            .sign_nostr_event(
-                1234567890,
-                40001,
-                vec![vec!["p".to_string(), "recipient_pubkey".to_string()]],
-                "encrypted_content_here",
-            )
-            .await;
-        assert!(result.is_ok());
+        let contents: Vec<u8> = (0..file_transfer::CHUNK_SIZE as usize + 500)
+            .map(|i| (i % 253) as u8)
+            .collect();
+        let source_path = test_dir.join("notes.bin");
+        std::fs::write(&source_path, &contents)?;
 
-        let (pubkey, event_id, signature) = result.unwrap();
-        assert!(!pubkey.is_empty());
-        assert!(!event_id.is_empty());
-        assert!(!signature.is_empty());
-        assert_eq!(event_id.len(), 64); // SHA256 hex should be 64 chars
-        assert_eq!(pubkey.len(), 64); // Nostr pubkey hex should be 64 chars
+        let transfer = alice_bridge
+            .start_file_transfer("bob", source_path.to_str().unwrap())
+            .await?;
+        assert_eq!(transfer.pending_chunks, vec![0, 1]);
 
-        let keys = bridge.derive_nostr_keypair().await?;
-        assert_eq!(pubkey, keys.public_key().to_hex());
+        let alice_pubkey = alice_bridge
+            .derive_nostr_keypair()
+            .await?
+            .public_key()
+            .to_hex();
+        let mut progress = None;
+        for index in transfer.pending_chunks.iter().rev() {
+            let (event_id, frame) = alice_bridge
+                .create_transfer_chunk_frame(
+                    &transfer.transfer_id,
+                    *index,
+                    1234567890,
+                    "test-0.1.0",
+                )
+                .await?;
+            let parsed: serde_json::Value = serde_json::from_slice(&frame)?;
+            assert_eq!(parsed[1]["id"], event_id.as_str());
+            assert_eq!(parsed[1]["kind"], FILE_CHUNK_KIND);
+            let content = base64::engine::general_purpose::STANDARD
+                .decode(parsed[1]["content"].as_str().unwrap())?;
+            progress = Some(
+                bob_bridge
+                    .process_transfer_chunk(&alice_pubkey, &content)
+                    .await?,
+            );
+            alice_bridge.mark_transfer_chunk_delivered(&transfer.transfer_id, *index)?;
+        }
+
+        let progress = progress.unwrap();
+        assert!(progress.complete);
+        assert_eq!(progress.name, "notes.bin");
+        assert_eq!(std::fs::read(&progress.path)?, contents);
+        assert!(progress
+            .path
+            .starts_with(test_dir.join("bob").join("downloads").to_str().unwrap()));
+        assert!(alice_bridge.pending_file_transfers()?.is_empty());
 
+        let _ = std::fs::remove_dir_all(&test_dir);
         Ok(())
     }
 
@@ -2923,6 +5329,138 @@ mod tests {
         let _ = std::fs::remove_file(&db_path);
     }
 
+    #[tokio::test]
+    async fn test_bundle_announcement_cached_until_keys_change(
+    ) -> Result<(), Box<dyn std::error::Error>> {
+        use crate::key_factory::InlineKeySource;
+        use crate::key_rotation::rotate_signed_pre_key;
+
+        let temp_dir = std::env::temp_dir();
+        let timestamp = SystemTime::now()
+            .duration_since(UNIX_EPOCH)
+            .unwrap()
+            .as_millis();
+        let db_path = temp_dir.join(format!("test_announcement_cache_{}.db", timestamp));
+        let mut bridge = SignalBridge::new(db_path.to_str().unwrap()).await?;
+
+        let first = bridge
+            .generate_prekey_bundle_announcement("1.0.0-test")
+            .await?;
+        let repeated = bridge
+            .generate_prekey_bundle_announcement("1.0.0-test")
+            .await?;
+        assert_eq!(first.announcement_json, repeated.announcement_json);
+
+        let identity_key_pair = bridge
+            .storage
+            .identity_store()
+            .get_identity_key_pair()
+            .await?;
+        rotate_signed_pre_key(&mut bridge.storage, &identity_key_pair, &InlineKeySource).await?;
+
+        let rotated = bridge
+            .generate_prekey_bundle_announcement("1.0.0-test")
+            .await?;
+        assert_ne!(first.announcement_json, rotated.announcement_json);
+        assert_eq!(rotated.signed_pre_key_id, first.signed_pre_key_id + 1);
+
+        let rotated_again = bridge
+            .generate_prekey_bundle_announcement("1.0.0-test")
+            .await?;
+        assert_eq!(rotated.announcement_json, rotated_again.announcement_json);
+
+        let _ = std::fs::remove_file(&db_path);
+        Ok(())
+    }
+
+    #[tokio::test]
+    async fn test_bundle_announcement_cache_invalidation() -> Result<(), Box<dyn std::error::Error>>
+    {
+        let temp_dir = std::env::temp_dir();
+        let timestamp = SystemTime::now()
+            .duration_since(UNIX_EPOCH)
+            .unwrap()
+            .as_millis();
+        let db_path = temp_dir.join(format!("test_announcement_invalidation_{}.db", timestamp));
+        let mut bridge = SignalBridge::new(db_path.to_str().unwrap()).await?;
+
+        let info = bridge
+            .generate_prekey_bundle_announcement("1.0.0-test")
+            .await?;
+        bridge.record_published_bundle(
+            info.pre_key_id,
+            info.signed_pre_key_id,
+            info.kyber_pre_key_id,
+        )?;
+        assert!(bridge.cached_bundle_announcement.is_some());
+
+        bridge.record_published_bundle(
+            info.pre_key_id - 1,
+            info.signed_pre_key_id,
+            info.kyber_pre_key_id,
+        )?;
+        assert!(bridge.cached_bundle_announcement.is_none());
+
+        bridge
+            .generate_prekey_bundle_announcement("1.0.0-test")
+            .await?;
+        let other_version = bridge
+            .generate_prekey_bundle_announcement("2.0.0-test")
+            .await?;
+        let event: serde_json::Value = serde_json::from_str(&other_version.announcement_json)?;
+        let version_tag = event["tags"]
+            .as_array()
+            .unwrap()
+            .iter()
+            .find(|t| t[0] == "radix_version")
+            .expect("Version tag should be present");
+        assert_eq!(version_tag[1], "2.0.0-test");
+
+        bridge.reset_identity().await?;
+        assert!(bridge.cached_bundle_announcement.is_none());
+
+        let _ = std::fs::remove_file(&db_path);
+        Ok(())
+    }
+
+    #[tokio::test]
+    async fn test_publish_after_unpublish_signs_a_newer_announcement(
+    ) -> Result<(), Box<dyn std::error::Error>> {
+        let temp_dir = std::env::temp_dir();
+        let timestamp = SystemTime::now()
+            .duration_since(UNIX_EPOCH)
+            .unwrap()
+            .as_millis();
+        let db_path = temp_dir.join(format!("test_unpublish_republish_{}.db", timestamp));
+        let mut bridge = SignalBridge::new(db_path.to_str().unwrap()).await?;
+
+        let published = bridge
+            .generate_prekey_bundle_announcement("1.0.0-test")
+            .await?;
+        bridge.record_published_bundle(
+            published.pre_key_id,
+            published.signed_pre_key_id,
+            published.kyber_pre_key_id,
+        )?;
+
+        let (_, empty_frame) = bridge.generate_empty_bundle_frame("1.0.0-test").await?;
+        assert!(bridge.cached_bundle_announcement.is_none());
+
+        let republished = bridge
+            .generate_prekey_bundle_announcement("1.0.0-test")
+            .await?;
+        assert_ne!(republished.event_id, published.event_id);
+
+        let empty: serde_json::Value = serde_json::from_slice(&empty_frame)?;
+        let announcement: serde_json::Value = serde_json::from_str(&republished.announcement_json)?;
+        assert!(
+            announcement["created_at"].as_u64().unwrap() > empty[1]["created_at"].as_u64().unwrap()
+        );
+
+        let _ = std::fs::remove_file(&db_path);
+        Ok(())
+    }
+
     #[tokio::test]
     async fn test_add_contact_and_establish_session() {
         let temp_dir = std::env::temp_dir();
@@ -3376,6 +5914,7 @@ mod tests {
 
     #[tokio::test]
     async fn test_bundle_uses_latest_available_keys() -> Result<(), Box<dyn std::error::Error>> {
+        use crate::key_factory::InlineKeySource;
         use crate::key_rotation::{rotate_kyber_pre_key, rotate_signed_pre_key};
         use crate::SignalBridge;
 
@@ -3403,8 +5942,8 @@ mod tests {
             .identity_store()
             .get_identity_key_pair()
             .await?;
-        rotate_signed_pre_key(&mut bridge.storage, &identity_key_pair).await?;
-        rotate_kyber_pre_key(&mut bridge.storage, &identity_key_pair).await?;
+        rotate_signed_pre_key(&mut bridge.storage, &identity_key_pair, &InlineKeySource).await?;
+        rotate_kyber_pre_key(&mut bridge.storage, &identity_key_pair, &InlineKeySource).await?;
 
         // Generate new bundle after rotation
         let (rotated_bundle_bytes, _, _, _) = bridge.generate_pre_key_bundle().await?;
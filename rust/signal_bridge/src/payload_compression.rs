@@ -0,0 +1,213 @@
+//! Optional compression of message plaintext ahead of Signal encryption
+//!
+//! Compression runs above the encryption call, so the compressed frame is what the Signal
+//! session encrypts and nothing about it is visible outside the ciphertext. A framed plaintext
+//! starts with [`FRAME_MARKER`] followed by a codec byte; anything else is a legacy plaintext
+//! and is passed through untouched, so uncompressed messages cost no extra bytes.
+//!
+//! Security trade-offs:
+//! * Compression makes ciphertext length depend on plaintext content. An observer who can
+//!   inject chosen text into a message and watch its size (the CRIME/BREACH pattern) can learn
+//!   about the rest of it. Chat messages rarely mix attacker-controlled and secret text, but
+//!   this is why the feature is opt-in and only used with peers that advertise support.
+//! * The shared dictionary is public and fixed. It only shifts which texts compress well; it
+//!   carries no secrets and adds no keying material.
+//! * Decompression is bounded by [`MAX_DECOMPRESSED_SIZE`] so a peer cannot exhaust memory
+//!   with a small, highly compressible frame.
+
+use crate::SignalBridgeError;
+
+/// First plaintext byte of a framed payload
+///
+/// Chat text never begins with a NUL byte, so unframed plaintext from older peers is never
+/// mistaken for a frame.
+pub const FRAME_MARKER: u8 = 0x00;
+
+/// Codec byte for a frame carrying the plaintext as-is
+pub const CODEC_STORED: u8 = 0x00;
+
+/// Codec byte for a zstd frame compressed against [`CHAT_DICTIONARY_V1`]
+pub const CODEC_ZSTD_CHAT_V1: u8 = 0x01;
+
+/// Name advertised in the `radix_compression` tag by peers that accept zstd frames
+pub const ZSTD_CAPABILITY: &str = "zstd";
+
+/// Plaintexts shorter than this are sent uncompressed
+///
+/// Below this size the zstd frame header eats most of the savings.
+pub const MIN_COMPRESSION_SIZE: usize = 64;
+
+/// Largest plaintext a compressed frame may expand to
+pub const MAX_DECOMPRESSED_SIZE: usize = 1024 * 1024;
+
+const FRAME_HEADER_SIZE: usize = 2;
+const COMPRESSION_LEVEL: i32 = 9;
+
+/// Raw-content zstd dictionary of common chat text
+///
+/// zstd treats a dictionary without its magic number as raw content and primes the match
+/// window with it, so short messages can reference these phrases instead of spelling them
+/// out. Later bytes are cheaper to reference, so the most common fragments sit at the end.
+/// Changing these bytes breaks decoding of existing frames; add a new codec byte instead.
+pub const CHAT_DICTIONARY_V1: &[u8] = b"\
+https://www. .com/ .org/ http:// \
+Sounds good. No problem. Thank you! Thanks! Talk to you later. See you soon. \
+Let me know if you need anything else. I don't know. I'm not sure. What do you think? \
+Can you send me the address? I'll be there in a few minutes. On my way. \
+Where are you? When are you coming back? Are you still there? Is everyone okay? \
+Please call me when you get this message. I'll call you back. \
+Good morning, good afternoon, good evening, good night. \
+tomorrow today tonight yesterday this morning this afternoon this evening \
+meeting point location battery signal network relay connection message \
+the and that have for not with you this but his from they we say her she \
+or an will my one all would there their what so up out if about who get \
+which go me when make can like time no just him know take people into year \
+your good some could them see other than then now look only come its over \
+think also back after use two how our work first well way even new want \
+because any these give day most us is are was were been being has had do \
+does did I'm I'll I've it's that's don't can't won't didn't isn't \
+Hello! Hi, how are you? I'm fine, thanks. Yes. No. OK. Okay. ";
+
+/// Frames a plaintext for encryption, compressing it when that makes it smaller
+///
+/// Plaintexts under [`MIN_COMPRESSION_SIZE`] or that don't shrink are returned unframed,
+/// except when they begin with [`FRAME_MARKER`] and need a stored frame to stay unambiguous.
+///
+/// # Arguments
+/// * `plaintext` - Message bytes about to be encrypted
+pub fn encode_frame(plaintext: &[u8]) -> Result<Vec<u8>, SignalBridgeError> {
+    if plaintext.len() >= MIN_COMPRESSION_SIZE {
+        let mut compressor =
+            zstd::bulk::Compressor::with_dictionary(COMPRESSION_LEVEL, CHAT_DICTIONARY_V1)
+                .map_err(|e| SignalBridgeError::Serialization(e.to_string()))?;
+        let compressed = compressor
+            .compress(plaintext)
+            .map_err(|e| SignalBridgeError::Serialization(e.to_string()))?;
+        if compressed.len() + FRAME_HEADER_SIZE < plaintext.len() {
+            return Ok(frame(CODEC_ZSTD_CHAT_V1, &compressed));
+        }
+    }
+
+    if plaintext.first() == Some(&FRAME_MARKER) {
+        return Ok(frame(CODEC_STORED, plaintext));
+    }
+    Ok(plaintext.to_vec())
+}
+
+/// Recovers the original plaintext from a decrypted payload
+///
+/// Payloads that don't start with [`FRAME_MARKER`] are legacy plaintext and are returned
+/// as-is.
+///
+/// # Arguments
+/// * `payload` - Decrypted bytes
+///
+/// # Returns
+/// Original plaintext, or an error for an unknown codec or a frame that fails to decompress
+/// within [`MAX_DECOMPRESSED_SIZE`]
+pub fn decode_frame(payload: &[u8]) -> Result<Vec<u8>, SignalBridgeError> {
+    let (codec, body) = match payload {
+        [FRAME_MARKER, codec, body @ ..] => (*codec, body),
+        [FRAME_MARKER] => {
+            return Err(SignalBridgeError::Serialization(
+                "Plaintext frame is missing its codec".to_string(),
+            ))
+        }
+        _ => return Ok(payload.to_vec()),
+    };
+
+    match codec {
+        CODEC_STORED => Ok(body.to_vec()),
+        CODEC_ZSTD_CHAT_V1 => {
+            let mut decompressor = zstd::bulk::Decompressor::with_dictionary(CHAT_DICTIONARY_V1)
+                .map_err(|e| SignalBridgeError::Serialization(e.to_string()))?;
+            decompressor
+                .decompress(body, MAX_DECOMPRESSED_SIZE)
+                .map_err(|e| SignalBridgeError::Serialization(e.to_string()))
+        }
+        unknown => Err(SignalBridgeError::Serialization(format!(
+            "Unknown plaintext codec {}",
+            unknown
+        ))),
+    }
+}
+
+fn frame(codec: u8, body: &[u8]) -> Vec<u8> {
+    let mut framed = Vec::with_capacity(FRAME_HEADER_SIZE + body.len());
+    framed.push(FRAME_MARKER);
+    framed.push(codec);
+    framed.extend_from_slice(body);
+    framed
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_short_plaintext_is_left_unframed() {
+        let plaintext = b"On my way.";
+        assert_eq!(encode_frame(plaintext).unwrap(), plaintext);
+    }
+
+    #[test]
+    fn test_chat_text_compresses_and_round_trips() {
+        let plaintext = b"Hi, how are you? I'll be there in a few minutes. Let me know if you need anything else. Thanks!";
+
+        let framed = encode_frame(plaintext).unwrap();
+
+        assert_eq!(framed[0], FRAME_MARKER);
+        assert_eq!(framed[1], CODEC_ZSTD_CHAT_V1);
+        assert!(framed.len() < plaintext.len());
+        assert_eq!(decode_frame(&framed).unwrap(), plaintext);
+    }
+
+    #[test]
+    fn test_incompressible_plaintext_is_left_unframed() {
+        let mut state = 0x9E37_79B9_7F4A_7C15u64;
+        let plaintext: Vec<u8> = (0..256)
+            .map(|_| {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                (state >> 56) as u8 | 0x01
+            })
+            .collect();
+
+        assert_eq!(encode_frame(&plaintext).unwrap(), plaintext);
+    }
+
+    #[test]
+    fn test_plaintext_starting_with_marker_is_escaped() {
+        let plaintext = [FRAME_MARKER, b'x'];
+
+        let framed = encode_frame(&plaintext).unwrap();
+
+        assert_eq!(framed, [FRAME_MARKER, CODEC_STORED, FRAME_MARKER, b'x']);
+        assert_eq!(decode_frame(&framed).unwrap(), plaintext);
+    }
+
+    #[test]
+    fn test_legacy_plaintext_passes_through() {
+        assert_eq!(decode_frame(b"Hello Bob!").unwrap(), b"Hello Bob!");
+        assert_eq!(decode_frame(b"").unwrap(), b"");
+    }
+
+    #[test]
+    fn test_malformed_frames_are_rejected() {
+        assert!(decode_frame(&[FRAME_MARKER]).is_err());
+        assert!(decode_frame(&[FRAME_MARKER, 0x7f, 1, 2, 3]).is_err());
+        assert!(decode_frame(&[FRAME_MARKER, CODEC_ZSTD_CHAT_V1, 1, 2, 3]).is_err());
+    }
+
+    #[test]
+    fn test_decompression_is_bounded() {
+        let bomb = vec![b'a'; MAX_DECOMPRESSED_SIZE + 1];
+        let mut compressor =
+            zstd::bulk::Compressor::with_dictionary(COMPRESSION_LEVEL, CHAT_DICTIONARY_V1).unwrap();
+        let framed = frame(CODEC_ZSTD_CHAT_V1, &compressor.compress(&bomb).unwrap());
+
+        assert!(framed.len() < 1024);
+        assert!(decode_frame(&framed).is_err());
+    }
+}
@@ -9,11 +9,12 @@ use libsignal_protocol::{
     message_decrypt, message_encrypt, process_prekey_bundle, CiphertextMessage, Direction,
     GenericSignedPreKey, IdentityChange, IdentityKey, IdentityKeyPair, IdentityKeyStore,
     KyberPreKeyId, KyberPreKeyRecord, KyberPreKeyStore, PreKeyBundle, PreKeyId, PreKeyRecord,
-    PreKeyStore, ProtocolAddress, SessionRecord, SessionStore, SignalProtocolError, SignedPreKeyId,
-    SignedPreKeyRecord, SignedPreKeyStore, UsePQRatchet,
+    PreKeyStore, ProtocolAddress, SenderKeyRecord, SenderKeyStore, SessionRecord, SessionStore,
+    SignalProtocolError, SignedPreKeyId, SignedPreKeyRecord, SignedPreKeyStore, UsePQRatchet,
 };
 use rusqlite::Connection;
 use std::sync::{Arc, Mutex};
+use uuid::Uuid;
 
 /// Bundle metadata tuple: (pre_key_id, signed_pre_key_id, kyber_pre_key_id)
 type BundleMetadata = (u32, u32, u32);
@@ -26,6 +27,7 @@ pub struct SqliteStorage {
     pre_key_store: Option<SqlitePreKeyStore>,
     signed_pre_key_store: Option<SqliteSignedPreKeyStore>,
     kyber_pre_key_store: Option<SqliteKyberPreKeyStore>,
+    sender_key_store: Option<SqliteSenderKeyStore>,
     message_history: Option<crate::message_history::MessageHistory>,
     is_closed: bool,
 }
@@ -48,6 +50,7 @@ impl SqliteStorage {
             pre_key_store: None,
             signed_pre_key_store: None,
             kyber_pre_key_store: None,
+            sender_key_store: None,
             message_history: None,
             is_closed: false,
         })
@@ -79,6 +82,10 @@ impl SqliteStorage {
             SqlitePreKeyStore::create_tables(&conn)?;
             SqliteSignedPreKeyStore::create_tables(&conn)?;
             SqliteKyberPreKeyStore::create_tables(&conn)?;
+            SqliteSenderKeyStore::create_tables(&conn)?;
+            crate::group_manager::GroupManager::create_tables(&conn)?;
+            crate::file_transfer::FileTransferManager::create_tables(&conn)?;
+            crate::bundle_cache::BundleCache::create_tables(&conn)?;
 
             conn.execute(
                 "CREATE TABLE IF NOT EXISTS contacts (
@@ -127,6 +134,12 @@ impl SqliteStorage {
             if current_version < 2 {
                 Self::migrate_to_v2(&conn)?;
             }
+            if current_version < 3 {
+                Self::migrate_to_v3(&conn)?;
+            }
+            if current_version < 4 {
+                Self::migrate_to_v4(&conn)?;
+            }
         }
 
         self.session_store = Some(SqliteSessionStore::new(self.connection.clone()));
@@ -134,6 +147,7 @@ impl SqliteStorage {
         self.pre_key_store = Some(SqlitePreKeyStore::new(self.connection.clone()));
         self.signed_pre_key_store = Some(SqliteSignedPreKeyStore::new(self.connection.clone()));
         self.kyber_pre_key_store = Some(SqliteKyberPreKeyStore::new(self.connection.clone()));
+        self.sender_key_store = Some(SqliteSenderKeyStore::new(self.connection.clone()));
         self.message_history = Some(crate::message_history::MessageHistory::new(
             self.connection.clone(),
         ));
@@ -209,6 +223,34 @@ impl SqliteStorage {
         Ok(())
     }
 
+    fn migrate_to_v3(conn: &Connection) -> Result<(), Box<dyn std::error::Error>> {
+        conn.execute(
+            "ALTER TABLE contacts ADD COLUMN accepts_base64_content BOOLEAN NOT NULL DEFAULT 0",
+            [],
+        )?;
+
+        conn.execute(
+            "UPDATE schema_info SET version = 3, updated_at = strftime('%s', 'now')",
+            [],
+        )?;
+
+        Ok(())
+    }
+
+    fn migrate_to_v4(conn: &Connection) -> Result<(), Box<dyn std::error::Error>> {
+        conn.execute(
+            "ALTER TABLE contacts ADD COLUMN accepts_zstd BOOLEAN NOT NULL DEFAULT 0",
+            [],
+        )?;
+
+        conn.execute(
+            "UPDATE schema_info SET version = 4, updated_at = strftime('%s', 'now')",
+            [],
+        )?;
+
+        Ok(())
+    }
+
     pub fn get_schema_version(&self) -> Result<i32, Box<dyn std::error::Error>> {
         let conn = self.connection.lock().unwrap();
         let mut stmt = conn.prepare("SELECT version FROM schema_info")?;
@@ -216,10 +258,46 @@ impl SqliteStorage {
         Ok(version)
     }
 
+    /// Sender key store backing group messaging
+    ///
+    /// Kept outside [`SignalStorageContainer`] because only the SQLite backend persists groups.
+    pub fn sender_key_store(&mut self) -> &mut SqliteSenderKeyStore {
+        if self.is_closed {
+            panic!("Storage has been closed");
+        }
+        self.sender_key_store
+            .as_mut()
+            .expect("Storage not initialized")
+    }
+
     pub fn connection(&self) -> Arc<Mutex<Connection>> {
         self.connection.clone()
     }
 
+    /// Opens a write transaction spanning every store that shares this connection
+    ///
+    /// Used to batch many ratchet updates and history rows into one commit. Stores must not
+    /// open their own transactions until [`Self::commit_batch`] or [`Self::rollback_batch`].
+    pub fn begin_batch(&self) -> Result<(), crate::SignalBridgeError> {
+        let conn = self.connection.lock().unwrap();
+        conn.execute_batch("BEGIN IMMEDIATE")?;
+        Ok(())
+    }
+
+    /// Commits the transaction opened by [`Self::begin_batch`]
+    pub fn commit_batch(&self) -> Result<(), crate::SignalBridgeError> {
+        let conn = self.connection.lock().unwrap();
+        conn.execute_batch("COMMIT")?;
+        Ok(())
+    }
+
+    /// Discards the transaction opened by [`Self::begin_batch`]
+    pub fn rollback_batch(&self) -> Result<(), crate::SignalBridgeError> {
+        let conn = self.connection.lock().unwrap();
+        conn.execute_batch("ROLLBACK")?;
+        Ok(())
+    }
+
     pub fn message_history(&self) -> &crate::message_history::MessageHistory {
         self.message_history
             .as_ref()
@@ -359,6 +437,7 @@ impl SignalStorageContainer for SqliteStorage {
         self.pre_key_store = None;
         self.signed_pre_key_store = None;
         self.kyber_pre_key_store = None;
+        self.sender_key_store = None;
 
         Ok(())
     }
@@ -1267,6 +1346,89 @@ impl ExtendedKyberPreKeyStore for SqliteKyberPreKeyStore {
     }
 }
 
+/// SQLite-backed sender key storage for group messaging
+pub struct SqliteSenderKeyStore {
+    connection: Arc<Mutex<Connection>>,
+}
+
+impl SqliteSenderKeyStore {
+    pub fn new(connection: Arc<Mutex<Connection>>) -> Self {
+        Self { connection }
+    }
+
+    pub fn create_tables(conn: &Connection) -> Result<(), Box<dyn std::error::Error>> {
+        conn.execute(
+            "CREATE TABLE IF NOT EXISTS sender_keys (
+                address TEXT NOT NULL,
+                device_id INTEGER NOT NULL DEFAULT 1,
+                distribution_id TEXT NOT NULL,
+                record BLOB NOT NULL,
+                updated_at INTEGER DEFAULT (strftime('%s', 'now')),
+                PRIMARY KEY (address, device_id, distribution_id)
+            )",
+            [],
+        )?;
+        Ok(())
+    }
+}
+
+#[async_trait(?Send)]
+impl SenderKeyStore for SqliteSenderKeyStore {
+    async fn store_sender_key(
+        &mut self,
+        sender: &ProtocolAddress,
+        distribution_id: Uuid,
+        record: &SenderKeyRecord,
+    ) -> Result<(), SignalProtocolError> {
+        let serialized = record.serialize()?;
+        let conn = self.connection.lock().unwrap();
+        conn.execute(
+            "INSERT OR REPLACE INTO sender_keys (address, device_id, distribution_id, record, updated_at)
+             VALUES (?, ?, ?, ?, strftime('%s', 'now'))",
+            rusqlite::params![
+                sender.name(),
+                u32::from(sender.device_id()),
+                distribution_id.to_string(),
+                &serialized
+            ],
+        )
+        .map_err(|e| {
+            SignalProtocolError::InvalidState(
+                "storage",
+                format!("Failed to store sender key: {}", e),
+            )
+        })?;
+        Ok(())
+    }
+
+    async fn load_sender_key(
+        &mut self,
+        sender: &ProtocolAddress,
+        distribution_id: Uuid,
+    ) -> Result<Option<SenderKeyRecord>, SignalProtocolError> {
+        let conn = self.connection.lock().unwrap();
+        let result = conn.query_row(
+            "SELECT record FROM sender_keys
+             WHERE address = ? AND device_id = ? AND distribution_id = ?",
+            rusqlite::params![
+                sender.name(),
+                u32::from(sender.device_id()),
+                distribution_id.to_string()
+            ],
+            |row| row.get::<_, Vec<u8>>(0),
+        );
+
+        match result {
+            Ok(data) => Ok(Some(SenderKeyRecord::deserialize(&data)?)),
+            Err(rusqlite::Error::QueryReturnedNoRows) => Ok(None),
+            Err(e) => Err(SignalProtocolError::InvalidState(
+                "storage",
+                format!("Database error: {}", e),
+            )),
+        }
+    }
+}
+
 #[async_trait(?Send)]
 impl ExtendedStorageOps for SqliteStorage {
     async fn establish_session_from_bundle(
@@ -1368,7 +1530,7 @@ mod tests {
         storage.initialize_schema()?;
 
         let version = storage.get_schema_version()?;
-        assert_eq!(version, 2);
+        assert_eq!(version, 4);
 
         Ok(())
     }
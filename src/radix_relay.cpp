@@ -2,6 +2,7 @@
 #include <boost/asio/cancellation_signal.hpp>
 #include <boost/asio/executor_work_guard.hpp>
 #include <boost/asio/io_context.hpp>
+#include <chrono>
 #include <cli_utils/app_init.hpp>
 #include <cli_utils/cli_parser.hpp>
 #include <core/command_handler.hpp>
@@ -42,6 +43,7 @@ auto main(int argc, char **argv) -> int
 
   {
     auto bridge = std::make_shared<bridge_t>(args.identity_path);
+    bridge->set_payload_compression(args.compress_payloads);
     auto node_fingerprint = bridge->get_node_fingerprint();
 
     auto display_filter_queue = std::make_shared<async::async_queue<core::events::display_filter_input_t>>(io_context);
@@ -82,7 +84,11 @@ auto main(int argc, char **argv) -> int
       io_context, display_filter_queue, core::display_filter::out_queues_t{ .ui = ui_event_queue });
 
     auto request_tracker = std::make_shared<nostr::request_tracker>(io_context);
-    auto websocket = std::make_shared<transport::websocket_stream>(io_context);
+    auto websocket = std::make_shared<transport::websocket_stream>(io_context,
+      transport::websocket_compression{ .enabled = not args.no_relay_deflate,
+        .window_bits = args.relay_deflate_window_bits,
+        .memory_level = args.relay_deflate_memory_level,
+        .no_context_takeover = args.relay_deflate_no_context_takeover });
 
     auto orchestrator = std::make_shared<nostr::session_orchestrator<bridge_t, nostr::request_tracker>>(bridge,
       request_tracker,
@@ -90,10 +96,16 @@ auto main(int argc, char **argv) -> int
       session_queue,
       transport_queue,
       presentation_event_queue,
-      connection_monitor_queue);
-
+      connection_monitor_queue,
+      nostr::session_orchestrator_config{ .pow_difficulty = args.pow_difficulty,
+        .relay_pow_difficulty = args.relay_pow_difficulty,
+        .discover_all_bundles = args.discover_all_bundles,
+        .relay_max_subscriptions = args.relay_max_subscriptions,
+        .backfill_page_size = args.backfill_page_size });
+
+    static constexpr auto relay_ping_interval = std::chrono::seconds(30);
     auto transport = std::make_shared<nostr::transport<transport::websocket_stream>>(
-      websocket, io_context, transport_queue, session_queue);
+      websocket, io_context, transport_queue, session_queue, relay_ping_interval);
 
     auto command_parser = std::make_shared<core::command_parser<bridge_t>>(bridge);
 
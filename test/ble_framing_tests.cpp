@@ -0,0 +1,111 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <transport/ble_framing.hpp>
+#include <vector>
+
+using radix_relay::transport::ble_last_fragment;
+using radix_relay::transport::ble_more_fragments;
+using radix_relay::transport::ble_reassembler;
+using radix_relay::transport::fragment_ble_message;
+
+namespace {
+auto make_message(std::size_t size) -> std::vector<std::byte>
+{
+  std::vector<std::byte> message(size);
+  for (std::size_t i = 0; i < size; ++i) { message[i] = static_cast<std::byte>(i % 251); }
+  return message;
+}
+}// namespace
+
+TEST_CASE("fragment_ble_message keeps small messages in one write", "[transport][ble_framing]")
+{
+  const auto message = make_message(10);
+
+  const auto fragments = fragment_ble_message(message, 20);
+
+  REQUIRE(fragments.size() == 1);
+  CHECK(fragments[0].size() == 11);
+  CHECK(fragments[0].front() == ble_last_fragment);
+}
+
+TEST_CASE("fragment_ble_message splits large messages at the MTU", "[transport][ble_framing]")
+{
+  const auto message = make_message(50);
+
+  const auto fragments = fragment_ble_message(message, 20);
+
+  REQUIRE(fragments.size() == 3);
+  CHECK(fragments[0].size() == 20);
+  CHECK(fragments[1].size() == 20);
+  CHECK(fragments[2].size() == 13);
+  CHECK(fragments[0].front() == ble_more_fragments);
+  CHECK(fragments[1].front() == ble_more_fragments);
+  CHECK(fragments[2].front() == ble_last_fragment);
+}
+
+TEST_CASE("fragment_ble_message sends an empty message as one header", "[transport][ble_framing]")
+{
+  const auto fragments = fragment_ble_message({}, 20);
+
+  REQUIRE(fragments.size() == 1);
+  CHECK(fragments[0] == std::vector<std::byte>{ ble_last_fragment });
+}
+
+TEST_CASE("fragment_ble_message rejects an MTU with no room for payload", "[transport][ble_framing]")
+{
+  const auto message = make_message(4);
+
+  CHECK_THROWS_AS(fragment_ble_message(message, 1), std::invalid_argument);
+}
+
+TEST_CASE("ble_reassembler rebuilds fragmented messages", "[transport][ble_framing]")
+{
+  const auto first = make_message(1000);
+  const auto second = make_message(7);
+  ble_reassembler reassembler;
+
+  std::vector<std::vector<std::byte>> received;
+  for (const auto &message : { first, second }) {
+    for (const auto &fragment : fragment_ble_message(message, 185)) {
+      if (auto complete = reassembler.push(fragment)) { received.push_back(std::move(*complete)); }
+    }
+  }
+
+  REQUIRE(received.size() == 2);
+  CHECK(received[0] == first);
+  CHECK(received[1] == second);
+}
+
+TEST_CASE("ble_reassembler drops a partial message on a malformed fragment", "[transport][ble_framing]")
+{
+  const auto message = make_message(60);
+  const auto fragments = fragment_ble_message(message, 20);
+  ble_reassembler reassembler;
+
+  CHECK_FALSE(reassembler.push(fragments[0]).has_value());
+  CHECK_FALSE(reassembler.push(std::vector<std::byte>{ std::byte{ 0x7f }, std::byte{ 0x01 } }).has_value());
+  CHECK_FALSE(reassembler.push(std::vector<std::byte>{}).has_value());
+
+  std::optional<std::vector<std::byte>> complete;
+  for (const auto &fragment : fragments) { complete = reassembler.push(fragment); }
+
+  REQUIRE(complete.has_value());
+  CHECK(*complete == message);
+}
+
+TEST_CASE("ble_reassembler bounds the size of a partial message", "[transport][ble_framing]")
+{
+  const auto oversized = make_message(radix_relay::transport::ble_max_message_size + 1);
+  ble_reassembler reassembler;
+
+  std::optional<std::vector<std::byte>> complete;
+  for (const auto &fragment : fragment_ble_message(oversized, 512)) { complete = reassembler.push(fragment); }
+  CHECK_FALSE(complete.has_value());
+
+  const auto next = make_message(30);
+  for (const auto &fragment : fragment_ble_message(next, 20)) { complete = reassembler.push(fragment); }
+  REQUIRE(complete.has_value());
+  CHECK(*complete == next);
+}
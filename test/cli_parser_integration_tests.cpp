@@ -45,6 +45,16 @@ TEST_CASE("CLI parsing basic flags", "[cli_utils][cli_parser][integration]")
 
     CHECK(parsed.verbose == true);
   }
+
+  SECTION("compress flag opts in to payload compression")
+  {
+    std::vector<std::string> args = { "radix-relay", "--compress" };
+    auto argv = create_argv(args);
+
+    auto parsed = radix_relay::cli_utils::parse_cli_args(static_cast<int>(args.size()), argv.data());
+
+    CHECK(parsed.compress_payloads == true);
+  }
 }
 
 TEST_CASE("CLI parsing options", "[cli_utils][cli_parser][integration]")
@@ -88,6 +98,86 @@ TEST_CASE("CLI parsing options", "[cli_utils][cli_parser][integration]")
 
     CHECK(parsed.mode == "mesh");
   }
+
+  SECTION("proof-of-work difficulty, with per-relay overrides")
+  {
+    std::vector<std::string> args = { "radix-relay",
+      "--pow",
+      "16",
+      "--relay-pow",
+      "wss://strict.example",
+      "24",
+      "--relay-pow",
+      "wss://open.example",
+      "0" };
+    auto argv = create_argv(args);
+
+    auto parsed = radix_relay::cli_utils::parse_cli_args(static_cast<int>(args.size()), argv.data());
+
+    CHECK(parsed.pow_difficulty == 16);
+    CHECK(parsed.relay_pow_difficulty.size() == 2);
+    CHECK(parsed.relay_pow_difficulty.at("wss://strict.example") == 24);
+    CHECK(parsed.relay_pow_difficulty.at("wss://open.example") == 0);
+  }
+
+  SECTION("global bundle discovery")
+  {
+    std::vector<std::string> args = { "radix-relay", "--discover-all" };
+    auto argv = create_argv(args);
+
+    auto parsed = radix_relay::cli_utils::parse_cli_args(static_cast<int>(args.size()), argv.data());
+
+    CHECK(parsed.discover_all_bundles);
+  }
+
+  SECTION("per-relay subscription limits")
+  {
+    std::vector<std::string> args = { "radix-relay", "--relay-max-subs", "wss://small.example", "4" };
+    auto argv = create_argv(args);
+
+    auto parsed = radix_relay::cli_utils::parse_cli_args(static_cast<int>(args.size()), argv.data());
+
+    CHECK(parsed.relay_max_subscriptions.size() == 1);
+    CHECK(parsed.relay_max_subscriptions.at("wss://small.example") == 4);
+  }
+
+  SECTION("message backfill page size")
+  {
+    std::vector<std::string> args = { "radix-relay", "--backfill-page", "50" };
+    auto argv = create_argv(args);
+
+    auto parsed = radix_relay::cli_utils::parse_cli_args(static_cast<int>(args.size()), argv.data());
+
+    CHECK(parsed.backfill_page_size == 50);
+  }
+
+  SECTION("relay compression settings")
+  {
+    std::vector<std::string> args = { "radix-relay",
+      "--relay-deflate-window",
+      "10",
+      "--relay-deflate-mem-level",
+      "2",
+      "--relay-deflate-no-context-takeover" };
+    auto argv = create_argv(args);
+
+    auto parsed = radix_relay::cli_utils::parse_cli_args(static_cast<int>(args.size()), argv.data());
+
+    CHECK_FALSE(parsed.no_relay_deflate);
+    CHECK(parsed.relay_deflate_window_bits == 10);
+    CHECK(parsed.relay_deflate_memory_level == 2);
+    CHECK(parsed.relay_deflate_no_context_takeover);
+  }
+
+  SECTION("relay compression can be turned off")
+  {
+    std::vector<std::string> args = { "radix-relay", "--no-relay-deflate" };
+    auto argv = create_argv(args);
+
+    auto parsed = radix_relay::cli_utils::parse_cli_args(static_cast<int>(args.size()), argv.data());
+
+    CHECK(parsed.no_relay_deflate);
+  }
 }
 
 TEST_CASE("CLI parsing send subcommand", "[cli_utils][cli_parser][integration]")
@@ -169,5 +259,8 @@ TEST_CASE("CLI parsing defaults", "[cli_utils][cli_parser][integration]")
     CHECK(parsed.send_parsed == false);
     CHECK(parsed.peers_parsed == false);
     CHECK(parsed.status_parsed == false);
+    CHECK(parsed.no_relay_deflate == false);
+    CHECK(parsed.relay_deflate_window_bits == 15);
+    CHECK(parsed.relay_deflate_memory_level == 4);
   }
 }
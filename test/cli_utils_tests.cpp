@@ -23,6 +23,12 @@ TEST_CASE("cli_args default values", "[cli_utils][cli_parser]")
   CHECK(args.mode == "hybrid");
   CHECK(args.verbose == false);
   CHECK(args.show_version == false);
+  CHECK(args.compress_payloads == false);
+  CHECK(args.pow_difficulty == 0);
+  CHECK(args.relay_pow_difficulty.empty());
+  CHECK(args.discover_all_bundles == false);
+  CHECK(args.relay_max_subscriptions.empty());
+  CHECK(args.backfill_page_size == 200);
   CHECK(args.send_parsed == false);
   CHECK(args.peers_parsed == false);
   CHECK(args.status_parsed == false);
@@ -61,6 +67,28 @@ TEST_CASE("validate_cli_args validates mode", "[cli_utils][cli_parser]")
   }
 }
 
+TEST_CASE("validate_cli_args validates relay proof-of-work difficulty", "[cli_utils][cli_parser]")
+{
+  radix_relay::cli_utils::cli_args args;
+
+  args.relay_pow_difficulty["wss://relay.example"] = 255;
+  CHECK(radix_relay::cli_utils::validate_cli_args(args) == true);
+
+  args.relay_pow_difficulty["wss://relay.example"] = 256;
+  CHECK(radix_relay::cli_utils::validate_cli_args(args) == false);
+}
+
+TEST_CASE("validate_cli_args validates relay subscription limits", "[cli_utils][cli_parser]")
+{
+  radix_relay::cli_utils::cli_args args;
+
+  args.relay_max_subscriptions["wss://relay.example"] = 1;
+  CHECK(radix_relay::cli_utils::validate_cli_args(args) == true);
+
+  args.relay_max_subscriptions["wss://relay.example"] = 0;
+  CHECK(radix_relay::cli_utils::validate_cli_args(args) == false);
+}
+
 TEST_CASE("validate_cli_args validates send command", "[cli_utils][cli_parser]")
 {
   radix_relay::cli_utils::cli_args args;
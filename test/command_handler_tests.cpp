@@ -197,12 +197,57 @@ TEST_CASE("send command outputs send command confirmation with peer and message"
   CHECK(output.find("hello world") != std::string::npos);
 }
 
+TEST_CASE("sendmany command forwards recipients to session orchestrator", "[commands][visitor][parameterized]")
+{
+  auto send_many_command =
+    radix_relay::core::events::send_many{ .peers = { "alice", "bob", "carol" }, .message = "meet at noon" };
+  const command_handler_fixture fixture;
+  fixture.visitor(send_many_command);
+  CHECK(fixture.get_all_output().find("3 recipient(s)") != std::string::npos);
+
+  auto forwarded = fixture.session_out_queue->try_pop();
+  REQUIRE(forwarded.has_value());
+  REQUIRE(std::holds_alternative<radix_relay::core::events::send_many>(*forwarded));
+  CHECK(std::get<radix_relay::core::events::send_many>(*forwarded).peers.size() == 3);
+}
+
+TEST_CASE("sendfile command forwards the transfer to session orchestrator", "[commands][visitor][parameterized]")
+{
+  auto send_file_command = radix_relay::core::events::send_file{ .peer = "alice", .path = "/tmp/notes.txt" };
+  const command_handler_fixture fixture;
+  fixture.visitor(send_file_command);
+  CHECK(fixture.get_all_output().find("/tmp/notes.txt") != std::string::npos);
+
+  auto forwarded = fixture.session_out_queue->try_pop();
+  REQUIRE(forwarded.has_value());
+  REQUIRE(std::holds_alternative<radix_relay::core::events::send_file>(*forwarded));
+  CHECK(std::get<radix_relay::core::events::send_file>(*forwarded).peer == "alice");
+}
+
 TEST_CASE("broadcast command outputs broadcast command confirmation with message", "[commands][visitor][parameterized]")
 {
-  auto broadcast_command = radix_relay::core::events::broadcast{ .message = "hello everyone" };
+  auto broadcast_command = radix_relay::core::events::broadcast{ .group = "friends", .message = "hello everyone" };
   const command_handler_fixture fixture;
   fixture.visitor(broadcast_command);
   CHECK(fixture.get_all_output().find("hello everyone") != std::string::npos);
+
+  auto forwarded = fixture.session_out_queue->try_pop();
+  REQUIRE(forwarded.has_value());
+  REQUIRE(std::holds_alternative<radix_relay::core::events::broadcast>(*forwarded));
+  CHECK(std::get<radix_relay::core::events::broadcast>(*forwarded).group == "friends");
+}
+
+TEST_CASE("group command forwards group creation to session orchestrator", "[commands][visitor][parameterized]")
+{
+  auto group_command = radix_relay::core::events::create_group{ .name = "friends", .members = { "alice", "bob" } };
+  const command_handler_fixture fixture;
+  fixture.visitor(group_command);
+  CHECK(fixture.get_all_output().find("friends") != std::string::npos);
+
+  auto forwarded = fixture.session_out_queue->try_pop();
+  REQUIRE(forwarded.has_value());
+  REQUIRE(std::holds_alternative<radix_relay::core::events::create_group>(*forwarded));
+  CHECK(std::get<radix_relay::core::events::create_group>(*forwarded).members.size() == 2);
 }
 
 TEST_CASE("connect command outputs connect command confirmation with relay URL", "[commands][visitor][parameterized]")
@@ -286,12 +331,39 @@ TEST_CASE("send command with empty parameters outputs usage information", "[comm
 
 TEST_CASE("broadcast command with empty message outputs usage information", "[commands][visitor][validation]")
 {
-  auto broadcast_command = radix_relay::core::events::broadcast{ .message = "" };
+  auto broadcast_command = radix_relay::core::events::broadcast{ .group = "", .message = "" };
   const command_handler_fixture fixture;
   fixture.visitor(broadcast_command);
   CHECK(fixture.get_all_output().find("Usage") != std::string::npos);
 }
 
+TEST_CASE("sendmany command without recipients outputs usage information", "[commands][visitor][validation]")
+{
+  auto send_many_command = radix_relay::core::events::send_many{ .peers = {}, .message = "hello" };
+  const command_handler_fixture fixture;
+  fixture.visitor(send_many_command);
+  CHECK(fixture.get_all_output().find("Usage") != std::string::npos);
+  CHECK_FALSE(fixture.session_out_queue->try_pop().has_value());
+}
+
+TEST_CASE("sendfile command without path outputs usage information", "[commands][visitor][validation]")
+{
+  auto send_file_command = radix_relay::core::events::send_file{ .peer = "alice", .path = "" };
+  const command_handler_fixture fixture;
+  fixture.visitor(send_file_command);
+  CHECK(fixture.get_all_output().find("Usage") != std::string::npos);
+  CHECK_FALSE(fixture.session_out_queue->try_pop().has_value());
+}
+
+TEST_CASE("group command without members outputs usage information", "[commands][visitor][validation]")
+{
+  auto group_command = radix_relay::core::events::create_group{ .name = "friends", .members = {} };
+  const command_handler_fixture fixture;
+  fixture.visitor(group_command);
+  CHECK(fixture.get_all_output().find("Usage") != std::string::npos);
+  CHECK_FALSE(fixture.session_out_queue->try_pop().has_value());
+}
+
 TEST_CASE("mode command with invalid mode outputs invalid mode error message", "[commands][visitor][validation]")
 {
   auto mode_command = radix_relay::core::events::mode{ .new_mode = "invalid" };
@@ -6,6 +6,7 @@
 
 using radix_relay::core::command_parser;
 using radix_relay::core::events::broadcast;
+using radix_relay::core::events::create_group;
 using radix_relay::core::events::chat;
 using radix_relay::core::events::connect;
 using radix_relay::core::events::disconnect;
@@ -17,6 +18,8 @@ using radix_relay::core::events::peers;
 using radix_relay::core::events::publish_identity;
 using radix_relay::core::events::scan;
 using radix_relay::core::events::send;
+using radix_relay::core::events::send_file;
+using radix_relay::core::events::send_many;
 using radix_relay::core::events::sessions;
 using radix_relay::core::events::status;
 using radix_relay::core::events::trust;
@@ -130,13 +133,65 @@ TEST_CASE("command_parser parses commands with arguments", "[command_parser]")
     CHECK(cmd.message.empty());
   }
 
+  SECTION("sendmany command splits comma-separated recipients")
+  {
+    auto result = parser.parse("/sendmany alice,RDX:bob,,carol meet at noon");
+    REQUIRE(std::holds_alternative<send_many>(result));
+    const auto &cmd = std::get<send_many>(result);
+    CHECK(cmd.peers == std::vector<std::string>{ "alice", "RDX:bob", "carol" });
+    CHECK(cmd.message == "meet at noon");
+  }
+
+  SECTION("sendmany command without message returns empty fields")
+  {
+    auto result = parser.parse("/sendmany alice,bob");
+    REQUIRE(std::holds_alternative<send_many>(result));
+    CHECK(std::get<send_many>(result).peers.empty());
+    CHECK(std::get<send_many>(result).message.empty());
+  }
+
+  SECTION("sendfile command keeps spaces in the path")
+  {
+    auto result = parser.parse("/sendfile alice /tmp/holiday photos.tar");
+    REQUIRE(std::holds_alternative<send_file>(result));
+    const auto &cmd = std::get<send_file>(result);
+    CHECK(cmd.peer == "alice");
+    CHECK(cmd.path == "/tmp/holiday photos.tar");
+  }
+
+  SECTION("sendfile command without path returns empty fields")
+  {
+    auto result = parser.parse("/sendfile alice");
+    REQUIRE(std::holds_alternative<send_file>(result));
+    CHECK(std::get<send_file>(result).peer.empty());
+    CHECK(std::get<send_file>(result).path.empty());
+  }
+
   SECTION("broadcast command")
   {
-    auto result = parser.parse("/broadcast hello everyone");
+    auto result = parser.parse("/broadcast friends hello everyone");
     REQUIRE(std::holds_alternative<broadcast>(result));
+    CHECK(std::get<broadcast>(result).group == "friends");
     CHECK(std::get<broadcast>(result).message == "hello everyone");
   }
 
+  SECTION("broadcast command without message")
+  {
+    auto result = parser.parse("/broadcast friends");
+    REQUIRE(std::holds_alternative<broadcast>(result));
+    CHECK(std::get<broadcast>(result).group.empty());
+    CHECK(std::get<broadcast>(result).message.empty());
+  }
+
+  SECTION("group command")
+  {
+    auto result = parser.parse("/group friends alice  RDX:bob");
+    REQUIRE(std::holds_alternative<create_group>(result));
+    const auto &cmd = std::get<create_group>(result);
+    CHECK(cmd.name == "friends");
+    CHECK(cmd.members == std::vector<std::string>{ "alice", "RDX:bob" });
+  }
+
   SECTION("connect command")
   {
     auto result = parser.parse("/connect wss://relay.example.com");
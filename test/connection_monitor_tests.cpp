@@ -295,3 +295,78 @@ TEST_CASE("connection_monitor emits display message for query_status with failed
       *msg);
   }
 }
+
+TEST_CASE("connection_monitor lists relay health in query_status", "[connection_monitor][query]")
+{
+  auto io_context = std::make_shared<boost::asio::io_context>();
+  auto display_queue =
+    std::make_shared<radix_relay::async::async_queue<radix_relay::core::events::display_filter_input_t>>(io_context);
+  const radix_relay::core::connection_monitor::out_queues_t queues{ .display = display_queue };
+  radix_relay::core::connection_monitor monitor(queues);
+
+  monitor.handle(radix_relay::core::events::connection_monitor::relay_stats{ .url = "wss://relay.example.com",
+    .score = 91,
+    .ok_p50_ms = 80,
+    .ok_p99_ms = 240,
+    .eose_p50_ms = std::nullopt,
+    .ping_ms = 35,
+    .connect_p50_ms = 120,
+    .connect_p99_ms = std::nullopt,
+    .request_timeout_ms = 1000,
+    .timeouts = 2 });
+  CHECK(monitor.get_status().relays.size() == 1);
+
+  monitor.handle(radix_relay::core::events::connection_monitor::query_status{});
+
+  auto msg = display_queue->try_pop();
+  REQUIRE(msg.has_value());
+  if (msg.has_value()) {
+    std::visit(
+      [](const auto &evt) {
+        if constexpr (std::same_as<std::decay_t<decltype(evt)>, radix_relay::core::events::display_message>) {
+          CHECK(evt.message.find("Relays:") != std::string::npos);
+          CHECK(evt.message.find("wss://relay.example.com: score 91, OK p50 80 ms p99 240 ms, EOSE p50 -, "
+                                 "ping 35 ms, connect p50 120 ms p99 -, timeout 1000 ms, 2 timeouts")
+                != std::string::npos);
+        }
+      },
+      *msg);
+  }
+}
+
+TEST_CASE("connection_monitor totals relay traffic in query_status", "[connection_monitor][query]")
+{
+  auto io_context = std::make_shared<boost::asio::io_context>();
+  auto display_queue =
+    std::make_shared<radix_relay::async::async_queue<radix_relay::core::events::display_filter_input_t>>(io_context);
+  const radix_relay::core::connection_monitor::out_queues_t queues{ .display = display_queue };
+  radix_relay::core::connection_monitor monitor(queues);
+
+  const radix_relay::core::events::connection_monitor::in_t report =
+    radix_relay::core::events::transport::traffic_measured{ .url = "wss://relay.example.com",
+      .message_bytes_sent = 4000,
+      .message_bytes_received = 9000,
+      .wire_bytes_sent = 1000,
+      .wire_bytes_received = 2000 };
+  monitor.handle(report);
+  monitor.handle(report);
+  REQUIRE(monitor.get_status().traffic.size() == 1);
+  CHECK(monitor.get_status().traffic.at("wss://relay.example.com").wire_bytes_received == 4000);
+
+  monitor.handle(radix_relay::core::events::connection_monitor::query_status{});
+
+  auto msg = display_queue->try_pop();
+  REQUIRE(msg.has_value());
+  if (msg.has_value()) {
+    std::visit(
+      [](const auto &evt) {
+        if constexpr (std::same_as<std::decay_t<decltype(evt)>, radix_relay::core::events::display_message>) {
+          CHECK(evt.message.find("Traffic:") != std::string::npos);
+          CHECK(evt.message.find("wss://relay.example.com: sent 8000 B (2000 B on the wire), "
+                                 "received 18000 B (4000 B on the wire)")
+                != std::string::npos);
+        }
+      },
+      *msg);
+  }
+}
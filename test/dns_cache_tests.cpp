@@ -0,0 +1,49 @@
+#include <boost/asio/ip/tcp.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <transport/dns_cache.hpp>
+
+using boost::asio::ip::make_address;
+using boost::asio::ip::tcp;
+using radix_relay::transport::dns_cache;
+
+namespace {
+auto addresses() -> dns_cache::endpoints_t
+{
+  return { { make_address("2001:db8::1"), 443 }, { make_address("192.0.2.1"), 443 } };
+}
+}// namespace
+
+TEST_CASE("dns_cache serves a resolution until its TTL runs out", "[transport][dns_cache]")
+{
+  dns_cache cache(std::chrono::seconds(60));
+  const auto resolved_at = dns_cache::clock::now();
+
+  CHECK_FALSE(cache.lookup("relay.example", "443", resolved_at).has_value());
+  cache.store("relay.example", "443", addresses(), resolved_at);
+
+  const auto fresh = cache.lookup("relay.example", "443", resolved_at + std::chrono::seconds(59));
+  REQUIRE(fresh.has_value());
+  CHECK(*fresh == addresses());
+  CHECK_FALSE(cache.lookup("relay.example", "443", resolved_at + std::chrono::seconds(60)).has_value());
+  CHECK_FALSE(cache.lookup("relay.example", "8443", resolved_at).has_value());
+}
+
+TEST_CASE("dns_cache forgets a host on request", "[transport][dns_cache]")
+{
+  dns_cache cache;
+  cache.store("relay.example", "443", addresses());
+  REQUIRE(cache.lookup("relay.example", "443").has_value());
+
+  cache.forget("relay.example", "443");
+
+  CHECK_FALSE(cache.lookup("relay.example", "443").has_value());
+}
+
+TEST_CASE("dns_cache ignores empty resolutions", "[transport][dns_cache]")
+{
+  dns_cache cache;
+  cache.store("relay.example", "443", {});
+
+  CHECK_FALSE(cache.lookup("relay.example", "443").has_value());
+}
@@ -90,7 +90,7 @@ TEST_CASE("Event handler processes parameterized raw commands", "[events][handle
   CHECK(fixture.command_handler->was_called("send:alice:hello"));
 
   fixture.handler.handle(broadcast_event);
-  CHECK(fixture.command_handler->was_called("broadcast:test message"));
+  CHECK(fixture.command_handler->was_called("broadcast:test:message"));
 
   fixture.handler.handle(connect_event);
   CHECK(fixture.command_handler->was_called("connect:wss://relay.example.com"));
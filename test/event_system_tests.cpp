@@ -33,8 +33,9 @@ TEST_CASE("Send event holds peer and message data", "[events][construction]")
 
 TEST_CASE("Broadcast event holds message data", "[events][construction]")
 {
-  auto broadcast_event = radix_relay::core::events::broadcast{ "hello everyone" };
+  auto broadcast_event = radix_relay::core::events::broadcast{ "friends", "hello everyone" };
 
+  CHECK(broadcast_event.group == "friends");
   CHECK(broadcast_event.message == "hello everyone");
 }
 
@@ -69,6 +70,8 @@ TEST_CASE("All event types satisfy Event concept", "[events][concepts]")
   CHECK(radix_relay::core::events::Event<radix_relay::core::events::version>);
   CHECK(radix_relay::core::events::Event<radix_relay::core::events::mode>);
   CHECK(radix_relay::core::events::Event<radix_relay::core::events::send>);
+  CHECK(radix_relay::core::events::Event<radix_relay::core::events::send_many>);
+  CHECK(radix_relay::core::events::Event<radix_relay::core::events::send_file>);
   CHECK(radix_relay::core::events::Event<radix_relay::core::events::broadcast>);
   CHECK(radix_relay::core::events::Event<radix_relay::core::events::connect>);
   CHECK(radix_relay::core::events::Event<radix_relay::core::events::trust>);
@@ -0,0 +1,128 @@
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <optional>
+#include <transport/happy_eyeballs.hpp>
+#include <vector>
+
+using boost::asio::ip::make_address;
+using boost::asio::ip::tcp;
+using radix_relay::transport::async_happy_eyeballs_connect;
+using radix_relay::transport::interleave_address_families;
+
+namespace {
+auto endpoint(const char *address, unsigned short port = 443) -> tcp::endpoint
+{
+  return { make_address(address), port };
+}
+
+/// Returns a loopback address nothing listens on, so connecting to it is refused
+auto refused_endpoint(boost::asio::io_context &io_context) -> tcp::endpoint
+{
+  tcp::acceptor acceptor(io_context, endpoint("127.0.0.1", 0));
+  auto closed = acceptor.local_endpoint();
+  acceptor.close();
+  return closed;
+}
+
+struct race_result
+{
+  boost::system::error_code error;
+  tcp::endpoint endpoint;
+  bool socket_open{ false };
+};
+
+auto race(boost::asio::io_context &io_context,
+  const std::vector<tcp::endpoint> &endpoints,
+  std::chrono::milliseconds timeout = std::chrono::seconds(5)) -> std::optional<race_result>
+{
+  std::optional<race_result> result;
+  async_happy_eyeballs_connect(io_context.get_executor(),
+    endpoints,
+    std::chrono::milliseconds(50),
+    timeout,
+    [&result](const boost::system::error_code &error, tcp::socket socket, const tcp::endpoint &connected) {
+      result = race_result{ .error = error, .endpoint = connected, .socket_open = socket.is_open() };
+    });
+  io_context.run();
+  io_context.restart();
+  return result;
+}
+}// namespace
+
+TEST_CASE("interleave_address_families alternates families starting with the first", "[transport][happy_eyeballs]")
+{
+  const std::vector<tcp::endpoint> resolved{
+    endpoint("2001:db8::1"), endpoint("2001:db8::2"), endpoint("192.0.2.1"), endpoint("192.0.2.2")
+  };
+
+  const auto ordered = interleave_address_families(resolved);
+
+  REQUIRE(ordered.size() == 4);
+  CHECK(ordered[0] == endpoint("2001:db8::1"));
+  CHECK(ordered[1] == endpoint("192.0.2.1"));
+  CHECK(ordered[2] == endpoint("2001:db8::2"));
+  CHECK(ordered[3] == endpoint("192.0.2.2"));
+}
+
+TEST_CASE("interleave_address_families appends the surplus of one family", "[transport][happy_eyeballs]")
+{
+  const std::vector<tcp::endpoint> resolved{
+    endpoint("192.0.2.1"), endpoint("192.0.2.2"), endpoint("192.0.2.3"), endpoint("2001:db8::1")
+  };
+
+  const auto ordered = interleave_address_families(resolved);
+
+  REQUIRE(ordered.size() == 4);
+  CHECK(ordered[0] == endpoint("192.0.2.1"));
+  CHECK(ordered[1] == endpoint("2001:db8::1"));
+  CHECK(ordered[2] == endpoint("192.0.2.2"));
+  CHECK(ordered[3] == endpoint("192.0.2.3"));
+  CHECK(interleave_address_families({}).empty());
+}
+
+TEST_CASE("async_happy_eyeballs_connect moves past a refused address", "[transport][happy_eyeballs]")
+{
+  boost::asio::io_context io_context;
+  const tcp::acceptor listening(io_context, endpoint("127.0.0.1", 0));
+  const auto refused = refused_endpoint(io_context);
+
+  const auto result = race(io_context, { refused, listening.local_endpoint() });
+
+  REQUIRE(result.has_value());
+  CHECK(not result->error);
+  CHECK(result->endpoint == listening.local_endpoint());
+  CHECK(result->socket_open);
+}
+
+TEST_CASE("async_happy_eyeballs_connect does not wait out an unanswered address", "[transport][happy_eyeballs]")
+{
+  boost::asio::io_context io_context;
+  const tcp::acceptor listening(io_context, endpoint("127.0.0.1", 0));
+
+  // TEST-NET-1 is never routed: the attempt either hangs or fails, and the race must not care which
+  const auto started = std::chrono::steady_clock::now();
+  const auto result = race(io_context, { endpoint("192.0.2.1", 9), listening.local_endpoint() });
+
+  REQUIRE(result.has_value());
+  CHECK(not result->error);
+  CHECK(result->endpoint == listening.local_endpoint());
+  CHECK(std::chrono::steady_clock::now() - started < std::chrono::seconds(2));
+}
+
+TEST_CASE("async_happy_eyeballs_connect fails once every address failed", "[transport][happy_eyeballs]")
+{
+  boost::asio::io_context io_context;
+  const auto refused = refused_endpoint(io_context);
+
+  const auto result = race(io_context, { refused, refused });
+
+  REQUIRE(result.has_value());
+  CHECK(result->error);
+  CHECK(not result->socket_open);
+
+  const auto none = race(io_context, {});
+  REQUIRE(none.has_value());
+  CHECK(none->error == boost::asio::error::host_not_found);
+}
@@ -0,0 +1,120 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <nostr/bundle_registry.hpp>
+#include <string>
+
+using radix_relay::nostr::bundle_registry;
+using radix_relay::nostr::discovered_bundle;
+
+namespace {
+
+auto make_bundle(const std::string &pubkey, const std::string &rdx, std::uint64_t created_at, std::size_t size = 4)
+  -> discovered_bundle
+{
+  return discovered_bundle{ .rdx_fingerprint = rdx,
+    .nostr_pubkey = pubkey,
+    .bundle_base64 = std::string(size, 'B'),
+    .event_id = pubkey + "_" + std::to_string(created_at),
+    .created_at = created_at };
+}
+
+}// namespace
+
+TEST_CASE("bundle_registry finds bundles by pubkey and RDX fingerprint", "[nostr][bundles]")
+{
+  bundle_registry registry;
+  CHECK(registry.upsert(make_bundle("alice", "RDX:alice", 10)));
+  CHECK(registry.upsert(make_bundle("bob", "RDX:bob", 10)));
+
+  REQUIRE(registry.find_by_pubkey("bob") != nullptr);
+  CHECK(registry.find_by_pubkey("bob")->rdx_fingerprint == "RDX:bob");
+  REQUIRE(registry.use_by_rdx("RDX:alice") != nullptr);
+  CHECK(registry.use_by_rdx("RDX:alice")->nostr_pubkey == "alice");
+  CHECK(registry.find_by_pubkey("carol") == nullptr);
+  CHECK(registry.use_by_rdx("RDX:carol") == nullptr);
+  CHECK(registry.size() == 2);
+}
+
+TEST_CASE("bundle_registry keeps the newest announcement per pubkey", "[nostr][bundles]")
+{
+  bundle_registry registry;
+  registry.upsert(make_bundle("alice", "RDX:alice", 20));
+
+  CHECK_FALSE(registry.upsert(make_bundle("alice", "RDX:stale", 10)));
+  CHECK(registry.find_by_pubkey("alice")->event_id == "alice_20");
+  CHECK(registry.use_by_rdx("RDX:stale") == nullptr);
+
+  CHECK(registry.upsert(make_bundle("alice", "RDX:rotated", 30, 8)));
+  CHECK(registry.size() == 1);
+  CHECK(registry.find_by_pubkey("alice")->event_id == "alice_30");
+  CHECK(registry.use_by_rdx("RDX:alice") == nullptr);
+  CHECK(registry.use_by_rdx("RDX:rotated") != nullptr);
+  CHECK(registry.body_bytes() == 8);
+}
+
+TEST_CASE("bundle_registry keeps indexes valid across removals", "[nostr][bundles]")
+{
+  bundle_registry registry;
+  registry.upsert(make_bundle("alice", "RDX:alice", 1));
+  registry.upsert(make_bundle("bob", "RDX:bob", 1));
+  registry.upsert(make_bundle("carol", "RDX:carol", 1));
+
+  CHECK(registry.erase("alice"));
+  CHECK_FALSE(registry.erase("alice"));
+
+  CHECK(registry.size() == 2);
+  CHECK(registry.body_bytes() == 8);
+  CHECK(registry.find_by_pubkey("alice") == nullptr);
+  CHECK(registry.use_by_rdx("RDX:alice") == nullptr);
+  REQUIRE(registry.use_by_rdx("RDX:carol") != nullptr);
+  CHECK(registry.use_by_rdx("RDX:carol")->nostr_pubkey == "carol");
+  REQUIRE(registry.find_by_pubkey("bob") != nullptr);
+  CHECK(registry.find_by_pubkey("bob")->rdx_fingerprint == "RDX:bob");
+}
+
+TEST_CASE("bundle_registry evicts the least recently used bodies over its cap", "[nostr][bundles]")
+{
+  bundle_registry registry(10);
+  registry.upsert(make_bundle("alice", "RDX:alice", 1));
+  registry.upsert(make_bundle("bob", "RDX:bob", 1));
+  registry.use_by_rdx("RDX:alice");
+  registry.upsert(make_bundle("carol", "RDX:carol", 1));
+
+  CHECK(registry.size() == 3);
+  CHECK(registry.body_bytes() == 8);
+  CHECK(registry.find_by_pubkey("bob")->bundle_base64.empty());
+  CHECK_FALSE(registry.find_by_pubkey("alice")->bundle_base64.empty());
+  CHECK_FALSE(registry.find_by_pubkey("carol")->bundle_base64.empty());
+
+  registry.upsert(make_bundle("bob", "RDX:bob", 1));
+  CHECK_FALSE(registry.find_by_pubkey("bob")->bundle_base64.empty());
+  CHECK(registry.find_by_pubkey("alice")->bundle_base64.empty());
+
+  registry.upsert(make_bundle("dave", "RDX:dave", 1, 32));
+  CHECK(registry.body_bytes() == 32);
+  CHECK_FALSE(registry.find_by_pubkey("dave")->bundle_base64.empty());
+}
+
+TEST_CASE("bundle_registry fills in RDX fingerprints lazily", "[nostr][bundles]")
+{
+  bundle_registry registry;
+  registry.upsert(make_bundle("alice", "", 1));
+  CHECK(registry.use_by_rdx("RDX:alice") == nullptr);
+
+  registry.set_rdx_fingerprint("alice", "RDX:alice");
+  REQUIRE(registry.use_by_rdx("RDX:alice") != nullptr);
+
+  SECTION("identical bundle data keeps the fingerprint")
+  {
+    registry.upsert(make_bundle("alice", "", 2));
+    CHECK(registry.find_by_pubkey("alice")->event_id == "alice_2");
+    CHECK(registry.find_by_pubkey("alice")->rdx_fingerprint == "RDX:alice");
+  }
+
+  SECTION("new bundle data needs a new fingerprint")
+  {
+    registry.upsert(make_bundle("alice", "", 2, 6));
+    CHECK(registry.find_by_pubkey("alice")->rdx_fingerprint.empty());
+    CHECK(registry.use_by_rdx("RDX:alice") == nullptr);
+  }
+}
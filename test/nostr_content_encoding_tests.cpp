@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <nostr/content_encoding.hpp>
+#include <string>
+#include <vector>
+
+using radix_relay::nostr::protocol::content_encoding;
+using radix_relay::nostr::protocol::decode_content;
+
+TEST_CASE("content_encoding_from_tags reads the radix_version marker", "[nostr][content_encoding]")
+{
+  using radix_relay::nostr::protocol::content_encoding_from_tags;
+
+  CHECK(content_encoding_from_tags({}) == content_encoding::hex);
+  CHECK(content_encoding_from_tags({ { "radix_version", "0.4.0" } }) == content_encoding::hex);
+  CHECK(content_encoding_from_tags({ { "p", "abc" }, { "radix_version", "0.4.0", "base64" } })
+        == content_encoding::base64);
+  CHECK(content_encoding_from_tags({ { "radix_version", "0.4.0", "zstd" } }) == content_encoding::hex);
+}
+
+TEST_CASE("accepts_base64_content reads the marker and the radix_content_encoding tag", "[nostr][content_encoding]")
+{
+  using radix_relay::nostr::protocol::accepts_base64_content;
+
+  CHECK_FALSE(accepts_base64_content({}));
+  CHECK_FALSE(accepts_base64_content({ { "radix_version", "0.4.0" } }));
+  CHECK_FALSE(accepts_base64_content({ { "radix_content_encoding" } }));
+  CHECK(accepts_base64_content({ { "radix_version", "0.4.0", "base64" } }));
+  CHECK(accepts_base64_content({ { "radix_version", "0.4.0" }, { "radix_content_encoding", "base64" } }));
+}
+
+TEST_CASE("accepts_zstd_compression reads the radix_compression tag", "[nostr][content_encoding]")
+{
+  using radix_relay::nostr::protocol::accepts_zstd_compression;
+
+  CHECK_FALSE(accepts_zstd_compression({}));
+  CHECK_FALSE(accepts_zstd_compression({ { "radix_version", "0.4.0", "base64" } }));
+  CHECK_FALSE(accepts_zstd_compression({ { "radix_compression" } }));
+  CHECK(accepts_zstd_compression({ { "p", "abc" }, { "radix_compression", "zstd" } }));
+  CHECK(accepts_zstd_compression({ { "radix_compression", "brotli", "zstd" } }));
+}
+
+TEST_CASE("group_id_from_tags reads the first g tag", "[nostr][content_encoding]")
+{
+  using radix_relay::nostr::protocol::group_id_from_tags;
+
+  CHECK_FALSE(group_id_from_tags({}).has_value());
+  CHECK_FALSE(group_id_from_tags({ { "g" } }).has_value());
+  CHECK_FALSE(group_id_from_tags({ { "p", "abc" } }).has_value());
+  CHECK(group_id_from_tags({ { "p", "abc" }, { "g", "group-1" }, { "g", "group-2" } }) == "group-1");
+}
+
+TEST_CASE("decode_content decodes hex", "[nostr][content_encoding]")
+{
+  CHECK(decode_content("", content_encoding::hex) == std::vector<std::uint8_t>{});
+  CHECK(decode_content("00ff7Fa0", content_encoding::hex) == std::vector<std::uint8_t>{ 0x00, 0xff, 0x7f, 0xa0 });
+  CHECK_FALSE(decode_content("abc", content_encoding::hex).has_value());
+  CHECK_FALSE(decode_content("zz", content_encoding::hex).has_value());
+}
+
+TEST_CASE("decode_content decodes base64", "[nostr][content_encoding]")
+{
+  const std::string text = "radix relay";
+  const std::vector<std::uint8_t> bytes(text.begin(), text.end());
+
+  CHECK(decode_content("", content_encoding::base64) == std::vector<std::uint8_t>{});
+  CHECK(decode_content("cmFkaXggcmVsYXk=", content_encoding::base64) == bytes);
+  CHECK(decode_content("cmFkaXggcmVsYXk", content_encoding::base64) == bytes);
+  CHECK(decode_content("aGk=", content_encoding::base64) == std::vector<std::uint8_t>{ 'h', 'i' });
+  CHECK(decode_content("aA==", content_encoding::base64) == std::vector<std::uint8_t>{ 'h' });
+  CHECK(decode_content("+/8=", content_encoding::base64) == std::vector<std::uint8_t>{ 0xfb, 0xff });
+  CHECK(decode_content("-_8", content_encoding::base64) == std::vector<std::uint8_t>{ 0xfb, 0xff });
+}
+
+TEST_CASE("decode_content rejects malformed base64", "[nostr][content_encoding]")
+{
+  CHECK_FALSE(decode_content("a", content_encoding::base64).has_value());
+  CHECK_FALSE(decode_content("aG=k", content_encoding::base64).has_value());
+  CHECK_FALSE(decode_content("aGk*", content_encoding::base64).has_value());
+  CHECK_FALSE(decode_content("aGk=aGk=", content_encoding::base64).has_value());
+}
@@ -0,0 +1,68 @@
+#include <catch2/catch_test_macros.hpp>
+#include <nlohmann/json.hpp>
+#include <nostr/event_verification.hpp>
+#include <string>
+
+using radix_relay::nostr::compute_event_id;
+using radix_relay::nostr::verified_event_cache;
+
+namespace {
+
+auto make_event(const std::string &content) -> nlohmann::json
+{
+  auto event = nlohmann::json::parse(R"({"pubkey":"ab","created_at":1,"kind":1,"tags":[["p","x"]],"sig":"s1"})");
+  event["content"] = content;
+  event["id"] = compute_event_id(event);
+  return event;
+}
+
+}// namespace
+
+TEST_CASE("compute_event_id hashes the NIP-01 serialization", "[nostr][verify]")
+{
+  const auto event = make_event("hi");
+
+  CHECK(event["id"] == "a90b75bb299fb53f45e177d9bf32217907927ded8018b494fa084f83ec0a760f");
+  CHECK_THROWS_AS(compute_event_id(nlohmann::json::parse(R"({"pubkey":"ab"})")), nlohmann::json::exception);
+}
+
+TEST_CASE("verified_event_cache only vouches for unchanged events", "[nostr][verify]")
+{
+  verified_event_cache cache;
+  const auto event = make_event("hi");
+
+  CHECK_FALSE(cache.contains(event));
+  cache.insert(event);
+  CHECK(cache.contains(event));
+
+  auto tampered = event;
+  tampered["content"] = "bye";
+  CHECK_FALSE(cache.contains(tampered));
+
+  auto resigned = event;
+  resigned["sig"] = "s2";
+  CHECK_FALSE(cache.contains(resigned));
+}
+
+TEST_CASE("verified_event_cache forgets the oldest events once full", "[nostr][verify]")
+{
+  verified_event_cache cache(2);
+  const auto first = make_event("one");
+  const auto second = make_event("two");
+  const auto third = make_event("three");
+
+  cache.insert(first);
+  cache.insert(second);
+  cache.insert(second);
+  cache.insert(third);
+
+  CHECK(cache.size() == 2);
+  CHECK_FALSE(cache.contains(first));
+  CHECK(cache.contains(second));
+  CHECK(cache.contains(third));
+
+  verified_event_cache disabled(0);
+  disabled.insert(first);
+  CHECK(disabled.size() == 0);
+  CHECK_FALSE(disabled.contains(first));
+}
@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <bit>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <limits>
+#include <nlohmann/json.hpp>
+#include <nostr/json_writer.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+auto to_string(const std::vector<std::byte> &bytes) -> std::string
+{
+  std::string result(bytes.size(), '\0');
+  std::ranges::transform(bytes, result.begin(), [](std::byte byte) { return std::bit_cast<char>(byte); });
+  return result;
+}
+
+auto write_string(std::string_view text) -> std::string
+{
+  std::vector<std::byte> bytes;
+  radix_relay::nostr::protocol::json_writer writer(bytes);
+  writer.value(text);
+  return to_string(bytes);
+}
+
+auto sample_event() -> radix_relay::nostr::protocol::event_data
+{
+  return { .id = "4376c65d2f232afbe9b882a35baa4f6fe8667c4e684749af565f981833ed6a65",
+    .pubkey = "6e468422dfb74a5738702a8823b9b28168abab8655faacb6853cd0ee15deee93",
+    .created_at = 1673347337,
+    .kind = radix_relay::nostr::protocol::kind::text_note,
+    .tags = { { "e", "3da979448d9ba263864c4d6f14984c423a3838364ec255f03c7904b1ae77f206" }, { "p", "bf2376e1" } },
+    .content = "Walled gardens became prisons,\nand \"nostr\" is the first step",
+    .sig = "908a15e46fb4d8675bab026fc230a0e3542bfade63da02d542fb78b2a8513fcd" };
+}
+
+}// namespace
+
+TEST_CASE("json_writer escapes strings", "[nostr][json_writer]")
+{
+  CHECK(write_string("plain") == R"("plain")");
+  CHECK(write_string("") == R"("")");
+  CHECK(write_string("quote \" backslash \\") == R"("quote \" backslash \\")");
+  CHECK(write_string("\n\r\t\b\f") == R"("\n\r\t\b\f")");
+  CHECK(write_string(std::string{ "nul\0unit\x1f", 9 }) == R"("nul\u0000unit\u001f")");
+  CHECK(write_string("caf\xc3\xa9 \xe2\x9c\x93") == "\"caf\xc3\xa9 \xe2\x9c\x93\"");
+}
+
+TEST_CASE("json_writer escaping matches nlohmann at every offset", "[nostr][json_writer]")
+{
+  const std::string filler = "abcdefghijklmnopqrstuvwxyz0123456789";
+  for (const char special : { '"', '\\', '\n', '\x01', '\x7f' }) {
+    for (std::size_t position = 0; position < filler.size(); ++position) {
+      auto text = filler;
+      text[position] = special;
+      CHECK(write_string(text) == nlohmann::json(text).dump());
+    }
+  }
+}
+
+TEST_CASE("json_writer finds the unescaped prefix", "[nostr][json_writer]")
+{
+  using radix_relay::nostr::protocol::json_writer;
+
+  CHECK(json_writer::unescaped_prefix_length("") == 0);
+  CHECK(json_writer::unescaped_prefix_length("0123456789abcdef0123") == 20);
+  CHECK(json_writer::unescaped_prefix_length("0123456789\"bcdef") == 10);
+  CHECK(json_writer::unescaped_prefix_length("01234\\") == 5);
+  CHECK(json_writer::unescaped_prefix_length("\xe2\x9c\x93\xe2\x9c\x93\xe2\x9c\x93\n") == 9);
+}
+
+TEST_CASE("json_writer writes nested structures with separators", "[nostr][json_writer]")
+{
+  std::vector<std::byte> bytes;
+  radix_relay::nostr::protocol::json_writer writer(bytes);
+  writer.begin_object()
+    .key("numbers")
+    .begin_array()
+    .value(std::uint64_t{ 0 })
+    .value(std::numeric_limits<std::uint64_t>::max())
+    .end_array()
+    .key("empty")
+    .begin_object()
+    .end_object()
+    .key("raw")
+    .raw(R"({"a":[1,2]})")
+    .end_object();
+
+  CHECK(to_string(bytes) == R"({"numbers":[0,18446744073709551615],"empty":{},"raw":{"a":[1,2]}})");
+}
+
+TEST_CASE("json_writer rejects unbalanced and overly deep output", "[nostr][json_writer]")
+{
+  std::vector<std::byte> bytes;
+  radix_relay::nostr::protocol::json_writer writer(bytes);
+  CHECK_THROWS_AS(writer.end_array(), std::logic_error);
+
+  for (std::size_t depth = 0; depth < radix_relay::nostr::protocol::json_writer::max_depth; ++depth) {
+    writer.begin_array();
+  }
+  CHECK_THROWS_AS(writer.begin_array(), std::length_error);
+}
+
+TEST_CASE("write_event_frame produces a client EVENT frame", "[nostr][json_writer]")
+{
+  const auto event = sample_event();
+  std::vector<std::byte> bytes;
+  radix_relay::nostr::protocol::write_event_frame(bytes, event);
+
+  const auto frame = to_string(bytes);
+  CHECK(frame.starts_with(R"(["EVENT",{"id":"4376c65d)"));
+
+  const auto parsed = nlohmann::json::parse(frame);
+  REQUIRE(parsed.size() == 2);
+  CHECK(parsed[1]["pubkey"] == event.pubkey);
+  CHECK(parsed[1]["created_at"] == event.created_at);
+  CHECK(parsed[1]["kind"] == 1);
+  CHECK(parsed[1]["tags"] == nlohmann::json(event.tags));
+  CHECK(parsed[1]["content"] == event.content);
+  CHECK(parsed[1]["sig"] == event.sig);
+}
+
+TEST_CASE("write_req_frame writes typed filters", "[nostr][json_writer]")
+{
+  using radix_relay::nostr::protocol::filter;
+  using radix_relay::nostr::protocol::kind;
+
+  std::vector<std::byte> bytes;
+  radix_relay::nostr::protocol::write_req_frame(bytes,
+    "sub-1",
+    filter{ .authors = { "abc" },
+      .kinds = { kind::bundle_announcement },
+      .tags = { { 'd', { "radix_prekey_bundle_v1" } } },
+      .since = 100,
+      .limit = 50 });
+
+  CHECK(to_string(bytes)
+        == R"(["REQ","sub-1",{"authors":["abc"],"kinds":[30078],"#d":["radix_prekey_bundle_v1"],"since":100,"limit":50}])");
+
+  const std::vector<filter> filters{ filter{ .kinds = { kind::encrypted_message } }, filter{ .ids = { "e1" } } };
+  bytes.clear();
+  radix_relay::nostr::protocol::write_req_frame(bytes, "sub-2", filters);
+  CHECK(to_string(bytes) == R"(["REQ","sub-2",{"kinds":[40001]},{"ids":["e1"]}])");
+}
+
+TEST_CASE("write_close_frame writes a CLOSE frame", "[nostr][json_writer]")
+{
+  std::vector<std::byte> bytes;
+  radix_relay::nostr::protocol::write_close_frame(bytes, "sub-1");
+  CHECK(to_string(bytes) == R"(["CLOSE","sub-1"])");
+}
+
+TEST_CASE("write_event_id_preimage follows NIP-01 canonical order", "[nostr][json_writer]")
+{
+  std::vector<std::byte> bytes;
+  radix_relay::nostr::protocol::write_event_id_preimage(bytes, sample_event());
+
+  CHECK(to_string(bytes)
+        == R"([0,"6e468422dfb74a5738702a8823b9b28168abab8655faacb6853cd0ee15deee93",1673347337,1,)"
+           R"([["e","3da979448d9ba263864c4d6f14984c423a3838364ec255f03c7904b1ae77f206"],["p","bf2376e1"]],)"
+           R"("Walled gardens became prisons,\nand \"nostr\" is the first step"])");
+}
+
+TEST_CASE("json_writer appends to existing buffer contents", "[nostr][json_writer]")
+{
+  std::vector<std::byte> bytes;
+  radix_relay::nostr::protocol::write_close_frame(bytes, "first");
+  const auto first_size = bytes.size();
+  radix_relay::nostr::protocol::write_close_frame(bytes, "second");
+
+  CHECK(to_string(bytes) == R"(["CLOSE","first"]["CLOSE","second"])");
+  CHECK(bytes.size() > first_size);
+}
+
+TEST_CASE("scratch_buffer is handed out empty and keeps its capacity", "[nostr][json_writer]")
+{
+  auto &first = radix_relay::nostr::protocol::scratch_buffer();
+  radix_relay::nostr::protocol::write_event_frame(first, sample_event());
+  const auto *const data = first.data();
+  const auto capacity = first.capacity();
+
+  auto &second = radix_relay::nostr::protocol::scratch_buffer();
+  CHECK(&second == &first);
+  CHECK(second.empty());
+  CHECK(second.capacity() == capacity);
+
+  radix_relay::nostr::protocol::write_close_frame(second, "sub");
+  CHECK(to_string(second) == R"(["CLOSE","sub"])");
+  CHECK(second.data() == data);
+}
+
+TEST_CASE("scratch_buffer releases an oversized allocation", "[nostr][json_writer]")
+{
+  auto &buffer = radix_relay::nostr::protocol::scratch_buffer();
+  buffer.resize(radix_relay::nostr::protocol::max_retained_scratch_capacity + 1);
+
+  CHECK(radix_relay::nostr::protocol::scratch_buffer().capacity()
+        <= radix_relay::nostr::protocol::max_retained_scratch_capacity);
+}
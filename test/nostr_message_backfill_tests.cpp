@@ -0,0 +1,106 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <nostr/message_backfill.hpp>
+#include <nostr/protocol.hpp>
+#include <string>
+#include <vector>
+
+using radix_relay::nostr::message_backfill;
+using radix_relay::nostr::protocol::filter;
+using radix_relay::nostr::protocol::kind;
+
+namespace {
+
+auto messages_since(std::uint64_t since) -> filter
+{
+  return filter{ .kinds = { kind::encrypted_message }, .tags = { { 'p', { "me" } } }, .since = since };
+}
+
+auto groups_since(std::uint64_t since) -> filter
+{
+  return filter{ .kinds = { kind::group_message }, .tags = { { 'g', { "friends" } } }, .since = since };
+}
+
+}// namespace
+
+TEST_CASE("message_backfill pages backwards from the newest events", "[nostr][backfill]")
+{
+  message_backfill backfill({ messages_since(100) }, 1000, 3);
+
+  auto page = backfill.page_filter();
+  CHECK(page.until == 1000);
+  CHECK(page.limit == 3);
+  CHECK(page.since == 100);
+  CHECK(page.tags == messages_since(100).tags);
+
+  CHECK(backfill.record_event("e9", 900));
+  CHECK(backfill.record_event("e8", 800));
+  CHECK(backfill.record_event("e7", 700));
+  REQUIRE(backfill.finish_page());
+  CHECK(backfill.page_filter().until == 700);
+
+  CHECK_FALSE(backfill.record_event("e7", 700));
+  CHECK(backfill.record_event("e6", 600));
+  CHECK_FALSE(backfill.finish_page());
+
+  CHECK(backfill.complete());
+  CHECK(backfill.pages() == 2);
+  CHECK(backfill.messages() == 4);
+}
+
+TEST_CASE("message_backfill retries a page without counting its events twice", "[nostr][backfill]")
+{
+  message_backfill backfill({ messages_since(100) }, 1000, 2);
+
+  CHECK(backfill.record_event("e9", 900));
+  backfill.retry_page();
+  CHECK(backfill.page_filter().until == 1000);
+
+  CHECK_FALSE(backfill.record_event("e9", 900));
+  CHECK(backfill.record_event("e8", 800));
+  REQUIRE(backfill.finish_page());
+  CHECK(backfill.page_filter().until == 800);
+  CHECK(backfill.pages() == 1);
+  CHECK(backfill.messages() == 2);
+}
+
+TEST_CASE("message_backfill walks each filter in turn", "[nostr][backfill]")
+{
+  message_backfill backfill({ messages_since(100), groups_since(200) }, 1000, 2);
+  CHECK(backfill.since() == 100);
+
+  CHECK_FALSE(backfill.page_filter().kinds.empty());
+  CHECK(backfill.page_filter().kinds[0] == kind::encrypted_message);
+  CHECK(backfill.record_event("e1", 500));
+  REQUIRE(backfill.finish_page());
+
+  const auto page = backfill.page_filter();
+  CHECK(page.kinds[0] == kind::group_message);
+  CHECK(page.until == 1000);
+  CHECK_FALSE(backfill.finish_page());
+}
+
+TEST_CASE("message_backfill steps past a second holding a full page", "[nostr][backfill]")
+{
+  message_backfill backfill({ messages_since(100) }, 1000, 2);
+
+  CHECK(backfill.record_event("e1", 1000));
+  CHECK(backfill.record_event("e2", 1000));
+  REQUIRE(backfill.finish_page());
+  CHECK(backfill.page_filter().until == 999);
+
+  CHECK(backfill.record_event("e0", 999));
+  CHECK_FALSE(backfill.finish_page());
+}
+
+TEST_CASE("message_backfill adds only new filters", "[nostr][backfill]")
+{
+  message_backfill backfill({ messages_since(100) }, 1000, 2);
+
+  backfill.add_filters({ messages_since(100), groups_since(100) });
+  REQUIRE(backfill.finish_page());
+  CHECK(backfill.page_filter().kinds[0] == kind::group_message);
+  CHECK_FALSE(backfill.finish_page());
+  CHECK(backfill.pages() == 2);
+  CHECK(backfill.messages() == 0);
+}
@@ -1,9 +1,11 @@
+#include "test_doubles/test_double_signal_bridge.hpp"
 #include <bit>
 #include <catch2/catch_test_macros.hpp>
 #include <filesystem>
 #include <nlohmann/json.hpp>
 #include <nostr/message_handler.hpp>
 #include <signal/signal_bridge.hpp>
+#include <stdexcept>
 
 TEST_CASE("message_handler handles incoming encrypted_message", "[message_handler]")
 {
@@ -68,6 +70,371 @@ TEST_CASE("message_handler handles incoming encrypted_message", "[message_handle
   std::filesystem::remove(bob_path);
 }
 
+TEST_CASE("message_handler tracks last message timestamp in memory until flushed", "[message_handler][since]")
+{
+  auto bridge = std::make_shared<radix_relay_test::test_double_signal_bridge>();
+  radix_relay::nostr::message_handler<radix_relay_test::test_double_signal_bridge> handler(bridge);
+
+  constexpr std::uint64_t newest_timestamp = 1700000100;
+  constexpr std::uint64_t older_timestamp = 1700000000;
+
+  for (const auto created_at : { newest_timestamp, older_timestamp }) {
+    radix_relay::nostr::protocol::event_data event_data;
+    event_data.id = "event_" + std::to_string(created_at);
+    event_data.pubkey = "sender_pubkey";
+    event_data.created_at = created_at;
+    event_data.kind = radix_relay::nostr::protocol::kind::encrypted_message;
+    event_data.content = "6869";
+    event_data.sig = "signature";
+    std::ignore = handler.handle(radix_relay::nostr::events::incoming::encrypted_message{ event_data });
+  }
+
+  CHECK_FALSE(bridge->was_called("update_last_message_timestamp"));
+  CHECK(handler.has_pending_message_timestamp());
+
+  CHECK(handler.flush_last_message_timestamp());
+  CHECK(bridge->call_count("update_last_message_timestamp") == 1);
+  CHECK(bridge->last_message_timestamp == newest_timestamp);
+
+  CHECK_FALSE(handler.has_pending_message_timestamp());
+  CHECK_FALSE(handler.flush_last_message_timestamp());
+  CHECK(bridge->call_count("update_last_message_timestamp") == 1);
+}
+
+TEST_CASE("message_handler holds the persisted timestamp at its ceiling", "[message_handler][since]")
+{
+  auto bridge = std::make_shared<radix_relay_test::test_double_signal_bridge>();
+  radix_relay::nostr::message_handler<radix_relay_test::test_double_signal_bridge> handler(bridge);
+
+  constexpr std::uint64_t ceiling = 1700000000;
+  constexpr std::uint64_t newest_timestamp = 1700000100;
+
+  handler.set_message_timestamp_ceiling(ceiling);
+
+  radix_relay::nostr::protocol::event_data event_data;
+  event_data.id = "event_id";
+  event_data.pubkey = "sender_pubkey";
+  event_data.created_at = newest_timestamp;
+  event_data.kind = radix_relay::nostr::protocol::kind::encrypted_message;
+  event_data.content = "6869";
+  event_data.sig = "signature";
+  std::ignore = handler.handle(radix_relay::nostr::events::incoming::encrypted_message{ event_data });
+
+  CHECK(handler.flush_last_message_timestamp());
+  CHECK(bridge->last_message_timestamp == ceiling);
+  CHECK_FALSE(handler.has_pending_message_timestamp());
+
+  handler.set_message_timestamp_ceiling(std::nullopt);
+  CHECK(handler.flush_last_message_timestamp());
+  CHECK(bridge->last_message_timestamp == newest_timestamp);
+}
+
+TEST_CASE("message_handler decodes content in the encoding declared by radix_version", "[message_handler][encoding]")
+{
+  auto bridge = std::make_shared<radix_relay_test::test_double_signal_bridge>();
+  radix_relay::nostr::message_handler<radix_relay_test::test_double_signal_bridge> handler(bridge);
+
+  radix_relay::nostr::protocol::event_data event_data;
+  event_data.id = "event_id";
+  event_data.pubkey = "sender_pubkey";
+  event_data.created_at = 1700000000;
+  event_data.kind = radix_relay::nostr::protocol::kind::encrypted_message;
+  event_data.sig = "signature";
+
+  SECTION("base64 when the tag carries the marker")
+  {
+    event_data.content = "aGk=";
+    event_data.tags.push_back({ "radix_version", "0.4.0", "base64" });
+    auto result = handler.handle(radix_relay::nostr::events::incoming::encrypted_message{ event_data });
+    REQUIRE(result.has_value());
+    CHECK(result->content == "hi");
+  }
+
+  SECTION("hex from peers without the marker")
+  {
+    event_data.content = "6869";
+    event_data.tags.push_back({ "radix_version", "0.4.0" });
+    auto result = handler.handle(radix_relay::nostr::events::incoming::encrypted_message{ event_data });
+    REQUIRE(result.has_value());
+    CHECK(result->content == "hi");
+  }
+
+  SECTION("malformed content is dropped before decryption")
+  {
+    event_data.content = "not hex";
+    auto result = handler.handle(radix_relay::nostr::events::incoming::encrypted_message{ event_data });
+    CHECK_FALSE(result.has_value());
+    CHECK_FALSE(bridge->was_called("decrypt_message"));
+  }
+}
+
+TEST_CASE("message_handler passes the sender's compression capability to the bridge", "[message_handler][compression]")
+{
+  auto bridge = std::make_shared<radix_relay_test::test_double_signal_bridge>();
+  radix_relay::nostr::message_handler<radix_relay_test::test_double_signal_bridge> handler(bridge);
+
+  radix_relay::nostr::protocol::event_data event_data;
+  event_data.id = "event_id";
+  event_data.pubkey = "sender_pubkey";
+  event_data.created_at = 1700000000;
+  event_data.kind = radix_relay::nostr::protocol::kind::encrypted_message;
+  event_data.content = "aGk=";
+  event_data.sig = "signature";
+  event_data.tags.push_back({ "radix_version", "0.4.0", "base64" });
+
+  SECTION("records peers that advertise zstd")
+  {
+    event_data.tags.push_back({ "radix_compression", "zstd" });
+    REQUIRE(handler.handle(radix_relay::nostr::events::incoming::encrypted_message{ event_data }).has_value());
+    CHECK(bridge->compression_peer == "RDX:test_contact");
+    CHECK(bridge->compression_supported);
+  }
+
+  SECTION("clears peers that stop advertising it")
+  {
+    bridge->compression_supported = true;
+    REQUIRE(handler.handle(radix_relay::nostr::events::incoming::encrypted_message{ event_data }).has_value());
+    CHECK(bridge->was_called("record_peer_compression"));
+    CHECK_FALSE(bridge->compression_supported);
+  }
+}
+
+TEST_CASE("message_handler passes the sender's base64 capability to the bridge", "[message_handler][encoding]")
+{
+  auto bridge = std::make_shared<radix_relay_test::test_double_signal_bridge>();
+  radix_relay::nostr::message_handler<radix_relay_test::test_double_signal_bridge> handler(bridge);
+
+  radix_relay::nostr::protocol::event_data event_data;
+  event_data.id = "event_id";
+  event_data.pubkey = "sender_pubkey";
+  event_data.created_at = 1700000000;
+  event_data.kind = radix_relay::nostr::protocol::kind::encrypted_message;
+  event_data.sig = "signature";
+
+  SECTION("records peers that send base64")
+  {
+    event_data.content = "aGk=";
+    event_data.tags.push_back({ "radix_version", "0.4.0", "base64" });
+    REQUIRE(handler.handle(radix_relay::nostr::events::incoming::encrypted_message{ event_data }).has_value());
+    CHECK(bridge->base64_content_peer == "RDX:test_contact");
+    CHECK(bridge->base64_content_supported);
+  }
+
+  SECTION("records hex senders that list base64 as accepted")
+  {
+    event_data.content = "6869";
+    event_data.tags.push_back({ "radix_version", "0.4.0" });
+    event_data.tags.push_back({ "radix_content_encoding", "base64" });
+    REQUIRE(handler.handle(radix_relay::nostr::events::incoming::encrypted_message{ event_data }).has_value());
+    CHECK(bridge->base64_content_supported);
+  }
+
+  SECTION("clears old peers that send bare hex")
+  {
+    bridge->base64_content_supported = true;
+    event_data.content = "6869";
+    event_data.tags.push_back({ "radix_version", "0.4.0" });
+    REQUIRE(handler.handle(radix_relay::nostr::events::incoming::encrypted_message{ event_data }).has_value());
+    CHECK(bridge->was_called("record_peer_base64_content"));
+    CHECK_FALSE(bridge->base64_content_supported);
+  }
+}
+
+TEST_CASE("message_handler only takes capabilities from the sender's newest message", "[message_handler][compression]")
+{
+  auto bridge = std::make_shared<radix_relay_test::test_double_signal_bridge>();
+  radix_relay::nostr::message_handler<radix_relay_test::test_double_signal_bridge> handler(bridge);
+
+  radix_relay::nostr::protocol::event_data newest;
+  newest.id = "newest";
+  newest.pubkey = "sender_pubkey";
+  newest.created_at = 1700000200;
+  newest.kind = radix_relay::nostr::protocol::kind::encrypted_message;
+  newest.content = "aGk=";
+  newest.sig = "signature";
+  newest.tags.push_back({ "radix_version", "0.4.0", "base64" });
+  newest.tags.push_back({ "radix_compression", "zstd" });
+  REQUIRE(handler.handle(radix_relay::nostr::events::incoming::encrypted_message{ newest }).has_value());
+  REQUIRE(bridge->compression_supported);
+  REQUIRE(bridge->base64_content_supported);
+
+  SECTION("an older message from the backfill leaves them alone")
+  {
+    auto older = newest;
+    older.id = "older";
+    older.created_at = 1700000100;
+    older.content = "6869";
+    older.tags = { { "radix_version", "0.3.0" } };
+    REQUIRE(handler.handle(radix_relay::nostr::events::incoming::encrypted_message{ older }).has_value());
+    CHECK(bridge->compression_supported);
+    CHECK(bridge->base64_content_supported);
+    CHECK(bridge->call_count("record_peer_compression") == 1);
+  }
+
+  SECTION("a newer message with the same capabilities is not passed on again")
+  {
+    auto next = newest;
+    next.id = "next";
+    next.created_at = 1700000300;
+    REQUIRE(handler.handle(radix_relay::nostr::events::incoming::encrypted_message{ next }).has_value());
+    CHECK(bridge->call_count("record_peer_compression") == 1);
+    CHECK(bridge->call_count("record_peer_base64_content") == 1);
+  }
+
+  SECTION("a newer message that drops one is passed on")
+  {
+    auto next = newest;
+    next.id = "next";
+    next.created_at = 1700000300;
+    next.tags.pop_back();
+    REQUIRE(handler.handle(radix_relay::nostr::events::incoming::encrypted_message{ next }).has_value());
+    CHECK_FALSE(bridge->compression_supported);
+    CHECK(bridge->call_count("record_peer_base64_content") == 1);
+  }
+}
+
+TEST_CASE("message_handler handles incoming sender_key_distribution", "[message_handler][group]")
+{
+  auto bridge = std::make_shared<radix_relay_test::test_double_signal_bridge>();
+  radix_relay::nostr::message_handler<radix_relay_test::test_double_signal_bridge> handler(bridge);
+
+  radix_relay::nostr::protocol::event_data event_data;
+  event_data.id = "event_id";
+  event_data.pubkey = "sender_pubkey";
+  event_data.created_at = 1700000000;
+  event_data.kind = radix_relay::nostr::protocol::kind::sender_key_distribution;
+  event_data.content = "aGk=";
+  event_data.sig = "signature";
+  event_data.tags.push_back({ "radix_version", "0.4.0", "base64" });
+
+  auto result = handler.handle(radix_relay::nostr::events::incoming::sender_key_distribution{ event_data });
+
+  REQUIRE(result.has_value());
+  CHECK(bridge->was_called("process_sender_key_distribution"));
+  CHECK(result->group_id == "test_group_id");
+  CHECK(result->name == "test_group");
+  CHECK(result->sender_rdx == "RDX:sender");
+  CHECK(handler.has_pending_message_timestamp());
+}
+
+TEST_CASE("message_handler handles incoming group_message", "[message_handler][group]")
+{
+  auto bridge = std::make_shared<radix_relay_test::test_double_signal_bridge>();
+  bridge->contacts_to_return.push_back(radix_relay::core::contact_info{ .rdx_fingerprint = "RDX:sender",
+    .nostr_pubkey = "sender_pubkey",
+    .user_alias = "carol",
+    .has_active_session = true });
+  radix_relay::nostr::message_handler<radix_relay_test::test_double_signal_bridge> handler(bridge);
+
+  radix_relay::nostr::protocol::event_data event_data;
+  event_data.id = "event_id";
+  event_data.pubkey = "sender_pubkey";
+  event_data.created_at = 1700000000;
+  event_data.kind = radix_relay::nostr::protocol::kind::group_message;
+  event_data.content = "aGk=";
+  event_data.sig = "signature";
+  event_data.tags.push_back({ "radix_version", "0.4.0", "base64" });
+
+  SECTION("decrypts with the group from the g tag")
+  {
+    event_data.tags.push_back({ "g", "test_group_id" });
+    auto result = handler.handle(radix_relay::nostr::events::incoming::group_message{ event_data });
+    REQUIRE(result.has_value());
+    CHECK(result->group_id == "test_group_id");
+    CHECK(result->group_name == "test_group");
+    CHECK(result->sender_alias == "carol");
+    CHECK(result->content == "hi");
+    CHECK(result->timestamp == 1700000000);
+  }
+
+  SECTION("messages without a g tag are dropped before decryption")
+  {
+    auto result = handler.handle(radix_relay::nostr::events::incoming::group_message{ event_data });
+    CHECK_FALSE(result.has_value());
+    CHECK_FALSE(bridge->was_called("decrypt_group_message"));
+  }
+}
+
+TEST_CASE("message_handler encrypts a send_many in one bridge call", "[message_handler][send_many]")
+{
+  auto bridge = std::make_shared<radix_relay_test::test_double_signal_bridge>();
+  radix_relay::nostr::message_handler<radix_relay_test::test_double_signal_bridge> handler(bridge);
+  bridge->unreachable_peers = { "mallory" };
+
+  auto frames =
+    handler.handle(radix_relay::core::events::send_many{ .peers = { "alice", "mallory", "bob" }, .message = "hi" });
+
+  REQUIRE(frames.size() == 3);
+  CHECK(frames[0].event_id == "test_message_event_id_alice");
+  CHECK(frames[1].bytes.empty());
+  CHECK_FALSE(frames[1].error.empty());
+  CHECK(frames[2].recipient == "bob");
+  CHECK(bridge->call_count("create_encrypted_message_frames") == 1);
+  CHECK(bridge->call_count("encrypt_message") == 0);
+}
+
+TEST_CASE("message_handler writes received file chunks through the bridge", "[message_handler][file_transfer]")
+{
+  auto bridge = std::make_shared<radix_relay_test::test_double_signal_bridge>();
+  radix_relay::nostr::message_handler<radix_relay_test::test_double_signal_bridge> handler(bridge);
+
+  radix_relay::nostr::protocol::event_data event_data;
+  event_data.id = "chunk_event";
+  event_data.pubkey = "sender_pubkey";
+  event_data.created_at = 1700000000;
+  event_data.kind = radix_relay::nostr::protocol::kind::file_chunk;
+  event_data.content = "aGk=";
+  event_data.sig = "signature";
+  event_data.tags.push_back({ "radix_version", "0.4.0", "base64" });
+
+  SECTION("a decodable chunk reports transfer progress")
+  {
+    auto progress = handler.handle(radix_relay::nostr::events::incoming::file_chunk{ event_data });
+
+    REQUIRE(progress.has_value());
+    CHECK(bridge->was_called("process_transfer_chunk"));
+    CHECK(progress->name == "notes.txt");
+    CHECK(progress->chunks_done == 1);
+    CHECK(progress->chunk_count == 3);
+    CHECK_FALSE(progress->outgoing);
+    CHECK(handler.has_pending_message_timestamp());
+  }
+
+  SECTION("malformed content is dropped before decryption")
+  {
+    event_data.content = "aGk*";
+
+    auto progress = handler.handle(radix_relay::nostr::events::incoming::file_chunk{ event_data });
+
+    CHECK_FALSE(progress.has_value());
+    CHECK_FALSE(bridge->was_called("process_transfer_chunk"));
+  }
+}
+
+TEST_CASE("message_handler sends pending sender keys ahead of a broadcast", "[message_handler][group]")
+{
+  auto bridge = std::make_shared<radix_relay_test::test_double_signal_bridge>();
+  radix_relay::nostr::message_handler<radix_relay_test::test_double_signal_bridge> handler(bridge);
+  bridge->members_awaiting_sender_key = { "RDX:bob", "RDX:carol" };
+
+  auto first = handler.handle(radix_relay::core::events::broadcast{ .group = "friends", .message = "hi all" });
+  CHECK(first.distribution_frames.size() == 2);
+  CHECK(first.event_id == "test_group_event_id");
+  CHECK_FALSE(first.bytes.empty());
+
+  CHECK(first.distribution_frames[0].recipient == "RDX:bob");
+
+  // Until a relay accepts a distribution, every broadcast sends it again
+  auto second = handler.handle(radix_relay::core::events::broadcast{ .group = "friends", .message = "hi again" });
+  CHECK(second.distribution_frames.size() == 2);
+
+  bridge->mark_sender_key_delivered("friends", "RDX:bob");
+  auto third = handler.handle(radix_relay::core::events::broadcast{ .group = "friends", .message = "hi once more" });
+  REQUIRE(third.distribution_frames.size() == 1);
+  CHECK(third.distribution_frames[0].recipient == "RDX:carol");
+  CHECK(bridge->call_count("create_group_message_frame") == 3);
+}
+
 TEST_CASE("message_handler handles incoming bundle_announcement without establishing session", "[message_handler]")
 {
   const std::string alice_path = "/tmp/nostr_handler_bundle_alice.db";
@@ -279,6 +646,83 @@ TEST_CASE("message_handler handles publish_identity command", "[message_handler]
   std::filesystem::remove(alice_path);
 }
 
+TEST_CASE("message_handler reuses signed bundle while keys are unchanged", "[message_handler]")
+{
+  const std::string alice_path = "/tmp/nostr_handler_publish_cache_alice.db";
+  std::filesystem::remove(alice_path);
+
+  {
+    auto alice_bridge = std::make_shared<radix_relay::signal::bridge>(alice_path);
+
+    radix_relay::nostr::message_handler<radix_relay::signal::bridge> handler(alice_bridge);
+    auto first = handler.handle(radix_relay::core::events::publish_identity{});
+    auto second = handler.handle(radix_relay::core::events::publish_identity{});
+
+    CHECK(first.event_id == second.event_id);
+    CHECK(first.bytes == second.bytes);
+    CHECK(first.pre_key_id == second.pre_key_id);
+    CHECK(first.signed_pre_key_id == second.signed_pre_key_id);
+    CHECK(first.kyber_pre_key_id == second.kyber_pre_key_id);
+  }
+
+  std::filesystem::remove(alice_path);
+}
+
+TEST_CASE("message_handler mines proof of work into an outgoing event", "[message_handler][pow]")
+{
+  const std::string alice_path = "/tmp/nostr_handler_pow_alice.db";
+  std::filesystem::remove(alice_path);
+
+  {
+    auto alice_bridge = std::make_shared<radix_relay::signal::bridge>(alice_path);
+    radix_relay::nostr::message_handler<radix_relay::signal::bridge> handler(alice_bridge);
+    auto published = handler.handle(radix_relay::core::events::publish_identity{});
+
+    auto [event_id, bytes] = handler.add_proof_of_work(
+      { published.event_id, published.bytes }, 8, { .threads = 1, .max_hashes_per_thread = 0 }, {});
+
+    auto parse_event = [](const std::vector<std::byte> &frame) {
+      std::string json_str(frame.size(), '\0');
+      std::ranges::transform(frame, json_str.begin(), [](std::byte byte) { return std::bit_cast<char>(byte); });
+      return nlohmann::json::parse(json_str).at(1);
+    };
+    auto event = parse_event(bytes);
+    auto original = parse_event(published.bytes);
+
+    CHECK(event_id.starts_with("00"));
+    CHECK(event["id"] == event_id);
+    CHECK(event["content"] == original["content"]);
+    CHECK(event["created_at"] == original["created_at"]);
+    CHECK(event["tags"].size() == original["tags"].size() + 1);
+    CHECK(event["tags"].back()[0] == "nonce");
+    CHECK(event["tags"].back()[2] == "8");
+  }
+
+  std::filesystem::remove(alice_path);
+}
+
+TEST_CASE("message_handler keeps the event when no nonce is found", "[message_handler][pow]")
+{
+  auto bridge = std::make_shared<radix_relay_test::test_double_signal_bridge>();
+  radix_relay::nostr::message_handler<radix_relay_test::test_double_signal_bridge> handler(bridge);
+  auto frame = handler.handle(radix_relay::core::events::send{ .peer = "RDX:alice", .message = "hi" });
+
+  auto result = handler.add_proof_of_work(frame, 255, { .threads = 1, .max_hashes_per_thread = 1000 }, {});
+
+  CHECK(result == frame);
+  CHECK_FALSE(bridge->was_called("sign_event_frame"));
+}
+
+TEST_CASE("message_handler fails when the signed event is not the mined one", "[message_handler][pow]")
+{
+  auto bridge = std::make_shared<radix_relay_test::test_double_signal_bridge>();
+  radix_relay::nostr::message_handler<radix_relay_test::test_double_signal_bridge> handler(bridge);
+  auto frame = handler.handle(radix_relay::core::events::send{ .peer = "RDX:alice", .message = "hi" });
+
+  CHECK_THROWS_AS(handler.add_proof_of_work(frame, 1, { .threads = 1 }, {}), std::runtime_error);
+  CHECK(bridge->was_called("sign_event_frame"));
+}
+
 TEST_CASE("message_handler handles establish_session command", "[message_handler]")
 {
   const std::string alice_path = "/tmp/nostr_handler_establish_alice.db";
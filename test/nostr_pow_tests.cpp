@@ -0,0 +1,120 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <nostr/pow.hpp>
+#include <nostr/sha256.hpp>
+#include <span>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+using radix_relay::nostr::sha256;
+using radix_relay::nostr::sha256_backend;
+using radix_relay::nostr::sha256_digest;
+using radix_relay::nostr::sha256_hex;
+
+namespace {
+
+auto digest_of(const std::string &input, sha256_backend backend) -> sha256_digest
+{
+  return sha256(std::span(reinterpret_cast<const std::uint8_t *>(input.data()), input.size()), backend);// NOLINT
+}
+
+auto available_backends() -> std::vector<sha256_backend>
+{
+  std::vector<sha256_backend> backends{ sha256_backend::scalar };
+  if (radix_relay::nostr::detected_sha256_backend() == sha256_backend::sha_ni) {
+    backends.push_back(sha256_backend::sha_ni);
+  }
+  return backends;
+}
+
+}// namespace
+
+TEST_CASE("sha256 matches the FIPS 180-2 test vectors", "[nostr][pow][sha256]")
+{
+  for (const auto backend : available_backends()) {
+    CHECK(sha256_hex(digest_of("", backend)) == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    CHECK(sha256_hex(digest_of("abc", backend)) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    CHECK(sha256_hex(digest_of("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", backend))
+          == "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+  }
+}
+
+TEST_CASE("sha256 backends agree across block boundaries", "[nostr][pow][sha256]")
+{
+  std::string input;
+  for (std::size_t length = 0; length < 300; ++length) {
+    const auto expected = digest_of(input, sha256_backend::scalar);
+    for (const auto backend : available_backends()) { CHECK(digest_of(input, backend) == expected); }
+    input += static_cast<char>('a' + (length % 26));
+  }
+}
+
+TEST_CASE("leading_zero_bits counts NIP-13 difficulty", "[nostr][pow]")
+{
+  using radix_relay::nostr::pow::leading_zero_bits;
+
+  sha256_digest digest{};
+  CHECK(leading_zero_bits(digest) == 256);
+
+  digest[0] = 0x80;
+  CHECK(leading_zero_bits(digest) == 0);
+
+  digest[0] = 0x00;
+  digest[1] = 0x0F;
+  CHECK(leading_zero_bits(digest) == 12);
+
+  digest[1] = 0x00;
+  digest[4] = 0x01;
+  CHECK(leading_zero_bits(digest) == 39);
+}
+
+TEST_CASE("make_event_template splits the NIP-01 serialization around the nonce", "[nostr][pow]")
+{
+  using radix_relay::nostr::pow::make_event_template;
+
+  const auto event = make_event_template("ab12", 1700000000, 40001, { { "p", "cd" } }, "hi \"there\"", 21);
+
+  CHECK(event.prefix == R"([0,"ab12",1700000000,40001,[["p","cd"],["nonce",")");
+  CHECK(event.suffix == R"(","21"]],"hi \"there\""])");
+  CHECK_THROWS_AS(make_event_template("ab12", 0, 1, {}, "", 256), std::invalid_argument);
+}
+
+TEST_CASE("mine finds a nonce that meets the target", "[nostr][pow]")
+{
+  namespace pow = radix_relay::nostr::pow;
+
+  const auto event = pow::make_event_template("ab12", 1700000000, 40001, { { "p", "cd" } }, "aGk=", 12);
+
+  for (const auto backend : available_backends()) {
+    const auto result = pow::mine(event, 12, { .threads = 2, .max_hashes_per_thread = 0, .backend = backend }, {});
+
+    REQUIRE(result.has_value());
+    CHECK(result->difficulty >= 12);
+    CHECK(result->hashes > 0);
+
+    const auto digest = digest_of(event.prefix + result->nonce + event.suffix, sha256_backend::scalar);
+    CHECK(sha256_hex(digest) == result->event_id);
+    CHECK(pow::leading_zero_bits(digest) == result->difficulty);
+  }
+}
+
+TEST_CASE("mine gives up when out of attempts or stopped", "[nostr][pow]")
+{
+  namespace pow = radix_relay::nostr::pow;
+
+  const auto event = pow::make_event_template("ab12", 1700000000, 40001, {}, "", pow::max_difficulty);
+
+  SECTION("attempt limit")
+  {
+    CHECK_FALSE(pow::mine(event, pow::max_difficulty, { .threads = 2, .max_hashes_per_thread = 5000 }, {}));
+  }
+
+  SECTION("stop requested")
+  {
+    std::stop_source stop;
+    stop.request_stop();
+    CHECK_FALSE(pow::mine(event, pow::max_difficulty, { .threads = 2 }, stop.get_token()));
+  }
+}
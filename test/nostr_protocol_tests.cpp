@@ -340,3 +340,47 @@ TEST_CASE("protocol::event_data helper methods work correctly", "[nostr][helpers
     CHECK_FALSE(unknown_event.get_kind().has_value());
   }
 }
+
+TEST_CASE("protocol::is_pubkey_hex recognizes hex-encoded public keys", "[nostr][helpers]")
+{
+  using radix_relay::nostr::protocol::is_pubkey_hex;
+
+  CHECK(is_pubkey_hex(std::string(32, 'a') + std::string(32, '9')));
+  CHECK_FALSE(is_pubkey_hex(std::string(63, 'a')));
+  CHECK_FALSE(is_pubkey_hex(std::string(64, 'A')));
+  CHECK_FALSE(is_pubkey_hex("RDX:" + std::string(60, 'a')));
+}
+
+TEST_CASE("protocol::filter can be parsed from JSON", "[nostr][parse]")
+{
+  using radix_relay::nostr::protocol::filter;
+  using radix_relay::nostr::protocol::kind;
+
+  const auto parsed = filter::from_json(
+    nlohmann::json::parse(R"({"kinds":[40001],"#p":["me"],"authors":["bob"],"since":5,"limit":10})"));
+  REQUIRE(parsed.has_value());
+  CHECK(parsed->kinds == std::vector{ kind::encrypted_message });
+  CHECK(parsed->authors == std::vector<std::string>{ "bob" });
+  REQUIRE(parsed->tags.size() == 1);
+  CHECK(parsed->tags[0].first == 'p');
+  CHECK(parsed->since == 5);
+  CHECK(parsed->limit == 10);
+
+  CHECK_FALSE(filter::from_json(nlohmann::json::parse(R"({"search":"hello"})")));
+  CHECK_FALSE(filter::from_json(nlohmann::json::parse(R"({"kinds":[-1]})")));
+  CHECK_FALSE(filter::from_json(nlohmann::json::parse(R"(["kinds"])")));
+}
+
+TEST_CASE("protocol::closed can be parsed from JSON", "[nostr][parse]")
+{
+  using radix_relay::nostr::protocol::closed;
+
+  const auto parsed = closed::deserialize(R"(["CLOSED","sub1","rate-limited: too many subscriptions"])");
+  REQUIRE(parsed.has_value());
+  CHECK(parsed->subscription_id == "sub1");
+  CHECK(parsed->message == "rate-limited: too many subscriptions");
+
+  CHECK(closed::deserialize(R"(["CLOSED","sub1"])").has_value());
+  CHECK_FALSE(closed::deserialize(R"(["EOSE","sub1"])").has_value());
+  CHECK_FALSE(closed::deserialize(R"(["CLOSED",1,""])").has_value());
+}
@@ -0,0 +1,118 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <nostr/relay_health.hpp>
+#include <string>
+#include <vector>
+
+using radix_relay::nostr::relay_health;
+using radix_relay::nostr::relay_latency;
+using std::chrono::milliseconds;
+
+TEST_CASE("relay_health keeps the configured timeout until a relay has enough samples", "[nostr][relay_health]")
+{
+  relay_health health(milliseconds(15000), milliseconds(1000), 3);
+
+  CHECK(health.timeout("wss://fast", relay_latency::ok) == milliseconds(15000));
+  for (std::size_t sample = 1; sample < relay_health::min_samples; ++sample) {
+    health.record("wss://fast", relay_latency::ok, milliseconds(400));
+  }
+  CHECK(health.timeout("wss://fast", relay_latency::ok) == milliseconds(15000));
+
+  health.record("wss://fast", relay_latency::ok, milliseconds(500));
+  CHECK(health.timeout("wss://fast", relay_latency::ok) == milliseconds(1500));
+  CHECK(health.timeout("wss://fast", relay_latency::eose) == milliseconds(15000));
+}
+
+TEST_CASE("relay_health clamps the adapted timeout", "[nostr][relay_health]")
+{
+  relay_health health(milliseconds(15000), milliseconds(1000), 3);
+
+  for (std::size_t sample = 0; sample < relay_health::min_samples; ++sample) {
+    health.record("wss://fast", relay_latency::ok, milliseconds(20));
+    health.record("wss://slow", relay_latency::ok, milliseconds(9000));
+  }
+  CHECK(health.timeout("wss://fast", relay_latency::ok) == milliseconds(1000));
+  CHECK(health.timeout("wss://slow", relay_latency::ok) == milliseconds(15000));
+
+  SECTION("a multiplier of zero keeps the timeout fixed")
+  {
+    relay_health fixed(milliseconds(15000), milliseconds(1000), 0);
+    for (std::size_t sample = 0; sample < relay_health::min_samples; ++sample) {
+      fixed.record("wss://fast", relay_latency::ok, milliseconds(20));
+    }
+    CHECK(fixed.timeout("wss://fast", relay_latency::ok) == milliseconds(15000));
+  }
+}
+
+TEST_CASE("relay_health reports percentiles over the recent window", "[nostr][relay_health]")
+{
+  relay_health health(milliseconds(15000), milliseconds(1000), 3, 4);
+
+  CHECK_FALSE(health.percentile("wss://relay", relay_latency::ok, 50).has_value());
+  for (const auto latency : { 900, 100, 200, 300, 400 }) {
+    health.record("wss://relay", relay_latency::ok, milliseconds(latency));
+  }
+
+  CHECK(health.percentile("wss://relay", relay_latency::ok, 50) == milliseconds(200));
+  CHECK(health.percentile("wss://relay", relay_latency::ok, 99) == milliseconds(400));
+  CHECK(health.percentile("wss://relay", relay_latency::ok, 1) == milliseconds(100));
+}
+
+TEST_CASE("relay_health scores relays by answered share and latency", "[nostr][relay_health]")
+{
+  relay_health health(milliseconds(15000), milliseconds(1000), 3);
+
+  CHECK_FALSE(health.score("wss://relay").has_value());
+
+  health.record("wss://relay", relay_latency::ping, milliseconds(50));
+  CHECK_FALSE(health.score("wss://relay").has_value());
+
+  health.record("wss://relay", relay_latency::ok, milliseconds(0));
+  CHECK(health.score("wss://relay") == 100U);
+
+  health.record_timeout("wss://relay", relay_latency::ok, milliseconds(1000));
+  CHECK(health.score("wss://relay") == 50U);
+
+  health.record_connect_failure("wss://down");
+  CHECK(health.score("wss://down") == 0U);
+
+  const auto stats = health.stats("wss://relay");
+  CHECK(stats.url == "wss://relay");
+  CHECK(stats.score == 50U);
+  CHECK(stats.ok_p50_ms == 0U);
+  CHECK(stats.ok_p99_ms == 1000U);
+  CHECK_FALSE(stats.eose_p50_ms.has_value());
+  CHECK(stats.ping_ms == 50U);
+  CHECK(stats.request_timeout_ms == 15000U);
+  CHECK(stats.timeouts == 1U);
+}
+
+TEST_CASE("relay_health ranks fast healthy relays first", "[nostr][relay_health]")
+{
+  relay_health health(milliseconds(15000), milliseconds(1000), 3);
+
+  health.record("wss://slow", relay_latency::ok, milliseconds(600));
+  health.record("wss://fast", relay_latency::ok, milliseconds(80));
+  health.record_timeout("wss://flaky", relay_latency::ok, milliseconds(15000));
+  health.record_connect_failure("wss://down");
+  health.record("wss://down", relay_latency::ok, milliseconds(100));
+
+  const auto ranked =
+    health.rank({ "wss://down", "wss://flaky", "wss://new", "wss://slow", "wss://other", "wss://fast" });
+  CHECK(ranked == std::vector<std::string>{ "wss://fast", "wss://slow", "wss://new", "wss://other", "wss://down",
+                    "wss://flaky" });
+}
+
+TEST_CASE("relay_health reports connect latency without scoring it", "[nostr][relay_health]")
+{
+  relay_health health(milliseconds(15000), milliseconds(1000), 3);
+
+  health.record("wss://relay", relay_latency::connect, milliseconds(300));
+  health.record("wss://relay", relay_latency::connect, milliseconds(100));
+  CHECK_FALSE(health.score("wss://relay").has_value());
+
+  const auto stats = health.stats("wss://relay");
+  CHECK(stats.connect_p50_ms == 100U);
+  CHECK(stats.connect_p99_ms == 300U);
+  CHECK_FALSE(stats.ok_p50_ms.has_value());
+}
@@ -0,0 +1,58 @@
+#include <catch2/catch_test_macros.hpp>
+#include <nostr/relay_information.hpp>
+
+using radix_relay::nostr::parse_relay_limits;
+
+TEST_CASE("parse_relay_limits reads the advertised limitation", "[nostr][relay_information]")
+{
+  const auto limits = parse_relay_limits(R"({
+    "name": "relay.example",
+    "supported_nips": [1, 11, 13],
+    "limitation": {
+      "max_message_length": 16384,
+      "max_subscriptions": 20,
+      "max_limit": 500,
+      "min_pow_difficulty": 16,
+      "auth_required": false
+    }
+  })");
+
+  REQUIRE(limits.has_value());
+  CHECK(limits->max_message_length == 16384);
+  CHECK(limits->max_subscriptions == 20);
+  CHECK(limits->max_limit == 500);
+  CHECK(limits->min_pow_difficulty == 16);
+}
+
+TEST_CASE("parse_relay_limits leaves unadvertised limits unset", "[nostr][relay_information]")
+{
+  const auto limits = parse_relay_limits(R"({"name": "relay.example"})");
+
+  REQUIRE(limits.has_value());
+  CHECK(*limits == radix_relay::core::events::transport::relay_limits{});
+}
+
+TEST_CASE("parse_relay_limits skips malformed fields", "[nostr][relay_information]")
+{
+  const auto limits = parse_relay_limits(R"({
+    "limitation": {
+      "max_message_length": "large",
+      "max_subscriptions": 0,
+      "max_limit": -1,
+      "min_pow_difficulty": 300
+    }
+  })");
+
+  REQUIRE(limits.has_value());
+  CHECK_FALSE(limits->max_message_length.has_value());
+  CHECK_FALSE(limits->max_subscriptions.has_value());
+  CHECK_FALSE(limits->max_limit.has_value());
+  CHECK_FALSE(limits->min_pow_difficulty.has_value());
+}
+
+TEST_CASE("parse_relay_limits rejects documents that are not JSON objects", "[nostr][relay_information]")
+{
+  CHECK_FALSE(parse_relay_limits("<html>not found</html>").has_value());
+  CHECK_FALSE(parse_relay_limits("[1, 2]").has_value());
+  CHECK_FALSE(parse_relay_limits("").has_value());
+}
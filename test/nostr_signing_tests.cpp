@@ -1,5 +1,6 @@
 #include <catch2/catch_test_macros.hpp>
 #include <filesystem>
+#include <nlohmann/json.hpp>
 #include <nostr/protocol.hpp>
 #include <platform/env_utils.hpp>
 #include <ranges>
@@ -105,4 +106,34 @@ TEST_CASE("Nostr Event Signing via Signal Bridge", "[nostr][signing]")
 
     std::ignore = std::filesystem::remove(db_path);
   }
+
+  SECTION("verify_events accepts signed events and rejects tampered ones")
+  {
+    const auto db_path = std::filesystem::path(radix_relay::platform::get_temp_directory()) / "test_nostr_verify.db";
+
+    {
+      auto signal_bridge = std::make_shared<radix_relay::signal::bridge>(db_path);
+
+      auto event = radix_relay::nostr::protocol::event_data::create_encrypted_message(
+        test_timestamp, "test_recipient", "test_content");
+      auto json_bytes = event.serialize();
+      std::string event_json;
+      event_json.resize(json_bytes.size());
+      std::ranges::transform(
+        json_bytes, event_json.begin(), [](std::byte byte) -> char { return std::bit_cast<char>(byte); });
+
+      auto signed_event = nlohmann::json::parse(signal_bridge->sign_nostr_event(event_json));
+      auto tampered_content = signed_event;
+      tampered_content["content"] = "other_content";
+      auto tampered_id = signed_event;
+      tampered_id["id"] = std::string(64, '0');
+
+      const auto verified =
+        signal_bridge->verify_events({ signed_event.dump(), tampered_content.dump(), tampered_id.dump(), "not json" });
+
+      CHECK(verified == std::vector<bool>{ true, false, false, false });
+    }
+
+    std::ignore = std::filesystem::remove(db_path);
+  }
 }
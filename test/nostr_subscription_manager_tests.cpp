@@ -0,0 +1,176 @@
+#include <catch2/catch_test_macros.hpp>
+#include <nostr/protocol.hpp>
+#include <nostr/subscription_manager.hpp>
+#include <string>
+#include <vector>
+
+using radix_relay::nostr::merge_filters;
+using radix_relay::nostr::subscription_lifetime;
+using radix_relay::nostr::subscription_manager;
+using radix_relay::nostr::protocol::filter;
+using radix_relay::nostr::protocol::kind;
+
+namespace {
+
+auto bundles_by(std::vector<std::string> authors) -> filter
+{
+  return filter{ .authors = std::move(authors), .kinds = { kind::bundle_announcement } };
+}
+
+auto messages_for(const std::string &pubkey) -> filter
+{
+  return filter{ .kinds = { kind::encrypted_message }, .tags = { { 'p', { pubkey } } } };
+}
+
+}// namespace
+
+TEST_CASE("subscription_manager gives each name its own subscription below the limit", "[nostr][subscriptions]")
+{
+  subscription_manager subscriptions(4);
+
+  const auto messages = subscriptions.open("messages", { messages_for("me") }, subscription_lifetime::persistent);
+  REQUIRE(messages.requests.size() == 1);
+  CHECK(messages.closes.empty());
+  CHECK(messages.requests[0].filters == std::vector{ messages_for("me") });
+
+  const auto contacts = subscriptions.open("contacts", { bundles_by({ "bob" }) }, subscription_lifetime::persistent);
+  REQUIRE(contacts.requests.size() == 1);
+  CHECK(contacts.requests[0].subscription_id != messages.requests[0].subscription_id);
+  CHECK(subscriptions.active_count() == 2);
+  CHECK(subscriptions.is_active(messages.requests[0].subscription_id));
+}
+
+TEST_CASE("subscription_manager closes the subscription a name replaces", "[nostr][subscriptions]")
+{
+  subscription_manager subscriptions;
+
+  const auto first = subscriptions.open("contacts", { bundles_by({ "bob" }) }, subscription_lifetime::persistent);
+  const auto second =
+    subscriptions.open("contacts", { bundles_by({ "bob", "carol" }) }, subscription_lifetime::persistent);
+
+  CHECK(second.closes == std::vector{ first.requests[0].subscription_id });
+  REQUIRE(second.requests.size() == 1);
+  CHECK(second.requests[0].filters == std::vector{ bundles_by({ "bob", "carol" }) });
+  CHECK_FALSE(subscriptions.is_active(first.requests[0].subscription_id));
+  CHECK(subscriptions.active_count() == 1);
+
+  const auto closed = subscriptions.close("contacts");
+  CHECK(closed.closes == std::vector{ second.requests[0].subscription_id });
+  CHECK(closed.requests.empty());
+  CHECK(subscriptions.active_count() == 0);
+  CHECK(subscriptions.close("contacts").closes.empty());
+}
+
+TEST_CASE("subscription_manager merges persistent subscriptions at the limit", "[nostr][subscriptions]")
+{
+  subscription_manager subscriptions(2);
+
+  const auto messages = subscriptions.open("messages", { messages_for("me") }, subscription_lifetime::persistent);
+  const auto contacts = subscriptions.open("contacts", { bundles_by({ "bob" }) }, subscription_lifetime::persistent);
+  CHECK(subscriptions.replay_finished(messages.requests[0].subscription_id).size() == 1);
+  CHECK(subscriptions.replay_finished(contacts.requests[0].subscription_id).size() == 1);
+  const auto merged = subscriptions.open("identities", { bundles_by({ "dave" }) }, subscription_lifetime::persistent);
+
+  REQUIRE(merged.requests.size() == 1);
+  REQUIRE(merged.closes.size() == 1);
+  const auto merged_id = merged.requests[0].subscription_id;
+  CHECK(subscriptions.active_count() == 2);
+  CHECK_FALSE(subscriptions.is_active(merged.closes[0]));
+  CHECK(subscriptions.is_active(merged_id));
+
+  SECTION("filters differing only in authors become one")
+  {
+    const auto contacts_merged = merged.closes[0] == contacts.requests[0].subscription_id;
+    if (contacts_merged) {
+      CHECK(merged.requests[0].filters == std::vector{ bundles_by({ "bob", "dave" }) });
+    } else {
+      CHECK(merged.closes[0] == messages.requests[0].subscription_id);
+      CHECK((merged.requests[0].filters == std::vector{ messages_for("me"), bundles_by({ "dave" }) }));
+    }
+  }
+
+  SECTION("EOSE of the merged subscription finishes only the new name")
+  {
+    const auto finished = subscriptions.replay_finished(merged_id);
+    REQUIRE(finished.size() == 1);
+    CHECK(finished[0].name == "identities");
+    CHECK(subscriptions.replay_finished(merged_id).empty());
+  }
+
+  SECTION("closing one name re-sends the others")
+  {
+    const auto closed = subscriptions.close("identities");
+    CHECK(closed.closes == std::vector{ merged_id });
+    REQUIRE(closed.requests.size() == 1);
+    CHECK(closed.requests[0].filters.size() == 1);
+    CHECK(subscriptions.active_count() == 2);
+  }
+}
+
+TEST_CASE("subscription_manager queues one-shot subscriptions until a slot frees", "[nostr][subscriptions]")
+{
+  subscription_manager subscriptions(1);
+
+  const auto messages = subscriptions.open("messages", { messages_for("me") }, subscription_lifetime::one_shot);
+  const auto fetch = subscriptions.open("fetch", { bundles_by({ "bob" }) }, subscription_lifetime::one_shot);
+  CHECK(fetch.requests.empty());
+  CHECK(fetch.closes.empty());
+  CHECK(subscriptions.waiting_count() == 1);
+  CHECK(subscriptions.contains("fetch"));
+
+  const auto closed = subscriptions.close("messages");
+  CHECK(closed.closes == std::vector{ messages.requests[0].subscription_id });
+  REQUIRE(closed.requests.size() == 1);
+  CHECK(closed.requests[0].filters == std::vector{ bundles_by({ "bob" }) });
+  CHECK(subscriptions.waiting_count() == 0);
+
+  SECTION("a queued name that is closed is never sent")
+  {
+    static_cast<void>(subscriptions.open("later", { bundles_by({ "carol" }) }, subscription_lifetime::one_shot));
+    const auto dropped = subscriptions.close("later");
+    CHECK(dropped.closes.empty());
+    CHECK(dropped.requests.empty());
+    CHECK(subscriptions.waiting_count() == 0);
+  }
+}
+
+TEST_CASE("subscription_manager routes relay messages by subscription ID", "[nostr][subscriptions]")
+{
+  subscription_manager subscriptions;
+
+  const auto opened = subscriptions.open("contacts", { bundles_by({ "bob" }) }, subscription_lifetime::persistent);
+  const auto &subscription_id = opened.requests[0].subscription_id;
+
+  CHECK(subscriptions.record_event(subscription_id));
+  CHECK(subscriptions.record_event(subscription_id));
+  CHECK_FALSE(subscriptions.record_event("unknown"));
+
+  const auto finished = subscriptions.replay_finished(subscription_id);
+  REQUIRE(finished.size() == 1);
+  CHECK(finished[0].events == 2);
+  CHECK(subscriptions.replay_finished("unknown").empty());
+  CHECK(subscriptions.subscription_id("contacts") == subscription_id);
+
+  const auto dropped = subscriptions.closed_by_relay(subscription_id);
+  REQUIRE(dropped.size() == 1);
+  CHECK(dropped[0].name == "contacts");
+  CHECK(dropped[0].filters == std::vector{ bundles_by({ "bob" }) });
+  CHECK_FALSE(subscriptions.contains("contacts"));
+  CHECK(subscriptions.subscription_id("contacts").empty());
+  CHECK(subscriptions.active_count() == 0);
+}
+
+TEST_CASE("merge_filters only combines filters that differ in authors", "[nostr][subscriptions]")
+{
+  CHECK(merge_filters({ bundles_by({ "bob" }), bundles_by({ "carol", "bob" }) })
+        == std::vector{ bundles_by({ "bob", "carol" }) });
+  CHECK(merge_filters({ messages_for("me"), messages_for("me") }) == std::vector{ messages_for("me") });
+
+  auto limited = bundles_by({ "carol" });
+  limited.limit = 1;
+  CHECK(merge_filters({ bundles_by({ "bob" }), limited }).size() == 2);
+
+  auto later = bundles_by({ "carol" });
+  later.since = 100;
+  CHECK(merge_filters({ bundles_by({ "bob" }), later }).size() == 2);
+}
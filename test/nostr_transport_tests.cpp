@@ -6,6 +6,7 @@
 #include <boost/asio.hpp>
 #include <boost/asio/experimental/channel_error.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <chrono>
 #include <memory>
 #include <spdlog/spdlog.h>
 #include <string>
@@ -66,6 +67,158 @@ TEST_CASE("Transport pushes connected event with correct URL after connection",
   CHECK(connected_evt.type == core::events::transport_type::internet);
 }
 
+TEST_CASE("Transport fetches relay limits before connecting and reports them", "[nostr][transport][queue]")
+{
+  auto io_context = std::make_shared<boost::asio::io_context>();
+  auto fake = std::make_shared<radix_relay::test::test_double_websocket_stream>(io_context);
+  fake->set_document(R"({"limitation":{"max_message_length":300000,"max_subscriptions":5,"max_limit":100}})");
+
+  auto in_queue = std::make_shared<async::async_queue<core::events::transport::in_t>>(io_context);
+  auto out_queue = std::make_shared<async::async_queue<core::events::session_orchestrator::in_t>>(io_context);
+
+  transport<radix_relay::test::test_double_websocket_stream> transport(fake, io_context, in_queue, out_queue);
+
+  in_queue->push(core::events::transport::connect{ .url = "wss://relay.damus.io/nostr" });
+  boost::asio::co_spawn(*io_context, transport.run_once(), boost::asio::detached);
+  io_context->run();
+
+  const auto &fetches = fake->get_fetches();
+  REQUIRE(fetches.size() == 1);
+  CHECK(fetches[0].host == "relay.damus.io");
+  CHECK(fetches[0].path == "/nostr");
+  REQUIRE(fake->get_connections().size() == 1);
+
+  io_context->restart();
+  auto future = boost::asio::co_spawn(*io_context, out_queue->pop(), boost::asio::use_future);
+  io_context->run();
+  auto event = future.get();
+
+  REQUIRE(std::holds_alternative<core::events::transport::connected>(event));
+  const auto &limits = std::get<core::events::transport::connected>(event).limits;
+  CHECK(limits.max_message_length == 300000);
+  CHECK(limits.max_subscriptions == 5);
+  CHECK(limits.max_limit == 100);
+  CHECK_FALSE(limits.min_pow_difficulty.has_value());
+
+  SECTION("the read buffer holds a message of the advertised size")
+  {
+    constexpr std::size_t large_message = 200000;
+    const std::vector<std::byte> incoming(large_message, std::byte{ 0x7B });
+    fake->set_read_data(incoming);
+
+    io_context->restart();
+    auto received = boost::asio::co_spawn(*io_context, out_queue->pop(), boost::asio::use_future);
+    io_context->run();
+    auto received_event = received.get();
+
+    REQUIRE(std::holds_alternative<core::events::transport::bytes_received>(received_event));
+    CHECK(std::get<core::events::transport::bytes_received>(received_event).bytes.size() == large_message);
+  }
+}
+
+TEST_CASE("Transport caches relay limits per URL and connects when the fetch fails", "[nostr][transport][queue]")
+{
+  auto io_context = std::make_shared<boost::asio::io_context>();
+  auto fake = std::make_shared<radix_relay::test::test_double_websocket_stream>(io_context);
+  fake->set_fetch_failure(true);
+
+  auto in_queue = std::make_shared<async::async_queue<core::events::transport::in_t>>(io_context);
+  auto out_queue = std::make_shared<async::async_queue<core::events::session_orchestrator::in_t>>(io_context);
+
+  transport<radix_relay::test::test_double_websocket_stream> transport(fake, io_context, in_queue, out_queue);
+
+  in_queue->push(core::events::transport::connect{ .url = "wss://relay.damus.io" });
+  in_queue->push(core::events::transport::disconnect{});
+  in_queue->push(core::events::transport::connect{ .url = "wss://relay.damus.io" });
+  for (auto command = 0; command < 3; ++command) {
+    boost::asio::co_spawn(*io_context, transport.run_once(), boost::asio::detached);
+    io_context->run();
+    io_context->restart();
+  }
+
+  CHECK(fake->get_fetches().size() == 1);
+  CHECK(fake->get_connections().size() == 2);
+
+  auto future = boost::asio::co_spawn(*io_context, out_queue->pop(), boost::asio::use_future);
+  io_context->run();
+  auto event = future.get();
+
+  REQUIRE(std::holds_alternative<core::events::transport::connected>(event));
+  CHECK(std::get<core::events::transport::connected>(event).limits == core::events::transport::relay_limits{});
+}
+
+TEST_CASE("Transport pings the relay while connected and reports round trips", "[nostr][transport][queue]")
+{
+  auto io_context = std::make_shared<boost::asio::io_context>();
+  auto fake = std::make_shared<radix_relay::test::test_double_websocket_stream>(io_context);
+
+  auto in_queue = std::make_shared<async::async_queue<core::events::transport::in_t>>(io_context);
+  auto out_queue = std::make_shared<async::async_queue<core::events::session_orchestrator::in_t>>(io_context);
+
+  static constexpr auto ping_interval = std::chrono::milliseconds(10);
+  transport<radix_relay::test::test_double_websocket_stream> transport(
+    fake, io_context, in_queue, out_queue, ping_interval);
+
+  in_queue->push(core::events::transport::connect{ .url = "wss://relay.damus.io" });
+  boost::asio::co_spawn(*io_context, transport.run_once(), boost::asio::detached);
+  io_context->run_for(std::chrono::milliseconds(100));
+  CHECK(fake->get_ping_count() >= 2);
+
+  // The ping timer is cancelled on disconnect, so run() returns once the close completes
+  in_queue->push(core::events::transport::disconnect{});
+  boost::asio::co_spawn(*io_context, transport.run_once(), boost::asio::detached);
+  io_context->run();
+
+  std::vector<core::events::transport::ping_measured> measured;
+  while (auto event = out_queue->try_pop()) {
+    if (const auto *ping = std::get_if<core::events::transport::ping_measured>(&*event)) { measured.push_back(*ping); }
+  }
+  REQUIRE(measured.size() >= 2);
+  CHECK(measured.size() <= fake->get_ping_count());
+  CHECK(measured[0].url == "wss://relay.damus.io");
+}
+
+TEST_CASE("Transport reports the traffic since its previous report", "[nostr][transport][queue]")
+{
+  auto io_context = std::make_shared<boost::asio::io_context>();
+  auto fake = std::make_shared<radix_relay::test::test_double_websocket_stream>(io_context);
+
+  auto in_queue = std::make_shared<async::async_queue<core::events::transport::in_t>>(io_context);
+  auto out_queue = std::make_shared<async::async_queue<core::events::session_orchestrator::in_t>>(io_context);
+
+  // Only the ping right after connecting falls within the test
+  static constexpr auto ping_interval = std::chrono::hours(1);
+  transport<radix_relay::test::test_double_websocket_stream> transport(
+    fake, io_context, in_queue, out_queue, ping_interval);
+
+  fake->set_traffic(
+    { .message_bytes_sent = 100, .message_bytes_received = 400, .wire_bytes_sent = 60, .wire_bytes_received = 150 });
+  in_queue->push(core::events::transport::connect{ .url = "wss://relay.damus.io" });
+  boost::asio::co_spawn(*io_context, transport.run_once(), boost::asio::detached);
+  io_context->run_for(std::chrono::milliseconds(50));
+
+  fake->set_traffic(
+    { .message_bytes_sent = 300, .message_bytes_received = 400, .wire_bytes_sent = 140, .wire_bytes_received = 190 });
+  in_queue->push(core::events::transport::disconnect{});
+  boost::asio::co_spawn(*io_context, transport.run_once(), boost::asio::detached);
+  io_context->run();
+
+  std::vector<core::events::transport::traffic_measured> reports;
+  while (auto event = out_queue->try_pop()) {
+    if (const auto *report = std::get_if<core::events::transport::traffic_measured>(&*event)) {
+      reports.push_back(*report);
+    }
+  }
+  REQUIRE(reports.size() == 2);
+  CHECK(reports[0].url == "wss://relay.damus.io");
+  CHECK(reports[0].message_bytes_received == 400);
+  CHECK(reports[0].wire_bytes_sent == 60);
+  CHECK(reports[1].message_bytes_sent == 200);
+  CHECK(reports[1].message_bytes_received == 0);
+  CHECK(reports[1].wire_bytes_sent == 80);
+  CHECK(reports[1].wire_bytes_received == 40);
+}
+
 TEST_CASE("Transport emits bytes_received event when WebSocket receives data", "[nostr][transport][queue]")
 {
   auto io_context = std::make_shared<boost::asio::io_context>();
@@ -180,6 +333,102 @@ TEST_CASE("Transport pushes sent event with message ID after sending data", "[no
   CHECK(sent_evt.message_id == "test-msg-id");
 }
 
+TEST_CASE("Transport writes batch frames in order and reports one sent event", "[nostr][transport][queue]")
+{
+  auto io_context = std::make_shared<boost::asio::io_context>();
+  auto fake = std::make_shared<radix_relay::test::test_double_websocket_stream>(io_context);
+
+  auto in_queue = std::make_shared<async::async_queue<core::events::transport::in_t>>(io_context);
+  auto out_queue = std::make_shared<async::async_queue<core::events::session_orchestrator::in_t>>(io_context);
+
+  transport<radix_relay::test::test_double_websocket_stream> transport(fake, io_context, in_queue, out_queue);
+
+  in_queue->push(core::events::transport::connect{ .url = "wss://relay.damus.io" });
+  boost::asio::co_spawn(*io_context, transport.run_once(), boost::asio::detached);
+  io_context->run();
+  io_context->restart();
+
+  auto clear_future = boost::asio::co_spawn(*io_context, out_queue->pop(), boost::asio::use_future);
+  io_context->run();
+  clear_future.get();
+
+  const std::vector<std::vector<std::byte>> frames{
+    { std::byte{ 0x01 } }, { std::byte{ 0x02 }, std::byte{ 0x03 } }, { std::byte{ 0x04 } }
+  };
+  in_queue->push(core::events::transport::send_batch{ .message_id = "test-batch-id", .frames = frames });
+
+  boost::asio::co_spawn(*io_context, transport.run_once(), boost::asio::detached);
+  io_context->restart();
+  io_context->run();
+
+  const auto &writes = fake->get_writes();
+  REQUIRE(writes.size() == 3);
+  CHECK(writes[0].data == frames[0]);
+  CHECK(writes[1].data == frames[1]);
+  CHECK(writes[2].data == frames[2]);
+
+  CHECK(out_queue->size() == 1);
+  io_context->restart();
+  auto future = boost::asio::co_spawn(*io_context, out_queue->pop(), boost::asio::use_future);
+  io_context->run();
+  auto event = future.get();
+
+  REQUIRE(std::holds_alternative<core::events::transport::sent>(event));
+  CHECK(std::get<core::events::transport::sent>(event).message_id == "test-batch-id");
+}
+
+TEST_CASE("Transport queues a send behind a batch instead of writing alongside it", "[nostr][transport][queue]")
+{
+  auto io_context = std::make_shared<boost::asio::io_context>();
+  auto fake = std::make_shared<radix_relay::test::test_double_websocket_stream>(io_context);
+
+  auto in_queue = std::make_shared<async::async_queue<core::events::transport::in_t>>(io_context);
+  auto out_queue = std::make_shared<async::async_queue<core::events::session_orchestrator::in_t>>(io_context);
+
+  transport<radix_relay::test::test_double_websocket_stream> transport(fake, io_context, in_queue, out_queue);
+
+  in_queue->push(core::events::transport::connect{ .url = "wss://relay.damus.io" });
+  boost::asio::co_spawn(*io_context, transport.run_once(), boost::asio::detached);
+  io_context->run();
+  io_context->restart();
+
+  auto clear_future = boost::asio::co_spawn(*io_context, out_queue->pop(), boost::asio::use_future);
+  io_context->run();
+  clear_future.get();
+
+  const std::vector<std::vector<std::byte>> frames{ { std::byte{ 0x01 } }, { std::byte{ 0x02 } } };
+  in_queue->push(core::events::transport::send_batch{ .message_id = "test-batch-id", .frames = frames });
+  in_queue->push(core::events::transport::send{ .message_id = "test-send-id", .bytes = { std::byte{ 0x03 } } });
+
+  boost::asio::co_spawn(
+    *io_context,
+    [&transport]() -> boost::asio::awaitable<void> {
+      co_await transport.run_once();
+      co_await transport.run_once();
+    },
+    boost::asio::detached);
+  io_context->restart();
+  io_context->run();
+
+  CHECK(fake->get_max_writes_in_flight() == 1);
+  const auto &writes = fake->get_writes();
+  REQUIRE(writes.size() == 3);
+  CHECK(writes[0].data == frames[0]);
+  CHECK(writes[1].data == frames[1]);
+  CHECK(writes[2].data == std::vector<std::byte>{ std::byte{ 0x03 } });
+
+  std::vector<std::string> sent_ids;
+  while (not out_queue->empty()) {
+    io_context->restart();
+    auto future = boost::asio::co_spawn(*io_context, out_queue->pop(), boost::asio::use_future);
+    io_context->run();
+    auto event = future.get();
+    REQUIRE(std::holds_alternative<core::events::transport::sent>(event));
+    sent_ids.push_back(std::get<core::events::transport::sent>(event).message_id);
+  }
+  CHECK(sent_ids == std::vector<std::string>{ "test-batch-id", "test-send-id" });
+}
+
 TEST_CASE("Transport pushes disconnected event after processing disconnect command", "[nostr][transport][queue]")
 {
   auto io_context = std::make_shared<boost::asio::io_context>();
@@ -105,6 +105,73 @@ TEST_CASE("Presentation handler formats message_sent with accepted=false", "[pre
   CHECK(output.find("Failed") != std::string::npos);
 }
 
+TEST_CASE("Presentation handler formats send_many_report with failed recipients", "[presentation_handler]")
+{
+  const radix_relay::core::events::send_many_report evt{ .accepted = { "alice", "bob" }, .failed = { "mallory" } };
+
+  const presentation_handler_fixture fixture;
+  fixture.handler.handle(evt);
+
+  const auto output = fixture.get_all_output();
+  CHECK(output.find("2/3") != std::string::npos);
+  CHECK(output.find("failed: mallory") != std::string::npos);
+}
+
+TEST_CASE("Presentation handler formats file_transfer_progress", "[presentation_handler]")
+{
+  const presentation_handler_fixture fixture;
+
+  SECTION("completed incoming transfer shows where the file was saved")
+  {
+    fixture.handler.handle(radix_relay::core::events::file_transfer_progress{ .transfer_id = "t1",
+      .peer = "alice",
+      .name = "notes.txt",
+      .chunks_done = 3,
+      .chunk_count = 3,
+      .outgoing = false,
+      .complete = true,
+      .path = "/downloads/notes.txt",
+      .error = "" });
+
+    CHECK(fixture.get_all_output().find("/downloads/notes.txt") != std::string::npos);
+  }
+
+  SECTION("paused outgoing transfer shows progress and the reason")
+  {
+    fixture.handler.handle(radix_relay::core::events::file_transfer_progress{ .transfer_id = "t1",
+      .peer = "alice",
+      .name = "notes.txt",
+      .chunks_done = 1,
+      .chunk_count = 3,
+      .outgoing = true,
+      .complete = false,
+      .path = "",
+      .error = "relay rejected chunk 1" });
+
+    const auto output = fixture.get_all_output();
+    CHECK(output.find("1/3") != std::string::npos);
+    CHECK(output.find("relay rejected chunk 1") != std::string::npos);
+  }
+}
+
+TEST_CASE("Presentation handler formats backfill_progress", "[presentation_handler]")
+{
+  const presentation_handler_fixture fixture;
+
+  SECTION("a fetch in progress shows the running count")
+  {
+    fixture.handler.handle(
+      radix_relay::core::events::backfill_progress{ .pages = 2, .messages = 400, .complete = false });
+    CHECK(fixture.get_all_output().find("400 so far") != std::string::npos);
+  }
+
+  SECTION("a fetch that found nothing is not shown")
+  {
+    fixture.handler.handle(radix_relay::core::events::backfill_progress{ .pages = 1, .messages = 0, .complete = true });
+    CHECK(fixture.get_all_output().empty());
+  }
+}
+
 TEST_CASE("Presentation handler formats bundle_published event", "[presentation_handler]")
 {
   const radix_relay::core::events::bundle_published evt{ .event_id = "bundle123", .accepted = true };
@@ -7,9 +7,12 @@
 #include <filesystem>
 #include <memory>
 #include <nlohmann/json.hpp>
+#include <nostr/event_verification.hpp>
 #include <nostr/protocol.hpp>
 #include <nostr/request_tracker.hpp>
 #include <nostr/session_orchestrator.hpp>
+#include <numeric>
+#include <optional>
 #include <platform/env_utils.hpp>
 #include <ranges>
 #include <signal/signal_bridge.hpp>
@@ -40,7 +43,10 @@ template<typename Bridge> struct orchestrator_fixture
   std::shared_ptr<radix_relay::nostr::session_orchestrator<Bridge, radix_relay::nostr::request_tracker>> orchestrator;
   std::string db_path;
 
-  explicit orchestrator_fixture(std::string path = "") : db_path(std::move(path))
+  // Hand-built events in these tests carry placeholder IDs and signatures, so verification is opt-in here
+  explicit orchestrator_fixture(std::string path = "",
+    radix_relay::nostr::session_orchestrator_config config = { .verify_event_signatures = false })
+    : db_path(std::move(path))
   {
     constexpr auto short_timeout{ 100 };
 
@@ -67,7 +73,31 @@ template<typename Bridge> struct orchestrator_fixture
         transport_out_queue,
         presentation_out_queue,
         connection_monitor_out_queue,
-        std::chrono::milliseconds(short_timeout));
+        radix_relay::nostr::session_orchestrator_config{ .request_timeout = std::chrono::milliseconds(short_timeout),
+          .min_request_timeout = config.min_request_timeout,
+          .request_timeout_multiplier = config.request_timeout_multiplier,
+          .timestamp_flush_interval = std::chrono::milliseconds(short_timeout),
+          .republish_window = std::chrono::milliseconds(short_timeout),
+          .key_maintenance_period = std::chrono::milliseconds::zero(),
+          .key_maintenance_jitter = std::chrono::milliseconds::zero(),
+          .file_transfer_window = config.file_transfer_window,
+          .file_chunk_retry_delay = config.file_chunk_retry_delay,
+          .max_file_chunk_retry_delay = config.max_file_chunk_retry_delay,
+          .file_chunk_max_attempts = config.file_chunk_max_attempts,
+          .pow_difficulty = config.pow_difficulty,
+          .relay_pow_difficulty = std::move(config.relay_pow_difficulty),
+          .pow_threads = config.pow_threads,
+          .verify_event_signatures = config.verify_event_signatures,
+          .verified_event_cache_size = config.verified_event_cache_size,
+          .discovered_bundle_memory = config.discovered_bundle_memory,
+          .discover_all_bundles = config.discover_all_bundles,
+          .bundle_discovery_limit = config.bundle_discovery_limit,
+          .bundle_discovery_window = config.bundle_discovery_window,
+          .max_subscriptions = config.max_subscriptions,
+          .relay_max_subscriptions = std::move(config.relay_max_subscriptions),
+          .backfill_page_size = config.backfill_page_size,
+          .backfill_retry_delay = std::chrono::milliseconds(short_timeout),
+          .backfill_page_attempts = config.backfill_page_attempts });
   }
 
   // NOLINTNEXTLINE(bugprone-exception-escape)
@@ -159,7 +189,12 @@ struct two_bridge_fixture
       alice_transport_out,
       alice_presentation_out,
       alice_transport_status_out,
-      std::chrono::milliseconds(short_timeout));
+      radix_relay::nostr::session_orchestrator_config{ .request_timeout = std::chrono::milliseconds(short_timeout),
+        .timestamp_flush_interval = std::chrono::milliseconds(short_timeout),
+        .republish_window = std::chrono::milliseconds(short_timeout),
+        .key_maintenance_period = std::chrono::milliseconds::zero(),
+        .key_maintenance_jitter = std::chrono::milliseconds::zero(),
+        .verify_event_signatures = false });
 
     bob_io = std::make_shared<boost::asio::io_context>();
     bob_in = std::make_shared<async::async_queue<core::events::session_orchestrator::in_t>>(bob_io);
@@ -176,7 +211,12 @@ struct two_bridge_fixture
       bob_transport_out,
       bob_presentation_out,
       bob_transport_status_out,
-      std::chrono::milliseconds(short_timeout));
+      radix_relay::nostr::session_orchestrator_config{ .request_timeout = std::chrono::milliseconds(short_timeout),
+        .timestamp_flush_interval = std::chrono::milliseconds(short_timeout),
+        .republish_window = std::chrono::milliseconds(short_timeout),
+        .key_maintenance_period = std::chrono::milliseconds::zero(),
+        .key_maintenance_jitter = std::chrono::milliseconds::zero(),
+        .verify_event_signatures = false });
   }
 
   // NOLINTNEXTLINE(bugprone-exception-escape)
@@ -439,6 +479,9 @@ TEST_CASE("session_orchestrator handles subscribe_identities command", "[session
     CHECK(parsed[2]["kinds"][0] == 30078);
     CHECK(parsed[2].contains("#d"));
     CHECK(parsed[2]["#d"][0] == "radix_prekey_bundle_v1");
+    CHECK(parsed[2]["limit"] == 500);
+    CHECK(parsed[2].contains("since"));
+    CHECK_FALSE(parsed[2].contains("authors"));
   }
 }
 
@@ -506,7 +549,11 @@ TEST_CASE("session_orchestrator handles connect command and manages connection l
 
 TEST_CASE("session_orchestrator sends subscriptions when transport connects", "[session_orchestrator][connect]")
 {
-  const test_double_fixture_t fixture;
+  const test_double_fixture_t fixture("", { .verify_event_signatures = false, .backfill_page_attempts = 1 });
+  fixture.bridge->contacts_to_return = { core::contact_info{ .rdx_fingerprint = "RDX:bob",
+    .nostr_pubkey = std::string(64, 'b'),
+    .user_alias = "bob",
+    .has_active_session = true } };
 
   fixture.in_queue->push(core::events::transport::connected{
     .url = "wss://relay.example.com", .type = core::events::transport_type::internet });
@@ -527,7 +574,7 @@ TEST_CASE("session_orchestrator sends subscriptions when transport connects", "[
     }
   }
 
-  CHECK(req_count == 2);
+  CHECK(req_count == 3);
 }
 
 TEST_CASE("session_orchestrator respects cancellation signal", "[core][session_orchestrator][cancellation]")
@@ -946,7 +993,7 @@ TEST_CASE("session_orchestrator ignores duplicate encrypted messages", "[session
 TEST_CASE("session_orchestrator includes since filter when subscribing to messages",
   "[session_orchestrator][subscribe][since]")
 {
-  const test_double_fixture_t fixture;
+  const test_double_fixture_t fixture("", { .verify_event_signatures = false, .backfill_page_attempts = 1 });
 
   constexpr std::uint64_t test_timestamp = 1700000000;
 
@@ -958,22 +1005,112 @@ TEST_CASE("session_orchestrator includes since filter when subscribing to messag
   fixture.io_context->restart();
   fixture.io_context->run();
 
-  CHECK(not fixture.transport_out_queue->empty());
-  auto transport_cmd = fixture.transport_out_queue->try_pop();
-  REQUIRE(transport_cmd.has_value());
+  std::vector<nlohmann::json> requests;
+  while (auto transport_cmd = fixture.transport_out_queue->try_pop()) {
+    REQUIRE(std::holds_alternative<core::events::transport::send>(*transport_cmd));
+    const auto &send_cmd = std::get<core::events::transport::send>(*transport_cmd);
+    requests.push_back(nlohmann::json::parse(bytes_to_string(send_cmd.bytes)));
+  }
 
-  if (transport_cmd.has_value()) {
-    CHECK(std::holds_alternative<core::events::transport::send>(transport_cmd.value()));
+  // The live subscription starts near the present; older messages are fetched by the backfill,
+  // whose only attempt at the first page is closed again once its EOSE times out
+  REQUIRE(requests.size() == 3);
+  CHECK(requests[0][0] == "REQ");
+  CHECK(requests[0][2]["since"] > test_timestamp);
+  CHECK(requests[1][0] == "REQ");
+  CHECK(requests[1][2]["since"] == test_timestamp);
+  CHECK(requests[1][2]["until"] == requests[0][2]["since"]);
+  CHECK(requests[1][2]["limit"] == 200);
+  CHECK(requests[2] == nlohmann::json::array({ "CLOSE", requests[1][1] }));
+}
 
-    const auto &send_cmd = std::get<core::events::transport::send>(transport_cmd.value());
-    const std::string json_str = bytes_to_string(send_cmd.bytes);
+auto make_encrypted_message_json(const std::string &event_id, std::uint64_t created_at) -> std::string
+{
+  return R"(["EVENT","sub",{"id":")" + event_id + R"(","pubkey":"test_sender","created_at":)"
+         + std::to_string(created_at) + R"(,"kind":40001,"tags":[],"content":"6869","sig":"sig"}])";
+}
 
-    auto parsed = nlohmann::json::parse(json_str);
-    CHECK(parsed.is_array());
-    CHECK(parsed[0] == "REQ");
-    CHECK(parsed[2].contains("since"));
-    CHECK(parsed[2]["since"] == test_timestamp);
+TEST_CASE("session_orchestrator coalesces last message timestamp writes",
+  "[session_orchestrator][messages][since][coalesce]")
+{
+  const test_double_fixture_t fixture;
+
+  constexpr std::uint64_t base_timestamp = 1700000000;
+  constexpr std::uint64_t message_count = 50;
+  for (std::uint64_t i = 0; i < message_count; ++i) {
+    fixture.in_queue->push(core::events::transport::bytes_received{
+      .bytes = string_to_bytes(make_encrypted_message_json("evt" + std::to_string(i), base_timestamp + i)) });
   }
+  fixture.in_queue->push(core::events::transport::bytes_received{
+    .bytes = string_to_bytes(make_encrypted_message_json("evt_old", base_timestamp - 1)) });
+
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture]() -> boost::asio::awaitable<void> {
+      for (std::uint64_t i = 0; i <= message_count; ++i) { co_await fixture.orchestrator->run_once(); }
+    },
+    boost::asio::detached);
+
+  fixture.io_context->poll();
+  CHECK(fixture.bridge->call_count("decrypt_message") == message_count + 1);
+  CHECK_FALSE(fixture.bridge->was_called("update_last_message_timestamp"));
+
+  fixture.io_context->run();
+
+  CHECK(fixture.bridge->call_count("update_last_message_timestamp") == 1);
+  CHECK(fixture.bridge->last_message_timestamp == base_timestamp + message_count - 1);
+}
+
+TEST_CASE("session_orchestrator persists last message timestamp on EOSE", "[session_orchestrator][messages][since]")
+{
+  const test_double_fixture_t fixture;
+
+  constexpr std::uint64_t test_timestamp = 1700000000;
+  fixture.in_queue->push(core::events::transport::bytes_received{
+    .bytes = string_to_bytes(make_encrypted_message_json("evt1", test_timestamp)) });
+  fixture.in_queue->push(
+    core::events::transport::bytes_received{ .bytes = string_to_bytes(R"(["EOSE","sub"])") });
+
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture]() -> boost::asio::awaitable<void> {
+      co_await fixture.orchestrator->run_once();
+      co_await fixture.orchestrator->run_once();
+    },
+    boost::asio::detached);
+
+  fixture.io_context->poll();
+
+  CHECK(fixture.bridge->call_count("update_last_message_timestamp") == 1);
+  CHECK(fixture.bridge->last_message_timestamp == test_timestamp);
+
+  fixture.io_context->run();
+
+  CHECK(fixture.bridge->call_count("update_last_message_timestamp") == 1);
+}
+
+TEST_CASE("session_orchestrator persists last message timestamp on shutdown", "[session_orchestrator][messages][since]")
+{
+  const test_double_fixture_t fixture;
+  auto cancel_signal = std::make_shared<boost::asio::cancellation_signal>();
+  auto cancel_slot = std::make_shared<boost::asio::cancellation_slot>(cancel_signal->slot());
+
+  constexpr std::uint64_t test_timestamp = 1700000000;
+  fixture.in_queue->push(core::events::transport::bytes_received{
+    .bytes = string_to_bytes(make_encrypted_message_json("evt1", test_timestamp)) });
+
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run(cancel_slot), boost::asio::detached);
+
+  fixture.io_context->poll();
+  CHECK_FALSE(fixture.bridge->was_called("update_last_message_timestamp"));
+
+  cancel_signal->emit(boost::asio::cancellation_type::terminal);
+  fixture.io_context->run();
+
+  CHECK(fixture.bridge->call_count("update_last_message_timestamp") == 1);
+  CHECK(fixture.bridge->last_message_timestamp == test_timestamp);
 }
 
 TEST_CASE("encrypted message event structure contains correct sender and recipient information",
@@ -1169,6 +1306,95 @@ TEST_CASE("session_orchestrator republishes bundle on connection if keys rotated
   CHECK(found_bundle);
 }
 
+TEST_CASE("session_orchestrator subscribes before key maintenance republishes",
+  "[session_orchestrator][maintenance][connect]")
+{
+  const test_double_fixture_t fixture("", { .verify_event_signatures = false, .backfill_page_size = 0 });
+
+  fixture.bridge->set_maintenance_result(
+    { .signed_pre_key_rotated = true, .kyber_pre_key_rotated = true, .pre_keys_replenished = false });
+
+  fixture.in_queue->push(core::events::transport::connected{
+    .url = "wss://relay.example.com", .type = core::events::transport_type::internet });
+
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->run();
+
+  CHECK(fixture.bridge->call_count("perform_key_maintenance") == 1);
+
+  std::vector<std::string> frame_types;
+  while (not fixture.transport_out_queue->empty()) {
+    auto transport_cmd = fixture.transport_out_queue->try_pop();
+    if (transport_cmd.has_value() and std::holds_alternative<core::events::transport::send>(*transport_cmd)) {
+      const auto &send_cmd = std::get<core::events::transport::send>(*transport_cmd);
+      frame_types.push_back(nlohmann::json::parse(bytes_to_string(send_cmd.bytes))[0].get<std::string>());
+    }
+  }
+
+  REQUIRE(frame_types.size() == 2);
+  CHECK(frame_types[0] == "REQ");
+  CHECK(frame_types[1] == "EVENT");
+}
+
+TEST_CASE("session_orchestrator skips republish when maintenance rotates nothing",
+  "[session_orchestrator][maintenance][connect]")
+{
+  const test_double_fixture_t fixture;
+
+  fixture.in_queue->push(core::events::transport::connected{
+    .url = "wss://relay.example.com", .type = core::events::transport_type::internet });
+
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->run();
+
+  CHECK(fixture.bridge->call_count("perform_key_maintenance") == 1);
+  CHECK_FALSE(fixture.bridge->was_called("generate_prekey_bundle_announcement"));
+  CHECK(fixture.orchestrator->get_republish_stats().triggers == 0);
+}
+
+TEST_CASE("session_orchestrator coalesces bundle republish triggers", "[session_orchestrator][republish][coalesce]")
+{
+  const test_double_fixture_t fixture;
+
+  fixture.bridge->should_republish_bundle_to_return = true;
+
+  constexpr std::uint64_t base_timestamp = 1700000000;
+  constexpr std::uint64_t message_count = 20;
+  for (std::uint64_t i = 0; i < message_count; ++i) {
+    fixture.in_queue->push(core::events::transport::bytes_received{
+      .bytes = string_to_bytes(make_encrypted_message_json("evt" + std::to_string(i), base_timestamp + i)) });
+  }
+
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture]() -> boost::asio::awaitable<void> {
+      for (std::uint64_t i = 0; i < message_count; ++i) { co_await fixture.orchestrator->run_once(); }
+    },
+    boost::asio::detached);
+
+  fixture.io_context->poll();
+  CHECK_FALSE(fixture.bridge->was_called("generate_prekey_bundle_announcement"));
+
+  fixture.io_context->run();
+
+  CHECK(fixture.bridge->call_count("generate_prekey_bundle_announcement") == 1);
+  const auto stats = fixture.orchestrator->get_republish_stats();
+  CHECK(stats.triggers == message_count);
+  CHECK(stats.publishes == 1);
+
+  int bundle_events = 0;
+  while (not fixture.transport_out_queue->empty()) {
+    auto transport_cmd = fixture.transport_out_queue->try_pop();
+    if (transport_cmd.has_value() and std::holds_alternative<core::events::transport::send>(*transport_cmd)) {
+      const auto &send_cmd = std::get<core::events::transport::send>(*transport_cmd);
+      auto parsed = nlohmann::json::parse(bytes_to_string(send_cmd.bytes));
+      if (parsed[0] == "EVENT" and parsed[1]["kind"] == nostr::protocol::kind::bundle_announcement) { ++bundle_events; }
+    }
+  }
+  CHECK(bundle_events == 1);
+}
+
 TEST_CASE("reply to unknown sender includes correct nostr pubkey in p tag",
   "[session_orchestrator][x3dh][unknown-sender][reply]")
 {
@@ -1339,4 +1565,1262 @@ TEST_CASE("trust updates alias for existing contact without bundle", "[session_o
   CHECK(updated_contact.rdx_fingerprint == bob_rdx);
 }
 
+auto drain_transport_frames(const test_double_fixture_t &fixture) -> std::vector<nlohmann::json>
+{
+  std::vector<nlohmann::json> frames;
+  while (auto transport_cmd = fixture.transport_out_queue->try_pop()) {
+    if (std::holds_alternative<core::events::transport::send>(*transport_cmd)) {
+      const auto &send_cmd = std::get<core::events::transport::send>(*transport_cmd);
+      frames.push_back(nlohmann::json::parse(bytes_to_string(send_cmd.bytes)));
+    }
+  }
+  return frames;
+}
+
+TEST_CASE("session_orchestrator replaces the messages subscription when a group is created",
+  "[session_orchestrator][group]")
+{
+  const test_double_fixture_t fixture;
+
+  fixture.in_queue->push(events::subscribe_messages{});
+  fixture.in_queue->push(events::create_group{ .name = "friends", .members = { "alice", "bob" } });
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture]() -> boost::asio::awaitable<void> {
+      co_await fixture.orchestrator->run_once();
+      co_await fixture.orchestrator->run_once();
+    },
+    boost::asio::detached);
+  fixture.io_context->poll();
+
+  CHECK(fixture.bridge->created_group_name == "friends");
+  CHECK(fixture.bridge->created_group_members == std::vector<std::string>{ "alice", "bob" });
+
+  // The backfill started by the first subscription keeps running across the replacement
+  const auto frames = drain_transport_frames(fixture);
+  REQUIRE(frames.size() == 4);
+  CHECK(frames[0][0] == "REQ");
+  CHECK(frames[1][0] == "REQ");
+  CHECK(frames[2] == nlohmann::json::array({ "CLOSE", frames[0][1] }));
+  CHECK(frames[3][0] == "REQ");
+  CHECK(frames[3][1] != frames[0][1]);
+
+  auto presentation = fixture.presentation_out_queue->try_pop();
+  REQUIRE(presentation.has_value());
+  REQUIRE(std::holds_alternative<events::group_created>(*presentation));
+  CHECK(std::get<events::group_created>(*presentation).group_id == "test_group_id");
+}
+
+TEST_CASE("session_orchestrator sends pending sender keys before the group message",
+  "[session_orchestrator][group]")
+{
+  const test_double_fixture_t fixture;
+  fixture.bridge->members_awaiting_sender_key = { "RDX:bob", "RDX:carol" };
+
+  fixture.in_queue->push(events::broadcast{ .group = "friends", .message = "hi all" });
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->poll();
+
+  const auto frames = drain_transport_frames(fixture);
+  REQUIRE(frames.size() == 3);
+  CHECK(frames[0][1]["kind"] == 40006);
+  CHECK(frames[1][1]["kind"] == 40006);
+  CHECK(frames[2][1]["kind"] == 40005);
+
+  fixture.io_context->run();
+  auto presentation = fixture.presentation_out_queue->try_pop();
+  REQUIRE(presentation.has_value());
+  REQUIRE(std::holds_alternative<events::message_sent>(*presentation));
+  CHECK(std::get<events::message_sent>(*presentation).peer == "friends");
+  CHECK_FALSE(fixture.bridge->was_called("mark_sender_key_delivered"));
+  CHECK(fixture.bridge->members_awaiting_sender_key.size() == 2);
+}
+
+TEST_CASE("session_orchestrator only counts sender keys a relay accepted as delivered",
+  "[session_orchestrator][group]")
+{
+  const test_double_fixture_t fixture;
+  fixture.bridge->members_awaiting_sender_key = { "RDX:bob", "RDX:carol" };
+
+  fixture.in_queue->push(events::broadcast{ .group = "friends", .message = "hi all" });
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->poll();
+  REQUIRE(drain_transport_frames(fixture).size() == 3);
+
+  fixture.in_queue->push(core::events::transport::bytes_received{
+    string_to_bytes(R"(["OK","test_distribution_event_id_RDX:bob",true,""])") });
+  fixture.in_queue->push(core::events::transport::bytes_received{
+    string_to_bytes(R"(["OK","test_distribution_event_id_RDX:carol",false,"blocked: rate limited"])") });
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture]() -> boost::asio::awaitable<void> {
+      co_await fixture.orchestrator->run_once();
+      co_await fixture.orchestrator->run_once();
+    },
+    boost::asio::detached);
+  fixture.io_context->poll();
+
+  CHECK(fixture.bridge->members_awaiting_sender_key == std::vector<std::string>{ "RDX:carol" });
+
+  fixture.in_queue->push(events::broadcast{ .group = "friends", .message = "hi again" });
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->poll();
+
+  const auto frames = drain_transport_frames(fixture);
+  REQUIRE(frames.size() == 2);
+  CHECK(frames[0][1]["id"] == "test_distribution_event_id_RDX:carol");
+  CHECK(frames[1][1]["kind"] == 40005);
+  fixture.io_context->run();
+}
+
+TEST_CASE("session_orchestrator sends a send_many as one batch and reports all recipients together",
+  "[session_orchestrator][send_many]")
+{
+  const test_double_fixture_t fixture;
+  fixture.bridge->unreachable_peers = { "mallory" };
+
+  fixture.in_queue->push(events::send_many{ .peers = { "alice", "mallory", "bob" }, .message = "hi" });
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->poll();
+
+  CHECK(fixture.bridge->call_count("create_encrypted_message_frames") == 1);
+  auto transport_cmd = fixture.transport_out_queue->try_pop();
+  REQUIRE(transport_cmd.has_value());
+  REQUIRE(std::holds_alternative<core::events::transport::send_batch>(*transport_cmd));
+  const auto &batch = std::get<core::events::transport::send_batch>(*transport_cmd);
+  REQUIRE(batch.frames.size() == 2);
+  CHECK(nlohmann::json::parse(bytes_to_string(batch.frames[0]))[1]["id"] == "test_message_event_id_alice");
+  CHECK(nlohmann::json::parse(bytes_to_string(batch.frames[1]))[1]["id"] == "test_message_event_id_bob");
+  CHECK(fixture.transport_out_queue->empty());
+
+  fixture.in_queue->push(core::events::transport::bytes_received{
+    string_to_bytes(R"(["OK","test_message_event_id_alice",true,""])") });
+  fixture.in_queue->push(core::events::transport::bytes_received{
+    string_to_bytes(R"(["OK","test_message_event_id_bob",false,"blocked: rate limited"])") });
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture]() -> boost::asio::awaitable<void> {
+      co_await fixture.orchestrator->run_once();
+      co_await fixture.orchestrator->run_once();
+    },
+    boost::asio::detached);
+  fixture.io_context->poll();
+
+  auto presentation = fixture.presentation_out_queue->try_pop();
+  REQUIRE(presentation.has_value());
+  REQUIRE(std::holds_alternative<events::send_many_report>(*presentation));
+  const auto &report = std::get<events::send_many_report>(*presentation);
+  CHECK(report.accepted == std::vector<std::string>{ "alice" });
+  CHECK(report.failed == std::vector<std::string>{ "mallory", "bob" });
+  CHECK(fixture.presentation_out_queue->empty());
+}
+
+namespace {
+auto sent_chunk_ids(async::async_queue<core::events::transport::in_t> &queue) -> std::vector<std::string>
+{
+  std::vector<std::string> ids;
+  while (auto transport_cmd = queue.try_pop()) {
+    if (not std::holds_alternative<core::events::transport::send>(*transport_cmd)) { continue; }
+    auto parsed = nlohmann::json::parse(bytes_to_string(std::get<core::events::transport::send>(*transport_cmd).bytes));
+    if (parsed[0] == "EVENT" and parsed[1]["kind"] == nostr::protocol::kind::file_chunk) {
+      ids.push_back(parsed[1]["id"].get<std::string>());
+    }
+  }
+  return ids;
+}
+
+auto sent_events(async::async_queue<core::events::transport::in_t> &queue) -> std::vector<nlohmann::json>
+{
+  std::vector<nlohmann::json> events;
+  while (auto transport_cmd = queue.try_pop()) {
+    if (not std::holds_alternative<core::events::transport::send>(*transport_cmd)) { continue; }
+    auto parsed = nlohmann::json::parse(bytes_to_string(std::get<core::events::transport::send>(*transport_cmd).bytes));
+    if (parsed[0] == "EVENT") { events.push_back(parsed[1]); }
+  }
+  return events;
+}
+}// namespace
+
+TEST_CASE("session_orchestrator keeps a window of file chunks in flight", "[session_orchestrator][file_transfer]")
+{
+  const test_double_fixture_t fixture;
+  fixture.bridge->transfer_chunk_count = 10;
+
+  fixture.in_queue->push(events::send_file{ .peer = "alice", .path = "/tmp/notes.txt" });
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->poll();
+
+  auto started = fixture.presentation_out_queue->try_pop();
+  REQUIRE(started.has_value());
+  REQUIRE(std::holds_alternative<events::file_transfer_progress>(*started));
+  CHECK(std::get<events::file_transfer_progress>(*started).chunk_count == 10);
+
+  auto first_window = sent_chunk_ids(*fixture.transport_out_queue);
+  REQUIRE(first_window.size() == 8);
+  CHECK(first_window.front() == "test_chunk_event_id_0");
+  CHECK(first_window.back() == "test_chunk_event_id_7");
+
+  fixture.in_queue->push(core::events::transport::bytes_received{
+    string_to_bytes(R"(["OK","test_chunk_event_id_0",true,""])") });
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->poll();
+
+  CHECK(fixture.bridge->call_count("mark_transfer_chunk_delivered") == 1);
+  CHECK(sent_chunk_ids(*fixture.transport_out_queue) == std::vector<std::string>{ "test_chunk_event_id_8" });
+
+  fixture.in_queue->push(core::events::transport::bytes_received{
+    string_to_bytes(R"(["OK","test_chunk_event_id_1",false,"blocked: too large"])") });
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->poll();
+
+  auto paused = fixture.presentation_out_queue->try_pop();
+  REQUIRE(paused.has_value());
+  REQUIRE(std::holds_alternative<events::file_transfer_progress>(*paused));
+  CHECK(std::get<events::file_transfer_progress>(*paused).chunks_done == 1);
+  CHECK_FALSE(std::get<events::file_transfer_progress>(*paused).error.empty());
+  CHECK(sent_chunk_ids(*fixture.transport_out_queue).empty());
+}
+
+TEST_CASE("session_orchestrator backs off unanswered file chunks and pauses after too many",
+  "[session_orchestrator][file_transfer]")
+{
+  const test_double_fixture_t fixture("",
+    { .file_transfer_window = 1,
+      .file_chunk_retry_delay = std::chrono::milliseconds(150),
+      .file_chunk_max_attempts = 3,
+      .verify_event_signatures = false });
+  fixture.bridge->transfer_chunk_count = 2;
+
+  fixture.in_queue->push(events::send_file{ .peer = "alice", .path = "/tmp/notes.txt" });
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->poll();
+  CHECK(sent_chunk_ids(*fixture.transport_out_queue) == std::vector<std::string>{ "test_chunk_event_id_0" });
+
+  const auto next_send = [&fixture]() -> std::vector<std::string> {
+    auto sent = sent_chunk_ids(*fixture.transport_out_queue);
+    while (sent.empty() and fixture.io_context->run_one() > 0) { sent = sent_chunk_ids(*fixture.transport_out_queue); }
+    return sent;
+  };
+
+  // Each resend waits out the 100ms OK timeout, then a delay of 150ms doubled per unanswered send;
+  // the checks leave the OK timeout as slack
+  auto sent_at = std::chrono::steady_clock::now();
+  CHECK(next_send() == std::vector<std::string>{ "test_chunk_event_id_0" });
+  CHECK(std::chrono::steady_clock::now() - sent_at >= std::chrono::milliseconds(150));
+  sent_at = std::chrono::steady_clock::now();
+  CHECK(next_send() == std::vector<std::string>{ "test_chunk_event_id_0" });
+  CHECK(std::chrono::steady_clock::now() - sent_at >= std::chrono::milliseconds(300));
+
+  // The third unanswered send pauses the transfer instead of sending the chunk again
+  CHECK(next_send().empty());
+
+  std::optional<events::file_transfer_progress> last_progress;
+  while (auto presentation = fixture.presentation_out_queue->try_pop()) {
+    if (std::holds_alternative<events::file_transfer_progress>(*presentation)) {
+      last_progress = std::get<events::file_transfer_progress>(*presentation);
+    }
+  }
+  REQUIRE(last_progress.has_value());
+  CHECK_FALSE(last_progress->complete);
+  CHECK_FALSE(last_progress->error.empty());
+}
+
+TEST_CASE("session_orchestrator resumes unfinished file transfers on connect", "[session_orchestrator][file_transfer]")
+{
+  const test_double_fixture_t fixture;
+  fixture.bridge->pending_transfers.push_back(radix_relay::signal::outgoing_transfer{ .transfer_id = "left_over",
+    .peer_rdx = "RDX:alice",
+    .name = "notes.txt",
+    .chunk_count = 3,
+    .pending_chunks = { 2 } });
+
+  fixture.in_queue->push(core::events::transport::connected{
+    .url = "wss://relay.example.com", .type = core::events::transport_type::internet });
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->poll();
+
+  CHECK(fixture.bridge->was_called("pending_file_transfers"));
+  CHECK(sent_chunk_ids(*fixture.transport_out_queue) == std::vector<std::string>{ "test_chunk_event_id_2" });
+
+  fixture.in_queue->push(core::events::transport::bytes_received{
+    string_to_bytes(R"(["OK","test_chunk_event_id_2",true,""])") });
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->poll();
+
+  std::optional<events::file_transfer_progress> last_progress;
+  while (auto presentation = fixture.presentation_out_queue->try_pop()) {
+    if (std::holds_alternative<events::file_transfer_progress>(*presentation)) {
+      last_progress = std::get<events::file_transfer_progress>(*presentation);
+    }
+  }
+  REQUIRE(last_progress.has_value());
+  CHECK(last_progress->complete);
+  CHECK(last_progress->chunks_done == 3);
+  CHECK(fixture.bridge->pending_transfers.empty());
+}
+
+TEST_CASE("session_orchestrator emits received group messages", "[session_orchestrator][group]")
+{
+  const test_double_fixture_t fixture;
+
+  const std::string group_event =
+    R"(["EVENT","sub",{"id":"evt","pubkey":"test_sender","created_at":1700000000,"kind":40005,)"
+    R"("tags":[["g","test_group_id"],["radix_version","0.4.0","base64"]],"content":"aGk=","sig":"sig"}])";
+  fixture.in_queue->push(core::events::transport::bytes_received{ .bytes = string_to_bytes(group_event) });
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->poll();
+
+  CHECK(fixture.bridge->was_called("decrypt_group_message"));
+  auto presentation = fixture.presentation_out_queue->try_pop();
+  REQUIRE(presentation.has_value());
+  REQUIRE(std::holds_alternative<events::group_message_received>(*presentation));
+  const auto &received = std::get<events::group_message_received>(*presentation);
+  CHECK(received.group_id == "test_group_id");
+  CHECK(received.content == "hi");
+}
+
+TEST_CASE("session_orchestrator drops its own group messages echoed by the relay", "[session_orchestrator][group]")
+{
+  const test_double_fixture_t fixture;
+
+  fixture.in_queue->push(events::subscribe_messages{});
+  const std::string own_event =
+    R"(["EVENT","sub",{"id":"evt","pubkey":"test_pubkey","created_at":1700000000,"kind":40005,)"
+    R"("tags":[["g","test_group_id"],["radix_version","0.4.0","base64"]],"content":"aGk=","sig":"sig"}])";
+  fixture.in_queue->push(core::events::transport::bytes_received{ .bytes = string_to_bytes(own_event) });
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture]() -> boost::asio::awaitable<void> {
+      co_await fixture.orchestrator->run_once();
+      co_await fixture.orchestrator->run_once();
+    },
+    boost::asio::detached);
+  fixture.io_context->poll();
+
+  CHECK_FALSE(fixture.bridge->was_called("decrypt_group_message"));
+  while (auto presentation = fixture.presentation_out_queue->try_pop()) {
+    CHECK_FALSE(std::holds_alternative<events::group_message_received>(*presentation));
+  }
+}
+
+TEST_CASE("session_orchestrator mines proof of work at the difficulty of the connected relay",
+  "[session_orchestrator][pow]")
+{
+  const test_double_fixture_t fixture("",
+    { .pow_difficulty = 4, .relay_pow_difficulty = { { "wss://open.example", 0 } }, .pow_threads = 1 });
+  fixture.bridge->signed_event_id = radix_relay::nostr::compute_event_id;
+
+  fixture.in_queue->push(events::send{ .peer = "alice", .message = "hi" });
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->run();
+  fixture.io_context->restart();
+
+  CHECK(fixture.bridge->call_count("sign_event_frame") == 1);
+  REQUIRE_FALSE(fixture.bridge->last_signed_tags.empty());
+  CHECK(fixture.bridge->last_signed_tags.back().front() == "nonce");
+  CHECK(fixture.bridge->last_signed_tags.back().back() == "4");
+  const auto sent = sent_events(*fixture.transport_out_queue);
+  REQUIRE(sent.size() == 1);
+  CHECK(sent.front()["id"].get<std::string>().starts_with("0"));
+
+  fixture.in_queue->push(
+    core::events::transport::connected{ .url = "wss://open.example", .type = core::events::transport_type::internet });
+  fixture.in_queue->push(events::send{ .peer = "alice", .message = "hi again" });
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture]() -> boost::asio::awaitable<void> {
+      co_await fixture.orchestrator->run_once();
+      co_await fixture.orchestrator->run_once();
+    },
+    boost::asio::detached);
+  fixture.io_context->run();
+
+  CHECK(fixture.bridge->call_count("sign_event_frame") == 1);
+  CHECK(fixture.bridge->call_count("create_encrypted_message_frame") == 2);
+}
+
+TEST_CASE("session_orchestrator sends the unmined event when the signed ID is not the mined one",
+  "[session_orchestrator][pow]")
+{
+  const test_double_fixture_t fixture("", { .pow_difficulty = 4, .pow_threads = 1 });
+
+  fixture.in_queue->push(events::send{ .peer = "alice", .message = "hi" });
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->run();
+
+  CHECK(fixture.bridge->call_count("sign_event_frame") == 1);
+  const auto sent = sent_events(*fixture.transport_out_queue);
+  REQUIRE(sent.size() == 1);
+  CHECK(sent.front()["id"] == "test_message_event_id");
+  CHECK(sent.front()["tags"].empty());
+}
+
+TEST_CASE("session_orchestrator mines an unchanged bundle announcement only once", "[session_orchestrator][pow]")
+{
+  const test_double_fixture_t fixture("", { .pow_difficulty = 4, .pow_threads = 1 });
+  fixture.bridge->signed_event_id = radix_relay::nostr::compute_event_id;
+
+  const auto publish = [&fixture]() -> void {
+    fixture.in_queue->push(events::publish_identity{});
+    boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+    fixture.io_context->run();
+    fixture.io_context->restart();
+  };
+
+  publish();
+  publish();
+
+  CHECK(fixture.bridge->call_count("generate_prekey_bundle_announcement") == 2);
+  CHECK(fixture.bridge->call_count("sign_event_frame") == 1);
+  const auto sent = sent_events(*fixture.transport_out_queue);
+  REQUIRE(sent.size() == 2);
+  CHECK(sent.front()["id"].get<std::string>().starts_with("0"));
+  CHECK(sent.front() == sent.back());
+
+  fixture.in_queue->push(core::events::transport::connected{ .url = "wss://strict.example",
+    .type = core::events::transport_type::internet,
+    .limits = { .min_pow_difficulty = 8 } });
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->run();
+  fixture.io_context->restart();
+  publish();
+
+  CHECK(fixture.bridge->call_count("sign_event_frame") == 2);
+  REQUIRE_FALSE(fixture.bridge->last_signed_tags.empty());
+  CHECK(fixture.bridge->last_signed_tags.back().back() == "8");
+}
+
+namespace {
+
+auto group_event_message(const std::string &content) -> std::string
+{
+  auto event = nlohmann::json::parse(R"({"pubkey":"test_sender","created_at":1700000000,"kind":40005,)"
+                                     R"("tags":[["g","test_group_id"],["radix_version","0.4.0","base64"]],)"
+                                     R"("sig":"sig"})");
+  event["content"] = content;
+  event["id"] = radix_relay::nostr::compute_event_id(event);
+  return nlohmann::json::array({ "EVENT", "sub", event }).dump();
+}
+
+auto deliver_events(const test_double_fixture_t &fixture, const std::vector<std::string> &messages) -> void
+{
+  for (const auto &message : messages) {
+    fixture.in_queue->push(core::events::transport::bytes_received{ string_to_bytes(message) });
+  }
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture, count = messages.size()]() -> boost::asio::awaitable<void> {
+      for (std::size_t i = 0; i < count; ++i) { co_await fixture.orchestrator->run_once(); }
+    },
+    boost::asio::detached);
+  fixture.io_context->run();
+  fixture.io_context->restart();
+}
+
+}// namespace
+
+TEST_CASE("session_orchestrator drops incoming events that fail verification", "[session_orchestrator][verify]")
+{
+  const test_double_fixture_t fixture("", { .verify_event_signatures = true });
+  const auto forged = group_event_message("Zm9yZ2Vk");
+  const auto tampered = group_event_message("YnllYnll");
+  for (const auto &message : { forged, tampered }) {
+    fixture.bridge->forged_event_ids.insert(nlohmann::json::parse(message)[2]["id"].get<std::string>());
+  }
+
+  deliver_events(fixture, { forged, group_event_message("aGk="), tampered, group_event_message("b2s=") });
+
+  CHECK(fixture.bridge->was_called("verify_events"));
+  CHECK(std::accumulate(fixture.bridge->verified_batch_sizes.begin(),
+          fixture.bridge->verified_batch_sizes.end(),
+          std::size_t{ 0 }) == 4);
+  CHECK(fixture.bridge->call_count("decrypt_group_message") == 2);
+
+  std::vector<std::string> received;
+  while (auto presentation = fixture.presentation_out_queue->try_pop()) {
+    if (std::holds_alternative<events::group_message_received>(*presentation)) {
+      received.push_back(std::get<events::group_message_received>(*presentation).content);
+    }
+  }
+  CHECK(received == std::vector<std::string>{ "hi", "ok" });
+}
+
+TEST_CASE("session_orchestrator skips verification of events it has already verified",
+  "[session_orchestrator][verify]")
+{
+  const test_double_fixture_t fixture("", { .verify_event_signatures = true });
+  const auto message = group_event_message("aGk=");
+
+  deliver_events(fixture, { message });
+  CHECK(fixture.bridge->call_count("verify_events") == 1);
+  CHECK(fixture.bridge->call_count("decrypt_group_message") == 1);
+
+  deliver_events(fixture, { message });
+  CHECK(fixture.bridge->call_count("verify_events") == 1);
+  CHECK(fixture.bridge->call_count("decrypt_group_message") == 2);
+}
+
+
+TEST_CASE("session_orchestrator ignores bundle announcements older than the stored one",
+  "[session_orchestrator][bundles]")
+{
+  const test_double_fixture_t fixture;
+
+  fixture.in_queue->push(core::events::bundle_announcement_received{
+    .pubkey = "bob_pubkey", .bundle_content = "bmV3", .event_id = "new_event", .created_at = 200 });
+  fixture.in_queue->push(core::events::bundle_announcement_received{
+    .pubkey = "bob_pubkey", .bundle_content = "b2xk", .event_id = "old_event", .created_at = 100 });
+  fixture.in_queue->push(core::events::list_identities{});
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture]() -> boost::asio::awaitable<void> {
+      for (int i = 0; i < 3; ++i) { co_await fixture.orchestrator->run_once(); }
+    },
+    boost::asio::detached);
+  fixture.io_context->run();
+
+  CHECK(fixture.bridge->call_count("extract_rdx_from_bundle_base64") == 1);
+  auto response = fixture.presentation_out_queue->try_pop();
+  REQUIRE(response.has_value());
+  REQUIRE(std::holds_alternative<core::events::identities_listed>(*response));
+  const auto &listed = std::get<core::events::identities_listed>(*response);
+  REQUIRE(listed.identities.size() == 1);
+  CHECK(listed.identities[0].event_id == "new_event");
+}
+
+
+TEST_CASE("session_orchestrator extracts RDX fingerprints only when identities are needed",
+  "[session_orchestrator][bundles]")
+{
+  const test_double_fixture_t fixture;
+  const auto process = [&fixture](std::vector<core::events::session_orchestrator::in_t> events) {
+    for (auto &event : events) { fixture.in_queue->push(std::move(event)); }
+    boost::asio::co_spawn(
+      *fixture.io_context,
+      // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+      [&fixture, count = events.size()]() -> boost::asio::awaitable<void> {
+        for (std::size_t i = 0; i < count; ++i) { co_await fixture.orchestrator->run_once(); }
+      },
+      boost::asio::detached);
+    fixture.io_context->run();
+    fixture.io_context->restart();
+  };
+
+  process({ core::events::bundle_announcement_received{
+              .pubkey = "bob_pubkey", .bundle_content = "Ym9i", .event_id = "bob_1", .created_at = 100 },
+    core::events::bundle_announcement_received{
+      .pubkey = "bob_pubkey", .bundle_content = "Ym9i", .event_id = "bob_1", .created_at = 100 },
+    core::events::bundle_announcement_received{
+      .pubkey = "carol_pubkey", .bundle_content = "Y2Fyb2w=", .event_id = "carol_1", .created_at = 100 } });
+  CHECK_FALSE(fixture.bridge->was_called("extract_rdx_from_bundle_base64"));
+
+  process({ core::events::list_identities{} });
+  CHECK(fixture.bridge->call_count("extract_rdx_from_bundle_base64") == 2);
+
+  process({ core::events::bundle_announcement_received{
+              .pubkey = "bob_pubkey", .bundle_content = "Ym9i", .event_id = "bob_2", .created_at = 200 },
+    core::events::list_identities{} });
+  CHECK(fixture.bridge->call_count("extract_rdx_from_bundle_base64") == 2);
+
+  std::optional<core::events::identities_listed> listed;
+  while (auto presentation = fixture.presentation_out_queue->try_pop()) {
+    if (std::holds_alternative<core::events::identities_listed>(*presentation)) {
+      listed = std::get<core::events::identities_listed>(*presentation);
+    }
+  }
+  REQUIRE(listed.has_value());
+  CHECK(listed->identities.size() == 2);
+}
+
+TEST_CASE("session_orchestrator caches re-announced bundle data only when it changed", "[session_orchestrator][bundles]")
+{
+  const test_double_fixture_t fixture;
+  const auto process = [&fixture](std::vector<core::events::session_orchestrator::in_t> events) {
+    for (auto &event : events) { fixture.in_queue->push(std::move(event)); }
+    boost::asio::co_spawn(
+      *fixture.io_context,
+      // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+      [&fixture, count = events.size()]() -> boost::asio::awaitable<void> {
+        for (std::size_t i = 0; i < count; ++i) { co_await fixture.orchestrator->run_once(); }
+      },
+      boost::asio::detached);
+    fixture.io_context->run();
+    fixture.io_context->restart();
+  };
+
+  process({ core::events::bundle_announcement_received{
+              .pubkey = "bob_pubkey", .bundle_content = "Ym9i", .event_id = "bob_1", .created_at = 100 },
+    core::events::list_identities{} });
+  CHECK(fixture.bridge->call_count("save_discovered_bundle") == 2);
+  CHECK(fixture.bridge->cached_bundles.at("bob_pubkey").first.rdx_fingerprint == "RDX:extracted_fingerprint");
+
+  process({ core::events::bundle_announcement_received{
+    .pubkey = "bob_pubkey", .bundle_content = "Ym9i", .event_id = "bob_2", .created_at = 200 } });
+  CHECK(fixture.bridge->call_count("save_discovered_bundle") == 2);
+  CHECK(fixture.bridge->cached_bundles.at("bob_pubkey").first.rdx_fingerprint == "RDX:extracted_fingerprint");
+
+  process({ core::events::bundle_announcement_received{
+    .pubkey = "bob_pubkey", .bundle_content = "Ym9iMg==", .event_id = "bob_3", .created_at = 300 } });
+  CHECK(fixture.bridge->call_count("save_discovered_bundle") == 3);
+  CHECK(fixture.bridge->cached_bundles.at("bob_pubkey").first.event_id == "bob_3");
+  CHECK(fixture.bridge->cached_bundles.at("bob_pubkey").first.rdx_fingerprint.empty());
+}
+
+
+namespace {
+
+auto sent_filters(async::async_queue<core::events::transport::in_t> &queue, const std::string &type)
+  -> std::vector<nlohmann::json>
+{
+  std::vector<nlohmann::json> frames;
+  while (auto transport_cmd = queue.try_pop()) {
+    if (not std::holds_alternative<core::events::transport::send>(*transport_cmd)) { continue; }
+    auto parsed = nlohmann::json::parse(bytes_to_string(std::get<core::events::transport::send>(*transport_cmd).bytes));
+    if (parsed[0] == type) { frames.push_back(std::move(parsed)); }
+  }
+  return frames;
+}
+
+}// namespace
+
+TEST_CASE("session_orchestrator only refreshes contact bundles unless global discovery is enabled",
+  "[session_orchestrator][connect][bundles]")
+{
+  const auto connect = [](const test_double_fixture_t &fixture) {
+    fixture.in_queue->push(core::events::transport::connected{
+      .url = "wss://relay.example.com", .type = core::events::transport_type::internet });
+    boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+    fixture.io_context->run();
+    return sent_filters(*fixture.transport_out_queue, "REQ");
+  };
+
+  SECTION("no contacts")
+  {
+    const test_double_fixture_t fixture("", { .verify_event_signatures = false, .backfill_page_attempts = 1 });
+    const auto requests = connect(fixture);
+    REQUIRE(requests.size() == 2);
+    CHECK(requests[0][2]["kinds"][0] == 40001);
+    CHECK(requests[1][2].contains("until"));
+  }
+
+  SECTION("global discovery")
+  {
+    const test_double_fixture_t fixture("",
+      { .verify_event_signatures = false,
+        .discover_all_bundles = true,
+        .bundle_discovery_limit = 50,
+        .backfill_page_attempts = 1 });
+    const auto requests = connect(fixture);
+    REQUIRE(requests.size() == 3);
+    CHECK(requests[0][2]["kinds"][0] == 30078);
+    CHECK_FALSE(requests[0][2].contains("authors"));
+    CHECK(requests[0][2]["limit"] == 50);
+  }
+}
+
+TEST_CASE("session_orchestrator fetches the bundle of an unknown pubkey to trust",
+  "[session_orchestrator][trust][bundles]")
+{
+  const test_double_fixture_t fixture;
+  const std::string carol_pubkey(64, 'c');
+  fixture.bridge->contacts_to_return = { core::contact_info{ .rdx_fingerprint = "RDX:bob",
+    .nostr_pubkey = std::string(64, 'b'),
+    .user_alias = "bob",
+    .has_active_session = true } };
+
+  fixture.in_queue->push(events::trust{ .peer = carol_pubkey, .alias = "carol" });
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->poll();
+
+  const auto requests = sent_filters(*fixture.transport_out_queue, "REQ");
+  REQUIRE(requests.size() == 1);
+  CHECK(requests[0][2]["authors"] == nlohmann::json::array({ carol_pubkey }));
+  CHECK(requests[0][2]["kinds"][0] == 30078);
+  CHECK_FALSE(fixture.bridge->was_called("add_contact_and_establish_session_from_base64"));
+
+  const auto eose = nlohmann::json::array({ "EOSE", requests[0][1] }).dump();
+  fixture.in_queue->push(core::events::transport::bytes_received{ string_to_bytes(eose) });
+  fixture.in_queue->push(core::events::bundle_announcement_received{
+    .pubkey = carol_pubkey, .bundle_content = "Y2Fyb2w=", .event_id = "carol_bundle", .created_at = 100 });
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture]() -> boost::asio::awaitable<void> {
+      co_await fixture.orchestrator->run_once();
+      co_await fixture.orchestrator->run_once();
+    },
+    boost::asio::detached);
+  fixture.io_context->run();
+
+  CHECK(fixture.bridge->was_called("add_contact_and_establish_session_from_base64"));
+  CHECK(sent_filters(*fixture.transport_out_queue, "CLOSE").size() == 1);
+}
+
+TEST_CASE("session_orchestrator trusts an identity discovered before a restart without the relay",
+  "[session_orchestrator][trust][bundles][cache]")
+{
+  const auto timestamp =
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  const auto alice_db_path =
+    (std::filesystem::temp_directory_path() / ("test_bundle_cache_alice_" + std::to_string(timestamp) + ".db"))
+      .string();
+  const auto bob_db_path =
+    (std::filesystem::temp_directory_path() / ("test_bundle_cache_bob_" + std::to_string(timestamp) + ".db")).string();
+  const queue_based_fixture_t bob(bob_db_path);
+
+  auto bob_announcement_json =
+    nlohmann::json::parse(bob.bridge->generate_prekey_bundle_announcement("test-0.1.0").announcement_json);
+  auto bob_bundle_base64 = bob_announcement_json["content"].template get<std::string>();
+  auto bob_pubkey = bob_announcement_json["pubkey"].template get<std::string>();
+  auto bob_event_id = bob_announcement_json["id"].template get<std::string>();
+
+  {
+    const queue_based_fixture_t alice(alice_db_path);
+    alice.in_queue->push(core::events::bundle_announcement_received{
+      .pubkey = bob_pubkey, .bundle_content = bob_bundle_base64, .event_id = bob_event_id });
+    boost::asio::co_spawn(*alice.io_context, alice.orchestrator->run_once(), boost::asio::detached);
+    alice.io_context->run();
+  }
+
+  const queue_based_fixture_t alice(alice_db_path);
+  const auto bob_rdx = alice.bridge->extract_rdx_from_bundle_base64(bob_bundle_base64);
+  alice.in_queue->push(core::events::list_identities{});
+  alice.in_queue->push(core::events::trust{ .peer = bob_rdx, .alias = "Bob" });
+  boost::asio::co_spawn(
+    *alice.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&alice]() -> boost::asio::awaitable<void> {
+      co_await alice.orchestrator->run_once();
+      co_await alice.orchestrator->run_once();
+    },
+    boost::asio::detached);
+  alice.io_context->run();
+
+  auto listed = alice.presentation_out_queue->try_pop();
+  REQUIRE(listed.has_value());
+  REQUIRE(std::holds_alternative<core::events::identities_listed>(*listed));
+  REQUIRE(std::get<core::events::identities_listed>(*listed).identities.size() == 1);
+  CHECK(std::get<core::events::identities_listed>(*listed).identities[0].event_id == bob_event_id);
+
+  auto established = alice.presentation_out_queue->try_pop();
+  REQUIRE(established.has_value());
+  REQUIRE(std::holds_alternative<core::events::session_established>(*established));
+  CHECK(std::get<core::events::session_established>(*established).peer_rdx == bob_rdx);
+}
+
+TEST_CASE("session_orchestrator reconciles cached contact bundles with the relay",
+  "[session_orchestrator][connect][bundles][cache]")
+{
+  const test_double_fixture_t fixture;
+  const std::string bob_pubkey(64, 'b');
+  const std::string carol_pubkey(64, 'c');
+  fixture.bridge->contacts_to_return = { core::contact_info{
+    .rdx_fingerprint = "RDX:bob", .nostr_pubkey = bob_pubkey, .user_alias = "bob", .has_active_session = true } };
+  const auto cache = [&fixture](const std::string &pubkey, std::string event_id, std::uint64_t created_at) {
+    fixture.bridge->cached_bundles[pubkey] = { radix_relay::signal::cached_bundle{ .nostr_pubkey = pubkey,
+                                                 .rdx_fingerprint = "RDX:" + pubkey.substr(0, 4),
+                                                 .event_id = std::move(event_id),
+                                                 .created_at = created_at },
+      "Ym9keQ==" };
+  };
+  cache(bob_pubkey, "bob_1", 100);
+  cache(carol_pubkey, "carol_1", 300);
+
+  fixture.in_queue->push(core::events::transport::connected{
+    .url = "wss://relay.example.com", .type = core::events::transport_type::internet });
+  fixture.in_queue->push(core::events::bundle_announcement_received{
+    .pubkey = bob_pubkey, .bundle_content = "Ym9keQ==", .event_id = "bob_1", .created_at = 100 });
+  fixture.in_queue->push(core::events::bundle_announcement_received{
+    .pubkey = bob_pubkey, .bundle_content = "bmV3", .event_id = "bob_2", .created_at = 200 });
+  fixture.in_queue->push(core::events::bundle_announcement_removed{ .pubkey = carol_pubkey, .event_id = "carol_2" });
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture]() -> boost::asio::awaitable<void> {
+      for (int i = 0; i < 4; ++i) { co_await fixture.orchestrator->run_once(); }
+    },
+    boost::asio::detached);
+  fixture.io_context->poll();
+
+  const auto requests = sent_filters(*fixture.transport_out_queue, "REQ");
+  REQUIRE(requests.size() == 3);
+  CHECK(requests[0][2]["authors"] == nlohmann::json::array({ bob_pubkey }));
+  CHECK(requests[0][2]["since"] == 100);
+
+  CHECK(fixture.bridge->call_count("cached_discovered_bundles") == 1);
+  CHECK(fixture.bridge->call_count("save_discovered_bundle") == 1);
+  CHECK(fixture.bridge->cached_bundles.at(bob_pubkey).first.event_id == "bob_2");
+  CHECK(fixture.bridge->cached_bundles.at(bob_pubkey).second == "bmV3");
+  CHECK_FALSE(fixture.bridge->cached_bundles.contains(carol_pubkey));
+}
+
+namespace {
+
+auto subscription_frames(const test_double_fixture_t &fixture) -> std::vector<nlohmann::json>
+{
+  auto frames = drain_transport_frames(fixture);
+  std::erase_if(frames, [](const nlohmann::json &frame) { return frame[0] != "REQ" and frame[0] != "CLOSE"; });
+  return frames;
+}
+
+}// namespace
+
+TEST_CASE("session_orchestrator closes the identities subscription it replaces", "[session_orchestrator][subscribe]")
+{
+  const test_double_fixture_t fixture;
+
+  fixture.in_queue->push(events::subscribe_identities{});
+  fixture.in_queue->push(events::subscribe_identities{});
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture]() -> boost::asio::awaitable<void> {
+      co_await fixture.orchestrator->run_once();
+      co_await fixture.orchestrator->run_once();
+    },
+    boost::asio::detached);
+  fixture.io_context->poll();
+
+  const auto frames = subscription_frames(fixture);
+  REQUIRE(frames.size() == 3);
+  CHECK(frames[0][0] == "REQ");
+  CHECK(frames[1] == nlohmann::json::array({ "CLOSE", frames[0][1] }));
+  CHECK(frames[2][0] == "REQ");
+  CHECK(frames[2][1] != frames[0][1]);
+}
+
+TEST_CASE("session_orchestrator merges subscriptions at the relay's subscription limit",
+  "[session_orchestrator][subscribe][connect]")
+{
+  const test_double_fixture_t fixture("",
+    { .verify_event_signatures = false,
+      .discover_all_bundles = true,
+      .relay_max_subscriptions = { { "wss://small.example", 1 } } });
+
+  fixture.in_queue->push(
+    core::events::transport::connected{ .url = "wss://small.example", .type = core::events::transport_type::internet });
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->poll();
+
+  const auto frames = subscription_frames(fixture);
+  REQUIRE(frames.size() == 3);
+  CHECK(frames[0][0] == "REQ");
+  CHECK(frames[1] == nlohmann::json::array({ "CLOSE", frames[0][1] }));
+  REQUIRE(frames[2].size() == 4);
+  CHECK(frames[2][2]["kinds"][0] == 30078);
+  CHECK(frames[2][3]["kinds"][0] == 40001);
+}
+
+TEST_CASE("session_orchestrator lowers the subscription limit when the relay refuses one",
+  "[session_orchestrator][subscribe]")
+{
+  const test_double_fixture_t fixture("", { .verify_event_signatures = false, .backfill_page_size = 0 });
+
+  fixture.in_queue->push(events::subscribe_messages{});
+  fixture.in_queue->push(events::subscribe_identities{});
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture]() -> boost::asio::awaitable<void> {
+      co_await fixture.orchestrator->run_once();
+      co_await fixture.orchestrator->run_once();
+    },
+    boost::asio::detached);
+  fixture.io_context->poll();
+
+  const auto requests = subscription_frames(fixture);
+  REQUIRE(requests.size() == 2);
+
+  const auto refused =
+    nlohmann::json::array({ "CLOSED", requests[1][1], "rate-limited: too many concurrent REQs" }).dump();
+  fixture.in_queue->push(core::events::transport::bytes_received{ string_to_bytes(R"(["CLOSED","unknown",""])") });
+  fixture.in_queue->push(core::events::transport::bytes_received{ string_to_bytes(refused) });
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture]() -> boost::asio::awaitable<void> {
+      co_await fixture.orchestrator->run_once();
+      co_await fixture.orchestrator->run_once();
+    },
+    boost::asio::detached);
+  fixture.io_context->poll();
+
+  const auto frames = subscription_frames(fixture);
+  REQUIRE(frames.size() == 2);
+  CHECK(frames[0] == nlohmann::json::array({ "CLOSE", requests[0][1] }));
+  REQUIRE(frames[1][0] == "REQ");
+  REQUIRE(frames[1].size() == 4);
+  CHECK(frames[1][2]["kinds"][0] == 40001);
+  CHECK(frames[1][3]["kinds"][0] == 30078);
+}
+
+TEST_CASE("session_orchestrator reports a user subscription under the user's ID", "[session_orchestrator][subscribe]")
+{
+  const test_double_fixture_t fixture;
+
+  fixture.in_queue->push(events::subscribe{ .subscription_json = R"(["REQ","mine",{"kinds":[1],"limit":5}])" });
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->poll();
+
+  const auto requests = subscription_frames(fixture);
+  REQUIRE(requests.size() == 1);
+  CHECK(requests[0][1] != "mine");
+  CHECK(requests[0][2] == nlohmann::json::parse(R"({"kinds":[1],"limit":5})"));
+
+  const auto eose = nlohmann::json::array({ "EOSE", requests[0][1] }).dump();
+  fixture.in_queue->push(core::events::transport::bytes_received{ string_to_bytes(eose) });
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->poll();
+
+  std::optional<std::string> established;
+  while (auto presentation = fixture.presentation_out_queue->try_pop()) {
+    if (std::holds_alternative<events::subscription_established>(*presentation)) {
+      established = std::get<events::subscription_established>(*presentation).subscription_id;
+    }
+  }
+  CHECK(established == "mine");
+}
+
+namespace {
+
+auto page_event(const nlohmann::json &subscription_id, const std::string &event_id, std::uint64_t created_at)
+  -> std::string
+{
+  auto message = nlohmann::json::parse(make_encrypted_message_json(event_id, created_at));
+  message[1] = subscription_id;
+  return message.dump();
+}
+
+auto deliver(const test_double_fixture_t &fixture, const std::vector<std::string> &messages) -> void
+{
+  for (const auto &message : messages) {
+    fixture.in_queue->push(core::events::transport::bytes_received{ string_to_bytes(message) });
+  }
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture, count = messages.size()]() -> boost::asio::awaitable<void> {
+      for (std::size_t i = 0; i < count; ++i) { co_await fixture.orchestrator->run_once(); }
+    },
+    boost::asio::detached);
+  fixture.io_context->poll();
+}
+
+auto backfill_updates(const test_double_fixture_t &fixture) -> std::vector<events::backfill_progress>
+{
+  std::vector<events::backfill_progress> updates;
+  while (auto presentation = fixture.presentation_out_queue->try_pop()) {
+    if (std::holds_alternative<events::backfill_progress>(*presentation)) {
+      updates.push_back(std::get<events::backfill_progress>(*presentation));
+    }
+  }
+  return updates;
+}
+
+}// namespace
+
+TEST_CASE("session_orchestrator pages stored messages backwards one EOSE at a time",
+  "[session_orchestrator][messages][backfill]")
+{
+  const test_double_fixture_t fixture("", { .verify_event_signatures = false, .backfill_page_size = 2 });
+  constexpr std::uint64_t persisted_timestamp = 1700000000;
+  fixture.bridge->update_last_message_timestamp(persisted_timestamp);
+
+  fixture.in_queue->push(events::subscribe_messages{});
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->poll();
+
+  auto frames = subscription_frames(fixture);
+  REQUIRE(frames.size() == 2);
+  const auto first_page = frames[1];
+  const auto until = first_page[2]["until"].get<std::uint64_t>();
+  CHECK(first_page[2]["since"] == persisted_timestamp);
+  CHECK(first_page[2]["limit"] == 2);
+
+  deliver(fixture,
+    { page_event(first_page[1], "newer", until - 10), page_event(first_page[1], "older", until - 20) });
+  CHECK(subscription_frames(fixture).empty());
+
+  deliver(fixture, { nlohmann::json::array({ "EOSE", first_page[1] }).dump() });
+  frames = subscription_frames(fixture);
+  REQUIRE(frames.size() == 2);
+  CHECK(frames[0] == nlohmann::json::array({ "CLOSE", first_page[1] }));
+  const auto second_page = frames[1];
+  CHECK(second_page[2]["until"] == until - 20);
+  CHECK(fixture.bridge->last_message_timestamp == persisted_timestamp);
+
+  auto updates = backfill_updates(fixture);
+  REQUIRE(updates.size() == 1);
+  CHECK(updates[0].messages == 2);
+  CHECK_FALSE(updates[0].complete);
+
+  deliver(fixture,
+    { page_event(second_page[1], "older", until - 20), nlohmann::json::array({ "EOSE", second_page[1] }).dump() });
+  frames = subscription_frames(fixture);
+  REQUIRE(frames.size() == 1);
+  CHECK(frames[0] == nlohmann::json::array({ "CLOSE", second_page[1] }));
+
+  updates = backfill_updates(fixture);
+  REQUIRE(updates.size() == 1);
+  CHECK(updates[0].pages == 2);
+  CHECK(updates[0].messages == 2);
+  CHECK(updates[0].complete);
+
+  fixture.io_context->run();
+  CHECK(fixture.bridge->last_message_timestamp == until - 10);
+}
+
+TEST_CASE("session_orchestrator retries a backfill page the relay did not finish",
+  "[session_orchestrator][messages][backfill]")
+{
+  const test_double_fixture_t fixture(
+    "", { .verify_event_signatures = false, .backfill_page_size = 2, .backfill_page_attempts = 2 });
+  fixture.bridge->update_last_message_timestamp(1700000000);
+
+  fixture.in_queue->push(events::subscribe_messages{});
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->poll();
+
+  auto frames = subscription_frames(fixture);
+  REQUIRE(frames.size() == 2);
+  const auto first_try = frames[1];
+  const auto until = first_try[2]["until"].get<std::uint64_t>();
+  deliver(fixture, { page_event(first_try[1], "newer", until - 10) });
+
+  // The EOSE wait times out, and the retry timer fires after it
+  const auto next_frame = [&fixture]() -> nlohmann::json {
+    auto pending = subscription_frames(fixture);
+    while (pending.empty() and fixture.io_context->run_one() > 0) { pending = subscription_frames(fixture); }
+    CHECK(pending.size() == 1);
+    return pending.empty() ? nlohmann::json{} : pending.front();
+  };
+  CHECK(next_frame() == nlohmann::json::array({ "CLOSE", first_try[1] }));
+  const auto second_try = next_frame();
+  CHECK(second_try[0] == "REQ");
+  CHECK(second_try[2] == first_try[2]);
+
+  deliver(fixture,
+    { page_event(second_try[1], "newer", until - 10), nlohmann::json::array({ "EOSE", second_try[1] }).dump() });
+  frames = subscription_frames(fixture);
+  REQUIRE(frames.size() == 1);
+  CHECK(frames[0] == nlohmann::json::array({ "CLOSE", second_try[1] }));
+
+  const auto updates = backfill_updates(fixture);
+  REQUIRE(updates.size() == 1);
+  CHECK(updates[0].pages == 1);
+  CHECK(updates[0].messages == 1);
+  CHECK(updates[0].complete);
+}
+
+TEST_CASE("session_orchestrator stops the backfill after a page fails too often",
+  "[session_orchestrator][messages][backfill]")
+{
+  const test_double_fixture_t fixture(
+    "", { .verify_event_signatures = false, .backfill_page_size = 2, .backfill_page_attempts = 2 });
+  constexpr std::uint64_t persisted_timestamp = 1700000000;
+  fixture.bridge->update_last_message_timestamp(persisted_timestamp);
+
+  fixture.in_queue->push(events::subscribe_messages{});
+  boost::asio::co_spawn(*fixture.io_context, fixture.orchestrator->run_once(), boost::asio::detached);
+  fixture.io_context->run();
+
+  std::vector<std::string> frame_types;
+  for (const auto &frame : subscription_frames(fixture)) { frame_types.push_back(frame[0].get<std::string>()); }
+  CHECK(frame_types == std::vector<std::string>{ "REQ", "REQ", "CLOSE", "REQ", "CLOSE" });
+  CHECK(backfill_updates(fixture).empty());
+  CHECK(fixture.bridge->last_message_timestamp == persisted_timestamp);
+}
+
+TEST_CASE("session_orchestrator applies the limits the relay advertises", "[session_orchestrator][relay_limits]")
+{
+  const test_double_fixture_t fixture("", { .verify_event_signatures = false, .discover_all_bundles = true });
+  fixture.bridge->signed_event_id = radix_relay::nostr::compute_event_id;
+
+  fixture.in_queue->push(core::events::transport::connected{ .url = "wss://strict.example",
+    .type = core::events::transport_type::internet,
+    .limits = { .max_limit = 50, .min_pow_difficulty = 6 } });
+  fixture.in_queue->push(events::send{ .peer = "alice", .message = "hi" });
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture]() -> boost::asio::awaitable<void> {
+      co_await fixture.orchestrator->run_once();
+      co_await fixture.orchestrator->run_once();
+    },
+    boost::asio::detached);
+  fixture.io_context->run();
+
+  std::vector<nlohmann::json> limits;
+  for (const auto &frame : subscription_frames(fixture)) {
+    if (frame[0] != "REQ") { continue; }
+    for (std::size_t index = 2; index < frame.size(); ++index) {
+      if (frame[index].contains("limit")) { limits.push_back(frame[index]["limit"]); }
+    }
+  }
+  REQUIRE(limits.size() >= 2);
+  CHECK(std::ranges::all_of(limits, [](const nlohmann::json &limit) { return limit == 50; }));
+
+  REQUIRE_FALSE(fixture.bridge->last_signed_tags.empty());
+  CHECK(fixture.bridge->last_signed_tags.back().front() == "nonce");
+  CHECK(fixture.bridge->last_signed_tags.back().back() == "6");
+}
+
+TEST_CASE("session_orchestrator fails events larger than the relay accepts without sending them",
+  "[session_orchestrator][relay_limits]")
+{
+  const test_double_fixture_t fixture;
+
+  fixture.in_queue->push(core::events::transport::connected{ .url = "wss://tiny.example",
+    .type = core::events::transport_type::internet,
+    .limits = { .max_message_length = 16 } });
+  fixture.in_queue->push(events::send_many{ .peers = { "alice", "bob" }, .message = "hi" });
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture]() -> boost::asio::awaitable<void> {
+      co_await fixture.orchestrator->run_once();
+      co_await fixture.orchestrator->run_once();
+    },
+    boost::asio::detached);
+  fixture.io_context->poll();
+
+  while (auto transport_cmd = fixture.transport_out_queue->try_pop()) {
+    CHECK_FALSE(std::holds_alternative<core::events::transport::send>(*transport_cmd));
+    CHECK_FALSE(std::holds_alternative<core::events::transport::send_batch>(*transport_cmd));
+  }
+
+  std::optional<events::send_many_report> report;
+  while (auto presentation = fixture.presentation_out_queue->try_pop()) {
+    if (std::holds_alternative<events::send_many_report>(*presentation)) {
+      report = std::get<events::send_many_report>(*presentation);
+    }
+  }
+  REQUIRE(report.has_value());
+  CHECK(report->accepted.empty());
+  CHECK(report->failed == std::vector<std::string>{ "alice", "bob" });
+}
+
+TEST_CASE("session_orchestrator tries the healthiest candidate relay first", "[session_orchestrator][relay_health]")
+{
+  const test_double_fixture_t fixture;
+
+  fixture.in_queue->push(events::connect{ .relay = "wss://first.example  wss://second.example" });
+  fixture.in_queue->push(core::events::transport::connect_failed{
+    .url = "wss://first.example", .error_message = "refused", .type = core::events::transport_type::internet });
+  fixture.in_queue->push(events::connect{ .relay = "wss://first.example wss://second.example" });
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture]() -> boost::asio::awaitable<void> {
+      co_await fixture.orchestrator->run_once();
+      co_await fixture.orchestrator->run_once();
+      co_await fixture.orchestrator->run_once();
+    },
+    boost::asio::detached);
+  fixture.io_context->run();
+
+  std::vector<std::string> connects;
+  while (auto transport_cmd = fixture.transport_out_queue->try_pop()) {
+    REQUIRE(std::holds_alternative<core::events::transport::connect>(*transport_cmd));
+    connects.push_back(std::get<core::events::transport::connect>(*transport_cmd).url);
+  }
+  CHECK(connects == std::vector<std::string>{ "wss://first.example", "wss://second.example", "wss://second.example" });
+
+  std::optional<core::events::connection_monitor::relay_stats> stats;
+  while (auto monitor_evt = fixture.connection_monitor_out_queue->try_pop()) {
+    if (std::holds_alternative<core::events::connection_monitor::relay_stats>(*monitor_evt)) {
+      stats = std::get<core::events::connection_monitor::relay_stats>(*monitor_evt);
+    }
+  }
+  REQUIRE(stats.has_value());
+  CHECK(stats->url == "wss://first.example");
+  CHECK(stats->score == 0U);
+}
+
+TEST_CASE("session_orchestrator reports how long connecting to the relay took", "[session_orchestrator][relay_health]")
+{
+  const test_double_fixture_t fixture;
+
+  fixture.in_queue->push(core::events::transport::connected{ .url = "wss://relay.example",
+    .type = core::events::transport_type::internet,
+    .limits = {},
+    .connect_ms = 180 });
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture]() -> boost::asio::awaitable<void> { co_await fixture.orchestrator->run_once(); },
+    boost::asio::detached);
+  fixture.io_context->run();
+
+  std::optional<core::events::connection_monitor::relay_stats> stats;
+  while (auto monitor_evt = fixture.connection_monitor_out_queue->try_pop()) {
+    if (not stats and std::holds_alternative<core::events::connection_monitor::relay_stats>(*monitor_evt)) {
+      stats = std::get<core::events::connection_monitor::relay_stats>(*monitor_evt);
+    }
+  }
+  REQUIRE(stats.has_value());
+  CHECK(stats->url == "wss://relay.example");
+  CHECK(stats->connect_p50_ms == 180U);
+  CHECK_FALSE(stats->ok_p50_ms.has_value());
+}
+
+TEST_CASE("session_orchestrator adapts the OK timeout to the latency of the relay",
+  "[session_orchestrator][relay_health]")
+{
+  const test_double_fixture_t fixture("",
+    { .min_request_timeout = std::chrono::milliseconds(10),
+      .request_timeout_multiplier = 3,
+      .verify_event_signatures = false });
+  const std::vector<std::string> peers{ "alice", "bob", "carol", "dave", "erin" };
+
+  fixture.in_queue->push(core::events::transport::connected{
+    .url = "wss://relay.example", .type = core::events::transport_type::internet });
+  fixture.in_queue->push(events::send_many{ .peers = peers, .message = "hi" });
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture]() -> boost::asio::awaitable<void> {
+      co_await fixture.orchestrator->run_once();
+      co_await fixture.orchestrator->run_once();
+    },
+    boost::asio::detached);
+  fixture.io_context->poll();
+
+  for (const auto &peer : peers) {
+    fixture.in_queue->push(core::events::transport::bytes_received{
+      string_to_bytes(R"(["OK","test_message_event_id_)" + peer + R"(",true,""])") });
+  }
+  boost::asio::co_spawn(
+    *fixture.io_context,
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-capturing-lambda-coroutines)
+    [&fixture, count = peers.size()]() -> boost::asio::awaitable<void> {
+      for (std::size_t index = 0; index < count; ++index) { co_await fixture.orchestrator->run_once(); }
+    },
+    boost::asio::detached);
+  fixture.io_context->poll();
+
+  std::vector<core::events::connection_monitor::relay_stats> stats;
+  while (auto monitor_evt = fixture.connection_monitor_out_queue->try_pop()) {
+    if (std::holds_alternative<core::events::connection_monitor::relay_stats>(*monitor_evt)) {
+      stats.push_back(std::get<core::events::connection_monitor::relay_stats>(*monitor_evt));
+    }
+  }
+  REQUIRE(stats.size() == peers.size());
+  CHECK(stats.front().request_timeout_ms == 100);
+  const auto &latest = stats.back();
+  CHECK(latest.url == "wss://relay.example");
+  CHECK(latest.ok_p50_ms.has_value());
+  CHECK(latest.timeouts == 0);
+  CHECK(latest.score >= 90U);
+  CHECK(latest.request_timeout_ms >= 10);
+  CHECK(latest.request_timeout_ms < 100);
+}
+
 }// namespace radix_relay::core::test
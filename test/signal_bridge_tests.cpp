@@ -226,6 +226,84 @@ TEST_CASE("signal::bridge generate_empty_bundle_announcement creates valid empty
   std::filesystem::remove(db_path);
 }
 
+TEST_CASE("signal::bridge typed signing returns wire-ready EVENT frames", "[signal][wrapper][signing]")
+{
+  auto timestamp =
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  auto alice_db = (std::filesystem::path(radix_relay::platform::get_temp_directory())
+                   / ("test_wrapper_frame_alice_" + std::to_string(timestamp) + ".db"))
+                    .string();
+  auto bob_db = (std::filesystem::path(radix_relay::platform::get_temp_directory())
+                 / ("test_wrapper_frame_bob_" + std::to_string(timestamp) + ".db"))
+                  .string();
+
+  const auto parse_frame = [](const std::vector<std::byte> &bytes) {
+    std::string frame(bytes.size(), '\0');
+    std::transform(bytes.begin(), bytes.end(), frame.begin(), [](std::byte byte) { return static_cast<char>(byte); });
+    return nlohmann::json::parse(frame);
+  };
+
+  {
+    auto alice = std::make_shared<radix_relay::signal::bridge>(alice_db);
+    auto bob = std::make_shared<radix_relay::signal::bridge>(bob_db);
+
+    SECTION("sign_event_frame signs typed fields")
+    {
+      const std::vector<std::vector<std::string>> tags{ { "t", "radix" }, { "radix_version", "test-0.1.0" } };
+      auto signed_frame = alice->sign_event_frame(1, tags, "hello \"relay\"", 1234567890);
+      auto frame = parse_frame(signed_frame.bytes);
+
+      REQUIRE(frame.is_array());
+      REQUIRE(frame.size() == 2);
+      CHECK(frame[0] == "EVENT");
+      CHECK(frame[1]["id"] == signed_frame.event_id);
+      CHECK(frame[1]["kind"] == 1);
+      CHECK(frame[1]["created_at"] == 1234567890);
+      CHECK(frame[1]["content"] == "hello \"relay\"");
+      CHECK(frame[1]["tags"] == nlohmann::json(tags));
+      CHECK(frame[1]["sig"].template get<std::string>().size() == 128);
+    }
+
+    SECTION("create_encrypted_message_frame carries base64 ciphertext and recipient tag")
+    {
+      auto bob_bundle_info = bob->generate_prekey_bundle_announcement("test-0.1.0");
+      auto bob_bundle_json = nlohmann::json::parse(bob_bundle_info.announcement_json);
+      auto bob_rdx =
+        alice->add_contact_and_establish_session_from_base64(bob_bundle_json["content"].template get<std::string>(), "");
+
+      const std::string plaintext = "Hello Bob!";
+      auto ciphertext = alice->encrypt_message(bob_rdx, { plaintext.begin(), plaintext.end() });
+      auto signed_frame = alice->create_encrypted_message_frame(bob_rdx, ciphertext, 1234567890, "test-0.1.0");
+      auto frame = parse_frame(signed_frame.bytes);
+
+      REQUIRE(frame.size() == 2);
+      CHECK(frame[0] == "EVENT");
+      CHECK(frame[1]["id"] == signed_frame.event_id);
+      CHECK(frame[1]["kind"] == 40001);
+      CHECK(frame[1]["content"].template get<std::string>().size() == ((ciphertext.size() + 2) / 3) * 4);
+      CHECK(frame[1]["tags"][0][0] == "p");
+      CHECK(frame[1]["tags"][0][1].template get<std::string>().size() == 64);
+      CHECK(frame[1]["tags"][1] == nlohmann::json::array({ "radix_version", "test-0.1.0", "base64" }));
+    }
+
+    SECTION("bundle announcements include their frame")
+    {
+      auto bundle_info = alice->generate_prekey_bundle_announcement("test-0.1.0");
+      auto frame = parse_frame(bundle_info.frame);
+      CHECK(frame[0] == "EVENT");
+      CHECK(frame[1] == nlohmann::json::parse(bundle_info.announcement_json));
+      CHECK(frame[1]["id"] == bundle_info.event_id);
+
+      auto empty_frame = alice->generate_empty_bundle_frame("test-0.1.0");
+      auto empty = parse_frame(empty_frame.bytes);
+      CHECK(empty[1]["id"] == empty_frame.event_id);
+      CHECK(empty[1]["content"].template get<std::string>().empty());
+    }
+  }
+  std::filesystem::remove(alice_db);
+  std::filesystem::remove(bob_db);
+}
+
 TEST_CASE("signal::bridge decrypt_message signals pre-key consumption", "[signal][wrapper][encryption]")
 {
   auto timestamp =
@@ -332,6 +410,38 @@ TEST_CASE("signal::bridge record_published_bundle tracks bundle state", "[signal
   }
 }
 
+TEST_CASE("signal::bridge caches discovered bundles across restarts", "[signal][wrapper][bundle]")
+{
+  auto timestamp =
+    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  auto db_path = (std::filesystem::path(radix_relay::platform::get_temp_directory())
+                  / ("test_bundle_cache_" + std::to_string(timestamp) + ".db"))
+                   .string();
+  const std::string bob_pubkey(64, 'b');
+
+  {
+    auto wrapper = radix_relay::signal::bridge(db_path);
+    wrapper.save_discovered_bundle(
+      { .nostr_pubkey = bob_pubkey, .rdx_fingerprint = "", .event_id = "bob_2", .created_at = 200 }, "bmV3");
+    wrapper.save_discovered_bundle(
+      { .nostr_pubkey = bob_pubkey, .rdx_fingerprint = "", .event_id = "bob_1", .created_at = 100 }, "b2xk");
+  }
+
+  {
+    auto wrapper = radix_relay::signal::bridge(db_path);
+    const auto cached = wrapper.cached_discovered_bundles();
+    REQUIRE(cached.size() == 1);
+    CHECK(cached[0].event_id == "bob_2");
+    CHECK(cached[0].created_at == 200);
+    CHECK(wrapper.load_discovered_bundle(bob_pubkey) == "bmV3");
+
+    wrapper.forget_discovered_bundle(bob_pubkey);
+    CHECK(wrapper.cached_discovered_bundles().empty());
+    CHECK(wrapper.load_discovered_bundle(bob_pubkey).empty());
+  }
+  std::filesystem::remove(db_path);
+}
+
 TEST_CASE("signal::bridge X3DH initial message from unknown sender", "[signal][wrapper][x3dh][unknown-sender]")
 {
   auto timestamp =
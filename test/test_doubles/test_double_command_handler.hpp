@@ -57,9 +57,24 @@ struct recording_command_handler
     called_commands.push_back("send:" + command.peer + ":" + command.message);
   }
 
+  auto operator()(const radix_relay::core::events::send_many &command) const -> void
+  {
+    called_commands.push_back("send_many:" + std::to_string(command.peers.size()) + ":" + command.message);
+  }
+
+  auto operator()(const radix_relay::core::events::send_file &command) const -> void
+  {
+    called_commands.push_back("send_file:" + command.peer + ":" + command.path);
+  }
+
   auto operator()(const radix_relay::core::events::broadcast &command) const -> void
   {
-    called_commands.push_back("broadcast:" + command.message);
+    called_commands.push_back("broadcast:" + command.group + ":" + command.message);
+  }
+
+  auto operator()(const radix_relay::core::events::create_group &command) const -> void
+  {
+    called_commands.push_back("create_group:" + command.name);
   }
 
   auto operator()(const radix_relay::core::events::connect &command) const -> void
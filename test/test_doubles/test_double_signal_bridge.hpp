@@ -1,15 +1,26 @@
 #pragma once
 
 #include <algorithm>
+#include <bit>
 #include <concepts/signal_bridge.hpp>
 #include <core/contact_info.hpp>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <set>
 #include <signal_types/signal_types.hpp>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace radix_relay_test {
 
+/// Records calls made through the signal bridge concept.
+///
+/// Maintenance, proof-of-work and verification run bridge calls on worker threads, so every
+/// method holds a lock. Tests read the public fields directly only after those workers reported back.
 struct test_double_signal_bridge
 {
   mutable std::vector<std::string> called_methods;
@@ -19,18 +30,21 @@ struct test_double_signal_bridge
 
   auto get_node_fingerprint() const -> std::string
   {
+    const std::scoped_lock lock(mutex_);
     called_methods.push_back("get_node_fingerprint");
     return fingerprint_to_return;
   }
 
   auto list_contacts() const -> std::vector<radix_relay::core::contact_info>
   {
+    const std::scoped_lock lock(mutex_);
     called_methods.push_back("list_contacts");
     return contacts_to_return;
   }
 
   auto was_called(const std::string &method) const -> bool
   {
+    const std::scoped_lock lock(mutex_);
     return std::any_of(called_methods.cbegin(), called_methods.cend(), [&method](const std::string &called) {
       return called == method;
     });
@@ -38,13 +52,19 @@ struct test_double_signal_bridge
 
   auto call_count(const std::string &method) const -> size_t
   {
+    const std::scoped_lock lock(mutex_);
     return static_cast<size_t>(std::count(called_methods.begin(), called_methods.end(), method));
   }
 
-  auto clear_calls() -> void { called_methods.clear(); }
+  auto clear_calls() -> void
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.clear();
+  }
 
   auto encrypt_message(const std::string & /*rdx*/, const std::vector<uint8_t> &bytes) const -> std::vector<uint8_t>
   {
+    const std::scoped_lock lock(mutex_);
     called_methods.push_back("encrypt_message");
     return bytes;
   }
@@ -52,25 +72,172 @@ struct test_double_signal_bridge
   auto decrypt_message(const std::string & /*rdx*/, const std::vector<uint8_t> &bytes) const
     -> radix_relay::signal::decryption_result
   {
+    const std::scoped_lock lock(mutex_);
     called_methods.push_back("decrypt_message");
     return {
       .plaintext = bytes,
-      .should_republish_bundle = false,
+      .should_republish_bundle = should_republish_bundle_to_return,
     };
   }
 
+  auto record_peer_compression(const std::string &rdx, bool supported) const -> void
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("record_peer_compression");
+    compression_peer = rdx;
+    compression_supported = supported;
+  }
+
+  auto record_peer_base64_content(const std::string &rdx, bool supported) const -> void
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("record_peer_base64_content");
+    base64_content_peer = rdx;
+    base64_content_supported = supported;
+  }
+
   auto add_contact_and_establish_session_from_base64(const std::string & /*bundle*/,
     const std::string & /*alias*/) const -> std::string
   {
+    const std::scoped_lock lock(mutex_);
     called_methods.push_back("add_contact_and_establish_session_from_base64");
     return "RDX:new_contact";
   }
 
+  auto create_group(const std::string &name, const std::vector<std::string> &members) const -> std::string
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("create_group");
+    created_group_name = name;
+    created_group_members = members;
+    return "test_group_id";
+  }
+
+  auto create_sender_key_distribution_frames(const std::string & /*group*/,
+    std::uint64_t /*timestamp*/,
+    const std::string & /*version*/) const -> std::vector<radix_relay::signal::fan_out_frame>
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("create_sender_key_distribution_frames");
+    std::vector<radix_relay::signal::fan_out_frame> frames;
+    for (const auto &member : members_awaiting_sender_key) {
+      const auto event_id = "test_distribution_event_id_" + member;
+      frames.push_back({
+        .recipient = member,
+        .event_id = event_id,
+        .bytes = to_frame(R"({"id":")" + event_id + R"(","kind":40006,"tags":[["p",")" + member
+                          + R"("]],"content":"","sig":"test_signature"})"),
+        .error = "",
+      });
+    }
+    return frames;
+  }
+
+  auto mark_sender_key_delivered(const std::string & /*group*/, const std::string &member_rdx) const -> void
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("mark_sender_key_delivered");
+    std::erase(members_awaiting_sender_key, member_rdx);
+  }
+
+  auto create_group_message_frame(const std::string & /*group*/,
+    const std::vector<uint8_t> & /*plaintext*/,
+    std::uint64_t /*timestamp*/,
+    const std::string & /*version*/) const -> radix_relay::signal::signed_event_frame
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("create_group_message_frame");
+    return {
+      .event_id = "test_group_event_id",
+      .bytes = to_frame(
+        R"({"id":"test_group_event_id","pubkey":"test_pubkey","created_at":1234567890,"kind":40005,"tags":[["g","test_group_id"]],"content":"","sig":"test_signature"})"),
+    };
+  }
+
+  auto process_sender_key_distribution(const std::string & /*rdx*/, const std::vector<uint8_t> & /*bytes*/) const
+    -> radix_relay::signal::group_membership
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("process_sender_key_distribution");
+    return { .group_id = "test_group_id",
+      .name = "test_group",
+      .sender_rdx = "RDX:sender",
+      .should_republish_bundle = should_republish_bundle_to_return };
+  }
+
+  auto decrypt_group_message(const std::string & /*rdx*/,
+    const std::string &group_id,
+    const std::vector<uint8_t> &bytes) const -> radix_relay::signal::group_decryption_result
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("decrypt_group_message");
+    return { .group_id = group_id, .name = "test_group", .sender_rdx = "RDX:sender", .plaintext = bytes };
+  }
+
+  auto start_file_transfer(const std::string &peer, const std::string &path) const
+    -> radix_relay::signal::outgoing_transfer
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("start_file_transfer");
+    if (not file_transfer_error.empty()) { throw std::runtime_error(file_transfer_error); }
+    radix_relay::signal::outgoing_transfer transfer{ .transfer_id = "test_transfer_id",
+      .peer_rdx = peer,
+      .name = path.substr(path.find_last_of('/') + 1),
+      .chunk_count = transfer_chunk_count,
+      .pending_chunks = {} };
+    for (std::uint32_t index = 0; index < transfer_chunk_count; ++index) { transfer.pending_chunks.push_back(index); }
+    pending_transfers.push_back(transfer);
+    return transfer;
+  }
+
+  auto pending_file_transfers() const -> std::vector<radix_relay::signal::outgoing_transfer>
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("pending_file_transfers");
+    return pending_transfers;
+  }
+
+  auto create_transfer_chunk_frame(const std::string &transfer_id,
+    std::uint32_t chunk_index,
+    std::uint64_t /*timestamp*/,
+    const std::string & /*version*/) const -> radix_relay::signal::signed_event_frame
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("create_transfer_chunk_frame");
+    const auto event_id = "test_chunk_event_id_" + std::to_string(chunk_index);
+    return {
+      .event_id = event_id,
+      .bytes = to_frame(R"({"id":")" + event_id + R"(","kind":40007,"tags":[["t",")" + transfer_id
+                        + R"("]],"content":"","sig":"test_signature"})"),
+    };
+  }
+
+  auto mark_transfer_chunk_delivered(const std::string &transfer_id, std::uint32_t chunk_index) const -> bool
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("mark_transfer_chunk_delivered");
+    const auto transfer = std::ranges::find_if(
+      pending_transfers, [&transfer_id](const auto &pending) { return pending.transfer_id == transfer_id; });
+    if (transfer == pending_transfers.end()) { return true; }
+    std::erase(transfer->pending_chunks, chunk_index);
+    if (not transfer->pending_chunks.empty()) { return false; }
+    pending_transfers.erase(transfer);
+    return true;
+  }
+
+  auto process_transfer_chunk(const std::string & /*rdx*/, const std::vector<uint8_t> & /*bytes*/) const
+    -> radix_relay::signal::transfer_progress
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("process_transfer_chunk");
+    return transfer_progress_to_return;
+  }
+
   auto generate_prekey_bundle_announcement(const std::string & /*version*/) const -> radix_relay::signal::bundle_info
   {
+    const std::scoped_lock lock(mutex_);
     called_methods.push_back("generate_prekey_bundle_announcement");
-    return {
-      .announcement_json = R"({
+    const std::string announcement_json = R"({
         "id": "test_bundle_event_id",
         "pubkey": "test_pubkey",
         "created_at": 1234567890,
@@ -78,32 +245,85 @@ struct test_double_signal_bridge
         "tags": [["d", "radix_prekey_bundle_v1"], ["v", "test-0.1.0"]],
         "content": "test_bundle_content_base64",
         "sig": "test_signature"
-      })",
+      })";
+    return {
+      .announcement_json = announcement_json,
       .pre_key_id = 100,
       .signed_pre_key_id = 1,
       .kyber_pre_key_id = 1,
+      .event_id = "test_bundle_event_id",
+      .frame = to_frame(announcement_json),
     };
   }
 
   auto generate_empty_bundle_announcement(const std::string & /*version*/) const -> std::string
   {
+    const std::scoped_lock lock(mutex_);
     called_methods.push_back("generate_empty_bundle_announcement");
     return "{}";
   }
 
+  auto generate_empty_bundle_frame(const std::string & /*version*/) const -> radix_relay::signal::signed_event_frame
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("generate_empty_bundle_frame");
+    return {
+      .event_id = "test_empty_bundle_event_id",
+      .bytes = to_frame(
+        R"({"id":"test_empty_bundle_event_id","pubkey":"test_pubkey","created_at":1234567890,"kind":30078,"tags":[["d","radix_prekey_bundle_v1"]],"content":"","sig":"test_signature"})"),
+    };
+  }
+
   auto extract_rdx_from_bundle_base64(const std::string & /*bundle_base64*/) const -> std::string
   {
+    const std::scoped_lock lock(mutex_);
     called_methods.push_back("extract_rdx_from_bundle_base64");
     return "RDX:extracted_fingerprint";
   }
 
+  auto save_discovered_bundle(const radix_relay::signal::cached_bundle &bundle, const std::string &bundle_base64) const
+    -> void
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("save_discovered_bundle");
+    const auto existing = cached_bundles.find(bundle.nostr_pubkey);
+    if (existing != cached_bundles.end() and existing->second.first.created_at > bundle.created_at) { return; }
+    cached_bundles[bundle.nostr_pubkey] = { bundle, bundle_base64 };
+  }
+
+  auto cached_discovered_bundles() const -> std::vector<radix_relay::signal::cached_bundle>
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("cached_discovered_bundles");
+    std::vector<radix_relay::signal::cached_bundle> result;
+    for (const auto &[pubkey, entry] : cached_bundles) { result.push_back(entry.first); }
+    return result;
+  }
+
+  auto load_discovered_bundle(const std::string &nostr_pubkey) const -> std::string
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("load_discovered_bundle");
+    const auto existing = cached_bundles.find(nostr_pubkey);
+    return existing != cached_bundles.end() ? existing->second.second : std::string{};
+  }
+
+  auto forget_discovered_bundle(const std::string &nostr_pubkey) const -> void
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("forget_discovered_bundle");
+    cached_bundles.erase(nostr_pubkey);
+  }
+
   auto assign_contact_alias(const std::string & /*rdx*/, const std::string & /*alias*/) const -> void
   {
+    const std::scoped_lock lock(mutex_);
     called_methods.push_back("assign_contact_alias");
   }
 
   auto lookup_contact(const std::string &alias) const -> radix_relay::core::contact_info
   {
+    const std::scoped_lock lock(mutex_);
     called_methods.push_back("lookup_contact");
     if (not contacts_to_return.empty()) {
       const auto it = std::find_if(contacts_to_return.cbegin(),
@@ -125,36 +345,107 @@ struct test_double_signal_bridge
     uint32_t /*timestamp*/,
     const std::string & /*version*/) const -> std::string
   {
+    const std::scoped_lock lock(mutex_);
     called_methods.push_back("create_and_sign_encrypted_message");
     return "{}";
   }
 
   auto sign_nostr_event(const std::string & /*event_json*/) const -> std::string
   {
+    const std::scoped_lock lock(mutex_);
     called_methods.push_back("sign_nostr_event");
     return "{}";
   }
 
-  auto create_subscription_for_self(const std::string &subscription_id, std::uint64_t since_timestamp = 0) const
-    -> std::string
+  auto create_encrypted_message_frame(const std::string & /*rdx*/,
+    const std::vector<uint8_t> & /*ciphertext*/,
+    std::uint64_t /*timestamp*/,
+    const std::string & /*version*/) const -> radix_relay::signal::signed_event_frame
   {
-    called_methods.push_back("create_subscription_for_self");
-    const auto timestamp_to_use = since_timestamp > 0 ? since_timestamp : last_message_timestamp;
-    if (timestamp_to_use > 0) {
-      return R"(["REQ",")" + subscription_id + R"(",{"kinds":[40001],"#p":["test_pubkey"],"since":)"
-             + std::to_string(timestamp_to_use) + R"(}])";
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("create_encrypted_message_frame");
+    return {
+      .event_id = "test_message_event_id",
+      .bytes = to_frame(
+        R"({"id":"test_message_event_id","pubkey":"test_pubkey","created_at":1234567890,"kind":40001,"tags":[],"content":"","sig":"test_signature"})"),
+    };
+  }
+
+  auto create_encrypted_message_frames(const std::vector<std::string> &peers,
+    const std::vector<uint8_t> & /*plaintext*/,
+    std::uint64_t /*timestamp*/,
+    const std::string & /*version*/) const -> std::vector<radix_relay::signal::fan_out_frame>
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("create_encrypted_message_frames");
+    std::vector<radix_relay::signal::fan_out_frame> frames;
+    for (const auto &peer : peers) {
+      if (std::ranges::find(unreachable_peers, peer) != unreachable_peers.end()) {
+        frames.push_back({ .recipient = peer, .event_id = "", .bytes = {}, .error = "Session not found: " + peer });
+        continue;
+      }
+      const auto event_id = "test_message_event_id_" + peer;
+      frames.push_back({
+        .recipient = peer,
+        .event_id = event_id,
+        .bytes = to_frame(R"({"id":")" + event_id + R"(","kind":40001,"tags":[["p",")" + peer
+                          + R"("]],"content":"","sig":"test_signature"})"),
+        .error = "",
+      });
     }
-    return R"(["REQ",")" + subscription_id + R"(",{"kinds":[40001],"#p":["test_pubkey"]}])";
+    return frames;
+  }
+
+  auto sign_event_frame(std::uint32_t kind,
+    const std::vector<std::vector<std::string>> &tags,
+    const std::string &content,
+    std::uint64_t created_at) const -> radix_relay::signal::signed_event_frame
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("sign_event_frame");
+    last_signed_tags = tags;
+    nlohmann::json event{ { "pubkey", "test_pubkey" },
+      { "created_at", created_at },
+      { "kind", kind },
+      { "tags", tags },
+      { "content", content } };
+    event["id"] = signed_event_id ? signed_event_id(event) : "test_signed_event_id";
+    event["sig"] = "test_signature";
+    return { .event_id = event["id"].get<std::string>(), .bytes = to_frame(event.dump()) };
+  }
+
+  auto message_subscription(std::uint64_t since_timestamp = 0) const -> radix_relay::signal::message_subscription
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("message_subscription");
+    return { .our_pubkey = "test_pubkey",
+      .group_ids = {},
+      .since = since_timestamp > 0 ? since_timestamp : last_message_timestamp };
   }
 
   auto update_last_message_timestamp(std::uint64_t timestamp) const -> void
   {
+    const std::scoped_lock lock(mutex_);
     called_methods.push_back("update_last_message_timestamp");
     last_message_timestamp = timestamp;
   }
 
+  auto verify_events(const std::vector<std::string> &event_jsons) const -> std::vector<bool>
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("verify_events");
+    verified_batch_sizes.push_back(event_jsons.size());
+    std::vector<bool> verified;
+    verified.reserve(event_jsons.size());
+    for (const auto &event_json : event_jsons) {
+      verified.push_back(not forged_event_ids.contains(nlohmann::json::parse(event_json).value("id", "")));
+    }
+    return verified;
+  }
+
   auto perform_key_maintenance() const -> radix_relay::signal::key_maintenance_result
   {
+    const std::scoped_lock lock(mutex_);
     called_methods.push_back("perform_key_maintenance");
     return maintenance_result;
   }
@@ -163,11 +454,13 @@ struct test_double_signal_bridge
     std::uint32_t /*signed_pre_key_id*/,
     std::uint32_t /*kyber_pre_key_id*/) const -> void
   {
+    const std::scoped_lock lock(mutex_);
     called_methods.push_back("record_published_bundle");
   }
 
   auto set_maintenance_result(radix_relay::signal::key_maintenance_result result) -> void
   {
+    const std::scoped_lock lock(mutex_);
     maintenance_result = result;
   }
 
@@ -175,6 +468,7 @@ struct test_double_signal_bridge
     std::uint32_t limit,
     std::uint32_t /*offset*/) const -> std::vector<radix_relay::signal::stored_message>
   {
+    const std::scoped_lock lock(mutex_);
     called_methods.push_back("get_conversation_messages");
     std::vector<radix_relay::signal::stored_message> result;
     const auto target_conv_id = conversation_id_for_rdx(rdx_fingerprint);
@@ -189,12 +483,14 @@ struct test_double_signal_bridge
 
   auto mark_conversation_read(const std::string &rdx_fingerprint) const -> void
   {
+    const std::scoped_lock lock(mutex_);
     called_methods.push_back("mark_conversation_read");
     marked_read_rdx = rdx_fingerprint;
   }
 
   auto mark_conversation_read_up_to(const std::string &rdx_fingerprint, std::uint64_t up_to_timestamp) const -> void
   {
+    const std::scoped_lock lock(mutex_);
     called_methods.push_back("mark_conversation_read_up_to");
     marked_read_rdx = rdx_fingerprint;
     marked_read_up_to_timestamp = up_to_timestamp;
@@ -202,36 +498,78 @@ struct test_double_signal_bridge
 
   auto get_unread_count(const std::string & /*rdx_fingerprint*/) const -> std::uint32_t
   {
+    const std::scoped_lock lock(mutex_);
     called_methods.push_back("get_unread_count");
     return unread_count_to_return;
   }
 
   auto get_conversations(bool /*include_archived*/) const -> std::vector<radix_relay::signal::conversation>
   {
+    const std::scoped_lock lock(mutex_);
     called_methods.push_back("get_conversations");
     return conversations_to_return;
   }
 
-  auto delete_message(std::int64_t /*message_id*/) const -> void { called_methods.push_back("delete_message"); }
+  auto delete_message(std::int64_t /*message_id*/) const -> void
+  {
+    const std::scoped_lock lock(mutex_);
+    called_methods.push_back("delete_message");
+  }
 
   auto delete_conversation(const std::string & /*rdx_fingerprint*/) const -> void
   {
+    const std::scoped_lock lock(mutex_);
     called_methods.push_back("delete_conversation");
   }
 
   mutable std::vector<radix_relay::signal::stored_message> messages_to_return;
   mutable std::vector<radix_relay::signal::conversation> conversations_to_return;
   mutable std::uint32_t unread_count_to_return = 0;
+  mutable bool should_republish_bundle_to_return = false;
+  mutable std::string compression_peer;
+  mutable bool compression_supported = false;
+  mutable std::string base64_content_peer;
+  mutable bool base64_content_supported = false;
   mutable std::string marked_read_rdx;
   mutable std::uint64_t marked_read_up_to_timestamp = 0;
+  mutable std::string created_group_name;
+  mutable std::vector<std::string> created_group_members;
+  mutable std::vector<std::string> members_awaiting_sender_key;
+  mutable std::vector<std::string> unreachable_peers;
+  mutable std::uint32_t transfer_chunk_count = 3;
+  mutable std::vector<radix_relay::signal::outgoing_transfer> pending_transfers;
+  mutable std::string file_transfer_error;
+  mutable std::vector<std::vector<std::string>> last_signed_tags;
+  /// Computes the ID of an event sign_event_frame signs; unset, every signed event gets a placeholder ID
+  std::function<std::string(const nlohmann::json &)> signed_event_id;
+  mutable std::set<std::string> forged_event_ids;
+  mutable std::vector<std::size_t> verified_batch_sizes;
+  mutable std::map<std::string, std::pair<radix_relay::signal::cached_bundle, std::string>> cached_bundles;
+  mutable radix_relay::signal::transfer_progress transfer_progress_to_return{ .transfer_id = "test_transfer_id",
+    .name = "notes.txt",
+    .sender_rdx = "RDX:sender",
+    .received_chunks = 1,
+    .chunk_count = 3,
+    .complete = false,
+    .path = "" };
 
 private:
+  mutable std::mutex mutex_;
   radix_relay::signal::key_maintenance_result maintenance_result{
     .signed_pre_key_rotated = false,
     .kyber_pre_key_rotated = false,
     .pre_keys_replenished = false,
   };
 
+  static auto to_frame(const std::string &event_json) -> std::vector<std::byte>
+  {
+    const std::string frame = R"(["EVENT",)" + event_json + "]";
+    std::vector<std::byte> bytes(frame.size());
+    std::transform(
+      frame.begin(), frame.end(), bytes.begin(), [](char character) { return std::bit_cast<std::byte>(character); });
+    return bytes;
+  }
+
   static auto conversation_id_for_rdx(const std::string &rdx) -> std::int64_t
   {
     return static_cast<std::int64_t>(std::hash<std::string>{}(rdx) % 1000);
@@ -3,6 +3,7 @@
 #include <concepts/transport_stream.hpp>
 #include <transport/websocket_stream.hpp>
 
+#include <algorithm>
 #include <boost/asio.hpp>
 #include <boost/system/error_code.hpp>
 #include <cstddef>
@@ -39,6 +40,10 @@ public:
   auto set_write_failure(bool fail) -> void { should_fail_write_ = fail; }
   auto set_read_failure(bool fail) -> void { should_fail_read_ = fail; }
   auto set_close_failure(bool fail) -> void { should_fail_close_ = fail; }
+  auto set_fetch_failure(bool fail) -> void { should_fail_fetch_ = fail; }
+  auto set_ping_failure(bool fail) -> void { should_fail_ping_ = fail; }
+  auto set_document(std::string document) -> void { document_ = std::move(document); }
+  auto set_traffic(radix_relay::transport::websocket_traffic traffic) -> void { traffic_ = traffic; }
 
   auto set_read_data(std::vector<std::byte> data) -> void
   {
@@ -50,12 +55,16 @@ public:
 
   [[nodiscard]] auto get_connections() const -> const std::vector<connection_record> & { return connections_; }
   [[nodiscard]] auto get_writes() const -> const std::vector<write_record> & { return writes_; }
+  [[nodiscard]] auto get_fetches() const -> const std::vector<connection_record> & { return fetches_; }
+  [[nodiscard]] auto get_ping_count() const -> std::size_t { return pings_; }
+  [[nodiscard]] auto get_max_writes_in_flight() const -> std::size_t { return max_writes_in_flight_; }
   [[nodiscard]] auto is_connected() const -> bool { return connected_; }
 
   auto reset() -> void
   {
     connections_.clear();
     writes_.clear();
+    max_writes_in_flight_ = 0;
     read_data_.clear();
     read_position_ = 0;
     connected_ = false;
@@ -63,6 +72,27 @@ public:
     should_fail_write_ = false;
     should_fail_read_ = false;
     should_fail_close_ = false;
+    should_fail_fetch_ = false;
+    fetches_.clear();
+    document_.clear();
+    should_fail_ping_ = false;
+    pings_ = 0;
+    traffic_ = {};
+  }
+
+  auto async_fetch_document(radix_relay::transport::websocket_connection_params params,
+    std::string_view /*accept*/,
+    std::function<void(const boost::system::error_code &, std::string)> handler) -> void
+  {
+    fetches_.push_back({ std::string(params.host), std::string(params.port), std::string(params.path) });
+
+    boost::asio::post(*io_context_, [this, handler = std::move(handler)]() {
+      if (should_fail_fetch_) {
+        handler(boost::asio::error::connection_refused, {});
+      } else {
+        handler(boost::system::error_code{}, document_);
+      }
+    });
   }
 
   auto async_connect(radix_relay::transport::websocket_connection_params params,
@@ -84,9 +114,11 @@ public:
     std::function<void(const boost::system::error_code &, std::size_t)> handler) -> void
   {
     writes_.push_back({ std::vector<std::byte>(data.begin(), data.end()) });
+    max_writes_in_flight_ = std::max(max_writes_in_flight_, ++writes_in_flight_);
 
     const auto bytes = data.size();
     boost::asio::post(*io_context_, [this, bytes, handler = std::move(handler)]() {
+      --writes_in_flight_;
       if (should_fail_write_) {
         handler(boost::asio::error::broken_pipe, 0);
       } else {
@@ -110,6 +142,17 @@ public:
     if (read_position_ < read_data_.size()) { complete_pending_read(); }
   }
 
+  auto async_ping(std::function<void(const boost::system::error_code &)> handler) -> void
+  {
+    ++pings_;
+
+    boost::asio::post(*io_context_, [this, handler = std::move(handler)]() {
+      handler(should_fail_ping_ ? boost::asio::error::broken_pipe : boost::system::error_code{});
+    });
+  }
+
+  [[nodiscard]] auto traffic() const -> radix_relay::transport::websocket_traffic { return traffic_; }
+
   auto async_close(std::function<void(const boost::system::error_code &, std::size_t)> handler) -> void
   {
     boost::asio::post(*io_context_, [this, handler = std::move(handler)]() {
@@ -151,9 +194,17 @@ private:
   bool should_fail_write_{ false };
   bool should_fail_read_{ false };
   bool should_fail_close_{ false };
+  bool should_fail_fetch_{ false };
+  bool should_fail_ping_{ false };
 
   std::vector<connection_record> connections_;
+  std::vector<connection_record> fetches_;
+  std::string document_;
+  std::size_t pings_{ 0 };
+  radix_relay::transport::websocket_traffic traffic_;
   std::vector<write_record> writes_;
+  std::size_t writes_in_flight_{ 0 };
+  std::size_t max_writes_in_flight_{ 0 };
   std::vector<std::byte> read_data_;
   size_t read_position_{ 0 };
   bool connected_{ false };
@@ -162,6 +213,8 @@ private:
   boost::asio::mutable_buffer pending_read_buffer_;
 };
 
-static_assert(radix_relay::concepts::transport_stream<test_double_websocket_stream>);
+static_assert(radix_relay::concepts::document_fetching_stream<test_double_websocket_stream>);
+static_assert(radix_relay::concepts::pinging_stream<test_double_websocket_stream>);
+static_assert(radix_relay::concepts::traffic_counting_stream<test_double_websocket_stream>);
 
 }// namespace radix_relay::test